@@ -0,0 +1,485 @@
+/*
+ * SysML v2 Parser - End-to-End Corpus Benchmark
+ *
+ * Runs the whole pipeline the CLI runs for `-f json` and `-f sysml` -
+ * parse, resolve, validate, JSON and SysML output - over two workloads:
+ *
+ *   official   every .sysml file under tests/fixtures/official
+ *   synthetic  `copies` generated models of `elements` elements each,
+ *              one file per model (roots Bench0, Bench1, ...)
+ *
+ * Each workload runs `iterations` times with a fresh arena, intern table
+ * and pipeline. For every phase the median and 95th percentile wall time
+ * and the highest memory budget use (see memory_budget.h) are printed, one
+ * line per phase:
+ *
+ *   bench=corpus workload=official files=95 bytes=222007 iterations=5 jobs=1
+ *   phase=parse median_ns=... p95_ns=... peak_bytes=...
+ *
+ * (one line each; `phase=total` is the whole run). That output is also
+ * the baseline format: with baseline=FILE, every phase is compared with
+ * the matching line of FILE (same input and jobs) and the benchmark exits
+ * with 1 if a median grew by more than `tolerance` percent (and more than
+ * `slack_ms`) or a peak by more than `memory_tolerance` percent. Lines
+ * starting with '#' are ignored. Record a baseline by redirecting a run
+ * to a file.
+ *
+ * Usage: bench_corpus [corpus=DIR] [copies=N] [elements=N] [iterations=N]
+ *                     [jobs=N] [lib=DIR] [baseline=FILE] [tolerance=PCT]
+ *                     [memory_tolerance=PCT] [slack_ms=N]
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "bench_model.h"
+#include "sysml2/cli.h"
+#include "sysml2/import_resolver.h"
+#include "sysml2/memory_budget.h"
+#include "sysml2/parser_pool.h"
+#include "sysml2/pipeline.h"
+#include "sysml2/utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifndef BENCH_CORPUS_DIR
+#define BENCH_CORPUS_DIR "tests/fixtures/official"
+#endif
+
+/* Rows per workload: the pipeline phases, then the whole run */
+#define ROW_TOTAL SYSML2_PHASE_COUNT
+#define ROW_COUNT (SYSML2_PHASE_COUNT + 1)
+
+typedef struct {
+    const char *corpus;
+    size_t copies;
+    size_t elements;
+    int iterations;
+    size_t jobs;
+    const char *lib;
+    const char *baseline;
+    double tolerance;           /* Percent */
+    double memory_tolerance;    /* Percent */
+    double slack_ms;
+} CorpusOptions;
+
+typedef struct {
+    const char *name;
+    const char **paths;
+    size_t count;
+    size_t bytes;
+} Workload;
+
+typedef struct {
+    uint64_t *wall_ns;          /* One per iteration */
+    size_t peak_bytes;
+    uint64_t median_ns;
+    uint64_t p95_ns;
+} Row;
+
+static void print_usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [corpus=DIR] [copies=N] [elements=N] [iterations=N] [jobs=N]\n"
+            "       [lib=DIR] [baseline=FILE] [tolerance=PCT] [memory_tolerance=PCT]\n"
+            "       [slack_ms=N]\n", prog);
+}
+
+static bool parse_options(CorpusOptions *opts, int argc, char **argv) {
+    opts->corpus = BENCH_CORPUS_DIR;
+    opts->copies = 8;
+    opts->elements = 2000;
+    opts->iterations = 5;
+    opts->jobs = 1;
+    opts->lib = NULL;
+    opts->baseline = NULL;
+    opts->tolerance = 25;
+    opts->memory_tolerance = 10;
+    opts->slack_ms = 5;
+
+    for (int i = 1; i < argc; i++) {
+        const char *eq = strchr(argv[i], '=');
+        if (!eq || eq[1] == '\0') {
+            print_usage(argv[0]);
+            return false;
+        }
+        const char *value = eq + 1;
+        char *end = NULL;
+        double number = strtod(value, &end);
+        bool numeric = *end == '\0' && number >= 0;
+
+        size_t key_len = (size_t)(eq - argv[i]);
+        #define KEY_IS(name) (key_len == strlen(name) && strncmp(argv[i], name, key_len) == 0)
+        if (KEY_IS("corpus")) opts->corpus = value;
+        else if (KEY_IS("lib")) opts->lib = value;
+        else if (KEY_IS("baseline")) opts->baseline = value;
+        else if (!numeric) {
+            print_usage(argv[0]);
+            return false;
+        }
+        else if (KEY_IS("copies")) opts->copies = (size_t)number;
+        else if (KEY_IS("elements")) opts->elements = (size_t)number;
+        else if (KEY_IS("iterations")) opts->iterations = (int)number;
+        else if (KEY_IS("jobs")) opts->jobs = (size_t)number;
+        else if (KEY_IS("tolerance")) opts->tolerance = number;
+        else if (KEY_IS("memory_tolerance")) opts->memory_tolerance = number;
+        else if (KEY_IS("slack_ms")) opts->slack_ms = number;
+        else {
+            print_usage(argv[0]);
+            return false;
+        }
+        #undef KEY_IS
+    }
+
+    if (opts->iterations <= 0 || opts->jobs == 0) {
+        fprintf(stderr, "%s: iterations and jobs must be positive\n", argv[0]);
+        return false;
+    }
+    return true;
+}
+
+/* ========== Workloads ========== */
+
+static size_t total_bytes(const char **paths, size_t count) {
+    size_t bytes = 0;
+    for (size_t i = 0; i < count; i++) {
+        size_t size = 0;
+        char *text = sysml2_read_file(paths[i], &size);
+        free(text);
+        bytes += size;
+    }
+    return bytes;
+}
+
+/* Write the generated models into dir; false if any could not be written */
+static bool write_synthetic(const CorpusOptions *opts, const char *dir, Workload *out) {
+    out->paths = calloc(opts->copies ? opts->copies : 1, sizeof(char *));
+    if (!out->paths) return false;
+
+    for (size_t i = 0; i < opts->copies; i++) {
+        char root[32];
+        snprintf(root, sizeof(root), "Bench%zu", i);
+        char name[48];
+        snprintf(name, sizeof(name), "%s.sysml", root);
+
+        BenchModelSpec spec;
+        bench_spec_init(&spec);
+        spec.root = root;
+        spec.elements = opts->elements;
+
+        size_t length = 0;
+        char *text = bench_model_generate(&spec, &length);
+        char *path = sysml2_path_join(dir, name);
+        FILE *file = path ? fopen(path, "w") : NULL;
+        bool written = text && file && fwrite(text, 1, length, file) == length;
+        if (file && fclose(file) != 0) written = false;
+        free(text);
+        if (path) out->paths[out->count++] = path;
+        if (!written) return false;
+        out->bytes += length;
+    }
+    return true;
+}
+
+/* ========== Runs ========== */
+
+/*
+ * Run the pipeline once over a workload, as `sysml2 -f json` followed by
+ * `-f sysml` would, and record each phase's time and peak
+ */
+static bool run_once(const CorpusOptions *opts, const Workload *workload,
+                     Row rows[ROW_COUNT], int iteration) {
+    Sysml2CliOptions options = {0};
+    options.stats_format = SYSML2_STATS_JSON;
+    options.max_errors = 0;
+    options.jobs = opts->jobs;
+    options.users_depth = 1;
+    const char *lib_paths[1] = { opts->lib };
+    if (opts->lib) {
+        options.library_paths = lib_paths;
+        options.library_path_count = 1;
+    }
+
+    FILE *sink = fopen("/dev/null", "w");
+    SysmlSemanticModel **models = calloc(workload->count ? workload->count : 1,
+                                         sizeof(SysmlSemanticModel *));
+    if (!sink || !models) {
+        if (sink) fclose(sink);
+        free(models);
+        return false;
+    }
+
+    /* Cached parser blocks would make the first run the only one that allocates */
+    sysml2_parser_pool_trim();
+
+    Sysml2Arena arena;
+    Sysml2Intern intern;
+    sysml2_arena_init(&arena);
+    sysml2_intern_init(&intern, &arena);
+
+    double start = bench_now_ns();
+    size_t outer_peak = sysml2_memory_begin_peak();
+
+    Sysml2PipelineContext *ctx = sysml2_pipeline_create(&arena, &intern, &options);
+    bool ok = ctx != NULL;
+    if (ok) {
+        /* Syntax errors in a corpus file are reported, not fatal */
+        ctx->err_out = sink;
+        sysml2_pipeline_process_files(ctx, workload->paths, workload->count, opts->jobs,
+                                      false, models, NULL);
+        for (size_t i = 0; i < workload->count; i++) {
+            if (models[i]) sysml2_resolver_resolve_imports(ctx->resolver, models[i], ctx->diag);
+        }
+
+        /* Undefined library names count as errors; timing is what matters */
+        sysml2_pipeline_validate_all(ctx);
+
+        size_t model_count = 0;
+        SysmlSemanticModel **all = sysml2_resolver_get_all_models(ctx->resolver, &model_count);
+        for (size_t i = 0; i < model_count; i++) {
+            if (all[i]) sysml2_pipeline_write_json(ctx, all[i], sink);
+        }
+        sysml2_pipeline_write_sysml_models(ctx, all, model_count, sink);
+        free(all);
+    }
+
+    double elapsed = bench_now_ns() - start;
+    size_t run_peak = sysml2_memory_end_peak(outer_peak);
+
+    if (ok) {
+        for (int p = 0; p < SYSML2_PHASE_COUNT; p++) {
+            rows[p].wall_ns[iteration] = ctx->stats->phases[p].wall_ns;
+            if (ctx->stats->phases[p].memory_peak > rows[p].peak_bytes) {
+                rows[p].peak_bytes = ctx->stats->phases[p].memory_peak;
+            }
+        }
+        rows[ROW_TOTAL].wall_ns[iteration] = (uint64_t)elapsed;
+        if (run_peak > rows[ROW_TOTAL].peak_bytes) rows[ROW_TOTAL].peak_bytes = run_peak;
+        sysml2_pipeline_destroy(ctx);
+    }
+
+    sysml2_intern_destroy(&intern);
+    sysml2_arena_destroy(&arena);
+    free(models);
+    fclose(sink);
+    return ok;
+}
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* Sort the samples and pick the median and nearest-rank 95th percentile */
+static void summarize(Row *row, int iterations) {
+    qsort(row->wall_ns, (size_t)iterations, sizeof(uint64_t), compare_u64);
+    size_t n = (size_t)iterations;
+    row->median_ns = n % 2 ? row->wall_ns[n / 2]
+                           : (row->wall_ns[n / 2 - 1] + row->wall_ns[n / 2]) / 2;
+    size_t rank = (95 * n + 99) / 100;
+    row->p95_ns = row->wall_ns[rank - 1];
+}
+
+static const char *row_name(int row) {
+    return row == ROW_TOTAL ? "total" : sysml2_stats_phase_name((Sysml2Phase)row);
+}
+
+/* ========== Baseline ========== */
+
+/* The number after `key=` in a result line, or -1 if it has none */
+static double line_value(const char *line, const char *key) {
+    size_t key_len = strlen(key);
+    for (const char *p = line; (p = strstr(p, key)) != NULL; p += key_len) {
+        if ((p == line || p[-1] == ' ') && p[key_len] == '=') {
+            return strtod(p + key_len + 1, NULL);
+        }
+    }
+    return -1;
+}
+
+/* Whether a result line has `key=value` exactly */
+static bool line_has(const char *line, const char *key, const char *value) {
+    char field[128];
+    snprintf(field, sizeof(field), "%s=%s", key, value);
+    size_t len = strlen(field);
+    for (const char *p = line; (p = strstr(p, field)) != NULL; p += len) {
+        if ((p == line || p[-1] == ' ') && (p[len] == ' ' || p[len] == '\n' || p[len] == '\0')) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Compare a workload's rows with the baseline
+ *
+ * @return Number of regressions (an unusable baseline counts as one)
+ */
+static size_t check_baseline(const CorpusOptions *opts, const Workload *workload,
+                             const Row rows[ROW_COUNT]) {
+    FILE *file = fopen(opts->baseline, "r");
+    if (!file) {
+        fprintf(stderr, "bench_corpus: cannot read baseline '%s'\n", opts->baseline);
+        return 1;
+    }
+
+    size_t regressions = 0;
+    bool seen[ROW_COUNT] = {false};
+    bool other_input = false;
+    char line[1024];
+    while (fgets(line, sizeof(line), file)) {
+        if (line[0] == '#' || !line_has(line, "workload", workload->name)) continue;
+
+        int row = -1;
+        for (int r = 0; r < ROW_COUNT; r++) {
+            if (line_has(line, "phase", row_name(r))) row = r;
+        }
+        if (row < 0 || seen[row]) continue;
+        seen[row] = true;
+
+        if (line_value(line, "files") != (double)workload->count ||
+            line_value(line, "bytes") != (double)workload->bytes ||
+            line_value(line, "jobs") != (double)opts->jobs) {
+            if (!other_input) {
+                fprintf(stderr, "bench_corpus: the %s baseline was recorded on other input or jobs "
+                        "(%.0f files, %.0f bytes, jobs=%.0f)\n", workload->name,
+                        line_value(line, "files"), line_value(line, "bytes"),
+                        line_value(line, "jobs"));
+                regressions++;
+            }
+            other_input = true;
+            continue;
+        }
+
+        double base_ns = line_value(line, "median_ns");
+        double ns = (double)rows[row].median_ns;
+        if (base_ns >= 0 && ns > base_ns * (1 + opts->tolerance / 100) &&
+            ns - base_ns > opts->slack_ms * 1e6) {
+            fprintf(stderr, "regression: workload=%s phase=%s median_ns=%.0f baseline=%.0f (%+.1f%%)\n",
+                    workload->name, row_name(row), ns, base_ns,
+                    base_ns > 0 ? (ns / base_ns - 1) * 100 : 100.0);
+            regressions++;
+        }
+
+        double base_bytes = line_value(line, "peak_bytes");
+        double bytes = (double)rows[row].peak_bytes;
+        if (base_bytes >= 0 && bytes > base_bytes * (1 + opts->memory_tolerance / 100)) {
+            fprintf(stderr, "regression: workload=%s phase=%s peak_bytes=%.0f baseline=%.0f (%+.1f%%)\n",
+                    workload->name, row_name(row), bytes, base_bytes,
+                    base_bytes > 0 ? (bytes / base_bytes - 1) * 100 : 100.0);
+            regressions++;
+        }
+    }
+    fclose(file);
+
+    for (int r = 0; r < ROW_COUNT; r++) {
+        if (!seen[r]) {
+            fprintf(stderr, "bench_corpus: baseline has no line for %s/%s\n",
+                    workload->name, row_name(r));
+            regressions++;
+        }
+    }
+    return regressions;
+}
+
+/* ========== Main ========== */
+
+/*
+ * Run a workload, print its rows and compare them with the baseline
+ *
+ * @return Number of regressions, or SIZE_MAX if the workload could not run
+ */
+static size_t bench_workload(const CorpusOptions *opts, const Workload *workload) {
+    Row rows[ROW_COUNT];
+    memset(rows, 0, sizeof(rows));
+    uint64_t *samples = calloc((size_t)ROW_COUNT * (size_t)opts->iterations, sizeof(uint64_t));
+    if (!samples) return SIZE_MAX;
+    for (int r = 0; r < ROW_COUNT; r++) rows[r].wall_ns = samples + (size_t)r * (size_t)opts->iterations;
+
+    for (int i = 0; i < opts->iterations; i++) {
+        if (!run_once(opts, workload, rows, i)) {
+            fprintf(stderr, "bench_corpus: %s: pipeline setup failed\n", workload->name);
+            free(samples);
+            return SIZE_MAX;
+        }
+    }
+
+    for (int r = 0; r < ROW_COUNT; r++) {
+        summarize(&rows[r], opts->iterations);
+        printf("bench=corpus workload=%s files=%zu bytes=%zu iterations=%d jobs=%zu "
+               "phase=%s median_ns=%llu p95_ns=%llu peak_bytes=%zu\n",
+               workload->name, workload->count, workload->bytes, opts->iterations, opts->jobs,
+               row_name(r), (unsigned long long)rows[r].median_ns,
+               (unsigned long long)rows[r].p95_ns, rows[r].peak_bytes);
+    }
+    fflush(stdout);
+
+    size_t regressions = opts->baseline ? check_baseline(opts, workload, rows) : 0;
+    free(samples);
+    return regressions;
+}
+
+int main(int argc, char **argv) {
+    CorpusOptions opts;
+    if (!parse_options(&opts, argc, argv)) return 1;
+
+    /* Fail before the runs, not after them */
+    if (opts.baseline && access(opts.baseline, R_OK) != 0) {
+        fprintf(stderr, "%s: cannot read baseline '%s'\n", argv[0], opts.baseline);
+        return 1;
+    }
+
+    /* Only lib= adds libraries, so runs stay comparable with the baseline */
+    unsetenv(SYSML2_LIBRARY_PATH_ENV);
+
+    size_t official_count = 0;
+    char **official_paths = sysml2_find_files_recursive(opts.corpus, ".sysml", &official_count);
+    if (!official_paths || official_count == 0) {
+        fprintf(stderr, "%s: no .sysml files under '%s'\n", argv[0], opts.corpus);
+        sysml2_free_file_list(official_paths, official_count);
+        return 1;
+    }
+    Workload official = {
+        .name = "official",
+        .paths = (const char **)official_paths,
+        .count = official_count,
+        .bytes = total_bytes((const char **)official_paths, official_count),
+    };
+
+    char dir[] = "/tmp/bench_corpus_XXXXXX";
+    Workload synthetic = { .name = "synthetic" };
+    if (!mkdtemp(dir) || !write_synthetic(&opts, dir, &synthetic)) {
+        fprintf(stderr, "%s: cannot write the synthetic corpus\n", argv[0]);
+        for (size_t i = 0; i < synthetic.count; i++) remove(synthetic.paths[i]);
+        sysml2_free_file_list((char **)synthetic.paths, synthetic.count);
+        rmdir(dir);
+        sysml2_free_file_list(official_paths, official_count);
+        return 1;
+    }
+
+    size_t regressions = 0;
+    bool failed = false;
+    const Workload *workloads[] = { &official, &synthetic };
+    for (size_t w = 0; w < sizeof(workloads) / sizeof(workloads[0]); w++) {
+        if (workloads[w]->count == 0) continue;
+        size_t found = bench_workload(&opts, workloads[w]);
+        if (found == SIZE_MAX) {
+            failed = true;
+        } else {
+            regressions += found;
+        }
+    }
+
+    for (size_t i = 0; i < synthetic.count; i++) remove(synthetic.paths[i]);
+    sysml2_free_file_list((char **)synthetic.paths, synthetic.count);
+    rmdir(dir);
+    sysml2_free_file_list(official_paths, official_count);
+
+    if (regressions > 0) {
+        fprintf(stderr, "%s: %zu regression%s against %s\n", argv[0], regressions,
+                regressions == 1 ? "" : "s", opts.baseline);
+    }
+    return failed || regressions > 0 ? 1 : 0;
+}
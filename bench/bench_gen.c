@@ -0,0 +1,32 @@
+/*
+ * SysML v2 Parser - Benchmark Model Generator CLI
+ *
+ * Writes the model the benchmarks time to stdout, for profiling the
+ * sysml2 binary itself on the same inputs.
+ *
+ * Usage: bench_gen [elements=N] [per_package=N] [depth=N] [imports=N] [spec_depth=N]
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "bench_model.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+int main(int argc, char **argv) {
+    BenchModelSpec spec;
+    bench_spec_init(&spec);
+    if (!bench_spec_parse(&spec, argc, argv)) return 1;
+
+    size_t length = 0;
+    char *text = bench_model_generate(&spec, &length);
+    if (!text) {
+        fprintf(stderr, "%s: out of memory\n", argv[0]);
+        return 1;
+    }
+
+    int status = fwrite(text, 1, length, stdout) == length ? 0 : 1;
+    free(text);
+    return status;
+}
@@ -0,0 +1,241 @@
+/*
+ * SysML v2 Parser - Benchmark Model Generator Implementation
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "bench_model.h"
+#include "sysml2/cli.h"
+#include "sysml2/pipeline.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Children per wrapper package */
+#define WRAPPER_FANOUT 8
+
+typedef struct {
+    char *data;
+    size_t length;
+    size_t capacity;
+    bool failed;
+} TextBuf;
+
+static void text_printf(TextBuf *buf, const char *fmt, ...) {
+    if (buf->failed) return;
+
+    for (;;) {
+        va_list args;
+        va_start(args, fmt);
+        size_t room = buf->capacity - buf->length;
+        int n = vsnprintf(buf->data + buf->length, room, fmt, args);
+        va_end(args);
+        if (n < 0) {
+            buf->failed = true;
+            return;
+        }
+        if ((size_t)n < room) {
+            buf->length += (size_t)n;
+            return;
+        }
+
+        size_t capacity = buf->capacity ? buf->capacity * 2 : 4096;
+        while (capacity - buf->length <= (size_t)n) capacity *= 2;
+        char *data = realloc(buf->data, capacity);
+        if (!data) {
+            buf->failed = true;
+            return;
+        }
+        buf->data = data;
+        buf->capacity = capacity;
+    }
+}
+
+static void indent(TextBuf *buf, size_t level) {
+    text_printf(buf, "%*s", (int)(level * 4), "");
+}
+
+void bench_spec_init(BenchModelSpec *spec) {
+    spec->root = "Bench";
+    spec->elements = 20000;
+    spec->per_package = 100;
+    spec->depth = 3;
+    spec->imports = 2;
+    spec->specialization_depth = 4;
+    spec->iterations = 3;
+}
+
+static void print_usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [elements=N] [per_package=N] [depth=N] [imports=N]\n"
+            "       [spec_depth=N] [iterations=N]\n", prog);
+}
+
+bool bench_spec_parse(BenchModelSpec *spec, int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        const char *eq = strchr(argv[i], '=');
+        char *end = NULL;
+        unsigned long long value = eq ? strtoull(eq + 1, &end, 10) : 0;
+        if (!eq || end == eq + 1 || *end != '\0') {
+            print_usage(argv[0]);
+            return false;
+        }
+
+        size_t key_len = (size_t)(eq - argv[i]);
+        #define KEY_IS(name) (key_len == strlen(name) && strncmp(argv[i], name, key_len) == 0)
+        if (KEY_IS("elements")) spec->elements = (size_t)value;
+        else if (KEY_IS("per_package")) spec->per_package = (size_t)value;
+        else if (KEY_IS("depth")) spec->depth = (size_t)value;
+        else if (KEY_IS("imports")) spec->imports = (size_t)value;
+        else if (KEY_IS("spec_depth")) spec->specialization_depth = (size_t)value;
+        else if (KEY_IS("iterations")) spec->iterations = (int)value;
+        else {
+            print_usage(argv[0]);
+            return false;
+        }
+        #undef KEY_IS
+    }
+
+    if (spec->elements == 0 || spec->per_package == 0 || spec->depth == 0 ||
+        spec->specialization_depth == 0 || spec->iterations <= 0) {
+        fprintf(stderr, "%s: elements, per_package, depth, spec_depth and iterations "
+                "must be positive\n", argv[0]);
+        return false;
+    }
+    return true;
+}
+
+size_t bench_spec_packages(const BenchModelSpec *spec) {
+    return (spec->elements + spec->per_package - 1) / spec->per_package;
+}
+
+/* Leaves under one wrapper at level (1 = outermost wrapper) */
+static size_t wrapper_span(const BenchModelSpec *spec, size_t level) {
+    size_t span = 1;
+    for (size_t l = level; l < spec->depth; l++) span *= WRAPPER_FANOUT;
+    return span;
+}
+
+/* Qualified name of leaf package p */
+static void leaf_path(TextBuf *buf, const BenchModelSpec *spec, size_t p) {
+    text_printf(buf, "%s", spec->root);
+    for (size_t level = 1; level < spec->depth; level++) {
+        text_printf(buf, "::G%zu_%zu", level, p / wrapper_span(spec, level));
+    }
+    text_printf(buf, "::P%zu", p);
+}
+
+static void emit_leaf(TextBuf *buf, const BenchModelSpec *spec, size_t p, size_t level) {
+    size_t packages = bench_spec_packages(spec);
+    size_t first = p * spec->per_package;
+    size_t count = spec->per_package;
+    if (first + count > spec->elements) count = spec->elements - first;
+
+    indent(buf, level);
+    text_printf(buf, "package P%zu {\n", p);
+
+    for (size_t i = 1; i <= spec->imports && i < packages; i++) {
+        indent(buf, level + 1);
+        text_printf(buf, "private import ");
+        leaf_path(buf, spec, (p + i) % packages);
+        text_printf(buf, "::*;\n");
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        size_t def = i / 2;
+        indent(buf, level + 1);
+        if (i % 2 == 1) {
+            text_printf(buf, "part u%zu : D%zu;\n", def, def);
+        } else if (def % spec->specialization_depth == 0) {
+            text_printf(buf, "part def D%zu { attribute v : Value; }\n", def);
+        } else {
+            text_printf(buf, "part def D%zu :> D%zu { attribute v : Value; }\n", def, def - 1);
+        }
+    }
+
+    indent(buf, level);
+    text_printf(buf, "}\n");
+}
+
+char *bench_model_generate(const BenchModelSpec *spec, size_t *out_length) {
+    TextBuf buf = {0};
+    size_t packages = bench_spec_packages(spec);
+
+    text_printf(&buf, "package %s {\n", spec->root);
+    text_printf(&buf, "    attribute def Value;\n");
+
+    /* Open and close wrappers as the leaf index crosses their spans */
+    for (size_t p = 0; p < packages; p++) {
+        for (size_t level = 1; level < spec->depth; level++) {
+            if (p % wrapper_span(spec, level) == 0) {
+                indent(&buf, level);
+                text_printf(&buf, "package G%zu_%zu {\n", level, p / wrapper_span(spec, level));
+            }
+        }
+
+        emit_leaf(&buf, spec, p, spec->depth);
+
+        for (size_t level = spec->depth - 1; level >= 1; level--) {
+            size_t span = wrapper_span(spec, level);
+            if ((p + 1) % span == 0 || p + 1 == packages) {
+                indent(&buf, level);
+                text_printf(&buf, "}\n");
+            }
+        }
+    }
+
+    text_printf(&buf, "}\n");
+
+    if (buf.failed) {
+        free(buf.data);
+        return NULL;
+    }
+    *out_length = buf.length;
+    return buf.data;
+}
+
+double bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+SysmlSemanticModel *bench_model_parse(
+    Sysml2Arena *arena,
+    Sysml2Intern *intern,
+    const char *text,
+    size_t length
+) {
+    Sysml2CliOptions options = {0};
+    options.parse_only = true;
+    options.no_resolve = true;
+
+    Sysml2PipelineContext *ctx = sysml2_pipeline_create(arena, intern, &options);
+    if (!ctx) return NULL;
+
+    SysmlSemanticModel *model = NULL;
+    Sysml2Result result = sysml2_pipeline_process_input(ctx, "<bench>", text, length, &model);
+    sysml2_pipeline_destroy(ctx);
+
+    return result == SYSML2_OK ? model : NULL;
+}
+
+void bench_report(
+    const char *name,
+    const BenchModelSpec *spec,
+    size_t elements,
+    double best_ns,
+    size_t peak_arena_bytes
+) {
+    printf("bench=%s elements=%zu packages=%zu depth=%zu imports=%zu spec_depth=%zu "
+           "iterations=%d best_ns=%.0f ops_per_s=%.3f ns_per_element=%.1f "
+           "peak_arena_bytes=%zu\n",
+           name, elements, bench_spec_packages(spec), spec->depth, spec->imports,
+           spec->specialization_depth, spec->iterations, best_ns,
+           best_ns > 0 ? 1e9 / best_ns : 0.0,
+           elements ? best_ns / (double)elements : 0.0,
+           peak_arena_bytes);
+}
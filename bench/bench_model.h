@@ -0,0 +1,109 @@
+/*
+ * SysML v2 Parser - Benchmark Model Generator
+ *
+ * Emits deterministic SysML models of configurable shape for the
+ * benchmarks in this directory and for bench_gen:
+ *
+ *   package Bench {
+ *       attribute def Value;
+ *       package G1_0 {                    nesting: depth - 1 wrappers
+ *           package P0 {                  leaf packages of per_package elements
+ *               private import Bench::G1_0::P1::*;   imports per leaf
+ *               part def D0 { attribute v : Value; }
+ *               part u0 : D0;
+ *               part def D1 :> D0 { ... }            chains of specialization_depth
+ *               ...
+ *
+ * Elements alternate between part definitions and part usages typed by
+ * the preceding definition. The same spec always yields the same text.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef SYSML2_BENCH_MODEL_H
+#define SYSML2_BENCH_MODEL_H
+
+#include "sysml2/arena.h"
+#include "sysml2/intern.h"
+#include "sysml2/ast.h"
+
+#include <stddef.h>
+#include <stdbool.h>
+
+typedef struct {
+    const char *root;               /* Name of the outermost package */
+    size_t elements;                /* Part definitions and usages */
+    size_t per_package;             /* Elements per leaf package */
+    size_t depth;                   /* Package levels holding the leaves (>= 1) */
+    size_t imports;                 /* Imports per leaf package */
+    size_t specialization_depth;    /* Definitions per :> chain (>= 1) */
+    int iterations;                 /* Timed runs (best is reported) */
+} BenchModelSpec;
+
+/* Fill in defaults: root Bench, 20000 elements, 100 per package, depth 3,
+ * 2 imports, chains of 4, 3 iterations */
+void bench_spec_init(BenchModelSpec *spec);
+
+/*
+ * Parse key=value arguments into a spec
+ *
+ * Keys: elements, per_package, depth, imports, spec_depth, iterations.
+ * Prints usage and returns false on an unknown key or a bad value.
+ */
+bool bench_spec_parse(BenchModelSpec *spec, int argc, char **argv);
+
+/* Number of leaf packages the spec produces */
+size_t bench_spec_packages(const BenchModelSpec *spec);
+
+/*
+ * Generate the model text
+ *
+ * @param spec Model shape
+ * @param out_length Output: text length
+ * @return NUL-terminated text (caller frees), or NULL on allocation failure
+ */
+char *bench_model_generate(const BenchModelSpec *spec, size_t *out_length);
+
+/*
+ * Parse model text without resolving imports or validating
+ *
+ * @param arena Arena for the model
+ * @param intern Intern table for the model
+ * @param text Model text
+ * @param length Text length
+ * @return Model, or NULL on a syntax error
+ */
+SysmlSemanticModel *bench_model_parse(
+    Sysml2Arena *arena,
+    Sysml2Intern *intern,
+    const char *text,
+    size_t length
+);
+
+/* Monotonic clock in nanoseconds */
+double bench_now_ns(void);
+
+/*
+ * Print one result line as space-separated key=value pairs:
+ *
+ *   bench=<name> elements= packages= depth= imports= spec_depth=
+ *   iterations= best_ns= ops_per_s= ns_per_element= peak_arena_bytes=
+ *
+ * ops_per_s counts whole runs of the operation; peak_arena_bytes is the
+ * arena memory live when the operation finished (model plus scratch).
+ *
+ * @param name Benchmark name
+ * @param spec Model shape
+ * @param elements Elements processed per run (model elements, not spec)
+ * @param best_ns Fastest run
+ * @param peak_arena_bytes Largest arena footprint over all runs
+ */
+void bench_report(
+    const char *name,
+    const BenchModelSpec *spec,
+    size_t elements,
+    double best_ns,
+    size_t peak_arena_bytes
+);
+
+#endif /* SYSML2_BENCH_MODEL_H */
@@ -0,0 +1,202 @@
+/*
+ * SysML v2 Parser - Query Benchmark
+ *
+ * Builds a synthetic model in memory and times sysml2_query_execute
+ * (the engine behind --select) over it.
+ *
+ * Usage: bench_query [elements] [iterations]
+ *
+ * Prints one line per pattern as space-separated key=value pairs.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "sysml2/common.h"
+#include "sysml2/arena.h"
+#include "sysml2/intern.h"
+#include "sysml2/ast.h"
+#include "sysml2/query.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Elements per generated package */
+#define ELEMENTS_PER_PACKAGE 1000
+
+/* Patterns in the multi-pattern run */
+#define MULTI_PATTERN_COUNT 48
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static SysmlNode *make_node(
+    Sysml2Arena *arena,
+    Sysml2Intern *intern,
+    const char *id,
+    const char *name,
+    const char *parent_id,
+    SysmlNodeKind kind
+) {
+    SysmlNode *node = SYSML2_ARENA_NEW(arena, SysmlNode);
+    node->id = sysml2_intern(intern, id);
+    node->name = sysml2_intern(intern, name);
+    node->parent_id = parent_id;
+    node->kind = kind;
+    return node;
+}
+
+static void add_specialization(
+    SysmlSemanticModel *model,
+    Sysml2Arena *arena,
+    const char *source,
+    const char *target
+) {
+    SysmlRelationship *rel = SYSML2_ARENA_NEW(arena, SysmlRelationship);
+    rel->kind = SYSML_KIND_REL_SPECIALIZATION;
+    rel->source = source;
+    rel->target = target;
+    model->relationships[model->relationship_count++] = rel;
+}
+
+/*
+ * Build Root::P<p>::E<i> parts; each part specializes its predecessor
+ * (every tenth one also an element outside Root); each package has one
+ * import.
+ */
+static SysmlSemanticModel *build_model(Sysml2Arena *arena, Sysml2Intern *intern, size_t elements) {
+    size_t packages = (elements + ELEMENTS_PER_PACKAGE - 1) / ELEMENTS_PER_PACKAGE;
+    size_t node_cap = elements + packages + 2;
+
+    SysmlSemanticModel *model = SYSML2_ARENA_NEW(arena, SysmlSemanticModel);
+    model->elements = SYSML2_ARENA_NEW_ARRAY(arena, SysmlNode *, node_cap);
+    model->relationships = SYSML2_ARENA_NEW_ARRAY(arena, SysmlRelationship *, elements * 2);
+    model->imports = SYSML2_ARENA_NEW_ARRAY(arena, SysmlImport *, packages);
+
+    SysmlNode *root = make_node(arena, intern, "Root", "Root", NULL, SYSML_KIND_PACKAGE);
+    SysmlNode *outside = make_node(arena, intern, "Outside", "Outside", NULL, SYSML_KIND_PART_DEF);
+    model->elements[model->element_count++] = root;
+    model->elements[model->element_count++] = outside;
+
+    char id[64], prev[64], name[32];
+    size_t made = 0;
+    for (size_t p = 0; p < packages; p++) {
+        snprintf(id, sizeof(id), "Root::P%zu", p);
+        snprintf(name, sizeof(name), "P%zu", p);
+        SysmlNode *pkg = make_node(arena, intern, id, name, root->id, SYSML_KIND_PACKAGE);
+        model->elements[model->element_count++] = pkg;
+
+        SysmlImport *imp = SYSML2_ARENA_NEW(arena, SysmlImport);
+        imp->kind = SYSML_KIND_IMPORT_ALL;
+        imp->target = outside->id;
+        imp->owner_scope = pkg->id;
+        model->imports[model->import_count++] = imp;
+
+        for (size_t i = 0; i < ELEMENTS_PER_PACKAGE && made < elements; i++, made++) {
+            snprintf(id, sizeof(id), "%s::E%zu", pkg->id, i);
+            snprintf(name, sizeof(name), "E%zu", i);
+            SysmlNode *node = make_node(arena, intern, id, name, pkg->id, SYSML_KIND_PART_DEF);
+            model->elements[model->element_count++] = node;
+
+            if (i > 0) {
+                snprintf(prev, sizeof(prev), "%s::E%zu", pkg->id, i - 1);
+                add_specialization(model, arena, node->id, sysml2_intern(intern, prev));
+            }
+            if (i % 10 == 0) {
+                add_specialization(model, arena, node->id, outside->id);
+            }
+        }
+    }
+
+    model->element_capacity = node_cap;
+    model->relationship_capacity = elements * 2;
+    model->import_capacity = packages;
+    return model;
+}
+
+static void run_patterns(
+    const char *label,
+    const char **patterns,
+    size_t pattern_count,
+    SysmlSemanticModel *model,
+    size_t model_bytes,
+    int iterations
+) {
+    Sysml2Arena arena;
+    sysml2_arena_init(&arena);
+
+    Sysml2QueryPattern *qp = sysml2_query_parse_multi(patterns, pattern_count, &arena);
+    SysmlSemanticModel *models[] = {model};
+    Sysml2QueryResult *result = NULL;
+
+    double best = 0;
+    for (int i = 0; i < iterations; i++) {
+        double start = now_ns();
+        result = sysml2_query_execute(qp, models, 1, &arena);
+        double elapsed = now_ns() - start;
+        if (i == 0 || elapsed < best) best = elapsed;
+    }
+
+    printf("bench=query pattern=%s patterns=%zu elements=%zu relationships=%zu matched=%zu "
+           "matched_relationships=%zu matched_imports=%zu best_ns=%.0f ops_per_s=%.3f "
+           "ns_per_element=%.1f peak_arena_bytes=%zu\n",
+           label, pattern_count, model->element_count, model->relationship_count,
+           result ? result->element_count : 0,
+           result ? result->relationship_count : 0,
+           result ? result->import_count : 0,
+           best, best > 0 ? 1e9 / best : 0.0, best / (double)model->element_count,
+           model_bytes + sysml2_arena_used(&arena));
+
+    sysml2_arena_destroy(&arena);
+}
+
+static void run_pattern(
+    const char *pattern,
+    SysmlSemanticModel *model,
+    size_t model_bytes,
+    int iterations
+) {
+    run_patterns(pattern, &pattern, 1, model, model_bytes, iterations);
+}
+
+int main(int argc, char **argv) {
+    size_t elements = argc > 1 ? strtoul(argv[1], NULL, 10) : 100000;
+    int iterations = argc > 2 ? atoi(argv[2]) : 5;
+    if (elements == 0 || iterations <= 0) {
+        fprintf(stderr, "usage: %s [elements] [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    Sysml2Arena arena;
+    Sysml2Intern intern;
+    sysml2_arena_init(&arena);
+    sysml2_intern_init(&intern, &arena);
+
+    SysmlSemanticModel *model = build_model(&arena, &intern, elements);
+    size_t model_bytes = sysml2_arena_used(&arena);
+
+    run_pattern("Root::**", model, model_bytes, iterations);
+    run_pattern("Root::P0::*", model, model_bytes, iterations);
+    run_pattern("Root::P0::E0", model, model_bytes, iterations);
+
+    /* Many patterns at once, as issued by dashboards */
+    char bufs[MULTI_PATTERN_COUNT][48];
+    const char *multi[MULTI_PATTERN_COUNT];
+    for (size_t i = 0; i < MULTI_PATTERN_COUNT; i++) {
+        switch (i % 3) {
+            case 0: snprintf(bufs[i], sizeof(bufs[i]), "Root::P%zu::*", i); break;
+            case 1: snprintf(bufs[i], sizeof(bufs[i]), "Root::P%zu::**", i); break;
+            default: snprintf(bufs[i], sizeof(bufs[i]), "Root::P%zu::E%zu", i, i); break;
+        }
+        multi[i] = bufs[i];
+    }
+    run_patterns("multi", multi, MULTI_PATTERN_COUNT, model, model_bytes, iterations);
+
+    sysml2_intern_destroy(&intern);
+    sysml2_arena_destroy(&arena);
+    return 0;
+}
@@ -0,0 +1,74 @@
+/*
+ * SysML v2 Parser - Validation Benchmark
+ *
+ * Parses a generated model once, then times sysml2_validate_multi over
+ * it with a fresh scratch arena and diagnostic context per run.
+ *
+ * Usage: bench_validate [elements=N] [per_package=N] [depth=N] [imports=N]
+ *                       [spec_depth=N] [iterations=N]
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "bench_model.h"
+#include "sysml2/diagnostic.h"
+#include "sysml2/validator.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+int main(int argc, char **argv) {
+    BenchModelSpec spec;
+    bench_spec_init(&spec);
+    if (!bench_spec_parse(&spec, argc, argv)) return 1;
+
+    size_t length = 0;
+    char *text = bench_model_generate(&spec, &length);
+    if (!text) {
+        fprintf(stderr, "%s: out of memory\n", argv[0]);
+        return 1;
+    }
+
+    Sysml2Arena arena;
+    Sysml2Intern intern;
+    sysml2_arena_init(&arena);
+    sysml2_intern_init(&intern, &arena);
+
+    SysmlSemanticModel *model = bench_model_parse(&arena, &intern, text, length);
+    if (!model) {
+        fprintf(stderr, "%s: generated model failed to parse\n", argv[0]);
+        return 1;
+    }
+
+    Sysml2ValidationOptions options = SYSML_VALIDATION_OPTIONS_DEFAULT;
+    double best = 0;
+    size_t peak = 0;
+    for (int i = 0; i < spec.iterations; i++) {
+        Sysml2Arena scratch;
+        Sysml2DiagContext diag;
+        sysml2_arena_init(&scratch);
+        sysml2_diag_context_init(&diag, &scratch);
+
+        double start = bench_now_ns();
+        Sysml2Result result = sysml2_validate_multi(&model, 1, &diag, &scratch, &intern, &options);
+        double elapsed = bench_now_ns() - start;
+
+        if (result != SYSML2_OK) {
+            fprintf(stderr, "%s: generated model has %zu validation errors\n",
+                    argv[0], diag.error_count);
+            return 1;
+        }
+        if (i == 0 || elapsed < best) best = elapsed;
+        size_t used = sysml2_arena_used(&arena) + sysml2_arena_used(&scratch);
+        if (used > peak) peak = used;
+
+        sysml2_arena_destroy(&scratch);
+    }
+
+    bench_report("validate", &spec, model->element_count, best, peak);
+
+    sysml2_intern_destroy(&intern);
+    sysml2_arena_destroy(&arena);
+    free(text);
+    return 0;
+}
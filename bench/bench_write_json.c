@@ -0,0 +1,65 @@
+/*
+ * SysML v2 Parser - JSON Writer Benchmark
+ *
+ * Parses a generated model once, then times sysml2_json_write (-f json,
+ * pretty-printed) writing it to /dev/null.
+ *
+ * Usage: bench_write_json [elements=N] [per_package=N] [depth=N] [imports=N]
+ *        [spec_depth=N] [iterations=N]
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "bench_model.h"
+#include "sysml2/json_writer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+int main(int argc, char **argv) {
+    BenchModelSpec spec;
+    bench_spec_init(&spec);
+    if (!bench_spec_parse(&spec, argc, argv)) return 1;
+
+    size_t length = 0;
+    char *text = bench_model_generate(&spec, &length);
+    if (!text) {
+        fprintf(stderr, "%s: out of memory\n", argv[0]);
+        return 1;
+    }
+
+    Sysml2Arena arena;
+    Sysml2Intern intern;
+    sysml2_arena_init(&arena);
+    sysml2_intern_init(&intern, &arena);
+
+    SysmlSemanticModel *model = bench_model_parse(&arena, &intern, text, length);
+    FILE *out = fopen("/dev/null", "w");
+    if (!model || !out) {
+        fprintf(stderr, "%s: cannot set up the benchmark\n", argv[0]);
+        return 1;
+    }
+
+    Sysml2JsonOptions json_options = SYSML_JSON_OPTIONS_DEFAULT;
+    double best = 0;
+    for (int i = 0; i < spec.iterations; i++) {
+        double start = bench_now_ns();
+        Sysml2Result result = sysml2_json_write(model, out, &json_options);
+        fflush(out);
+        double elapsed = bench_now_ns() - start;
+
+        if (result != SYSML2_OK) {
+            fprintf(stderr, "%s: write failed\n", argv[0]);
+            return 1;
+        }
+        if (i == 0 || elapsed < best) best = elapsed;
+    }
+
+    bench_report("write_json", &spec, model->element_count, best, sysml2_arena_used(&arena));
+
+    fclose(out);
+    sysml2_intern_destroy(&intern);
+    sysml2_arena_destroy(&arena);
+    free(text);
+    return 0;
+}
@@ -0,0 +1,18 @@
+# Post-process a PackCC-generated parser so it is safe to run on several
+# threads at once (parse workers under -j).
+#
+# pcc_apply_rule() hands the address of a function-static dummy value to
+# thunks whose result nobody reads; every parse writes to it, so it is
+# made thread-local. It cannot be a stack value: the thunk keeps the
+# pointer after the call returns.
+#
+# Usage: cmake -DPARSER_SOURCE=<file> -P patch_packcc.cmake
+
+file(READ ${PARSER_SOURCE} content)
+string(REPLACE "static pcc_value_t null;" "static _Thread_local pcc_value_t null;" patched "${content}")
+if(NOT patched MATCHES "static _Thread_local pcc_value_t null;")
+    message(FATAL_ERROR "${PARSER_SOURCE}: PackCC's shared null value was not found")
+endif()
+if(NOT patched STREQUAL content)
+    file(WRITE ${PARSER_SOURCE} "${patched}")
+endif()
@@ -453,15 +453,9 @@ static void sysml2_build_push(SysmlParserContext *ctx, SysmlNodeKind kind, const
     if (!ctx->build_ctx) return;
 
     /* First, attach any pending statements to the CURRENT scope (parent) before creating child */
-    const char *current_scope = sysml2_build_current_scope(ctx->build_ctx);
-    if (current_scope) {
-        for (size_t i = ctx->build_ctx->element_count; i > 0; i--) {
-            SysmlNode *parent_node = ctx->build_ctx->elements[i - 1];
-            if (parent_node->id == current_scope) {
-                sysml2_attach_pending_stmts(ctx->build_ctx, parent_node);
-                break;
-            }
-        }
+    SysmlNode *parent_node = sysml2_build_current_scope_node(ctx->build_ctx);
+    if (parent_node) {
+        sysml2_attach_pending_stmts(ctx->build_ctx, parent_node);
     }
 
     const char *name = sysml2_extract_name(ctx, text, len);
@@ -486,15 +480,9 @@ static void sysml2_build_push_shorthand(SysmlParserContext *ctx, const char *tex
     if (!ctx->build_ctx) return;
 
     /* First, attach any pending statements to the CURRENT scope (parent) before creating child */
-    const char *current_scope = sysml2_build_current_scope(ctx->build_ctx);
-    if (current_scope) {
-        for (size_t i = ctx->build_ctx->element_count; i > 0; i--) {
-            SysmlNode *parent_node = ctx->build_ctx->elements[i - 1];
-            if (parent_node->id == current_scope) {
-                sysml2_attach_pending_stmts(ctx->build_ctx, parent_node);
-                break;
-            }
-        }
+    SysmlNode *parent_node = sysml2_build_current_scope_node(ctx->build_ctx);
+    if (parent_node) {
+        sysml2_attach_pending_stmts(ctx->build_ctx, parent_node);
     }
 
     /* Extract name from the qualified name (redefines target) - use it as the node name */
@@ -533,15 +521,9 @@ static void sysml2_build_push_param(SysmlParserContext *ctx, const char *text, s
     ctx->build_ctx->pending_param_kind = SYSML_KIND_UNKNOWN;
 
     /* First, attach any pending statements to the CURRENT scope (parent) before creating child */
-    const char *current_scope = sysml2_build_current_scope(ctx->build_ctx);
-    if (current_scope) {
-        for (size_t i = ctx->build_ctx->element_count; i > 0; i--) {
-            SysmlNode *parent_node = ctx->build_ctx->elements[i - 1];
-            if (parent_node->id == current_scope) {
-                sysml2_attach_pending_stmts(ctx->build_ctx, parent_node);
-                break;
-            }
-        }
+    SysmlNode *parent_node = sysml2_build_current_scope_node(ctx->build_ctx);
+    if (parent_node) {
+        sysml2_attach_pending_stmts(ctx->build_ctx, parent_node);
     }
 
     const char *name = sysml2_extract_name(ctx, text, len);
@@ -566,15 +548,9 @@ static void sysml2_capture_body_end_trivia(SysmlParserContext *ctx) {
     if (!ctx->build_ctx) return;
 
     /* Find the current scope's node and attach body-end trivia */
-    const char *current_scope = sysml2_build_current_scope(ctx->build_ctx);
-    if (current_scope) {
-        for (size_t i = ctx->build_ctx->element_count; i > 0; i--) {
-            SysmlNode *node = ctx->build_ctx->elements[i - 1];
-            if (node->id == current_scope) {
-                sysml2_build_attach_pending_trailing_trivia(ctx->build_ctx, node);
-                break;
-            }
-        }
+    SysmlNode *node = sysml2_build_current_scope_node(ctx->build_ctx);
+    if (node) {
+        sysml2_build_attach_pending_trailing_trivia(ctx->build_ctx, node);
     }
 }
 
@@ -583,16 +559,10 @@ static void sysml2_pop(SysmlParserContext *ctx) {
     if (!ctx->build_ctx) return;
 
     /* Find the current scope's node and attach pending statements */
-    const char *current_scope = sysml2_build_current_scope(ctx->build_ctx);
-    if (current_scope) {
-        for (size_t i = ctx->build_ctx->element_count; i > 0; i--) {
-            SysmlNode *node = ctx->build_ctx->elements[i - 1];
-            if (node->id == current_scope) {
-                sysml2_attach_pending_stmts(ctx->build_ctx, node);
-                /* NOTE: Trailing trivia is captured by sysml2_capture_body_end_trivia BEFORE RBRACE */
-                break;
-            }
-        }
+    SysmlNode *node = sysml2_build_current_scope_node(ctx->build_ctx);
+    if (node) {
+        sysml2_attach_pending_stmts(ctx->build_ctx, node);
+        /* NOTE: Trailing trivia is captured by sysml2_capture_body_end_trivia BEFORE RBRACE */
     }
 
     sysml2_build_pop_scope(ctx->build_ctx);
@@ -1779,7 +1749,7 @@ static size_t pcc_get_char_as_utf32(pcc_context_t *ctx, int *out) { /* with chec
 
 MARK_FUNC_AS_USED
 static pcc_bool_t pcc_apply_rule(pcc_context_t *ctx, pcc_rule_t rule, pcc_thunk_array_t *thunks, pcc_value_t *value) {
-    static pcc_value_t null;
+    static _Thread_local pcc_value_t null;
     pcc_thunk_chunk_t *c = NULL;
     const size_t p = ctx->pos + ctx->cur;
     pcc_bool_t b = PCC_TRUE;
@@ -2026,7 +1996,7 @@ static void pcc_action_Package_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t *__pcc
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_PACKAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_PACKAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -2066,7 +2036,7 @@ static void pcc_action_LibraryPackage_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_LIBRARY_PACKAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_LIBRARY_PACKAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -2120,7 +2090,7 @@ static void pcc_action_Import_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t *__pcc_
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_import(auxil, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_import(auxil, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -2166,7 +2136,7 @@ static void pcc_action_NamespaceDefinition_0(sysml2_context_t *__pcc_ctx, pcc_th
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_NAMESPACE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_NAMESPACE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -2220,7 +2190,7 @@ static void pcc_action_TypeDefinition_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_TYPE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_TYPE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -2274,7 +2244,7 @@ static void pcc_action_ClassifierDefinition_0(sysml2_context_t *__pcc_ctx, pcc_t
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_CLASSIFIER, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_CLASSIFIER, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -2314,7 +2284,7 @@ static void pcc_action_ClassDefinition_0(sysml2_context_t *__pcc_ctx, pcc_thunk_
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_CLASS, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_CLASS, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -2354,7 +2324,7 @@ static void pcc_action_StructureDefinition_0(sysml2_context_t *__pcc_ctx, pcc_th
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_STRUCTURE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_STRUCTURE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -2394,7 +2364,7 @@ static void pcc_action_MetaclassDefinition_0(sysml2_context_t *__pcc_ctx, pcc_th
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_METACLASS, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_METACLASS, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -2434,7 +2404,7 @@ static void pcc_action_AssociationDefinition_0(sysml2_context_t *__pcc_ctx, pcc_
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_ASSOCIATION, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_ASSOCIATION, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -2474,7 +2444,7 @@ static void pcc_action_AssociationStructureDefinition_0(sysml2_context_t *__pcc_
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_ASSOC_STRUCT, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_ASSOC_STRUCT, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -2514,7 +2484,7 @@ static void pcc_action_InteractionDefinition_0(sysml2_context_t *__pcc_ctx, pcc_
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_INTERACTION, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_INTERACTION, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -2554,7 +2524,7 @@ static void pcc_action_BehaviorDefinition_0(sysml2_context_t *__pcc_ctx, pcc_thu
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_BEHAVIOR, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_BEHAVIOR, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -2608,7 +2578,7 @@ static void pcc_action_FunctionDefinition_0(sysml2_context_t *__pcc_ctx, pcc_thu
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_FUNCTION, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_FUNCTION, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -2662,7 +2632,7 @@ static void pcc_action_PredicateDefinition_0(sysml2_context_t *__pcc_ctx, pcc_th
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_PREDICATE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_PREDICATE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -2702,7 +2672,7 @@ static void pcc_action_MultiplicityDefinition_0(sysml2_context_t *__pcc_ctx, pcc
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_MULTIPLICITY_DEF, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_MULTIPLICITY_DEF, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -2742,7 +2712,7 @@ static void pcc_action_ImplicitFeatureDefinition_0(sysml2_context_t *__pcc_ctx,
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_FEATURE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_FEATURE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -2782,7 +2752,7 @@ static void pcc_action_EndWithFeatureKeyword_0(sysml2_context_t *__pcc_ctx, pcc_
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_FEATURE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_FEATURE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -2822,7 +2792,7 @@ static void pcc_action_EndWithoutFeatureKeyword_0(sysml2_context_t *__pcc_ctx, p
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_FEATURE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_FEATURE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -2862,7 +2832,7 @@ static void pcc_action_FeatureDefinition_0(sysml2_context_t *__pcc_ctx, pcc_thun
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_FEATURE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_FEATURE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -2902,7 +2872,7 @@ static void pcc_action_StepDefinition_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_STEP, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_STEP, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -2942,7 +2912,7 @@ static void pcc_action_ExpressionDefinition_0(sysml2_context_t *__pcc_ctx, pcc_t
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_EXPRESSION, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_EXPRESSION, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -2982,7 +2952,7 @@ static void pcc_action_BooleanExpressionDefinition_0(sysml2_context_t *__pcc_ctx
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_BOOL_EXPRESSION, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_BOOL_EXPRESSION, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -3022,7 +2992,7 @@ static void pcc_action_InvariantDefinition_0(sysml2_context_t *__pcc_ctx, pcc_th
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_INVARIANT, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_INVARIANT, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -3062,7 +3032,7 @@ static void pcc_action_ConnectorDefinition_0(sysml2_context_t *__pcc_ctx, pcc_th
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_CONNECTOR, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_CONNECTOR, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -3102,7 +3072,7 @@ static void pcc_action_BindingConnectorNamed_0(sysml2_context_t *__pcc_ctx, pcc_
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_BINDING_CONNECTOR, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_BINDING_CONNECTOR, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -3252,7 +3222,7 @@ static void pcc_action_SuccessionNamed_0(sysml2_context_t *__pcc_ctx, pcc_thunk_
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_SUCCESSION, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_SUCCESSION, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -3402,7 +3372,7 @@ static void pcc_action_KerMLFlowNamed_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_KERML_FLOW, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_KERML_FLOW, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -3634,7 +3604,7 @@ static void pcc_action_SuccessionFlowNamed_0(sysml2_context_t *__pcc_ctx, pcc_th
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_SUCCESSION_FLOW, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_SUCCESSION_FLOW, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -3866,7 +3836,7 @@ static void pcc_action_PrefixMetadata_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_capture_prefix_metadata(auxil, _1, _1e - _1s);
+    if (auxil->build_ctx) sysml2_capture_prefix_metadata(auxil, _1, _1e - _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -3886,7 +3856,7 @@ static void pcc_action_MetadataUsage_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_capture_start_metadata(auxil, _1, _1e - _1s);
+    if (auxil->build_ctx) sysml2_capture_start_metadata(auxil, _1, _1e - _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -3949,7 +3919,7 @@ static void pcc_action_MetadataBodyFeature_0(sysml2_context_t *__pcc_ctx, pcc_th
 #define _2 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[1])
 #define _2s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[1]->range.start))
 #define _2e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[1]->range.end))
-    sysml2_capture_metadata_feature(auxil, _1, _1e - _1s, _2, _2e - _2s);
+    if (auxil->build_ctx) sysml2_capture_metadata_feature(auxil, _1, _1e - _1s, _2, _2e - _2s);
 #undef _2e
 #undef _2s
 #undef _2
@@ -3972,7 +3942,7 @@ static void pcc_action_MetadataBodyShorthandFeature_0(sysml2_context_t *__pcc_ct
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_capture_metadata_shorthand_feature(auxil, _1, _1e - _1s);
+    if (auxil->build_ctx) sysml2_capture_metadata_shorthand_feature(auxil, _1, _1e - _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -4096,7 +4066,7 @@ static void pcc_action_AttributeDefinition_0(sysml2_context_t *__pcc_ctx, pcc_th
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_ATTRIBUTE_DEF, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_ATTRIBUTE_DEF, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -4136,7 +4106,7 @@ static void pcc_action_EnumerationDefinition_0(sysml2_context_t *__pcc_ctx, pcc_
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_ENUMERATION_DEF, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_ENUMERATION_DEF, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -4176,7 +4146,7 @@ static void pcc_action_DatatypeDefinition_0(sysml2_context_t *__pcc_ctx, pcc_thu
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_DATATYPE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_DATATYPE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -4256,7 +4226,7 @@ static void pcc_action_EnumeratedValueVariant_2(sysml2_context_t *__pcc_ctx, pcc
 #define _2 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[1])
 #define _2s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[1]->range.start))
 #define _2e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[1]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_ENUMERATION_USAGE, _2, _2e - _2s, _2s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_ENUMERATION_USAGE, _2, _2e - _2s, _2s);
 #undef _2e
 #undef _2s
 #undef _2
@@ -4296,7 +4266,7 @@ static void pcc_action_OccurrenceDefinitionExplicit_0(sysml2_context_t *__pcc_ct
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_OCCURRENCE_DEF, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_OCCURRENCE_DEF, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -4336,7 +4306,7 @@ static void pcc_action_OccurrenceDefinitionShorthand_0(sysml2_context_t *__pcc_c
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_OCCURRENCE_DEF, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_OCCURRENCE_DEF, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -4390,7 +4360,7 @@ static void pcc_action_ItemDefinition_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_ITEM_DEF, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_ITEM_DEF, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -4430,7 +4400,7 @@ static void pcc_action_PartDefinition_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_PART_DEF, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_PART_DEF, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -4470,7 +4440,7 @@ static void pcc_action_ConnectionDefinition_0(sysml2_context_t *__pcc_ctx, pcc_t
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_CONNECTION_DEF, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_CONNECTION_DEF, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -4510,7 +4480,7 @@ static void pcc_action_FlowDefinition_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_FLOW_DEF, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_FLOW_DEF, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -4550,7 +4520,7 @@ static void pcc_action_InterfaceDefinition_0(sysml2_context_t *__pcc_ctx, pcc_th
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_INTERFACE_DEF, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_INTERFACE_DEF, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -4604,7 +4574,7 @@ static void pcc_action_PortDefinition_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_PORT_DEF, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_PORT_DEF, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -4658,7 +4628,7 @@ static void pcc_action_AllocationDefinition_0(sysml2_context_t *__pcc_ctx, pcc_t
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_ALLOCATION_DEF, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_ALLOCATION_DEF, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -4718,7 +4688,7 @@ static void pcc_action_ActionDefinition_1(sysml2_context_t *__pcc_ctx, pcc_thunk
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_ACTION_DEF, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_ACTION_DEF, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -4792,7 +4762,7 @@ static void pcc_action_StateDefinition_1(sysml2_context_t *__pcc_ctx, pcc_thunk_
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_STATE_DEF, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_STATE_DEF, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -4906,7 +4876,7 @@ static void pcc_action_PerformActionUsage_0(sysml2_context_t *__pcc_ctx, pcc_thu
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_PERFORM_ACTION_USAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_PERFORM_ACTION_USAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -4966,7 +4936,7 @@ static void pcc_action_PerformActionUsage_3(sysml2_context_t *__pcc_ctx, pcc_thu
 #define _2 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[1])
 #define _2s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[1]->range.start))
 #define _2e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[1]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_PERFORM_ACTION_USAGE, _2, _2e - _2s, _2s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_PERFORM_ACTION_USAGE, _2, _2e - _2s, _2s);
 #undef _2e
 #undef _2s
 #undef _2
@@ -5026,7 +4996,7 @@ static void pcc_action_ConstraintDefinition_0(sysml2_context_t *__pcc_ctx, pcc_t
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_CONSTRAINT_DEF, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_CONSTRAINT_DEF, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -5080,7 +5050,7 @@ static void pcc_action_RequirementDefinition_0(sysml2_context_t *__pcc_ctx, pcc_
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_REQUIREMENT_DEF, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_REQUIREMENT_DEF, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -5134,7 +5104,7 @@ static void pcc_action_ConcernDefinition_0(sysml2_context_t *__pcc_ctx, pcc_thun
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_CONCERN_DEF, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_CONCERN_DEF, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -5174,7 +5144,7 @@ static void pcc_action_CalcDefinition_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_CALC_DEF, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_CALC_DEF, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -5228,7 +5198,7 @@ static void pcc_action_CaseDefinition_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_CASE_DEF, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_CASE_DEF, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -5282,7 +5252,7 @@ static void pcc_action_AnalysisDefinition_0(sysml2_context_t *__pcc_ctx, pcc_thu
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_ANALYSIS_DEF, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_ANALYSIS_DEF, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -5322,7 +5292,7 @@ static void pcc_action_VerificationDefinition_0(sysml2_context_t *__pcc_ctx, pcc
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_VERIFICATION_DEF, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_VERIFICATION_DEF, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -5362,7 +5332,7 @@ static void pcc_action_UseCaseDefinition_0(sysml2_context_t *__pcc_ctx, pcc_thun
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_USE_CASE_DEF, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_USE_CASE_DEF, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -5402,7 +5372,7 @@ static void pcc_action_ViewDefinition_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_VIEW_DEF, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_VIEW_DEF, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -5456,7 +5426,7 @@ static void pcc_action_ViewpointDefinition_0(sysml2_context_t *__pcc_ctx, pcc_th
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_VIEWPOINT_DEF, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_VIEWPOINT_DEF, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -5496,7 +5466,7 @@ static void pcc_action_RenderingDefinition_0(sysml2_context_t *__pcc_ctx, pcc_th
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_RENDERING_DEF, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_RENDERING_DEF, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -5536,7 +5506,7 @@ static void pcc_action_MetadataDefinition_0(sysml2_context_t *__pcc_ctx, pcc_thu
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_METADATA_DEF, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_METADATA_DEF, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -5590,7 +5560,7 @@ static void pcc_action_PortionUsage_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t *
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_PORTION_USAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_PORTION_USAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -5650,7 +5620,7 @@ static void pcc_action_SuccessionUsage_0(sysml2_context_t *__pcc_ctx, pcc_thunk_
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_SUCCESSION, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_SUCCESSION, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -5768,7 +5738,7 @@ static void pcc_action_ReferenceUsage_1(sysml2_context_t *__pcc_ctx, pcc_thunk_t
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_FEATURE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_FEATURE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -5808,7 +5778,7 @@ static void pcc_action_ReferenceUsage_3(sysml2_context_t *__pcc_ctx, pcc_thunk_t
 #define _2 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[1])
 #define _2s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[1]->range.start))
 #define _2e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[1]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_FEATURE, _2, _2e - _2s, _2s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_FEATURE, _2, _2e - _2s, _2s);
 #undef _2e
 #undef _2s
 #undef _2
@@ -5888,7 +5858,7 @@ static void pcc_action_AttributeUsage_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_ATTRIBUTE_USAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_ATTRIBUTE_USAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -5928,7 +5898,7 @@ static void pcc_action_EnumerationUsage_0(sysml2_context_t *__pcc_ctx, pcc_thunk
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_ENUMERATION_USAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_ENUMERATION_USAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -5968,7 +5938,7 @@ static void pcc_action_OccurrenceUsage_0(sysml2_context_t *__pcc_ctx, pcc_thunk_
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_OCCURRENCE_USAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_OCCURRENCE_USAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -6022,7 +5992,7 @@ static void pcc_action_EventOccurrenceUsage_1(sysml2_context_t *__pcc_ctx, pcc_t
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_EVENT_USAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_EVENT_USAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -6062,7 +6032,7 @@ static void pcc_action_EventUsage_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t *__
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_EVENT_USAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_EVENT_USAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -6102,7 +6072,7 @@ static void pcc_action_EventUsage_2(sysml2_context_t *__pcc_ctx, pcc_thunk_t *__
 #define _2 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[1])
 #define _2s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[1]->range.start))
 #define _2e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[1]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_EVENT_USAGE, _2, _2e - _2s, _2s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_EVENT_USAGE, _2, _2e - _2s, _2s);
 #undef _2e
 #undef _2s
 #undef _2
@@ -6142,7 +6112,7 @@ static void pcc_action_EventUsage_4(sysml2_context_t *__pcc_ctx, pcc_thunk_t *__
 #define _3 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[2])
 #define _3s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[2]->range.start))
 #define _3e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[2]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_EVENT_USAGE, _3, _3e - _3s, _3s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_EVENT_USAGE, _3, _3e - _3s, _3s);
 #undef _3e
 #undef _3s
 #undef _3
@@ -6182,7 +6152,7 @@ static void pcc_action_EventUsage_6(sysml2_context_t *__pcc_ctx, pcc_thunk_t *__
 #define _4 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[3])
 #define _4s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[3]->range.start))
 #define _4e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[3]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_EVENT_USAGE, _4, _4e - _4s, _4s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_EVENT_USAGE, _4, _4e - _4s, _4s);
 #undef _4e
 #undef _4s
 #undef _4
@@ -6222,7 +6192,7 @@ static void pcc_action_EventUsage_8(sysml2_context_t *__pcc_ctx, pcc_thunk_t *__
 #define _5 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[4])
 #define _5s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[4]->range.start))
 #define _5e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[4]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_EVENT_USAGE, _5, _5e - _5s, _5s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_EVENT_USAGE, _5, _5e - _5s, _5s);
 #undef _5e
 #undef _5s
 #undef _5
@@ -6276,7 +6246,7 @@ static void pcc_action_ItemUsage_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t *__p
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_ITEM_USAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_ITEM_USAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -6316,7 +6286,7 @@ static void pcc_action_PartUsage_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t *__p
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_PART_USAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_PART_USAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -6356,7 +6326,7 @@ static void pcc_action_ConnectionUsageNamed_0(sysml2_context_t *__pcc_ctx, pcc_t
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_CONNECTION_USAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_CONNECTION_USAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -6440,7 +6410,7 @@ static void pcc_action_ConnectionUsageNamed_3(sysml2_context_t *__pcc_ctx, pcc_t
 #define _4 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[3])
 #define _4s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[3]->range.start))
 #define _4e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[3]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_CONNECTION_USAGE, _4, _4e - _4s, _4s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_CONNECTION_USAGE, _4, _4e - _4s, _4s);
 #undef _4e
 #undef _4s
 #undef _4
@@ -6526,7 +6496,7 @@ static void pcc_action_FlowBody_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t *__pc
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_FLOW_USAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_FLOW_USAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -6750,7 +6720,7 @@ static void pcc_action_InterfaceUsageNamedBinaryConnect_0(sysml2_context_t *__pc
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_INTERFACE_USAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_INTERFACE_USAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -6854,7 +6824,7 @@ static void pcc_action_InterfaceUsageNamedNaryConnect_0(sysml2_context_t *__pcc_
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_INTERFACE_USAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_INTERFACE_USAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -6914,7 +6884,7 @@ static void pcc_action_InterfaceUsageNamed_0(sysml2_context_t *__pcc_ctx, pcc_th
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_INTERFACE_USAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_INTERFACE_USAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -6954,7 +6924,7 @@ static void pcc_action_PortUsage_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t *__p
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_PORT_USAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_PORT_USAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -6994,7 +6964,7 @@ static void pcc_action_AllocationUsage_0(sysml2_context_t *__pcc_ctx, pcc_thunk_
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_ALLOCATION_USAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_ALLOCATION_USAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -7060,7 +7030,7 @@ static void pcc_action_ActionUsage_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t *_
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_ACTION_USAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_ACTION_USAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -7134,7 +7104,7 @@ static void pcc_action_StateUsage_1(sysml2_context_t *__pcc_ctx, pcc_thunk_t *__
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_STATE_USAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_STATE_USAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -7194,7 +7164,7 @@ static void pcc_action_ExhibitStateUsage_0(sysml2_context_t *__pcc_ctx, pcc_thun
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_STATE_USAGE, _1, _1e - _1s, _1s); if (auxil->build_ctx) sysml2_set_exhibit_on_current(auxil->build_ctx);
+    if (auxil->build_ctx) { sysml2_build_push(auxil, SYSML_KIND_STATE_USAGE, _1, _1e - _1s, _1s); sysml2_set_exhibit_on_current(auxil->build_ctx); }
 #undef _1e
 #undef _1s
 #undef _1
@@ -7254,7 +7224,7 @@ static void pcc_action_ExhibitStateUsage_3(sysml2_context_t *__pcc_ctx, pcc_thun
 #define _2 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[1])
 #define _2s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[1]->range.start))
 #define _2e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[1]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_STATE_USAGE, _2, _2e - _2s, _2s); if (auxil->build_ctx) sysml2_set_exhibit_on_current(auxil->build_ctx);
+    if (auxil->build_ctx) { sysml2_build_push(auxil, SYSML_KIND_STATE_USAGE, _2, _2e - _2s, _2s); sysml2_set_exhibit_on_current(auxil->build_ctx); }
 #undef _2e
 #undef _2s
 #undef _2
@@ -7314,7 +7284,7 @@ static void pcc_action_ConstraintUsage_0(sysml2_context_t *__pcc_ctx, pcc_thunk_
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_CONSTRAINT_USAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_CONSTRAINT_USAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -7354,7 +7324,7 @@ static void pcc_action_RequirementUsage_0(sysml2_context_t *__pcc_ctx, pcc_thunk
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_REQUIREMENT_USAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_REQUIREMENT_USAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -7394,7 +7364,7 @@ static void pcc_action_ConcernUsage_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t *
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_CONCERN_USAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_CONCERN_USAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -7434,7 +7404,7 @@ static void pcc_action_CalcUsage_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t *__p
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_CALC_USAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_CALC_USAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -7474,7 +7444,7 @@ static void pcc_action_CaseUsage_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t *__p
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_CASE_USAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_CASE_USAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -7514,7 +7484,7 @@ static void pcc_action_AnalysisUsage_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_ANALYSIS_USAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_ANALYSIS_USAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -7554,7 +7524,7 @@ static void pcc_action_VerificationUsage_0(sysml2_context_t *__pcc_ctx, pcc_thun
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_VERIFICATION_USAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_VERIFICATION_USAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -7594,7 +7564,7 @@ static void pcc_action_UseCaseUsage_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t *
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_USE_CASE_USAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_USE_CASE_USAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -7634,7 +7604,7 @@ static void pcc_action_ViewUsage_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t *__p
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_VIEW_USAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_VIEW_USAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -7674,7 +7644,7 @@ static void pcc_action_ViewpointUsage_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_VIEWPOINT_USAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_VIEWPOINT_USAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -7714,7 +7684,7 @@ static void pcc_action_RenderingUsage_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_RENDERING_USAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_RENDERING_USAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -7922,7 +7892,7 @@ static void pcc_action_ParameterUsage_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push_param(auxil, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push_param(auxil, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -8624,7 +8594,7 @@ static void pcc_action_ShorthandFeatureWithBody_0(sysml2_context_t *__pcc_ctx, p
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push_shorthand(auxil, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push_shorthand(auxil, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -8684,7 +8654,7 @@ static void pcc_action_ShorthandRedefinesWithBody_0(sysml2_context_t *__pcc_ctx,
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push_shorthand(auxil, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push_shorthand(auxil, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -8864,7 +8834,7 @@ static void pcc_action_AssertConstraintWithKW_0(sysml2_context_t *__pcc_ctx, pcc
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_CONSTRAINT_USAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_CONSTRAINT_USAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -9148,7 +9118,7 @@ static void pcc_action_EndMemberBody_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_END_FEATURE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_END_FEATURE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -9188,7 +9158,7 @@ static void pcc_action_MessageUsage_0(sysml2_context_t *__pcc_ctx, pcc_thunk_t *
 #define _1 pcc_get_capture_string(__pcc_ctx, __pcc_in->data.leaf.capts.buf[0])
 #define _1s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.start))
 #define _1e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capts.buf[0]->range.end))
-    sysml2_build_push(auxil, SYSML_KIND_MESSAGE_USAGE, _1, _1e - _1s, _1s);
+    if (auxil->build_ctx) sysml2_build_push(auxil, SYSML_KIND_MESSAGE_USAGE, _1, _1e - _1s, _1s);
 #undef _1e
 #undef _1s
 #undef _1
@@ -8,6 +8,10 @@
 #include <string.h>
 #include <ctype.h>
 
+#include "sysml2/parser_pool.h"
+#include "sysml2/memory_budget.h"
+#include "sysml2/utils.h"
+
 /* Forward declaration for AST builder */
 struct SysmlBuildContext;
 
@@ -17,13 +21,9 @@ typedef struct {
     size_t input_len;
     size_t input_pos;
     int error_count;
-    int line;
-    int col;
 
     /* Furthest failure tracking for better error messages */
     size_t furthest_pos;
-    int furthest_line;
-    int furthest_col;
     const char *failed_rules[16];  /* Rules that failed at furthest pos */
     int failed_rule_count;
     const char *context_rule;       /* Enclosing rule for context */
@@ -34,21 +34,49 @@ typedef struct {
 
     /* AST building context (optional, NULL if not building AST) */
     struct SysmlBuildContext *build_ctx;
+
+    /* Stream for syntax error reports (NULL = stderr) */
+    FILE *err_out;
+
+    /* Input was cut off because the memory budget tripped */
+    bool memory_stop;
+
+    /* Line start offsets, built on first use by sysml2_pos_to_line_col();
+     * release with sysml2_parser_context_release() */
+    uint32_t *line_offsets;
+    uint32_t line_count;
 } SysmlParserContext;
 
 #define PCC_GETCHAR(auxil) sysml2_getchar(auxil)
 #define PCC_ERROR(auxil) sysml2_error(auxil)
 
+/* Parser allocations come from a per-thread pool that outlives each parse */
+#define PCC_MALLOC(auxil, size) sysml2_parser_pool_alloc(size)
+#define PCC_REALLOC(auxil, ptr, size) sysml2_parser_pool_realloc((ptr), (size))
+#define PCC_FREE(auxil, ptr) sysml2_parser_pool_free(ptr)
+
+/* PackCC's default starts each thunk and memo pool at 65536 entries,
+ * some 19 MB per parse before any input is read; start small and let the
+ * pools double as the input needs them */
+#define PCC_POOL_MIN_SIZE 256
+
+/* Only the byte offset is tracked; lines and columns are derived on demand */
 static inline int sysml2_getchar(SysmlParserContext *ctx) {
     if (ctx->input_pos >= ctx->input_len) return EOF;
-    int c = (unsigned char)ctx->input[ctx->input_pos++];
-    if (c == '\n') {
-        ctx->line++;
-        ctx->col = 1;
-    } else {
-        ctx->col++;
+    /* Past the memory limit the rest of the input is cut off */
+    if ((ctx->input_pos & (SYSML2_MEMORY_CHECK_INTERVAL - 1)) == 0 && ctx->input_pos > 0 &&
+        sysml2_memory_exceeded()) {
+        ctx->memory_stop = true;
+        ctx->input_len = ctx->input_pos;
+        return EOF;
     }
-    return c;
+    return (unsigned char)ctx->input[ctx->input_pos++];
+}
+
+static inline void sysml2_parser_context_release(SysmlParserContext *ctx) {
+    free(ctx->line_offsets);
+    ctx->line_offsets = NULL;
+    ctx->line_count = 0;
 }
 
 /* Check if a rule name is "noise" that we don't want to report */
@@ -74,8 +102,6 @@ static inline void sysml2_debug_hook(SysmlParserContext *ctx, int event,
     if (pos > ctx->furthest_pos) {
         /* New furthest position - reset tracking */
         ctx->furthest_pos = pos;
-        ctx->furthest_line = ctx->line;
-        ctx->furthest_col = ctx->col;
         ctx->failed_rule_count = 0;
         ctx->context_rule = NULL;
     }
@@ -225,12 +251,24 @@ static const char *sysml2_keyword_help(const char *keyword) {
     return NULL;
 }
 
-/* Compute line and column from position */
+/* Compute line and column from position (binary search over line starts) */
 static void sysml2_pos_to_line_col(SysmlParserContext *ctx, size_t pos,
                                    int *out_line, int *out_col) {
+    if (pos > ctx->input_len) pos = ctx->input_len;
+    if (!ctx->line_offsets) {
+        ctx->line_offsets = sysml2_build_line_offsets(ctx->input, ctx->input_len, &ctx->line_count);
+    }
+    if (ctx->line_offsets) {
+        uint32_t index = sysml2_line_index_find(ctx->line_offsets, ctx->line_count, pos);
+        *out_line = (int)index + 1;
+        *out_col = (int)(pos - ctx->line_offsets[index]) + 1;
+        return;
+    }
+
+    /* Out of memory for the index: count from the start */
     int line = 1;
     int col = 1;
-    for (size_t i = 0; i < pos && i < ctx->input_len; i++) {
+    for (size_t i = 0; i < pos; i++) {
         if (ctx->input[i] == '\n') {
             line++;
             col = 1;
@@ -244,14 +282,16 @@ static void sysml2_pos_to_line_col(SysmlParserContext *ctx, size_t pos,
 
 static inline void sysml2_error(SysmlParserContext *ctx) {
     ctx->error_count++;
+    /* A cut-off input is reported as a memory limit breach, not a syntax error */
+    if (ctx->memory_stop) return;
+    FILE *out = ctx->err_out ? ctx->err_out : stderr;
 
     /* Use furthest position for error location if available */
     int err_line, err_col;
     if (ctx->furthest_pos > 0 && ctx->failed_rule_count > 0) {
         sysml2_pos_to_line_col(ctx, ctx->furthest_pos, &err_line, &err_col);
     } else {
-        err_line = ctx->line;
-        err_col = ctx->col;
+        sysml2_pos_to_line_col(ctx, ctx->input_pos, &err_line, &err_col);
     }
 
     /* Build expectation message from failed rules */
@@ -286,30 +326,30 @@ static inline void sysml2_error(SysmlParserContext *ctx) {
     while (*line_end && *line_end != '\n') line_end++;
 
     /* Print error header with specific expectation if available */
-    fprintf(stderr, ANSI_BOLD "%s:%d:%d: " ANSI_RED "error: " ANSI_RESET ANSI_BOLD,
+    fprintf(out, ANSI_BOLD "%s:%d:%d: " ANSI_RED "error: " ANSI_RESET ANSI_BOLD,
             ctx->filename, err_line, err_col);
 
     if (count > 0) {
-        fprintf(stderr, "expected %s" ANSI_RESET "\n", expected);
+        fprintf(out, "expected %s" ANSI_RESET "\n", expected);
     } else {
-        fprintf(stderr, "syntax error" ANSI_RESET "\n");
+        fprintf(out, "syntax error" ANSI_RESET "\n");
     }
 
     /* Print source line context */
-    fprintf(stderr, " %5d | %.*s\n", err_line, (int)(line_end - line_start), line_start);
-    fprintf(stderr, "       | " ANSI_GREEN);
+    fprintf(out, " %5d | %.*s\n", err_line, (int)(line_end - line_start), line_start);
+    fprintf(out, "       | " ANSI_GREEN);
     for (int i = 1; i < err_col; i++) {
         char c = (i <= (int)(line_end - line_start)) ? line_start[i-1] : ' ';
-        fprintf(stderr, "%c", (c == '\t') ? '\t' : ' ');
+        fprintf(out, "%c", (c == '\t') ? '\t' : ' ');
     }
-    fprintf(stderr, "^" ANSI_RESET "\n");
+    fprintf(out, "^" ANSI_RESET "\n");
 
     /* Add context about which keyword was being parsed */
     if (ctx->last_keyword && ctx->last_keyword_pos > 0 &&
         ctx->last_keyword_pos <= ctx->furthest_pos &&
         ctx->furthest_pos - ctx->last_keyword_pos < 50) {
 
-        fprintf(stderr, "       = " ANSI_CYAN "note: " ANSI_RESET
+        fprintf(out, "       = " ANSI_CYAN "note: " ANSI_RESET
                 "parsing failed after '%s' keyword\n", ctx->last_keyword);
 
         /* Try keyword-specific help if we don't have help yet */
@@ -320,7 +360,7 @@ static inline void sysml2_error(SysmlParserContext *ctx) {
 
     /* Print help text if available */
     if (help) {
-        fprintf(stderr, "       = " ANSI_CYAN "help: " ANSI_RESET "%s\n", help);
+        fprintf(out, "       = " ANSI_CYAN "help: " ANSI_RESET "%s\n", help);
     }
 }
 
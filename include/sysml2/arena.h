@@ -3,6 +3,7 @@
  *
  * Fast bump allocator for parser memory management.
  * Memory is allocated in large blocks and freed all at once.
+ * Blocks are charged to the process memory budget (memory_budget.h).
  *
  * SPDX-License-Identifier: MIT
  */
@@ -32,6 +33,18 @@ typedef struct {
     size_t total_allocated;     /* Total bytes allocated */
 } Sysml2Arena;
 
+/*
+ * Arena checkpoint
+ *
+ * Records how far an arena had been filled; sysml2_arena_rewind() gives
+ * back everything allocated after it.
+ */
+typedef struct {
+    Sysml2ArenaBlock *block;    /* Current block at the mark (NULL if none) */
+    size_t used;                /* Bytes used in that block */
+    size_t total_allocated;
+} Sysml2ArenaMark;
+
 /* Initialize an arena with default block size */
 void sysml2_arena_init(Sysml2Arena *arena);
 
@@ -68,6 +81,37 @@ char *sysml2_arena_sprintf(Sysml2Arena *arena, const char *fmt, ...) SYSML2_PRIN
 /* Get total memory used by the arena */
 size_t sysml2_arena_used(const Sysml2Arena *arena);
 
+/*
+ * Take a checkpoint of the arena
+ *
+ * @param arena Arena
+ * @return Mark for sysml2_arena_rewind()
+ */
+Sysml2ArenaMark sysml2_arena_mark(const Sysml2Arena *arena);
+
+/*
+ * Discard everything allocated since a mark
+ *
+ * Blocks added after the mark are freed. Nothing allocated after the mark
+ * may be referenced afterwards; strings interned into this arena since the
+ * mark must first be dropped with sysml2_intern_rewind(). Marks are
+ * nested: rewinding to a mark invalidates all later marks.
+ *
+ * @param arena Arena
+ * @param mark Mark taken from this arena
+ */
+void sysml2_arena_rewind(Sysml2Arena *arena, Sysml2ArenaMark mark);
+
+/*
+ * Check whether a pointer was allocated after a mark
+ *
+ * @param arena Arena
+ * @param mark Mark taken from this arena
+ * @param ptr Pointer to test
+ * @return true if ptr lies in memory handed out since the mark
+ */
+bool sysml2_arena_allocated_since(const Sysml2Arena *arena, Sysml2ArenaMark mark, const void *ptr);
+
 /* Typed allocation macros */
 #define SYSML2_ARENA_NEW(arena, type) \
     ((type *)sysml2_arena_calloc((arena), 1, sizeof(type)))
@@ -75,4 +119,44 @@ size_t sysml2_arena_used(const Sysml2Arena *arena);
 #define SYSML2_ARENA_NEW_ARRAY(arena, type, count) \
     ((type *)sysml2_arena_calloc((arena), (count), sizeof(type)))
 
+#ifdef SYSML2_ARENA_STATS
+#include <stdio.h>
+
+/*
+ * Allocation statistics (configure with -DSYSML2_ARENA_STATS=ON)
+ *
+ * Every arena allocation is counted by power-of-two size class and by call
+ * site. The wrappers below record the caller's file and line before each
+ * call; allocations made any other way are reported as "(unknown)".
+ * Counters are process-wide and shared by all arenas and threads.
+ */
+
+/* Set the call site for the calling thread's next allocation */
+void sysml2_arena_stats_site(const char *file, int line);
+
+/* Print size-class and call-site counters, largest sites first */
+void sysml2_arena_stats_print(FILE *out);
+
+/* Clear all counters */
+void sysml2_arena_stats_reset(void);
+
+#ifndef SYSML2_ARENA_IMPLEMENTATION
+#define SYSML2_ARENA_SITE_ sysml2_arena_stats_site(__FILE__, __LINE__)
+#define sysml2_arena_alloc(arena, size) \
+    (SYSML2_ARENA_SITE_, (sysml2_arena_alloc)((arena), (size)))
+#define sysml2_arena_alloc_aligned(arena, size, alignment) \
+    (SYSML2_ARENA_SITE_, (sysml2_arena_alloc_aligned)((arena), (size), (alignment)))
+#define sysml2_arena_calloc(arena, count, size) \
+    (SYSML2_ARENA_SITE_, (sysml2_arena_calloc)((arena), (count), (size)))
+#define sysml2_arena_strdup(arena, str) \
+    (SYSML2_ARENA_SITE_, (sysml2_arena_strdup)((arena), (str)))
+#define sysml2_arena_strndup(arena, str, length) \
+    (SYSML2_ARENA_SITE_, (sysml2_arena_strndup)((arena), (str), (length)))
+#define sysml2_arena_sv_dup(arena, sv) \
+    (SYSML2_ARENA_SITE_, (sysml2_arena_sv_dup)((arena), (sv)))
+#define sysml2_arena_sprintf(...) \
+    (SYSML2_ARENA_SITE_, (sysml2_arena_sprintf)(__VA_ARGS__))
+#endif
+#endif /* SYSML2_ARENA_STATS */
+
 #endif /* SYSML2_ARENA_H */
@@ -10,6 +10,7 @@
 #define SYSML2_AST_H
 
 #include "common.h"
+#include "arena.h"
 
 /*
  * Trivia Kind Enumeration
@@ -383,56 +384,15 @@ typedef enum {
 } SysmlVisibility;
 
 /*
- * AST Node - represents an element in the semantic graph
+ * Cold element data - value text, documentation, metadata, trivia and body
  *
- * Uses interned strings for memory efficiency.
+ * Only the writers, modify and the model cache read this; validation and
+ * queries never do. Elements that have none of it share no record at
+ * all (SysmlNode.cold is NULL), so read it through sysml2_node_cold().
  */
-typedef struct SysmlNode {
-    const char *id;           /* Path-based ID (e.g., "Pkg::PartDef::attr") */
-    const char *name;         /* Local name */
-    SysmlNodeKind kind;
-    const char *parent_id;    /* Parent element ID (containment) */
-
-    /* Type relationships */
-    const char **typed_by;       /* : Type (typing) */
-    size_t typed_by_count;
-    bool *typed_by_conjugated;   /* Parallel array: true if type has ~ prefix */
-
-    const char **specializes;    /* :> Type (specialization/subsetting) */
-    size_t specializes_count;
-
-    const char **redefines;      /* :>> Type (redefinition) */
-    size_t redefines_count;
-
-    const char **references;     /* ::> Type (referencing) */
-    size_t references_count;
-
-    /* Multiplicity bounds (e.g., [0..1], [1..*], [4]) */
-    const char *multiplicity_lower;  /* "0", "1", "*", etc. */
-    const char *multiplicity_upper;  /* "1", "*", etc. (NULL if same as lower) */
-
+typedef struct SysmlNodeCold {
     /* Default/initial value */
     const char *default_value;       /* Expression text */
-    bool has_default_keyword;        /* true if "default =" vs just "=" */
-
-    /* Modifiers */
-    bool is_abstract;
-    bool is_variation;
-    bool is_readonly;
-    bool is_derived;
-    bool is_constant;
-    bool is_ref;
-    bool is_end;                 /* true if 'end' keyword was present */
-    bool is_parallel;            /* true if 'parallel' keyword on state */
-    bool is_exhibit;             /* true if 'exhibit' keyword on state usage */
-    bool is_event_occurrence;    /* true if 'event occurrence' vs just 'event' */
-    bool is_standard_library;    /* true if library package declared with 'standard' prefix */
-    bool is_public_explicit;     /* true if 'public' keyword was explicit */
-    bool has_enum_keyword;       /* true if enum usage has 'enum' keyword prefix */
-    bool is_asserted;            /* true if 'assert' keyword was present */
-    bool is_negated;             /* true if 'not' keyword was present (assert not) */
-    bool has_connect_keyword;    /* true if 'connect' keyword was present in interface */
-    bool has_action_keyword;     /* true if 'action' keyword was present in perform */
 
     /* Specialized keyword for ref behavioral features (state, action, etc.) */
     const char *ref_behavioral_keyword;  /* NULL or "state", "action", etc. */
@@ -440,21 +400,12 @@ typedef struct SysmlNode {
     /* Portion kind for snapshot/timeslice usages */
     const char *portion_kind;    /* NULL or "snapshot", "timeslice" */
 
-    /* Direction (for parameters) */
-    SysmlDirection direction;
-
-    /* Visibility */
-    SysmlVisibility visibility;
-
     /* Parameter list for action/state definitions */
     const char *parameter_list;  /* Raw "(in x : T, out y)" for definitions */
 
     /* Connector/allocation parts for connections and allocations */
     const char *connector_part;  /* Raw "connect (a, b, c)" or "allocate X to Y" */
 
-    /* Source location for debugging */
-    Sysml2SourceLoc loc;
-
     /* Documentation comment (doc comment text) */
     const char *documentation;
     Sysml2SourceLoc doc_loc;      /* Source location for ordering */
@@ -489,8 +440,149 @@ typedef struct SysmlNode {
 
     /* Result expression (for calc/constraint bodies) */
     const char *result_expression;
+} SysmlNodeCold;
+
+/*
+ * AST Node - represents an element in the semantic graph
+ *
+ * Holds what name resolution, validation and queries sweep over; the
+ * rest lives in the separately allocated cold record. Uses interned
+ * strings for memory efficiency.
+ */
+typedef struct SysmlNode {
+    const char *id;           /* Path-based ID (e.g., "Pkg::PartDef::attr") */
+    const char *name;         /* Local name */
+    SysmlNodeKind kind;
+
+    /* Modifiers */
+    bool has_default_keyword : 1;    /* true if "default =" vs just "=" */
+    bool is_abstract : 1;
+    bool is_variation : 1;
+    bool is_readonly : 1;
+    bool is_derived : 1;
+    bool is_constant : 1;
+    bool is_ref : 1;
+    bool is_end : 1;                 /* true if 'end' keyword was present */
+    bool is_parallel : 1;            /* true if 'parallel' keyword on state */
+    bool is_exhibit : 1;             /* true if 'exhibit' keyword on state usage */
+    bool is_event_occurrence : 1;    /* true if 'event occurrence' vs just 'event' */
+    bool is_standard_library : 1;    /* true if library package declared with 'standard' prefix */
+    bool is_public_explicit : 1;     /* true if 'public' keyword was explicit */
+    bool has_enum_keyword : 1;       /* true if enum usage has 'enum' keyword prefix */
+    bool is_asserted : 1;            /* true if 'assert' keyword was present */
+    bool is_negated : 1;             /* true if 'not' keyword was present (assert not) */
+    bool has_connect_keyword : 1;    /* true if 'connect' keyword was present in interface */
+    bool has_action_keyword : 1;     /* true if 'action' keyword was present in perform */
+    bool has_path : 1;               /* parent, depth and name_offset are set */
+
+    const char *parent_id;    /* Parent element ID (containment) */
+
+    /* Containment path, worked out once from id and parent_id so that
+     * readers need not re-parse IDs; only valid if has_path (elements
+     * assembled by hand have it clear) */
+    const struct SysmlNode *parent;  /* An element whose id is parent_id (NULL: top level or unlinked) */
+    uint32_t depth;           /* Enclosing elements (top level = 0) */
+    uint32_t name_offset;     /* Local segment starts at id + name_offset (0 at top level) */
+
+    /* Type relationships */
+    const char **typed_by;       /* : Type (typing) */
+    size_t typed_by_count;
+    bool *typed_by_conjugated;   /* Parallel array: true if type has ~ prefix */
+
+    const char **specializes;    /* :> Type (specialization/subsetting) */
+    size_t specializes_count;
+
+    const char **redefines;      /* :>> Type (redefinition) */
+    size_t redefines_count;
+
+    const char **references;     /* ::> Type (referencing) */
+    size_t references_count;
+
+    /* Multiplicity bounds (e.g., [0..1], [1..*], [4]) */
+    const char *multiplicity_lower;  /* "0", "1", "*", etc. */
+    const char *multiplicity_upper;  /* "1", "*", etc. (NULL if same as lower) */
+
+    /* Direction (for parameters) */
+    SysmlDirection direction;
+
+    /* Visibility */
+    SysmlVisibility visibility;
+
+    /* Source location for debugging */
+    Sysml2SourceLoc loc;
+
+    /* Everything else (NULL if the element has none of it) */
+    SysmlNodeCold *cold;
 } SysmlNode;
 
+/* Cold record of elements that have none */
+extern const SysmlNodeCold sysml2_node_cold_empty;
+
+/*
+ * Cold data of an element, for reading
+ *
+ * @param node Element
+ * @return Its cold record, or an empty one if it has none (never NULL)
+ */
+SYSML2_INLINE const SysmlNodeCold *sysml2_node_cold(const SysmlNode *node) {
+    return node->cold ? node->cold : &sysml2_node_cold_empty;
+}
+
+/*
+ * Cold data of an element, for writing
+ *
+ * Allocates the record on first use. A node copied with *copy = *node
+ * shares its original's record; give the copy its own with
+ * sysml2_node_cold_detach before writing through it.
+ *
+ * @param arena Arena for the record
+ * @param node Element
+ * @return Writable cold record, or NULL on allocation failure
+ */
+SysmlNodeCold *sysml2_node_cold_mut(Sysml2Arena *arena, SysmlNode *node);
+
+/*
+ * Give a node its own copy of its cold record
+ *
+ * @param arena Arena for the copy
+ * @param node Element
+ * @return Writable cold record owned by node, or NULL on allocation failure
+ */
+SysmlNodeCold *sysml2_node_cold_detach(Sysml2Arena *arena, SysmlNode *node);
+
+/*
+ * Last segment of an element's ID ("C" for "A::B::C")
+ *
+ * Equals name for named elements; anonymous ones have a generated one.
+ *
+ * @param node Element with has_path set
+ * @return Pointer into node->id
+ */
+SYSML2_INLINE const char *sysml2_node_local_id(const SysmlNode *node) {
+    return node->id + node->name_offset;
+}
+
+/*
+ * Length of the parent_id prefix of an element's ID
+ *
+ * @param node Element with has_path set
+ * @return Bytes before the local segment's "::" (0 at top level)
+ */
+SYSML2_INLINE size_t sysml2_node_parent_length(const SysmlNode *node) {
+    return node->name_offset >= 2 ? node->name_offset - 2 : 0;
+}
+
+/*
+ * Set an element's path fields from its id and parent_id, leaving its
+ * parent unlinked
+ *
+ * For elements created or renamed outside the builder, which sets the
+ * path fields itself.
+ *
+ * @param node Element
+ */
+void sysml2_node_derive_path(SysmlNode *node);
+
 /*
  * Relationship - represents a connection between elements
  */
@@ -563,6 +655,19 @@ typedef struct {
     size_t alias_capacity;
 } SysmlSemanticModel;
 
+/*
+ * Set the path fields of all elements and link each to its parent
+ *
+ * For models read back without the builder (the model cache). Parents
+ * are looked up among the model's own elements, by ID address, so the
+ * IDs must be interned.
+ *
+ * @param model Model to link
+ * @return false if the lookup table could not be allocated (the depths
+ *         and name offsets are still set, the parents left unlinked)
+ */
+bool sysml2_model_link_paths(SysmlSemanticModel *model);
+
 /* Get the JSON type string for a node kind */
 const char *sysml2_kind_to_json_type(SysmlNodeKind kind);
 
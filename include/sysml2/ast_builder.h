@@ -22,6 +22,29 @@
 #define SYSML_BUILD_DEFAULT_IMPORT_CAPACITY 32
 #define SYSML_BUILD_DEFAULT_ALIAS_CAPACITY 16
 
+/*
+ * What the builder records beyond the semantic model
+ *
+ * Comments, blank lines and doc comment text are only read by the SysML
+ * writer, modify and the model cache. Runs that never write SysML can
+ * turn them off, which saves the allocations for every comment.
+ */
+typedef struct {
+    bool trivia;              /* Comments and blank lines (SysmlTrivia lists) */
+    bool documentation;       /* Doc comment text (SysmlNodeCold.documentation) */
+} SysmlCaptureOptions;
+
+/* Everything, as needed to write the model back out */
+#define SYSML_CAPTURE_ALL ((SysmlCaptureOptions){ .trivia = true, .documentation = true })
+
+/* The semantic model only */
+#define SYSML_CAPTURE_NONE ((SysmlCaptureOptions){ .trivia = false, .documentation = false })
+
+/* Whether nothing is skipped */
+SYSML2_INLINE bool sysml2_capture_is_all(SysmlCaptureOptions capture) {
+    return capture.trivia && capture.documentation;
+}
+
 /*
  * Build Context - manages AST construction during parsing
  */
@@ -29,9 +52,11 @@ typedef struct SysmlBuildContext {
     Sysml2Arena *arena;       /* Memory arena for allocations */
     Sysml2Intern *intern;     /* String interning table */
     const char *source_name;  /* Source file name */
+    SysmlCaptureOptions capture; /* What to keep besides the model (default: all) */
 
     /* Scope stack for containment tracking */
     const char **scope_stack; /* Stack of scope IDs */
+    SysmlNode **scope_nodes;  /* Element of each scope (NULL if not built here) */
     size_t scope_depth;
     size_t scope_capacity;
 
@@ -158,6 +183,9 @@ typedef struct SysmlBuildContext {
 /*
  * Create a new build context
  *
+ * Captures everything; set ctx->capture before parsing to skip trivia or
+ * documentation.
+ *
  * @param arena Memory arena for allocations
  * @param intern String interning table
  * @param source_name Name of the source file
@@ -179,6 +207,9 @@ void sysml2_build_context_destroy(SysmlBuildContext *ctx);
 /*
  * Push a new scope onto the scope stack
  *
+ * Elements created in the scope are linked to the element with that ID
+ * (normally the one just added) as their parent.
+ *
  * @param ctx Build context
  * @param scope_id ID of the new scope (interned)
  */
@@ -199,6 +230,15 @@ void sysml2_build_pop_scope(SysmlBuildContext *ctx);
  */
 const char *sysml2_build_current_scope(SysmlBuildContext *ctx);
 
+/*
+ * Get the element of the current scope
+ *
+ * @param ctx Build context
+ * @return Element whose ID is the current scope, or NULL at root or if
+ *         the scope has no element in this context
+ */
+SysmlNode *sysml2_build_current_scope_node(SysmlBuildContext *ctx);
+
 /*
  * Generate a path-based ID for an element
  *
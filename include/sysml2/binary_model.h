@@ -0,0 +1,223 @@
+/*
+ * SysML v2 Parser - Binary Model Format
+ *
+ * Compact export format written by `-f binary`, for tools that would
+ * otherwise re-parse the JSON output. A file holds one or more models
+ * (one per source file) and is read in place: map it, open it, and
+ * iterate records by index without allocating.
+ *
+ * Layout (little-endian uint32 words, offsets from start of file):
+ *
+ *   header     magic "SYSML2BM", version, total size, then one
+ *              {offset, count} pair per section
+ *   sources    per model: name, then {first, count} of its elements,
+ *              relationships, imports and aliases
+ *   strings    count offsets, each to { uint32 length; bytes; '\0' }
+ *              padded to 4 bytes; every distinct string is stored once
+ *   elements   id, name, type, parent, then {first, count} into refs
+ *              for typedBy, specializes, redefines and references
+ *   relationships  id, type, source, target
+ *   imports    id, type, target, owner scope, flags
+ *   aliases    id, name, target, owner scope
+ *   refs       one reference per word
+ *
+ * Strings are indices into the string table, or SYSML2_BINARY_NONE.
+ * A reference is an element index when its text is the ID of an element
+ * in the same model, a string index tagged with SYSML2_BINARY_REF_STRING
+ * otherwise, or SYSML2_BINARY_NONE. Types are the JSON type names
+ * ("PartDef", "Specialization", ...).
+ *
+ * Metadata usages and source locations are not exported.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef SYSML2_BINARY_MODEL_H
+#define SYSML2_BINARY_MODEL_H
+
+#include "common.h"
+
+/* File magic and format version.
+ * Bump the version whenever a record layout changes. */
+#define SYSML2_BINARY_MAGIC "SYSML2BM"
+#define SYSML2_BINARY_VERSION 1
+
+/* Absent string or reference */
+#define SYSML2_BINARY_NONE 0xFFFFFFFFu
+
+/* Tag bit of references that are strings rather than element indices */
+#define SYSML2_BINARY_REF_STRING 0x80000000u
+
+/* Import flags */
+#define SYSML2_BINARY_IMPORT_PRIVATE         (1u << 0)
+#define SYSML2_BINARY_IMPORT_PUBLIC_EXPLICIT (1u << 1)
+
+/* Sections, in file order */
+typedef enum {
+    SYSML2_BINARY_SOURCES,
+    SYSML2_BINARY_STRINGS,
+    SYSML2_BINARY_ELEMENTS,
+    SYSML2_BINARY_RELATIONSHIPS,
+    SYSML2_BINARY_IMPORTS,
+    SYSML2_BINARY_ALIASES,
+    SYSML2_BINARY_REFS,
+    SYSML2_BINARY_SECTION_COUNT
+} Sysml2BinarySection;
+
+/* Record sizes in words */
+#define SYSML2_BINARY_SOURCE_WORDS       9
+#define SYSML2_BINARY_ELEMENT_WORDS      12
+#define SYSML2_BINARY_RELATIONSHIP_WORDS 4
+#define SYSML2_BINARY_IMPORT_WORDS       5
+#define SYSML2_BINARY_ALIAS_WORDS        4
+
+/* Header: magic, version, size, then the section table */
+#define SYSML2_BINARY_HEADER_SIZE (8 + 4 + 4 + SYSML2_BINARY_SECTION_COUNT * 8)
+
+/* Slice of a record array */
+typedef struct {
+    uint32_t first;
+    uint32_t count;
+} Sysml2BinaryRange;
+
+typedef struct {
+    uint32_t name;                      /* String: source file name */
+    Sysml2BinaryRange elements;
+    Sysml2BinaryRange relationships;
+    Sysml2BinaryRange imports;
+    Sysml2BinaryRange aliases;
+} Sysml2BinarySource;
+
+typedef struct {
+    uint32_t id;                        /* String */
+    uint32_t name;                      /* String */
+    uint32_t type;                      /* String */
+    uint32_t parent;                    /* Reference */
+    Sysml2BinaryRange typed_by;         /* Into refs */
+    Sysml2BinaryRange specializes;
+    Sysml2BinaryRange redefines;
+    Sysml2BinaryRange references;
+} Sysml2BinaryElement;
+
+typedef struct {
+    uint32_t id;                        /* String */
+    uint32_t type;                      /* String */
+    uint32_t source;                    /* Reference */
+    uint32_t target;                    /* Reference */
+} Sysml2BinaryRelationship;
+
+typedef struct {
+    uint32_t id;                        /* String */
+    uint32_t type;                      /* String: Import, ImportAll, ImportRecursive */
+    uint32_t target;                    /* Reference */
+    uint32_t owner;                     /* Reference */
+    uint32_t flags;                     /* SYSML2_BINARY_IMPORT_* */
+} Sysml2BinaryImport;
+
+typedef struct {
+    uint32_t id;                        /* String */
+    uint32_t name;                      /* String */
+    uint32_t target;                    /* Reference */
+    uint32_t owner;                     /* Reference */
+} Sysml2BinaryAlias;
+
+/*
+ * Binary Model - an opened file; borrows its data
+ */
+typedef struct {
+    const uint8_t *data;
+    size_t size;
+    Sysml2BinaryRange sections[SYSML2_BINARY_SECTION_COUNT]; /* {offset, count} */
+
+    /* Set by sysml2_binary_map */
+    void *mapping;
+    size_t mapping_size;
+} Sysml2BinaryModel;
+
+/*
+ * Open a binary model held in memory
+ *
+ * Checks the header and that every section lies within the data; record
+ * contents are checked as they are read.
+ *
+ * @param model Model to initialize
+ * @param data File contents (must outlive the model; any alignment)
+ * @param size Size in bytes
+ * @return SYSML2_OK, or SYSML2_ERROR_SYNTAX if the data is not a
+ *         binary model of this version
+ */
+Sysml2Result sysml2_binary_open(Sysml2BinaryModel *model, const void *data, size_t size);
+
+/*
+ * Map a binary model file read-only and open it
+ *
+ * @param model Model to initialize
+ * @param path File path
+ * @return SYSML2_OK, SYSML2_ERROR_FILE_NOT_FOUND or SYSML2_ERROR_FILE_READ
+ *         if the file cannot be mapped, SYSML2_ERROR_SYNTAX if malformed
+ */
+Sysml2Result sysml2_binary_map(Sysml2BinaryModel *model, const char *path);
+
+/*
+ * Unmap a file opened with sysml2_binary_map
+ *
+ * @param model Model (no-op for models from sysml2_binary_open)
+ */
+void sysml2_binary_unmap(Sysml2BinaryModel *model);
+
+/*
+ * Number of records in a section
+ *
+ * @param model Binary model
+ * @param section Section
+ * @return Record count
+ */
+uint32_t sysml2_binary_count(const Sysml2BinaryModel *model, Sysml2BinarySection section);
+
+/*
+ * Get a string
+ *
+ * @param model Binary model
+ * @param index String index
+ * @return View into the file (NUL-terminated), or SYSML2_SV_NULL for
+ *         SYSML2_BINARY_NONE and invalid indices
+ */
+Sysml2StringView sysml2_binary_string(const Sysml2BinaryModel *model, uint32_t index);
+
+/*
+ * Get the text of a reference: the element ID or the string
+ *
+ * @param model Binary model
+ * @param ref Reference
+ * @return View into the file, or SYSML2_SV_NULL for none/invalid
+ */
+Sysml2StringView sysml2_binary_ref_text(const Sysml2BinaryModel *model, uint32_t ref);
+
+/*
+ * Get a reference from the refs section
+ *
+ * @param model Binary model
+ * @param index Index into refs (range.first + i)
+ * @return Reference, or SYSML2_BINARY_NONE if out of range
+ */
+uint32_t sysml2_binary_ref(const Sysml2BinaryModel *model, uint32_t index);
+
+/*
+ * Decode one record
+ *
+ * @param model Binary model
+ * @param index Record index
+ * @param out Output record
+ * @return false if index is out of range
+ */
+bool sysml2_binary_source(const Sysml2BinaryModel *model, uint32_t index, Sysml2BinarySource *out);
+bool sysml2_binary_element(const Sysml2BinaryModel *model, uint32_t index, Sysml2BinaryElement *out);
+bool sysml2_binary_relationship(
+    const Sysml2BinaryModel *model,
+    uint32_t index,
+    Sysml2BinaryRelationship *out
+);
+bool sysml2_binary_import(const Sysml2BinaryModel *model, uint32_t index, Sysml2BinaryImport *out);
+bool sysml2_binary_alias(const Sysml2BinaryModel *model, uint32_t index, Sysml2BinaryAlias *out);
+
+#endif /* SYSML2_BINARY_MODEL_H */
@@ -0,0 +1,36 @@
+/*
+ * SysML v2 Parser - Binary Model Writer
+ *
+ * Serializes semantic models to the compact binary format described in
+ * binary_model.h (`-f binary`).
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef SYSML2_BINARY_WRITER_H
+#define SYSML2_BINARY_WRITER_H
+
+#include "common.h"
+#include "ast.h"
+#include <stdio.h>
+
+/*
+ * Write semantic models as one binary model file
+ *
+ * Each model becomes one source record; the string table is shared, so
+ * names repeated across models are stored once.
+ *
+ * @param models Models to serialize
+ * @param model_count Number of models
+ * @param out Output file handle
+ * @return SYSML2_OK on success, SYSML2_ERROR_OUT_OF_MEMORY if the file
+ *         cannot be built (including models too large for 32-bit
+ *         indices), SYSML2_ERROR_FILE_READ if writing fails
+ */
+Sysml2Result sysml2_binary_write(
+    SysmlSemanticModel **models,
+    size_t model_count,
+    FILE *out
+);
+
+#endif /* SYSML2_BINARY_WRITER_H */
@@ -16,8 +16,17 @@ typedef enum {
     SYSML2_OUTPUT_JSON,      /* JSON AST output */
     SYSML2_OUTPUT_XML,       /* XML AST output (future) */
     SYSML2_OUTPUT_SYSML,     /* Formatted SysML/KerML source */
+    SYSML2_OUTPUT_BINARY,    /* Compact binary model (binary_model.h) */
+    SYSML2_OUTPUT_NDJSON,    /* One JSON object per element/relationship/import */
 } Sysml2OutputFormat;
 
+/* --stats report formats */
+typedef enum {
+    SYSML2_STATS_NONE,       /* No report */
+    SYSML2_STATS_TEXT,       /* Table on stderr */
+    SYSML2_STATS_JSON,       /* One JSON object on stderr */
+} Sysml2StatsFormat;
+
 /* CLI options */
 typedef struct {
     /* Input/output */
@@ -25,16 +34,25 @@ typedef struct {
     size_t input_file_count;
     const char *output_file;        /* Output file (NULL for stdout) */
     Sysml2OutputFormat output_format;
+    bool compact_json;              /* --compact: JSON without indentation */
 
     /* Library paths for import resolution */
     const char **library_paths;     /* Array of library search paths (-I) */
     size_t library_path_count;
     size_t library_path_capacity;
 
+    /* Persistent model cache */
+    const char *cache_dir;          /* --cache-dir: reuse parsed library models */
+    bool clear_cache;               /* --clear-cache: remove cache entries first */
+
     /* Query options */
     const char **select_patterns;   /* Array of --select patterns */
     size_t select_pattern_count;
     size_t select_pattern_capacity;
+    const char **users_patterns;    /* Array of --select-users patterns */
+    size_t users_pattern_count;
+    size_t users_pattern_capacity;
+    size_t users_depth;             /* --users-depth: levels of users (0 = all) */
 
     /* Modification options */
     const char **set_fragments;     /* Fragment file paths for --set */
@@ -53,6 +71,7 @@ typedef struct {
 
     /* Diagnostics */
     Sysml2ColorMode color_mode;
+    Sysml2DiagFormat diag_format;   /* --diagnostics-format */
     size_t max_errors;
     bool treat_warnings_as_errors;
 
@@ -60,14 +79,25 @@ typedef struct {
     bool dump_tokens;           /* Print lexer tokens */
     bool dump_ast;              /* Print parsed AST */
     bool verbose;               /* Verbose output */
+    Sysml2StatsFormat stats_format; /* --stats[=json]: per-phase timing report */
+    const char *trace_path;     /* --trace <file>: Trace Event Format output */
 
     /* Mode options */
     bool parse_only;            /* Skip semantic validation */
+    bool validate_queries;      /* --validate: resolve and validate --list/--select runs */
+    bool syntax_only;           /* --syntax-only: report syntax errors, build nothing */
     bool fix_in_place;          /* --fix: rewrite files with formatting */
     bool no_resolve;            /* --no-resolve: disable import resolution */
+    bool lazy_libraries;        /* --lazy-libraries: parse library files as they are used */
+    bool trim_models;           /* Parse without trivia and doc text (no SysML is written) */
     bool allow_semantic_errors; /* --allow-semantic-errors: write files despite E3xxx errors */
     bool recursive;             /* --recursive: load all .sysml files from directory */
     bool list_mode;             /* --list: output element summary (name + kind) */
+    size_t jobs;                /* -j/--jobs: parser and validator threads (1 = serial) */
+    size_t memory_limit;        /* --memory-limit: bytes models may hold (0 = unlimited) */
+    bool serve_mode;            /* --serve: answer JSON-RPC requests on stdin */
+    bool batch_mode;            /* --batch: validate the documents listed on stdin */
+    const char *daemon_socket;  /* --daemon: run forwarded command lines on this socket */
 
     /* Meta */
     bool show_help;
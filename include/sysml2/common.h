@@ -112,6 +112,7 @@ typedef struct {
     size_t content_length;      /* Length of content */
     const uint32_t *line_offsets; /* Array of byte offsets for each line start */
     uint32_t line_count;        /* Number of lines */
+    bool load_failed;           /* Loading for snippets failed; don't retry */
 } Sysml2SourceFile;
 
 /* Result type for operations that can fail */
@@ -0,0 +1,76 @@
+/*
+ * SysML v2 Parser - Fork Server
+ *
+ * For build systems that run sysml2 once per file. `--daemon <socket>`
+ * loads the library paths once and then runs command lines sent to a
+ * Unix socket. Each request runs in a child forked from the loaded
+ * process: it starts with the libraries already parsed (shared
+ * copy-on-write) and whatever it does is gone when it exits.
+ *
+ * The client is the normal CLI. With SYSML2_DAEMON set to the socket
+ * path, sysml2 hands its command line, working directory,
+ * SYSML2_LIBRARY_PATH and stdin/stdout/stderr to the daemon and exits
+ * with the request's exit code. When nothing accepts on the socket it
+ * runs the command itself.
+ *
+ * Requests run with the daemon's rights, so only its user may send them:
+ * the socket file is created 0600 and a peer with another user ID is
+ * turned away.
+ *
+ * Library files are not watched; restart the daemon after editing them.
+ *
+ * Protocol, one request per connection, native byte order:
+ *
+ *   client: uint32 payload length, sent with the client's descriptors
+ *           0, 1 and 2 attached (SCM_RIGHTS)
+ *   client: payload - NUL-terminated strings: working directory,
+ *           "=value" for SYSML2_LIBRARY_PATH or "" if unset, argv[0..]
+ *   daemon: int32 exit code, after the request's output is flushed
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef SYSML2_DAEMON_H
+#define SYSML2_DAEMON_H
+
+#include "common.h"
+
+/* Environment variable naming the socket the CLI forwards to */
+#define SYSML2_DAEMON_ENV "SYSML2_DAEMON"
+
+/*
+ * Run one request in the forked child
+ *
+ * Called with the client's stdio, working directory and library path
+ * already in place; argv is the client's command line.
+ *
+ * @return Exit code for the client
+ */
+typedef int (*Sysml2DaemonHandler)(int argc, char **argv, void *data);
+
+/*
+ * Accept requests until SIGINT or SIGTERM
+ *
+ * A stale socket file left by a daemon that died is replaced; a live one
+ * is an error. The socket file is removed on exit.
+ *
+ * @param socket_path Path of the Unix socket to listen on
+ * @param handler Runs each request
+ * @param data Passed to handler
+ * @return Process exit code (0 after a signal, 1 if the socket cannot be set up)
+ */
+int sysml2_daemon_run(const char *socket_path, Sysml2DaemonHandler handler, void *data);
+
+/*
+ * Run a command line through a daemon
+ *
+ * @param socket_path Daemon socket
+ * @param argc Argument count
+ * @param argv Arguments, including argv[0]
+ * @return The request's exit code, or -1 if no daemon accepted the
+ *         connection (nothing has run; the caller should run the
+ *         command itself)
+ */
+int sysml2_daemon_forward(const char *socket_path, int argc, char **argv);
+
+#endif /* SYSML2_DAEMON_H */
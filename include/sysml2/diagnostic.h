@@ -18,6 +18,7 @@
  * E1xxx - Lexical errors
  * E2xxx - Syntax errors
  * E3xxx - Semantic errors
+ * E4xxx - Resource limits
  * W1xxx - Warnings
  */
 
@@ -56,6 +57,9 @@ typedef enum {
     SYSML2_DIAG_E3009_CIRCULAR_IMPORT,
     SYSML2_DIAG_E3010_IMPORT_NOT_FOUND,
 
+    /* Resource limits (E4xxx) */
+    SYSML2_DIAG_E4001_MEMORY_LIMIT = 4001,
+
     /* Warnings (W1xxx) */
     SYSML2_DIAG_W1001_UNUSED_IMPORT = 10001,
     SYSML2_DIAG_W1002_SHADOWED_NAME,
@@ -117,13 +121,20 @@ typedef enum {
     SYSML2_COLOR_NEVER,
 } Sysml2ColorMode;
 
+/* Diagnostic output format */
+typedef enum {
+    SYSML2_DIAG_FORMAT_TEXT,    /* Clang-style text with source snippets */
+    SYSML2_DIAG_FORMAT_JSON,    /* One JSON object per line, no snippets */
+} Sysml2DiagFormat;
+
 /* Diagnostic output options */
 typedef struct {
     FILE *output;               /* Output stream */
-    Sysml2ColorMode color_mode;
-    bool show_source_context;   /* Show source lines */
-    bool show_column_numbers;   /* Show column in location */
-    bool show_error_codes;      /* Show [E1001] etc */
+    Sysml2DiagFormat format;
+    Sysml2ColorMode color_mode; /* Text only */
+    bool show_source_context;   /* Show source lines (text only) */
+    bool show_column_numbers;   /* Show column in location (text only) */
+    bool show_error_codes;      /* Show [E1001] etc (text only) */
 } Sysml2DiagOptions;
 
 /* Initialize diagnostic context */
@@ -177,7 +188,27 @@ Sysml2Diagnostic *sysml2_diag_add_note(
 /* Emit a diagnostic to the context */
 void sysml2_diag_emit(Sysml2DiagContext *ctx, Sysml2Diagnostic *diag);
 
-/* Print all diagnostics */
+/*
+ * Copy every diagnostic in src to the end of dst, in order
+ *
+ * Messages, help, fix-its and notes are copied into dst's arena, so src
+ * (and its arena) may be discarded afterwards. Each copy is emitted as
+ * if reported to dst directly, so dst's counts and warning promotion
+ * apply.
+ */
+void sysml2_diag_merge(Sysml2DiagContext *dst, const Sysml2DiagContext *src);
+
+/*
+ * Print all diagnostics
+ *
+ * Output is buffered and written in large chunks. Source line tables are
+ * built on first use and kept on each Sysml2SourceFile, so later
+ * diagnostics in the same file reuse them.
+ *
+ * The JSON format writes one object per line with file, line, column,
+ * end_line, end_column, severity, code and message, plus help, fixits
+ * and notes when present. It never loads source text.
+ */
 void sysml2_diag_print_all(const Sysml2DiagContext *ctx, const Sysml2DiagOptions *options);
 
 /* Print a single diagnostic */
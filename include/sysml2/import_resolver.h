@@ -14,7 +14,11 @@
 #include "arena.h"
 #include "intern.h"
 #include "ast.h"
+#include "ast_builder.h"
 #include "diagnostic.h"
+#include "stats.h"
+#include "trace.h"
+#include "model_cache.h"
 
 /* Forward declaration */
 typedef struct Sysml2ImportResolver Sysml2ImportResolver;
@@ -50,6 +54,26 @@ typedef struct Sysml2FailedLookup {
     struct Sysml2FailedLookup *next; /* Next entry in bucket chain */
 } Sysml2FailedLookup;
 
+/*
+ * File index entry - where a .sysml/.kerml basename occurs under a
+ * library path (the first match a directory walk would find)
+ */
+typedef struct Sysml2FileIndexEntry {
+    char *name;                        /* Basename (owned) */
+    size_t path_index;                 /* Library path it is under */
+    char *path;                        /* Full path to file (owned) */
+    struct Sysml2FileIndexEntry *next; /* Next entry in bucket chain */
+} Sysml2FileIndexEntry;
+
+/*
+ * Result of scanning a file for its top-level package declaration
+ */
+typedef enum {
+    SYSML2_SCAN_NO_PACKAGE,          /* No top-level package declared */
+    SYSML2_SCAN_FOUND,               /* Package name found */
+    SYSML2_SCAN_AMBIGUOUS,           /* Scanner unsure; a full parse is needed */
+} Sysml2PackageScan;
+
 /*
  * Import Resolver - manages library paths, file caching, and cycle detection
  */
@@ -69,10 +93,21 @@ struct Sysml2ImportResolver {
     size_t package_map_capacity;      /* Number of hash buckets */
     size_t package_map_count;         /* Number of entries */
 
+    /* Directories already scanned by discover_packages (owned) */
+    char **discovered_dirs;
+    size_t discovered_count;
+    size_t discovered_capacity;
+
     /* Negative lookup cache - packages known to not exist in library paths */
     Sysml2FailedLookup **failed_lookups;
     size_t failed_lookups_capacity;
 
+    /* Filename index - each library path is walked once, on the first
+     * lookup that has to search it */
+    Sysml2FileIndexEntry **file_index; /* Hash table (NULL until first search) */
+    size_t file_index_capacity;      /* Number of hash buckets */
+    size_t indexed_paths;            /* Library paths [0, indexed_paths) are indexed */
+
     /* Cycle detection */
     char **resolution_stack;         /* Stack of files being resolved (owned) */
     size_t stack_depth;
@@ -82,11 +117,28 @@ struct Sysml2ImportResolver {
     Sysml2Arena *arena;              /* Arena for AST allocations */
     Sysml2Intern *intern;            /* String interning */
 
+    /* Persistent on-disk model cache (NULL if disabled) */
+    Sysml2ModelCache *model_cache;   /* Owned */
+
+    /* Imported files parsed ahead of the walk (only while resolving) */
+    struct Sysml2Prefetch *prefetch;
+
+    /* Statistics */
+    size_t files_parsed;             /* Files run through the parser */
+    size_t bytes_parsed;             /* Their total size */
+    size_t file_cache_hits;          /* Lookups answered by file_cache */
+    Sysml2Stats *stats;              /* Phase timings for --stats (NULL = off) */
+    Sysml2Trace *trace;              /* Span output for --trace (NULL = off) */
+
     /* Options */
     bool verbose;                    /* Print verbose messages */
     bool disabled;                   /* --no-resolve flag */
     bool strict_imports;             /* Emit errors for missing imports (for --fix mode) */
     bool preloaded;                  /* Whether preload_libraries has been called */
+    bool libraries_indexed;          /* Whether index_libraries has been called */
+    size_t library_path_count;       /* Paths [0, n) were indexed as libraries */
+    size_t jobs;                     /* Parser threads for imported files (<= 1 = serial) */
+    SysmlCaptureOptions capture;     /* Trivia/documentation kept by parses (default: all) */
 };
 
 /*
@@ -120,6 +172,9 @@ void sysml2_resolver_destroy(Sysml2ImportResolver *resolver);
  */
 void sysml2_resolver_add_path(Sysml2ImportResolver *resolver, const char *path);
 
+/* Environment variable with extra library paths */
+#define SYSML2_LIBRARY_PATH_ENV "SYSML2_LIBRARY_PATH"
+
 /*
  * Add library paths from the SYSML2_LIBRARY_PATH environment variable
  *
@@ -129,6 +184,22 @@ void sysml2_resolver_add_path(Sysml2ImportResolver *resolver, const char *path);
  */
 void sysml2_resolver_add_paths_from_env(Sysml2ImportResolver *resolver);
 
+/*
+ * Enable the persistent model cache
+ *
+ * Parsed files are stored in the cache directory and reused by later
+ * runs while the source file is unchanged.
+ *
+ * @param resolver Import resolver
+ * @param dir Cache directory (created if missing)
+ * @return SYSML2_OK on success, SYSML2_ERROR_FILE_READ if the directory
+ *         cannot be created
+ */
+Sysml2Result sysml2_resolver_set_cache_dir(
+    Sysml2ImportResolver *resolver,
+    const char *dir
+);
+
 /*
  * Cache a parsed model for a file
  *
@@ -209,8 +280,10 @@ Sysml2Result sysml2_resolver_preload_libraries(
  * match the package name (e.g., package SystemBehavior in _index.sysml).
  *
  * Unlike preload_libraries, this does NOT cache models for validation.
- * Files are only parsed to extract package names; they will be fully
- * cached when actually imported.
+ * Files are only scanned for their top-level package declaration (see
+ * sysml2_scan_top_level_package); they are parsed when actually imported.
+ * Each directory is scanned once per resolver, and with a model cache
+ * the result is persisted and reused while the tree is unchanged.
  *
  * @param resolver Import resolver
  * @param dir_path Directory to scan
@@ -223,6 +296,64 @@ Sysml2Result sysml2_resolver_discover_packages(
     Sysml2DiagContext *diag
 );
 
+/*
+ * Map the packages of every library path without parsing them
+ *
+ * The on-demand counterpart of preload_libraries (--lazy-libraries):
+ * runs discover_packages on each library path, so startup costs one
+ * scan (or one cached package index) and imports parse only the files
+ * they name.
+ *
+ * @param resolver Import resolver
+ * @param diag Diagnostic context for parse errors
+ * @return SYSML2_OK on success
+ */
+Sysml2Result sysml2_resolver_index_libraries(
+    Sysml2ImportResolver *resolver,
+    Sysml2DiagContext *diag
+);
+
+/*
+ * Parse the library files that qualified names refer to
+ *
+ * For every cached model, the first segment of each typing,
+ * specialization, redefinition, reference and relationship end is
+ * looked up in the package map; a library file mapped to it that is not
+ * cached yet is loaded like an import, with its own imports. Repeats
+ * until a pass loads nothing, so names used by the loaded files are
+ * followed too. Files outside the library paths are never loaded.
+ *
+ * @param resolver Import resolver
+ * @param diag Diagnostic context for parse errors
+ * @return Number of files added to the cache
+ */
+size_t sysml2_resolver_load_referenced(
+    Sysml2ImportResolver *resolver,
+    Sysml2DiagContext *diag
+);
+
+/*
+ * Find the first top-level package declaration without parsing
+ *
+ * Skips comments, strings and nested bodies and looks for the first
+ * `package` keyword at brace depth zero, as in `package P`,
+ * `library package P` or `standard library package P`. Declarations the
+ * scanner cannot map to the parser's name exactly (short names, escapes,
+ * unexpected tokens, unterminated comments) are reported as ambiguous.
+ *
+ * @param content Source text
+ * @param length Length of the source text
+ * @param out_name Output: start of the package name (points into content)
+ * @param out_length Output: length of the package name
+ * @return Scan result; out_name/out_length are set only for SYSML2_SCAN_FOUND
+ */
+Sysml2PackageScan sysml2_scan_top_level_package(
+    const char *content,
+    size_t length,
+    const char **out_name,
+    size_t *out_length
+);
+
 /*
  * Find the file path for an import target
  *
@@ -4,6 +4,21 @@
  * Deduplicates strings by storing only one copy of each unique string.
  * Enables fast pointer comparison for string equality.
  *
+ * The table uses open addressing with linear probing. Each slot keeps the
+ * string's hash and length next to the data pointer, so probes compare
+ * slots without touching string memory. The table doubles when it passes
+ * its load factor; strings themselves live in the arena and never move.
+ *
+ * Identifier contract: every element ID stored in a SysmlSemanticModel
+ * (node id/parent_id, relationship source/target, import target and
+ * owner_scope, alias ids) is interned in the run's single Sysml2Intern.
+ * The builder, the model cache, model deserialization and the modify
+ * engine all re-intern, so two IDs are equal iff their pointers are.
+ * Hot lookups rely on this through sysml2_id_eq(); strings from outside
+ * a model (CLI patterns, computed parent paths) must be interned first
+ * or compared with strcmp. Configure with -DSYSML2_CHECK_INTERNING=ON
+ * to verify the contract at run time.
+ *
  * SPDX-License-Identifier: MIT
  */
 
@@ -13,34 +28,57 @@
 #include "common.h"
 #include "arena.h"
 
-/* Default hash table capacity */
+#ifdef SYSML2_CHECK_INTERNING
+#include <string.h>
+#endif
+
+/* Default initial slot count (grows on demand) */
 #define SYSML2_INTERN_DEFAULT_CAPACITY 1024
 
-/* Interned string entry */
-typedef struct Sysml2InternEntry {
-    struct Sysml2InternEntry *next; /* Hash collision chain */
+/* Maximum load factor before the table grows, in percent */
+#define SYSML2_INTERN_MAX_LOAD_PERCENT 70
+
+/* Hash table slot (data == NULL means empty) */
+typedef struct {
     uint32_t hash;                  /* Cached hash value */
     uint32_t length;                /* String length */
-    char data[];                    /* Null-terminated string */
-} Sysml2InternEntry;
+    const char *data;               /* Null-terminated string (in arena) */
+} Sysml2InternSlot;
 
 /* String intern table */
 typedef struct {
     Sysml2Arena *arena;             /* Arena for string storage */
-    Sysml2InternEntry **buckets;    /* Hash table buckets */
-    size_t capacity;                /* Number of buckets */
+    Sysml2InternSlot *slots;        /* Slot array (heap, owned) */
+    size_t capacity;                /* Number of slots (power of two) */
     size_t count;                   /* Number of unique strings */
+
+    /* Strings added since sysml2_intern_start_journal(), oldest first */
+    Sysml2InternSlot *journal;      /* Heap, owned (NULL = not journaling) */
+    size_t journal_count;
+    size_t journal_capacity;
 } Sysml2Intern;
 
 /* Initialize the intern table with default capacity */
 void sysml2_intern_init(Sysml2Intern *intern, Sysml2Arena *arena);
 
-/* Initialize the intern table with custom capacity */
+/* Initialize the intern table with custom initial capacity */
 void sysml2_intern_init_with_capacity(Sysml2Intern *intern, Sysml2Arena *arena, size_t capacity);
 
 /* Clean up the intern table (strings remain valid until arena is destroyed) */
 void sysml2_intern_destroy(Sysml2Intern *intern);
 
+/*
+ * Pre-size the table for an expected number of unique strings
+ *
+ * Avoids repeated rehashing when the final size can be estimated up
+ * front (e.g. from total input bytes). Never shrinks the table.
+ *
+ * @param intern Intern table
+ * @param expected_count Expected number of unique strings
+ * @return true on success, false on allocation failure (table unchanged)
+ */
+bool sysml2_intern_reserve(Sysml2Intern *intern, size_t expected_count);
+
 /* Intern a null-terminated string, returns interned pointer */
 const char *sysml2_intern(Sysml2Intern *intern, const char *str);
 
@@ -59,7 +97,80 @@ const char *sysml2_intern_lookup_sv(const Sysml2Intern *intern, Sysml2StringView
 /* Get the number of unique interned strings */
 size_t sysml2_intern_count(const Sysml2Intern *intern);
 
-/* FNV-1a hash function */
+/*
+ * Record the strings interned from now on
+ *
+ * With a journal, sysml2_intern_rewind() removes just the strings added
+ * since the mark instead of rebuilding the whole table, so rewinding a
+ * small document's strings out of a table holding a large library costs
+ * the document's size, not the table's. Journaling stops (and rewinds
+ * rebuild the table again) if an entry cannot be recorded.
+ *
+ * @param intern Intern table
+ */
+void sysml2_intern_start_journal(Sysml2Intern *intern);
+
+/*
+ * Forget strings interned since an arena mark
+ *
+ * Call before sysml2_arena_rewind() on the table's arena so that the
+ * table holds no pointers into the discarded memory. The mark should be
+ * taken after sysml2_intern_start_journal() for the journal to apply.
+ *
+ * @param intern Intern table
+ * @param mark Mark taken from the table's arena
+ * @return false on allocation failure (table unchanged)
+ */
+bool sysml2_intern_rewind(Sysml2Intern *intern, Sysml2ArenaMark mark);
+
+/* String hash function (word-at-a-time multiply/xorshift mix).
+ * Values are only stable within one build; do not persist them. */
 uint32_t sysml2_hash_string(const char *str, size_t length);
 
+/*
+ * Report a violated identifier contract and abort
+ *
+ * Called by sysml2_id_eq() in SYSML2_CHECK_INTERNING builds when pointer
+ * and string equality disagree.
+ *
+ * @param a First identifier
+ * @param b Second identifier
+ */
+void sysml2_intern_contract_failure(const char *a, const char *b);
+
+/*
+ * Compare two interned identifiers
+ *
+ * Both arguments must be NULL or interned in the same table.
+ *
+ * @param a First identifier
+ * @param b Second identifier
+ * @return true if both refer to the same string
+ */
+SYSML2_INLINE bool sysml2_id_eq(const char *a, const char *b) {
+#ifdef SYSML2_CHECK_INTERNING
+    if (a != b && a && b && strcmp(a, b) == 0) {
+        sysml2_intern_contract_failure(a, b);
+    }
+#endif
+    return a == b;
+}
+
+/*
+ * Hash an interned identifier by address
+ *
+ * Only meaningful for interned strings; equal IDs hash equally because
+ * they share one address.
+ *
+ * @param id Interned identifier
+ * @return Hash value
+ */
+SYSML2_INLINE uint32_t sysml2_id_hash(const char *id) {
+    uint64_t x = (uint64_t)(uintptr_t)id;
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return (uint32_t)x;
+}
+
 #endif /* SYSML2_INTERN_H */
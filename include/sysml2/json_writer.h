@@ -22,10 +22,11 @@ typedef struct {
     bool pretty;          /* Pretty print with indentation */
     int indent_size;      /* Spaces per indent level (default: 2) */
     bool include_source;  /* Include source file in meta */
+    size_t jobs;          /* Threads rendering query result chunks (<= 1 = serial) */
 } Sysml2JsonOptions;
 
 /* Default JSON options */
-#define SYSML_JSON_OPTIONS_DEFAULT { .pretty = true, .indent_size = 2, .include_source = true }
+#define SYSML_JSON_OPTIONS_DEFAULT { .pretty = true, .indent_size = 2, .include_source = true, .jobs = 1 }
 
 /*
  * Write the semantic model as JSON to a file
@@ -93,4 +94,43 @@ Sysml2Result sysml2_json_write_query(
     const Sysml2JsonOptions *options
 );
 
+/*
+ * Write the semantic model as NDJSON (one JSON object per line)
+ *
+ * Each line is an object with a single key naming the record:
+ *
+ *   {"meta": {"version": "1.0", "source": "file.sysml"}}
+ *   {"element": { ... }}
+ *   {"relationship": { ... }}
+ *   {"import": {"id": ..., "type": ..., "target": ..., "owner": ..., "private": false}}
+ *
+ * Element and relationship objects are those of sysml2_json_write.
+ * Models written one after another form a single valid stream.
+ *
+ * @param model Semantic model to serialize
+ * @param out Output file handle
+ * @param options Output options (pretty is ignored; can be NULL)
+ * @return SYSML2_OK on success, error code on failure
+ */
+Sysml2Result sysml2_json_write_ndjson(
+    const SysmlSemanticModel *model,
+    FILE *out,
+    const Sysml2JsonOptions *options
+);
+
+/*
+ * Write a query result as NDJSON
+ *
+ * Same records as sysml2_json_write_ndjson; the meta line has
+ * "type": "query_result" instead of a source.
+ *
+ * @param result Query result to serialize
+ * @param out Output file handle
+ * @return SYSML2_OK on success, error code on failure
+ */
+Sysml2Result sysml2_json_write_query_ndjson(
+    const Sysml2QueryResult *result,
+    FILE *out
+);
+
 #endif /* SYSML2_JSON_WRITER_H */
@@ -52,8 +52,8 @@ bool sysml2_lexer_is_eof(const Sysml2Lexer *lexer);
 /* Get current source location */
 Sysml2SourceLoc sysml2_lexer_current_loc(const Sysml2Lexer *lexer);
 
-/* Keyword lookup functions */
-void sysml2_keywords_init(void);
+/* Keyword lookup (SYSML2_TOKEN_IDENTIFIER if str is not a keyword).
+ * The table is generated at build time, so this is thread-safe. */
 Sysml2TokenType sysml2_keyword_lookup(const char *str, size_t length);
 
 #endif /* SYSML2_LEXER_H */
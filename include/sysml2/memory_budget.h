@@ -0,0 +1,140 @@
+/*
+ * SysML v2 Parser - Memory Budget
+ *
+ * Process-wide count of the memory a run holds on behalf of models:
+ * arena blocks, source file buffers and the PackCC pool's blocks.
+ * `--memory-limit` puts a ceiling on it.
+ *
+ * Charges never fail. The first one past the limit trips the budget;
+ * the parser then stops reading its input, and the pipeline and
+ * resolver check the budget around every file they parse and after
+ * each phase, report the breach as an E4001 diagnostic and skip
+ * whatever would allocate more. Handing out NULL from deep inside the
+ * builder instead would leave half-built models behind and take the
+ * diagnostic machinery, which allocates from the same arenas, down
+ * with them.
+ *
+ * The budget also tracks the current pipeline phase (fed by the
+ * sysml2_stats phase hooks, with or without --stats) so a breach report
+ * can say where it happened, and a resettable peak for per-phase
+ * high-water marks.
+ *
+ * All functions are thread-safe.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef SYSML2_MEMORY_BUDGET_H
+#define SYSML2_MEMORY_BUDGET_H
+
+#include "diagnostic.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Input bytes the parser reads between two budget checks (power of two) */
+#define SYSML2_MEMORY_CHECK_INTERVAL 4096u
+
+/*
+ * Set the ceiling
+ *
+ * @param bytes Limit in bytes (0 = unlimited; usage is still counted)
+ */
+void sysml2_memory_set_limit(size_t bytes);
+
+/*
+ * Get the ceiling
+ *
+ * @return Limit in bytes, 0 if unlimited
+ */
+size_t sysml2_memory_limit(void);
+
+/*
+ * Count bytes as held; trips the budget if this crosses the limit
+ *
+ * @param bytes Bytes allocated
+ */
+void sysml2_memory_charge(size_t bytes);
+
+/*
+ * Count bytes as given back
+ *
+ * @param bytes Bytes freed (as charged)
+ */
+void sysml2_memory_release(size_t bytes);
+
+/*
+ * Bytes currently charged
+ *
+ * @return Bytes held
+ */
+size_t sysml2_memory_used(void);
+
+/*
+ * Highest use since the start of the run (or of the current peak window)
+ *
+ * @return Bytes
+ */
+size_t sysml2_memory_peak(void);
+
+/*
+ * Open a peak window: restart the peak at current use
+ *
+ * Windows nest; pass the returned value to sysml2_memory_end_peak().
+ *
+ * @return Peak before the window (the enclosing window's so far)
+ */
+size_t sysml2_memory_begin_peak(void);
+
+/*
+ * Close a peak window, folding its peak back into the enclosing one
+ *
+ * @param outer Value returned by the matching sysml2_memory_begin_peak()
+ * @return Peak within the window
+ */
+size_t sysml2_memory_end_peak(size_t outer);
+
+/*
+ * Whether a charge has crossed the limit
+ *
+ * @return true once the budget has tripped (stays tripped)
+ */
+bool sysml2_memory_exceeded(void);
+
+/*
+ * Enter or leave a named phase (the innermost one is reported)
+ *
+ * @param name Phase name (static string)
+ */
+void sysml2_memory_phase_push(const char *name);
+void sysml2_memory_phase_pop(void);
+
+/*
+ * Report a tripped budget
+ *
+ * The first call after the budget trips emits a fatal E4001 diagnostic
+ * naming the limit, the use, the current phase and the file; later calls
+ * with a context that already holds one emit nothing. Without a context
+ * the report is printed to stderr, once per run.
+ *
+ * @param diag Diagnostic context for the report (NULL = stderr)
+ * @param file File being processed (NULL if none)
+ * @return true if the budget has tripped: the caller should return
+ *         SYSML2_ERROR_OUT_OF_MEMORY
+ */
+bool sysml2_memory_report(Sysml2DiagContext *diag, const char *file);
+
+/* Clear the counters, the phase stack and the tripped state (for tests) */
+void sysml2_memory_reset(void);
+
+/*
+ * Parse a byte count with an optional K, M or G suffix (powers of 1024)
+ *
+ * @param text Text such as "512M"
+ * @param out_bytes Output: byte count
+ * @return true on success; false for empty, negative, malformed or
+ *         overflowing values
+ */
+bool sysml2_memory_parse_size(const char *text, size_t *out_bytes);
+
+#endif /* SYSML2_MEMORY_BUDGET_H */
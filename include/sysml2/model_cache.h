@@ -0,0 +1,355 @@
+/*
+ * SysML v2 Parser - Persistent Model Cache
+ *
+ * On-disk cache of parsed semantic models, used by the import resolver
+ * to skip parsing of unchanged library files on warm runs.
+ *
+ * Each source file maps to one cache entry in the cache directory.
+ * Entries are keyed by the absolute source path and validated against
+ * the file's size, modification time and a 64-bit content hash, and
+ * against the program version that wrote them, so a build whose grammar
+ * or builder changed does not reuse older models.
+ *
+ * The entry format is relocatable: it contains no pointers, only
+ * offsets into a string table and a flat record stream. Entries are
+ * mapped read-only and decoded in place into arena-allocated nodes;
+ * all strings are re-interned so identifiers keep pointer identity
+ * with the rest of the run.
+ *
+ * The cache directory also holds package indexes: the package names
+ * found by package discovery under a directory, so unchanged library
+ * trees need no scanning at all. It also holds validation results: the
+ * diagnostics validation reported for a file, keyed by the content of
+ * the file and of everything it depends on.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef SYSML2_MODEL_CACHE_H
+#define SYSML2_MODEL_CACHE_H
+
+#include "common.h"
+#include "arena.h"
+#include "intern.h"
+#include "ast.h"
+#include "diagnostic.h"
+
+/* Cache entry file magic and format version.
+ * Bump the version whenever the serialized layout or SysmlNode changes. */
+#define SYSML2_MODEL_CACHE_MAGIC "SYSML2MC"
+#define SYSML2_MODEL_CACHE_VERSION 2
+
+/* File extension for cache entries */
+#define SYSML2_MODEL_CACHE_EXT ".smc"
+
+/* Package index entry magic (stored with the same extension) */
+#define SYSML2_PACKAGE_INDEX_MAGIC "SYSML2PI"
+
+/* Validation result entry magic (stored with the same extension) */
+#define SYSML2_RESULT_CACHE_MAGIC "SYSML2VR"
+
+/* Validation result revision, hashed into every result entry's key along
+ * with the program version. Bump it whenever a change alters the text or
+ * the order of diagnostics, so older entries are not replayed. */
+#define SYSML2_RESULT_CACHE_REVISION 5
+
+/*
+ * Model Cache - handle for a cache directory
+ */
+typedef struct Sysml2ModelCache {
+    char *dir;                       /* Cache directory (owned) */
+    Sysml2Arena *arena;              /* Arena for loaded models */
+    Sysml2Intern *intern;            /* Interner for loaded strings */
+    bool verbose;                    /* Print hit/miss notes */
+
+    /* Statistics */
+    size_t hits;                     /* Entries loaded from cache */
+    size_t misses;                   /* Lookups without a valid entry */
+    size_t stores;                   /* Entries written */
+} Sysml2ModelCache;
+
+/*
+ * Open a model cache directory
+ *
+ * The directory (and missing parents) is created if it does not exist.
+ *
+ * @param dir Cache directory path
+ * @param arena Arena used for models loaded from the cache
+ * @param intern Interner used for strings loaded from the cache
+ * @return New cache handle, or NULL if the directory cannot be created
+ */
+Sysml2ModelCache *sysml2_model_cache_create(
+    const char *dir,
+    Sysml2Arena *arena,
+    Sysml2Intern *intern
+);
+
+/*
+ * Close a model cache handle
+ *
+ * Models loaded from the cache stay valid (they live in the arena).
+ *
+ * @param cache Cache to destroy (may be NULL)
+ */
+void sysml2_model_cache_destroy(Sysml2ModelCache *cache);
+
+/*
+ * Load the cached model for a source file
+ *
+ * Returns NULL when there is no entry, the entry is from another format
+ * or program version, or the source file changed since the entry was
+ * written.
+ *
+ * @param cache Model cache
+ * @param abs_path Absolute path of the source file
+ * @return Model allocated in the cache arena, or NULL on miss
+ */
+SysmlSemanticModel *sysml2_model_cache_load(
+    Sysml2ModelCache *cache,
+    const char *abs_path
+);
+
+/*
+ * Store a parsed model for a source file
+ *
+ * The entry is written to a temporary file and renamed into place.
+ *
+ * @param cache Model cache
+ * @param abs_path Absolute path of the source file
+ * @param content Source content the model was parsed from
+ * @param content_length Content length in bytes
+ * @param model Parsed model
+ * @return SYSML2_OK on success, error code otherwise
+ */
+Sysml2Result sysml2_model_cache_store(
+    Sysml2ModelCache *cache,
+    const char *abs_path,
+    const char *content,
+    size_t content_length,
+    const SysmlSemanticModel *model
+);
+
+/*
+ * Remove the cached entry for a single source file
+ *
+ * @param cache Model cache
+ * @param abs_path Absolute path of the source file
+ * @return SYSML2_OK if removed or not present, error code otherwise
+ */
+Sysml2Result sysml2_model_cache_invalidate(
+    Sysml2ModelCache *cache,
+    const char *abs_path
+);
+
+/*
+ * Remove all cache entries from a cache directory
+ *
+ * Only files with the cache entry extension are removed.
+ *
+ * @param dir Cache directory path
+ * @param out_removed Output: number of entries removed (may be NULL)
+ * @return SYSML2_OK on success (or if the directory does not exist)
+ */
+Sysml2Result sysml2_model_cache_clear(const char *dir, size_t *out_removed);
+
+/*
+ * Serialize a model into a self-contained, relocatable buffer
+ *
+ * Uses the same encoding as cache entries, without the file key.
+ * Used to move models between arenas, e.g. from parser worker threads
+ * into the main pipeline arena.
+ *
+ * @param model Model to serialize
+ * @param out_data Output: malloc'd buffer (caller must free)
+ * @param out_size Output: buffer size in bytes
+ * @return SYSML2_OK on success, error code otherwise
+ */
+Sysml2Result sysml2_model_serialize(
+    const SysmlSemanticModel *model,
+    void **out_data,
+    size_t *out_size
+);
+
+/*
+ * Rebuild a model from a buffer produced by sysml2_model_serialize
+ *
+ * source_name and source_file are left NULL for the caller to set.
+ *
+ * @param data Serialized buffer
+ * @param size Buffer size in bytes
+ * @param arena Arena for the rebuilt model
+ * @param intern Interner for the rebuilt model's strings
+ * @return Rebuilt model, or NULL if the buffer is malformed
+ */
+SysmlSemanticModel *sysml2_model_deserialize(
+    const void *data,
+    size_t size,
+    Sysml2Arena *arena,
+    Sysml2Intern *intern
+);
+
+/*
+ * Package Index Entry - one directory or source file seen by package discovery
+ */
+typedef struct {
+    char *path;                      /* Path as scanned (owned) */
+    char *package;                   /* Top-level package name, NULL if none (owned) */
+    uint64_t size;                   /* File size in bytes (0 for directories) */
+    int64_t mtime;                   /* Modification time (ns) when scanned */
+    bool is_directory;
+} Sysml2PackageIndexEntry;
+
+/*
+ * Package Index - package names found under one discovery root
+ *
+ * Entries are kept in scan order so replaying the index registers
+ * packages exactly like the scan did (first mapping wins).
+ */
+typedef struct {
+    Sysml2PackageIndexEntry *entries;
+    size_t count;
+    size_t capacity;
+} Sysml2PackageIndex;
+
+/*
+ * Initialize an empty package index
+ *
+ * @param index Index to initialize
+ */
+void sysml2_package_index_init(Sysml2PackageIndex *index);
+
+/*
+ * Free all entries of a package index
+ *
+ * @param index Index to free (the struct itself is not freed)
+ */
+void sysml2_package_index_free(Sysml2PackageIndex *index);
+
+/*
+ * Record a scanned directory or file
+ *
+ * The path is stat'ed to capture its current size and mtime. Paths
+ * changed within the last few seconds are recorded as untrusted, which
+ * makes the stored index stale on the next run.
+ *
+ * @param index Package index
+ * @param path Directory or file path
+ * @param package Top-level package name (NULL if none or for directories)
+ * @param package_length Length of the package name
+ * @param is_directory Whether path is a directory
+ * @return true on success, false if the path cannot be stat'ed or on OOM
+ */
+bool sysml2_package_index_add(
+    Sysml2PackageIndex *index,
+    const char *path,
+    const char *package,
+    size_t package_length,
+    bool is_directory
+);
+
+/*
+ * Load the package index stored for a discovery root
+ *
+ * Succeeds only if every recorded directory and file still has the
+ * recorded mtime (and size, for files).
+ *
+ * @param cache Model cache
+ * @param root Absolute path of the discovery root
+ * @param out_index Output: loaded index (initialized by this call)
+ * @return true if an up-to-date index was loaded
+ */
+bool sysml2_model_cache_load_package_index(
+    Sysml2ModelCache *cache,
+    const char *root,
+    Sysml2PackageIndex *out_index
+);
+
+/*
+ * Store the package index for a discovery root
+ *
+ * @param cache Model cache
+ * @param root Absolute path of the discovery root
+ * @param index Index to store
+ * @return SYSML2_OK on success, error code otherwise
+ */
+Sysml2Result sysml2_model_cache_store_package_index(
+    Sysml2ModelCache *cache,
+    const char *root,
+    const Sysml2PackageIndex *index
+);
+
+/*
+ * Result Dependency - one file a validation result was computed from
+ */
+typedef struct {
+    const char *path;                /* Absolute path */
+    uint64_t size;                   /* Content size in bytes */
+    uint64_t content_hash;           /* sysml2_model_cache_hash of the content */
+} Sysml2ResultDependency;
+
+/* Maps a file path stored in a result entry to a source file of this run */
+typedef const Sysml2SourceFile *(*Sysml2ResultFileLookup)(void *data, const char *path);
+
+/*
+ * Load the validation results stored for a source file
+ *
+ * Succeeds only if the entry was written with the same configuration
+ * hash and the same dependency list: the same paths in the same order,
+ * each with the same size and content hash. The decoded diagnostics are
+ * emitted into diag in their original order; nothing is emitted on a
+ * miss.
+ *
+ * @param cache Model cache
+ * @param abs_path Absolute path of the source file
+ * @param config_hash Hash of everything besides file content that
+ *        validation results depend on (options, library paths, ...)
+ * @param deps Current dependencies, the file itself first
+ * @param dep_count Number of dependencies
+ * @param diag Diagnostic context to emit into
+ * @param own_file Source file for diagnostics located in the file itself
+ * @param lookup Maps other stored paths (notes) to source files
+ * @param lookup_data Passed to lookup
+ * @return true if the results were loaded and emitted
+ */
+bool sysml2_model_cache_load_results(
+    Sysml2ModelCache *cache,
+    const char *abs_path,
+    uint64_t config_hash,
+    const Sysml2ResultDependency *deps,
+    size_t dep_count,
+    Sysml2DiagContext *diag,
+    const Sysml2SourceFile *own_file,
+    Sysml2ResultFileLookup lookup,
+    void *lookup_data
+);
+
+/*
+ * Store the validation results of a source file
+ *
+ * @param cache Model cache
+ * @param abs_path Absolute path of the source file
+ * @param config_hash Configuration hash (see sysml2_model_cache_load_results)
+ * @param deps Dependencies, the file itself first
+ * @param dep_count Number of dependencies
+ * @param diags Diagnostics reported for the file, in order
+ * @param diag_count Number of diagnostics
+ * @param own_file Source file that diagnostics located in the file itself use
+ * @return SYSML2_OK on success, error code otherwise
+ */
+Sysml2Result sysml2_model_cache_store_results(
+    Sysml2ModelCache *cache,
+    const char *abs_path,
+    uint64_t config_hash,
+    const Sysml2ResultDependency *deps,
+    size_t dep_count,
+    const Sysml2Diagnostic *const *diags,
+    size_t diag_count,
+    const Sysml2SourceFile *own_file
+);
+
+/*
+ * 64-bit FNV-1a hash used for cache keys and content validation
+ */
+uint64_t sysml2_model_cache_hash(const void *data, size_t length);
+
+#endif /* SYSML2_MODEL_CACHE_H */
@@ -127,7 +127,11 @@ Sysml2Result sysml2_modify_plan_add_set_content(
  * 2. Cascade deletion to children
  * 3. Copy non-deleted elements to new model
  * 4. Filter relationships (remove if source or target deleted)
- * 5. Filter imports (remove if owner scope deleted)
+ * 5. Filter imports and aliases (remove if owner scope deleted)
+ *
+ * The result shares nodes, relationships, imports and aliases with the
+ * original; only the filtered pointer arrays are new. When nothing
+ * matches, it shares the arrays too.
  *
  * @param original Original model (unchanged)
  * @param patterns Delete patterns (linked list)
@@ -155,13 +159,18 @@ SysmlSemanticModel *sysml2_modify_clone_with_deletions(
  * 4. Add new elements
  * 5. Remap relationships and imports
  *
+ * Base nodes the fragment does not replace are shared with the result,
+ * as are preserved statements and metadata of replaced nodes; the target
+ * scope is copied before its metadata changes. The base model is never
+ * modified.
+ *
  * @param base Base model to modify (actually creates new model)
  * @param fragment Fragment to merge
  * @param target_scope Target scope for insertion
  * @param create_scope Create scope chain if doesn't exist
  * @param replace_scope Clear target scope before inserting (preserves fragment order)
  * @param arena Memory arena for new model
- * @param intern String intern table
+ * @param intern String intern table base and fragment IDs are interned in
  * @param out_added_count Output: number of elements added
  * @param out_replaced_count Output: number of elements replaced
  * @return New model with merge applied, or NULL on error
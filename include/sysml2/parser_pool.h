@@ -0,0 +1,65 @@
+/*
+ * SysML v2 Parser - Parser Memory Pool
+ *
+ * Backs the PackCC allocation hooks (PCC_MALLOC/PCC_REALLOC/PCC_FREE).
+ * The generated parser builds its memo tables, thunk pools and capture
+ * buffers for every file and frees them all in sysml2_destroy(); the
+ * pool keeps those blocks in per-thread free lists instead, so the next
+ * parse on the same thread reuses memory that is already mapped.
+ *
+ * Blocks are rounded up to power-of-two size classes. Blocks larger than
+ * the biggest class go straight to malloc. A block may be freed on any
+ * thread; it joins that thread's lists. Blocks are charged to the memory
+ * budget (memory_budget.h) while they are allocated, cached or not.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef SYSML2_PARSER_POOL_H
+#define SYSML2_PARSER_POOL_H
+
+#include <stddef.h>
+
+/* Free bytes a thread keeps for reuse; frees beyond this go to the heap */
+#define SYSML2_PARSER_POOL_MAX_CACHED (64u * 1024 * 1024)
+
+/*
+ * Allocate a block (aborts with a message when out of memory, like
+ * PackCC's default hooks, since the generated code never checks)
+ *
+ * @param size Size in bytes
+ * @return Block, suitably aligned for any type
+ */
+void *sysml2_parser_pool_alloc(size_t size);
+
+/*
+ * Resize a block
+ *
+ * @param ptr Block from this pool, or NULL
+ * @param size New size in bytes
+ * @return Block holding the old contents (may be ptr itself)
+ */
+void *sysml2_parser_pool_realloc(void *ptr, size_t size);
+
+/*
+ * Return a block to the calling thread's free lists
+ *
+ * @param ptr Block from this pool, or NULL
+ */
+void sysml2_parser_pool_free(void *ptr);
+
+/*
+ * Release every block cached by the calling thread
+ *
+ * Threads release their cache automatically when they exit.
+ */
+void sysml2_parser_pool_trim(void);
+
+/*
+ * Bytes currently cached by the calling thread
+ *
+ * @return Cached bytes (block capacities)
+ */
+size_t sysml2_parser_pool_cached(void);
+
+#endif /* SYSML2_PARSER_POOL_H */
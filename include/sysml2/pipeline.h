@@ -18,6 +18,9 @@
 #include "cli.h"
 #include "import_resolver.h"
 #include "query.h"
+#include "validator.h"
+#include "stats.h"
+#include "trace.h"
 
 /*
  * Pipeline Context - manages state for processing files
@@ -28,6 +31,28 @@ typedef struct Sysml2PipelineContext {
     Sysml2DiagContext *diag;
     Sysml2ImportResolver *resolver;
     const Sysml2CliOptions *options;
+    FILE *err_out;              /* Syntax errors from process_input (NULL = stderr) */
+
+    /* Called by process_files for each parsed model, in input order, as
+     * soon as it is registered (NULL = none) */
+    void (*on_parsed)(struct Sysml2PipelineContext *ctx, SysmlSemanticModel *model, void *data);
+    void *on_parsed_data;
+    /* With on_parsed, rewind the arena and interner after each model that
+     * parsed cleanly and drop it (NULL in out_models): the callback is its
+     * only reader, so memory stays near one file's worth */
+    bool reclaim_parsed;
+
+    /* Statistics */
+    size_t files_parsed;        /* Inputs run through the parser */
+    size_t bytes_parsed;        /* Their total size */
+    Sysml2Stats *stats;         /* Owned; set when options->stats_format is not NONE */
+    Sysml2Trace *trace;         /* Owned; set when options->trace_path is given */
+
+    /* Models the library preload cached, and their symbol layer, built
+     * by the first validation and shared by later ones */
+    SysmlSemanticModel **library_models;  /* Owned array, NULL before the preload */
+    size_t library_model_count;
+    Sysml2SymbolLayer *library_layer;     /* Arena-owned, NULL until built */
 } Sysml2PipelineContext;
 
 /*
@@ -51,6 +76,21 @@ Sysml2PipelineContext *sysml2_pipeline_create(
  */
 void sysml2_pipeline_destroy(Sysml2PipelineContext *ctx);
 
+/*
+ * Reuse a loaded context for another command line (--daemon)
+ *
+ * The libraries ctx has loaded are kept if options would load the same
+ * ones: the same library paths once SYSML2_LIBRARY_PATH and the working
+ * directory are applied, the same cache directory and the same preload
+ * setting. Diagnostics from loading are replayed under the new
+ * options; stats, trace, verbosity and job count follow the new options.
+ *
+ * @param ctx Loaded context (modified in place on success)
+ * @param options New CLI options (caller owns)
+ * @return true if ctx now runs with options, false if it cannot
+ */
+bool sysml2_pipeline_reuse(Sysml2PipelineContext *ctx, const Sysml2CliOptions *options);
+
 /*
  * Process a single file
  *
@@ -67,6 +107,37 @@ Sysml2Result sysml2_pipeline_process_file(
     SysmlSemanticModel **out_model
 );
 
+/*
+ * Process a list of files, optionally in parallel
+ *
+ * With jobs > 1, files are parsed concurrently into worker-local arenas
+ * and intern tables, then merged into the pipeline arena in input order.
+ * Syntax errors and verbose output are buffered per file and replayed in
+ * the same order, so results are identical to calling
+ * sysml2_pipeline_process_file() on each path in turn.
+ *
+ * Each parsed model is registered with the import resolver under its
+ * path as soon as it is merged.
+ *
+ * @param ctx Pipeline context
+ * @param paths Paths of files to parse
+ * @param count Number of paths
+ * @param jobs Number of parser threads (<= 1 parses serially)
+ * @param stop_at_error_limit Stop after the file that reaches max_errors
+ * @param out_models Output: model per path, NULL where parsing failed
+ * @param out_processed Output: number of files processed (may be NULL)
+ * @return SYSML2_OK if all files parsed cleanly, otherwise the first error
+ */
+Sysml2Result sysml2_pipeline_process_files(
+    Sysml2PipelineContext *ctx,
+    const char **paths,
+    size_t count,
+    size_t jobs,
+    bool stop_at_error_limit,
+    SysmlSemanticModel **out_models,
+    size_t *out_processed
+);
+
 /*
  * Process stdin
  *
@@ -81,6 +152,26 @@ Sysml2Result sysml2_pipeline_process_stdin(
     SysmlSemanticModel **out_model
 );
 
+/*
+ * Check that files parse, without building models (--syntax-only)
+ *
+ * Runs the parser as a recognizer: no build context is created, so the
+ * grammar actions do nothing and only syntax errors (with their
+ * locations) are reported and counted in the diagnostic context. Nothing
+ * is interned, cached or added to the resolver. Files are checked on
+ * ctx->options->jobs threads and their errors written in input order.
+ *
+ * @param ctx Pipeline context
+ * @param paths Files to check; with count 0, stdin is checked instead
+ * @param count Number of paths
+ * @return SYSML2_OK if every input parsed cleanly, otherwise the first error
+ */
+Sysml2Result sysml2_pipeline_check_syntax(
+    Sysml2PipelineContext *ctx,
+    const char **paths,
+    size_t count
+);
+
 /*
  * Process input content (shared implementation)
  *
@@ -99,6 +190,29 @@ Sysml2Result sysml2_pipeline_process_input(
     SysmlSemanticModel **out_model
 );
 
+/*
+ * Make the configured library paths available for resolution
+ *
+ * Parses every library file, or with --lazy-libraries only maps their
+ * packages to files (see sysml2_resolver_index_libraries). Does nothing
+ * under --no-resolve; safe to call more than once.
+ *
+ * @param ctx Pipeline context
+ */
+void sysml2_pipeline_load_libraries(Sysml2PipelineContext *ctx);
+
+/*
+ * Symbol layer of the preloaded libraries, built on first use
+ *
+ * Validations pass it as Sysml2ValidationOptions.layer, so the library
+ * symbols are indexed once per context rather than once per validation
+ * (the --serve loop, --daemon requests, the --lazy-libraries retry).
+ *
+ * @param ctx Pipeline context
+ * @return The layer, or NULL without preloaded libraries or on failure
+ */
+const Sysml2SymbolLayer *sysml2_pipeline_library_layer(Sysml2PipelineContext *ctx);
+
 /*
  * Resolve imports for all cached models
  *
@@ -110,11 +224,34 @@ Sysml2Result sysml2_pipeline_resolve_all(Sysml2PipelineContext *ctx);
 /*
  * Run validation on all cached models
  *
+ * With --lazy-libraries, first loads the library files that qualified
+ * names refer to. If names are still undefined after that (they may come
+ * from a library package nobody imported), every library file is loaded
+ * and validation runs again, so the diagnostics match an eager run.
+ *
  * @param ctx Pipeline context
  * @return SYSML2_OK on success, error code otherwise
  */
 Sysml2Result sysml2_pipeline_validate_all(Sysml2PipelineContext *ctx);
 
+/*
+ * Find the users of matching elements across all cached models
+ *
+ * Indexes every resolved reference between the cached models (input
+ * files and loaded libraries) and follows it backwards from the
+ * matching elements; see sysml2_query_users.
+ *
+ * @param ctx Pipeline context
+ * @param patterns Query patterns selecting the used elements
+ * @param depth Levels of users to follow (0 = no limit)
+ * @return Query result with the users, or NULL on error
+ */
+Sysml2QueryResult *sysml2_pipeline_query_users(
+    Sysml2PipelineContext *ctx,
+    const Sysml2QueryPattern *patterns,
+    size_t depth
+);
+
 /*
  * Write model as JSON to output stream
  *
@@ -129,6 +266,20 @@ Sysml2Result sysml2_pipeline_write_json(
     FILE *out
 );
 
+/*
+ * Write model as NDJSON to output stream
+ *
+ * @param ctx Pipeline context
+ * @param model Model to write
+ * @param out Output stream
+ * @return SYSML2_OK on success, error code otherwise
+ */
+Sysml2Result sysml2_pipeline_write_ndjson(
+    Sysml2PipelineContext *ctx,
+    SysmlSemanticModel *model,
+    FILE *out
+);
+
 /*
  * Write model as SysML to output stream
  *
@@ -143,6 +294,42 @@ Sysml2Result sysml2_pipeline_write_sysml(
     FILE *out
 );
 
+/*
+ * Write models as SysML to output stream, one after another
+ *
+ * With --jobs above 1 the models are rendered on worker threads (they are
+ * only read) and written in order as each finishes, so the output is the
+ * same as writing them one by one. NULL entries are skipped.
+ *
+ * @param ctx Pipeline context
+ * @param models Models to write
+ * @param model_count Number of models
+ * @param out Output stream
+ * @return SYSML2_OK on success, error code otherwise
+ */
+Sysml2Result sysml2_pipeline_write_sysml_models(
+    Sysml2PipelineContext *ctx,
+    SysmlSemanticModel **models,
+    size_t model_count,
+    FILE *out
+);
+
+/*
+ * Write models as one binary model file to output stream
+ *
+ * @param ctx Pipeline context
+ * @param models Models to write
+ * @param model_count Number of models
+ * @param out Output stream
+ * @return SYSML2_OK on success, error code otherwise
+ */
+Sysml2Result sysml2_pipeline_write_binary(
+    Sysml2PipelineContext *ctx,
+    SysmlSemanticModel **models,
+    size_t model_count,
+    FILE *out
+);
+
 /*
  * Print diagnostics summary
  *
@@ -151,6 +338,18 @@ Sysml2Result sysml2_pipeline_write_sysml(
  */
 void sysml2_pipeline_print_diagnostics(Sysml2PipelineContext *ctx, FILE *output);
 
+/*
+ * Print the --stats report
+ *
+ * Collects counters from the pipeline, resolver, model cache and intern
+ * table and prints them with the phase timings. No-op unless stats
+ * were enabled in the options.
+ *
+ * @param ctx Pipeline context
+ * @param output Output stream
+ */
+void sysml2_pipeline_print_stats(Sysml2PipelineContext *ctx, FILE *output);
+
 /*
  * Get diagnostic context from pipeline
  *
@@ -197,6 +396,20 @@ Sysml2Result sysml2_pipeline_write_query_json(
     FILE *out
 );
 
+/*
+ * Write query result as NDJSON to output stream
+ *
+ * @param ctx Pipeline context
+ * @param result Query result to write
+ * @param out Output stream
+ * @return SYSML2_OK on success, error code otherwise
+ */
+Sysml2Result sysml2_pipeline_write_query_ndjson(
+    Sysml2PipelineContext *ctx,
+    const Sysml2QueryResult *result,
+    FILE *out
+);
+
 /*
  * Write query result as SysML to output stream
  *
@@ -217,4 +430,20 @@ Sysml2Result sysml2_pipeline_write_query_sysml(
     FILE *out
 );
 
+/*
+ * Write query result as a binary model file to output stream
+ *
+ * The result is written as a single source named "<query>".
+ *
+ * @param ctx Pipeline context
+ * @param result Query result to write
+ * @param out Output stream
+ * @return SYSML2_OK on success, error code otherwise
+ */
+Sysml2Result sysml2_pipeline_write_query_binary(
+    Sysml2PipelineContext *ctx,
+    const Sysml2QueryResult *result,
+    FILE *out
+);
+
 #endif /* SYSML2_PIPELINE_H */
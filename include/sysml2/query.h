@@ -37,6 +37,110 @@ typedef struct Sysml2QueryPattern {
     struct Sysml2QueryPattern *next;    /* Linked list for multiple patterns */
 } Sysml2QueryPattern;
 
+/*
+ * Pattern trie node - one "::" segment shared by one or more base paths
+ */
+typedef struct Sysml2QueryTrieNode {
+    const char *segment;                    /* Segment text (not terminated) */
+    size_t segment_length;
+    unsigned kinds;                         /* (1 << kind) for each pattern ending here */
+    struct Sysml2QueryTrieNode *children;   /* First child */
+    struct Sysml2QueryTrieNode *next;       /* Next sibling */
+} Sysml2QueryTrieNode;
+
+/*
+ * Query matcher - a pattern list compiled for matching many element IDs
+ *
+ * Base paths are merged into a trie over "::" segments, so matching an
+ * ID costs one walk over its segments however many patterns there are.
+ * Base paths with stray ':' characters are kept aside and matched with
+ * sysml2_query_matches.
+ */
+typedef struct {
+    Sysml2QueryTrieNode root;
+    const Sysml2QueryPattern **fallback;
+    size_t fallback_count;
+} Sysml2QueryMatcher;
+
+/*
+ * ID set slot (id == NULL means empty)
+ */
+typedef struct {
+    const char *id;
+    uint32_t hash;                      /* sysml2_hash_string of id */
+} Sysml2IdSetSlot;
+
+/*
+ * ID set - open-addressed hash set of element IDs
+ *
+ * Keyed by string content, so IDs that are not interned (e.g. computed
+ * parent paths) are found too; interned IDs match on the pointer before
+ * any string compare. Slots live in the arena and are never freed
+ * individually. A zeroed struct is an empty set.
+ */
+typedef struct {
+    Sysml2IdSetSlot *slots;
+    size_t capacity;                    /* Power of two, 0 until first insert */
+    size_t count;
+} Sysml2IdSet;
+
+/*
+ * ID map slot (id == NULL means empty)
+ */
+typedef struct {
+    const char *id;
+    void *value;
+} Sysml2IdMapSlot;
+
+/*
+ * ID map - open-addressed hash map from an element ID to a pointer
+ *
+ * Unlike Sysml2IdSet, keys are compared by pointer (sysml2_id_hash,
+ * sysml2_id_eq), so every key must be interned in the same table. Slots
+ * live in the arena and are never freed individually. A zeroed struct is
+ * an empty map.
+ */
+typedef struct {
+    Sysml2IdMapSlot *slots;
+    size_t capacity;                    /* Power of two, 0 until first insert */
+    size_t count;
+} Sysml2IdMap;
+
+/*
+ * Kind of reference from a user element to the element it names
+ */
+typedef enum {
+    SYSML2_REF_TYPED_BY,                /* : Type */
+    SYSML2_REF_SPECIALIZES,             /* :> Type */
+    SYSML2_REF_REDEFINES,               /* :>> feature */
+    SYSML2_REF_REFERENCES,              /* ::> feature */
+    SYSML2_REF_RELATIONSHIP,            /* Source of a relationship to the target */
+} Sysml2RefKind;
+
+/*
+ * One resolved reference to an element
+ */
+typedef struct Sysml2RefEdge {
+    SysmlNode *user;                    /* Element whose reference resolved here */
+    Sysml2RefKind kind;
+    struct Sysml2RefEdge *next;         /* Next user of the same element */
+} Sysml2RefEdge;
+
+/*
+ * Reference index - maps each element ID to the elements that use it
+ *
+ * Filled from resolved typing, specialization, redefinition and
+ * reference edges plus relationship endpoints (see
+ * sysml2_validator_index_references), so finding the users of an
+ * element is one lookup instead of a scan over every model. IDs must be
+ * interned. Storage lives in the arena. A zeroed struct is an empty
+ * index.
+ */
+typedef struct {
+    Sysml2IdMap users;                  /* Referenced element ID -> its users */
+    size_t edge_count;
+} Sysml2RefIndex;
+
 /*
  * Query result - contains filtered elements and relationships
  */
@@ -53,10 +157,11 @@ typedef struct {
     size_t import_count;
     size_t import_capacity;
 
-    /* Set of element IDs in result (for relationship filtering) */
+    /* Element IDs in result, in insertion order (for relationship filtering) */
     const char **element_ids;
     size_t element_id_count;
     size_t element_id_capacity;
+    Sysml2IdSet element_id_set;         /* Membership index over element_ids */
 } Sysml2QueryResult;
 
 /*
@@ -105,6 +210,40 @@ bool sysml2_query_matches(const Sysml2QueryPattern *pattern, const char *element
  */
 bool sysml2_query_matches_any(const Sysml2QueryPattern *patterns, const char *element_id);
 
+/*
+ * Compile a pattern list into a matcher
+ *
+ * The matcher references the patterns' base paths, which must outlive it.
+ *
+ * @param patterns Linked list of query patterns
+ * @param arena Memory arena for the matcher
+ * @return Compiled matcher, or NULL on allocation failure
+ */
+Sysml2QueryMatcher *sysml2_query_compile(const Sysml2QueryPattern *patterns, Sysml2Arena *arena);
+
+/*
+ * Check if an element ID matches a compiled matcher
+ *
+ * Same result as sysml2_query_matches_any on the compiled patterns.
+ *
+ * @param matcher Compiled matcher
+ * @param element_id Element ID to check
+ * @return true if the element matches any pattern
+ */
+bool sysml2_query_matcher_matches(const Sysml2QueryMatcher *matcher, const char *element_id);
+
+/*
+ * Check if an element matches a compiled matcher
+ *
+ * Walks the element's linked parents instead of splitting its ID; takes
+ * the ID path when they are not set.
+ *
+ * @param matcher Compiled matcher
+ * @param node Element to check
+ * @return true if the element matches any pattern
+ */
+bool sysml2_query_matcher_matches_node(const Sysml2QueryMatcher *matcher, const SysmlNode *node);
+
 /*
  * Execute a query against one or more semantic models
  *
@@ -124,6 +263,33 @@ Sysml2QueryResult *sysml2_query_execute(
     Sysml2Arena *arena
 );
 
+/*
+ * Find the users of matching elements through a reference index
+ *
+ * Starts from the elements matching any pattern and follows the index
+ * breadth first: depth 1 returns their direct users, depth 2 adds the
+ * users of those, and so on; depth 0 follows users until no new ones are
+ * found. The starting elements appear only if they use each other.
+ * Elements are in discovery order; relationships and imports are
+ * collected as for sysml2_query_execute.
+ *
+ * @param patterns Linked list of query patterns selecting the elements
+ * @param index Reference index over the models
+ * @param depth Levels of users to follow (0 = no limit)
+ * @param models Array of semantic models to query
+ * @param model_count Number of models
+ * @param arena Memory arena for result allocation
+ * @return Query result with the users, or NULL on error
+ */
+Sysml2QueryResult *sysml2_query_users(
+    const Sysml2QueryPattern *patterns,
+    const Sysml2RefIndex *index,
+    size_t depth,
+    SysmlSemanticModel **models,
+    size_t model_count,
+    Sysml2Arena *arena
+);
+
 /*
  * Check if an element ID is in the query result
  *
@@ -133,6 +299,71 @@ Sysml2QueryResult *sysml2_query_execute(
  */
 bool sysml2_query_result_contains(const Sysml2QueryResult *result, const char *element_id);
 
+/*
+ * Add an ID to an ID set
+ *
+ * @param set ID set
+ * @param id Element ID (must outlive the set)
+ * @param arena Memory arena for slot storage
+ * @return true if present afterwards, false on allocation failure
+ */
+bool sysml2_id_set_add(Sysml2IdSet *set, const char *id, Sysml2Arena *arena);
+
+/*
+ * Check if an ID set contains an ID
+ *
+ * @param set ID set
+ * @param id Element ID to look for
+ * @return true if the set contains an equal string
+ */
+bool sysml2_id_set_contains(const Sysml2IdSet *set, const char *id);
+
+/*
+ * Get the value stored for an ID
+ *
+ * @param map ID map
+ * @param id Interned element ID
+ * @return Stored value, or NULL if the ID is not in the map
+ */
+void *sysml2_id_map_get(const Sysml2IdMap *map, const char *id);
+
+/*
+ * Get the slot for an ID, inserting it with a NULL value if missing
+ *
+ * @param map ID map
+ * @param id Interned element ID (must outlive the map)
+ * @param arena Memory arena for slot storage
+ * @return Slot (valid until the next insert), or NULL on allocation failure
+ */
+Sysml2IdMapSlot *sysml2_id_map_slot(Sysml2IdMap *map, const char *id, Sysml2Arena *arena);
+
+/*
+ * Record that user refers to the element with ID id
+ *
+ * @param index Reference index
+ * @param id Interned referenced element ID (must outlive the index)
+ * @param user Referring element
+ * @param kind Kind of reference
+ * @param arena Memory arena for index storage
+ * @return true if recorded, false on allocation failure
+ */
+bool sysml2_ref_index_add(
+    Sysml2RefIndex *index,
+    const char *id,
+    SysmlNode *user,
+    Sysml2RefKind kind,
+    Sysml2Arena *arena
+);
+
+/*
+ * Get the users of an element
+ *
+ * @param index Reference index
+ * @param id Interned element ID
+ * @return First user (follow next for the rest), NULL if it has none
+ */
+const Sysml2RefEdge *sysml2_ref_index_users(const Sysml2RefIndex *index, const char *id);
+
 /*
  * Free a query result (if not using arena allocation)
  *
@@ -160,7 +391,8 @@ const char *sysml2_query_parent_path(const char *element_id, Sysml2Arena *arena)
  *
  * When outputting a filtered result as SysML, we need parent package stubs
  * to maintain valid syntax. This returns all ancestor IDs for elements in
- * the result that are not themselves in the result.
+ * the result that are not themselves in the result. They are taken from
+ * the elements' parent_id and linked parents where set.
  *
  * @param result Query result
  * @param models Source models (to look up ancestor nodes)
@@ -0,0 +1,94 @@
+/*
+ * SysML v2 Parser - Workspace Server
+ *
+ * Long-running mode (--serve) for editors and pre-commit hooks. The
+ * pipeline's file cache, package map and preloaded libraries stay
+ * resident between requests, so a change re-parses only the edited
+ * file and re-validates only the files that may depend on it.
+ *
+ * Protocol: JSON-RPC 2.0 over stdin/stdout, one request per line and
+ * one response line per request.
+ *
+ *   load         {"files": ["a.sysml", ...]}   Parse and validate files
+ *   change       {"path": "a.sysml", "text"?: "..."}
+ *                                             Re-parse one file (from disk
+ *                                             unless text is given)
+ *   diagnostics  {"path"?: "a.sysml"}         Current results, no work
+ *   shutdown                                  Reply, then exit
+ *
+ * load and change reply with the files whose results were recomputed:
+ *
+ *   {"reparsed": 1, "validated": 3, "files": [
+ *     {"path": "/abs/a.sysml", "syntax": null,
+ *      "diagnostics": [{"severity": "error", "code": "E3001",
+ *                       "line": 4, "column": 5, "message": "...",
+ *                       "help": "..."}]}]}
+ *
+ * "syntax" holds the parser's error output when the file does not parse;
+ * its previous model (if any) then stays in use for its dependents.
+ * Diagnostics are only reported for files named by the client, not for
+ * libraries pulled in by imports.
+ *
+ * A file depends on an edited file if it mentions (as its own root
+ * element or as the first segment of a reference or import) a root
+ * element name of the old or new version, or depends on such a file.
+ * Library packages are implicitly imported everywhere, so editing one
+ * re-validates every file.
+ *
+ * Each workspace file's model lives in an arena of its own, which is
+ * freed together with the file's text when a change replaces the model,
+ * so a long session holds one model per file. Only names interned for
+ * the first time stay behind in the pipeline's intern table.
+ *
+ * Batch mode (--batch) is for services that validate many independent
+ * documents: the libraries are loaded once and every document is parsed
+ * and validated against them alone, without import resolution. Input
+ * records on stdin are either a path on a line of its own or an inline
+ * document:
+ *
+ *   models/a.sysml
+ *   @<length> [name]\n<length bytes of text>
+ *
+ * Each document gets one result line, flushed as soon as it is ready:
+ *
+ *   {"path": "models/a.sysml", "ok": false, "syntax": null,
+ *    "diagnostics": [...]}
+ *
+ * with "syntax" and "diagnostics" as in the server's file results.
+ * Everything a document allocates is rewound out of the pipeline arena
+ * and intern table before the next one, so memory stays at the
+ * libraries' footprint however many documents pass through.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef SYSML2_SERVER_H
+#define SYSML2_SERVER_H
+
+#include "common.h"
+#include "pipeline.h"
+
+#include <stdio.h>
+
+/*
+ * Serve requests until shutdown or end of input
+ *
+ * @param ctx Pipeline context (libraries already preloaded)
+ * @param in Request stream
+ * @param out Response stream (flushed after every response)
+ * @return Process exit code (0 after shutdown or end of input)
+ */
+int sysml2_server_run(Sysml2PipelineContext *ctx, FILE *in, FILE *out);
+
+/*
+ * Validate the documents named or contained in a batch stream
+ *
+ * @param ctx Pipeline context (libraries already preloaded)
+ * @param in Batch records
+ * @param out Result stream, one line per document
+ * @return Process exit code: 1 if a document did not parse or the input
+ *         was malformed, else 2 if one had validation errors, else 0
+ */
+int sysml2_batch_run(Sysml2PipelineContext *ctx, FILE *in, FILE *out);
+
+#endif /* SYSML2_SERVER_H */
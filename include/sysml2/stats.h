@@ -0,0 +1,158 @@
+/*
+ * SysML v2 Parser - Run Statistics
+ *
+ * Wall and CPU time per pipeline phase and per validator pass, for
+ * `--stats`. Counters that cost nothing to keep (files parsed, cache
+ * hits, bytes read) live in the structures that own them; the report
+ * collects them at the end of the run.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef SYSML2_STATS_H
+#define SYSML2_STATS_H
+
+#include "common.h"
+#include "arena.h"
+#include <stdio.h>
+
+/* Pipeline phases */
+typedef enum {
+    SYSML2_PHASE_LIBRARIES,     /* Library preload and package discovery */
+    SYSML2_PHASE_PARSE,         /* Input files */
+    SYSML2_PHASE_RESOLVE,       /* Import resolution (parses imported files) */
+    SYSML2_PHASE_VALIDATE,      /* Semantic validation */
+    SYSML2_PHASE_WRITE,         /* Output and rewritten files */
+    SYSML2_PHASE_COUNT
+} Sysml2Phase;
+
+/* Validator passes, in run order */
+typedef enum {
+    SYSML2_PASS_SYMTAB,         /* 1: symbol table and duplicates */
+    SYSML2_PASS_TYPES,          /* 2: type resolution */
+    SYSML2_PASS_CYCLES,         /* 3: circular specializations */
+    SYSML2_PASS_MULTIPLICITIES, /* 4 */
+    SYSML2_PASS_REDEFINES,      /* 5 */
+    SYSML2_PASS_IMPORTS,        /* 6 */
+    SYSML2_PASS_ABSTRACT,       /* 7: abstract instantiation */
+    SYSML2_PASS_COUNT
+} Sysml2ValidatorPass;
+
+/* Accumulated time of one phase or pass */
+typedef struct {
+    uint64_t wall_ns;
+    uint64_t cpu_ns;
+    size_t runs;
+    size_t arena_bytes;         /* Arena growth while running (phases only) */
+    size_t memory_peak;         /* Highest memory budget use while running (phases only) */
+} Sysml2StatsTimer;
+
+/*
+ * Stats - timings of one run
+ */
+typedef struct {
+    const Sysml2Arena *arena;   /* Arena whose growth is attributed */
+    uint64_t start_wall_ns;
+    uint64_t start_cpu_ns;
+
+    Sysml2StatsTimer phases[SYSML2_PHASE_COUNT];
+    Sysml2StatsTimer passes[SYSML2_PASS_COUNT];
+
+    /* Running phases: nesting depth and start readings */
+    unsigned depth[SYSML2_PHASE_COUNT];
+    uint64_t phase_wall[SYSML2_PHASE_COUNT];
+    uint64_t phase_cpu[SYSML2_PHASE_COUNT];
+    size_t phase_arena[SYSML2_PHASE_COUNT];
+    size_t phase_outer_peak[SYSML2_PHASE_COUNT];
+
+    size_t arena_peak;          /* Largest sysml2_arena_used() seen */
+
+    /* Last validation's symbol table */
+    size_t scope_count;
+    size_t symbol_count;
+} Sysml2Stats;
+
+/* Everything the report prints besides the timers */
+typedef struct {
+    size_t input_files;         /* Input files parsed */
+    size_t input_bytes;         /* Bytes of input parsed */
+    size_t library_files;       /* Imported/library files parsed */
+    size_t library_bytes;       /* Bytes of those files */
+    size_t model_cache_hits;    /* Files loaded from --cache-dir */
+    size_t model_cache_misses;
+    size_t file_cache_hits;     /* Lookups answered by the resolver's file cache */
+    size_t file_cache_count;    /* Files in it */
+    size_t intern_count;        /* Unique interned strings */
+    size_t intern_capacity;     /* Intern table slots */
+} Sysml2StatsCounters;
+
+/* Monotonic wall clock in nanoseconds */
+uint64_t sysml2_stats_wall_ns(void);
+
+/* CPU time of the calling thread in nanoseconds */
+uint64_t sysml2_stats_thread_cpu_ns(void);
+
+/*
+ * Initialize stats and start the run clock
+ *
+ * @param stats Stats to initialize
+ * @param arena Arena to watch (may be NULL)
+ */
+void sysml2_stats_init(Sysml2Stats *stats, const Sysml2Arena *arena);
+
+/*
+ * Start or stop timing a phase
+ *
+ * Calls nest: only the outermost start/stop pair is timed. CPU time is
+ * that of the whole process, so phases running worker threads count
+ * every thread. The memory budget is told about every call, also
+ * without stats, so a --memory-limit breach can name its phase.
+ *
+ * @param stats Stats (NULL = only the memory budget's phase is tracked)
+ * @param phase Phase
+ */
+void sysml2_stats_phase_start(Sysml2Stats *stats, Sysml2Phase phase);
+void sysml2_stats_phase_stop(Sysml2Stats *stats, Sysml2Phase phase);
+
+/*
+ * Add one run of a validator pass
+ *
+ * @param stats Stats (NULL = no-op)
+ * @param pass Pass
+ * @param wall_ns Wall time of the run
+ * @param cpu_ns CPU time of the run
+ */
+void sysml2_stats_add_pass(Sysml2Stats *stats, Sysml2ValidatorPass pass,
+                           uint64_t wall_ns, uint64_t cpu_ns);
+
+/*
+ * Name of a phase as printed in the report
+ *
+ * @param phase Phase
+ * @return Static string
+ */
+const char *sysml2_stats_phase_name(Sysml2Phase phase);
+
+/*
+ * Name of a validator pass as printed in the report
+ *
+ * @param pass Pass
+ * @return Static string
+ */
+const char *sysml2_stats_pass_name(Sysml2ValidatorPass pass);
+
+/*
+ * Print the report
+ *
+ * The text form is a table for people; the JSON form is one object on
+ * one line.
+ *
+ * @param stats Stats
+ * @param counters Counters collected from the run
+ * @param json Print JSON instead of text
+ * @param out Output stream
+ */
+void sysml2_stats_print(const Sysml2Stats *stats, const Sysml2StatsCounters *counters,
+                        bool json, FILE *out);
+
+#endif /* SYSML2_STATS_H */
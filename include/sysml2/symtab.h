@@ -1,7 +1,15 @@
 /*
  * SysML v2 Parser - Symbol Table
  *
- * Two-level hash table for name resolution in semantic validation.
+ * Scope index plus per-scope member lists for name resolution in
+ * semantic validation.
+ *
+ * Tables can be layered: a frozen table (typically the standard
+ * library's symbols, built once) sits under a cheap per-run overlay.
+ * The overlay answers lookups from its own entries first and then from
+ * the frozen layer. Adding to a scope of the frozen layer gives the
+ * overlay its own "shadow" of that scope, holding only the additions
+ * and pointing at the frozen scope through `lower`.
  *
  * SPDX-License-Identifier: MIT
  */
@@ -15,8 +23,10 @@
 #include "ast.h"
 
 /* Default symbol table sizes */
-#define SYSML_SYMTAB_DEFAULT_SCOPE_CAPACITY 256
-#define SYSML_SYMTAB_DEFAULT_SYMBOL_CAPACITY 32
+#define SYSML_SYMTAB_DEFAULT_SCOPE_CAPACITY 256  /* Scope index slots (power of two) */
+#define SYSML_SYMTAB_INLINE_SYMBOLS 4            /* Members stored in the scope itself */
+#define SYSML_SYMTAB_INDEX_THRESHOLD 8           /* Members scanned linearly before hashing */
+#define SYSML_SYMTAB_SYMBOL_BLOCK 256            /* Symbols per allocation block */
 
 /*
  * Symbol Entry - represents a named element in a scope
@@ -25,34 +35,57 @@ typedef struct Sysml2Symbol {
     const char *name;           /* Local name (interned) */
     const char *qualified_id;   /* Full path ID */
     SysmlNode *node;            /* AST node */
-    struct Sysml2Symbol *next;   /* Hash chain */
+    uint32_t hash;              /* sysml2_hash_string of name */
+    uint32_t name_length;       /* strlen of name */
 } Sysml2Symbol;
 
 /*
  * Import Entry - represents an import in a scope
  */
 typedef struct Sysml2ImportEntry {
-    const char *target;         /* Imported qualified name */
+    const char *target;         /* Imported qualified name (interned) */
     SysmlNodeKind import_kind;  /* IMPORT, IMPORT_ALL, IMPORT_RECURSIVE */
+    const char *imported_name;  /* Final segment of target (member imports) */
+    struct Sysml2Scope *target_scope; /* Target namespace, NULL until it exists */
     struct Sysml2ImportEntry *next; /* Next import in chain */
 } Sysml2ImportEntry;
 
 /*
  * Scope Entry - represents a namespace/container
+ *
+ * Most scopes hold a handful of members, so they start in inline_symbols
+ * and are searched linearly; a hash index is added only once a scope
+ * grows past SYSML_SYMTAB_INDEX_THRESHOLD members.
  */
 typedef struct Sysml2Scope {
     const char *id;             /* Scope's qualified ID */
     struct Sysml2Scope *parent;  /* Enclosing scope */
-    Sysml2Symbol **symbols;      /* Hash table of symbols */
+    Sysml2Symbol **symbols;      /* Members in insertion order (NULL while empty) */
     size_t symbol_count;
     size_t symbol_capacity;
+    uint32_t *symbol_slots;      /* Hash index: member + 1, 0 = empty (NULL while small) */
+    size_t slot_capacity;        /* Power of two */
     Sysml2ImportEntry *imports;  /* Linked list of imports */
+    size_t index;                /* Creation order (root = 0), unique across layers */
+    const struct Sysml2Scope *lower; /* Frozen scope this one shadows, NULL if none */
+    bool frozen;                 /* Belongs to a frozen table */
+    Sysml2Symbol *inline_symbols[SYSML_SYMTAB_INLINE_SYMBOLS];
 } Sysml2Scope;
 
 /*
- * Symbol Table - two-level hash table for name resolution
+ * Resolution Cache Entry - memoized result of one (scope, name) lookup
  */
 typedef struct {
+    const Sysml2Scope *scope;   /* Starting scope */
+    const char *name;           /* Resolved name (interned), NULL = empty slot */
+    uint32_t hash;
+    Sysml2Symbol *symbol;       /* Result, NULL for a cached miss */
+} Sysml2ResolveCacheEntry;
+
+/*
+ * Symbol Table - scopes by ID, each with its own members
+ */
+typedef struct Sysml2SymbolTable {
     Sysml2Arena *arena;         /* Arena for allocations */
     Sysml2Intern *intern;       /* String interning */
 
@@ -63,6 +96,29 @@ typedef struct {
 
     /* Root scope (global/unnamed namespace) */
     Sysml2Scope *root_scope;
+
+    /* Symbols are carved from blocks, so a table's symbols sit together */
+    Sysml2Symbol *symbol_block;
+    size_t symbol_block_used;
+
+    /* Resolution cache: hits and misses of sysml2_symtab_resolve,
+     * cleared whenever a symbol, import or scope is added */
+    Sysml2ResolveCacheEntry *resolve_cache;
+    size_t resolve_cache_count;
+    size_t resolve_cache_capacity;
+
+    /* Import traversal stamps, indexed by scope index (cycle guard) */
+    uint32_t *import_visits;
+    size_t import_visit_capacity;
+    uint32_t import_visit_epoch;
+
+    /* Table this is a read-only view of, NULL for a normal table */
+    const struct Sysml2SymbolTable *base;
+
+    /* Frozen table under this overlay, NULL for a single-layer table */
+    const struct Sysml2SymbolTable *lower;
+    size_t shadow_count;        /* Scopes that shadow one of the lower layer */
+    bool frozen;                /* Read-only (see sysml2_symtab_freeze) */
 } Sysml2SymbolTable;
 
 /*
@@ -78,6 +134,58 @@ void sysml2_symtab_init(
     Sysml2Intern *intern
 );
 
+/*
+ * Initialize a read-only view of a symbol table
+ *
+ * A view shares scopes and symbols with its base but keeps its own
+ * resolution cache and traversal state, so several views can resolve
+ * names concurrently on different threads. The base must not change
+ * while views are in use. Views never add symbols, imports or scopes:
+ * sysml2_symtab_add and sysml2_symtab_add_import return NULL, and
+ * sysml2_symtab_get_or_create_scope returns the nearest existing
+ * enclosing scope for an unknown ID.
+ *
+ * @param view View to initialize
+ * @param base Symbol table to view
+ * @param arena Arena for the view's own allocations (e.g. thread-local)
+ */
+void sysml2_symtab_init_view(
+    Sysml2SymbolTable *view,
+    const Sysml2SymbolTable *base,
+    Sysml2Arena *arena
+);
+
+/*
+ * Freeze a symbol table so overlays can be layered on it
+ *
+ * Import targets are looked up once here. Afterwards the table never
+ * changes: like a view it refuses additions, so it can be shared by
+ * overlays on several threads. Resolve names through an overlay (or a
+ * view), not the frozen table itself.
+ *
+ * @param symtab Table to freeze (must not be an overlay or a view)
+ */
+void sysml2_symtab_freeze(Sysml2SymbolTable *symtab);
+
+/*
+ * Initialize an overlay on a frozen symbol table
+ *
+ * The overlay starts empty and takes additions like a normal table;
+ * lookups, resolution and suggestions see the frozen table's symbols,
+ * scopes and imports under the overlay's own.
+ *
+ * @param overlay Symbol table to initialize
+ * @param lower Frozen table (must outlive the overlay)
+ * @param arena Memory arena for the overlay's allocations
+ * @param intern String interning table (the one lower was built with)
+ */
+void sysml2_symtab_init_overlay(
+    Sysml2SymbolTable *overlay,
+    const Sysml2SymbolTable *lower,
+    Sysml2Arena *arena,
+    Sysml2Intern *intern
+);
+
 /*
  * Destroy a symbol table
  *
@@ -88,6 +196,9 @@ void sysml2_symtab_destroy(Sysml2SymbolTable *symtab);
 /*
  * Get or create a scope by ID
  *
+ * Lookups are fastest when scope_id is interned in the symbol table's
+ * interner (pointer compare); other strings are interned on a miss.
+ *
  * @param symtab Symbol table
  * @param scope_id Qualified scope ID (NULL for root scope)
  * @return Scope entry (never NULL)
@@ -97,6 +208,46 @@ Sysml2Scope *sysml2_symtab_get_or_create_scope(
     const char *scope_id
 );
 
+/*
+ * Get or create the scope an element is declared in
+ *
+ * Same as sysml2_symtab_get_or_create_scope(symtab, node->parent_id),
+ * but missing enclosing scopes are created from the element's linked
+ * parents instead of by splitting the ID.
+ *
+ * @param symtab Symbol table
+ * @param node Element
+ * @return Scope entry (never NULL)
+ */
+Sysml2Scope *sysml2_symtab_get_or_create_node_scope(
+    Sysml2SymbolTable *symtab,
+    const SysmlNode *node
+);
+
+/*
+ * Find an existing scope by ID (never creates one)
+ *
+ * @param symtab Symbol table
+ * @param scope_id Qualified scope ID, interned (NULL for root scope)
+ * @return Scope entry, or NULL if no scope has this ID
+ */
+Sysml2Scope *sysml2_symtab_find_scope(
+    const Sysml2SymbolTable *symtab,
+    const char *scope_id
+);
+
+/*
+ * Enclosing scope of a scope, as seen through the table's layers
+ *
+ * @param symtab Symbol table
+ * @param scope Scope (may belong to the frozen layer)
+ * @return Parent scope (the overlay's shadow if it has one), NULL for root
+ */
+const Sysml2Scope *sysml2_symtab_parent(
+    const Sysml2SymbolTable *symtab,
+    const Sysml2Scope *scope
+);
+
 /*
  * Add a symbol to a scope
  *
@@ -115,9 +266,31 @@ Sysml2Symbol *sysml2_symtab_add(
     SysmlNode *node
 );
 
+/*
+ * Add an import to a scope
+ *
+ * Imports must be added through this function (not by linking entries
+ * directly) so cached resolutions are invalidated. The new import is
+ * searched before the scope's existing imports.
+ *
+ * @param symtab Symbol table
+ * @param scope Importing scope
+ * @param target Imported qualified name
+ * @param import_kind IMPORT, IMPORT_ALL or IMPORT_RECURSIVE
+ * @return The new import entry, or NULL on allocation failure
+ */
+Sysml2ImportEntry *sysml2_symtab_add_import(
+    Sysml2SymbolTable *symtab,
+    Sysml2Scope *scope,
+    const char *target,
+    SysmlNodeKind import_kind
+);
+
 /*
  * Look up a symbol by local name in a specific scope (no parent search)
  *
+ * A shadow scope is searched with the frozen scope under it.
+ *
  * @param scope Scope to search
  * @param name Local name
  * @return Symbol if found, NULL otherwise
@@ -133,6 +306,9 @@ Sysml2Symbol *sysml2_symtab_lookup(
  * Handles both simple names (walk up scope chain) and
  * qualified names (resolve segments left-to-right).
  *
+ * Results, including misses, are cached per (scope, name) until the
+ * next symbol, import or scope is added.
+ *
  * @param symtab Symbol table
  * @param scope Starting scope for resolution
  * @param name Name to resolve (may contain "::")
@@ -0,0 +1,83 @@
+/*
+ * SysML v2 Parser - Trace Event Output
+ *
+ * Writes `--trace <file>` as Trace Event Format JSON (the format read by
+ * chrome://tracing and Perfetto). Spans are begin/end pairs on the calling
+ * thread, so a span opened inside another nests under it in the viewer:
+ * an import's parse and its own imports appear beneath the import that
+ * pulled them in.
+ *
+ * Every function accepts a NULL trace and does nothing, so call sites
+ * need no checks of their own.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef SYSML2_TRACE_H
+#define SYSML2_TRACE_H
+
+#include "common.h"
+#include <stdio.h>
+#include <pthread.h>
+
+/*
+ * Trace - an open trace file
+ *
+ * Events from any thread may be written; the lock keeps them whole.
+ */
+typedef struct {
+    FILE *out;
+    uint64_t start_ns;          /* Timestamps are microseconds since open */
+    size_t event_count;
+    pthread_mutex_t lock;
+} Sysml2Trace;
+
+/*
+ * Open a trace file and write the document header
+ *
+ * @param path File to create (truncated if it exists)
+ * @return Trace (free with sysml2_trace_close), NULL with errno set on error
+ */
+Sysml2Trace *sysml2_trace_open(const char *path);
+
+/*
+ * Finish the document and close the file
+ *
+ * Spans still open are left unterminated; viewers extend them to the end
+ * of the trace.
+ *
+ * @param trace Trace to close (may be NULL)
+ * @return SYSML2_OK, SYSML2_ERROR_FILE_READ if writing failed
+ */
+Sysml2Result sysml2_trace_close(Sysml2Trace *trace);
+
+/*
+ * Begin a span on the calling thread
+ *
+ * @param trace Trace (NULL = no-op)
+ * @param category Event category ("parse", "resolve", "validate", ...)
+ * @param name Span name
+ * @param detail Shown as args.detail, typically a path (may be NULL)
+ */
+void sysml2_trace_begin(Sysml2Trace *trace, const char *category,
+                        const char *name, const char *detail);
+
+/*
+ * End the innermost open span of the calling thread
+ *
+ * @param trace Trace (NULL = no-op)
+ */
+void sysml2_trace_end(Sysml2Trace *trace);
+
+/*
+ * Record a zero-length event on the calling thread
+ *
+ * @param trace Trace (NULL = no-op)
+ * @param category Event category
+ * @param name Event name
+ * @param detail Shown as args.detail (may be NULL)
+ */
+void sysml2_trace_instant(Sysml2Trace *trace, const char *category,
+                          const char *name, const char *detail);
+
+#endif /* SYSML2_TRACE_H */
@@ -13,6 +13,7 @@
 #include "arena.h"
 #include <stdbool.h>
 #include <stddef.h>
+#include <dirent.h>
 
 /*
  * Dynamic Array Growth Macro
@@ -47,6 +48,77 @@
  */
 char *sysml2_read_file(const char *path, size_t *out_size);
 
+/*
+ * Source Buffer - file contents, memory-mapped when possible
+ *
+ * Regular files are mapped read-only, so their contents cost no heap and
+ * only the pages actually touched are read. Pipes, devices, empty files
+ * and files whose size is an exact multiple of the page size (leaving no
+ * zero byte after the end) are read into a malloc'd buffer instead.
+ * Either way data[length] is '\0'.
+ */
+typedef struct {
+    const char *data;
+    size_t length;
+    size_t mapped_size;          /* Length of the mapping, 0 if malloc'd */
+} Sysml2SourceBuffer;
+
+/*
+ * Open a file as a source buffer
+ *
+ * The content is charged to the memory budget until it is released.
+ *
+ * @param path Path to file
+ * @param out Output: buffer (zeroed on failure)
+ * @return true on success, false with errno set on error
+ */
+bool sysml2_source_open(const char *path, Sysml2SourceBuffer *out);
+
+/* Bytes of piped input kept in memory before the rest is spooled to a file */
+#define SYSML2_STDIN_SPOOL_THRESHOLD ((size_t)64 << 20)
+
+/*
+ * Read an open descriptor (such as stdin) to the end as a source buffer
+ *
+ * A regular file positioned at its start is mapped directly. Anything
+ * else is read into a geometrically grown buffer that never grows past
+ * spool_threshold bytes; once it is full, it and the rest of the input
+ * are copied to an unlinked temporary file under $TMPDIR (default /tmp),
+ * which is mapped instead, so large piped models cost page cache rather
+ * than heap. The descriptor is left open.
+ *
+ * The content is charged to the memory budget until it is released.
+ *
+ * @param fd Descriptor to read
+ * @param spool_threshold Bytes to buffer before spooling (0 = never spool)
+ * @param out Output: buffer (zeroed on failure)
+ * @return true on success, false with errno set on error
+ */
+bool sysml2_source_read_fd(int fd, size_t spool_threshold, Sysml2SourceBuffer *out);
+
+/*
+ * Ask the system to start reading a file into the page cache
+ *
+ * Returns without waiting: the file is read in the background, so a
+ * later sysml2_source_open() finds its pages resident instead of
+ * stalling on each one the parser touches. Uses
+ * posix_fadvise(POSIX_FADV_WILLNEED); a no-op where that is missing or
+ * the file cannot be opened.
+ *
+ * @param path Path to file
+ */
+void sysml2_read_ahead(const char *path);
+
+/*
+ * Release a source buffer (unmap or free)
+ *
+ * Buffers whose data is still referenced (e.g. by a model's
+ * Sysml2SourceFile) are simply never released.
+ *
+ * @param buffer Buffer to release (zeroed afterwards; may be empty)
+ */
+void sysml2_source_release(Sysml2SourceBuffer *buffer);
+
 /*
  * Read from stdin into memory
  *
@@ -71,6 +143,27 @@ bool sysml2_is_file(const char *path);
  */
 bool sysml2_is_directory(const char *path);
 
+/* What a directory entry is, after following symlinks */
+typedef enum {
+    SYSML2_ENTRY_OTHER,              /* Missing, dangling or special */
+    SYSML2_ENTRY_FILE,               /* Regular file */
+    SYSML2_ENTRY_DIRECTORY,
+} Sysml2EntryKind;
+
+/*
+ * Classify an entry returned by readdir
+ *
+ * Uses d_type where the filesystem fills it in, so most entries cost no
+ * system call; symlinks and unknown types take one fstatat relative to
+ * the open directory.
+ *
+ * @param dir Directory the entry was read from
+ * @param entry Entry from readdir(dir)
+ * @param out_link Output: whether the entry is a symlink (may be NULL)
+ * @return Entry kind, as sysml2_is_file / sysml2_is_directory would see it
+ */
+Sysml2EntryKind sysml2_dir_entry_kind(DIR *dir, const struct dirent *entry, bool *out_link);
+
 /*
  * Join two path components
  *
@@ -93,7 +186,8 @@ char *sysml2_get_realpath(const char *path);
 /*
  * Build line offset table from content
  *
- * Creates an array of byte offsets for each line start.
+ * Creates an array of byte offsets for each line start. Newlines are
+ * found with memchr, which the C library vectorizes.
  *
  * @param content File content
  * @param length Content length in bytes
@@ -102,6 +196,58 @@ char *sysml2_get_realpath(const char *path);
  */
 uint32_t *sysml2_build_line_offsets(const char *content, size_t length, uint32_t *out_count);
 
+/*
+ * Find the line containing a byte offset
+ *
+ * @param offsets Line start offsets from sysml2_build_line_offsets
+ * @param count Number of lines (at least 1)
+ * @param offset Byte offset
+ * @return Zero-based line index
+ */
+uint32_t sysml2_line_index_find(const uint32_t *offsets, uint32_t count, size_t offset);
+
+/* Longest name matched with the bit-parallel edit distance */
+#define SYSML2_EDIT_PATTERN_MAX 64
+
+/*
+ * Edit Pattern - a string prepared for many bounded edit distance checks
+ *
+ * Strings of up to SYSML2_EDIT_PATTERN_MAX bytes are matched with Myers'
+ * bit-parallel algorithm, one machine word operation per byte of the
+ * other string; longer ones fall back to the row-by-row dynamic program.
+ */
+typedef struct {
+    const char *text;
+    size_t length;
+    uint64_t char_mask;          /* Bit (c & 63) set for every byte c of text */
+    uint64_t peq[256];           /* Positions of each byte (short patterns only) */
+} Sysml2EditPattern;
+
+/*
+ * Prepare a pattern
+ *
+ * @param pattern Pattern to initialize
+ * @param text String to match against (must outlive the pattern)
+ * @param length Length of text
+ */
+void sysml2_edit_pattern_init(Sysml2EditPattern *pattern, const char *text, size_t length);
+
+/*
+ * Levenshtein distance between a pattern and a string, up to a bound
+ *
+ * Strings whose lengths or byte sets differ by more than max_dist are
+ * rejected before any distance is computed, and the computation stops
+ * as soon as the distance can no longer come back under the bound.
+ *
+ * @param pattern Prepared pattern
+ * @param text Other string
+ * @param length Length of text
+ * @param max_dist Largest distance of interest
+ * @return The distance if it is at most max_dist, otherwise max_dist + 1
+ */
+size_t sysml2_edit_distance_bounded(const Sysml2EditPattern *pattern,
+                                    const char *text, size_t length, size_t max_dist);
+
 /*
  * Recursively find all files matching an extension in a directory
  *
@@ -16,6 +16,23 @@
 #include "ast.h"
 #include "diagnostic.h"
 #include "symtab.h"
+#include "stats.h"
+#include "trace.h"
+#include "query.h"
+
+/*
+ * Symbol Layer - frozen symbol table of models shared by many validations
+ *
+ * Typically built once from the standard library. A validation whose
+ * models include all of the layer's models starts from the layer and
+ * only indexes the remaining models, on an overlay (see symtab.h).
+ */
+typedef struct Sysml2SymbolLayer {
+    Sysml2SymbolTable symtab;          /* Frozen table of the models */
+    SysmlSemanticModel **models;       /* Models it was built from (arena-owned) */
+    size_t model_count;
+    bool has_duplicates;               /* Some non-package name is defined twice */
+} Sysml2SymbolLayer;
 
 /*
  * Validation Options - controls which checks are performed
@@ -32,6 +49,11 @@ typedef struct {
     bool warn_abstract_instantiation;  /* default: true */
     bool suggest_corrections;          /* "did you mean?" hints */
     size_t max_suggestions;            /* default: 3 */
+    size_t jobs;                       /* Worker threads for multi-model validation (<= 1 = serial) */
+    bool fuse_passes;                  /* Per-element passes in one sweep - default: true */
+    Sysml2Stats *stats;                /* Per-pass timings and symbol counts (NULL = off) */
+    Sysml2Trace *trace;                /* Per-pass spans (NULL = off) */
+    const Sysml2SymbolLayer *layer;    /* Prebuilt symbols of some models (NULL = none) */
 } Sysml2ValidationOptions;
 
 /* Default validation options (all checks enabled) */
@@ -46,7 +68,9 @@ typedef struct {
     .check_redefinition_compat = true, \
     .warn_abstract_instantiation = true, \
     .suggest_corrections = true, \
-    .max_suggestions = 3 \
+    .max_suggestions = 3, \
+    .jobs = 1, \
+    .fuse_passes = true \
 })
 
 /*
@@ -58,6 +82,17 @@ typedef struct {
  */
 bool sysml2_is_type_compatible(SysmlNodeKind usage_kind, SysmlNodeKind def_kind);
 
+/*
+ * Validator pass that reports a diagnostic code
+ *
+ * Validation reports pass by pass and, within a pass, model by model,
+ * so this recovers where a diagnostic falls in a run's output.
+ *
+ * @param code Diagnostic code
+ * @return Pass, SYSML2_PASS_COUNT if no pass reports the code
+ */
+Sysml2ValidatorPass sysml2_validator_diag_pass(Sysml2DiagCode code);
+
 /*
  * Run semantic validation on a parsed model
  *
@@ -72,6 +107,14 @@ bool sysml2_is_type_compatible(SysmlNodeKind usage_kind, SysmlNodeKind def_kind)
  * - E3008: Redefinition compatibility errors
  * - Abstract instantiation warnings
  *
+ * With options->fuse_passes, the per-element checks (E3001, E3002,
+ * E3006, E3007, E3008 and abstract instantiation) run in one sweep over
+ * the elements, each element's references resolved once; the cycle
+ * check then runs over the resolved type graph. Diagnostics are the
+ * same, in the same order, as with separate passes. Per-pass timings
+ * (options->stats) and spans (options->trace) need separate passes, so
+ * with either set the passes are not fused.
+ *
  * @param model Parsed semantic model
  * @param diag_ctx Diagnostic context for error reporting
  * @param source_file Source file for error locations (may be NULL)
@@ -95,6 +138,11 @@ Sysml2Result sysml2_validate(
  * This builds a single symbol table from all models before
  * performing type resolution, enabling cross-file imports.
  *
+ * With options->jobs > 1, the per-element passes run concurrently over
+ * chunks of each model against the read-only symbol table. Diagnostics
+ * are reported in the same order as a serial run. Passes are fused per
+ * model, or per chunk, as in sysml2_validate().
+ *
  * @param models Array of parsed semantic models
  * @param model_count Number of models
  * @param diag_ctx Diagnostic context for error reporting
@@ -112,4 +160,85 @@ Sysml2Result sysml2_validate_multi(
     const Sysml2ValidationOptions *options
 );
 
+/*
+ * Run unified semantic validation, reporting on a subset of models
+ *
+ * Every model contributes to the symbol table, but only models with
+ * check[i] set are validated: diagnostics about the others (including
+ * duplicate definitions) are not reported. Used to re-check the files
+ * affected by an edit without re-reporting the rest of a workspace.
+ *
+ * @param models Array of parsed semantic models
+ * @param model_count Number of models
+ * @param check Per model: validate it (NULL validates all models)
+ * @param diag_ctx Diagnostic context for error reporting
+ * @param arena Memory arena
+ * @param intern String interning table
+ * @param options Validation options (NULL for defaults)
+ * @return SYSML2_OK if the checked models are valid,
+ *         SYSML2_ERROR_SEMANTIC if errors found
+ */
+Sysml2Result sysml2_validate_subset(
+    SysmlSemanticModel **models,
+    size_t model_count,
+    const bool *check,
+    Sysml2DiagContext *diag_ctx,
+    Sysml2Arena *arena,
+    Sysml2Intern *intern,
+    const Sysml2ValidationOptions *options
+);
+
+/*
+ * Build a symbol layer for models that many validations share
+ *
+ * Indexes the models as pass 1 of sysml2_validate_multi would, reporting
+ * nothing, and freezes the table. Models are indexed ahead of the
+ * models a validation adds on top, so on a name clash between the two
+ * the layer's definition is kept and the duplicate is reported in the
+ * other model.
+ *
+ * A validation uses the layer (options->layer) only if all of the
+ * layer's models are among its models, and, when the layer holds
+ * duplicates, none of its models is checked for them. Otherwise it
+ * builds its symbol table from scratch, as without a layer.
+ *
+ * @param layer Layer to build
+ * @param models Models to index (layer keeps its own copy of the array)
+ * @param model_count Number of models
+ * @param arena Arena for the layer (must outlive every use of it)
+ * @param intern String interning table (the one validations will use)
+ * @return SYSML2_OK, or SYSML2_ERROR_OUT_OF_MEMORY
+ */
+Sysml2Result sysml2_validator_build_layer(
+    Sysml2SymbolLayer *layer,
+    SysmlSemanticModel **models,
+    size_t model_count,
+    Sysml2Arena *arena,
+    Sysml2Intern *intern
+);
+
+/*
+ * Build the reverse-reference index over multiple models
+ *
+ * Builds the same symbol table as sysml2_validate_multi, then records
+ * for every typing, specialization, redefinition and reference that
+ * resolves, and for every relationship whose endpoints resolve, the
+ * element that uses the target. Unresolved references are skipped;
+ * nothing is reported.
+ *
+ * @param models Array of parsed semantic models
+ * @param model_count Number of models
+ * @param arena Memory arena (symbol table and index storage)
+ * @param intern String interning table
+ * @param index Index to add to (zeroed for a new index)
+ * @return SYSML2_OK, or SYSML2_ERROR_OUT_OF_MEMORY if the index is incomplete
+ */
+Sysml2Result sysml2_validator_index_references(
+    SysmlSemanticModel **models,
+    size_t model_count,
+    Sysml2Arena *arena,
+    Sysml2Intern *intern,
+    Sysml2RefIndex *index
+);
+
 #endif /* SYSML2_VALIDATOR_H */
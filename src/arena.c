@@ -4,22 +4,166 @@
  * SPDX-License-Identifier: MIT
  */
 
+/* Define the allocation functions themselves, not the call-site wrappers */
+#define SYSML2_ARENA_IMPLEMENTATION
 #include "sysml2/arena.h"
+#include "sysml2/memory_budget.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
 #include <stdio.h>
 
-/* Create a new arena block */
+#ifdef SYSML2_ARENA_STATS
+#include <pthread.h>
+
+/* Size classes: <= 16 bytes, then one per power of two, then the rest */
+#define STATS_SIZE_CLASSES 18
+#define STATS_MAX_SITES 1024
+
+typedef struct {
+    const char *file;
+    int line;
+    size_t count;
+    size_t bytes;
+} StatsSite;
+
+typedef struct {
+    size_t count;
+    size_t bytes;
+} StatsClass;
+
+static pthread_mutex_t stats_lock = PTHREAD_MUTEX_INITIALIZER;
+static StatsClass stats_classes[STATS_SIZE_CLASSES];
+static StatsSite stats_sites[STATS_MAX_SITES];
+static StatsSite stats_overflow = { "(other sites)", 0, 0, 0 };
+
+static _Thread_local const char *current_file;
+static _Thread_local int current_line;
+
+void sysml2_arena_stats_site(const char *file, int line) {
+    current_file = file;
+    current_line = line;
+}
+
+static size_t size_class(size_t size) {
+    size_t cls = 0;
+    size_t limit = 16;
+    while (size > limit && cls + 1 < STATS_SIZE_CLASSES) {
+        limit *= 2;
+        cls++;
+    }
+    return cls;
+}
+
+/* Count one allocation against the pending call site */
+static void stats_record(size_t size) {
+    const char *file = current_file ? current_file : "(unknown)";
+    int line = current_file ? current_line : 0;
+    current_file = NULL;
+
+    pthread_mutex_lock(&stats_lock);
+    StatsClass *cls = &stats_classes[size_class(size)];
+    cls->count++;
+    cls->bytes += size;
+
+    /* Open addressing on (file, line); file names are string literals */
+    size_t hash = ((uintptr_t)file >> 3) * 31 + (size_t)line;
+    StatsSite *site = &stats_overflow;
+    for (size_t probe = 0; probe < STATS_MAX_SITES; probe++) {
+        StatsSite *slot = &stats_sites[(hash + probe) % STATS_MAX_SITES];
+        if (!slot->file) {
+            slot->file = file;
+            slot->line = line;
+        }
+        if (slot->file == file && slot->line == line) {
+            site = slot;
+            break;
+        }
+    }
+    site->count++;
+    site->bytes += size;
+    pthread_mutex_unlock(&stats_lock);
+}
+
+static int compare_sites(const void *a, const void *b) {
+    const StatsSite *x = a;
+    const StatsSite *y = b;
+    if (x->bytes != y->bytes) return x->bytes < y->bytes ? 1 : -1;
+    return 0;
+}
+
+/* Trim a build path to its last two components */
+static const char *short_path(const char *path) {
+    const char *last = strrchr(path, '/');
+    if (!last) return path;
+    const char *p = last;
+    while (p > path && p[-1] != '/') p--;
+    return p;
+}
+
+void sysml2_arena_stats_print(FILE *out) {
+    pthread_mutex_lock(&stats_lock);
+
+    fprintf(out, "arena allocations by size class:\n");
+    fprintf(out, "  %-12s %12s %14s\n", "size", "count", "bytes");
+    size_t limit = 16;
+    for (size_t i = 0; i < STATS_SIZE_CLASSES; i++, limit *= 2) {
+        const StatsClass *cls = &stats_classes[i];
+        if (cls->count == 0) continue;
+        char label[32];
+        if (i + 1 < STATS_SIZE_CLASSES) {
+            snprintf(label, sizeof(label), "<= %zu", limit);
+        } else {
+            snprintf(label, sizeof(label), "> %zu", limit / 2);
+        }
+        fprintf(out, "  %-12s %12zu %14zu\n", label, cls->count, cls->bytes);
+    }
+
+    StatsSite sorted[STATS_MAX_SITES + 1];
+    size_t count = 0;
+    for (size_t i = 0; i < STATS_MAX_SITES; i++) {
+        if (stats_sites[i].file) sorted[count++] = stats_sites[i];
+    }
+    if (stats_overflow.count > 0) sorted[count++] = stats_overflow;
+    qsort(sorted, count, sizeof(StatsSite), compare_sites);
+
+    fprintf(out, "arena allocations by call site:\n");
+    fprintf(out, "  %-40s %12s %14s\n", "site", "count", "bytes");
+    for (size_t i = 0; i < count; i++) {
+        char label[256];
+        snprintf(label, sizeof(label), "%s:%d", short_path(sorted[i].file), sorted[i].line);
+        fprintf(out, "  %-40s %12zu %14zu\n", label, sorted[i].count, sorted[i].bytes);
+    }
+
+    pthread_mutex_unlock(&stats_lock);
+}
+
+void sysml2_arena_stats_reset(void) {
+    pthread_mutex_lock(&stats_lock);
+    memset(stats_classes, 0, sizeof(stats_classes));
+    memset(stats_sites, 0, sizeof(stats_sites));
+    stats_overflow.count = 0;
+    stats_overflow.bytes = 0;
+    pthread_mutex_unlock(&stats_lock);
+}
+#endif /* SYSML2_ARENA_STATS */
+
+/* Create a new arena block, charged to the memory budget */
 static Sysml2ArenaBlock *arena_new_block(size_t size) {
     Sysml2ArenaBlock *block = malloc(sizeof(Sysml2ArenaBlock) + size);
     if (!block) return NULL;
+    sysml2_memory_charge(sizeof(Sysml2ArenaBlock) + size);
     block->next = NULL;
     block->size = size;
     block->used = 0;
     return block;
 }
 
+static void arena_free_block(Sysml2ArenaBlock *block) {
+    sysml2_memory_release(sizeof(Sysml2ArenaBlock) + block->size);
+    free(block);
+}
+
 void sysml2_arena_init(Sysml2Arena *arena) {
     sysml2_arena_init_with_size(arena, SYSML2_ARENA_DEFAULT_BLOCK_SIZE);
 }
@@ -35,7 +179,7 @@ void sysml2_arena_destroy(Sysml2Arena *arena) {
     Sysml2ArenaBlock *block = arena->blocks;
     while (block) {
         Sysml2ArenaBlock *next = block->next;
-        free(block);
+        arena_free_block(block);
         block = next;
     }
     arena->head = NULL;
@@ -50,7 +194,7 @@ void sysml2_arena_reset(Sysml2Arena *arena) {
         Sysml2ArenaBlock *block = first->next;
         while (block) {
             Sysml2ArenaBlock *next = block->next;
-            free(block);
+            arena_free_block(block);
             block = next;
         }
         first->next = NULL;
@@ -64,6 +208,10 @@ void *sysml2_arena_alloc_aligned(Sysml2Arena *arena, size_t size, size_t alignme
     /* Ensure alignment is a power of 2 */
     assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
 
+#ifdef SYSML2_ARENA_STATS
+    stats_record(size);
+#endif
+
     /* Try to allocate from current block */
     if (arena->head) {
         size_t aligned_used = SYSML2_ALIGN_UP(arena->head->used, alignment);
@@ -157,3 +305,43 @@ char *sysml2_arena_sprintf(Sysml2Arena *arena, const char *fmt, ...) {
 size_t sysml2_arena_used(const Sysml2Arena *arena) {
     return arena->total_allocated;
 }
+
+Sysml2ArenaMark sysml2_arena_mark(const Sysml2Arena *arena) {
+    Sysml2ArenaMark mark = {
+        .block = arena->head,
+        .used = arena->head ? arena->head->used : 0,
+        .total_allocated = arena->total_allocated,
+    };
+    return mark;
+}
+
+void sysml2_arena_rewind(Sysml2Arena *arena, Sysml2ArenaMark mark) {
+    /* Blocks are linked newest first, so the ones to free precede the mark */
+    Sysml2ArenaBlock *block = arena->blocks;
+    while (block && block != mark.block) {
+        Sysml2ArenaBlock *next = block->next;
+        arena_free_block(block);
+        block = next;
+    }
+    arena->blocks = block;
+    arena->head = block;
+    if (block) block->used = mark.used;
+    arena->total_allocated = mark.total_allocated;
+}
+
+/* Is ptr within [start, start + length) */
+static bool in_range(const void *ptr, const char *start, size_t length) {
+    uintptr_t p = (uintptr_t)ptr;
+    uintptr_t s = (uintptr_t)start;
+    return p >= s && p - s < length;
+}
+
+bool sysml2_arena_allocated_since(const Sysml2Arena *arena, Sysml2ArenaMark mark, const void *ptr) {
+    for (const Sysml2ArenaBlock *block = arena->blocks; block; block = block->next) {
+        if (block == mark.block) {
+            return in_range(ptr, block->data + mark.used, block->size - mark.used);
+        }
+        if (in_range(ptr, block->data, block->size)) return true;
+    }
+    return false;
+}
@@ -6,6 +6,102 @@
 
 #include "sysml2/ast.h"
 
+#include "sysml2/intern.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+const SysmlNodeCold sysml2_node_cold_empty;
+
+SysmlNodeCold *sysml2_node_cold_mut(Sysml2Arena *arena, SysmlNode *node) {
+    if (!node->cold) {
+        node->cold = sysml2_arena_calloc(arena, 1, sizeof(SysmlNodeCold));
+    }
+    return node->cold;
+}
+
+SysmlNodeCold *sysml2_node_cold_detach(Sysml2Arena *arena, SysmlNode *node) {
+    SysmlNodeCold *copy = sysml2_arena_calloc(arena, 1, sizeof(SysmlNodeCold));
+    if (copy && node->cold) memcpy(copy, node->cold, sizeof(SysmlNodeCold));
+    node->cold = copy;
+    return copy;
+}
+
+void sysml2_node_derive_path(SysmlNode *node) {
+    node->parent = NULL;
+    node->depth = 0;
+    node->name_offset = 0;
+    node->has_path = node->id != NULL;
+    if (!node->parent_id || !node->id) return;
+
+    /* IDs are parent_id "::" local; count the parent's segments */
+    size_t parent_len = strlen(node->parent_id);
+    uint32_t depth = 1;
+    for (size_t i = 0; i + 1 < parent_len; i++) {
+        if (node->parent_id[i] == ':' && node->parent_id[i + 1] == ':') {
+            depth++;
+            i++;
+        }
+    }
+    node->depth = depth;
+
+    if (strncmp(node->id, node->parent_id, parent_len) == 0 &&
+        node->id[parent_len] == ':' && node->id[parent_len + 1] == ':') {
+        node->name_offset = (uint32_t)(parent_len + 2);
+        return;
+    }
+
+    /* An ID outside its parent's path: fall back to its last "::" */
+    for (size_t i = 0; node->id[i] && node->id[i + 1]; i++) {
+        if (node->id[i] == ':' && node->id[i + 1] == ':') node->name_offset = (uint32_t)(i + 2);
+    }
+}
+
+bool sysml2_model_link_paths(SysmlSemanticModel *model) {
+    if (!model) return true;
+    for (size_t i = 0; i < model->element_count; i++) {
+        if (model->elements[i]) sysml2_node_derive_path(model->elements[i]);
+    }
+
+    /* Open-addressed index of the elements by (interned) ID address */
+    size_t capacity = 16;
+    while (capacity < model->element_count * 2) capacity *= 2;
+    SysmlNode **slots = calloc(capacity, sizeof(SysmlNode *));
+    if (!slots) return false;
+
+    size_t mask = capacity - 1;
+    for (size_t i = 0; i < model->element_count; i++) {
+        SysmlNode *node = model->elements[i];
+        if (!node || !node->id) continue;
+        size_t idx = sysml2_id_hash(node->id) & mask;
+        while (slots[idx] && slots[idx]->id != node->id) idx = (idx + 1) & mask;
+        if (!slots[idx]) slots[idx] = node;
+    }
+    for (size_t i = 0; i < model->element_count; i++) {
+        SysmlNode *node = model->elements[i];
+        if (!node || !node->parent_id) continue;
+        size_t idx = sysml2_id_hash(node->parent_id) & mask;
+        while (slots[idx] && slots[idx]->id != node->parent_id) idx = (idx + 1) & mask;
+        if (slots[idx] && slots[idx] != node) node->parent = slots[idx];
+    }
+    free(slots);
+
+    /* Depths follow the links, as the builder counts them (the walk is
+     * bounded in case IDs form a cycle) */
+    for (size_t i = 0; i < model->element_count; i++) {
+        SysmlNode *node = model->elements[i];
+        if (!node || !node->parent) continue;
+        const SysmlNode *top = node;
+        uint32_t steps = 0;
+        while (top->parent && steps <= model->element_count) {
+            top = top->parent;
+            steps++;
+        }
+        node->depth = top->depth + steps;
+    }
+    return true;
+}
+
 /*
  * Mapping of node kinds to JSON type strings.
  *
@@ -24,10 +24,12 @@ SysmlBuildContext *sysml2_build_context_create(
     ctx->arena = arena;
     ctx->intern = intern;
     ctx->source_name = sysml2_intern(intern, source_name);
+    ctx->capture = SYSML_CAPTURE_ALL;
 
     /* Initialize scope stack */
     ctx->scope_capacity = SYSML_BUILD_DEFAULT_SCOPE_CAPACITY;
     ctx->scope_stack = SYSML2_ARENA_NEW_ARRAY(arena, const char *, ctx->scope_capacity);
+    ctx->scope_nodes = SYSML2_ARENA_NEW_ARRAY(arena, SysmlNode *, ctx->scope_capacity);
     ctx->scope_depth = 0;
 
     /* Initialize counters */
@@ -161,12 +163,25 @@ void sysml2_build_push_scope(SysmlBuildContext *ctx, const char *scope_id) {
     if (ctx->scope_depth >= ctx->scope_capacity) {
         size_t new_capacity = ctx->scope_capacity * 2;
         const char **new_stack = SYSML2_ARENA_NEW_ARRAY(ctx->arena, const char *, new_capacity);
-        if (!new_stack) return;
+        SysmlNode **new_nodes = SYSML2_ARENA_NEW_ARRAY(ctx->arena, SysmlNode *, new_capacity);
+        if (!new_stack || !new_nodes) return;
         memcpy(new_stack, ctx->scope_stack, ctx->scope_depth * sizeof(const char *));
+        memcpy(new_nodes, ctx->scope_nodes, ctx->scope_depth * sizeof(SysmlNode *));
         ctx->scope_stack = new_stack;
+        ctx->scope_nodes = new_nodes;
         ctx->scope_capacity = new_capacity;
     }
 
+    /* The scope's element is almost always the one just added */
+    SysmlNode *scope_node = NULL;
+    for (size_t i = ctx->element_count; i > 0; i--) {
+        if (ctx->elements[i - 1]->id == scope_id) {
+            scope_node = ctx->elements[i - 1];
+            break;
+        }
+    }
+
+    ctx->scope_nodes[ctx->scope_depth] = scope_node;
     ctx->scope_stack[ctx->scope_depth++] = scope_id;
 }
 
@@ -186,6 +201,14 @@ const char *sysml2_build_current_scope(SysmlBuildContext *ctx) {
     return ctx->scope_stack[ctx->scope_depth - 1];
 }
 
+/*
+ * Get the element of the current scope
+ */
+SysmlNode *sysml2_build_current_scope_node(SysmlBuildContext *ctx) {
+    if (!ctx || ctx->scope_depth == 0) return NULL;
+    return ctx->scope_nodes[ctx->scope_depth - 1];
+}
+
 /*
  * Generate a path-based ID for an element
  */
@@ -264,6 +287,15 @@ SysmlNode *sysml2_build_node(
     node->name = interned_name;
     node->kind = kind;
     node->parent_id = sysml2_build_current_scope(ctx);
+    node->parent = sysml2_build_current_scope_node(ctx);
+    if (node->parent && node->id) {
+        node->has_path = true;
+        node->depth = node->parent->depth + 1;
+        node->name_offset = (uint32_t)(node->parent->name_offset +
+            strlen(sysml2_node_local_id(node->parent)) + 2);
+    } else {
+        sysml2_node_derive_path(node);
+    }
     node->typed_by = NULL;
     node->typed_by_count = 0;
     node->specializes = NULL;
@@ -279,8 +311,18 @@ SysmlNode *sysml2_build_node(
     ctx->pending_multiplicity_lower = NULL;
     ctx->pending_multiplicity_upper = NULL;
 
+    /* Pending cold data: the record is only allocated when there is some */
+    if (ctx->pending_default_value || ctx->pending_ref_behavioral_keyword ||
+        ctx->pending_portion_kind || ctx->pending_param_list) {
+        SysmlNodeCold *cold = sysml2_node_cold_mut(ctx->arena, node);
+        if (!cold) return NULL;
+        cold->default_value = ctx->pending_default_value;
+        cold->ref_behavioral_keyword = ctx->pending_ref_behavioral_keyword;
+        cold->portion_kind = ctx->pending_portion_kind;
+        cold->parameter_list = ctx->pending_param_list;
+    }
+
     /* Apply pending default value */
-    node->default_value = ctx->pending_default_value;
     node->has_default_keyword = ctx->pending_has_default_keyword;
     ctx->pending_default_value = NULL;
     ctx->pending_has_default_keyword = false;
@@ -295,8 +337,6 @@ SysmlNode *sysml2_build_node(
     node->is_parallel = ctx->pending_parallel;
     node->has_enum_keyword = ctx->pending_has_enum_keyword;
     node->is_event_occurrence = ctx->pending_event_occurrence;
-    node->ref_behavioral_keyword = ctx->pending_ref_behavioral_keyword;
-    node->portion_kind = ctx->pending_portion_kind;
     node->is_asserted = ctx->pending_is_asserted;
     node->is_negated = ctx->pending_is_negated;
     node->has_connect_keyword = ctx->pending_has_connect_keyword;
@@ -323,52 +363,35 @@ SysmlNode *sysml2_build_node(
     node->visibility = ctx->pending_visibility;
     ctx->pending_visibility = SYSML_VIS_PUBLIC;
 
-    /* Apply pending parameter list */
-    node->parameter_list = ctx->pending_param_list;
     ctx->pending_param_list = NULL;
 
     node->loc = SYSML2_LOC_INVALID;
-    node->documentation = NULL;
-    node->doc_loc = SYSML2_LOC_INVALID;
-    node->metadata = NULL;
-    node->metadata_count = 0;
-    node->prefix_metadata = NULL;
-    node->prefix_metadata_count = 0;
-    node->prefix_applied_metadata = NULL;
-    node->prefix_applied_metadata_count = 0;
-    node->leading_trivia = NULL;
-    node->trailing_trivia = NULL;
-
-    /* Initialize body statement arrays */
-    node->body_stmts = NULL;
-    node->body_stmt_count = 0;
-    node->comments = NULL;
-    node->comment_count = 0;
-    node->textual_reps = NULL;
-    node->textual_rep_count = 0;
-    node->result_expression = NULL;
 
     /* Attach any pending trivia as leading trivia */
     sysml2_build_attach_pending_trivia(ctx, node);
 
     /* Attach any pending prefix metadata */
     if (ctx->pending_prefix_metadata_count > 0) {
-        node->prefix_metadata = SYSML2_ARENA_NEW_ARRAY(ctx->arena, const char *, ctx->pending_prefix_metadata_count);
-        if (node->prefix_metadata) {
-            memcpy(node->prefix_metadata, ctx->pending_prefix_metadata,
+        SysmlNodeCold *cold = sysml2_node_cold_mut(ctx->arena, node);
+        if (!cold) return NULL;
+        cold->prefix_metadata = SYSML2_ARENA_NEW_ARRAY(ctx->arena, const char *, ctx->pending_prefix_metadata_count);
+        if (cold->prefix_metadata) {
+            memcpy(cold->prefix_metadata, ctx->pending_prefix_metadata,
                    ctx->pending_prefix_metadata_count * sizeof(const char *));
-            node->prefix_metadata_count = ctx->pending_prefix_metadata_count;
+            cold->prefix_metadata_count = ctx->pending_prefix_metadata_count;
         }
         ctx->pending_prefix_metadata_count = 0;
     }
 
     /* Attach any pending applied metadata (@Type {...}) - goes in prefix position */
     if (ctx->pending_metadata_count > 0) {
-        node->prefix_applied_metadata = SYSML2_ARENA_NEW_ARRAY(ctx->arena, SysmlMetadataUsage *, ctx->pending_metadata_count);
-        if (node->prefix_applied_metadata) {
-            memcpy(node->prefix_applied_metadata, ctx->pending_metadata,
+        SysmlNodeCold *cold = sysml2_node_cold_mut(ctx->arena, node);
+        if (!cold) return NULL;
+        cold->prefix_applied_metadata = SYSML2_ARENA_NEW_ARRAY(ctx->arena, SysmlMetadataUsage *, ctx->pending_metadata_count);
+        if (cold->prefix_applied_metadata) {
+            memcpy(cold->prefix_applied_metadata, ctx->pending_metadata,
                    ctx->pending_metadata_count * sizeof(SysmlMetadataUsage *));
-            node->prefix_applied_metadata_count = ctx->pending_metadata_count;
+            cold->prefix_applied_metadata_count = ctx->pending_metadata_count;
         }
         ctx->pending_metadata_count = 0;
     }
@@ -800,7 +823,9 @@ void sysml2_build_attach_pending_trivia(SysmlBuildContext *ctx, SysmlNode *node)
     }
 
     /* Now attach the deduplicated trivia */
-    node->leading_trivia = ctx->pending_trivia_head;
+    SysmlNodeCold *cold = sysml2_node_cold_mut(ctx->arena, node);
+    if (!cold) return;
+    cold->leading_trivia = ctx->pending_trivia_head;
     ctx->pending_trivia_head = NULL;
     ctx->pending_trivia_tail = NULL;
 }
@@ -835,8 +860,9 @@ void sysml2_build_attach_pending_trailing_trivia(SysmlBuildContext *ctx, SysmlNo
     SysmlTrivia *first = ctx->pending_trivia_head;
     bool has_blank_line = (first->kind == SYSML_TRIVIA_BLANK_LINE);
     /* Check if node has any body content indicating a braced body */
-    bool has_body_content = (node->body_stmt_count > 0 || node->comment_count > 0 ||
-                             node->textual_rep_count > 0 || node->documentation != NULL ||
+    const SysmlNodeCold *body = sysml2_node_cold(node);
+    bool has_body_content = (body->body_stmt_count > 0 || body->comment_count > 0 ||
+                             body->textual_rep_count > 0 || body->documentation != NULL ||
                              has_child_elements(ctx, node));
 
     if (has_blank_line) {
@@ -852,11 +878,12 @@ void sysml2_build_attach_pending_trailing_trivia(SysmlBuildContext *ctx, SysmlNo
                 }
             }
 
-            if (last_content) {
+            SysmlNodeCold *cold = last_content ? sysml2_node_cold_mut(ctx->arena, node) : NULL;
+            if (cold) {
                 /* Stop the list after the last content item */
                 SysmlTrivia *after_content = last_content->next;
                 last_content->next = NULL;
-                node->trailing_trivia = first;
+                cold->trailing_trivia = first;
                 ctx->pending_trivia_head = after_content;
                 if (!after_content) {
                     ctx->pending_trivia_tail = NULL;
@@ -869,7 +896,9 @@ void sysml2_build_attach_pending_trailing_trivia(SysmlBuildContext *ctx, SysmlNo
     }
 
     /* No blank line - this is same-line trailing trivia, attach to this node */
-    node->trailing_trivia = ctx->pending_trivia_head;
+    SysmlNodeCold *cold = sysml2_node_cold_mut(ctx->arena, node);
+    if (!cold) return;
+    cold->trailing_trivia = ctx->pending_trivia_head;
     ctx->pending_trivia_head = NULL;
     ctx->pending_trivia_tail = NULL;
 }
@@ -969,20 +998,23 @@ void sysml2_build_add_metadata(
 ) {
     if (!ctx || !node || !meta) return;
 
+    SysmlNodeCold *cold = sysml2_node_cold_mut(ctx->arena, node);
+    if (!cold) return;
+
     /* Grow metadata array */
-    size_t new_count = node->metadata_count + 1;
+    size_t new_count = cold->metadata_count + 1;
     SysmlMetadataUsage **new_metadata = SYSML2_ARENA_NEW_ARRAY(ctx->arena, SysmlMetadataUsage *, new_count);
     if (!new_metadata) return;
 
     /* Copy existing metadata */
-    if (node->metadata && node->metadata_count > 0) {
-        memcpy(new_metadata, node->metadata, node->metadata_count * sizeof(SysmlMetadataUsage *));
+    if (cold->metadata && cold->metadata_count > 0) {
+        memcpy(new_metadata, cold->metadata, cold->metadata_count * sizeof(SysmlMetadataUsage *));
     }
 
     /* Add new metadata */
-    new_metadata[node->metadata_count] = meta;
-    node->metadata = new_metadata;
-    node->metadata_count = new_count;
+    new_metadata[cold->metadata_count] = meta;
+    cold->metadata = new_metadata;
+    cold->metadata_count = new_count;
 }
 
 /*
@@ -998,20 +1030,23 @@ void sysml2_build_add_prefix_metadata(
     /* Intern the metadata reference */
     const char *interned_ref = sysml2_intern(ctx->intern, metadata_ref);
 
+    SysmlNodeCold *cold = sysml2_node_cold_mut(ctx->arena, node);
+    if (!cold) return;
+
     /* Grow prefix_metadata array */
-    size_t new_count = node->prefix_metadata_count + 1;
+    size_t new_count = cold->prefix_metadata_count + 1;
     const char **new_prefix_metadata = SYSML2_ARENA_NEW_ARRAY(ctx->arena, const char *, new_count);
     if (!new_prefix_metadata) return;
 
     /* Copy existing prefix metadata */
-    if (node->prefix_metadata && node->prefix_metadata_count > 0) {
-        memcpy(new_prefix_metadata, node->prefix_metadata, node->prefix_metadata_count * sizeof(const char *));
+    if (cold->prefix_metadata && cold->prefix_metadata_count > 0) {
+        memcpy(new_prefix_metadata, cold->prefix_metadata, cold->prefix_metadata_count * sizeof(const char *));
     }
 
     /* Add new prefix metadata */
-    new_prefix_metadata[node->prefix_metadata_count] = interned_ref;
-    node->prefix_metadata = new_prefix_metadata;
-    node->prefix_metadata_count = new_count;
+    new_prefix_metadata[cold->prefix_metadata_count] = interned_ref;
+    cold->prefix_metadata = new_prefix_metadata;
+    cold->prefix_metadata_count = new_count;
 }
 
 /*
@@ -1113,32 +1148,28 @@ void sysml2_build_current_metadata_add_feature(
 /* Forward declaration - defined in sysml_parser.c via grammar */
 struct Sysml2ParserContext;
 
+/* Leading fields of SysmlParserContext (grammar/sysml.peg); keep in sync */
+typedef struct {
+    const char *filename;
+    const char *input;
+    size_t input_len;
+    size_t input_pos;
+    int error_count;
+    size_t furthest_pos;
+    const char *failed_rules[16];
+    int failed_rule_count;
+    const char *context_rule;
+    const char *last_keyword;
+    size_t last_keyword_pos;
+    SysmlBuildContext *build_ctx;
+} ParserCtx;
+
 void sysml2_capture_line_comment(struct Sysml2ParserContext *pctx, size_t start_offset, size_t end_offset) {
     if (!pctx) return;
 
-    /* The parser context struct layout - access input and build_ctx */
-    typedef struct {
-        const char *filename;
-        const char *input;
-        size_t input_len;
-        size_t input_pos;
-        int error_count;
-        int line;
-        int col;
-        size_t furthest_pos;
-        int furthest_line;
-        int furthest_col;
-        const char *failed_rules[16];
-        int failed_rule_count;
-        const char *context_rule;
-        const char *last_keyword;
-        size_t last_keyword_pos;
-        SysmlBuildContext *build_ctx;
-    } ParserCtx;
-
     ParserCtx *ctx = (ParserCtx *)pctx;
     SysmlBuildContext *build_ctx = ctx->build_ctx;
-    if (!build_ctx) return;
+    if (!build_ctx || !build_ctx->capture.trivia) return;
 
     /* Prevent duplicate capture from PEG backtracking.
      * If we already captured a comment at this offset, skip. */
@@ -1177,28 +1208,9 @@ void sysml2_capture_line_comment(struct Sysml2ParserContext *pctx, size_t start_
 void sysml2_capture_block_comment(struct Sysml2ParserContext *pctx, size_t start_offset, size_t end_offset) {
     if (!pctx) return;
 
-    typedef struct {
-        const char *filename;
-        const char *input;
-        size_t input_len;
-        size_t input_pos;
-        int error_count;
-        int line;
-        int col;
-        size_t furthest_pos;
-        int furthest_line;
-        int furthest_col;
-        const char *failed_rules[16];
-        int failed_rule_count;
-        const char *context_rule;
-        const char *last_keyword;
-        size_t last_keyword_pos;
-        SysmlBuildContext *build_ctx;
-    } ParserCtx;
-
     ParserCtx *ctx = (ParserCtx *)pctx;
     SysmlBuildContext *build_ctx = ctx->build_ctx;
-    if (!build_ctx) return;
+    if (!build_ctx || !build_ctx->capture.trivia) return;
 
     /* Convert offsets to pointers */
     const char *start = ctx->input + start_offset;
@@ -1224,28 +1236,9 @@ void sysml2_capture_block_comment(struct Sysml2ParserContext *pctx, size_t start
 void sysml2_capture_regular_block_comment(struct Sysml2ParserContext *pctx, size_t start_offset, size_t end_offset) {
     if (!pctx) return;
 
-    typedef struct {
-        const char *filename;
-        const char *input;
-        size_t input_len;
-        size_t input_pos;
-        int error_count;
-        int line;
-        int col;
-        size_t furthest_pos;
-        int furthest_line;
-        int furthest_col;
-        const char *failed_rules[16];
-        int failed_rule_count;
-        const char *context_rule;
-        const char *last_keyword;
-        size_t last_keyword_pos;
-        SysmlBuildContext *build_ctx;
-    } ParserCtx;
-
     ParserCtx *ctx = (ParserCtx *)pctx;
     SysmlBuildContext *build_ctx = ctx->build_ctx;
-    if (!build_ctx) return;
+    if (!build_ctx || !build_ctx->capture.trivia) return;
 
     /* Convert offsets to pointers */
     const char *start = ctx->input + start_offset;
@@ -1271,28 +1264,9 @@ void sysml2_capture_regular_block_comment(struct Sysml2ParserContext *pctx, size
 void sysml2_capture_blank_lines(struct Sysml2ParserContext *pctx, size_t start_offset, size_t end_offset) {
     if (!pctx) return;
 
-    typedef struct {
-        const char *filename;
-        const char *input;
-        size_t input_len;
-        size_t input_pos;
-        int error_count;
-        int line;
-        int col;
-        size_t furthest_pos;
-        int furthest_line;
-        int furthest_col;
-        const char *failed_rules[16];
-        int failed_rule_count;
-        const char *context_rule;
-        const char *last_keyword;
-        size_t last_keyword_pos;
-        SysmlBuildContext *build_ctx;
-    } ParserCtx;
-
     ParserCtx *ctx = (ParserCtx *)pctx;
     SysmlBuildContext *build_ctx = ctx->build_ctx;
-    if (!build_ctx) return;
+    if (!build_ctx || !build_ctx->capture.trivia) return;
 
     /* Count the number of newlines (handle \r\n as single newline) */
     const char *start = ctx->input + start_offset;
@@ -1326,28 +1300,9 @@ void sysml2_capture_blank_lines(struct Sysml2ParserContext *pctx, size_t start_o
 void sysml2_capture_documentation(struct Sysml2ParserContext *pctx, size_t start_offset, size_t end_offset) {
     if (!pctx) return;
 
-    typedef struct {
-        const char *filename;
-        const char *input;
-        size_t input_len;
-        size_t input_pos;
-        int error_count;
-        int line;
-        int col;
-        size_t furthest_pos;
-        int furthest_line;
-        int furthest_col;
-        const char *failed_rules[16];
-        int failed_rule_count;
-        const char *context_rule;
-        const char *last_keyword;
-        size_t last_keyword_pos;
-        SysmlBuildContext *build_ctx;
-    } ParserCtx;
-
     ParserCtx *ctx = (ParserCtx *)pctx;
     SysmlBuildContext *build_ctx = ctx->build_ctx;
-    if (!build_ctx) return;
+    if (!build_ctx || !build_ctx->capture.documentation) return;
 
     /* Skip documentation attachment when inside a raw body (objective, require/assume constraint).
      * The documentation is already embedded in the raw_text of the containing statement. */
@@ -1380,11 +1335,13 @@ void sysml2_capture_documentation(struct Sysml2ParserContext *pctx, size_t start
         for (size_t i = build_ctx->element_count; i > 0; i--) {
             SysmlNode *node = build_ctx->elements[i - 1];
             if (node->id == current_scope) {
-                node->documentation = interned_text;
+                SysmlNodeCold *cold = sysml2_node_cold_mut(build_ctx->arena, node);
+                if (!cold) break;
+                cold->documentation = interned_text;
                 /* Capture source location for ordering */
-                node->doc_loc.offset = (uint32_t)start_offset;
-                node->doc_loc.line = 0;  /* Not tracked */
-                node->doc_loc.column = 0;
+                cold->doc_loc.offset = (uint32_t)start_offset;
+                cold->doc_loc.line = 0;  /* Not tracked */
+                cold->doc_loc.column = 0;
                 break;
             }
         }
@@ -1734,6 +1691,14 @@ static const char *trim_and_intern(SysmlBuildContext *ctx, const char *text, siz
     return sysml2_intern_n(ctx->intern, text, len);
 }
 
+/*
+ * Helper: Set a node's connector part (connect/allocate/flow/succession text)
+ */
+static void set_connector_part(SysmlBuildContext *ctx, SysmlNode *node, const char *text) {
+    SysmlNodeCold *cold = sysml2_node_cold_mut(ctx->arena, node);
+    if (cold) cold->connector_part = text;
+}
+
 /*
  * Helper: Ensure pending statement array has capacity
  */
@@ -1839,7 +1804,7 @@ void sysml2_capture_flow(
         if (current && (current->kind == SYSML_KIND_FLOW_USAGE ||
                         current->kind == SYSML_KIND_KERML_FLOW ||
                         current->kind == SYSML_KIND_SUCCESSION_FLOW) &&
-            !current->connector_part) {
+            !sysml2_node_cold(current)->connector_part) {
             const char *src = trim_and_intern(ctx, source, source_len);
             const char *tgt = trim_and_intern(ctx, target, target_len);
             if (src && tgt) {
@@ -1849,7 +1814,7 @@ void sysml2_capture_flow(
                 char *buf = sysml2_arena_alloc(ctx->arena, total_len);
                 if (buf) {
                     snprintf(buf, total_len, "from %s to %s", src, tgt);
-                    current->connector_part = sysml2_intern(ctx->intern, buf);
+                    set_connector_part(ctx, current, sysml2_intern(ctx->intern, buf));
                 }
             }
             return;  /* Don't create statement */
@@ -2228,7 +2193,8 @@ void sysml2_capture_result_expr(SysmlBuildContext *ctx, const char *expr, size_t
         for (size_t i = ctx->element_count; i > 0; i--) {
             SysmlNode *node = ctx->elements[i - 1];
             if (node->id == current_scope) {
-                node->result_expression = trim_and_intern(ctx, expr, len);
+                SysmlNodeCold *cold = sysml2_node_cold_mut(ctx->arena, node);
+                if (cold) cold->result_expression = trim_and_intern(ctx, expr, len);
                 break;
             }
         }
@@ -2281,50 +2247,57 @@ void sysml2_capture_shorthand_feature(SysmlBuildContext *ctx, const char *text,
  */
 void sysml2_attach_pending_stmts(SysmlBuildContext *ctx, SysmlNode *node) {
     if (!ctx || !node) return;
+    if (ctx->pending_stmt_count == 0 && ctx->pending_comment_count == 0 &&
+        ctx->pending_rep_count == 0) {
+        return;
+    }
+
+    SysmlNodeCold *cold = sysml2_node_cold_mut(ctx->arena, node);
+    if (!cold) return;
 
     /* Append pending statements to existing */
     if (ctx->pending_stmt_count > 0) {
-        size_t new_count = node->body_stmt_count + ctx->pending_stmt_count;
+        size_t new_count = cold->body_stmt_count + ctx->pending_stmt_count;
         SysmlStatement **new_stmts = SYSML2_ARENA_NEW_ARRAY(ctx->arena, SysmlStatement *, new_count);
         if (new_stmts) {
             /* Copy existing statements first */
-            if (node->body_stmts && node->body_stmt_count > 0) {
-                memcpy(new_stmts, node->body_stmts, node->body_stmt_count * sizeof(SysmlStatement *));
+            if (cold->body_stmts && cold->body_stmt_count > 0) {
+                memcpy(new_stmts, cold->body_stmts, cold->body_stmt_count * sizeof(SysmlStatement *));
             }
             /* Append pending statements */
-            memcpy(new_stmts + node->body_stmt_count, ctx->pending_stmts, ctx->pending_stmt_count * sizeof(SysmlStatement *));
-            node->body_stmts = new_stmts;
-            node->body_stmt_count = new_count;
+            memcpy(new_stmts + cold->body_stmt_count, ctx->pending_stmts, ctx->pending_stmt_count * sizeof(SysmlStatement *));
+            cold->body_stmts = new_stmts;
+            cold->body_stmt_count = new_count;
         }
         ctx->pending_stmt_count = 0;
     }
 
     /* Append pending comments to existing */
     if (ctx->pending_comment_count > 0) {
-        size_t new_count = node->comment_count + ctx->pending_comment_count;
+        size_t new_count = cold->comment_count + ctx->pending_comment_count;
         SysmlNamedComment **new_comments = SYSML2_ARENA_NEW_ARRAY(ctx->arena, SysmlNamedComment *, new_count);
         if (new_comments) {
-            if (node->comments && node->comment_count > 0) {
-                memcpy(new_comments, node->comments, node->comment_count * sizeof(SysmlNamedComment *));
+            if (cold->comments && cold->comment_count > 0) {
+                memcpy(new_comments, cold->comments, cold->comment_count * sizeof(SysmlNamedComment *));
             }
-            memcpy(new_comments + node->comment_count, ctx->pending_comments, ctx->pending_comment_count * sizeof(SysmlNamedComment *));
-            node->comments = new_comments;
-            node->comment_count = new_count;
+            memcpy(new_comments + cold->comment_count, ctx->pending_comments, ctx->pending_comment_count * sizeof(SysmlNamedComment *));
+            cold->comments = new_comments;
+            cold->comment_count = new_count;
         }
         ctx->pending_comment_count = 0;
     }
 
     /* Append pending textual reps to existing */
     if (ctx->pending_rep_count > 0) {
-        size_t new_count = node->textual_rep_count + ctx->pending_rep_count;
+        size_t new_count = cold->textual_rep_count + ctx->pending_rep_count;
         SysmlTextualRep **new_reps = SYSML2_ARENA_NEW_ARRAY(ctx->arena, SysmlTextualRep *, new_count);
         if (new_reps) {
-            if (node->textual_reps && node->textual_rep_count > 0) {
-                memcpy(new_reps, node->textual_reps, node->textual_rep_count * sizeof(SysmlTextualRep *));
+            if (cold->textual_reps && cold->textual_rep_count > 0) {
+                memcpy(new_reps, cold->textual_reps, cold->textual_rep_count * sizeof(SysmlTextualRep *));
             }
-            memcpy(new_reps + node->textual_rep_count, ctx->pending_reps, ctx->pending_rep_count * sizeof(SysmlTextualRep *));
-            node->textual_reps = new_reps;
-            node->textual_rep_count = new_count;
+            memcpy(new_reps + cold->textual_rep_count, ctx->pending_reps, ctx->pending_rep_count * sizeof(SysmlTextualRep *));
+            cold->textual_reps = new_reps;
+            cold->textual_rep_count = new_count;
         }
         ctx->pending_rep_count = 0;
     }
@@ -2653,7 +2626,7 @@ void sysml2_capture_nary_connector(SysmlBuildContext *ctx, const char *text, siz
                         memcpy(buf, keyword, keyword_len);
                         memcpy(buf + keyword_len, trimmed, trimmed_len);
                         buf[total_len - 1] = '\0';
-                        node->connector_part = sysml2_intern(ctx->intern, buf);
+                        set_connector_part(ctx, node, sysml2_intern(ctx->intern, buf));
                     }
                 }
                 break;
@@ -2700,7 +2673,7 @@ void sysml2_capture_interface_connect(
     char *buf = sysml2_arena_alloc(ctx->arena, total_len);
     if (buf) {
         snprintf(buf, total_len, "%s to %s", src, tgt);
-        current->connector_part = sysml2_intern(ctx->intern, buf);
+        set_connector_part(ctx, current, sysml2_intern(ctx->intern, buf));
     }
 }
 
@@ -2729,7 +2702,7 @@ void sysml2_capture_succession_part(
             char *buf = sysml2_arena_alloc(ctx->arena, total_len);
             if (buf) {
                 snprintf(buf, total_len, "first %s then %s", first_str, then_str);
-                current->connector_part = sysml2_intern(ctx->intern, buf);
+                set_connector_part(ctx, current, sysml2_intern(ctx->intern, buf));
             }
         }
     } else {
@@ -2737,7 +2710,7 @@ void sysml2_capture_succession_part(
         char *buf = sysml2_arena_alloc(ctx->arena, total_len);
         if (buf) {
             snprintf(buf, total_len, "first %s", first_str);
-            current->connector_part = sysml2_intern(ctx->intern, buf);
+            set_connector_part(ctx, current, sysml2_intern(ctx->intern, buf));
         }
     }
 }
@@ -2781,7 +2754,7 @@ void sysml2_capture_binding_endpoints(
     char *buf = sysml2_arena_alloc(ctx->arena, total_len);
     if (buf) {
         snprintf(buf, total_len, "of %s = %s", l, r);
-        current->connector_part = sysml2_intern(ctx->intern, buf);
+        set_connector_part(ctx, current, sysml2_intern(ctx->intern, buf));
     }
 }
 
@@ -0,0 +1,202 @@
+/*
+ * SysML v2 Parser - Binary Model Reader Implementation
+ *
+ * Words are decoded byte-wise, so files read the same on any host and
+ * need no particular alignment.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "sysml2/binary_model.h"
+
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* Words per record of each section (strings: one offset per entry) */
+static const uint32_t section_words[SYSML2_BINARY_SECTION_COUNT] = {
+    [SYSML2_BINARY_SOURCES]       = SYSML2_BINARY_SOURCE_WORDS,
+    [SYSML2_BINARY_STRINGS]       = 1,
+    [SYSML2_BINARY_ELEMENTS]      = SYSML2_BINARY_ELEMENT_WORDS,
+    [SYSML2_BINARY_RELATIONSHIPS] = SYSML2_BINARY_RELATIONSHIP_WORDS,
+    [SYSML2_BINARY_IMPORTS]       = SYSML2_BINARY_IMPORT_WORDS,
+    [SYSML2_BINARY_ALIASES]       = SYSML2_BINARY_ALIAS_WORDS,
+    [SYSML2_BINARY_REFS]          = 1,
+};
+
+static uint32_t read_u32(const uint8_t *p) {
+    return (uint32_t)p[0]
+         | ((uint32_t)p[1] << 8)
+         | ((uint32_t)p[2] << 16)
+         | ((uint32_t)p[3] << 24);
+}
+
+/* Start of a record, or NULL if index is out of range */
+static const uint8_t *record(
+    const Sysml2BinaryModel *model,
+    Sysml2BinarySection section,
+    uint32_t index
+) {
+    const Sysml2BinaryRange *s = &model->sections[section];
+    if (index >= s->count) return NULL;
+    return model->data + s->first + (size_t)index * section_words[section] * 4;
+}
+
+static Sysml2BinaryRange read_range(const uint8_t *p) {
+    return (Sysml2BinaryRange){ read_u32(p), read_u32(p + 4) };
+}
+
+Sysml2Result sysml2_binary_open(Sysml2BinaryModel *model, const void *data, size_t size) {
+    memset(model, 0, sizeof(*model));
+    const uint8_t *bytes = data;
+
+    if (!bytes || size < SYSML2_BINARY_HEADER_SIZE) return SYSML2_ERROR_SYNTAX;
+    if (memcmp(bytes, SYSML2_BINARY_MAGIC, 8) != 0) return SYSML2_ERROR_SYNTAX;
+    if (read_u32(bytes + 8) != SYSML2_BINARY_VERSION) return SYSML2_ERROR_SYNTAX;
+    if (read_u32(bytes + 12) != size) return SYSML2_ERROR_SYNTAX;
+
+    for (int i = 0; i < SYSML2_BINARY_SECTION_COUNT; i++) {
+        Sysml2BinaryRange s = read_range(bytes + 16 + i * 8);
+        uint64_t end = (uint64_t)s.first + (uint64_t)s.count * section_words[i] * 4;
+        if (s.first < SYSML2_BINARY_HEADER_SIZE || end > size) return SYSML2_ERROR_SYNTAX;
+        model->sections[i] = s;
+    }
+
+    model->data = bytes;
+    model->size = size;
+    return SYSML2_OK;
+}
+
+Sysml2Result sysml2_binary_map(Sysml2BinaryModel *model, const char *path) {
+    memset(model, 0, sizeof(*model));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return errno == ENOENT ? SYSML2_ERROR_FILE_NOT_FOUND : SYSML2_ERROR_FILE_READ;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return SYSML2_ERROR_FILE_READ;
+    }
+    if (st.st_size < SYSML2_BINARY_HEADER_SIZE) {
+        close(fd);
+        return SYSML2_ERROR_SYNTAX;
+    }
+
+    size_t size = (size_t)st.st_size;
+    void *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return SYSML2_ERROR_FILE_READ;
+
+    Sysml2Result result = sysml2_binary_open(model, data, size);
+    if (result != SYSML2_OK) {
+        munmap(data, size);
+        return result;
+    }
+    model->mapping = data;
+    model->mapping_size = size;
+    return SYSML2_OK;
+}
+
+void sysml2_binary_unmap(Sysml2BinaryModel *model) {
+    if (!model || !model->mapping) return;
+    munmap(model->mapping, model->mapping_size);
+    memset(model, 0, sizeof(*model));
+}
+
+uint32_t sysml2_binary_count(const Sysml2BinaryModel *model, Sysml2BinarySection section) {
+    if (section >= SYSML2_BINARY_SECTION_COUNT) return 0;
+    return model->sections[section].count;
+}
+
+Sysml2StringView sysml2_binary_string(const Sysml2BinaryModel *model, uint32_t index) {
+    const uint8_t *p = record(model, SYSML2_BINARY_STRINGS, index);
+    if (!p) return SYSML2_SV_NULL;
+
+    uint32_t offset = read_u32(p);
+    if ((uint64_t)offset + 4 > model->size) return SYSML2_SV_NULL;
+    uint32_t length = read_u32(model->data + offset);
+    uint64_t end = (uint64_t)offset + 4 + length;
+    if (end >= model->size || model->data[end] != '\0') return SYSML2_SV_NULL;
+
+    return sysml2_sv_from_parts((const char *)model->data + offset + 4, length);
+}
+
+uint32_t sysml2_binary_ref(const Sysml2BinaryModel *model, uint32_t index) {
+    const uint8_t *p = record(model, SYSML2_BINARY_REFS, index);
+    return p ? read_u32(p) : SYSML2_BINARY_NONE;
+}
+
+Sysml2StringView sysml2_binary_ref_text(const Sysml2BinaryModel *model, uint32_t ref) {
+    if (ref == SYSML2_BINARY_NONE) return SYSML2_SV_NULL;
+    if (ref & SYSML2_BINARY_REF_STRING) {
+        return sysml2_binary_string(model, ref & ~SYSML2_BINARY_REF_STRING);
+    }
+    const uint8_t *p = record(model, SYSML2_BINARY_ELEMENTS, ref);
+    return p ? sysml2_binary_string(model, read_u32(p)) : SYSML2_SV_NULL;
+}
+
+bool sysml2_binary_source(const Sysml2BinaryModel *model, uint32_t index, Sysml2BinarySource *out) {
+    const uint8_t *p = record(model, SYSML2_BINARY_SOURCES, index);
+    if (!p) return false;
+    out->name = read_u32(p);
+    out->elements = read_range(p + 4);
+    out->relationships = read_range(p + 12);
+    out->imports = read_range(p + 20);
+    out->aliases = read_range(p + 28);
+    return true;
+}
+
+bool sysml2_binary_element(const Sysml2BinaryModel *model, uint32_t index, Sysml2BinaryElement *out) {
+    const uint8_t *p = record(model, SYSML2_BINARY_ELEMENTS, index);
+    if (!p) return false;
+    out->id = read_u32(p);
+    out->name = read_u32(p + 4);
+    out->type = read_u32(p + 8);
+    out->parent = read_u32(p + 12);
+    out->typed_by = read_range(p + 16);
+    out->specializes = read_range(p + 24);
+    out->redefines = read_range(p + 32);
+    out->references = read_range(p + 40);
+    return true;
+}
+
+bool sysml2_binary_relationship(
+    const Sysml2BinaryModel *model,
+    uint32_t index,
+    Sysml2BinaryRelationship *out
+) {
+    const uint8_t *p = record(model, SYSML2_BINARY_RELATIONSHIPS, index);
+    if (!p) return false;
+    out->id = read_u32(p);
+    out->type = read_u32(p + 4);
+    out->source = read_u32(p + 8);
+    out->target = read_u32(p + 12);
+    return true;
+}
+
+bool sysml2_binary_import(const Sysml2BinaryModel *model, uint32_t index, Sysml2BinaryImport *out) {
+    const uint8_t *p = record(model, SYSML2_BINARY_IMPORTS, index);
+    if (!p) return false;
+    out->id = read_u32(p);
+    out->type = read_u32(p + 4);
+    out->target = read_u32(p + 8);
+    out->owner = read_u32(p + 12);
+    out->flags = read_u32(p + 16);
+    return true;
+}
+
+bool sysml2_binary_alias(const Sysml2BinaryModel *model, uint32_t index, Sysml2BinaryAlias *out) {
+    const uint8_t *p = record(model, SYSML2_BINARY_ALIASES, index);
+    if (!p) return false;
+    out->id = read_u32(p);
+    out->name = read_u32(p + 4);
+    out->target = read_u32(p + 8);
+    out->owner = read_u32(p + 12);
+    return true;
+}
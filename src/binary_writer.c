@@ -0,0 +1,383 @@
+/*
+ * SysML v2 Parser - Binary Model Writer Implementation
+ *
+ * The file is built in memory section by section and written with one
+ * fwrite once every offset is known.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "sysml2/binary_writer.h"
+#include "sysml2/binary_model.h"
+#include "sysml2/intern.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Largest element or string index a reference can carry */
+#define BINARY_MAX_INDEX (SYSML2_BINARY_REF_STRING - 1)
+
+typedef struct {
+    uint8_t *data;
+    size_t length;
+    size_t capacity;
+    bool ok;
+} ByteBuf;
+
+/* String -> index map (open addressing, keyed by content) */
+typedef struct {
+    const char **keys;
+    uint32_t *hashes;
+    uint32_t *values;
+    size_t capacity;
+    size_t count;
+} StrMap;
+
+typedef struct {
+    ByteBuf sections[SYSML2_BINARY_SECTION_COUNT];
+    ByteBuf string_data;            /* Entries; offsets go in sections[STRINGS] */
+    uint32_t counts[SYSML2_BINARY_SECTION_COUNT];
+
+    StrMap strings;                 /* All strings written so far */
+    StrMap ids;                     /* Element ID -> index, current model only */
+    bool ok;
+} BinaryWriter;
+
+static void buf_append(ByteBuf *buf, const void *data, size_t length) {
+    if (!buf->ok) return;
+    if (buf->length + length > buf->capacity) {
+        size_t new_cap = buf->capacity ? buf->capacity * 2 : 4096;
+        while (new_cap < buf->length + length) new_cap *= 2;
+        uint8_t *new_data = realloc(buf->data, new_cap);
+        if (!new_data) {
+            buf->ok = false;
+            return;
+        }
+        buf->data = new_data;
+        buf->capacity = new_cap;
+    }
+    memcpy(buf->data + buf->length, data, length);
+    buf->length += length;
+}
+
+static void buf_u32(ByteBuf *buf, uint32_t value) {
+    uint8_t bytes[4] = {
+        (uint8_t)value,
+        (uint8_t)(value >> 8),
+        (uint8_t)(value >> 16),
+        (uint8_t)(value >> 24),
+    };
+    buf_append(buf, bytes, sizeof(bytes));
+}
+
+/* ========== String Map ========== */
+
+static bool map_grow(StrMap *map) {
+    size_t new_cap = map->capacity ? map->capacity * 2 : 1024;
+    const char **keys = calloc(new_cap, sizeof(const char *));
+    uint32_t *hashes = malloc(new_cap * sizeof(uint32_t));
+    uint32_t *values = malloc(new_cap * sizeof(uint32_t));
+    if (!keys || !hashes || !values) {
+        free(keys);
+        free(hashes);
+        free(values);
+        return false;
+    }
+    for (size_t i = 0; i < map->capacity; i++) {
+        if (!map->keys[i]) continue;
+        size_t j = map->hashes[i] & (new_cap - 1);
+        while (keys[j]) j = (j + 1) & (new_cap - 1);
+        keys[j] = map->keys[i];
+        hashes[j] = map->hashes[i];
+        values[j] = map->values[i];
+    }
+    free(map->keys);
+    free(map->hashes);
+    free(map->values);
+    map->keys = keys;
+    map->hashes = hashes;
+    map->values = values;
+    map->capacity = new_cap;
+    return true;
+}
+
+/*
+ * Find the slot for a key
+ *
+ * @return Slot index; keys[slot] is NULL if the key is absent
+ */
+static size_t map_slot(const StrMap *map, const char *key, uint32_t hash) {
+    size_t mask = map->capacity - 1;
+    size_t i = hash & mask;
+    while (map->keys[i]) {
+        if (map->keys[i] == key ||
+            (map->hashes[i] == hash && strcmp(map->keys[i], key) == 0)) {
+            break;
+        }
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+static bool map_find(const StrMap *map, const char *key, uint32_t *value) {
+    if (map->count == 0) return false;
+    uint32_t hash = sysml2_hash_string(key, strlen(key));
+    size_t i = map_slot(map, key, hash);
+    if (!map->keys[i]) return false;
+    *value = map->values[i];
+    return true;
+}
+
+/* Insert unless present; first insertion wins */
+static bool map_insert(StrMap *map, const char *key, uint32_t hash, uint32_t value) {
+    if ((map->count + 1) * 2 > map->capacity && !map_grow(map)) return false;
+    size_t i = map_slot(map, key, hash);
+    if (map->keys[i]) return true;
+    map->keys[i] = key;
+    map->hashes[i] = hash;
+    map->values[i] = value;
+    map->count++;
+    return true;
+}
+
+static void map_clear(StrMap *map) {
+    if (map->capacity) memset(map->keys, 0, map->capacity * sizeof(const char *));
+    map->count = 0;
+}
+
+static void map_free(StrMap *map) {
+    free(map->keys);
+    free(map->hashes);
+    free(map->values);
+}
+
+/* ========== Encoding ========== */
+
+/* Index of a string in the table, adding it if new */
+static uint32_t intern_string(BinaryWriter *w, const char *str) {
+    if (!str || !w->ok) return SYSML2_BINARY_NONE;
+
+    size_t length = strlen(str);
+    uint32_t hash = sysml2_hash_string(str, length);
+    if (w->strings.count) {
+        size_t i = map_slot(&w->strings, str, hash);
+        if (w->strings.keys[i]) return w->strings.values[i];
+    }
+
+    uint32_t index = w->counts[SYSML2_BINARY_STRINGS];
+    if (index > BINARY_MAX_INDEX || length > UINT32_MAX - 8 ||
+        !map_insert(&w->strings, str, hash, index)) {
+        w->ok = false;
+        return SYSML2_BINARY_NONE;
+    }
+
+    /* Offsets are relative to the string data until the layout is known */
+    static const uint8_t padding[4] = {0};
+    buf_u32(&w->sections[SYSML2_BINARY_STRINGS], (uint32_t)w->string_data.length);
+    buf_u32(&w->string_data, (uint32_t)length);
+    buf_append(&w->string_data, str, length + 1);
+    buf_append(&w->string_data, padding, (4 - (length + 1) % 4) % 4);
+    w->counts[SYSML2_BINARY_STRINGS]++;
+    return index;
+}
+
+static void put_string(BinaryWriter *w, Sysml2BinarySection section, const char *str) {
+    buf_u32(&w->sections[section], intern_string(w, str));
+}
+
+/* Element index for IDs of the current model, tagged string otherwise */
+static uint32_t encode_ref(BinaryWriter *w, const char *text) {
+    if (!text) return SYSML2_BINARY_NONE;
+    uint32_t index;
+    if (map_find(&w->ids, text, &index)) return index;
+    uint32_t str = intern_string(w, text);
+    return str == SYSML2_BINARY_NONE ? str : str | SYSML2_BINARY_REF_STRING;
+}
+
+static void put_ref(BinaryWriter *w, Sysml2BinarySection section, const char *text) {
+    buf_u32(&w->sections[section], encode_ref(w, text));
+}
+
+/* Append refs and write their {first, count} range into the element */
+static void put_ref_list(BinaryWriter *w, const char **refs, size_t count) {
+    ByteBuf *element = &w->sections[SYSML2_BINARY_ELEMENTS];
+    if (w->counts[SYSML2_BINARY_REFS] + (uint64_t)count > UINT32_MAX) {
+        w->ok = false;
+        return;
+    }
+    buf_u32(element, w->counts[SYSML2_BINARY_REFS]);
+    buf_u32(element, (uint32_t)count);
+    for (size_t i = 0; i < count; i++) {
+        buf_u32(&w->sections[SYSML2_BINARY_REFS], encode_ref(w, refs[i]));
+    }
+    w->counts[SYSML2_BINARY_REFS] += (uint32_t)count;
+}
+
+static void put_range(ByteBuf *buf, uint32_t first, size_t count) {
+    buf_u32(buf, first);
+    buf_u32(buf, (uint32_t)count);
+}
+
+static void encode_model(BinaryWriter *w, const SysmlSemanticModel *model) {
+    uint32_t *counts = w->counts;
+
+    if (counts[SYSML2_BINARY_ELEMENTS] + (uint64_t)model->element_count > BINARY_MAX_INDEX ||
+        counts[SYSML2_BINARY_RELATIONSHIPS] + (uint64_t)model->relationship_count > UINT32_MAX ||
+        counts[SYSML2_BINARY_IMPORTS] + (uint64_t)model->import_count > UINT32_MAX ||
+        counts[SYSML2_BINARY_ALIASES] + (uint64_t)model->alias_count > UINT32_MAX) {
+        w->ok = false;
+        return;
+    }
+
+    /* Register IDs first so forward references resolve to indices */
+    map_clear(&w->ids);
+    for (size_t i = 0; i < model->element_count; i++) {
+        const char *id = model->elements[i]->id;
+        if (!id) continue;
+        uint32_t hash = sysml2_hash_string(id, strlen(id));
+        if (!map_insert(&w->ids, id, hash, counts[SYSML2_BINARY_ELEMENTS] + (uint32_t)i)) {
+            w->ok = false;
+            return;
+        }
+    }
+
+    ByteBuf *source = &w->sections[SYSML2_BINARY_SOURCES];
+    put_string(w, SYSML2_BINARY_SOURCES, model->source_name);
+    put_range(source, counts[SYSML2_BINARY_ELEMENTS], model->element_count);
+    put_range(source, counts[SYSML2_BINARY_RELATIONSHIPS], model->relationship_count);
+    put_range(source, counts[SYSML2_BINARY_IMPORTS], model->import_count);
+    put_range(source, counts[SYSML2_BINARY_ALIASES], model->alias_count);
+    counts[SYSML2_BINARY_SOURCES]++;
+
+    for (size_t i = 0; i < model->element_count; i++) {
+        const SysmlNode *node = model->elements[i];
+        put_string(w, SYSML2_BINARY_ELEMENTS, node->id);
+        put_string(w, SYSML2_BINARY_ELEMENTS, node->name);
+        put_string(w, SYSML2_BINARY_ELEMENTS, sysml2_kind_to_json_type(node->kind));
+        put_ref(w, SYSML2_BINARY_ELEMENTS, node->parent_id);
+        put_ref_list(w, node->typed_by, node->typed_by_count);
+        put_ref_list(w, node->specializes, node->specializes_count);
+        put_ref_list(w, node->redefines, node->redefines_count);
+        put_ref_list(w, node->references, node->references_count);
+    }
+    counts[SYSML2_BINARY_ELEMENTS] += (uint32_t)model->element_count;
+
+    for (size_t i = 0; i < model->relationship_count; i++) {
+        const SysmlRelationship *rel = model->relationships[i];
+        put_string(w, SYSML2_BINARY_RELATIONSHIPS, rel->id);
+        put_string(w, SYSML2_BINARY_RELATIONSHIPS, sysml2_kind_to_json_type(rel->kind));
+        put_ref(w, SYSML2_BINARY_RELATIONSHIPS, rel->source);
+        put_ref(w, SYSML2_BINARY_RELATIONSHIPS, rel->target);
+    }
+    counts[SYSML2_BINARY_RELATIONSHIPS] += (uint32_t)model->relationship_count;
+
+    for (size_t i = 0; i < model->import_count; i++) {
+        const SysmlImport *imp = model->imports[i];
+        uint32_t flags = 0;
+        if (imp->is_private) flags |= SYSML2_BINARY_IMPORT_PRIVATE;
+        if (imp->is_public_explicit) flags |= SYSML2_BINARY_IMPORT_PUBLIC_EXPLICIT;
+        put_string(w, SYSML2_BINARY_IMPORTS, imp->id);
+        put_string(w, SYSML2_BINARY_IMPORTS, sysml2_kind_to_json_type(imp->kind));
+        put_ref(w, SYSML2_BINARY_IMPORTS, imp->target);
+        put_ref(w, SYSML2_BINARY_IMPORTS, imp->owner_scope);
+        buf_u32(&w->sections[SYSML2_BINARY_IMPORTS], flags);
+    }
+    counts[SYSML2_BINARY_IMPORTS] += (uint32_t)model->import_count;
+
+    for (size_t i = 0; i < model->alias_count; i++) {
+        const SysmlAlias *alias = model->aliases[i];
+        put_string(w, SYSML2_BINARY_ALIASES, alias->id);
+        put_string(w, SYSML2_BINARY_ALIASES, alias->name);
+        put_ref(w, SYSML2_BINARY_ALIASES, alias->target);
+        put_ref(w, SYSML2_BINARY_ALIASES, alias->owner_scope);
+    }
+    counts[SYSML2_BINARY_ALIASES] += (uint32_t)model->alias_count;
+}
+
+/* Lay out the sections after the header and fix up string offsets */
+static ByteBuf assemble(BinaryWriter *w) {
+    ByteBuf file = { .ok = true };
+
+    uint64_t offsets[SYSML2_BINARY_SECTION_COUNT];
+    uint64_t position = SYSML2_BINARY_HEADER_SIZE;
+    for (int i = 0; i < SYSML2_BINARY_SECTION_COUNT; i++) {
+        offsets[i] = position;
+        position += w->sections[i].length;
+        if (i == SYSML2_BINARY_STRINGS) position += w->string_data.length;
+    }
+    if (position > UINT32_MAX) {
+        file.ok = false;
+        return file;
+    }
+
+    /* String entries follow the offset array */
+    uint32_t data_start = (uint32_t)(offsets[SYSML2_BINARY_STRINGS] +
+                                     w->sections[SYSML2_BINARY_STRINGS].length);
+    uint8_t *entry = w->sections[SYSML2_BINARY_STRINGS].data;
+    for (uint32_t i = 0; i < w->counts[SYSML2_BINARY_STRINGS]; i++, entry += 4) {
+        uint32_t offset = ((uint32_t)entry[0] | ((uint32_t)entry[1] << 8) |
+                           ((uint32_t)entry[2] << 16) | ((uint32_t)entry[3] << 24)) + data_start;
+        entry[0] = (uint8_t)offset;
+        entry[1] = (uint8_t)(offset >> 8);
+        entry[2] = (uint8_t)(offset >> 16);
+        entry[3] = (uint8_t)(offset >> 24);
+    }
+
+    buf_append(&file, SYSML2_BINARY_MAGIC, 8);
+    buf_u32(&file, SYSML2_BINARY_VERSION);
+    buf_u32(&file, (uint32_t)position);
+    for (int i = 0; i < SYSML2_BINARY_SECTION_COUNT; i++) {
+        buf_u32(&file, (uint32_t)offsets[i]);
+        buf_u32(&file, w->counts[i]);
+    }
+    for (int i = 0; i < SYSML2_BINARY_SECTION_COUNT; i++) {
+        if (w->sections[i].length) {
+            buf_append(&file, w->sections[i].data, w->sections[i].length);
+        }
+        if (i == SYSML2_BINARY_STRINGS && w->string_data.length) {
+            buf_append(&file, w->string_data.data, w->string_data.length);
+        }
+    }
+    return file;
+}
+
+Sysml2Result sysml2_binary_write(
+    SysmlSemanticModel **models,
+    size_t model_count,
+    FILE *out
+) {
+    if ((!models && model_count > 0) || !out) {
+        return SYSML2_ERROR_SYNTAX;
+    }
+
+    BinaryWriter w;
+    memset(&w, 0, sizeof(w));
+    w.ok = true;
+    for (int i = 0; i < SYSML2_BINARY_SECTION_COUNT; i++) w.sections[i].ok = true;
+    w.string_data.ok = true;
+
+    for (size_t i = 0; i < model_count && w.ok; i++) {
+        if (models[i]) encode_model(&w, models[i]);
+    }
+
+    bool ok = w.ok && w.string_data.ok;
+    for (int i = 0; i < SYSML2_BINARY_SECTION_COUNT; i++) ok = ok && w.sections[i].ok;
+
+    ByteBuf file = {0};
+    if (ok) {
+        file = assemble(&w);
+        ok = file.ok;
+    }
+
+    Sysml2Result result = ok ? SYSML2_OK : SYSML2_ERROR_OUT_OF_MEMORY;
+    if (ok && fwrite(file.data, 1, file.length, out) != file.length) {
+        result = SYSML2_ERROR_FILE_READ;
+    }
+
+    free(file.data);
+    free(w.string_data.data);
+    for (int i = 0; i < SYSML2_BINARY_SECTION_COUNT; i++) free(w.sections[i].data);
+    map_free(&w.strings);
+    map_free(&w.ids);
+    return result;
+}
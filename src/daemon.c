@@ -0,0 +1,370 @@
+/*
+ * SysML v2 Parser - Fork Server Implementation
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/* struct ucred for SO_PEERCRED */
+#if defined(__linux__)
+#define _GNU_SOURCE
+#endif
+
+#include "sysml2/daemon.h"
+#include "sysml2/import_resolver.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/* Largest request payload accepted (command line plus two strings) */
+#define DAEMON_MAX_PAYLOAD (16u * 1024 * 1024)
+
+static volatile sig_atomic_t daemon_stop = 0;
+
+static void on_stop_signal(int sig) {
+    (void)sig;
+    daemon_stop = 1;
+}
+
+static bool make_address(const char *path, struct sockaddr_un *addr) {
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr->sun_path)) return false;
+    strcpy(addr->sun_path, path);
+    return true;
+}
+
+/* Connect to the socket at path; -1 if nothing accepts there */
+static int connect_socket(const char *path) {
+    struct sockaddr_un addr;
+    if (!make_address(path, &addr)) return -1;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static bool send_all(int fd, const void *data, size_t length) {
+    const char *p = data;
+    while (length > 0) {
+        ssize_t n = send(fd, p, length, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        length -= (size_t)n;
+    }
+    return true;
+}
+
+static bool recv_all(int fd, void *data, size_t length) {
+    char *p = data;
+    while (length > 0) {
+        ssize_t n = recv(fd, p, length, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        length -= (size_t)n;
+    }
+    return true;
+}
+
+/* ========== Daemon ========== */
+
+/*
+ * Receive the payload length and the client's three descriptors
+ *
+ * @return true with fds[0..2] set; on failure any received descriptors
+ *         are closed
+ */
+static bool recv_header(int conn, uint32_t *length, int fds[3]) {
+    union {
+        char buf[CMSG_SPACE(3 * sizeof(int))];
+        struct cmsghdr align;
+    } control;
+    struct iovec iov = { .iov_base = length, .iov_len = sizeof(*length) };
+    struct msghdr msg = {
+        .msg_iov = &iov,
+        .msg_iovlen = 1,
+        .msg_control = control.buf,
+        .msg_controllen = sizeof(control.buf),
+    };
+
+    ssize_t n;
+    do {
+        n = recvmsg(conn, &msg, 0);
+    } while (n < 0 && errno == EINTR);
+    if (n <= 0) return false;
+
+    size_t fd_count = 0;
+    for (struct cmsghdr *c = CMSG_FIRSTHDR(&msg); c; c = CMSG_NXTHDR(&msg, c)) {
+        if (c->cmsg_level != SOL_SOCKET || c->cmsg_type != SCM_RIGHTS) continue;
+        size_t count = (c->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        for (size_t i = 0; i < count; i++) {
+            int received;
+            memcpy(&received, CMSG_DATA(c) + i * sizeof(int), sizeof(int));
+            if (fd_count < 3) {
+                fds[fd_count++] = received;
+            } else {
+                close(received);
+            }
+        }
+    }
+
+    /* The rest of the length word may arrive separately */
+    bool ok = fd_count == 3 &&
+        recv_all(conn, (char *)length + n, sizeof(*length) - (size_t)n);
+    if (!ok) {
+        for (size_t i = 0; i < fd_count; i++) close(fds[i]);
+    }
+    return ok;
+}
+
+/* Whether the peer runs as the daemon's user; requests run with its rights */
+static bool peer_is_owner(int conn) {
+#if defined(__linux__)
+    struct ucred cred;
+    socklen_t cred_length = sizeof(cred);
+    if (getsockopt(conn, SOL_SOCKET, SO_PEERCRED, &cred, &cred_length) != 0) return false;
+    return cred.uid == geteuid();
+#else
+    uid_t uid;
+    gid_t gid;
+    if (getpeereid(conn, &uid, &gid) != 0) return false;
+    return uid == geteuid();
+#endif
+}
+
+/* Receive one request and run it; called in the forked child */
+static int serve_request(int conn, Sysml2DaemonHandler handler, void *data) {
+    /* Checked before the client's descriptors are taken */
+    if (!peer_is_owner(conn)) {
+        fprintf(stderr, "error: rejected a request from another user\n");
+        return 1;
+    }
+
+    uint32_t length;
+    int fds[3];
+    if (!recv_header(conn, &length, fds)) return 1;
+
+    /* From here on, errors are the client's to see */
+    for (int i = 0; i < 3; i++) {
+        if (fds[i] != i) {
+            dup2(fds[i], i);
+            close(fds[i]);
+        }
+    }
+
+    char *payload = length <= DAEMON_MAX_PAYLOAD ? malloc((size_t)length + 1) : NULL;
+    if (!payload || !recv_all(conn, payload, length)) {
+        fprintf(stderr, "error: incomplete request to daemon\n");
+        free(payload);
+        return 1;
+    }
+    payload[length] = '\0';
+
+    /* Split into strings: cwd, library path, argv */
+    size_t count = 0;
+    for (uint32_t i = 0; i < length; i++) {
+        if (payload[i] == '\0') count++;
+    }
+    char **strings = malloc((count + 1) * sizeof(char *));
+    if (!strings || count < 3 || payload[length - 1] != '\0') {
+        fprintf(stderr, "error: malformed request to daemon\n");
+        free(strings);
+        free(payload);
+        return 1;
+    }
+    char *p = payload;
+    for (size_t i = 0; i < count; i++) {
+        strings[i] = p;
+        p += strlen(p) + 1;
+    }
+    strings[count] = NULL;
+
+    if (chdir(strings[0]) != 0) {
+        fprintf(stderr, "error: cannot change to directory '%s': %s\n", strings[0], strerror(errno));
+        free(strings);
+        free(payload);
+        return 1;
+    }
+    if (strings[1][0] == '=') {
+        setenv(SYSML2_LIBRARY_PATH_ENV, strings[1] + 1, 1);
+    } else {
+        unsetenv(SYSML2_LIBRARY_PATH_ENV);
+    }
+
+    int code = handler((int)(count - 2), strings + 2, data);
+
+    fflush(stdout);
+    fflush(stderr);
+    int32_t reply = code;
+    send_all(conn, &reply, sizeof(reply));
+    return code;
+}
+
+int sysml2_daemon_run(const char *socket_path, Sysml2DaemonHandler handler, void *data) {
+    struct sockaddr_un addr;
+    if (!make_address(socket_path, &addr)) {
+        fprintf(stderr, "error: socket path too long: %s\n", socket_path);
+        return 1;
+    }
+
+    /* Replace a socket nobody listens on any more, never anything else */
+    struct stat st;
+    if (lstat(socket_path, &st) == 0) {
+        int live = connect_socket(socket_path);
+        if (live >= 0) {
+            close(live);
+            fprintf(stderr, "error: a daemon is already listening on %s\n", socket_path);
+            return 1;
+        }
+        if (!S_ISSOCK(st.st_mode)) {
+            fprintf(stderr, "error: %s exists and is not a socket\n", socket_path);
+            return 1;
+        }
+        unlink(socket_path);
+    }
+
+    /* Only the owner may connect: bind under a umask that leaves the
+     * socket file 0600, whatever umask the daemon inherited */
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    mode_t old_umask = umask(0177);
+    bool bound = listen_fd >= 0 && bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) == 0;
+    umask(old_umask);
+    if (!bound || listen(listen_fd, 128) != 0) {
+        fprintf(stderr, "error: cannot listen on %s: %s\n", socket_path, strerror(errno));
+        if (listen_fd >= 0) close(listen_fd);
+        return 1;
+    }
+
+    /* No SA_RESTART: a signal must interrupt accept() */
+    struct sigaction stop = { .sa_handler = on_stop_signal };
+    sigemptyset(&stop.sa_mask);
+    struct sigaction old_int, old_term, old_chld;
+    sigaction(SIGINT, &stop, &old_int);
+    sigaction(SIGTERM, &stop, &old_term);
+
+    /* Children are never waited for */
+    struct sigaction reap = { .sa_handler = SIG_IGN };
+    sigemptyset(&reap.sa_mask);
+    sigaction(SIGCHLD, &reap, &old_chld);
+
+    while (!daemon_stop) {
+        int conn = accept(listen_fd, NULL, NULL);
+        if (conn < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            fprintf(stderr, "error: accept on %s failed: %s\n", socket_path, strerror(errno));
+            break;
+        }
+
+        /* Nothing buffered here may be written twice */
+        fflush(NULL);
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(listen_fd);
+            sigaction(SIGINT, &old_int, NULL);
+            sigaction(SIGTERM, &old_term, NULL);
+            sigaction(SIGCHLD, &old_chld, NULL);
+            _exit(serve_request(conn, handler, data));
+        }
+        if (pid < 0) {
+            fprintf(stderr, "error: cannot fork for a request: %s\n", strerror(errno));
+        }
+        close(conn);
+    }
+
+    close(listen_fd);
+    unlink(socket_path);
+    sigaction(SIGINT, &old_int, NULL);
+    sigaction(SIGTERM, &old_term, NULL);
+    sigaction(SIGCHLD, &old_chld, NULL);
+    return 0;
+}
+
+/* ========== Client ========== */
+
+static bool send_header(int fd, uint32_t length) {
+    int fds[3] = { STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO };
+    union {
+        char buf[CMSG_SPACE(sizeof(fds))];
+        struct cmsghdr align;
+    } control;
+    memset(&control, 0, sizeof(control));
+
+    struct iovec iov = { .iov_base = &length, .iov_len = sizeof(length) };
+    struct msghdr msg = {
+        .msg_iov = &iov,
+        .msg_iovlen = 1,
+        .msg_control = control.buf,
+        .msg_controllen = sizeof(control.buf),
+    };
+    struct cmsghdr *c = CMSG_FIRSTHDR(&msg);
+    c->cmsg_level = SOL_SOCKET;
+    c->cmsg_type = SCM_RIGHTS;
+    c->cmsg_len = CMSG_LEN(sizeof(fds));
+    memcpy(CMSG_DATA(c), fds, sizeof(fds));
+
+    ssize_t n;
+    do {
+        n = sendmsg(fd, &msg, MSG_NOSIGNAL);
+    } while (n < 0 && errno == EINTR);
+    return n == (ssize_t)sizeof(length);
+}
+
+int sysml2_daemon_forward(const char *socket_path, int argc, char **argv) {
+    int fd = connect_socket(socket_path);
+    if (fd < 0) return -1;
+
+    char *cwd = getcwd(NULL, 0);
+    const char *lib_path = getenv(SYSML2_LIBRARY_PATH_ENV);
+
+    /* Payload: cwd, "=value" or "", then argv, each NUL-terminated */
+    size_t length = cwd ? strlen(cwd) + 1 : 0;
+    length += lib_path ? strlen(lib_path) + 2 : 1;
+    for (int i = 0; i < argc; i++) length += strlen(argv[i]) + 1;
+
+    char *payload = cwd && length <= DAEMON_MAX_PAYLOAD ? malloc(length) : NULL;
+    if (!payload) {
+        free(cwd);
+        close(fd);
+        return -1;
+    }
+    char *p = payload;
+    p = stpcpy(p, cwd) + 1;
+    if (lib_path) {
+        *p++ = '=';
+        p = stpcpy(p, lib_path) + 1;
+    } else {
+        *p++ = '\0';
+    }
+    for (int i = 0; i < argc; i++) p = stpcpy(p, argv[i]) + 1;
+    free(cwd);
+
+    /* The request cannot run without its whole payload */
+    bool sent = send_header(fd, (uint32_t)length) && send_all(fd, payload, length);
+    free(payload);
+    if (!sent) {
+        close(fd);
+        return -1;
+    }
+
+    int32_t code;
+    bool replied = recv_all(fd, &code, sizeof(code));
+    close(fd);
+    if (!replied) {
+        fprintf(stderr, "error: daemon on %s ended the request without an exit code\n", socket_path);
+        return 1;
+    }
+    return code;
+}
@@ -150,7 +150,7 @@ void sysml2_diag_emit(Sysml2DiagContext *ctx, Sysml2Diagnostic *diag) {
             /* Track error type based on diagnostic code */
             if (diag->code >= 1000 && diag->code < 3000) {
                 ctx->parse_error_count++;
-            } else if (diag->code >= 3000 && diag->code < 10000) {
+            } else if (diag->code >= 3000 && diag->code < 4000) {
                 ctx->semantic_error_count++;
             }
             break;
@@ -161,7 +161,7 @@ void sysml2_diag_emit(Sysml2DiagContext *ctx, Sysml2Diagnostic *diag) {
                 /* Track error type based on diagnostic code */
                 if (diag->code >= 1000 && diag->code < 3000) {
                     ctx->parse_error_count++;
-                } else if (diag->code >= 3000 && diag->code < 10000) {
+                } else if (diag->code >= 3000 && diag->code < 4000) {
                     ctx->semantic_error_count++;
                 }
             } else {
@@ -173,7 +173,7 @@ void sysml2_diag_emit(Sysml2DiagContext *ctx, Sysml2Diagnostic *diag) {
             /* Track error type based on diagnostic code */
             if (diag->code >= 1000 && diag->code < 3000) {
                 ctx->parse_error_count++;
-            } else if (diag->code >= 3000 && diag->code < 10000) {
+            } else if (diag->code >= 3000 && diag->code < 4000) {
                 ctx->semantic_error_count++;
             }
             ctx->has_fatal = true;
@@ -192,6 +192,32 @@ void sysml2_diag_emit(Sysml2DiagContext *ctx, Sysml2Diagnostic *diag) {
     }
 }
 
+static Sysml2Diagnostic *diag_copy(Sysml2DiagContext *dst, const Sysml2Diagnostic *src) {
+    Sysml2Diagnostic *copy = sysml2_diag_create(
+        dst, src->code, src->severity, src->file, src->range, src->message);
+    if (src->help) {
+        sysml2_diag_add_help(copy, dst, src->help);
+    }
+    for (size_t i = 0; i < src->fixit_count; i++) {
+        sysml2_diag_add_fixit(copy, dst, src->fixits[i].range, src->fixits[i].replacement);
+    }
+    for (const Sysml2Diagnostic *note = src->notes; note; note = note->next) {
+        Sysml2Diagnostic *note_copy = sysml2_diag_add_note(
+            copy, dst, note->file, note->range, note->message);
+        note_copy->code = note->code;
+        if (note->help) {
+            sysml2_diag_add_help(note_copy, dst, note->help);
+        }
+    }
+    return copy;
+}
+
+void sysml2_diag_merge(Sysml2DiagContext *dst, const Sysml2DiagContext *src) {
+    for (const Sysml2Diagnostic *diag = src->first; diag; diag = diag->next) {
+        sysml2_diag_emit(dst, diag_copy(dst, diag));
+    }
+}
+
 bool sysml2_should_use_color(Sysml2ColorMode mode, FILE *output) {
     switch (mode) {
         case SYSML2_COLOR_ALWAYS:
@@ -244,6 +270,7 @@ const char *sysml2_diag_code_to_string(Sysml2DiagCode code) {
         case SYSML2_DIAG_E3008_REDEFINITION_ERROR: return "E3008";
         case SYSML2_DIAG_E3009_CIRCULAR_IMPORT: return "E3009";
         case SYSML2_DIAG_E3010_IMPORT_NOT_FOUND: return "E3010";
+        case SYSML2_DIAG_E4001_MEMORY_LIMIT: return "E4001";
         case SYSML2_DIAG_W1001_UNUSED_IMPORT: return "W1001";
         case SYSML2_DIAG_W1002_SHADOWED_NAME: return "W1002";
         case SYSML2_DIAG_W1003_DEPRECATED: return "W1003";
@@ -256,33 +283,37 @@ const char *sysml2_diag_code_to_string(Sysml2DiagCode code) {
  * Handles two cases:
  * - Content present but line offsets not yet built (transferred from pipeline)
  * - No content at all: re-reads the file from disk (path must be a real file)
+ * Either way the result stays on the source file for the rest of the run,
+ * and a file that could not be loaded is not tried again.
  * Allocated memory (content/offsets) is intentionally not freed - acceptable
  * for a CLI tool that exits shortly after. */
 static void ensure_source_loaded(Sysml2SourceFile *sf) {
-    if (!sf) return;
+    if (!sf || sf->line_offsets || sf->load_failed) return;
 
     /* Case 1: Content available but line offsets not yet built */
-    if (sf->content && !sf->line_offsets) {
+    if (sf->content) {
         uint32_t line_count;
         uint32_t *offsets = sysml2_build_line_offsets(sf->content, sf->content_length, &line_count);
         sf->line_offsets = offsets;
         sf->line_count = offsets ? line_count : 0;
+        sf->load_failed = !offsets;
         return;
     }
 
     /* Case 2: No content - try to load from file path */
-    if (!sf->content && sf->path && sf->path[0] != '<') {
-        size_t length;
-        char *content = sysml2_read_file(sf->path, &length);
-        if (!content) return;
+    sf->load_failed = true;
+    if (sf->path && sf->path[0] != '<') {
+        Sysml2SourceBuffer source;
+        if (!sysml2_source_open(sf->path, &source)) return;
 
-        sf->content = content;
-        sf->content_length = length;
+        sf->content = source.data;
+        sf->content_length = source.length;
 
         uint32_t line_count;
-        uint32_t *offsets = sysml2_build_line_offsets(content, length, &line_count);
+        uint32_t *offsets = sysml2_build_line_offsets(source.data, source.length, &line_count);
         sf->line_offsets = offsets;
         sf->line_count = offsets ? line_count : 0;
+        sf->load_failed = !offsets;
     }
 }
 
@@ -313,27 +344,114 @@ static const char *get_source_line(const Sysml2SourceFile *file, uint32_t line,
     return file->content + start;
 }
 
-void sysml2_diag_print(
+/* ========== Buffered Output ========== */
+
+/*
+ * Diagnostics are rendered into one buffer and written in large chunks.
+ * stderr is unbuffered, so printing piece by piece costs a system call
+ * for every fragment and every caret.
+ */
+#define DIAG_BUFFER_SIZE 16384
+
+typedef struct {
+    FILE *out;
+    size_t length;
+    char data[DIAG_BUFFER_SIZE];
+} DiagWriter;
+
+static void dw_flush(DiagWriter *w) {
+    if (w->length > 0) {
+        fwrite(w->data, 1, w->length, w->out);
+        w->length = 0;
+    }
+}
+
+static void dw_write(DiagWriter *w, const char *data, size_t length) {
+    if (length > DIAG_BUFFER_SIZE - w->length) {
+        dw_flush(w);
+        if (length > DIAG_BUFFER_SIZE) {
+            fwrite(data, 1, length, w->out);
+            return;
+        }
+    }
+    memcpy(w->data + w->length, data, length);
+    w->length += length;
+}
+
+static void dw_puts(DiagWriter *w, const char *str) {
+    dw_write(w, str, strlen(str));
+}
+
+static void dw_putc(DiagWriter *w, char c) {
+    if (w->length == DIAG_BUFFER_SIZE) dw_flush(w);
+    w->data[w->length++] = c;
+}
+
+/* Write a number right-aligned in at least width columns */
+static void dw_uint(DiagWriter *w, uint32_t value, int width) {
+    char digits[16];
+    int n = 0;
+    do {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    for (int i = n; i < width; i++) dw_putc(w, ' ');
+    while (n > 0) dw_putc(w, digits[--n]);
+}
+
+static void dw_json_string(DiagWriter *w, const char *str) {
+    dw_putc(w, '"');
+    const char *run = str ? str : "";
+    const char *p = run;
+    for (; *p; p++) {
+        unsigned char c = (unsigned char)*p;
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        dw_write(w, run, (size_t)(p - run));
+        run = p + 1;
+        switch (c) {
+            case '"':  dw_puts(w, "\\\""); break;
+            case '\\': dw_puts(w, "\\\\"); break;
+            case '\n': dw_puts(w, "\\n"); break;
+            case '\r': dw_puts(w, "\\r"); break;
+            case '\t': dw_puts(w, "\\t"); break;
+            case '\f': dw_puts(w, "\\f"); break;
+            case '\b': dw_puts(w, "\\b"); break;
+            default: {
+                static const char hex[] = "0123456789abcdef";
+                char esc[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf] };
+                dw_write(w, esc, sizeof(esc));
+                break;
+            }
+        }
+    }
+    dw_write(w, run, (size_t)(p - run));
+    dw_putc(w, '"');
+}
+
+/* ========== Text Format ========== */
+
+static void print_text(
+    DiagWriter *w,
     const Sysml2Diagnostic *diag,
-    const Sysml2DiagOptions *options
+    const Sysml2DiagOptions *options,
+    bool use_color
 ) {
-    FILE *out = options->output;
-    bool use_color = sysml2_should_use_color(options->color_mode, out);
-
     /* Location */
     if (diag->file && diag->file->path) {
-        if (use_color) fprintf(out, "%s", COLOR_BOLD);
-        fprintf(out, "%s", diag->file->path);
-        if (use_color) fprintf(out, "%s", COLOR_RESET);
-        fprintf(out, ":");
+        if (use_color) dw_puts(w, COLOR_BOLD);
+        dw_puts(w, diag->file->path);
+        if (use_color) dw_puts(w, COLOR_RESET);
+        dw_putc(w, ':');
     }
 
     if (diag->range.start.line > 0) {
-        fprintf(out, "%u", diag->range.start.line);
+        dw_uint(w, diag->range.start.line, 0);
         if (options->show_column_numbers && diag->range.start.column > 0) {
-            fprintf(out, ":%u", diag->range.start.column);
+            dw_putc(w, ':');
+            dw_uint(w, diag->range.start.column, 0);
         }
-        fprintf(out, ": ");
+        dw_puts(w, ": ");
     }
 
     /* Severity with color */
@@ -341,33 +459,35 @@ void sysml2_diag_print(
         switch (diag->severity) {
             case SYSML2_SEVERITY_ERROR:
             case SYSML2_SEVERITY_FATAL:
-                fprintf(out, "%s%s", COLOR_BOLD, COLOR_RED);
+                dw_puts(w, COLOR_BOLD COLOR_RED);
                 break;
             case SYSML2_SEVERITY_WARNING:
-                fprintf(out, "%s%s", COLOR_BOLD, COLOR_YELLOW);
+                dw_puts(w, COLOR_BOLD COLOR_YELLOW);
                 break;
             case SYSML2_SEVERITY_NOTE:
-                fprintf(out, "%s%s", COLOR_BOLD, COLOR_CYAN);
+                dw_puts(w, COLOR_BOLD COLOR_CYAN);
                 break;
         }
     }
 
-    fprintf(out, "%s", sysml2_severity_to_string(diag->severity));
+    dw_puts(w, sysml2_severity_to_string(diag->severity));
 
     /* Error code */
     if (options->show_error_codes) {
-        fprintf(out, "[%s]", sysml2_diag_code_to_string(diag->code));
+        dw_putc(w, '[');
+        dw_puts(w, sysml2_diag_code_to_string(diag->code));
+        dw_putc(w, ']');
     }
 
-    if (use_color) fprintf(out, "%s", COLOR_RESET);
+    if (use_color) dw_puts(w, COLOR_RESET);
 
-    fprintf(out, ": ");
+    dw_puts(w, ": ");
 
     /* Message */
-    if (use_color) fprintf(out, "%s", COLOR_BOLD);
-    fprintf(out, "%s", diag->message);
-    if (use_color) fprintf(out, "%s", COLOR_RESET);
-    fprintf(out, "\n");
+    if (use_color) dw_puts(w, COLOR_BOLD);
+    dw_puts(w, diag->message);
+    if (use_color) dw_puts(w, COLOR_RESET);
+    dw_putc(w, '\n');
 
     /* Source context */
     if (options->show_source_context && diag->file && diag->range.start.line > 0) {
@@ -379,29 +499,26 @@ void sysml2_diag_print(
 
         if (line && line_len > 0) {
             /* Line number gutter */
-            fprintf(out, "   |\n");
-            fprintf(out, "%3u| ", diag->range.start.line);
+            dw_puts(w, "   |\n");
+            dw_uint(w, diag->range.start.line, 3);
+            dw_puts(w, "| ");
 
             /* Print line content */
-            fwrite(line, 1, line_len, out);
-            fprintf(out, "\n");
+            dw_write(w, line, line_len);
+            dw_putc(w, '\n');
 
             /* Caret line */
-            fprintf(out, "   | ");
+            dw_puts(w, "   | ");
 
             /* Spaces up to error position */
             uint32_t col = diag->range.start.column;
             if (col > 0) col--;
             for (uint32_t i = 0; i < col && i < line_len; i++) {
-                if (line[i] == '\t') {
-                    fprintf(out, "\t");
-                } else {
-                    fprintf(out, " ");
-                }
+                dw_putc(w, line[i] == '\t' ? '\t' : ' ');
             }
 
             /* Caret/underline */
-            if (use_color) fprintf(out, "%s", COLOR_GREEN);
+            if (use_color) dw_puts(w, COLOR_GREEN);
 
             uint32_t end_col = diag->range.end.column;
             if (diag->range.end.line > diag->range.start.line) {
@@ -411,49 +528,144 @@ void sysml2_diag_print(
 
             if (end_col > col) {
                 for (uint32_t i = col; i < end_col && i < line_len; i++) {
-                    fprintf(out, "^");
+                    dw_putc(w, '^');
                 }
             } else {
-                fprintf(out, "^");
+                dw_putc(w, '^');
             }
 
-            if (use_color) fprintf(out, "%s", COLOR_RESET);
-            fprintf(out, "\n");
+            if (use_color) dw_puts(w, COLOR_RESET);
+            dw_putc(w, '\n');
 
-            fprintf(out, "   |\n");
+            dw_puts(w, "   |\n");
         }
     }
 
     /* Help text */
     if (diag->help) {
-        fprintf(out, "   ");
-        if (use_color) fprintf(out, "%s", COLOR_CYAN);
-        fprintf(out, "= help: ");
-        if (use_color) fprintf(out, "%s", COLOR_RESET);
-        fprintf(out, "%s\n", diag->help);
+        dw_puts(w, "   ");
+        if (use_color) dw_puts(w, COLOR_CYAN);
+        dw_puts(w, "= help: ");
+        if (use_color) dw_puts(w, COLOR_RESET);
+        dw_puts(w, diag->help);
+        dw_putc(w, '\n');
     }
 
     /* Fix-it hints */
     for (size_t i = 0; i < diag->fixit_count; i++) {
-        fprintf(out, "   ");
-        if (use_color) fprintf(out, "%s", COLOR_GREEN);
-        fprintf(out, "= suggestion: ");
-        if (use_color) fprintf(out, "%s", COLOR_RESET);
-        fprintf(out, "replace with '%s'\n", diag->fixits[i].replacement);
+        dw_puts(w, "   ");
+        if (use_color) dw_puts(w, COLOR_GREEN);
+        dw_puts(w, "= suggestion: ");
+        if (use_color) dw_puts(w, COLOR_RESET);
+        dw_puts(w, "replace with '");
+        dw_puts(w, diag->fixits[i].replacement);
+        dw_puts(w, "'\n");
     }
 
     /* Notes */
     for (Sysml2Diagnostic *note = diag->notes; note; note = note->next) {
-        sysml2_diag_print(note, options);
+        print_text(w, note, options, use_color);
+    }
+
+    dw_putc(w, '\n');
+}
+
+/* ========== JSON Format ========== */
+
+static void print_json_range(DiagWriter *w, Sysml2SourceRange range) {
+    dw_puts(w, "\"line\":");
+    dw_uint(w, range.start.line, 0);
+    dw_puts(w, ",\"column\":");
+    dw_uint(w, range.start.column, 0);
+    dw_puts(w, ",\"end_line\":");
+    dw_uint(w, range.end.line, 0);
+    dw_puts(w, ",\"end_column\":");
+    dw_uint(w, range.end.column, 0);
+}
+
+/* One object; never touches the source text */
+static void print_json(DiagWriter *w, const Sysml2Diagnostic *diag) {
+    dw_puts(w, "{\"file\":");
+    if (diag->file && diag->file->path) {
+        dw_json_string(w, diag->file->path);
+    } else {
+        dw_puts(w, "null");
+    }
+    dw_putc(w, ',');
+    print_json_range(w, diag->range);
+    dw_puts(w, ",\"severity\":");
+    dw_json_string(w, sysml2_severity_to_string(diag->severity));
+    dw_puts(w, ",\"code\":");
+    dw_json_string(w, sysml2_diag_code_to_string(diag->code));
+    dw_puts(w, ",\"message\":");
+    dw_json_string(w, diag->message);
+
+    if (diag->help) {
+        dw_puts(w, ",\"help\":");
+        dw_json_string(w, diag->help);
+    }
+
+    if (diag->fixit_count > 0) {
+        dw_puts(w, ",\"fixits\":[");
+        for (size_t i = 0; i < diag->fixit_count; i++) {
+            if (i > 0) dw_putc(w, ',');
+            dw_putc(w, '{');
+            print_json_range(w, diag->fixits[i].range);
+            dw_puts(w, ",\"replacement\":");
+            dw_json_string(w, diag->fixits[i].replacement);
+            dw_putc(w, '}');
+        }
+        dw_putc(w, ']');
     }
 
-    fprintf(out, "\n");
+    if (diag->notes) {
+        dw_puts(w, ",\"notes\":[");
+        for (const Sysml2Diagnostic *note = diag->notes; note; note = note->next) {
+            if (note != diag->notes) dw_putc(w, ',');
+            print_json(w, note);
+        }
+        dw_putc(w, ']');
+    }
+
+    dw_putc(w, '}');
+}
+
+/* ========== Printing ========== */
+
+static void print_one(
+    DiagWriter *w,
+    const Sysml2Diagnostic *diag,
+    const Sysml2DiagOptions *options,
+    bool use_color
+) {
+    if (options->format == SYSML2_DIAG_FORMAT_JSON) {
+        print_json(w, diag);
+        dw_putc(w, '\n');
+    } else {
+        print_text(w, diag, options, use_color);
+    }
+}
+
+void sysml2_diag_print(
+    const Sysml2Diagnostic *diag,
+    const Sysml2DiagOptions *options
+) {
+    DiagWriter w;
+    w.out = options->output;
+    w.length = 0;
+    print_one(&w, diag, options, sysml2_should_use_color(options->color_mode, w.out));
+    dw_flush(&w);
 }
 
 void sysml2_diag_print_all(const Sysml2DiagContext *ctx, const Sysml2DiagOptions *options) {
+    DiagWriter w;
+    w.out = options->output;
+    w.length = 0;
+    bool use_color = sysml2_should_use_color(options->color_mode, w.out);
     for (Sysml2Diagnostic *diag = ctx->first; diag; diag = diag->next) {
-        sysml2_diag_print(diag, options);
+        print_one(&w, diag, options, use_color);
     }
+    dw_flush(&w);
 }
 
 void sysml2_diag_print_summary(const Sysml2DiagContext *ctx, FILE *output) {
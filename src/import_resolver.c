@@ -8,6 +8,7 @@
  */
 
 #include "sysml2/import_resolver.h"
+#include "sysml2/memory_budget.h"
 #include "sysml2/ast_builder.h"
 #include "sysml2/utils.h"
 #include "sysml_parser.h"
@@ -17,6 +18,7 @@
 #include <string.h>
 #include <errno.h>
 #include <dirent.h>
+#include <pthread.h>
 
 /* Initial capacities */
 #define RESOLVER_INITIAL_PATH_CAPACITY 8
@@ -24,9 +26,8 @@
 #define RESOLVER_INITIAL_PACKAGE_MAP_CAPACITY 64
 #define RESOLVER_INITIAL_FILE_CACHE_CAPACITY 128
 #define RESOLVER_INITIAL_FAILED_LOOKUP_CAPACITY 32
-
-/* Environment variable name */
-#define SYSML2_LIBRARY_PATH_ENV "SYSML2_LIBRARY_PATH"
+#define RESOLVER_FILE_INDEX_CAPACITY 256
+#define RESOLVER_SEARCH_DEPTH 5
 
 /* Hash function for package names (djb2) */
 static size_t hash_string(const char *str) {
@@ -78,7 +79,7 @@ static void register_package_file(
     while (entry) {
         if (strcmp(entry->package_name, pkg_name) == 0) {
             /* Already registered - first-wins, just warn in verbose mode */
-            if (resolver->verbose) {
+            if (resolver->verbose && strcmp(entry->file_path, file_path) != 0) {
                 fprintf(stderr, "note: package '%s' already mapped to %s, ignoring %s\n",
                         pkg_name, entry->file_path, file_path);
             }
@@ -131,8 +132,8 @@ static const char *lookup_package_file(
     return NULL;
 }
 
-/* Internal: get cached model using already-absolute path (skip realpath) */
-static SysmlSemanticModel *get_cached_abs(
+/* Internal: look up a cached model by already-absolute path (skip realpath) */
+static SysmlSemanticModel *peek_cached_abs(
     Sysml2ImportResolver *resolver,
     const char *abs_path
 ) {
@@ -149,6 +150,16 @@ static SysmlSemanticModel *get_cached_abs(
     return NULL;
 }
 
+/* Internal: get cached model using already-absolute path, counting hits */
+static SysmlSemanticModel *get_cached_abs(
+    Sysml2ImportResolver *resolver,
+    const char *abs_path
+) {
+    SysmlSemanticModel *model = peek_cached_abs(resolver, abs_path);
+    if (model) resolver->file_cache_hits++;
+    return model;
+}
+
 /* Internal: cache model using already-absolute path (skip realpath) */
 static void cache_model_abs(
     Sysml2ImportResolver *resolver,
@@ -259,41 +270,135 @@ static char *extract_package_name(const char *import_target) {
     return result;
 }
 
-/* Forward declaration for recursive search */
-static char *search_directory_recursive(const char *dir, const char *filename, int max_depth);
+/* Whether name ends in .sysml or .kerml */
+static bool is_model_file_name(const char *name) {
+    size_t len = strlen(name);
+    return len > 6 && (strcmp(name + len - 6, ".sysml") == 0 ||
+                       strcmp(name + len - 6, ".kerml") == 0);
+}
 
-/* Search a directory for a file, optionally recursive */
-static char *search_directory_recursive(const char *dir, const char *filename, int max_depth) {
-    if (max_depth <= 0) return NULL;
+static Sysml2FileIndexEntry *file_index_find(
+    const Sysml2ImportResolver *resolver,
+    size_t path_index,
+    const char *name
+) {
+    if (!resolver->file_index) return NULL;
+
+    size_t bucket = hash_string(name) % resolver->file_index_capacity;
+    for (Sysml2FileIndexEntry *entry = resolver->file_index[bucket]; entry; entry = entry->next) {
+        if (entry->path_index == path_index && strcmp(entry->name, name) == 0) return entry;
+    }
+    return NULL;
+}
 
-    DIR *d = opendir(dir);
-    if (!d) return NULL;
+/* Record name -> path unless an earlier match exists; takes path */
+static void file_index_add(
+    Sysml2ImportResolver *resolver,
+    size_t path_index,
+    const char *name,
+    char *path
+) {
+    Sysml2FileIndexEntry *entry = NULL;
+    if (!file_index_find(resolver, path_index, name)) {
+        entry = malloc(sizeof(Sysml2FileIndexEntry));
+    }
+    char *name_copy = entry ? strdup(name) : NULL;
+    if (!name_copy) {
+        free(entry);
+        free(path);
+        return;
+    }
 
-    struct dirent *entry;
-    char *result = NULL;
+    size_t bucket = hash_string(name) % resolver->file_index_capacity;
+    entry->name = name_copy;
+    entry->path_index = path_index;
+    entry->path = path;
+    entry->next = resolver->file_index[bucket];
+    resolver->file_index[bucket] = entry;
+}
 
-    while ((entry = readdir(d)) != NULL && !result) {
+/*
+ * Index the model files under dir in readdir order, depth first, so the
+ * first entry per name is what a search for that name would return.
+ * Only d_type is consulted, except for symlinks and unknown types.
+ */
+static void index_directory(
+    Sysml2ImportResolver *resolver,
+    size_t path_index,
+    const char *dir_path,
+    int max_depth
+) {
+    if (max_depth <= 0) return;
+
+    DIR *d = opendir(dir_path);
+    if (!d) return;
+
+    struct dirent *entry;
+    while ((entry = readdir(d)) != NULL) {
         /* Skip . and .. */
         if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
             continue;
         }
 
-        char *full_path = sysml2_path_join(dir, entry->d_name);
-        if (!full_path) continue;
-
-        if (strcmp(entry->d_name, filename) == 0 && sysml2_is_file(full_path)) {
-            result = full_path;
-        } else if (sysml2_is_directory(full_path)) {
-            /* Recurse into subdirectory */
-            result = search_directory_recursive(full_path, filename, max_depth - 1);
-            free(full_path);
-        } else {
+        Sysml2EntryKind kind = sysml2_dir_entry_kind(d, entry, NULL);
+        if (kind == SYSML2_ENTRY_FILE && is_model_file_name(entry->d_name)) {
+            char *full_path = sysml2_path_join(dir_path, entry->d_name);
+            if (full_path) file_index_add(resolver, path_index, entry->d_name, full_path);
+        } else if (kind == SYSML2_ENTRY_DIRECTORY) {
+            char *full_path = sysml2_path_join(dir_path, entry->d_name);
+            if (full_path) index_directory(resolver, path_index, full_path, max_depth - 1);
             free(full_path);
         }
     }
 
     closedir(d);
-    return result;
+}
+
+/* Walk library path path_index once and add its files to the index */
+static void index_library_path(Sysml2ImportResolver *resolver, size_t path_index) {
+    if (!resolver->file_index) {
+        resolver->file_index = calloc(RESOLVER_FILE_INDEX_CAPACITY, sizeof(Sysml2FileIndexEntry *));
+        if (!resolver->file_index) return;
+        resolver->file_index_capacity = RESOLVER_FILE_INDEX_CAPACITY;
+    }
+
+    const char *lib_path = resolver->library_paths[path_index];
+    sysml2_trace_begin(resolver->trace, "resolve", "index", lib_path);
+    index_directory(resolver, path_index, lib_path, RESOLVER_SEARCH_DEPTH);
+    sysml2_trace_end(resolver->trace);
+}
+
+/* Find filename anywhere under library path path_index (caller frees) */
+static char *search_library_path(
+    Sysml2ImportResolver *resolver,
+    size_t path_index,
+    const char *filename
+) {
+    while (resolver->indexed_paths <= path_index) {
+        index_library_path(resolver, resolver->indexed_paths++);
+    }
+
+    Sysml2FileIndexEntry *entry = file_index_find(resolver, path_index, filename);
+    return entry ? strdup(entry->path) : NULL;
+}
+
+static void clear_file_index(Sysml2ImportResolver *resolver) {
+    if (!resolver->file_index) return;
+
+    for (size_t i = 0; i < resolver->file_index_capacity; i++) {
+        Sysml2FileIndexEntry *entry = resolver->file_index[i];
+        while (entry) {
+            Sysml2FileIndexEntry *next = entry->next;
+            free(entry->name);
+            free(entry->path);
+            free(entry);
+            entry = next;
+        }
+    }
+    free(resolver->file_index);
+    resolver->file_index = NULL;
+    resolver->file_index_capacity = 0;
+    resolver->indexed_paths = 0;
 }
 
 Sysml2ImportResolver *sysml2_resolver_create(
@@ -360,6 +465,9 @@ Sysml2ImportResolver *sysml2_resolver_create(
     resolver->disabled = false;
     resolver->strict_imports = false;
     resolver->preloaded = false;
+    resolver->libraries_indexed = false;
+    resolver->library_path_count = 0;
+    resolver->capture = SYSML_CAPTURE_ALL;
 
     return resolver;
 }
@@ -407,15 +515,40 @@ void sysml2_resolver_destroy(Sysml2ImportResolver *resolver) {
         free(resolver->package_map);
     }
 
+    /* Free discovered directory list */
+    for (size_t i = 0; i < resolver->discovered_count; i++) {
+        free(resolver->discovered_dirs[i]);
+    }
+    free(resolver->discovered_dirs);
+
+    clear_file_index(resolver);
+
     /* Free failed lookup cache */
     if (resolver->failed_lookups) {
         clear_failed_lookups(resolver);
         free(resolver->failed_lookups);
     }
 
+    sysml2_model_cache_destroy(resolver->model_cache);
+
     free(resolver);
 }
 
+Sysml2Result sysml2_resolver_set_cache_dir(
+    Sysml2ImportResolver *resolver,
+    const char *dir
+) {
+    if (!resolver || !dir) return SYSML2_ERROR_SEMANTIC;
+
+    Sysml2ModelCache *cache = sysml2_model_cache_create(dir, resolver->arena, resolver->intern);
+    if (!cache) return SYSML2_ERROR_FILE_READ;
+
+    cache->verbose = resolver->verbose;
+    sysml2_model_cache_destroy(resolver->model_cache);
+    resolver->model_cache = cache;
+    return SYSML2_OK;
+}
+
 void sysml2_resolver_add_path(Sysml2ImportResolver *resolver, const char *path) {
     if (!resolver || !path) return;
 
@@ -532,6 +665,7 @@ char *sysml2_resolver_find_file(
     /* Check package map first (populated by preload) */
     const char *mapped_path = lookup_package_file(resolver, package_name);
     if (mapped_path) {
+        sysml2_trace_instant(resolver->trace, "cache", "package map hit", package_name);
         if (resolver->verbose) {
             fprintf(stderr, "note: found '%s' via package map -> %s\n",
                     package_name, mapped_path);
@@ -542,6 +676,7 @@ char *sysml2_resolver_find_file(
 
     /* Check negative lookup cache - skip expensive search if already failed */
     if (is_failed_lookup(resolver, package_name)) {
+        sysml2_trace_instant(resolver->trace, "cache", "failed lookup hit", package_name);
         if (resolver->verbose) {
             fprintf(stderr, "note: '%s' in negative cache, skipping search\n", package_name);
         }
@@ -577,14 +712,14 @@ char *sysml2_resolver_find_file(
         }
         free(full_path);
 
-        /* Try recursive search in subdirectories (max depth 5) */
-        char *found = search_directory_recursive(lib_path, filename_kerml, 5);
+        /* Try subdirectories (max depth 5), from the path's file index */
+        char *found = search_library_path(resolver, i, filename_kerml);
         if (found) {
             free(package_name);
             return found;
         }
 
-        found = search_directory_recursive(lib_path, filename_sysml, 5);
+        found = search_library_path(resolver, i, filename_sysml);
         if (found) {
             free(package_name);
             return found;
@@ -592,6 +727,7 @@ char *sysml2_resolver_find_file(
     }
 
     /* Remember this failure to avoid repeating expensive searches */
+    sysml2_trace_instant(resolver->trace, "cache", "lookup failed", package_name);
     add_failed_lookup(resolver, package_name);
 
     free(package_name);
@@ -635,79 +771,477 @@ static void pop_resolution_stack(Sysml2ImportResolver *resolver) {
     }
 }
 
-/* Parse a single file and return its model */
-static SysmlSemanticModel *parse_file(
-    Sysml2ImportResolver *resolver,
+/*
+ * Parse content into the given arena/intern
+ *
+ * Shared with prefetch workers, so it touches nothing else; syntax
+ * errors go to err_out (NULL = stderr).
+ */
+static SysmlSemanticModel *parse_source(
+    Sysml2Arena *arena,
+    Sysml2Intern *intern,
+    SysmlCaptureOptions capture,
+    FILE *err_out,
     const char *path,
-    Sysml2DiagContext *diag
+    const char *content,
+    size_t length,
+    int *out_error_count
 ) {
-    /* Read file content */
-    size_t content_length;
-    char *content = sysml2_read_file(path, &content_length);
-    if (!content) {
-        /* Report error using diagnostic system */
-        Sysml2SourceRange range = {{1, 1, 0}, {1, 1, 0}};
-        char msg[512];
-        snprintf(msg, sizeof(msg), "cannot read file '%s': %s", path, strerror(errno));
-        sysml2_diag_emit(diag, sysml2_diag_create(
-            diag, SYSML2_DIAG_E3010_IMPORT_NOT_FOUND, SYSML2_SEVERITY_ERROR,
-            NULL, range, sysml2_arena_strdup(resolver->arena, msg)
-        ));
-        return NULL;
-    }
+    *out_error_count = 0;
+
+    /* Over the memory limit nothing more is parsed; finish_parse reports it */
+    if (sysml2_memory_exceeded()) return NULL;
 
     /* Create build context */
-    SysmlBuildContext *build_ctx = sysml2_build_context_create(
-        resolver->arena, resolver->intern, path
-    );
-    if (!build_ctx) {
-        free(content);
-        return NULL;
-    }
+    SysmlBuildContext *build_ctx = sysml2_build_context_create(arena, intern, path);
+    if (!build_ctx) return NULL;
+    build_ctx->capture = capture;
 
     /* Set up parser context */
     SysmlParserContext ctx = {
         .filename = path,
         .input = content,
-        .input_len = content_length,
+        .input_len = length,
         .input_pos = 0,
         .error_count = 0,
-        .line = 1,
-        .col = 1,
         .furthest_pos = 0,
-        .furthest_line = 0,
-        .furthest_col = 0,
         .failed_rule_count = 0,
         .context_rule = NULL,
         .build_ctx = build_ctx,
+        .err_out = err_out,
     };
 
     /* Parse */
     sysml2_context_t *parser = sysml2_create(&ctx);
-    if (!parser) {
-        free(content);
-        return NULL;
-    }
+    if (!parser) return NULL;
 
     void *result = NULL;
     int parse_ok = sysml2_parse(parser, &result);
-
-    if (ctx.error_count > 0) {
-        diag->error_count += ctx.error_count;
-        diag->parse_error_count += ctx.error_count;
-    }
+    *out_error_count = ctx.error_count;
 
     SysmlSemanticModel *model = NULL;
-    if (parse_ok && ctx.error_count == 0) {
+    if (parse_ok && ctx.error_count == 0 && !ctx.memory_stop) {
         model = sysml2_build_finalize(build_ctx);
     }
 
     sysml2_destroy(parser);
-    free(content);
+    sysml2_parser_context_release(&ctx);
+    return model;
+}
+
+/*
+ * Account for a parse of path: count it, report its errors, store the
+ * model in the model cache and attach or release the source. Past the
+ * memory limit the model is dropped and the breach reported instead.
+ */
+static SysmlSemanticModel *finish_parse(
+    Sysml2ImportResolver *resolver,
+    const char *path,
+    Sysml2DiagContext *diag,
+    Sysml2SourceBuffer *source,
+    SysmlSemanticModel *model,
+    int error_count,
+    bool keep_source
+) {
+    resolver->files_parsed++;
+    resolver->bytes_parsed += source->length;
+
+    if (sysml2_memory_report(diag, path)) {
+        sysml2_source_release(source);
+        return NULL;
+    }
+
+    if (error_count > 0) {
+        diag->error_count += error_count;
+        diag->parse_error_count += error_count;
+    }
+
+    /* Failing to write the cache is not an error; the next run reparses.
+     * Entries must serve any later run, so trimmed models are not stored. */
+    if (model && resolver->model_cache && sysml2_capture_is_all(resolver->capture)) {
+        sysml2_model_cache_store(resolver->model_cache, path, source->data, source->length, model);
+    }
+
+    /* Keep the content for diagnostic snippets; it is mapped, so pages
+     * nobody reads again cost nothing */
+    Sysml2SourceFile *sf = model && keep_source
+        ? SYSML2_ARENA_NEW(resolver->arena, Sysml2SourceFile) : NULL;
+    if (sf) {
+        sf->path = sysml2_intern(resolver->intern, path);
+        sf->content = source->data;
+        sf->content_length = source->length;
+        model->source_file = sf;
+        memset(source, 0, sizeof(*source));
+    } else {
+        sysml2_source_release(source);
+    }
 
     return model;
 }
 
+/* Parse a single file and return its model.
+ * With keep_source the content stays attached for diagnostic snippets. */
+static SysmlSemanticModel *parse_file(
+    Sysml2ImportResolver *resolver,
+    const char *path,
+    Sysml2DiagContext *diag,
+    bool keep_source
+) {
+    /* Reuse the model from a previous run if the file is unchanged */
+    if (resolver->model_cache) {
+        SysmlSemanticModel *cached = sysml2_model_cache_load(resolver->model_cache, path);
+        sysml2_trace_instant(resolver->trace, "cache",
+                             cached ? "model cache hit" : "model cache miss", path);
+        if (cached) return cached;
+    }
+
+    if (sysml2_memory_report(diag, path)) return NULL;
+
+    /* Map file content */
+    Sysml2SourceBuffer source;
+    if (!sysml2_source_open(path, &source)) {
+        /* Report error using diagnostic system */
+        Sysml2SourceRange range = {{1, 1, 0}, {1, 1, 0}};
+        char msg[512];
+        snprintf(msg, sizeof(msg), "cannot read file '%s': %s", path, strerror(errno));
+        sysml2_diag_emit(diag, sysml2_diag_create(
+            diag, SYSML2_DIAG_E3010_IMPORT_NOT_FOUND, SYSML2_SEVERITY_ERROR,
+            NULL, range, sysml2_arena_strdup(resolver->arena, msg)
+        ));
+        return NULL;
+    }
+
+    sysml2_trace_begin(resolver->trace, "parse", "parse", path);
+    int error_count = 0;
+    SysmlSemanticModel *model = parse_source(resolver->arena, resolver->intern, resolver->capture,
+                                             NULL, path, source.data, source.length, &error_count);
+    sysml2_trace_end(resolver->trace);
+
+    return finish_parse(resolver, path, diag, &source, model, error_count, keep_source);
+}
+
+/* ========== Import Prefetch ========== */
+
+/*
+ * With jobs > 1, resolving a model's imports starts by walking the import
+ * graph breadth-first with find_file, parsing each level's missing files
+ * on worker threads into worker-local arenas. The files are only parked
+ * here; the depth-first walk below still visits imports in the same
+ * order as a serial run and takes each file from the prefetch instead of
+ * parsing it, so the file cache, its model order, cycle detection and
+ * every message come out exactly as without threads.
+ */
+
+/* One file parsed ahead of the walk */
+typedef struct {
+    char *path;                  /* Absolute path (owned) */
+    Sysml2SourceBuffer source;   /* Content, when parsed by a worker */
+    char *messages;              /* Buffered parser output (malloc'd) */
+    size_t messages_length;
+    void *blob;                  /* Serialized model from the worker (malloc'd) */
+    size_t blob_size;
+    int error_count;             /* Syntax errors reported */
+    SysmlSemanticModel *model;   /* Rebuilt or cached model */
+    bool parsed;                 /* A worker parsed it (else: model cache hit) */
+    bool ready;                  /* Usable by the walk; if not, it parses itself */
+    bool taken;                  /* Handed to the walk */
+} PrefetchEntry;
+
+typedef struct Sysml2Prefetch {
+    PrefetchEntry *entries;
+    size_t count;
+    size_t capacity;
+    size_t *slots;               /* Open-addressed index: entry + 1, 0 = empty */
+    size_t slot_capacity;        /* Power of two */
+} Sysml2Prefetch;
+
+/* Work shared by the workers of one level */
+typedef struct {
+    PrefetchEntry **jobs;
+    size_t count;
+    size_t next;
+    SysmlCaptureOptions capture;
+    Sysml2Trace *trace;
+    pthread_mutex_t lock;
+} PrefetchQueue;
+
+static PrefetchEntry *prefetch_find(const Sysml2Prefetch *pf, const char *path) {
+    if (!pf->slot_capacity) return NULL;
+    size_t mask = pf->slot_capacity - 1;
+    for (size_t i = hash_string(path) & mask; pf->slots[i]; i = (i + 1) & mask) {
+        PrefetchEntry *entry = &pf->entries[pf->slots[i] - 1];
+        if (strcmp(entry->path, path) == 0) return entry;
+    }
+    return NULL;
+}
+
+/* Add an entry for path (taking ownership); false on allocation failure */
+static bool prefetch_add(Sysml2Prefetch *pf, char *path) {
+    if ((pf->count + 1) * 2 > pf->slot_capacity) {
+        size_t capacity = pf->slot_capacity ? pf->slot_capacity * 2 : 64;
+        size_t *slots = calloc(capacity, sizeof(size_t));
+        if (!slots) return false;
+        for (size_t e = 0; e < pf->count; e++) {
+            size_t i = hash_string(pf->entries[e].path) & (capacity - 1);
+            while (slots[i]) i = (i + 1) & (capacity - 1);
+            slots[i] = e + 1;
+        }
+        free(pf->slots);
+        pf->slots = slots;
+        pf->slot_capacity = capacity;
+    }
+    if (pf->count >= pf->capacity) {
+        size_t capacity = pf->capacity ? pf->capacity * 2 : 32;
+        PrefetchEntry *entries = realloc(pf->entries, capacity * sizeof(PrefetchEntry));
+        if (!entries) return false;
+        pf->entries = entries;
+        pf->capacity = capacity;
+    }
+
+    pf->entries[pf->count] = (PrefetchEntry){.path = path};
+    size_t mask = pf->slot_capacity - 1;
+    size_t i = hash_string(path) & mask;
+    while (pf->slots[i]) i = (i + 1) & mask;
+    pf->slots[i] = ++pf->count;
+    return true;
+}
+
+static void prefetch_destroy(Sysml2Prefetch *pf) {
+    for (size_t i = 0; i < pf->count; i++) {
+        PrefetchEntry *entry = &pf->entries[i];
+        sysml2_source_release(&entry->source);
+        free(entry->messages);
+        free(entry->blob);
+        free(entry->path);
+    }
+    free(pf->entries);
+    free(pf->slots);
+}
+
+/* Parse one file into a worker-local arena and serialize the result */
+static void run_prefetch_job(PrefetchEntry *entry, SysmlCaptureOptions capture,
+                             Sysml2Trace *trace) {
+    if (!sysml2_source_open(entry->path, &entry->source)) return;
+
+    FILE *msg = open_memstream(&entry->messages, &entry->messages_length);
+    if (!msg) {
+        sysml2_source_release(&entry->source);
+        return;
+    }
+
+    Sysml2Arena arena;
+    sysml2_arena_init(&arena);
+    Sysml2Intern intern;
+    sysml2_intern_init(&intern, &arena);
+
+    sysml2_trace_begin(trace, "parse", "parse", entry->path);
+    SysmlSemanticModel *model = parse_source(&arena, &intern, capture, msg, entry->path,
+                                             entry->source.data, entry->source.length,
+                                             &entry->error_count);
+    sysml2_trace_end(trace);
+
+    /* A model that cannot be handed over is parsed again by the walk */
+    bool ok = !model || sysml2_model_serialize(model, &entry->blob, &entry->blob_size) == SYSML2_OK;
+
+    sysml2_intern_destroy(&intern);
+    sysml2_arena_destroy(&arena);
+    fclose(msg);
+
+    if (ok) {
+        entry->parsed = true;
+        entry->ready = true;
+    } else {
+        sysml2_source_release(&entry->source);
+    }
+}
+
+static void *prefetch_worker(void *arg) {
+    PrefetchQueue *queue = arg;
+
+    for (;;) {
+        pthread_mutex_lock(&queue->lock);
+        if (queue->next >= queue->count) {
+            pthread_mutex_unlock(&queue->lock);
+            break;
+        }
+        PrefetchEntry *job = queue->jobs[queue->next++];
+        pthread_mutex_unlock(&queue->lock);
+
+        run_prefetch_job(job, queue->capture, queue->trace);
+    }
+    return NULL;
+}
+
+/* Parse jobs on up to resolver->jobs threads; the calling thread helps */
+static void run_prefetch_jobs(Sysml2ImportResolver *resolver, PrefetchEntry **jobs, size_t count) {
+    if (count == 0) return;
+
+    PrefetchQueue queue = {
+        .jobs = jobs,
+        .count = count,
+        .capture = resolver->capture,
+        .trace = resolver->trace,
+    };
+    pthread_mutex_init(&queue.lock, NULL);
+
+    size_t wanted = SYSML2_MIN(resolver->jobs, count) - 1;
+    pthread_t *threads = wanted > 0 ? malloc(wanted * sizeof(pthread_t)) : NULL;
+    size_t thread_count = 0;
+    for (size_t t = 0; threads && t < wanted; t++) {
+        if (pthread_create(&threads[thread_count], NULL, prefetch_worker, &queue) != 0) break;
+        thread_count++;
+    }
+
+    prefetch_worker(&queue);
+    for (size_t t = 0; t < thread_count; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    free(threads);
+    pthread_mutex_destroy(&queue.lock);
+}
+
+/*
+ * Parse every file reachable from model's imports that is not cached yet
+ *
+ * Only the package map is consulted: searching the library paths would
+ * fill the negative cache and change what the walk reports, and files
+ * found by searching are rare enough to leave to the walk.
+ */
+static void prefetch_imports(
+    Sysml2ImportResolver *resolver,
+    SysmlSemanticModel *model,
+    Sysml2Prefetch *pf
+) {
+    SysmlSemanticModel **frontier = malloc(sizeof(SysmlSemanticModel *));
+    PrefetchEntry **jobs = NULL;
+    if (!frontier) return;
+    frontier[0] = model;
+    size_t frontier_count = 1;
+
+    sysml2_trace_begin(resolver->trace, "resolve", "prefetch imports", model->source_name);
+
+    while (frontier_count > 0) {
+        /* Next level: import targets not cached or prefetched yet */
+        size_t level_start = pf->count;
+        for (size_t m = 0; m < frontier_count; m++) {
+            for (size_t i = 0; i < frontier[m]->import_count; i++) {
+                SysmlImport *import = frontier[m]->imports[i];
+                if (!import || !import->target) continue;
+
+                char *package_name = extract_package_name(import->target);
+                const char *found = package_name ? lookup_package_file(resolver, package_name) : NULL;
+                free(package_name);
+                if (!found) continue;
+                char *abs_path = sysml2_get_realpath(found);
+                if (!abs_path) abs_path = strdup(found);
+                if (!abs_path) continue;
+
+                if (peek_cached_abs(resolver, abs_path) || prefetch_find(pf, abs_path) ||
+                    !prefetch_add(pf, abs_path)) {
+                    free(abs_path);
+                }
+            }
+        }
+        size_t level_count = pf->count - level_start;
+        if (level_count == 0) break;
+
+        /* Unchanged files come from the model cache, the rest from workers */
+        PrefetchEntry **grown = realloc(jobs, level_count * sizeof(PrefetchEntry *));
+        SysmlSemanticModel **next = realloc(frontier, level_count * sizeof(SysmlSemanticModel *));
+        if (next) frontier = next;
+        if (!grown || !next) {
+            if (grown) jobs = grown;
+            break;
+        }
+        jobs = grown;
+
+        size_t job_count = 0;
+        for (size_t e = level_start; e < pf->count; e++) {
+            PrefetchEntry *entry = &pf->entries[e];
+            if (resolver->model_cache) {
+                entry->model = sysml2_model_cache_load(resolver->model_cache, entry->path);
+                sysml2_trace_instant(resolver->trace, "cache",
+                                     entry->model ? "model cache hit" : "model cache miss",
+                                     entry->path);
+                entry->ready = entry->model != NULL;
+            }
+            if (!entry->ready) jobs[job_count++] = entry;
+        }
+        run_prefetch_jobs(resolver, jobs, job_count);
+
+        /* Rebuild parsed models in discovery order and descend into them */
+        frontier_count = 0;
+        for (size_t e = level_start; e < pf->count; e++) {
+            PrefetchEntry *entry = &pf->entries[e];
+            if (entry->blob) {
+                entry->model = sysml2_model_deserialize(entry->blob, entry->blob_size,
+                                                        resolver->arena, resolver->intern);
+                free(entry->blob);
+                entry->blob = NULL;
+                if (entry->model) {
+                    entry->model->source_name = sysml2_intern(resolver->intern, entry->path);
+                } else {
+                    entry->ready = false;
+                    sysml2_source_release(&entry->source);
+                }
+            }
+            if (entry->ready && entry->model) frontier[frontier_count++] = entry->model;
+        }
+    }
+
+    sysml2_trace_end(resolver->trace);
+    free(frontier);
+    free(jobs);
+}
+
+/*
+ * Hand a file to the walk: from the prefetch if it was parsed ahead,
+ * replaying its output, else by parsing it now
+ */
+static SysmlSemanticModel *take_file(
+    Sysml2ImportResolver *resolver,
+    const char *path,
+    Sysml2DiagContext *diag
+) {
+    PrefetchEntry *entry = resolver->prefetch ? prefetch_find(resolver->prefetch, path) : NULL;
+    if (!entry || !entry->ready || entry->taken) {
+        return parse_file(resolver, path, diag, true);
+    }
+
+    entry->taken = true;
+    if (!entry->parsed) return entry->model;
+
+    if (entry->messages_length > 0) {
+        fwrite(entry->messages, 1, entry->messages_length, stderr);
+    }
+    return finish_parse(resolver, path, diag, &entry->source, entry->model,
+                        entry->error_count, true);
+}
+
+/*
+ * Start reading the files that a model's imports map to, so the walk
+ * finds them in the page cache when it gets to them
+ *
+ * Only the package map is consulted, as in prefetch_imports. Nothing is
+ * read ahead while a prefetch is active (its workers read the files) or
+ * with a model cache (a hit reads its entry, not the source).
+ */
+static void read_ahead_imports(Sysml2ImportResolver *resolver, const SysmlSemanticModel *model) {
+    if (resolver->prefetch || resolver->model_cache) return;
+
+    for (size_t i = 0; i < model->import_count; i++) {
+        SysmlImport *import = model->imports[i];
+        if (!import || !import->target) continue;
+
+        char *package_name = extract_package_name(import->target);
+        const char *found = package_name ? lookup_package_file(resolver, package_name) : NULL;
+        free(package_name);
+        if (found && !peek_cached_abs(resolver, found)) {
+            sysml2_read_ahead(found);
+        }
+    }
+}
+
 /* Resolve imports for a single file (recursive) */
 static Sysml2Result resolve_file_imports(
     Sysml2ImportResolver *resolver,
@@ -716,7 +1250,7 @@ static Sysml2Result resolve_file_imports(
 );
 
 /* Resolve a single import target */
-static Sysml2Result resolve_single_import(
+static Sysml2Result resolve_import_target(
     Sysml2ImportResolver *resolver,
     const char *import_target,
     const char *requesting_file,
@@ -756,6 +1290,7 @@ static Sysml2Result resolve_single_import(
 
     /* Check if already cached (path is already absolute, skip realpath) */
     if (get_cached_abs(resolver, abs_path)) {
+        sysml2_trace_instant(resolver->trace, "cache", "file cache hit", abs_path);
         free(abs_path);
         return SYSML2_OK;
     }
@@ -784,12 +1319,12 @@ static Sysml2Result resolve_single_import(
         return SYSML2_ERROR_OUT_OF_MEMORY;
     }
 
-    /* Parse the file */
-    SysmlSemanticModel *model = parse_file(resolver, abs_path, diag);
+    /* Parse the file, or take it from the prefetch */
+    SysmlSemanticModel *model = take_file(resolver, abs_path, diag);
     if (!model) {
         pop_resolution_stack(resolver);
         free(abs_path);
-        return SYSML2_ERROR_SYNTAX;
+        return sysml2_memory_exceeded() ? SYSML2_ERROR_OUT_OF_MEMORY : SYSML2_ERROR_SYNTAX;
     }
 
     /* Cache the model (path is already absolute, skip realpath) */
@@ -804,6 +1339,20 @@ static Sysml2Result resolve_single_import(
     return result;
 }
 
+/* Resolve one import as a span, so the files it pulls in nest under it */
+static Sysml2Result resolve_single_import(
+    Sysml2ImportResolver *resolver,
+    const char *import_target,
+    const char *requesting_file,
+    Sysml2SourceLoc loc,
+    Sysml2DiagContext *diag
+) {
+    sysml2_trace_begin(resolver->trace, "resolve", import_target, requesting_file);
+    Sysml2Result result = resolve_import_target(resolver, import_target, requesting_file, loc, diag);
+    sysml2_trace_end(resolver->trace);
+    return result;
+}
+
 /* Resolve imports for a model */
 static Sysml2Result resolve_file_imports(
     Sysml2ImportResolver *resolver,
@@ -816,6 +1365,8 @@ static Sysml2Result resolve_file_imports(
         return SYSML2_OK;  /* Nothing to do */
     }
 
+    read_ahead_imports(resolver, model);
+
     /* Process each import */
     Sysml2Result overall_result = SYSML2_OK;
     for (size_t i = 0; i < model->import_count; i++) {
@@ -837,7 +1388,7 @@ static Sysml2Result resolve_file_imports(
     return overall_result;
 }
 
-Sysml2Result sysml2_resolver_resolve_imports(
+static Sysml2Result resolve_model_imports(
     Sysml2ImportResolver *resolver,
     SysmlSemanticModel *model,
     Sysml2DiagContext *diag
@@ -863,6 +1414,8 @@ Sysml2Result sysml2_resolver_resolve_imports(
         return SYSML2_ERROR_OUT_OF_MEMORY;
     }
 
+    read_ahead_imports(resolver, model);
+
     /* Process imports */
     Sysml2Result overall_result = SYSML2_OK;
     for (size_t i = 0; i < model->import_count; i++) {
@@ -889,6 +1442,41 @@ Sysml2Result sysml2_resolver_resolve_imports(
     return overall_result;
 }
 
+Sysml2Result sysml2_resolver_resolve_imports(
+    Sysml2ImportResolver *resolver,
+    SysmlSemanticModel *model,
+    Sysml2DiagContext *diag
+) {
+    Sysml2Stats *stats = resolver ? resolver->stats : NULL;
+    Sysml2Trace *trace = resolver ? resolver->trace : NULL;
+    sysml2_stats_phase_start(stats, SYSML2_PHASE_RESOLVE);
+    sysml2_trace_begin(trace, "resolve", "resolve imports",
+                       model && model->source_name ? model->source_name : NULL);
+
+    /* Parse the whole import graph up front when threads are allowed;
+     * nested calls reuse the outer prefetch */
+    Sysml2Prefetch prefetch = {0};
+    bool own_prefetch = resolver && model && !resolver->disabled &&
+                        resolver->jobs > 1 && !resolver->prefetch;
+    if (own_prefetch) {
+        resolver->prefetch = &prefetch;
+        if (model->source_name) {
+            sysml2_resolver_cache_model(resolver, model->source_name, model);
+        }
+        prefetch_imports(resolver, model, &prefetch);
+    }
+
+    Sysml2Result result = resolve_model_imports(resolver, model, diag);
+
+    if (own_prefetch) {
+        resolver->prefetch = NULL;
+        prefetch_destroy(&prefetch);
+    }
+    sysml2_trace_end(trace);
+    sysml2_stats_phase_stop(stats, SYSML2_PHASE_RESOLVE);
+    return result;
+}
+
 SysmlSemanticModel **sysml2_resolver_get_all_models(
     Sysml2ImportResolver *resolver,
     size_t *count
@@ -925,12 +1513,33 @@ SysmlSemanticModel **sysml2_resolver_get_all_models(
     return models;
 }
 
-/* Recursively load all SysML/KerML files from a directory */
-static void preload_directory(
-    Sysml2ImportResolver *resolver,
+/*
+ * Absolute path of a directory entry. Under a canonical directory, an
+ * entry that is not a symlink is already canonical, which saves the
+ * realpath walk over every path component.
+ */
+static char *entry_abs_path(const char *full_path, bool canonical) {
+    char *abs_path = canonical ? NULL : sysml2_get_realpath(full_path);
+    return abs_path ? abs_path : strdup(full_path);
+}
+
+/* Files of a preload walk, in the order they are parsed */
+typedef struct {
+    char **paths;                /* Absolute paths (owned) */
+    size_t count;
+    size_t capacity;
+} PreloadList;
+
+/* Files being read ahead of the one being parsed while preloading */
+#define PRELOAD_READ_AHEAD 8
+
+/* Recursively list the SysML/KerML files under a directory.
+ * canonical: dir_path is its own realpath. */
+static void list_directory(
     const char *dir_path,
-    Sysml2DiagContext *diag,
-    int max_depth
+    bool canonical,
+    int max_depth,
+    PreloadList *list
 ) {
     if (max_depth <= 0) return;
 
@@ -944,29 +1553,30 @@ static void preload_directory(
             continue;
         }
 
+        bool is_link = false;
+        Sysml2EntryKind kind = sysml2_dir_entry_kind(d, entry, &is_link);
+        if (kind == SYSML2_ENTRY_OTHER) continue;
+        if (kind == SYSML2_ENTRY_FILE && !is_model_file_name(entry->d_name)) continue;
+
         char *full_path = sysml2_path_join(dir_path, entry->d_name);
         if (!full_path) continue;
 
-        if (sysml2_is_directory(full_path)) {
+        if (kind == SYSML2_ENTRY_DIRECTORY) {
             /* Recurse into subdirectory */
-            preload_directory(resolver, full_path, diag, max_depth - 1);
-        } else if (sysml2_is_file(full_path)) {
-            /* Check if it's a SysML or KerML file */
-            size_t len = strlen(entry->d_name);
-            bool is_sysml = (len > 6 && strcmp(entry->d_name + len - 6, ".sysml") == 0);
-            bool is_kerml = (len > 6 && strcmp(entry->d_name + len - 6, ".kerml") == 0);
-
-            if (is_sysml || is_kerml) {
-                char *abs_path = sysml2_get_realpath(full_path);
-                if (!abs_path) abs_path = strdup(full_path);
-
-                if (abs_path && !get_cached_abs(resolver, abs_path)) {
-                    /* Parse and cache the file */
-                    SysmlSemanticModel *model = parse_file(resolver, abs_path, diag);
-                    if (model) {
-                        cache_model_abs(resolver, abs_path, model);
-                    }
+            list_directory(full_path, canonical && !is_link, max_depth - 1, list);
+        } else {
+            char *abs_path = entry_abs_path(full_path, canonical && !is_link);
+            if (abs_path && list->count == list->capacity) {
+                size_t capacity = list->capacity ? list->capacity * 2 : 64;
+                char **paths = realloc(list->paths, capacity * sizeof(char *));
+                if (paths) {
+                    list->paths = paths;
+                    list->capacity = capacity;
                 }
+            }
+            if (abs_path && list->count < list->capacity) {
+                list->paths[list->count++] = abs_path;
+            } else {
                 free(abs_path);
             }
         }
@@ -976,18 +1586,255 @@ static void preload_directory(
     closedir(d);
 }
 
+/*
+ * Recursively load all SysML/KerML files from a directory
+ *
+ * The tree is listed before anything is parsed, so the files can be read
+ * ahead: while one file is parsed, the next PRELOAD_READ_AHEAD are read
+ * into the page cache in the background.
+ *
+ * canonical: dir_path is its own realpath.
+ */
+static void preload_directory(
+    Sysml2ImportResolver *resolver,
+    const char *dir_path,
+    bool canonical,
+    Sysml2DiagContext *diag,
+    int max_depth
+) {
+    PreloadList list = {0};
+    list_directory(dir_path, canonical, max_depth, &list);
+
+    /* A model cache hit reads its entry, not the source */
+    bool read_ahead = !resolver->model_cache;
+    size_t hinted = 0;
+    for (size_t i = 0; i < list.count; i++) {
+        const char *abs_path = list.paths[i];
+        for (; read_ahead && hinted < list.count && hinted <= i + PRELOAD_READ_AHEAD; hinted++) {
+            if (sysml2_memory_exceeded()) break;
+            if (!peek_cached_abs(resolver, list.paths[hinted])) {
+                sysml2_read_ahead(list.paths[hinted]);
+            }
+        }
+
+        if (!get_cached_abs(resolver, abs_path)) {
+            /* Parse and cache the file */
+            SysmlSemanticModel *model = parse_file(resolver, abs_path, diag, true);
+            if (model) {
+                cache_model_abs(resolver, abs_path, model);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < list.count; i++) {
+        free(list.paths[i]);
+    }
+    free(list.paths);
+}
+
+/* ========== Package Discovery ========== */
+
+static bool is_ident_start(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+static bool is_ident_char(char c) {
+    return is_ident_start(c) || (c >= '0' && c <= '9');
+}
+
+/* Skip whitespace and comments. Returns false on an unterminated comment. */
+static bool scan_skip_trivia(const char *text, size_t length, size_t *pos) {
+    size_t i = *pos;
+    while (i < length) {
+        char c = text[i];
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f') {
+            i++;
+        } else if (c == '/' && i + 1 < length && text[i + 1] == '*') {
+            /* Block comment (covers doc comments) */
+            i += 2;
+            while (i + 1 < length && !(text[i] == '*' && text[i + 1] == '/')) i++;
+            if (i + 1 >= length) return false;
+            i += 2;
+        } else if (c == '/' && i + 2 < length && text[i + 1] == '/' && text[i + 2] == '*') {
+            /* Slash-slash-star note, closed like a block comment */
+            i += 3;
+            while (i + 1 < length && !(text[i] == '*' && text[i + 1] == '/')) i++;
+            if (i + 1 >= length) return false;
+            i += 2;
+        } else if (c == '/' && i + 1 < length && text[i + 1] == '/') {
+            while (i < length && text[i] != '\n' && text[i] != '\r') i++;
+        } else {
+            break;
+        }
+    }
+    *pos = i;
+    return true;
+}
+
+/* Skip a quoted string or unrestricted name starting at *pos.
+ * Returns false if unterminated. */
+static bool scan_skip_quoted(const char *text, size_t length, size_t *pos, bool *has_escape) {
+    char quote = text[*pos];
+    size_t i = *pos + 1;
+    while (i < length && text[i] != quote) {
+        if (text[i] == '\\') {
+            if (has_escape) *has_escape = true;
+            i++;
+        }
+        i++;
+    }
+    if (i >= length) return false;
+    *pos = i + 1;
+    return true;
+}
+
+Sysml2PackageScan sysml2_scan_top_level_package(
+    const char *content,
+    size_t length,
+    const char **out_name,
+    size_t *out_length
+) {
+    if (!content) return SYSML2_SCAN_AMBIGUOUS;
+
+    size_t i = 0;
+    int depth = 0;
+    while (i < length) {
+        if (!scan_skip_trivia(content, length, &i)) return SYSML2_SCAN_AMBIGUOUS;
+        if (i >= length) break;
+
+        char c = content[i];
+        if (c == '"' || c == '\'') {
+            if (!scan_skip_quoted(content, length, &i, NULL)) return SYSML2_SCAN_AMBIGUOUS;
+            continue;
+        }
+        if (c == '{') {
+            depth++;
+            i++;
+            continue;
+        }
+        if (c == '}') {
+            if (depth == 0) return SYSML2_SCAN_AMBIGUOUS;
+            depth--;
+            i++;
+            continue;
+        }
+        if (!is_ident_start(c)) {
+            i++;
+            continue;
+        }
+
+        size_t word = i;
+        while (i < length && is_ident_char(content[i])) i++;
+        if (depth != 0 || i - word != 7 || memcmp(content + word, "package", 7) != 0) {
+            continue;
+        }
+
+        /* 'package' is reserved, so at depth 0 it always starts a
+         * (possibly library) package declaration; the name follows. */
+        if (!scan_skip_trivia(content, length, &i) || i >= length) return SYSML2_SCAN_AMBIGUOUS;
+
+        const char *name;
+        size_t name_len;
+        if (is_ident_start(content[i])) {
+            name = content + i;
+            while (i < length && is_ident_char(content[i])) i++;
+            name_len = (size_t)(content + i - name);
+        } else if (content[i] == '\'') {
+            bool has_escape = false;
+            size_t quote_start = i;
+            if (!scan_skip_quoted(content, length, &i, &has_escape) || has_escape) {
+                return SYSML2_SCAN_AMBIGUOUS;
+            }
+            /* The builder strips the quotes but keeps '' as-is */
+            name_len = i - quote_start - 2;
+            if (name_len == 0) return SYSML2_SCAN_AMBIGUOUS;
+            name = content + quote_start + 1;
+        } else {
+            /* Short names (<...>) and anonymous packages */
+            return SYSML2_SCAN_AMBIGUOUS;
+        }
+
+        if (!scan_skip_trivia(content, length, &i) || i >= length) return SYSML2_SCAN_AMBIGUOUS;
+        if (content[i] != '{' && content[i] != ';') return SYSML2_SCAN_AMBIGUOUS;
+
+        *out_name = name;
+        *out_length = name_len;
+        return SYSML2_SCAN_FOUND;
+    }
+
+    return depth == 0 ? SYSML2_SCAN_NO_PACKAGE : SYSML2_SCAN_AMBIGUOUS;
+}
+
+/* Determine the top-level package of a file for discovery.
+ * Uses the scanner and falls back to a full parse only when it is unsure.
+ * Returns false if the file cannot be read. */
+static bool discover_file_package(
+    Sysml2ImportResolver *resolver,
+    const char *abs_path,
+    Sysml2DiagContext *diag,
+    const char **out_package
+) {
+    *out_package = NULL;
+
+    Sysml2SourceBuffer source;
+    if (!sysml2_source_open(abs_path, &source)) return false;
+
+    const char *name = NULL;
+    size_t name_len = 0;
+    Sysml2PackageScan scan = sysml2_scan_top_level_package(source.data, source.length, &name, &name_len);
+    if (scan == SYSML2_SCAN_FOUND) {
+        *out_package = sysml2_intern_n(resolver->intern, name, name_len);
+    }
+    sysml2_source_release(&source);
+
+    if (scan == SYSML2_SCAN_AMBIGUOUS) {
+        /* Only register the package, don't cache the model.
+         * The file will be fully cached when actually imported, so the
+         * throwaway parse is rolled back unless it left diagnostics
+         * (which live in the same arena). */
+        Sysml2ArenaMark mark = sysml2_arena_mark(resolver->arena);
+        Sysml2Diagnostic *last_diag = diag->last;
+
+        SysmlSemanticModel *model = parse_file(resolver, abs_path, diag, false);
+        const char *package = extract_top_level_package(model);
+
+        if (resolver->intern->arena == resolver->arena && diag->last == last_diag) {
+            char *saved = package ? strdup(package) : NULL;
+            if ((saved || !package) && sysml2_intern_rewind(resolver->intern, mark)) {
+                sysml2_arena_rewind(resolver->arena, mark);
+                package = saved ? sysml2_intern(resolver->intern, saved) : NULL;
+            }
+            free(saved);
+        }
+        *out_package = package;
+    }
+    return true;
+}
+
 /* Discover packages in a directory for package map (without full caching).
- * This parses files only to extract package names, doesn't add to validation set. */
+ * Files are scanned for package names and not added to the validation set.
+ * canonical: dir_path is its own realpath.
+ * When index is non-NULL, every scanned directory and file is recorded;
+ * *complete is cleared if something could not be recorded. */
 static void discover_packages_in_directory(
     Sysml2ImportResolver *resolver,
     const char *dir_path,
+    bool canonical,
     Sysml2DiagContext *diag,
-    int max_depth
+    int max_depth,
+    Sysml2PackageIndex *index,
+    bool *complete
 ) {
     if (max_depth <= 0) return;
 
     DIR *d = opendir(dir_path);
-    if (!d) return;
+    if (!d) {
+        *complete = false;
+        return;
+    }
+    if (index && !sysml2_package_index_add(index, dir_path, NULL, 0, true)) {
+        *complete = false;
+    }
 
     struct dirent *entry;
     while ((entry = readdir(d)) != NULL) {
@@ -996,37 +1843,43 @@ static void discover_packages_in_directory(
             continue;
         }
 
+        bool is_link = false;
+        Sysml2EntryKind kind = sysml2_dir_entry_kind(d, entry, &is_link);
+        if (kind == SYSML2_ENTRY_OTHER) continue;
+        if (kind == SYSML2_ENTRY_FILE && !is_model_file_name(entry->d_name)) continue;
+
         char *full_path = sysml2_path_join(dir_path, entry->d_name);
         if (!full_path) continue;
 
-        if (sysml2_is_directory(full_path)) {
+        if (kind == SYSML2_ENTRY_DIRECTORY) {
             /* Recurse into subdirectory */
-            discover_packages_in_directory(resolver, full_path, diag, max_depth - 1);
-        } else if (sysml2_is_file(full_path)) {
-            /* Check if it's a SysML or KerML file */
-            size_t len = strlen(entry->d_name);
-            bool is_sysml = (len > 6 && strcmp(entry->d_name + len - 6, ".sysml") == 0);
-            bool is_kerml = (len > 6 && strcmp(entry->d_name + len - 6, ".kerml") == 0);
-
-            if (is_sysml || is_kerml) {
-                char *abs_path = sysml2_get_realpath(full_path);
-                if (!abs_path) abs_path = strdup(full_path);
-
-                /* Check if package already registered for this file */
-                if (abs_path && !get_cached_abs(resolver, abs_path)) {
-                    /* Parse file just for package discovery */
-                    SysmlSemanticModel *model = parse_file(resolver, abs_path, diag);
-                    if (model) {
-                        /* Only register the package, don't cache the model.
-                         * The file will be fully cached when actually imported. */
-                        const char *pkg_name = extract_top_level_package(model);
-                        if (pkg_name) {
-                            register_package_file(resolver, pkg_name, abs_path);
-                        }
+            discover_packages_in_directory(resolver, full_path, canonical && !is_link, diag,
+                                           max_depth - 1, index, complete);
+        } else {
+            char *abs_path = entry_abs_path(full_path, canonical && !is_link);
+
+            if (abs_path) {
+                /* Files already cached registered their package on insert */
+                SysmlSemanticModel *cached = get_cached_abs(resolver, abs_path);
+                const char *pkg_name = NULL;
+                bool scanned = true;
+                if (cached) {
+                    pkg_name = extract_top_level_package(cached);
+                } else {
+                    scanned = discover_file_package(resolver, abs_path, diag, &pkg_name);
+                    if (pkg_name) {
+                        register_package_file(resolver, pkg_name, abs_path);
+                    }
+                }
+
+                if (index) {
+                    if (!scanned || !sysml2_package_index_add(
+                            index, abs_path, pkg_name, pkg_name ? strlen(pkg_name) : 0, false)) {
+                        *complete = false;
                     }
                 }
-                free(abs_path);
             }
+            free(abs_path);
         }
         free(full_path);
     }
@@ -1034,6 +1887,39 @@ static void discover_packages_in_directory(
     closedir(d);
 }
 
+/* Register packages from an up-to-date stored index, in scan order */
+static void replay_package_index(
+    Sysml2ImportResolver *resolver,
+    const Sysml2PackageIndex *index
+) {
+    for (size_t i = 0; i < index->count; i++) {
+        const Sysml2PackageIndexEntry *entry = &index->entries[i];
+        if (entry->is_directory || !entry->package) continue;
+        if (get_cached_abs(resolver, entry->path)) continue;
+        register_package_file(resolver, sysml2_intern(resolver->intern, entry->package), entry->path);
+    }
+}
+
+/* Record a discovery root; returns false if it was already scanned */
+static bool mark_discovered(Sysml2ImportResolver *resolver, const char *abs_dir) {
+    for (size_t i = 0; i < resolver->discovered_count; i++) {
+        if (strcmp(resolver->discovered_dirs[i], abs_dir) == 0) return false;
+    }
+
+    if (resolver->discovered_count >= resolver->discovered_capacity) {
+        size_t new_capacity = resolver->discovered_capacity ? resolver->discovered_capacity * 2 : 8;
+        char **dirs = realloc(resolver->discovered_dirs, new_capacity * sizeof(char *));
+        if (!dirs) return true;
+        resolver->discovered_dirs = dirs;
+        resolver->discovered_capacity = new_capacity;
+    }
+    char *copy = strdup(abs_dir);
+    if (copy) {
+        resolver->discovered_dirs[resolver->discovered_count++] = copy;
+    }
+    return true;
+}
+
 Sysml2Result sysml2_resolver_preload_libraries(
     Sysml2ImportResolver *resolver,
     Sysml2DiagContext *diag
@@ -1043,30 +1929,219 @@ Sysml2Result sysml2_resolver_preload_libraries(
     /* Skip if already preloaded (idempotent) */
     if (resolver->preloaded) return SYSML2_OK;
 
-    /* Preload all SysML/KerML files from each library path */
-    for (size_t i = 0; i < resolver->path_count; i++) {
+    /* Preload all SysML/KerML files from each library path; after
+     * index_libraries, input directories added since are not libraries */
+    size_t path_count = resolver->libraries_indexed ? resolver->library_path_count
+                                                    : resolver->path_count;
+    sysml2_stats_phase_start(resolver->stats, SYSML2_PHASE_LIBRARIES);
+    for (size_t i = 0; i < path_count; i++) {
         const char *lib_path = resolver->library_paths[i];
         if (resolver->verbose) {
             fprintf(stderr, "note: preloading library files from %s\n", lib_path);
         }
-        preload_directory(resolver, lib_path, diag, 10);
+        /* add_path stores the realpath unless it could not be resolved */
+        char *real = sysml2_get_realpath(lib_path);
+        bool canonical = real && strcmp(real, lib_path) == 0;
+        free(real);
+
+        sysml2_trace_begin(resolver->trace, "resolve", "preload", lib_path);
+        preload_directory(resolver, lib_path, canonical, diag, 10);
+        sysml2_trace_end(resolver->trace);
     }
+    sysml2_stats_phase_stop(resolver->stats, SYSML2_PHASE_LIBRARIES);
 
     resolver->preloaded = true;
     return SYSML2_OK;
 }
 
-Sysml2Result sysml2_resolver_discover_packages(
+static Sysml2Result discover_packages(
     Sysml2ImportResolver *resolver,
     const char *dir_path,
     Sysml2DiagContext *diag
 ) {
-    if (!resolver || !dir_path) return SYSML2_ERROR_SEMANTIC;
+
+    char *abs_dir = sysml2_get_realpath(dir_path);
+    if (!abs_dir) abs_dir = strdup(dir_path);
+    if (!abs_dir) return SYSML2_ERROR_OUT_OF_MEMORY;
+
+    /* Several input files usually share a directory */
+    if (!mark_discovered(resolver, abs_dir)) {
+        free(abs_dir);
+        return SYSML2_OK;
+    }
+
+    Sysml2PackageIndex index;
+    if (resolver->model_cache &&
+        sysml2_model_cache_load_package_index(resolver->model_cache, abs_dir, &index)) {
+        if (resolver->verbose) {
+            fprintf(stderr, "note: using cached package index for %s\n", dir_path);
+        }
+        replay_package_index(resolver, &index);
+        sysml2_package_index_free(&index);
+        free(abs_dir);
+        return SYSML2_OK;
+    }
 
     if (resolver->verbose) {
         fprintf(stderr, "note: discovering packages in %s\n", dir_path);
     }
-    discover_packages_in_directory(resolver, dir_path, diag, 10);
 
+    bool complete = true;
+    Sysml2PackageIndex *record = resolver->model_cache ? &index : NULL;
+    discover_packages_in_directory(resolver, abs_dir, true, diag, 10, record, &complete);
+
+    if (record) {
+        /* Failing to write the index is not an error; the next run rescans */
+        if (complete) {
+            sysml2_model_cache_store_package_index(resolver->model_cache, abs_dir, record);
+        }
+        sysml2_package_index_free(record);
+    }
+
+    free(abs_dir);
     return SYSML2_OK;
 }
+
+Sysml2Result sysml2_resolver_discover_packages(
+    Sysml2ImportResolver *resolver,
+    const char *dir_path,
+    Sysml2DiagContext *diag
+) {
+    if (!resolver || !dir_path) return SYSML2_ERROR_SEMANTIC;
+
+    sysml2_stats_phase_start(resolver->stats, SYSML2_PHASE_LIBRARIES);
+    sysml2_trace_begin(resolver->trace, "resolve", "discover packages", dir_path);
+    Sysml2Result result = discover_packages(resolver, dir_path, diag);
+    sysml2_trace_end(resolver->trace);
+    sysml2_stats_phase_stop(resolver->stats, SYSML2_PHASE_LIBRARIES);
+    return result;
+}
+
+Sysml2Result sysml2_resolver_index_libraries(
+    Sysml2ImportResolver *resolver,
+    Sysml2DiagContext *diag
+) {
+    if (!resolver) return SYSML2_ERROR_SEMANTIC;
+
+    if (resolver->libraries_indexed) return SYSML2_OK;
+
+    Sysml2Result result = SYSML2_OK;
+    for (size_t i = 0; i < resolver->path_count && result == SYSML2_OK; i++) {
+        result = sysml2_resolver_discover_packages(resolver, resolver->library_paths[i], diag);
+    }
+    resolver->libraries_indexed = true;
+    resolver->library_path_count = resolver->path_count;
+    return result;
+}
+
+/* Whether an absolute path lies under one of the library paths */
+static bool is_library_file(const Sysml2ImportResolver *resolver, const char *abs_path) {
+    for (size_t i = 0; i < resolver->library_path_count; i++) {
+        const char *lib = resolver->library_paths[i];
+        size_t len = strlen(lib);
+        if (strncmp(abs_path, lib, len) == 0 && (abs_path[len] == '/' || lib[len - 1] == '/')) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Load the library file of a reference's first segment, if not yet cached */
+static bool load_reference_package(
+    Sysml2ImportResolver *resolver,
+    const SysmlSemanticModel *model,
+    const char *ref,
+    Sysml2SourceLoc loc,
+    Sysml2DiagContext *diag
+) {
+    if (!ref) return false;
+    if (*ref == '~') ref++;
+
+    size_t length = 0;
+    while (ref[length] && ref[length] != '.' &&
+           !(ref[length] == ':' && ref[length + 1] == ':')) {
+        length++;
+    }
+    char segment[256];
+    if (length == 0 || length >= sizeof(segment)) return false;
+    memcpy(segment, ref, length);
+    segment[length] = '\0';
+
+    /* Only packages the index put in a library file not parsed yet */
+    const char *path = lookup_package_file(resolver, segment);
+    if (!path || peek_cached_abs(resolver, path) || !is_library_file(resolver, path)) {
+        return false;
+    }
+
+    resolve_single_import(resolver, segment, model->source_name, loc, diag);
+    return peek_cached_abs(resolver, path) != NULL;
+}
+
+static bool load_reference_packages(
+    Sysml2ImportResolver *resolver,
+    const SysmlSemanticModel *model,
+    const char **refs,
+    size_t count,
+    Sysml2SourceLoc loc,
+    Sysml2DiagContext *diag
+) {
+    bool loaded = false;
+    for (size_t i = 0; i < count; i++) {
+        loaded |= load_reference_package(resolver, model, refs[i], loc, diag);
+    }
+    return loaded;
+}
+
+/* One pass over every cached model; returns whether anything was loaded */
+static bool load_referenced_round(Sysml2ImportResolver *resolver, Sysml2DiagContext *diag) {
+    size_t model_count;
+    SysmlSemanticModel **models = sysml2_resolver_get_all_models(resolver, &model_count);
+    if (!models) return false;
+
+    bool loaded = false;
+    for (size_t m = 0; m < model_count && !sysml2_diag_should_stop(diag); m++) {
+        const SysmlSemanticModel *model = models[m];
+        for (size_t i = 0; i < model->element_count; i++) {
+            const SysmlNode *node = model->elements[i];
+            if (!node) continue;
+            loaded |= load_reference_packages(resolver, model, node->typed_by,
+                                              node->typed_by_count, node->loc, diag);
+            loaded |= load_reference_packages(resolver, model, node->specializes,
+                                              node->specializes_count, node->loc, diag);
+            loaded |= load_reference_packages(resolver, model, node->redefines,
+                                              node->redefines_count, node->loc, diag);
+            loaded |= load_reference_packages(resolver, model, node->references,
+                                              node->references_count, node->loc, diag);
+        }
+        for (size_t i = 0; i < model->relationship_count; i++) {
+            const SysmlRelationship *rel = model->relationships[i];
+            if (!rel) continue;
+            loaded |= load_reference_package(resolver, model, rel->source, rel->loc, diag);
+            loaded |= load_reference_package(resolver, model, rel->target, rel->loc, diag);
+        }
+    }
+
+    free(models);
+    return loaded;
+}
+
+size_t sysml2_resolver_load_referenced(
+    Sysml2ImportResolver *resolver,
+    Sysml2DiagContext *diag
+) {
+    if (!resolver || resolver->disabled) return 0;
+
+    size_t before = resolver->file_cache_count;
+    sysml2_stats_phase_start(resolver->stats, SYSML2_PHASE_LIBRARIES);
+    sysml2_trace_begin(resolver->trace, "resolve", "load referenced", NULL);
+
+    /* Files loaded in one round may name further packages */
+    bool more = true;
+    while (more) {
+        more = load_referenced_round(resolver, diag) && !sysml2_diag_should_stop(diag);
+    }
+
+    sysml2_trace_end(resolver->trace);
+    sysml2_stats_phase_stop(resolver->stats, SYSML2_PHASE_LIBRARIES);
+    return resolver->file_cache_count - before;
+}
@@ -5,20 +5,61 @@
  */
 
 #include "sysml2/intern.h"
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-/* FNV-1a hash constants */
-#define FNV_OFFSET_BASIS 2166136261u
-#define FNV_PRIME 16777619u
+/* Smallest table ever allocated */
+#define INTERN_MIN_CAPACITY 16
+
+/* Hash mixing constants (64-bit golden ratio and splitmix64 finalizer) */
+#define HASH_SEED 0x9E3779B97F4A7C15ull
+#define HASH_MUL1 0xBF58476D1CE4E5B9ull
+#define HASH_MUL2 0x94D049BB133111EBull
+
+static uint64_t load_word(const char *p) {
+    uint64_t word;
+    memcpy(&word, p, sizeof(word));
+    return word;
+}
+
+static uint64_t mix_word(uint64_t hash, uint64_t word) {
+    hash ^= word;
+    hash *= HASH_MUL1;
+    return hash ^ (hash >> 29);
+}
 
 uint32_t sysml2_hash_string(const char *str, size_t length) {
-    uint32_t hash = FNV_OFFSET_BASIS;
-    for (size_t i = 0; i < length; i++) {
-        hash ^= (uint8_t)str[i];
-        hash *= FNV_PRIME;
+    uint64_t hash = HASH_SEED ^ ((uint64_t)length * HASH_MUL2);
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        hash = mix_word(hash, load_word(str + i));
+    }
+
+    /* Tail: 0-7 remaining bytes */
+    if (i < length) {
+        uint64_t tail = 0;
+        memcpy(&tail, str + i, length - i);
+        hash = mix_word(hash, tail);
     }
-    return hash;
+
+    /* Final avalanche */
+    hash ^= hash >> 31;
+    hash *= HASH_MUL2;
+    hash ^= hash >> 32;
+    return (uint32_t)hash;
+}
+
+/* Round up to a power of two (at least INTERN_MIN_CAPACITY) */
+static size_t round_capacity(size_t capacity) {
+    size_t result = INTERN_MIN_CAPACITY;
+    while (result < capacity) result *= 2;
+    return result;
+}
+
+/* Slot count needed to hold count strings under the load factor */
+static size_t capacity_for_count(size_t count) {
+    return round_capacity(count / SYSML2_INTERN_MAX_LOAD_PERCENT * 100 + 100);
 }
 
 void sysml2_intern_init(Sysml2Intern *intern, Sysml2Arena *arena) {
@@ -27,52 +68,131 @@ void sysml2_intern_init(Sysml2Intern *intern, Sysml2Arena *arena) {
 
 void sysml2_intern_init_with_capacity(Sysml2Intern *intern, Sysml2Arena *arena, size_t capacity) {
     intern->arena = arena;
-    intern->capacity = capacity;
     intern->count = 0;
-    intern->buckets = sysml2_arena_calloc(arena, capacity, sizeof(Sysml2InternEntry *));
+    intern->capacity = round_capacity(capacity);
+    intern->slots = calloc(intern->capacity, sizeof(Sysml2InternSlot));
+    if (!intern->slots) intern->capacity = 0;
+    intern->journal = NULL;
+    intern->journal_count = 0;
+    intern->journal_capacity = 0;
 }
 
 void sysml2_intern_destroy(Sysml2Intern *intern) {
-    /* Entries are in the arena, nothing to free */
-    intern->buckets = NULL;
+    /* Strings are in the arena; only the slot array is ours */
+    free(intern->slots);
+    intern->slots = NULL;
     intern->capacity = 0;
     intern->count = 0;
+    free(intern->journal);
+    intern->journal = NULL;
+    intern->journal_count = 0;
+    intern->journal_capacity = 0;
+}
+
+/* Rehash all slots into a table of new_capacity slots */
+static bool intern_resize(Sysml2Intern *intern, size_t new_capacity) {
+    Sysml2InternSlot *slots = calloc(new_capacity, sizeof(Sysml2InternSlot));
+    if (!slots) return false;
+
+    size_t mask = new_capacity - 1;
+    for (size_t i = 0; i < intern->capacity; i++) {
+        const Sysml2InternSlot *slot = &intern->slots[i];
+        if (!slot->data) continue;
+        size_t index = slot->hash & mask;
+        while (slots[index].data) index = (index + 1) & mask;
+        slots[index] = *slot;
+    }
+
+    free(intern->slots);
+    intern->slots = slots;
+    intern->capacity = new_capacity;
+    return true;
+}
+
+bool sysml2_intern_reserve(Sysml2Intern *intern, size_t expected_count) {
+    if (!intern->slots) return false;
+    size_t needed = capacity_for_count(expected_count);
+    if (needed <= intern->capacity) return true;
+    return intern_resize(intern, needed);
+}
+
+/* Probe for a string; returns the matching or first empty slot index */
+static size_t probe(const Sysml2Intern *intern, const char *str, size_t length, uint32_t hash) {
+    size_t mask = intern->capacity - 1;
+    size_t index = hash & mask;
+    for (;;) {
+        const Sysml2InternSlot *slot = &intern->slots[index];
+        if (!slot->data) return index;
+        if (slot->hash == hash && slot->length == length &&
+            memcmp(slot->data, str, length) == 0) {
+            return index;
+        }
+        index = (index + 1) & mask;
+    }
+}
+
+static void journal_push(Sysml2Intern *intern, const Sysml2InternSlot *slot) {
+    if (intern->journal_count == intern->journal_capacity) {
+        size_t capacity = intern->journal_capacity * 2;
+        Sysml2InternSlot *grown = realloc(intern->journal, capacity * sizeof(Sysml2InternSlot));
+        if (!grown) {
+            free(intern->journal);
+            intern->journal = NULL;
+            intern->journal_count = 0;
+            intern->journal_capacity = 0;
+            return;
+        }
+        intern->journal = grown;
+        intern->journal_capacity = capacity;
+    }
+    intern->journal[intern->journal_count++] = *slot;
+}
+
+/* Empty a slot, moving later members of its probe run back into the hole */
+static void remove_slot(Sysml2Intern *intern, size_t index) {
+    size_t mask = intern->capacity - 1;
+    size_t hole = index;
+    for (size_t i = (hole + 1) & mask; intern->slots[i].data; i = (i + 1) & mask) {
+        /* A slot may fill the hole unless its home lies after the hole */
+        size_t home = intern->slots[i].hash & mask;
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            intern->slots[hole] = intern->slots[i];
+            hole = i;
+        }
+    }
+    intern->slots[hole] = (Sysml2InternSlot){0};
+    intern->count--;
 }
 
 /* Find or create an entry for a string */
 static const char *intern_impl(Sysml2Intern *intern, const char *str, size_t length) {
-    if (!intern->buckets) return NULL;
+    if (!intern->slots || length > UINT32_MAX) return NULL;
 
     uint32_t hash = sysml2_hash_string(str, length);
-    size_t index = hash % intern->capacity;
-
-    /* Search existing entries */
-    for (Sysml2InternEntry *entry = intern->buckets[index]; entry; entry = entry->next) {
-        if (entry->hash == hash && entry->length == length) {
-            if (memcmp(entry->data, str, length) == 0) {
-                return entry->data;
-            }
-        }
+    size_t index = probe(intern, str, length, hash);
+    if (intern->slots[index].data) {
+        return intern->slots[index].data;
     }
 
-    /* Allocate new entry */
-    Sysml2InternEntry *new_entry = sysml2_arena_alloc(
-        intern->arena,
-        sizeof(Sysml2InternEntry) + length + 1
-    );
-    if (!new_entry) return NULL;
-
-    new_entry->hash = hash;
-    new_entry->length = length;
-    memcpy(new_entry->data, str, length);
-    new_entry->data[length] = '\0';
-
-    /* Insert at head of bucket */
-    new_entry->next = intern->buckets[index];
-    intern->buckets[index] = new_entry;
+    /* Grow before inserting past the load factor */
+    if ((intern->count + 1) * 100 > intern->capacity * SYSML2_INTERN_MAX_LOAD_PERCENT) {
+        if (!intern_resize(intern, intern->capacity * 2)) return NULL;
+        index = probe(intern, str, length, hash);
+    }
+
+    char *data = sysml2_arena_alloc_aligned(intern->arena, length + 1, 1);
+    if (!data) return NULL;
+    memcpy(data, str, length);
+    data[length] = '\0';
+
+    Sysml2InternSlot *slot = &intern->slots[index];
+    slot->hash = hash;
+    slot->length = (uint32_t)length;
+    slot->data = data;
     intern->count++;
 
-    return new_entry->data;
+    if (intern->journal) journal_push(intern, slot);
+    return data;
 }
 
 const char *sysml2_intern(Sysml2Intern *intern, const char *str) {
@@ -92,20 +212,10 @@ const char *sysml2_intern_sv(Sysml2Intern *intern, Sysml2StringView sv) {
 
 /* Lookup without inserting */
 static const char *lookup_impl(const Sysml2Intern *intern, const char *str, size_t length) {
-    if (!intern->buckets) return NULL;
+    if (!intern->slots || length > UINT32_MAX) return NULL;
 
     uint32_t hash = sysml2_hash_string(str, length);
-    size_t index = hash % intern->capacity;
-
-    for (Sysml2InternEntry *entry = intern->buckets[index]; entry; entry = entry->next) {
-        if (entry->hash == hash && entry->length == length) {
-            if (memcmp(entry->data, str, length) == 0) {
-                return entry->data;
-            }
-        }
-    }
-
-    return NULL;
+    return intern->slots[probe(intern, str, length, hash)].data;
 }
 
 const char *sysml2_intern_lookup(const Sysml2Intern *intern, const char *str) {
@@ -121,3 +231,53 @@ const char *sysml2_intern_lookup_sv(const Sysml2Intern *intern, Sysml2StringView
 size_t sysml2_intern_count(const Sysml2Intern *intern) {
     return intern->count;
 }
+
+void sysml2_intern_start_journal(Sysml2Intern *intern) {
+    if (intern->journal) return;
+    intern->journal = malloc(INTERN_MIN_CAPACITY * sizeof(Sysml2InternSlot));
+    intern->journal_capacity = intern->journal ? INTERN_MIN_CAPACITY : 0;
+    intern->journal_count = 0;
+}
+
+bool sysml2_intern_rewind(Sysml2Intern *intern, Sysml2ArenaMark mark) {
+    if (!intern->slots) return true;
+
+    /* Strings are copied into the arena as they are added, so the ones
+     * since the mark are the journal's tail */
+    if (intern->journal) {
+        while (intern->journal_count > 0) {
+            const Sysml2InternSlot *entry = &intern->journal[intern->journal_count - 1];
+            if (!sysml2_arena_allocated_since(intern->arena, mark, entry->data)) break;
+            remove_slot(intern, probe(intern, entry->data, entry->length, entry->hash));
+            intern->journal_count--;
+        }
+        return true;
+    }
+
+    /* Dropping entries would break probe chains, so rebuild from survivors */
+    Sysml2InternSlot *slots = calloc(intern->capacity, sizeof(Sysml2InternSlot));
+    if (!slots) return false;
+
+    size_t mask = intern->capacity - 1;
+    size_t count = 0;
+    for (size_t i = 0; i < intern->capacity; i++) {
+        const Sysml2InternSlot *slot = &intern->slots[i];
+        if (!slot->data) continue;
+        if (sysml2_arena_allocated_since(intern->arena, mark, slot->data)) continue;
+        size_t index = slot->hash & mask;
+        while (slots[index].data) index = (index + 1) & mask;
+        slots[index] = *slot;
+        count++;
+    }
+
+    free(intern->slots);
+    intern->slots = slots;
+    intern->count = count;
+    return true;
+}
+
+void sysml2_intern_contract_failure(const char *a, const char *b) {
+    fprintf(stderr, "sysml2: internal error: identifier '%s' compared by pointer "
+            "but not interned (%p vs %p)\n", a, (const void *)a, (const void *)b);
+    abort();
+}
@@ -8,26 +8,88 @@
 #include "sysml2/query.h"
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 /* JSON output version */
 #define SYSML_JSON_VERSION "1.0"
 
+/* Output buffer size; large exports are dominated by stdio overhead */
+#define JSON_BUFFER_SIZE (64 * 1024)
+
+/* Spaces available to one bulk indent copy */
+#define JSON_INDENT_CHUNK 64
+
+/* Query arrays shorter than this are always written on one thread */
+#define JSON_PARALLEL_MIN_ITEMS 2048
+
+/* Items per chunk rendered by a worker thread */
+#define JSON_CHUNK_ITEMS 1024
+
 /*
  * Internal writer state
+ *
+ * Output is collected in buffer and handed to the stream with one
+ * fwrite per JSON_BUFFER_SIZE bytes.
  */
 typedef struct {
     FILE *out;
     const Sysml2JsonOptions *options;
     int indent_level;
+    size_t length;                  /* Bytes pending in buffer */
+    char buffer[JSON_BUFFER_SIZE];
 } JsonWriter;
 
+static void json_writer_init(JsonWriter *w, FILE *out, const Sysml2JsonOptions *options) {
+    w->out = out;
+    w->options = options;
+    w->indent_level = 0;
+    w->length = 0;
+}
+
+static void json_flush(JsonWriter *w) {
+    if (w->length > 0) {
+        fwrite(w->buffer, 1, w->length, w->out);
+        w->length = 0;
+    }
+}
+
+static void json_write(JsonWriter *w, const char *data, size_t length) {
+    if (length > JSON_BUFFER_SIZE - w->length) {
+        json_flush(w);
+        if (length >= JSON_BUFFER_SIZE) {
+            fwrite(data, 1, length, w->out);
+            return;
+        }
+    }
+    memcpy(w->buffer + w->length, data, length);
+    w->length += length;
+}
+
+SYSML2_INLINE void json_putc(JsonWriter *w, char c) {
+    if (w->length == JSON_BUFFER_SIZE) json_flush(w);
+    w->buffer[w->length++] = c;
+}
+
+SYSML2_INLINE void json_puts(JsonWriter *w, const char *str) {
+    json_write(w, str, strlen(str));
+}
+
 /*
  * Write indentation
  */
 static void write_indent(JsonWriter *w) {
     if (!w->options->pretty) return;
-    for (int i = 0; i < w->indent_level * w->options->indent_size; i++) {
-        fputc(' ', w->out);
+    static const char spaces[JSON_INDENT_CHUNK + 1] =
+        "                                                                ";
+    size_t width = (size_t)(w->indent_level * w->options->indent_size);
+    while (width > 0) {
+        size_t n = width < JSON_INDENT_CHUNK ? width : JSON_INDENT_CHUNK;
+        json_write(w, spaces, n);
+        width -= n;
     }
 }
 
@@ -36,10 +98,37 @@ static void write_indent(JsonWriter *w) {
  */
 static void write_newline(JsonWriter *w) {
     if (w->options->pretty) {
-        fputc('\n', w->out);
+        json_putc(w, '\n');
     }
 }
 
+/*
+ * Length of the prefix of str[0..length) that needs no escaping:
+ * no '"', '\\' or control character
+ */
+static size_t json_plain_prefix(const char *str, size_t length) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control_max = _mm_set1_epi8(0x1F);
+    for (; i + 16 <= length; i += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)(const void *)(str + i));
+        /* Unsigned c <= 0x1F  <=>  min(c, 0x1F) == c */
+        __m128i special = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+            _mm_cmpeq_epi8(_mm_min_epu8(chunk, control_max), chunk));
+        int mask = _mm_movemask_epi8(special);
+        if (mask) return i + (size_t)__builtin_ctz((unsigned)mask);
+    }
+#endif
+    for (; i < length; i++) {
+        unsigned char c = (unsigned char)str[i];
+        if (c < 0x20 || c == '"' || c == '\\') break;
+    }
+    return i;
+}
+
 /*
  * Escape a string for JSON output
  */
@@ -83,32 +172,42 @@ size_t sysml2_json_escape_string(const char *str, char *out, size_t out_size) {
 
 /*
  * Write an escaped string with quotes
+ *
+ * Runs that need no escaping are copied in bulk.
  */
 static void write_string(JsonWriter *w, const char *str) {
-    fputc('"', w->out);
+    json_putc(w, '"');
     if (str) {
-        /* Write escaped content */
-        for (const char *p = str; *p; p++) {
-            char c = *p;
+        size_t length = strlen(str);
+        size_t i = 0;
+        while (i < length) {
+            size_t plain = json_plain_prefix(str + i, length - i);
+            json_write(w, str + i, plain);
+            i += plain;
+            if (i == length) break;
+
+            char c = str[i++];
             switch (c) {
-                case '"':  fputs("\\\"", w->out); break;
-                case '\\': fputs("\\\\", w->out); break;
-                case '\n': fputs("\\n", w->out); break;
-                case '\r': fputs("\\r", w->out); break;
-                case '\t': fputs("\\t", w->out); break;
-                case '\f': fputs("\\f", w->out); break;
-                case '\b': fputs("\\b", w->out); break;
-                default:
-                    if ((unsigned char)c < 0x20) {
-                        fprintf(w->out, "\\u%04x", (unsigned char)c);
-                    } else {
-                        fputc(c, w->out);
-                    }
+                case '"':  json_write(w, "\\\"", 2); break;
+                case '\\': json_write(w, "\\\\", 2); break;
+                case '\n': json_write(w, "\\n", 2); break;
+                case '\r': json_write(w, "\\r", 2); break;
+                case '\t': json_write(w, "\\t", 2); break;
+                case '\f': json_write(w, "\\f", 2); break;
+                case '\b': json_write(w, "\\b", 2); break;
+                default: {
+                    /* Remaining control characters */
+                    static const char hex[] = "0123456789abcdef";
+                    char escape[6] = {'\\', 'u', '0', '0',
+                                      hex[((unsigned char)c >> 4) & 0xF],
+                                      hex[(unsigned char)c & 0xF]};
+                    json_write(w, escape, sizeof(escape));
                     break;
+                }
             }
         }
     }
-    fputc('"', w->out);
+    json_putc(w, '"');
 }
 
 /*
@@ -116,16 +215,16 @@ static void write_string(JsonWriter *w, const char *str) {
  */
 static void write_string_field(JsonWriter *w, const char *key, const char *value, bool comma) {
     if (comma) {
-        fputc(',', w->out);
+        json_putc(w, ',');
         write_newline(w);
     }
     write_indent(w);
     write_string(w, key);
-    fputs(": ", w->out);
+    json_puts(w, ": ");
     if (value) {
         write_string(w, value);
     } else {
-        fputs("null", w->out);
+        json_puts(w, "null");
     }
 }
 
@@ -135,19 +234,19 @@ static void write_string_field(JsonWriter *w, const char *key, const char *value
 static void write_string_array_field(JsonWriter *w, const char *key,
                                       const char **values, size_t count, bool comma) {
     if (comma) {
-        fputc(',', w->out);
+        json_putc(w, ',');
         write_newline(w);
     }
     write_indent(w);
     write_string(w, key);
-    fputs(": [", w->out);
+    json_puts(w, ": [");
 
     for (size_t i = 0; i < count; i++) {
-        if (i > 0) fputs(", ", w->out);
+        if (i > 0) json_puts(w, ", ");
         write_string(w, values[i]);
     }
 
-    fputc(']', w->out);
+    json_putc(w, ']');
 }
 
 /*
@@ -155,7 +254,7 @@ static void write_string_array_field(JsonWriter *w, const char *key,
  */
 static void write_meta(JsonWriter *w, const SysmlSemanticModel *model) {
     write_indent(w);
-    fputs("\"meta\": {", w->out);
+    json_puts(w, "\"meta\": {");
     write_newline(w);
     w->indent_level++;
 
@@ -168,15 +267,16 @@ static void write_meta(JsonWriter *w, const SysmlSemanticModel *model) {
     write_newline(w);
     w->indent_level--;
     write_indent(w);
-    fputc('}', w->out);
+    json_putc(w, '}');
 }
 
 /*
  * Write a single element
  */
 static void write_element(JsonWriter *w, const SysmlNode *node) {
+    const SysmlNodeCold *cold = sysml2_node_cold(node);
     write_indent(w);
-    fputc('{', w->out);
+    json_putc(w, '{');
     write_newline(w);
     w->indent_level++;
 
@@ -213,52 +313,52 @@ static void write_element(JsonWriter *w, const SysmlNode *node) {
     }
 
     /* prefixMetadata (if present) */
-    if (node->prefix_metadata && node->prefix_metadata_count > 0) {
-        write_string_array_field(w, "prefixMetadata", node->prefix_metadata, node->prefix_metadata_count, true);
+    if (cold->prefix_metadata && cold->prefix_metadata_count > 0) {
+        write_string_array_field(w, "prefixMetadata", cold->prefix_metadata, cold->prefix_metadata_count, true);
     }
 
     /* metadata (if present) */
-    if (node->metadata && node->metadata_count > 0) {
-        fputc(',', w->out);
+    if (cold->metadata && cold->metadata_count > 0) {
+        json_putc(w, ',');
         write_newline(w);
         write_indent(w);
-        fputs("\"metadata\": [", w->out);
-        for (size_t i = 0; i < node->metadata_count; i++) {
-            SysmlMetadataUsage *m = node->metadata[i];
+        json_puts(w, "\"metadata\": [");
+        for (size_t i = 0; i < cold->metadata_count; i++) {
+            SysmlMetadataUsage *m = cold->metadata[i];
             if (!m) continue;
-            if (i > 0) fputc(',', w->out);
+            if (i > 0) json_putc(w, ',');
             write_newline(w);
             write_indent(w);
-            fputs("  { \"type\": ", w->out);
+            json_puts(w, "  { \"type\": ");
             write_string(w, m->type_ref);
             if (m->feature_count > 0) {
-                fputs(", \"features\": {", w->out);
+                json_puts(w, ", \"features\": {");
                 for (size_t j = 0; j < m->feature_count; j++) {
                     SysmlMetadataFeature *f = m->features[j];
                     if (!f) continue;
-                    if (j > 0) fputc(',', w->out);
-                    fputc(' ', w->out);
+                    if (j > 0) json_putc(w, ',');
+                    json_putc(w, ' ');
                     write_string(w, f->name);
-                    fputs(": ", w->out);
+                    json_puts(w, ": ");
                     if (f->value) {
                         write_string(w, f->value);
                     } else {
-                        fputs("null", w->out);
+                        json_puts(w, "null");
                     }
                 }
-                fputs(" }", w->out);
+                json_puts(w, " }");
             }
-            fputs(" }", w->out);
+            json_puts(w, " }");
         }
         write_newline(w);
         write_indent(w);
-        fputc(']', w->out);
+        json_putc(w, ']');
     }
 
     write_newline(w);
     w->indent_level--;
     write_indent(w);
-    fputc('}', w->out);
+    json_putc(w, '}');
 }
 
 /*
@@ -266,13 +366,13 @@ static void write_element(JsonWriter *w, const SysmlNode *node) {
  */
 static void write_elements(JsonWriter *w, const SysmlSemanticModel *model) {
     write_indent(w);
-    fputs("\"elements\": [", w->out);
+    json_puts(w, "\"elements\": [");
     write_newline(w);
     w->indent_level++;
 
     for (size_t i = 0; i < model->element_count; i++) {
         if (i > 0) {
-            fputc(',', w->out);
+            json_putc(w, ',');
             write_newline(w);
         }
         write_element(w, model->elements[i]);
@@ -281,7 +381,7 @@ static void write_elements(JsonWriter *w, const SysmlSemanticModel *model) {
     write_newline(w);
     w->indent_level--;
     write_indent(w);
-    fputc(']', w->out);
+    json_putc(w, ']');
 }
 
 /*
@@ -289,7 +389,7 @@ static void write_elements(JsonWriter *w, const SysmlSemanticModel *model) {
  */
 static void write_relationship(JsonWriter *w, const SysmlRelationship *rel) {
     write_indent(w);
-    fputc('{', w->out);
+    json_putc(w, '{');
     write_newline(w);
     w->indent_level++;
 
@@ -308,7 +408,7 @@ static void write_relationship(JsonWriter *w, const SysmlRelationship *rel) {
     write_newline(w);
     w->indent_level--;
     write_indent(w);
-    fputc('}', w->out);
+    json_putc(w, '}');
 }
 
 /*
@@ -316,13 +416,13 @@ static void write_relationship(JsonWriter *w, const SysmlRelationship *rel) {
  */
 static void write_relationships(JsonWriter *w, const SysmlSemanticModel *model) {
     write_indent(w);
-    fputs("\"relationships\": [", w->out);
+    json_puts(w, "\"relationships\": [");
     write_newline(w);
     w->indent_level++;
 
     for (size_t i = 0; i < model->relationship_count; i++) {
         if (i > 0) {
-            fputc(',', w->out);
+            json_putc(w, ',');
             write_newline(w);
         }
         write_relationship(w, model->relationships[i]);
@@ -331,7 +431,7 @@ static void write_relationships(JsonWriter *w, const SysmlSemanticModel *model)
     write_newline(w);
     w->indent_level--;
     write_indent(w);
-    fputc(']', w->out);
+    json_putc(w, ']');
 }
 
 /*
@@ -352,67 +452,65 @@ Sysml2Result sysml2_json_write(
         options = &default_opts;
     }
 
-    JsonWriter w = {
-        .out = out,
-        .options = options,
-        .indent_level = 0
-    };
+    /* Not zero-initialized: the buffer is only read up to length */
+    JsonWriter w;
+    json_writer_init(&w, out, options);
 
     /* Write root object */
-    fputc('{', w.out);
+    json_putc(&w, '{');
     write_newline(&w);
     w.indent_level++;
 
     /* Meta section */
     write_meta(&w, model);
-    fputc(',', w.out);
+    json_putc(&w, ',');
     write_newline(&w);
 
     /* File-level metadata array (if any) */
     if (model->file_metadata_count > 0) {
         write_indent(&w);
-        fputs("\"fileMetadata\": [", w.out);
+        json_puts(&w, "\"fileMetadata\": [");
         write_newline(&w);
         w.indent_level++;
 
         for (size_t i = 0; i < model->file_metadata_count; i++) {
             SysmlMetadataUsage *m = model->file_metadata[i];
             if (!m) continue;
-            if (i > 0) fputc(',', w.out);
+            if (i > 0) json_putc(&w, ',');
             write_newline(&w);
             write_indent(&w);
-            fputs("{ \"type\": ", w.out);
+            json_puts(&w, "{ \"type\": ");
             write_string(&w, m->type_ref);
             if (m->feature_count > 0) {
-                fputs(", \"features\": {", w.out);
+                json_puts(&w, ", \"features\": {");
                 for (size_t j = 0; j < m->feature_count; j++) {
                     SysmlMetadataFeature *f = m->features[j];
                     if (!f) continue;
-                    if (j > 0) fputc(',', w.out);
-                    fputc(' ', w.out);
+                    if (j > 0) json_putc(&w, ',');
+                    json_putc(&w, ' ');
                     write_string(&w, f->name);
-                    fputs(": ", w.out);
+                    json_puts(&w, ": ");
                     if (f->value) {
                         write_string(&w, f->value);
                     } else {
-                        fputs("null", w.out);
+                        json_puts(&w, "null");
                     }
                 }
-                fputs(" }", w.out);
+                json_puts(&w, " }");
             }
-            fputs(" }", w.out);
+            json_puts(&w, " }");
         }
         write_newline(&w);
         w.indent_level--;
         write_indent(&w);
-        fputc(']', w.out);
-        fputc(',', w.out);
+        json_putc(&w, ']');
+        json_putc(&w, ',');
         write_newline(&w);
     }
 
     /* Elements array */
     write_elements(&w, model);
-    fputc(',', w.out);
+    json_putc(&w, ',');
     write_newline(&w);
 
     /* Relationships array */
@@ -422,9 +520,10 @@ Sysml2Result sysml2_json_write(
     /* Close root object */
     w.indent_level--;
     write_indent(&w);
-    fputc('}', w.out);
+    json_putc(&w, '}');
     write_newline(&w);
 
+    json_flush(&w);
     return SYSML2_OK;
 }
 
@@ -466,7 +565,7 @@ Sysml2Result sysml2_json_write_string(
  */
 static void write_query_meta(JsonWriter *w) {
     write_indent(w);
-    fputs("\"meta\": {", w->out);
+    json_puts(w, "\"meta\": {");
     write_newline(w);
     w->indent_level++;
 
@@ -476,53 +575,197 @@ static void write_query_meta(JsonWriter *w) {
     write_newline(w);
     w->indent_level--;
     write_indent(w);
-    fputc('}', w->out);
+    json_putc(w, '}');
 }
 
 /*
- * Write query elements array
+ * Write query array items [start, end): elements, or relationships if
+ * relationships is set, each after a separator unless it is the first
  */
-static void write_query_elements(JsonWriter *w, const Sysml2QueryResult *result) {
-    write_indent(w);
-    fputs("\"elements\": [", w->out);
-    write_newline(w);
-    w->indent_level++;
-
-    for (size_t i = 0; i < result->element_count; i++) {
+static void write_query_items(
+    JsonWriter *w,
+    const Sysml2QueryResult *result,
+    bool relationships,
+    size_t start,
+    size_t end
+) {
+    for (size_t i = start; i < end; i++) {
         if (i > 0) {
-            fputc(',', w->out);
+            json_putc(w, ',');
             write_newline(w);
         }
-        write_element(w, result->elements[i]);
+        if (relationships) {
+            write_relationship(w, result->relationships[i]);
+        } else {
+            write_element(w, result->elements[i]);
+        }
     }
+}
 
-    write_newline(w);
-    w->indent_level--;
-    write_indent(w);
-    fputc(']', w->out);
+/* A range of query array items rendered into memory by a worker thread */
+typedef struct {
+    size_t start, end;
+    char *text;                  /* Rendered JSON (malloc'd) */
+    size_t length;
+    bool failed;
+    bool done;
+} JsonChunk;
+
+/* Work queue shared by chunk rendering threads */
+typedef struct {
+    const Sysml2QueryResult *result;
+    const Sysml2JsonOptions *options;
+    bool relationships;
+    int indent_level;            /* Level the items are written at */
+    JsonChunk *chunks;
+    size_t count;
+    size_t next;                 /* Next chunk to hand out */
+    pthread_mutex_t lock;
+    pthread_cond_t chunk_done;
+} JsonChunkQueue;
+
+static void render_chunk(const JsonChunkQueue *queue, JsonChunk *chunk) {
+    FILE *out = open_memstream(&chunk->text, &chunk->length);
+    if (!out) {
+        chunk->failed = true;
+        return;
+    }
+
+    /* Heap-allocated: the buffer is too large for a worker's stack */
+    JsonWriter *w = malloc(sizeof(JsonWriter));
+    if (w) {
+        json_writer_init(w, out, queue->options);
+        w->indent_level = queue->indent_level;
+        write_query_items(w, queue->result, queue->relationships, chunk->start, chunk->end);
+        json_flush(w);
+        free(w);
+    } else {
+        chunk->failed = true;
+    }
+    if (fclose(out) != 0) chunk->failed = true;
+}
+
+static void *chunk_worker(void *arg) {
+    JsonChunkQueue *queue = arg;
+
+    for (;;) {
+        pthread_mutex_lock(&queue->lock);
+        if (queue->next >= queue->count) {
+            pthread_mutex_unlock(&queue->lock);
+            break;
+        }
+        JsonChunk *chunk = &queue->chunks[queue->next++];
+        pthread_mutex_unlock(&queue->lock);
+
+        render_chunk(queue, chunk);
+
+        pthread_mutex_lock(&queue->lock);
+        chunk->done = true;
+        pthread_cond_broadcast(&queue->chunk_done);
+        pthread_mutex_unlock(&queue->lock);
+    }
+    return NULL;
 }
 
 /*
- * Write query relationships array
+ * Write query array items [0, count) in chunks rendered on worker
+ * threads, concatenated in order
+ *
+ * @return false if no thread could be started (nothing was written)
  */
-static void write_query_relationships(JsonWriter *w, const Sysml2QueryResult *result) {
+static bool write_query_items_parallel(
+    JsonWriter *w,
+    const Sysml2QueryResult *result,
+    bool relationships,
+    size_t count
+) {
+    JsonChunkQueue queue = {
+        .result = result,
+        .options = w->options,
+        .relationships = relationships,
+        .indent_level = w->indent_level,
+        .count = (count + JSON_CHUNK_ITEMS - 1) / JSON_CHUNK_ITEMS,
+    };
+    size_t thread_limit = SYSML2_MIN(w->options->jobs, queue.count);
+    queue.chunks = calloc(queue.count, sizeof(JsonChunk));
+    pthread_t *threads = malloc(thread_limit * sizeof(pthread_t));
+    if (!queue.chunks || !threads) {
+        free(queue.chunks);
+        free(threads);
+        return false;
+    }
+    for (size_t c = 0; c < queue.count; c++) {
+        queue.chunks[c].start = c * JSON_CHUNK_ITEMS;
+        queue.chunks[c].end = SYSML2_MIN(count, (c + 1) * JSON_CHUNK_ITEMS);
+    }
+
+    pthread_mutex_init(&queue.lock, NULL);
+    pthread_cond_init(&queue.chunk_done, NULL);
+    size_t thread_count = 0;
+    for (size_t t = 0; t < thread_limit; t++) {
+        if (pthread_create(&threads[thread_count], NULL, chunk_worker, &queue) != 0) break;
+        thread_count++;
+    }
+    if (thread_count == 0) {
+        pthread_cond_destroy(&queue.chunk_done);
+        pthread_mutex_destroy(&queue.lock);
+        free(queue.chunks);
+        free(threads);
+        return false;
+    }
+
+    /* Chunks go out in order as they finish; one that failed to render
+     * is redone here so the output stays complete */
+    json_flush(w);
+    for (size_t c = 0; c < queue.count; c++) {
+        JsonChunk *chunk = &queue.chunks[c];
+        pthread_mutex_lock(&queue.lock);
+        while (!chunk->done) pthread_cond_wait(&queue.chunk_done, &queue.lock);
+        pthread_mutex_unlock(&queue.lock);
+
+        if (chunk->failed) {
+            write_query_items(w, result, relationships, chunk->start, chunk->end);
+            json_flush(w);
+        } else {
+            fwrite(chunk->text, 1, chunk->length, w->out);
+        }
+        free(chunk->text);
+    }
+
+    for (size_t t = 0; t < thread_count; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    pthread_cond_destroy(&queue.chunk_done);
+    pthread_mutex_destroy(&queue.lock);
+    free(queue.chunks);
+    free(threads);
+    return true;
+}
+
+/*
+ * Write a query array ("elements" or "relationships")
+ */
+static void write_query_array(
+    JsonWriter *w,
+    const Sysml2QueryResult *result,
+    bool relationships
+) {
+    size_t count = relationships ? result->relationship_count : result->element_count;
+
     write_indent(w);
-    fputs("\"relationships\": [", w->out);
+    json_puts(w, relationships ? "\"relationships\": [" : "\"elements\": [");
     write_newline(w);
     w->indent_level++;
 
-    for (size_t i = 0; i < result->relationship_count; i++) {
-        if (i > 0) {
-            fputc(',', w->out);
-            write_newline(w);
-        }
-        write_relationship(w, result->relationships[i]);
+    bool parallel = w->options->jobs > 1 && count >= JSON_PARALLEL_MIN_ITEMS;
+    if (!parallel || !write_query_items_parallel(w, result, relationships, count)) {
+        write_query_items(w, result, relationships, 0, count);
     }
 
     write_newline(w);
     w->indent_level--;
     write_indent(w);
-    fputc(']', w->out);
+    json_putc(w, ']');
 }
 
 /*
@@ -543,36 +786,135 @@ Sysml2Result sysml2_json_write_query(
         options = &default_opts;
     }
 
-    JsonWriter w = {
-        .out = out,
-        .options = options,
-        .indent_level = 0
-    };
+    /* Not zero-initialized: the buffer is only read up to length */
+    JsonWriter w;
+    json_writer_init(&w, out, options);
 
     /* Write root object */
-    fputc('{', w.out);
+    json_putc(&w, '{');
     write_newline(&w);
     w.indent_level++;
 
     /* Meta section */
     write_query_meta(&w);
-    fputc(',', w.out);
+    json_putc(&w, ',');
     write_newline(&w);
 
     /* Elements array */
-    write_query_elements(&w, result);
-    fputc(',', w.out);
+    write_query_array(&w, result, false);
+    json_putc(&w, ',');
     write_newline(&w);
 
     /* Relationships array */
-    write_query_relationships(&w, result);
+    write_query_array(&w, result, true);
     write_newline(&w);
 
     /* Close root object */
     w.indent_level--;
     write_indent(&w);
-    fputc('}', w.out);
+    json_putc(&w, '}');
     write_newline(&w);
 
+    json_flush(&w);
+    return SYSML2_OK;
+}
+
+/* ========== NDJSON ========== */
+
+/*
+ * Write a single import
+ */
+static void write_import(JsonWriter *w, const SysmlImport *imp) {
+    json_putc(w, '{');
+    write_string_field(w, "id", imp->id, false);
+    write_string_field(w, "type", sysml2_kind_to_json_type(imp->kind), true);
+    write_string_field(w, "target", imp->target, true);
+    write_string_field(w, "owner", imp->owner_scope, true);
+    json_puts(w, imp->is_private ? ",\"private\": true" : ",\"private\": false");
+    json_putc(w, '}');
+}
+
+static void write_ndjson_elements(JsonWriter *w, SysmlNode **elements, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        json_puts(w, "{\"element\": ");
+        write_element(w, elements[i]);
+        json_puts(w, "}\n");
+    }
+}
+
+static void write_ndjson_relationships(JsonWriter *w, SysmlRelationship **rels, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        json_puts(w, "{\"relationship\": ");
+        write_relationship(w, rels[i]);
+        json_puts(w, "}\n");
+    }
+}
+
+static void write_ndjson_imports(JsonWriter *w, SysmlImport **imports, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        json_puts(w, "{\"import\": ");
+        write_import(w, imports[i]);
+        json_puts(w, "}\n");
+    }
+}
+
+/*
+ * Write the semantic model as NDJSON to a file
+ */
+Sysml2Result sysml2_json_write_ndjson(
+    const SysmlSemanticModel *model,
+    FILE *out,
+    const Sysml2JsonOptions *options
+) {
+    if (!model || !out) {
+        return SYSML2_ERROR_SYNTAX;
+    }
+
+    /* One record per line: never indent */
+    Sysml2JsonOptions line_opts = SYSML_JSON_OPTIONS_DEFAULT;
+    if (options) line_opts = *options;
+    line_opts.pretty = false;
+
+    JsonWriter w;
+    json_writer_init(&w, out, &line_opts);
+
+    json_putc(&w, '{');
+    write_meta(&w, model);
+    json_puts(&w, "}\n");
+
+    write_ndjson_elements(&w, model->elements, model->element_count);
+    write_ndjson_relationships(&w, model->relationships, model->relationship_count);
+    write_ndjson_imports(&w, model->imports, model->import_count);
+
+    json_flush(&w);
+    return SYSML2_OK;
+}
+
+/*
+ * Write a query result as NDJSON to a file
+ */
+Sysml2Result sysml2_json_write_query_ndjson(
+    const Sysml2QueryResult *result,
+    FILE *out
+) {
+    if (!result || !out) {
+        return SYSML2_ERROR_SYNTAX;
+    }
+
+    Sysml2JsonOptions line_opts = SYSML_JSON_OPTIONS_DEFAULT;
+    line_opts.pretty = false;
+
+    JsonWriter w;
+    json_writer_init(&w, out, &line_opts);
+
+    json_putc(&w, '{');
+    write_query_meta(&w);
+    json_puts(&w, "}\n");
+
+    write_ndjson_elements(&w, result->elements, result->element_count);
+    write_ndjson_relationships(&w, result->relationships, result->relationship_count);
+    write_ndjson_imports(&w, result->imports, result->import_count);
+
+    json_flush(&w);
     return SYSML2_OK;
 }
@@ -0,0 +1,27 @@
+/*
+ * SysML v2 Parser - Keyword Hash
+ *
+ * Seeded hash used by the generated perfect-hash keyword table. Shared by
+ * keywords.c and tools/gen_keywords.c so both agree on every slot.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef SYSML2_KEYWORD_HASH_H
+#define SYSML2_KEYWORD_HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+static inline uint32_t sysml2_keyword_hash(uint32_t seed, const char *str, size_t length) {
+    uint32_t hash = seed ^ (uint32_t)length;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ (unsigned char)str[i]) * 0x01000193u;
+    }
+    hash ^= hash >> 15;
+    hash *= 0x2C1B3C6Du;
+    hash ^= hash >> 12;
+    return hash;
+}
+
+#endif /* SYSML2_KEYWORD_HASH_H */
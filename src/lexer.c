@@ -285,9 +285,6 @@ void sysml2_lexer_init(
     lexer->token_column = 1;
 
     lexer->had_error = false;
-
-    /* Initialize keyword table */
-    sysml2_keywords_init();
 }
 
 Sysml2Token sysml2_lexer_next(Sysml2Lexer *lexer) {
@@ -13,7 +13,10 @@
 #include "sysml2/sysml_writer.h"
 #include "sysml2/query.h"
 #include "sysml2/modify.h"
+#include "sysml2/server.h"
+#include "sysml2/daemon.h"
 #include "sysml2/utils.h"
+#include "sysml2/memory_budget.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -22,47 +25,48 @@
 #include <errno.h>
 #include <limits.h>
 #include <unistd.h>
+#include <pthread.h>
 
 /*
  * Helper: Atomic file write using temp file + rename
  *
  * This prevents file truncation if an error occurs during writing.
  * The original file remains intact until the write completes successfully.
- *
- * verbose_msg: NULL to suppress message, or message prefix like "Formatted" or "Modified"
+ * Errors are reported to err, so worker threads can buffer them.
  */
-static bool atomic_write_file(
+static bool atomic_write_data(
     const char *path,
-    SysmlSemanticModel *model,
-    const char *verbose_msg
+    const char *data,
+    size_t length,
+    FILE *err
 ) {
     char tmp_path[PATH_MAX];
     int len = snprintf(tmp_path, sizeof(tmp_path), "%s.tmp.%d", path, getpid());
     if (len < 0 || (size_t)len >= sizeof(tmp_path)) {
-        fprintf(stderr, "error: path too long for temp file: %s\n", path);
+        fprintf(err, "error: path too long for temp file: %s\n", path);
         return false;
     }
 
     /* Write to temp file */
     FILE *out = fopen(tmp_path, "w");
     if (!out) {
-        fprintf(stderr, "error: cannot create temp file '%s': %s\n",
+        fprintf(err, "error: cannot create temp file '%s': %s\n",
                 tmp_path, strerror(errno));
         return false;
     }
 
-    sysml2_sysml_write(model, out);
+    fwrite(data, 1, length, out);
 
     /* Check for write errors before closing */
     if (ferror(out)) {
-        fprintf(stderr, "error: write failed to temp file '%s'\n", tmp_path);
+        fprintf(err, "error: write failed to temp file '%s'\n", tmp_path);
         fclose(out);
         unlink(tmp_path);
         return false;
     }
 
     if (fclose(out) != 0) {
-        fprintf(stderr, "error: failed to close temp file '%s': %s\n",
+        fprintf(err, "error: failed to close temp file '%s': %s\n",
                 tmp_path, strerror(errno));
         unlink(tmp_path);
         return false;
@@ -70,33 +74,61 @@ static bool atomic_write_file(
 
     /* Atomic rename - this preserves original file until this succeeds */
     if (rename(tmp_path, path) != 0) {
-        fprintf(stderr, "error: failed to rename temp file '%s' to '%s': %s\n",
+        fprintf(err, "error: failed to rename temp file '%s' to '%s': %s\n",
                 tmp_path, path, strerror(errno));
         unlink(tmp_path);
         return false;
     }
 
-    if (verbose_msg) {
-        fprintf(stderr, "%s: %s\n", verbose_msg, path);
+    return true;
+}
+
+/*
+ * Helper: Format a model and write it atomically over path
+ *
+ * verbose_msg: NULL to suppress message, or message prefix like "Formatted" or "Modified"
+ */
+static bool atomic_write_file(
+    const char *path,
+    SysmlSemanticModel *model,
+    const char *verbose_msg
+) {
+    char *text = NULL;
+    if (sysml2_sysml_write_string(model, &text) != SYSML2_OK) {
+        fprintf(stderr, "error: out of memory formatting '%s'\n", path);
+        return false;
     }
 
-    return true;
+    bool ok = atomic_write_data(path, text, strlen(text), stderr);
+    free(text);
+
+    if (ok && verbose_msg) {
+        fprintf(stderr, "%s: %s\n", verbose_msg, path);
+    }
+    return ok;
 }
 
 /* Long options for getopt_long */
 static const struct option long_options[] = {
     {"output",       required_argument, 0, 'o'},
     {"format",       required_argument, 0, 'f'},
+    {"compact",      no_argument,       0, 'c' + 256},
     {"select",       required_argument, 0, 's'},
+    {"select-users", required_argument, 0, 'u' + 256},
+    {"users-depth",  required_argument, 0, 'U' + 256},
     {"fix",          no_argument,       0, 'F'},
     {"color",        optional_argument, 0, 'c'},
+    {"diagnostics-format", required_argument, 0, 'G' + 256},
     {"max-errors",   required_argument, 0, 'm'},
     {"dump-tokens",  no_argument,       0, 'T'},
     {"dump-ast",     no_argument,       0, 'A'},
     {"verbose",      no_argument,       0, 'v'},
     {"parse-only",   no_argument,       0, 'P'},
     {"no-validate",  no_argument,       0, 'P'},  /* alias for --parse-only */
+    {"validate",     no_argument,       0, 'V' + 256},
+    {"syntax-only",  no_argument,       0, 'Y' + 256},
     {"no-resolve",   no_argument,       0, 'R'},
+    {"lazy-libraries", no_argument,     0, 'L' + 256},
     {"recursive",    no_argument,       0, 'r'},
     {"set",          required_argument, 0, 'S'},
     {"at",           required_argument, 0, 'a'},
@@ -107,12 +139,21 @@ static const struct option long_options[] = {
     {"dry-run",      no_argument,       0, 'D'},
     {"allow-semantic-errors", no_argument, 0, 'e'},
     {"list",         no_argument,       0, 'l'},
+    {"jobs",         required_argument, 0, 'j'},
+    {"cache-dir",    required_argument, 0, 'K' + 256},
+    {"clear-cache",  no_argument,       0, 'X' + 256},
+    {"serve",        no_argument,       0, 's' + 256},
+    {"batch",        no_argument,       0, 'B' + 256},
+    {"daemon",       required_argument, 0, 'D' + 256},
+    {"stats",        optional_argument, 0, 't' + 256},
+    {"trace",        required_argument, 0, 'T' + 256},
+    {"memory-limit", required_argument, 0, 'M' + 256},
     {"help",         no_argument,       0, 'h'},
     {"version",      no_argument,       0, 'V'},
     {0, 0, 0, 0}
 };
 
-static const char *short_options = "o:f:s:W:I:S:a:d:hVvTAPFRCDrel";
+static const char *short_options = "o:f:s:W:I:S:a:d:j:hVvTAPFRCDrel";
 
 /* Parse color mode from string */
 static Sysml2ColorMode parse_color_mode(const char *arg) {
@@ -134,6 +175,10 @@ static Sysml2OutputFormat parse_output_format(const char *arg) {
         return SYSML2_OUTPUT_XML;
     } else if (strcmp(arg, "sysml") == 0) {
         return SYSML2_OUTPUT_SYSML;
+    } else if (strcmp(arg, "binary") == 0) {
+        return SYSML2_OUTPUT_BINARY;
+    } else if (strcmp(arg, "ndjson") == 0) {
+        return SYSML2_OUTPUT_NDJSON;
     }
     return SYSML2_OUTPUT_NONE;
 }
@@ -143,9 +188,12 @@ Sysml2Result sysml2_cli_parse(Sysml2CliOptions *options, int argc, char **argv)
     memset(options, 0, sizeof(*options));
     options->color_mode = SYSML2_COLOR_AUTO;
     options->max_errors = 20;
+    options->jobs = 1;
+    options->users_depth = 1;
 
     int opt;
     int option_index = 0;
+    optind = 1;  /* A --daemon request parses a second command line */
 
     while ((opt = getopt_long(argc, argv, short_options, long_options, &option_index)) != -1) {
         switch (opt) {
@@ -161,6 +209,21 @@ Sysml2Result sysml2_cli_parse(Sysml2CliOptions *options, int argc, char **argv)
                 options->color_mode = parse_color_mode(optarg);
                 break;
 
+            case 'G' + 256:  /* --diagnostics-format */
+                if (strcmp(optarg, "text") == 0) {
+                    options->diag_format = SYSML2_DIAG_FORMAT_TEXT;
+                } else if (strcmp(optarg, "json") == 0) {
+                    options->diag_format = SYSML2_DIAG_FORMAT_JSON;
+                } else {
+                    fprintf(stderr, "error: invalid --diagnostics-format '%s'\n", optarg);
+                    return SYSML2_ERROR_SYNTAX;
+                }
+                break;
+
+            case 'c' + 256:  /* --compact */
+                options->compact_json = true;
+                break;
+
             case 'm':
                 options->max_errors = (size_t)atoi(optarg);
                 break;
@@ -187,6 +250,17 @@ Sysml2Result sysml2_cli_parse(Sysml2CliOptions *options, int argc, char **argv)
                 options->parse_only = true;
                 break;
 
+            case 'V' + 256:  /* --validate */
+                options->validate_queries = true;
+                break;
+
+            case 'Y' + 256:  /* --syntax-only */
+                /* No model means nothing to resolve or validate */
+                options->syntax_only = true;
+                options->parse_only = true;
+                options->no_resolve = true;
+                break;
+
             case 'F':
                 options->fix_in_place = true;
                 break;
@@ -219,10 +293,39 @@ Sysml2Result sysml2_cli_parse(Sysml2CliOptions *options, int argc, char **argv)
                 options->select_patterns[options->select_pattern_count++] = optarg;
                 break;
 
+            case 'u' + 256:  /* --select-users */
+                if (options->users_pattern_count >= options->users_pattern_capacity) {
+                    size_t new_cap = options->users_pattern_capacity == 0 ? 8 : options->users_pattern_capacity * 2;
+                    const char **new_patterns = realloc((void *)options->users_patterns, new_cap * sizeof(char *));
+                    if (!new_patterns) {
+                        return SYSML2_ERROR_OUT_OF_MEMORY;
+                    }
+                    options->users_patterns = new_patterns;
+                    options->users_pattern_capacity = new_cap;
+                }
+                options->users_patterns[options->users_pattern_count++] = optarg;
+                break;
+
+            case 'U' + 256: {  /* --users-depth */
+                char *end = NULL;
+                errno = 0;
+                unsigned long depth = strtoul(optarg, &end, 10);
+                if (errno != 0 || !end || *end != '\0' || optarg[0] == '-') {
+                    fprintf(stderr, "error: invalid --users-depth '%s'\n", optarg);
+                    return SYSML2_ERROR_SYNTAX;
+                }
+                options->users_depth = depth;
+                break;
+            }
+
             case 'R':
                 options->no_resolve = true;
                 break;
 
+            case 'L' + 256:  /* --lazy-libraries */
+                options->lazy_libraries = true;
+                break;
+
             case 'S':
                 /* --set: Add fragment to pending set operation */
                 if (options->set_count >= options->set_capacity) {
@@ -295,6 +398,66 @@ Sysml2Result sysml2_cli_parse(Sysml2CliOptions *options, int argc, char **argv)
                 options->list_mode = true;
                 break;
 
+            case 'j': {
+                char *end = NULL;
+                errno = 0;
+                unsigned long jobs = strtoul(optarg, &end, 10);
+                if (errno != 0 || !end || *end != '\0' || optarg[0] == '-') {
+                    fprintf(stderr, "error: invalid job count '%s'\n", optarg);
+                    return SYSML2_ERROR_SYNTAX;
+                }
+                if (jobs == 0) {
+                    /* -j 0: one parser thread per online CPU */
+                    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+                    jobs = cpus > 0 ? (unsigned long)cpus : 1;
+                }
+                options->jobs = jobs;
+                break;
+            }
+
+            case 'K' + 256:  /* --cache-dir */
+                options->cache_dir = optarg;
+                break;
+
+            case 'X' + 256:  /* --clear-cache */
+                options->clear_cache = true;
+                break;
+
+            case 's' + 256:  /* --serve */
+                options->serve_mode = true;
+                break;
+
+            case 'B' + 256:  /* --batch */
+                options->batch_mode = true;
+                break;
+
+            case 'D' + 256:  /* --daemon */
+                options->daemon_socket = optarg;
+                break;
+
+            case 't' + 256:  /* --stats[=json] */
+                if (!optarg || strcmp(optarg, "text") == 0) {
+                    options->stats_format = SYSML2_STATS_TEXT;
+                } else if (strcmp(optarg, "json") == 0) {
+                    options->stats_format = SYSML2_STATS_JSON;
+                } else {
+                    fprintf(stderr, "error: invalid --stats format '%s'\n", optarg);
+                    return SYSML2_ERROR_SYNTAX;
+                }
+                break;
+
+            case 'T' + 256:  /* --trace */
+                options->trace_path = optarg;
+                break;
+
+            case 'M' + 256:  /* --memory-limit */
+                if (!sysml2_memory_parse_size(optarg, &options->memory_limit) ||
+                    options->memory_limit == 0) {
+                    fprintf(stderr, "error: invalid memory limit '%s'\n", optarg);
+                    return SYSML2_ERROR_SYNTAX;
+                }
+                break;
+
             case 'h':
                 options->show_help = true;
                 return SYSML2_OK;
@@ -309,6 +472,11 @@ Sysml2Result sysml2_cli_parse(Sysml2CliOptions *options, int argc, char **argv)
         }
     }
 
+    if (options->users_pattern_count > 0 && options->select_pattern_count > 0) {
+        fprintf(stderr, "error: --select-users cannot be combined with --select\n");
+        return SYSML2_ERROR_SYNTAX;
+    }
+
     /* Collect input files */
     int file_count = argc - optind;
     if (file_count > 0) {
@@ -316,6 +484,25 @@ Sysml2Result sysml2_cli_parse(Sysml2CliOptions *options, int argc, char **argv)
         options->input_file_count = file_count;
     }
 
+    /* Comments and doc text are only read when SysML is written; a
+     * daemon's libraries serve requests with any output */
+    bool writes_sysml = options->output_format == SYSML2_OUTPUT_SYSML || options->fix_in_place ||
+                        options->delete_pattern_count > 0 || options->set_count > 0;
+    options->trim_models = !writes_sysml && !options->daemon_socket;
+
+    /* --list and --select read only the input files' own elements, so
+     * unless --validate asks for a full run they skip the libraries,
+     * import resolution and validation. --select-users needs everything
+     * loaded, and the modes that rewrite files need validation. */
+    bool input_query = (options->list_mode || options->select_pattern_count > 0) &&
+                       options->users_pattern_count == 0 && !options->fix_in_place &&
+                       options->set_count == 0 && options->delete_pattern_count == 0 &&
+                       !options->serve_mode && !options->batch_mode && !options->daemon_socket;
+    if (input_query && !options->validate_queries) {
+        options->parse_only = true;
+        options->no_resolve = true;
+    }
+
     return SYSML2_OK;
 }
 
@@ -328,6 +515,10 @@ void sysml2_cli_cleanup(Sysml2CliOptions *options) {
         free((void *)options->select_patterns);
         options->select_patterns = NULL;
     }
+    if (options->users_patterns) {
+        free((void *)options->users_patterns);
+        options->users_patterns = NULL;
+    }
     if (options->set_fragments) {
         free((void *)options->set_fragments);
         options->set_fragments = NULL;
@@ -352,24 +543,49 @@ void sysml2_cli_print_help(FILE *output) {
         "\n"
         "Options:\n"
         "  -o, --output <file>    Write output to file\n"
-        "  -f, --format <fmt>     Output format: json, xml, sysml (default: none)\n"
+        "  -f, --format <fmt>     Output format: json, ndjson, xml, sysml, binary\n"
+        "      --compact          Write JSON without indentation or newlines\n"
         "  -s, --select <pattern> Filter output to matching elements (repeatable)\n"
+        "      --select-users <pattern>\n"
+        "                         Output the elements that use matching elements (repeatable)\n"
+        "      --users-depth <n>  Follow users of users n levels deep (default: 1, 0 = all)\n"
         "  -l, --list             List element names and kinds (discovery mode)\n"
         "  -I <path>              Add library search path for imports\n"
         "  -r, --recursive        Recursively load all .sysml files from directory\n"
+        "  -j, --jobs <n>         Parse, validate, format and --fix with n threads (0 = all CPUs)\n"
         "      --fix              Format and rewrite files in place\n"
         "  -P, --parse-only       Parse only, skip semantic validation\n"
         "      --no-validate      Same as --parse-only\n"
+        "      --validate         Resolve imports and validate with --list and --select\n"
+        "                         (which otherwise only parse the input files)\n"
+        "      --syntax-only      Only check that the input parses (no AST, no output)\n"
         "      --no-resolve       Disable automatic import resolution\n"
+        "      --lazy-libraries   Parse only the library files that imports and\n"
+        "                         qualified names refer to\n"
+        "      --cache-dir <dir>  Cache parsed files and validation results in <dir>\n"
+        "      --clear-cache      Remove all entries from the cache directory\n"
+        "      --serve            Run a workspace server (JSON-RPC on stdin/stdout)\n"
+        "      --batch            Validate each file or document listed on stdin,\n"
+        "                         one JSON result line per document\n"
+        "      --daemon <socket>  Load libraries once and run commands sent by clients\n"
+        "                         that have " SYSML2_DAEMON_ENV "=<socket> set\n"
         "  --color[=when]         Colorize output (auto, always, never)\n"
         "  --max-errors <n>       Stop after n errors (default: 20)\n"
+        "  --diagnostics-format <fmt>\n"
+        "                         Diagnostics as text (default) or json, one object per line\n"
         "  -W<warning>            Enable warning (e.g., -Werror)\n"
         "  --dump-tokens          Dump lexer tokens\n"
         "  --dump-ast             Dump parsed AST\n"
         "  -v, --verbose          Verbose output\n"
+        "      --stats[=json]     Print per-phase timing and memory to stderr\n"
+        "      --trace <file>     Write parse/import/validation spans as trace JSON\n"
+        "      --memory-limit <n> Fail cleanly once models hold more than n bytes\n"
+        "                         (K, M and G suffixes allowed)\n"
         "  -h, --help             Show help\n"
         "  --version              Show version\n"
         "\n"
+    );
+    fprintf(output,
         "Modification options:\n"
         "  --set <file> --at <scope>  Insert elements from file into scope\n"
         "  --delete <pattern>         Delete elements matching pattern (repeatable)\n"
@@ -387,6 +603,7 @@ void sysml2_cli_print_help(FILE *output) {
         "\n"
         "Environment:\n"
         "  SYSML2_LIBRARY_PATH    Colon-separated list of library search paths\n"
+        "  " SYSML2_DAEMON_ENV "          Run commands through the --daemon on this socket\n"
         "\n"
         "Examples:\n"
         "  sysml2 model.kerml              Validate a KerML file\n"
@@ -402,6 +619,7 @@ void sysml2_cli_print_help(FILE *output) {
         "  sysml2 --list -r ~/model/           List root elements\n"
         "  sysml2 --list -s 'Pkg::*' model.sysml  List children of Pkg\n"
         "  sysml2 --list -f json model.sysml   JSON summary output\n"
+        "  sysml2 --list --select-users 'Pkg::Engine' --users-depth 0 -r ~/model/\n"
         "\n"
         "Modification examples:\n"
         "  sysml2 --delete 'Pkg::OldElement' model.sysml\n"
@@ -610,6 +828,135 @@ static void write_element_list(
     }
 }
 
+/* One input file formatted by --fix */
+typedef struct {
+    const char *path;
+    const SysmlSemanticModel *model;
+    char *messages;              /* Buffered stderr output (malloc'd) */
+    size_t messages_length;
+    bool changed;                /* Formatting differs from the file */
+    bool failed;
+} FixJob;
+
+/* Work queue shared by --fix worker threads */
+typedef struct {
+    FixJob *jobs;
+    size_t count;
+    size_t next;                 /* Next job to hand out */
+    Sysml2Trace *trace;
+    pthread_mutex_t lock;
+} FixQueue;
+
+/* Format one model in memory and rewrite its file only if that changes it */
+static void run_fix_job(FixJob *job, Sysml2Trace *trace) {
+    FILE *msg = open_memstream(&job->messages, &job->messages_length);
+    if (!msg) {
+        job->failed = true;
+        return;
+    }
+
+    sysml2_trace_begin(trace, "write", "format", job->path);
+    char *text = NULL;
+    if (sysml2_sysml_write_string(job->model, &text) != SYSML2_OK) {
+        fprintf(msg, "error: out of memory formatting '%s'\n", job->path);
+        job->failed = true;
+    } else {
+        /* The parsed content is still mapped; compare against it instead
+         * of rereading the file */
+        const Sysml2SourceFile *sf = job->model->source_file;
+        size_t length = strlen(text);
+        job->changed = !sf || !sf->content || sf->content_length != length ||
+                       memcmp(sf->content, text, length) != 0;
+        if (job->changed && !atomic_write_data(job->path, text, length, msg)) {
+            job->failed = true;
+        }
+        free(text);
+    }
+    sysml2_trace_end(trace);
+    fclose(msg);
+}
+
+static void *fix_worker(void *arg) {
+    FixQueue *queue = arg;
+
+    for (;;) {
+        pthread_mutex_lock(&queue->lock);
+        if (queue->next >= queue->count) {
+            pthread_mutex_unlock(&queue->lock);
+            break;
+        }
+        FixJob *job = &queue->jobs[queue->next++];
+        pthread_mutex_unlock(&queue->lock);
+
+        run_fix_job(job, queue->trace);
+    }
+    return NULL;
+}
+
+/*
+ * Rewrite the formatted models over their input files on up to jobs
+ * threads. Files whose formatting is unchanged are left alone. Messages
+ * are printed afterwards in input order.
+ */
+static bool write_fixed_files(
+    Sysml2PipelineContext *ctx,
+    const char **paths,
+    SysmlSemanticModel **models,
+    size_t count,
+    size_t jobs,
+    bool verbose
+) {
+    FixQueue queue = {0};
+    queue.jobs = calloc(count, sizeof(FixJob));
+    if (!queue.jobs) {
+        fprintf(stderr, "error: out of memory\n");
+        return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (!models[i]) continue;
+        queue.jobs[queue.count].path = paths[i];
+        queue.jobs[queue.count].model = models[i];
+        queue.count++;
+    }
+    queue.trace = ctx->trace;
+    pthread_mutex_init(&queue.lock, NULL);
+
+    /* The calling thread is one of the workers */
+    size_t helpers = jobs > 1 && queue.count > 1 ? SYSML2_MIN(jobs, queue.count) - 1 : 0;
+    size_t thread_count = 0;
+    pthread_t *threads = helpers > 0 ? malloc(helpers * sizeof(pthread_t)) : NULL;
+    if (threads) {
+        for (size_t t = 0; t < helpers; t++) {
+            if (pthread_create(&threads[thread_count], NULL, fix_worker, &queue) != 0) break;
+            thread_count++;
+        }
+    }
+    /* Serial, or whatever the workers have not taken yet */
+    fix_worker(&queue);
+    for (size_t t = 0; t < thread_count; t++) {
+        pthread_join(threads[t], NULL);
+    }
+
+    bool ok = true;
+    for (size_t i = 0; i < queue.count; i++) {
+        FixJob *job = &queue.jobs[i];
+        if (job->messages_length > 0) {
+            fwrite(job->messages, 1, job->messages_length, stderr);
+        }
+        if (job->failed) {
+            ok = false;
+        } else if (verbose) {
+            fprintf(stderr, "%s: %s\n", job->changed ? "Formatted" : "Unchanged", job->path);
+        }
+        free(job->messages);
+    }
+
+    pthread_mutex_destroy(&queue.lock);
+    free(threads);
+    free(queue.jobs);
+    return ok;
+}
+
 /* Run --fix mode: parse, resolve, validate, then rewrite files */
 static int run_fix_mode(
     Sysml2PipelineContext *ctx,
@@ -635,7 +982,7 @@ static int run_fix_mode(
 
     /* Preload from configured library paths */
     if (!options->no_resolve) {
-        sysml2_resolver_preload_libraries(resolver, diag);
+        sysml2_pipeline_load_libraries(ctx);
     }
 
     /* Add directories containing input files to search paths */
@@ -670,8 +1017,9 @@ static int run_fix_mode(
                 free(path_copy);
             }
         }
-        /* Clear any parse errors from discovery - they shouldn't affect exit code */
-        sysml2_diag_clear(diag);
+        /* Clear any parse errors from discovery - they shouldn't affect exit
+         * code - but keep a memory limit breach, which ends the run */
+        if (!sysml2_memory_exceeded()) sysml2_diag_clear(diag);
     }
 
     /* Allocate model array */
@@ -686,15 +1034,14 @@ static int run_fix_mode(
     size_t error_count_before = diag->error_count;
 
     /* Pass 1: Parse ALL input files */
+    if (sysml2_pipeline_process_files(ctx, input_files, input_count, options->jobs,
+                                      false, models, NULL) != SYSML2_OK) {
+        has_errors = true;
+    }
     for (size_t i = 0; i < input_count; i++) {
-        models[i] = NULL;
-        Sysml2Result result = sysml2_pipeline_process_file(ctx, input_files[i], &models[i]);
-        if (result != SYSML2_OK || models[i] == NULL) {
+        if (models[i] == NULL) {
             has_errors = true;
         }
-        if (models[i]) {
-            sysml2_resolver_cache_model(resolver, input_files[i], models[i]);
-        }
     }
 
     if (has_errors) {
@@ -737,15 +1084,13 @@ static int run_fix_mode(
         }
     }
 
-    /* Pass 4: All checks passed, now rewrite input files using atomic writes */
-    for (size_t i = 0; i < input_count; i++) {
-        if (models[i]) {
-            if (!atomic_write_file(input_files[i], models[i],
-                                   options->verbose ? "Formatted" : NULL)) {
-                has_errors = true;
-            }
-        }
+    /* Pass 4: All checks passed, now rewrite changed input files using atomic writes */
+    sysml2_stats_phase_start(ctx->stats, SYSML2_PHASE_WRITE);
+    if (!write_fixed_files(ctx, input_files, models, input_count, options->jobs,
+                           options->verbose)) {
+        has_errors = true;
     }
+    sysml2_stats_phase_stop(ctx->stats, SYSML2_PHASE_WRITE);
 
     free(models);
     sysml2_free_file_list((char **)input_files, input_count);
@@ -760,6 +1105,51 @@ static int run_fix_mode(
     }
 }
 
+/* NDJSON records written while parsing (--parse-only -f ndjson) */
+typedef struct {
+    FILE *out;
+    Sysml2IdSet written;            /* Source names already written */
+} NdjsonStream;
+
+static void stream_parsed_model(
+    Sysml2PipelineContext *ctx,
+    SysmlSemanticModel *model,
+    void *data
+) {
+    NdjsonStream *stream = data;
+    sysml2_pipeline_write_ndjson(ctx, model, stream->out);
+    fflush(stream->out);
+    /* Reclaimed models take the set's memory with them; nothing is loaded
+     * after the inputs then, so there is nothing to filter */
+    if (model->source_name && !ctx->reclaim_parsed) {
+        sysml2_id_set_add(&stream->written, model->source_name, sysml2_pipeline_get_arena(ctx));
+    }
+}
+
+/* Check if --select or --select-users filters the output */
+static bool has_query(const Sysml2CliOptions *options) {
+    return options->select_pattern_count > 0 || options->users_pattern_count > 0;
+}
+
+/* Run --select over the input models, or --select-users over everything loaded */
+static Sysml2QueryResult *run_query(
+    Sysml2PipelineContext *ctx,
+    const Sysml2CliOptions *options,
+    SysmlSemanticModel **input_models,
+    size_t input_count
+) {
+    Sysml2Arena *arena = sysml2_pipeline_get_arena(ctx);
+    if (options->users_pattern_count > 0) {
+        Sysml2QueryPattern *patterns = sysml2_query_parse_multi(
+            options->users_patterns, options->users_pattern_count, arena);
+        return patterns ? sysml2_pipeline_query_users(ctx, patterns, options->users_depth) : NULL;
+    }
+
+    Sysml2QueryPattern *patterns = sysml2_query_parse_multi(
+        options->select_patterns, options->select_pattern_count, arena);
+    return patterns ? sysml2_query_execute(patterns, input_models, input_count, arena) : NULL;
+}
+
 /* Run normal mode: parse, resolve, validate, output */
 static int run_normal_mode(
     Sysml2PipelineContext *ctx,
@@ -785,9 +1175,10 @@ static int run_normal_mode(
     }
 
     /* Preload from configured library paths (-I and SYSML2_LIBRARY_PATH).
-     * These files are fully cached for validation. */
+     * These files are fully cached for validation; with --lazy-libraries
+     * only their packages are mapped and validation loads what it uses. */
     if (!options->no_resolve) {
-        sysml2_resolver_preload_libraries(resolver, diag);
+        sysml2_pipeline_load_libraries(ctx);
     }
 
     /* Add directories containing input files to search paths */
@@ -829,8 +1220,9 @@ static int run_normal_mode(
                 free(path_copy);
             }
         }
-        /* Clear any parse errors from discovery - they shouldn't affect exit code */
-        sysml2_diag_clear(diag);
+        /* Clear any parse errors from discovery - they shouldn't affect exit
+         * code - but keep a memory limit breach, which ends the run */
+        if (!sysml2_memory_exceeded()) sysml2_diag_clear(diag);
     }
 
     Sysml2Result final_result = SYSML2_OK;
@@ -892,6 +1284,18 @@ static int run_normal_mode(
                     sysml2_pipeline_write_sysml(ctx, model, out);
                     if (options->output_file) fclose(out);
                 }
+            } else if (options->output_format == SYSML2_OUTPUT_BINARY) {
+                FILE *out = options->output_file ? fopen(options->output_file, "wb") : stdout;
+                if (out) {
+                    sysml2_pipeline_write_binary(ctx, &model, 1, out);
+                    if (options->output_file) fclose(out);
+                }
+            } else if (options->output_format == SYSML2_OUTPUT_NDJSON) {
+                FILE *out = options->output_file ? fopen(options->output_file, "w") : stdout;
+                if (out) {
+                    sysml2_pipeline_write_ndjson(ctx, model, out);
+                    if (options->output_file) fclose(out);
+                }
             }
         }
     } else {
@@ -905,21 +1309,27 @@ static int run_normal_mode(
 
         bool has_parse_errors = false;
 
-        /* Pass 1: Parse all input files */
-        for (size_t i = 0; i < input_count; i++) {
-            input_models[i] = NULL;
-            Sysml2Result result = sysml2_pipeline_process_file(ctx, input_files[i], &input_models[i]);
-            if (result != SYSML2_OK) {
-                has_parse_errors = true;
-            }
-            if (input_models[i]) {
-                sysml2_resolver_cache_model(resolver, input_files[i], input_models[i]);
-            }
-            if (sysml2_diag_should_stop(diag)) {
-                break;
+        /* Without validation nothing later can change a file's records, so
+         * NDJSON is written as each file is parsed instead of at the end.
+         * Without import resolution nothing reads a model after that either,
+         * so each one is reclaimed once written. */
+        NdjsonStream stream = {0};
+        if (options->output_format == SYSML2_OUTPUT_NDJSON && options->parse_only &&
+            !has_query(options) && !options->list_mode) {
+            stream.out = options->output_file ? fopen(options->output_file, "w") : stdout;
+            if (stream.out) {
+                ctx->on_parsed = stream_parsed_model;
+                ctx->on_parsed_data = &stream;
+                ctx->reclaim_parsed = options->no_resolve;
             }
         }
 
+        /* Pass 1: Parse all input files (stops once the error limit is hit) */
+        if (sysml2_pipeline_process_files(ctx, input_files, input_count, options->jobs,
+                                          true, input_models, NULL) != SYSML2_OK) {
+            has_parse_errors = true;
+        }
+
         /* Pass 2: Resolve imports */
         if (!options->no_resolve && !has_parse_errors) {
             for (size_t i = 0; i < input_count; i++) {
@@ -944,25 +1354,15 @@ static int run_normal_mode(
 
         /* Output */
         if (!has_parse_errors && input_models[0]) {
-            if (options->list_mode && options->select_pattern_count > 0) {
+            if (options->list_mode && has_query(options)) {
                 /* --list with --select: query then output summary */
-                Sysml2Arena *arena = sysml2_pipeline_get_arena(ctx);
-                Sysml2QueryPattern *patterns = sysml2_query_parse_multi(
-                    options->select_patterns,
-                    options->select_pattern_count,
-                    arena
-                );
-                if (patterns) {
-                    Sysml2QueryResult *query_result = sysml2_query_execute(
-                        patterns, input_models, input_count, arena
-                    );
-                    if (query_result) {
-                        FILE *out = options->output_file ? fopen(options->output_file, "w") : stdout;
-                        if (out) {
-                            write_element_list(query_result->elements, query_result->element_count,
-                                               options->output_format, out);
-                            if (options->output_file) fclose(out);
-                        }
+                Sysml2QueryResult *query_result = run_query(ctx, options, input_models, input_count);
+                if (query_result) {
+                    FILE *out = options->output_file ? fopen(options->output_file, "w") : stdout;
+                    if (out) {
+                        write_element_list(query_result->elements, query_result->element_count,
+                                           options->output_format, out);
+                        if (options->output_file) fclose(out);
                     }
                 }
             } else if (options->list_mode) {
@@ -994,48 +1394,53 @@ static int run_normal_mode(
                     }
                     free(roots);
                 }
-            } else if (options->select_pattern_count > 0) {
+            } else if (has_query(options)) {
                 /* Query mode: filter output using patterns */
-                Sysml2Arena *arena = sysml2_pipeline_get_arena(ctx);
-                Sysml2QueryPattern *patterns = sysml2_query_parse_multi(
-                    options->select_patterns,
-                    options->select_pattern_count,
-                    arena
-                );
-
-                if (patterns) {
-                    Sysml2QueryResult *query_result = sysml2_query_execute(
-                        patterns,
-                        input_models,
-                        input_count,
-                        arena
-                    );
-
-                    if (query_result) {
-                        FILE *out = options->output_file ? fopen(options->output_file, "w") : stdout;
-                        if (out) {
-                            if (options->output_format == SYSML2_OUTPUT_JSON) {
-                                sysml2_pipeline_write_query_json(ctx, query_result, out);
-                            } else if (options->output_format == SYSML2_OUTPUT_SYSML) {
-                                sysml2_pipeline_write_query_sysml(ctx, query_result, input_models, input_count, out);
-                            }
-                            if (options->output_file) fclose(out);
+                Sysml2QueryResult *query_result = run_query(ctx, options, input_models, input_count);
+                if (query_result) {
+                    FILE *out = options->output_file ? fopen(options->output_file, "w") : stdout;
+                    if (out) {
+                        if (options->output_format == SYSML2_OUTPUT_JSON) {
+                            sysml2_pipeline_write_query_json(ctx, query_result, out);
+                        } else if (options->output_format == SYSML2_OUTPUT_SYSML) {
+                            sysml2_pipeline_write_query_sysml(ctx, query_result, input_models, input_count, out);
+                        } else if (options->output_format == SYSML2_OUTPUT_BINARY) {
+                            sysml2_pipeline_write_query_binary(ctx, query_result, out);
+                        } else if (options->output_format == SYSML2_OUTPUT_NDJSON) {
+                            sysml2_pipeline_write_query_ndjson(ctx, query_result, out);
                         }
+                        if (options->output_file) fclose(out);
                     }
                 }
             } else {
                 /* Normal mode: output all resolved models */
                 size_t all_model_count;
                 SysmlSemanticModel **all_models = sysml2_resolver_get_all_models(ctx->resolver, &all_model_count);
-                if (all_models && all_model_count > 0) {
+                if (all_models && all_model_count > 0 && stream.out) {
+                    /* Input files were streamed; add the libraries they import */
+                    for (size_t i = 0; i < all_model_count; i++) {
+                        if (all_models[i] &&
+                            !sysml2_id_set_contains(&stream.written, all_models[i]->source_name)) {
+                            sysml2_pipeline_write_ndjson(ctx, all_models[i], stream.out);
+                        }
+                    }
+                } else if (all_models && all_model_count > 0) {
                     FILE *out = options->output_file ? fopen(options->output_file, "w") : stdout;
-                    if (out) {
+                    if (out && options->output_format == SYSML2_OUTPUT_BINARY) {
+                        /* One file holds every model */
+                        sysml2_pipeline_write_binary(ctx, all_models, all_model_count, out);
+                        if (options->output_file) fclose(out);
+                    } else if (out && options->output_format == SYSML2_OUTPUT_SYSML) {
+                        /* Rendered on --jobs threads, written in order */
+                        sysml2_pipeline_write_sysml_models(ctx, all_models, all_model_count, out);
+                        if (options->output_file) fclose(out);
+                    } else if (out) {
                         for (size_t i = 0; i < all_model_count; i++) {
                             if (all_models[i]) {
                                 if (options->output_format == SYSML2_OUTPUT_JSON) {
                                     sysml2_pipeline_write_json(ctx, all_models[i], out);
-                                } else if (options->output_format == SYSML2_OUTPUT_SYSML) {
-                                    sysml2_pipeline_write_sysml(ctx, all_models[i], out);
+                                } else if (options->output_format == SYSML2_OUTPUT_NDJSON) {
+                                    sysml2_pipeline_write_ndjson(ctx, all_models[i], out);
                                 }
                             }
                         }
@@ -1046,6 +1451,11 @@ static int run_normal_mode(
             }
         }
 
+        if (stream.out) {
+            ctx->on_parsed = NULL;
+            ctx->reclaim_parsed = false;
+            if (options->output_file) fclose(stream.out);
+        }
         free(input_models);
     }
 
@@ -1098,7 +1508,7 @@ static int run_modify_mode(
 
     /* Preload from configured library paths */
     if (!options->no_resolve) {
-        sysml2_resolver_preload_libraries(resolver, diag);
+        sysml2_pipeline_load_libraries(ctx);
     }
 
     /* Add directories containing input files to search paths */
@@ -1133,8 +1543,9 @@ static int run_modify_mode(
                 free(path_copy);
             }
         }
-        /* Clear any parse errors from discovery - they shouldn't affect exit code */
-        sysml2_diag_clear(diag);
+        /* Clear any parse errors from discovery - they shouldn't affect exit
+         * code - but keep a memory limit breach, which ends the run */
+        if (!sysml2_memory_exceeded()) sysml2_diag_clear(diag);
     }
 
     /* Allocate model array */
@@ -1439,6 +1850,7 @@ static int run_modify_mode(
 
     /* Pass 5: Write modified files (unless dry-run) */
     if (!options->dry_run) {
+        sysml2_stats_phase_start(ctx->stats, SYSML2_PHASE_WRITE);
         for (size_t i = 0; i < input_count; i++) {
             if (!modified_models[i]) continue;
 
@@ -1458,6 +1870,7 @@ static int run_modify_mode(
                 }
             }
         }
+        sysml2_stats_phase_stop(ctx->stats, SYSML2_PHASE_WRITE);
     } else {
         fprintf(stderr, "Dry run: no files modified\n");
     }
@@ -1476,7 +1889,75 @@ static int run_modify_mode(
     }
 }
 
-int main(int argc, char **argv) {
+/* Run the mode options select, then print --stats */
+/* --syntax-only: check that each input parses, write nothing else */
+static int run_syntax_mode(
+    Sysml2PipelineContext *ctx,
+    const Sysml2CliOptions *options
+) {
+    size_t input_count = 0;
+    const char **input_files = NULL;
+    if (options->input_file_count > 0) {
+        input_files = expand_input_files(options, &input_count);
+        if (!input_files) {
+            fprintf(stderr, "error: out of memory expanding input files\n");
+            return 1;
+        }
+        if (input_count == 0 && options->recursive) {
+            fprintf(stderr, "error: no .sysml files found\n");
+            sysml2_free_file_list((char **)input_files, input_count);
+            return 1;
+        }
+    }
+
+    Sysml2Result result = sysml2_pipeline_check_syntax(ctx, input_files, input_count);
+    if (input_files) {
+        sysml2_free_file_list((char **)input_files, input_count);
+    }
+    sysml2_pipeline_print_diagnostics(ctx, stderr);
+
+    /* Unreadable files count as failures too */
+    Sysml2DiagContext *diag = sysml2_pipeline_get_diag(ctx);
+    return diag->error_count > 0 || result != SYSML2_OK ? 1 : 0;
+}
+
+static int run_mode(Sysml2PipelineContext *ctx, const Sysml2CliOptions *options) {
+    int exit_code;
+    if (options->serve_mode) {
+        exit_code = sysml2_server_run(ctx, stdin, stdout);
+    } else if (options->batch_mode) {
+        exit_code = sysml2_batch_run(ctx, stdin, stdout);
+    } else if (has_modify_options(options)) {
+        exit_code = run_modify_mode(ctx, options);
+    } else if (options->fix_in_place) {
+        exit_code = run_fix_mode(ctx, options);
+    } else if (options->syntax_only) {
+        exit_code = run_syntax_mode(ctx, options);
+    } else {
+        exit_code = run_normal_mode(ctx, options);
+    }
+
+    /* A breach was reported where it happened; whatever ran after it is incomplete */
+    if (sysml2_memory_exceeded()) exit_code = 1;
+
+    sysml2_pipeline_print_stats(ctx, stderr);
+    return exit_code;
+}
+
+static int run_cli(int argc, char **argv, Sysml2PipelineContext *loaded);
+
+/* One --daemon request, in a child holding the client's stdio */
+static int run_daemon_request(int argc, char **argv, void *data) {
+    return run_cli(argc, argv, data);
+}
+
+/*
+ * Run one command line
+ *
+ * @param loaded Context a --daemon loaded, reused when the command needs
+ *               the same libraries (NULL = load everything here)
+ */
+static int run_cli(int argc, char **argv, Sysml2PipelineContext *loaded) {
     Sysml2CliOptions options;
     Sysml2Result result = sysml2_cli_parse(&options, argc, argv);
 
@@ -1523,6 +2004,62 @@ int main(int argc, char **argv) {
         }
     }
 
+    /* Invalidate the model cache before anything is loaded from it */
+    if (options.clear_cache) {
+        if (!options.cache_dir) {
+            fprintf(stderr, "error: --clear-cache requires --cache-dir\n");
+            return 1;
+        }
+        size_t removed = 0;
+        if (sysml2_model_cache_clear(options.cache_dir, &removed) != SYSML2_OK) {
+            fprintf(stderr, "error: failed to clear cache directory '%s'\n", options.cache_dir);
+            return 1;
+        }
+        if (options.verbose) {
+            fprintf(stderr, "note: removed %zu cache entries from %s\n", removed, options.cache_dir);
+        }
+        /* Clearing alone is a complete command; don't wait on stdin */
+        if (options.input_file_count == 0) {
+            return 0;
+        }
+    }
+
+    /* --serve takes its files from requests */
+    if (options.serve_mode &&
+        (options.input_file_count > 0 || options.fix_in_place ||
+         has_modify_options(&options) || options.list_mode)) {
+        fprintf(stderr, "error: --serve cannot be combined with file arguments or other modes\n");
+        return 1;
+    }
+
+    /* --batch takes its documents from stdin, and rewinds each one out
+     * of the loaded libraries, so nothing may be loaded on demand */
+    if (options.batch_mode) {
+        if (options.input_file_count > 0 || options.fix_in_place || options.serve_mode ||
+            has_modify_options(&options) || options.list_mode || options.syntax_only ||
+            has_query(&options)) {
+            fprintf(stderr, "error: --batch cannot be combined with file arguments or other modes\n");
+            return 1;
+        }
+        if (options.lazy_libraries) {
+            fprintf(stderr, "error: --batch cannot be combined with --lazy-libraries\n");
+            return 1;
+        }
+    }
+
+    /* --daemon takes its command lines from clients */
+    if (options.daemon_socket) {
+        if (loaded) {
+            fprintf(stderr, "error: --daemon cannot be run by a daemon\n");
+            return 1;
+        }
+        if (options.input_file_count > 0 || options.fix_in_place || options.serve_mode ||
+            options.batch_mode || has_modify_options(&options) || options.list_mode) {
+            fprintf(stderr, "error: --daemon cannot be combined with file arguments or other modes\n");
+            return 1;
+        }
+    }
+
     /* Validate --set has corresponding --at */
     for (size_t i = 0; i < options.set_count; i++) {
         if (options.set_targets[i] == NULL) {
@@ -1531,6 +2068,23 @@ int main(int argc, char **argv) {
         }
     }
 
+    /* A daemon's own limit carries over to requests that set none */
+    if (options.memory_limit > 0) {
+        sysml2_memory_set_limit(options.memory_limit);
+    }
+
+    /* Start from the daemon's libraries when they are the ones needed */
+    if (loaded && sysml2_pipeline_reuse(loaded, &options)) {
+        if (options.verbose) {
+            fprintf(stderr, "note: reusing libraries loaded by the daemon\n");
+        }
+        int exit_code = run_mode(loaded, &options);
+        /* The arena and intern table belong to the daemon */
+        sysml2_pipeline_destroy(loaded);
+        sysml2_cli_cleanup(&options);
+        return exit_code;
+    }
+
     /* Initialize memory arena and string interning */
     Sysml2Arena arena;
     sysml2_arena_init(&arena);
@@ -1549,13 +2103,19 @@ int main(int argc, char **argv) {
 
     /* Run appropriate mode */
     int exit_code;
-    if (has_modify_options(&options)) {
-        exit_code = run_modify_mode(ctx, &options);
-    } else if (options.fix_in_place) {
-        exit_code = run_fix_mode(ctx, &options);
+    if (options.daemon_socket) {
+        /* Index the libraries once; forked requests inherit the layer */
+        sysml2_pipeline_library_layer(ctx);
+        exit_code = sysml2_daemon_run(options.daemon_socket, run_daemon_request, ctx);
     } else {
-        exit_code = run_normal_mode(ctx, &options);
+        exit_code = run_mode(ctx, &options);
+    }
+
+#ifdef SYSML2_ARENA_STATS
+    if (options.verbose) {
+        sysml2_arena_stats_print(stderr);
     }
+#endif
 
     /* Cleanup */
     sysml2_pipeline_destroy(ctx);
@@ -1565,3 +2125,21 @@ int main(int argc, char **argv) {
 
     return exit_code;
 }
+
+/* Whether argv starts a daemon rather than being a command to forward */
+static bool starts_daemon(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--daemon", 8) == 0) return true;
+    }
+    return false;
+}
+
+int main(int argc, char **argv) {
+    /* Hand the command to a running daemon if one is configured */
+    const char *daemon_socket = getenv(SYSML2_DAEMON_ENV);
+    if (daemon_socket && *daemon_socket && !starts_daemon(argc, argv)) {
+        int exit_code = sysml2_daemon_forward(daemon_socket, argc, argv);
+        if (exit_code >= 0) return exit_code;
+    }
+    return run_cli(argc, argv, NULL);
+}
@@ -0,0 +1,193 @@
+/*
+ * SysML v2 Parser - Memory Budget Implementation
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "sysml2/memory_budget.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Deeper phase nesting is counted but not named */
+#define MAX_PHASE_DEPTH 16
+
+static pthread_mutex_t budget_lock = PTHREAD_MUTEX_INITIALIZER;
+static size_t budget_limit;
+static size_t budget_used;
+static size_t budget_peak;
+static bool budget_exceeded;
+static bool budget_reported;
+static const char *phase_stack[MAX_PHASE_DEPTH];
+static size_t phase_depth;
+
+void sysml2_memory_set_limit(size_t bytes) {
+    pthread_mutex_lock(&budget_lock);
+    budget_limit = bytes;
+    if (bytes > 0 && budget_used > bytes) budget_exceeded = true;
+    pthread_mutex_unlock(&budget_lock);
+}
+
+size_t sysml2_memory_limit(void) {
+    pthread_mutex_lock(&budget_lock);
+    size_t limit = budget_limit;
+    pthread_mutex_unlock(&budget_lock);
+    return limit;
+}
+
+void sysml2_memory_charge(size_t bytes) {
+    pthread_mutex_lock(&budget_lock);
+    budget_used = bytes > SIZE_MAX - budget_used ? SIZE_MAX : budget_used + bytes;
+    if (budget_used > budget_peak) budget_peak = budget_used;
+    if (budget_limit > 0 && budget_used > budget_limit) budget_exceeded = true;
+    pthread_mutex_unlock(&budget_lock);
+}
+
+void sysml2_memory_release(size_t bytes) {
+    pthread_mutex_lock(&budget_lock);
+    budget_used = bytes < budget_used ? budget_used - bytes : 0;
+    pthread_mutex_unlock(&budget_lock);
+}
+
+size_t sysml2_memory_used(void) {
+    pthread_mutex_lock(&budget_lock);
+    size_t used = budget_used;
+    pthread_mutex_unlock(&budget_lock);
+    return used;
+}
+
+size_t sysml2_memory_peak(void) {
+    pthread_mutex_lock(&budget_lock);
+    size_t peak = budget_peak;
+    pthread_mutex_unlock(&budget_lock);
+    return peak;
+}
+
+size_t sysml2_memory_begin_peak(void) {
+    pthread_mutex_lock(&budget_lock);
+    size_t outer = budget_peak;
+    budget_peak = budget_used;
+    pthread_mutex_unlock(&budget_lock);
+    return outer;
+}
+
+size_t sysml2_memory_end_peak(size_t outer) {
+    pthread_mutex_lock(&budget_lock);
+    size_t inner = budget_peak;
+    if (outer > budget_peak) budget_peak = outer;
+    pthread_mutex_unlock(&budget_lock);
+    return inner;
+}
+
+bool sysml2_memory_exceeded(void) {
+    pthread_mutex_lock(&budget_lock);
+    bool exceeded = budget_exceeded;
+    pthread_mutex_unlock(&budget_lock);
+    return exceeded;
+}
+
+void sysml2_memory_phase_push(const char *name) {
+    pthread_mutex_lock(&budget_lock);
+    if (phase_depth < MAX_PHASE_DEPTH) phase_stack[phase_depth] = name;
+    phase_depth++;
+    pthread_mutex_unlock(&budget_lock);
+}
+
+void sysml2_memory_phase_pop(void) {
+    pthread_mutex_lock(&budget_lock);
+    if (phase_depth > 0) phase_depth--;
+    pthread_mutex_unlock(&budget_lock);
+}
+
+/* Whether a context already holds a breach report */
+static bool has_report(const Sysml2DiagContext *diag) {
+    for (const Sysml2Diagnostic *d = diag->first; d; d = d->next) {
+        if (d->code == SYSML2_DIAG_E4001_MEMORY_LIMIT) return true;
+    }
+    return false;
+}
+
+bool sysml2_memory_report(Sysml2DiagContext *diag, const char *file) {
+    pthread_mutex_lock(&budget_lock);
+    bool exceeded = budget_exceeded;
+    bool first = exceeded && (diag || !budget_reported);
+    if (first) budget_reported = true;
+    size_t limit = budget_limit;
+    size_t used = budget_used;
+    size_t depth = phase_depth < MAX_PHASE_DEPTH ? phase_depth : MAX_PHASE_DEPTH;
+    const char *phase = depth > 0 ? phase_stack[depth - 1] : NULL;
+    pthread_mutex_unlock(&budget_lock);
+
+    if (!first || (diag && has_report(diag))) return exceeded;
+
+    char message[160];
+    int length = snprintf(message, sizeof(message), "memory limit of %zu bytes exceeded", limit);
+    if (phase && length >= 0 && (size_t)length < sizeof(message)) {
+        length += snprintf(message + length, sizeof(message) - (size_t)length,
+                           " in %s phase", phase);
+    }
+    if (length >= 0 && (size_t)length < sizeof(message)) {
+        snprintf(message + length, sizeof(message) - (size_t)length, " (%zu bytes in use)", used);
+    }
+
+    if (!diag) {
+        if (file) {
+            fprintf(stderr, "%s: fatal error[E4001]: %s\n", file, message);
+        } else {
+            fprintf(stderr, "fatal error[E4001]: %s\n", message);
+        }
+        return exceeded;
+    }
+
+    /* The file is named like a diagnostic location, without a line */
+    Sysml2SourceFile *sf = NULL;
+    if (file) {
+        sf = SYSML2_ARENA_NEW(diag->arena, Sysml2SourceFile);
+        if (sf) {
+            memset(sf, 0, sizeof(*sf));
+            sf->path = sysml2_arena_strdup(diag->arena, file);
+        }
+    }
+    Sysml2SourceRange range = {{0, 0, 0}, {0, 0, 0}};
+    sysml2_diag_emit(diag, sysml2_diag_create(diag, SYSML2_DIAG_E4001_MEMORY_LIMIT,
+                                              SYSML2_SEVERITY_FATAL, sf, range,
+                                              sysml2_arena_strdup(diag->arena, message)));
+    return exceeded;
+}
+
+void sysml2_memory_reset(void) {
+    pthread_mutex_lock(&budget_lock);
+    budget_limit = 0;
+    budget_used = 0;
+    budget_peak = 0;
+    budget_exceeded = false;
+    budget_reported = false;
+    phase_depth = 0;
+    pthread_mutex_unlock(&budget_lock);
+}
+
+bool sysml2_memory_parse_size(const char *text, size_t *out_bytes) {
+    if (!text || !isdigit((unsigned char)text[0])) return false;
+
+    char *end = NULL;
+    errno = 0;
+    unsigned long long value = strtoull(text, &end, 10);
+    if (errno != 0 || !end) return false;
+
+    unsigned shift = 0;
+    switch (toupper((unsigned char)*end)) {
+        case 'K': shift = 10; end++; break;
+        case 'M': shift = 20; end++; break;
+        case 'G': shift = 30; end++; break;
+        default: break;
+    }
+    if (*end != '\0') return false;
+    if (value > (unsigned long long)(SIZE_MAX >> shift)) return false;
+
+    *out_bytes = (size_t)value << shift;
+    return true;
+}
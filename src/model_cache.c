@@ -0,0 +1,1851 @@
+/*
+ * SysML v2 Parser - Persistent Model Cache Implementation
+ *
+ * Entry layout (host byte order, all offsets from start of file):
+ *
+ *   CacheHeader
+ *   source path (NUL-terminated, padded to 8 bytes)
+ *   string table: { uint32 length; char data[length]; '\0' } * string_count
+ *   record stream: model encoded as uint32 words / string indices
+ *
+ * String index 0 encodes NULL; index i > 0 refers to the i-th table entry.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "sysml2/model_cache.h"
+#include "sysml2/utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* Marker used to reject entries written on a host with other byte order */
+#define CACHE_BYTE_ORDER_MARK 0x01020304u
+
+/* Stored mtime meaning "always verify the content hash" */
+#define CACHE_MTIME_UNTRUSTED INT64_MIN
+
+/* Files modified this recently (ns) are not trusted by mtime alone */
+#define CACHE_RACY_WINDOW_NS 2000000000LL
+
+/* Limit on statement nesting when decoding (guards corrupt entries) */
+#define CACHE_MAX_STMT_DEPTH 64
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t program_hash;
+    uint64_t source_size;
+    int64_t source_mtime;
+    uint64_t content_hash;
+    uint32_t path_length;
+    uint32_t string_count;
+    uint64_t strings_offset;
+    uint64_t strings_size;
+    uint64_t records_offset;
+    uint64_t records_size;
+} CacheHeader;
+
+/* Node modifier bits (packed into one word) */
+enum {
+    NODE_HAS_DEFAULT_KEYWORD  = 1u << 0,
+    NODE_IS_ABSTRACT          = 1u << 1,
+    NODE_IS_VARIATION         = 1u << 2,
+    NODE_IS_READONLY          = 1u << 3,
+    NODE_IS_DERIVED           = 1u << 4,
+    NODE_IS_CONSTANT          = 1u << 5,
+    NODE_IS_REF               = 1u << 6,
+    NODE_IS_END               = 1u << 7,
+    NODE_IS_PARALLEL          = 1u << 8,
+    NODE_IS_EXHIBIT           = 1u << 9,
+    NODE_IS_EVENT_OCCURRENCE  = 1u << 10,
+    NODE_IS_STANDARD_LIBRARY  = 1u << 11,
+    NODE_IS_PUBLIC_EXPLICIT   = 1u << 12,
+    NODE_HAS_ENUM_KEYWORD     = 1u << 13,
+    NODE_IS_ASSERTED          = 1u << 14,
+    NODE_IS_NEGATED           = 1u << 15,
+    NODE_HAS_CONNECT_KEYWORD  = 1u << 16,
+    NODE_HAS_ACTION_KEYWORD   = 1u << 17,
+    NODE_HAS_CONJUGATED       = 1u << 18,
+};
+
+/* ========== Hashing and Paths ========== */
+
+uint64_t sysml2_model_cache_hash(const void *data, size_t length) {
+    const uint8_t *bytes = (const uint8_t *)data;
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static int64_t stat_mtime_ns(const struct stat *st) {
+    int64_t ns = (int64_t)st->st_mtime * 1000000000LL;
+#if defined(__APPLE__)
+    ns += st->st_mtimespec.tv_nsec;
+#elif defined(st_mtime)
+    /* POSIX.1-2008: st_mtime is a macro for st_mtim.tv_sec */
+    ns += st->st_mtim.tv_nsec;
+#endif
+    return ns;
+}
+
+static char *entry_path(const Sysml2ModelCache *cache, const char *abs_path) {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx" SYSML2_MODEL_CACHE_EXT,
+             (unsigned long long)sysml2_model_cache_hash(abs_path, strlen(abs_path)));
+    return sysml2_path_join(cache->dir, name);
+}
+
+/* Create a directory and any missing parents */
+static bool make_directories(const char *dir) {
+    char *path = strdup(dir);
+    if (!path) return false;
+
+    size_t len = strlen(path);
+    while (len > 1 && path[len - 1] == '/') path[--len] = '\0';
+
+    for (char *p = path + 1; *p; p++) {
+        if (*p != '/') continue;
+        *p = '\0';
+        if (mkdir(path, 0755) != 0 && errno != EEXIST) {
+            free(path);
+            return false;
+        }
+        *p = '/';
+    }
+    bool ok = mkdir(path, 0755) == 0 || errno == EEXIST;
+    free(path);
+    return ok && sysml2_is_directory(dir);
+}
+
+/* ========== Lifecycle ========== */
+
+Sysml2ModelCache *sysml2_model_cache_create(
+    const char *dir,
+    Sysml2Arena *arena,
+    Sysml2Intern *intern
+) {
+    if (!dir || !arena || !intern) return NULL;
+    if (!make_directories(dir)) return NULL;
+
+    Sysml2ModelCache *cache = calloc(1, sizeof(Sysml2ModelCache));
+    if (!cache) return NULL;
+
+    cache->dir = strdup(dir);
+    if (!cache->dir) {
+        free(cache);
+        return NULL;
+    }
+    cache->arena = arena;
+    cache->intern = intern;
+    return cache;
+}
+
+void sysml2_model_cache_destroy(Sysml2ModelCache *cache) {
+    if (!cache) return;
+    free(cache->dir);
+    free(cache);
+}
+
+/* ========== Encoder ========== */
+
+typedef struct {
+    uint8_t *data;
+    size_t length;
+    size_t capacity;
+    bool ok;
+} ByteBuf;
+
+typedef struct {
+    ByteBuf records;
+    ByteBuf strings;
+    uint32_t string_count;
+
+    /* Pointer -> string index map (open addressing) */
+    const char **slot_keys;
+    uint32_t *slot_values;
+    size_t slot_capacity;
+} Encoder;
+
+static void buf_append(ByteBuf *buf, const void *data, size_t length) {
+    if (!buf->ok) return;
+    if (buf->length + length > buf->capacity) {
+        size_t new_cap = buf->capacity ? buf->capacity * 2 : 4096;
+        while (new_cap < buf->length + length) new_cap *= 2;
+        uint8_t *new_data = realloc(buf->data, new_cap);
+        if (!new_data) {
+            buf->ok = false;
+            return;
+        }
+        buf->data = new_data;
+        buf->capacity = new_cap;
+    }
+    memcpy(buf->data + buf->length, data, length);
+    buf->length += length;
+}
+
+static size_t hash_pointer(const void *ptr) {
+    uintptr_t v = (uintptr_t)ptr;
+    v ^= v >> 33;
+    v *= 0xff51afd7ed558ccdULL;
+    v ^= v >> 33;
+    return (size_t)v;
+}
+
+static bool encoder_grow_slots(Encoder *enc) {
+    size_t new_cap = enc->slot_capacity ? enc->slot_capacity * 2 : 1024;
+    const char **keys = calloc(new_cap, sizeof(const char *));
+    uint32_t *values = calloc(new_cap, sizeof(uint32_t));
+    if (!keys || !values) {
+        free(keys);
+        free(values);
+        return false;
+    }
+    for (size_t i = 0; i < enc->slot_capacity; i++) {
+        if (!enc->slot_keys[i]) continue;
+        size_t j = hash_pointer(enc->slot_keys[i]) & (new_cap - 1);
+        while (keys[j]) j = (j + 1) & (new_cap - 1);
+        keys[j] = enc->slot_keys[i];
+        values[j] = enc->slot_values[i];
+    }
+    free(enc->slot_keys);
+    free(enc->slot_values);
+    enc->slot_keys = keys;
+    enc->slot_values = values;
+    enc->slot_capacity = new_cap;
+    return true;
+}
+
+static void enc_u32(Encoder *enc, uint32_t value) {
+    buf_append(&enc->records, &value, sizeof(value));
+}
+
+static void enc_str(Encoder *enc, const char *str) {
+    if (!str) {
+        enc_u32(enc, 0);
+        return;
+    }
+
+    if ((enc->string_count + 1) * 2 > enc->slot_capacity) {
+        if (!encoder_grow_slots(enc)) {
+            enc->records.ok = false;
+            return;
+        }
+    }
+
+    size_t mask = enc->slot_capacity - 1;
+    size_t i = hash_pointer(str) & mask;
+    while (enc->slot_keys[i]) {
+        if (enc->slot_keys[i] == str) {
+            enc_u32(enc, enc->slot_values[i]);
+            return;
+        }
+        i = (i + 1) & mask;
+    }
+
+    uint32_t length = (uint32_t)strlen(str);
+    buf_append(&enc->strings, &length, sizeof(length));
+    buf_append(&enc->strings, str, (size_t)length + 1);
+
+    uint32_t index = ++enc->string_count;
+    enc->slot_keys[i] = str;
+    enc->slot_values[i] = index;
+    enc_u32(enc, index);
+}
+
+static void enc_loc(Encoder *enc, Sysml2SourceLoc loc) {
+    enc_u32(enc, loc.line);
+    enc_u32(enc, loc.column);
+    enc_u32(enc, loc.offset);
+}
+
+static void enc_str_array(Encoder *enc, const char **strs, size_t count) {
+    enc_u32(enc, strs ? (uint32_t)count : 0);
+    if (!strs) return;
+    for (size_t i = 0; i < count; i++) enc_str(enc, strs[i]);
+}
+
+/* Pointer arrays are encoded without their NULL holes */
+static uint32_t count_present(void *const *items, size_t count) {
+    uint32_t n = 0;
+    if (!items) return 0;
+    for (size_t i = 0; i < count; i++) {
+        if (items[i]) n++;
+    }
+    return n;
+}
+
+static void enc_metadata(Encoder *enc, const SysmlMetadataUsage *meta) {
+    enc_str(enc, meta->type_ref);
+    enc_str_array(enc, meta->about, meta->about_count);
+    enc_u32(enc, count_present((void *const *)meta->features, meta->feature_count));
+    for (size_t i = 0; meta->features && i < meta->feature_count; i++) {
+        if (!meta->features[i]) continue;
+        enc_str(enc, meta->features[i]->name);
+        enc_str(enc, meta->features[i]->value);
+    }
+    enc_loc(enc, meta->loc);
+}
+
+static void enc_metadata_array(Encoder *enc, SysmlMetadataUsage **items, size_t count) {
+    enc_u32(enc, count_present((void *const *)items, count));
+    for (size_t i = 0; items && i < count; i++) {
+        if (items[i]) enc_metadata(enc, items[i]);
+    }
+}
+
+static void enc_trivia(Encoder *enc, const SysmlTrivia *trivia) {
+    uint32_t count = 0;
+    for (const SysmlTrivia *t = trivia; t; t = t->next) count++;
+    enc_u32(enc, count);
+    for (const SysmlTrivia *t = trivia; t; t = t->next) {
+        enc_u32(enc, (uint32_t)t->kind);
+        enc_str(enc, t->text);
+        enc_loc(enc, t->loc);
+        enc_u32(enc, t->count);
+    }
+}
+
+static void enc_connector_end(Encoder *enc, const SysmlConnectorEnd *end) {
+    enc_str(enc, end->target);
+    enc_str(enc, end->feature_chain);
+    enc_str(enc, end->multiplicity);
+}
+
+static void enc_statement(Encoder *enc, const SysmlStatement *stmt) {
+    enc_u32(enc, (uint32_t)stmt->kind);
+    enc_loc(enc, stmt->loc);
+    enc_str(enc, stmt->raw_text);
+    enc_connector_end(enc, &stmt->source);
+    enc_connector_end(enc, &stmt->target);
+    enc_str(enc, stmt->name);
+    enc_str(enc, stmt->guard);
+    enc_str(enc, stmt->payload);
+    enc_u32(enc, count_present((void *const *)stmt->nested, stmt->nested_count));
+    for (size_t i = 0; stmt->nested && i < stmt->nested_count; i++) {
+        if (stmt->nested[i]) enc_statement(enc, stmt->nested[i]);
+    }
+}
+
+static uint32_t node_flags(const SysmlNode *node) {
+    uint32_t flags = 0;
+    if (node->has_default_keyword) flags |= NODE_HAS_DEFAULT_KEYWORD;
+    if (node->is_abstract) flags |= NODE_IS_ABSTRACT;
+    if (node->is_variation) flags |= NODE_IS_VARIATION;
+    if (node->is_readonly) flags |= NODE_IS_READONLY;
+    if (node->is_derived) flags |= NODE_IS_DERIVED;
+    if (node->is_constant) flags |= NODE_IS_CONSTANT;
+    if (node->is_ref) flags |= NODE_IS_REF;
+    if (node->is_end) flags |= NODE_IS_END;
+    if (node->is_parallel) flags |= NODE_IS_PARALLEL;
+    if (node->is_exhibit) flags |= NODE_IS_EXHIBIT;
+    if (node->is_event_occurrence) flags |= NODE_IS_EVENT_OCCURRENCE;
+    if (node->is_standard_library) flags |= NODE_IS_STANDARD_LIBRARY;
+    if (node->is_public_explicit) flags |= NODE_IS_PUBLIC_EXPLICIT;
+    if (node->has_enum_keyword) flags |= NODE_HAS_ENUM_KEYWORD;
+    if (node->is_asserted) flags |= NODE_IS_ASSERTED;
+    if (node->is_negated) flags |= NODE_IS_NEGATED;
+    if (node->has_connect_keyword) flags |= NODE_HAS_CONNECT_KEYWORD;
+    if (node->has_action_keyword) flags |= NODE_HAS_ACTION_KEYWORD;
+    if (node->typed_by && node->typed_by_conjugated) flags |= NODE_HAS_CONJUGATED;
+    return flags;
+}
+
+static void enc_node(Encoder *enc, const SysmlNode *node) {
+    uint32_t flags = node_flags(node);
+    const SysmlNodeCold *cold = sysml2_node_cold(node);
+
+    enc_str(enc, node->id);
+    enc_str(enc, node->name);
+    enc_u32(enc, (uint32_t)node->kind);
+    enc_str(enc, node->parent_id);
+    enc_u32(enc, flags);
+
+    enc_str_array(enc, node->typed_by, node->typed_by_count);
+    if (flags & NODE_HAS_CONJUGATED) {
+        for (size_t i = 0; i < node->typed_by_count; i++) {
+            enc_u32(enc, node->typed_by_conjugated[i] ? 1 : 0);
+        }
+    }
+    enc_str_array(enc, node->specializes, node->specializes_count);
+    enc_str_array(enc, node->redefines, node->redefines_count);
+    enc_str_array(enc, node->references, node->references_count);
+
+    enc_str(enc, node->multiplicity_lower);
+    enc_str(enc, node->multiplicity_upper);
+    enc_str(enc, cold->default_value);
+    enc_str(enc, cold->ref_behavioral_keyword);
+    enc_str(enc, cold->portion_kind);
+    enc_u32(enc, (uint32_t)node->direction);
+    enc_u32(enc, (uint32_t)node->visibility);
+    enc_str(enc, cold->parameter_list);
+    enc_str(enc, cold->connector_part);
+    enc_loc(enc, node->loc);
+    enc_str(enc, cold->documentation);
+    enc_loc(enc, cold->doc_loc);
+
+    enc_metadata_array(enc, cold->metadata, cold->metadata_count);
+    enc_str_array(enc, cold->prefix_metadata, cold->prefix_metadata_count);
+    enc_metadata_array(enc, cold->prefix_applied_metadata, cold->prefix_applied_metadata_count);
+
+    enc_trivia(enc, cold->leading_trivia);
+    enc_trivia(enc, cold->trailing_trivia);
+
+    enc_u32(enc, count_present((void *const *)cold->body_stmts, cold->body_stmt_count));
+    for (size_t i = 0; cold->body_stmts && i < cold->body_stmt_count; i++) {
+        if (cold->body_stmts[i]) enc_statement(enc, cold->body_stmts[i]);
+    }
+
+    enc_u32(enc, count_present((void *const *)cold->comments, cold->comment_count));
+    for (size_t i = 0; cold->comments && i < cold->comment_count; i++) {
+        const SysmlNamedComment *c = cold->comments[i];
+        if (!c) continue;
+        enc_str(enc, c->id);
+        enc_str(enc, c->name);
+        enc_str_array(enc, c->about, c->about_count);
+        enc_str(enc, c->locale);
+        enc_str(enc, c->text);
+        enc_loc(enc, c->loc);
+    }
+
+    enc_u32(enc, count_present((void *const *)cold->textual_reps, cold->textual_rep_count));
+    for (size_t i = 0; cold->textual_reps && i < cold->textual_rep_count; i++) {
+        const SysmlTextualRep *r = cold->textual_reps[i];
+        if (!r) continue;
+        enc_str(enc, r->id);
+        enc_str(enc, r->name);
+        enc_str(enc, r->language);
+        enc_str(enc, r->text);
+        enc_loc(enc, r->loc);
+    }
+
+    enc_str(enc, cold->result_expression);
+}
+
+static void enc_model(Encoder *enc, const SysmlSemanticModel *model) {
+    enc_metadata_array(enc, model->file_metadata, model->file_metadata_count);
+
+    enc_u32(enc, count_present((void *const *)model->elements, model->element_count));
+    for (size_t i = 0; model->elements && i < model->element_count; i++) {
+        if (model->elements[i]) enc_node(enc, model->elements[i]);
+    }
+
+    enc_u32(enc, count_present((void *const *)model->relationships, model->relationship_count));
+    for (size_t i = 0; model->relationships && i < model->relationship_count; i++) {
+        const SysmlRelationship *rel = model->relationships[i];
+        if (!rel) continue;
+        enc_str(enc, rel->id);
+        enc_u32(enc, (uint32_t)rel->kind);
+        enc_str(enc, rel->source);
+        enc_str(enc, rel->target);
+        enc_loc(enc, rel->loc);
+    }
+
+    enc_u32(enc, count_present((void *const *)model->imports, model->import_count));
+    for (size_t i = 0; model->imports && i < model->import_count; i++) {
+        const SysmlImport *imp = model->imports[i];
+        if (!imp) continue;
+        enc_str(enc, imp->id);
+        enc_u32(enc, (uint32_t)imp->kind);
+        enc_str(enc, imp->target);
+        enc_str(enc, imp->owner_scope);
+        enc_u32(enc, (imp->is_private ? 1u : 0u) | (imp->is_public_explicit ? 2u : 0u));
+        enc_loc(enc, imp->loc);
+    }
+
+    enc_u32(enc, count_present((void *const *)model->aliases, model->alias_count));
+    for (size_t i = 0; model->aliases && i < model->alias_count; i++) {
+        const SysmlAlias *alias = model->aliases[i];
+        if (!alias) continue;
+        enc_str(enc, alias->id);
+        enc_str(enc, alias->name);
+        enc_str(enc, alias->target);
+        enc_str(enc, alias->owner_scope);
+        enc_loc(enc, alias->loc);
+    }
+}
+
+static void encoder_free(Encoder *enc) {
+    free(enc->records.data);
+    free(enc->strings.data);
+    free(enc->slot_keys);
+    free(enc->slot_values);
+}
+
+/* ========== Decoder ========== */
+
+typedef struct {
+    const uint8_t *pos;
+    const uint8_t *end;
+    bool ok;
+    const char **strings;
+    uint32_t string_count;
+    Sysml2Arena *arena;
+} Decoder;
+
+static uint32_t dec_u32(Decoder *dec) {
+    uint32_t value = 0;
+    if (!dec->ok || (size_t)(dec->end - dec->pos) < sizeof(value)) {
+        dec->ok = false;
+        return 0;
+    }
+    memcpy(&value, dec->pos, sizeof(value));
+    dec->pos += sizeof(value);
+    return value;
+}
+
+static const char *dec_str(Decoder *dec) {
+    uint32_t index = dec_u32(dec);
+    if (index == 0) return NULL;
+    if (index > dec->string_count) {
+        dec->ok = false;
+        return NULL;
+    }
+    return dec->strings[index - 1];
+}
+
+static Sysml2SourceLoc dec_loc(Decoder *dec) {
+    Sysml2SourceLoc loc;
+    loc.line = dec_u32(dec);
+    loc.column = dec_u32(dec);
+    loc.offset = dec_u32(dec);
+    return loc;
+}
+
+/* Read an element count; every element takes at least one word */
+static size_t dec_count(Decoder *dec) {
+    uint32_t count = dec_u32(dec);
+    if (!dec->ok) return 0;
+    if ((size_t)count > (size_t)(dec->end - dec->pos) / sizeof(uint32_t)) {
+        dec->ok = false;
+        return 0;
+    }
+    return count;
+}
+
+static void *dec_alloc(Decoder *dec, size_t size) {
+    if (!dec->ok) return NULL;
+    void *ptr = sysml2_arena_calloc(dec->arena, 1, size);
+    if (!ptr) dec->ok = false;
+    return ptr;
+}
+
+#define DEC_NEW(dec, type) ((type *)dec_alloc((dec), sizeof(type)))
+#define DEC_NEW_ARRAY(dec, type, n) ((n) ? (type *)dec_alloc((dec), sizeof(type) * (n)) : NULL)
+
+static const char **dec_str_array(Decoder *dec, size_t *out_count) {
+    size_t count = dec_count(dec);
+    const char **strs = DEC_NEW_ARRAY(dec, const char *, count);
+    for (size_t i = 0; strs && i < count; i++) strs[i] = dec_str(dec);
+    *out_count = dec->ok ? count : 0;
+    return dec->ok ? strs : NULL;
+}
+
+static SysmlMetadataUsage *dec_metadata(Decoder *dec) {
+    SysmlMetadataUsage *meta = DEC_NEW(dec, SysmlMetadataUsage);
+    if (!meta) return NULL;
+    meta->type_ref = dec_str(dec);
+    meta->about = dec_str_array(dec, &meta->about_count);
+    size_t feature_count = dec_count(dec);
+    meta->features = DEC_NEW_ARRAY(dec, SysmlMetadataFeature *, feature_count);
+    for (size_t i = 0; meta->features && i < feature_count; i++) {
+        SysmlMetadataFeature *feature = DEC_NEW(dec, SysmlMetadataFeature);
+        if (!feature) break;
+        feature->name = dec_str(dec);
+        feature->value = dec_str(dec);
+        meta->features[i] = feature;
+    }
+    meta->feature_count = dec->ok ? feature_count : 0;
+    meta->loc = dec_loc(dec);
+    return meta;
+}
+
+static SysmlMetadataUsage **dec_metadata_array(Decoder *dec, size_t *out_count) {
+    size_t count = dec_count(dec);
+    SysmlMetadataUsage **items = DEC_NEW_ARRAY(dec, SysmlMetadataUsage *, count);
+    for (size_t i = 0; items && i < count && dec->ok; i++) items[i] = dec_metadata(dec);
+    *out_count = dec->ok ? count : 0;
+    return items;
+}
+
+static SysmlTrivia *dec_trivia(Decoder *dec) {
+    size_t count = dec_count(dec);
+    SysmlTrivia *head = NULL;
+    SysmlTrivia **tail = &head;
+    for (size_t i = 0; i < count && dec->ok; i++) {
+        SysmlTrivia *t = DEC_NEW(dec, SysmlTrivia);
+        if (!t) break;
+        t->kind = (SysmlTriviaKind)dec_u32(dec);
+        t->text = dec_str(dec);
+        t->loc = dec_loc(dec);
+        t->count = (uint16_t)dec_u32(dec);
+        *tail = t;
+        tail = &t->next;
+    }
+    return head;
+}
+
+static void dec_connector_end(Decoder *dec, SysmlConnectorEnd *end) {
+    end->target = dec_str(dec);
+    end->feature_chain = dec_str(dec);
+    end->multiplicity = dec_str(dec);
+}
+
+static SysmlStatement *dec_statement(Decoder *dec, int depth) {
+    if (depth > CACHE_MAX_STMT_DEPTH) {
+        dec->ok = false;
+        return NULL;
+    }
+    SysmlStatement *stmt = DEC_NEW(dec, SysmlStatement);
+    if (!stmt) return NULL;
+    stmt->kind = (SysmlStatementKind)dec_u32(dec);
+    stmt->loc = dec_loc(dec);
+    stmt->raw_text = dec_str(dec);
+    dec_connector_end(dec, &stmt->source);
+    dec_connector_end(dec, &stmt->target);
+    stmt->name = dec_str(dec);
+    stmt->guard = dec_str(dec);
+    stmt->payload = dec_str(dec);
+    size_t nested_count = dec_count(dec);
+    stmt->nested = DEC_NEW_ARRAY(dec, SysmlStatement *, nested_count);
+    for (size_t i = 0; stmt->nested && i < nested_count && dec->ok; i++) {
+        stmt->nested[i] = dec_statement(dec, depth + 1);
+    }
+    stmt->nested_count = dec->ok ? nested_count : 0;
+    return stmt;
+}
+
+static bool cold_is_empty(const SysmlNodeCold *cold) {
+    /* doc_loc only means something alongside documentation */
+    return !cold->default_value && !cold->ref_behavioral_keyword && !cold->portion_kind &&
+           !cold->parameter_list && !cold->connector_part && !cold->documentation &&
+           cold->metadata_count == 0 && cold->prefix_metadata_count == 0 &&
+           cold->prefix_applied_metadata_count == 0 &&
+           !cold->leading_trivia && !cold->trailing_trivia &&
+           cold->body_stmt_count == 0 && cold->comment_count == 0 &&
+           cold->textual_rep_count == 0 && !cold->result_expression;
+}
+
+static SysmlNode *dec_node(Decoder *dec) {
+    SysmlNode *node = DEC_NEW(dec, SysmlNode);
+    if (!node) return NULL;
+    SysmlNodeCold cold_data = {0};
+    SysmlNodeCold *cold = &cold_data;
+
+    node->id = dec_str(dec);
+    node->name = dec_str(dec);
+    node->kind = (SysmlNodeKind)dec_u32(dec);
+    node->parent_id = dec_str(dec);
+    uint32_t flags = dec_u32(dec);
+
+    node->typed_by = dec_str_array(dec, &node->typed_by_count);
+    if (flags & NODE_HAS_CONJUGATED) {
+        node->typed_by_conjugated = DEC_NEW_ARRAY(dec, bool, node->typed_by_count);
+        for (size_t i = 0; node->typed_by_conjugated && i < node->typed_by_count; i++) {
+            node->typed_by_conjugated[i] = dec_u32(dec) != 0;
+        }
+    }
+    node->specializes = dec_str_array(dec, &node->specializes_count);
+    node->redefines = dec_str_array(dec, &node->redefines_count);
+    node->references = dec_str_array(dec, &node->references_count);
+
+    node->multiplicity_lower = dec_str(dec);
+    node->multiplicity_upper = dec_str(dec);
+    cold->default_value = dec_str(dec);
+    cold->ref_behavioral_keyword = dec_str(dec);
+    cold->portion_kind = dec_str(dec);
+    node->direction = (SysmlDirection)dec_u32(dec);
+    node->visibility = (SysmlVisibility)dec_u32(dec);
+    cold->parameter_list = dec_str(dec);
+    cold->connector_part = dec_str(dec);
+    node->loc = dec_loc(dec);
+    cold->documentation = dec_str(dec);
+    cold->doc_loc = dec_loc(dec);
+
+    node->has_default_keyword = (flags & NODE_HAS_DEFAULT_KEYWORD) != 0;
+    node->is_abstract = (flags & NODE_IS_ABSTRACT) != 0;
+    node->is_variation = (flags & NODE_IS_VARIATION) != 0;
+    node->is_readonly = (flags & NODE_IS_READONLY) != 0;
+    node->is_derived = (flags & NODE_IS_DERIVED) != 0;
+    node->is_constant = (flags & NODE_IS_CONSTANT) != 0;
+    node->is_ref = (flags & NODE_IS_REF) != 0;
+    node->is_end = (flags & NODE_IS_END) != 0;
+    node->is_parallel = (flags & NODE_IS_PARALLEL) != 0;
+    node->is_exhibit = (flags & NODE_IS_EXHIBIT) != 0;
+    node->is_event_occurrence = (flags & NODE_IS_EVENT_OCCURRENCE) != 0;
+    node->is_standard_library = (flags & NODE_IS_STANDARD_LIBRARY) != 0;
+    node->is_public_explicit = (flags & NODE_IS_PUBLIC_EXPLICIT) != 0;
+    node->has_enum_keyword = (flags & NODE_HAS_ENUM_KEYWORD) != 0;
+    node->is_asserted = (flags & NODE_IS_ASSERTED) != 0;
+    node->is_negated = (flags & NODE_IS_NEGATED) != 0;
+    node->has_connect_keyword = (flags & NODE_HAS_CONNECT_KEYWORD) != 0;
+    node->has_action_keyword = (flags & NODE_HAS_ACTION_KEYWORD) != 0;
+
+    cold->metadata = dec_metadata_array(dec, &cold->metadata_count);
+    cold->prefix_metadata = dec_str_array(dec, &cold->prefix_metadata_count);
+    cold->prefix_applied_metadata = dec_metadata_array(dec, &cold->prefix_applied_metadata_count);
+
+    cold->leading_trivia = dec_trivia(dec);
+    cold->trailing_trivia = dec_trivia(dec);
+
+    size_t stmt_count = dec_count(dec);
+    cold->body_stmts = DEC_NEW_ARRAY(dec, SysmlStatement *, stmt_count);
+    for (size_t i = 0; cold->body_stmts && i < stmt_count && dec->ok; i++) {
+        cold->body_stmts[i] = dec_statement(dec, 0);
+    }
+    cold->body_stmt_count = dec->ok ? stmt_count : 0;
+
+    size_t comment_count = dec_count(dec);
+    cold->comments = DEC_NEW_ARRAY(dec, SysmlNamedComment *, comment_count);
+    for (size_t i = 0; cold->comments && i < comment_count && dec->ok; i++) {
+        SysmlNamedComment *c = DEC_NEW(dec, SysmlNamedComment);
+        if (!c) break;
+        c->id = dec_str(dec);
+        c->name = dec_str(dec);
+        c->about = dec_str_array(dec, &c->about_count);
+        c->locale = dec_str(dec);
+        c->text = dec_str(dec);
+        c->loc = dec_loc(dec);
+        cold->comments[i] = c;
+    }
+    cold->comment_count = dec->ok ? comment_count : 0;
+
+    size_t rep_count = dec_count(dec);
+    cold->textual_reps = DEC_NEW_ARRAY(dec, SysmlTextualRep *, rep_count);
+    for (size_t i = 0; cold->textual_reps && i < rep_count && dec->ok; i++) {
+        SysmlTextualRep *r = DEC_NEW(dec, SysmlTextualRep);
+        if (!r) break;
+        r->id = dec_str(dec);
+        r->name = dec_str(dec);
+        r->language = dec_str(dec);
+        r->text = dec_str(dec);
+        r->loc = dec_loc(dec);
+        cold->textual_reps[i] = r;
+    }
+    cold->textual_rep_count = dec->ok ? rep_count : 0;
+
+    cold->result_expression = dec_str(dec);
+
+    /* Most elements have no cold data; they keep sharing the empty record */
+    if (!cold_is_empty(cold)) {
+        node->cold = DEC_NEW(dec, SysmlNodeCold);
+        if (node->cold) *node->cold = cold_data;
+    }
+    return node;
+}
+
+static SysmlSemanticModel *dec_model(Decoder *dec) {
+    SysmlSemanticModel *model = DEC_NEW(dec, SysmlSemanticModel);
+    if (!model) return NULL;
+
+    model->file_metadata = dec_metadata_array(dec, &model->file_metadata_count);
+    model->file_metadata_capacity = model->file_metadata_count;
+
+    size_t element_count = dec_count(dec);
+    model->elements = DEC_NEW_ARRAY(dec, SysmlNode *, element_count);
+    for (size_t i = 0; model->elements && i < element_count && dec->ok; i++) {
+        model->elements[i] = dec_node(dec);
+    }
+    model->element_count = model->element_capacity = element_count;
+
+    size_t rel_count = dec_count(dec);
+    model->relationships = DEC_NEW_ARRAY(dec, SysmlRelationship *, rel_count);
+    for (size_t i = 0; model->relationships && i < rel_count && dec->ok; i++) {
+        SysmlRelationship *rel = DEC_NEW(dec, SysmlRelationship);
+        if (!rel) break;
+        rel->id = dec_str(dec);
+        rel->kind = (SysmlNodeKind)dec_u32(dec);
+        rel->source = dec_str(dec);
+        rel->target = dec_str(dec);
+        rel->loc = dec_loc(dec);
+        model->relationships[i] = rel;
+    }
+    model->relationship_count = model->relationship_capacity = rel_count;
+
+    size_t import_count = dec_count(dec);
+    model->imports = DEC_NEW_ARRAY(dec, SysmlImport *, import_count);
+    for (size_t i = 0; model->imports && i < import_count && dec->ok; i++) {
+        SysmlImport *imp = DEC_NEW(dec, SysmlImport);
+        if (!imp) break;
+        imp->id = dec_str(dec);
+        imp->kind = (SysmlNodeKind)dec_u32(dec);
+        imp->target = dec_str(dec);
+        imp->owner_scope = dec_str(dec);
+        uint32_t flags = dec_u32(dec);
+        imp->is_private = (flags & 1u) != 0;
+        imp->is_public_explicit = (flags & 2u) != 0;
+        imp->loc = dec_loc(dec);
+        model->imports[i] = imp;
+    }
+    model->import_count = model->import_capacity = import_count;
+
+    size_t alias_count = dec_count(dec);
+    model->aliases = DEC_NEW_ARRAY(dec, SysmlAlias *, alias_count);
+    for (size_t i = 0; model->aliases && i < alias_count && dec->ok; i++) {
+        SysmlAlias *alias = DEC_NEW(dec, SysmlAlias);
+        if (!alias) break;
+        alias->id = dec_str(dec);
+        alias->name = dec_str(dec);
+        alias->target = dec_str(dec);
+        alias->owner_scope = dec_str(dec);
+        alias->loc = dec_loc(dec);
+        model->aliases[i] = alias;
+    }
+    model->alias_count = model->alias_capacity = alias_count;
+
+    if (dec->ok && dec->pos != dec->end) dec->ok = false;
+
+    /* Paths are not stored; they follow from the IDs */
+    if (dec->ok && !sysml2_model_link_paths(model)) dec->ok = false;
+    return dec->ok ? model : NULL;
+}
+
+/* Intern the string table and decode the record stream */
+static SysmlSemanticModel *decode_sections(
+    const uint8_t *strings_data,
+    uint64_t strings_size,
+    uint32_t string_count,
+    const uint8_t *records_data,
+    uint64_t records_size,
+    Sysml2Arena *arena,
+    Sysml2Intern *intern
+) {
+    const char **strings = NULL;
+    if (string_count > 0) {
+        if (string_count > strings_size / (sizeof(uint32_t) + 1)) return NULL;
+        strings = malloc(string_count * sizeof(const char *));
+        if (!strings) return NULL;
+    }
+
+    const uint8_t *p = strings_data;
+    const uint8_t *strings_end = p + strings_size;
+    for (uint32_t i = 0; i < string_count; i++) {
+        uint32_t length;
+        if ((size_t)(strings_end - p) < sizeof(length)) {
+            free(strings);
+            return NULL;
+        }
+        memcpy(&length, p, sizeof(length));
+        p += sizeof(length);
+        if ((size_t)(strings_end - p) <= length || p[length] != '\0') {
+            free(strings);
+            return NULL;
+        }
+        strings[i] = sysml2_intern_n(intern, (const char *)p, length);
+        p += (size_t)length + 1;
+    }
+
+    Decoder dec = {
+        .pos = records_data,
+        .end = records_data + records_size,
+        .ok = true,
+        .strings = strings,
+        .string_count = string_count,
+        .arena = arena,
+    };
+    SysmlSemanticModel *model = dec_model(&dec);
+    free(strings);
+    return model;
+}
+
+/* ========== Load ========== */
+
+/* Check that the source file still matches the entry key */
+static bool source_matches(const CacheHeader *header, const char *abs_path) {
+    struct stat st;
+    if (stat(abs_path, &st) != 0) return false;
+    if ((uint64_t)st.st_size != header->source_size) return false;
+
+    if (header->source_mtime != CACHE_MTIME_UNTRUSTED &&
+        header->source_mtime == stat_mtime_ns(&st)) {
+        return true;
+    }
+
+    /* Timestamp changed (or was untrusted): compare content hashes */
+    Sysml2SourceBuffer source;
+    if (!sysml2_source_open(abs_path, &source)) return false;
+    bool same = source.length == header->source_size &&
+                sysml2_model_cache_hash(source.data, source.length) == header->content_hash;
+    sysml2_source_release(&source);
+    return same;
+}
+
+/* Hash of the program version that parsed an entry's model */
+static uint64_t program_hash(void) {
+    return sysml2_model_cache_hash(SYSML2_VERSION_STRING, strlen(SYSML2_VERSION_STRING));
+}
+
+static SysmlSemanticModel *decode_entry(
+    Sysml2ModelCache *cache,
+    const uint8_t *data,
+    size_t size,
+    const char *abs_path
+) {
+    CacheHeader header;
+    if (size < sizeof(header)) return NULL;
+    memcpy(&header, data, sizeof(header));
+
+    if (memcmp(header.magic, SYSML2_MODEL_CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != SYSML2_MODEL_CACHE_VERSION ||
+        header.byte_order != CACHE_BYTE_ORDER_MARK ||
+        header.program_hash != program_hash()) {
+        return NULL;
+    }
+
+    /* Validate section bounds */
+    size_t path_len = strlen(abs_path);
+    if (header.path_length != path_len ||
+        sizeof(header) + path_len >= size ||
+        memcmp(data + sizeof(header), abs_path, path_len) != 0) {
+        return NULL;
+    }
+    if (header.strings_offset > size || header.strings_size > size - header.strings_offset ||
+        header.records_offset > size || header.records_size > size - header.records_offset) {
+        return NULL;
+    }
+
+    if (!source_matches(&header, abs_path)) return NULL;
+
+    SysmlSemanticModel *model = decode_sections(
+        data + header.strings_offset, header.strings_size, header.string_count,
+        data + header.records_offset, header.records_size,
+        cache->arena, cache->intern);
+
+    if (model) {
+        model->source_name = sysml2_intern(cache->intern, abs_path);
+        model->source_file = NULL;
+    }
+    return model;
+}
+
+SysmlSemanticModel *sysml2_model_cache_load(
+    Sysml2ModelCache *cache,
+    const char *abs_path
+) {
+    if (!cache || !abs_path) return NULL;
+
+    char *path = entry_path(cache, abs_path);
+    if (!path) return NULL;
+
+    SysmlSemanticModel *model = NULL;
+    int fd = open(path, O_RDONLY);
+    if (fd >= 0) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            size_t size = (size_t)st.st_size;
+            void *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED) {
+                model = decode_entry(cache, (const uint8_t *)data, size, abs_path);
+                munmap(data, size);
+            }
+        }
+        close(fd);
+    }
+    free(path);
+
+    if (model) {
+        cache->hits++;
+        if (cache->verbose) {
+            fprintf(stderr, "note: loaded %s from model cache\n", abs_path);
+        }
+    } else {
+        cache->misses++;
+    }
+    return model;
+}
+
+/* ========== Store / Invalidate ========== */
+
+Sysml2Result sysml2_model_cache_store(
+    Sysml2ModelCache *cache,
+    const char *abs_path,
+    const char *content,
+    size_t content_length,
+    const SysmlSemanticModel *model
+) {
+    if (!cache || !abs_path || !content || !model) return SYSML2_ERROR_SEMANTIC;
+
+    struct stat st;
+    if (stat(abs_path, &st) != 0) return SYSML2_ERROR_FILE_NOT_FOUND;
+
+    Encoder enc = {0};
+    enc.records.ok = true;
+    enc.strings.ok = true;
+    enc_model(&enc, model);
+    if (!enc.records.ok || !enc.strings.ok) {
+        encoder_free(&enc);
+        return SYSML2_ERROR_OUT_OF_MEMORY;
+    }
+
+    /* A file modified within the racy window may change again without a
+     * visible timestamp change, so force content verification on load. */
+    int64_t mtime = stat_mtime_ns(&st);
+    int64_t now = (int64_t)time(NULL) * 1000000000LL;
+    if (now - mtime < CACHE_RACY_WINDOW_NS) {
+        mtime = CACHE_MTIME_UNTRUSTED;
+    }
+
+    size_t path_len = strlen(abs_path);
+    size_t path_section = SYSML2_ALIGN_UP(path_len + 1, 8);
+
+    CacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SYSML2_MODEL_CACHE_MAGIC, sizeof(header.magic));
+    header.version = SYSML2_MODEL_CACHE_VERSION;
+    header.byte_order = CACHE_BYTE_ORDER_MARK;
+    header.program_hash = program_hash();
+    header.source_size = content_length;
+    header.source_mtime = mtime;
+    header.content_hash = sysml2_model_cache_hash(content, content_length);
+    header.path_length = (uint32_t)path_len;
+    header.string_count = enc.string_count;
+    header.strings_offset = sizeof(header) + path_section;
+    header.strings_size = enc.strings.length;
+    header.records_offset = header.strings_offset + SYSML2_ALIGN_UP(enc.strings.length, 8);
+    header.records_size = enc.records.length;
+
+    char *final_path = entry_path(cache, abs_path);
+    if (!final_path) {
+        encoder_free(&enc);
+        return SYSML2_ERROR_OUT_OF_MEMORY;
+    }
+    size_t tmp_len = strlen(final_path) + 32;
+    char *tmp_path = malloc(tmp_len);
+    if (!tmp_path) {
+        free(final_path);
+        encoder_free(&enc);
+        return SYSML2_ERROR_OUT_OF_MEMORY;
+    }
+    snprintf(tmp_path, tmp_len, "%s.tmp.%ld", final_path, (long)getpid());
+
+    Sysml2Result result = SYSML2_OK;
+    FILE *out = fopen(tmp_path, "wb");
+    if (!out) {
+        result = SYSML2_ERROR_FILE_READ;
+    } else {
+        static const uint8_t zeros[8] = {0};
+        bool ok = fwrite(&header, sizeof(header), 1, out) == 1;
+        ok = ok && fwrite(abs_path, 1, path_len, out) == path_len;
+        ok = ok && fwrite(zeros, 1, path_section - path_len, out) == path_section - path_len;
+        if (enc.strings.length > 0) {
+            size_t pad = SYSML2_ALIGN_UP(enc.strings.length, 8) - enc.strings.length;
+            ok = ok && fwrite(enc.strings.data, 1, enc.strings.length, out) == enc.strings.length;
+            ok = ok && fwrite(zeros, 1, pad, out) == pad;
+        }
+        if (enc.records.length > 0) {
+            ok = ok && fwrite(enc.records.data, 1, enc.records.length, out) == enc.records.length;
+        }
+        if (fclose(out) != 0) ok = false;
+
+        if (!ok || rename(tmp_path, final_path) != 0) {
+            unlink(tmp_path);
+            result = SYSML2_ERROR_FILE_READ;
+        }
+    }
+
+    if (result == SYSML2_OK) {
+        cache->stores++;
+    }
+
+    free(tmp_path);
+    free(final_path);
+    encoder_free(&enc);
+    return result;
+}
+
+Sysml2Result sysml2_model_cache_invalidate(
+    Sysml2ModelCache *cache,
+    const char *abs_path
+) {
+    if (!cache || !abs_path) return SYSML2_ERROR_SEMANTIC;
+
+    char *path = entry_path(cache, abs_path);
+    if (!path) return SYSML2_ERROR_OUT_OF_MEMORY;
+
+    Sysml2Result result = SYSML2_OK;
+    if (unlink(path) != 0 && errno != ENOENT) {
+        result = SYSML2_ERROR_FILE_READ;
+    }
+    free(path);
+    return result;
+}
+
+/* ========== In-Memory Serialization ========== */
+
+/* Buffer layout: BlobHeader, string table (padded to 8), record stream */
+typedef struct {
+    uint32_t string_count;
+    uint32_t reserved;
+    uint64_t strings_size;
+    uint64_t records_size;
+} BlobHeader;
+
+Sysml2Result sysml2_model_serialize(
+    const SysmlSemanticModel *model,
+    void **out_data,
+    size_t *out_size
+) {
+    if (!model || !out_data || !out_size) return SYSML2_ERROR_SEMANTIC;
+    *out_data = NULL;
+    *out_size = 0;
+
+    Encoder enc = {0};
+    enc.records.ok = true;
+    enc.strings.ok = true;
+    enc_model(&enc, model);
+    if (!enc.records.ok || !enc.strings.ok) {
+        encoder_free(&enc);
+        return SYSML2_ERROR_OUT_OF_MEMORY;
+    }
+
+    size_t strings_section = SYSML2_ALIGN_UP(enc.strings.length, 8);
+    size_t size = sizeof(BlobHeader) + strings_section + enc.records.length;
+    uint8_t *data = calloc(1, size);
+    if (!data) {
+        encoder_free(&enc);
+        return SYSML2_ERROR_OUT_OF_MEMORY;
+    }
+
+    BlobHeader header = {
+        .string_count = enc.string_count,
+        .strings_size = enc.strings.length,
+        .records_size = enc.records.length,
+    };
+    memcpy(data, &header, sizeof(header));
+    if (enc.strings.length > 0) {
+        memcpy(data + sizeof(header), enc.strings.data, enc.strings.length);
+    }
+    if (enc.records.length > 0) {
+        memcpy(data + sizeof(header) + strings_section, enc.records.data, enc.records.length);
+    }
+    encoder_free(&enc);
+
+    *out_data = data;
+    *out_size = size;
+    return SYSML2_OK;
+}
+
+SysmlSemanticModel *sysml2_model_deserialize(
+    const void *data,
+    size_t size,
+    Sysml2Arena *arena,
+    Sysml2Intern *intern
+) {
+    if (!data || !arena || !intern || size < sizeof(BlobHeader)) return NULL;
+
+    BlobHeader header;
+    memcpy(&header, data, sizeof(header));
+
+    size_t body = size - sizeof(header);
+    if (header.strings_size > body) return NULL;
+    size_t strings_section = SYSML2_ALIGN_UP((size_t)header.strings_size, 8);
+    if (strings_section > body || header.records_size != body - strings_section) return NULL;
+
+    const uint8_t *base = (const uint8_t *)data + sizeof(header);
+    return decode_sections(base, header.strings_size, header.string_count,
+                           base + strings_section, header.records_size,
+                           arena, intern);
+}
+
+Sysml2Result sysml2_model_cache_clear(const char *dir, size_t *out_removed) {
+    if (out_removed) *out_removed = 0;
+    if (!dir) return SYSML2_ERROR_SEMANTIC;
+
+    DIR *d = opendir(dir);
+    if (!d) {
+        return errno == ENOENT ? SYSML2_OK : SYSML2_ERROR_FILE_READ;
+    }
+
+    Sysml2Result result = SYSML2_OK;
+    size_t removed = 0;
+    size_t ext_len = strlen(SYSML2_MODEL_CACHE_EXT);
+    struct dirent *entry;
+    while ((entry = readdir(d)) != NULL) {
+        /* Match "<key>.smc" and leftover "<key>.smc.tmp.<pid>" files */
+        const char *ext = strstr(entry->d_name, SYSML2_MODEL_CACHE_EXT);
+        if (!ext || ext == entry->d_name) continue;
+        if (ext[ext_len] != '\0' && strncmp(ext + ext_len, ".tmp.", 5) != 0) continue;
+
+        char *path = sysml2_path_join(dir, entry->d_name);
+        if (!path) {
+            result = SYSML2_ERROR_OUT_OF_MEMORY;
+            break;
+        }
+        if (unlink(path) == 0) {
+            removed++;
+        } else if (errno != ENOENT) {
+            result = SYSML2_ERROR_FILE_READ;
+        }
+        free(path);
+    }
+    closedir(d);
+
+    if (out_removed) *out_removed = removed;
+    return result;
+}
+
+/* ========== Package Index ========== */
+
+/* Write a whole entry through a temp file so readers never see part of it */
+static Sysml2Result write_entry_file(const char *final_path, const void *data, size_t length) {
+    size_t tmp_len = strlen(final_path) + 32;
+    char *tmp_path = malloc(tmp_len);
+    if (!tmp_path) return SYSML2_ERROR_OUT_OF_MEMORY;
+    snprintf(tmp_path, tmp_len, "%s.tmp.%ld", final_path, (long)getpid());
+
+    Sysml2Result result = SYSML2_OK;
+    FILE *out = fopen(tmp_path, "wb");
+    if (!out) {
+        result = SYSML2_ERROR_FILE_READ;
+    } else {
+        bool ok = fwrite(data, 1, length, out) == length;
+        if (fclose(out) != 0) ok = false;
+        if (!ok || rename(tmp_path, final_path) != 0) {
+            unlink(tmp_path);
+            result = SYSML2_ERROR_FILE_READ;
+        }
+    }
+    free(tmp_path);
+    return result;
+}
+
+/* Index entry layout: IndexHeader, root path, then for each entry an
+ * IndexRecord followed by the path and package name bytes. */
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t root_length;
+    uint32_t entry_count;
+} IndexHeader;
+
+typedef struct {
+    uint32_t is_directory;
+    uint32_t path_length;
+    uint32_t package_length;         /* INDEX_NO_PACKAGE if none */
+    uint32_t reserved;
+    uint64_t size;
+    int64_t mtime;
+} IndexRecord;
+
+#define INDEX_NO_PACKAGE UINT32_MAX
+
+/* Index entries share the cache directory with model entries; the key
+ * gets a suffix no source path ends with so the names cannot collide. */
+static char *index_entry_path(const Sysml2ModelCache *cache, const char *root) {
+    size_t len = strlen(root);
+    char *key = malloc(len + sizeof("\n#packages"));
+    if (!key) return NULL;
+    memcpy(key, root, len);
+    memcpy(key + len, "\n#packages", sizeof("\n#packages"));
+    char *path = entry_path(cache, key);
+    free(key);
+    return path;
+}
+
+void sysml2_package_index_init(Sysml2PackageIndex *index) {
+    index->entries = NULL;
+    index->count = 0;
+    index->capacity = 0;
+}
+
+void sysml2_package_index_free(Sysml2PackageIndex *index) {
+    if (!index) return;
+    for (size_t i = 0; i < index->count; i++) {
+        free(index->entries[i].path);
+        free(index->entries[i].package);
+    }
+    free(index->entries);
+    sysml2_package_index_init(index);
+}
+
+/* Append an entry, taking ownership of path and package */
+static bool index_append(Sysml2PackageIndex *index, Sysml2PackageIndexEntry entry) {
+    if (index->count >= index->capacity) {
+        size_t new_capacity = index->capacity ? index->capacity * 2 : 32;
+        Sysml2PackageIndexEntry *entries = realloc(
+            index->entries, new_capacity * sizeof(Sysml2PackageIndexEntry));
+        if (!entries) {
+            free(entry.path);
+            free(entry.package);
+            return false;
+        }
+        index->entries = entries;
+        index->capacity = new_capacity;
+    }
+    index->entries[index->count++] = entry;
+    return true;
+}
+
+bool sysml2_package_index_add(
+    Sysml2PackageIndex *index,
+    const char *path,
+    const char *package,
+    size_t package_length,
+    bool is_directory
+) {
+    if (!index || !path) return false;
+
+    struct stat st;
+    if (stat(path, &st) != 0) return false;
+
+    Sysml2PackageIndexEntry entry = {0};
+    entry.is_directory = is_directory;
+    entry.size = is_directory ? 0 : (uint64_t)st.st_size;
+    entry.mtime = stat_mtime_ns(&st);
+
+    /* Same racy-timestamp rule as model entries */
+    int64_t now = (int64_t)time(NULL) * 1000000000LL;
+    if (now - entry.mtime < CACHE_RACY_WINDOW_NS) {
+        entry.mtime = CACHE_MTIME_UNTRUSTED;
+    }
+
+    entry.path = strdup(path);
+    if (!entry.path) return false;
+    if (package) {
+        entry.package = malloc(package_length + 1);
+        if (!entry.package) {
+            free(entry.path);
+            return false;
+        }
+        memcpy(entry.package, package, package_length);
+        entry.package[package_length] = '\0';
+    }
+    return index_append(index, entry);
+}
+
+/* Check that a recorded path has not changed since it was scanned */
+static bool index_entry_current(const Sysml2PackageIndexEntry *entry) {
+    if (entry->mtime == CACHE_MTIME_UNTRUSTED) return false;
+
+    struct stat st;
+    if (stat(entry->path, &st) != 0) return false;
+    if (entry->is_directory != S_ISDIR(st.st_mode)) return false;
+    if (!entry->is_directory && entry->size != (uint64_t)st.st_size) return false;
+    return entry->mtime == stat_mtime_ns(&st);
+}
+
+static bool decode_index(
+    const uint8_t *data,
+    size_t size,
+    const char *root,
+    Sysml2PackageIndex *index
+) {
+    IndexHeader header;
+    if (size < sizeof(header)) return false;
+    memcpy(&header, data, sizeof(header));
+
+    if (memcmp(header.magic, SYSML2_PACKAGE_INDEX_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != SYSML2_MODEL_CACHE_VERSION ||
+        header.byte_order != CACHE_BYTE_ORDER_MARK) {
+        return false;
+    }
+
+    size_t pos = sizeof(header);
+    size_t root_len = strlen(root);
+    if (header.root_length != root_len || root_len > size - pos ||
+        memcmp(data + pos, root, root_len) != 0) {
+        return false;
+    }
+    pos += root_len;
+
+    /* Each entry needs at least a record, which bounds the count */
+    if (header.entry_count > (size - pos) / sizeof(IndexRecord)) return false;
+
+    for (uint32_t i = 0; i < header.entry_count; i++) {
+        IndexRecord record;
+        if (sizeof(record) > size - pos) return false;
+        memcpy(&record, data + pos, sizeof(record));
+        pos += sizeof(record);
+
+        size_t package_len = record.package_length == INDEX_NO_PACKAGE ? 0 : record.package_length;
+        if (record.path_length > size - pos || package_len > size - pos - record.path_length) {
+            return false;
+        }
+
+        Sysml2PackageIndexEntry entry = {0};
+        entry.is_directory = record.is_directory != 0;
+        entry.size = record.size;
+        entry.mtime = record.mtime;
+        entry.path = malloc((size_t)record.path_length + 1);
+        if (!entry.path) return false;
+        memcpy(entry.path, data + pos, record.path_length);
+        entry.path[record.path_length] = '\0';
+        pos += record.path_length;
+
+        if (record.package_length != INDEX_NO_PACKAGE) {
+            entry.package = malloc(package_len + 1);
+            if (!entry.package) {
+                free(entry.path);
+                return false;
+            }
+            memcpy(entry.package, data + pos, package_len);
+            entry.package[package_len] = '\0';
+            pos += package_len;
+        }
+
+        if (!index_append(index, entry)) return false;
+        if (!index_entry_current(&index->entries[index->count - 1])) return false;
+    }
+    return pos == size;
+}
+
+bool sysml2_model_cache_load_package_index(
+    Sysml2ModelCache *cache,
+    const char *root,
+    Sysml2PackageIndex *out_index
+) {
+    if (!out_index) return false;
+    sysml2_package_index_init(out_index);
+    if (!cache || !root) return false;
+
+    char *path = index_entry_path(cache, root);
+    if (!path) return false;
+
+    bool ok = false;
+    int fd = open(path, O_RDONLY);
+    if (fd >= 0) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            size_t size = (size_t)st.st_size;
+            void *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED) {
+                ok = decode_index((const uint8_t *)data, size, root, out_index);
+                munmap(data, size);
+            }
+        }
+        close(fd);
+    }
+    free(path);
+
+    if (!ok) {
+        sysml2_package_index_free(out_index);
+    }
+    return ok;
+}
+
+Sysml2Result sysml2_model_cache_store_package_index(
+    Sysml2ModelCache *cache,
+    const char *root,
+    const Sysml2PackageIndex *index
+) {
+    if (!cache || !root || !index) return SYSML2_ERROR_SEMANTIC;
+    if (index->count > UINT32_MAX) return SYSML2_ERROR_SEMANTIC;
+
+    size_t root_len = strlen(root);
+    IndexHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SYSML2_PACKAGE_INDEX_MAGIC, sizeof(header.magic));
+    header.version = SYSML2_MODEL_CACHE_VERSION;
+    header.byte_order = CACHE_BYTE_ORDER_MARK;
+    header.root_length = (uint32_t)root_len;
+    header.entry_count = (uint32_t)index->count;
+
+    ByteBuf buf = {0};
+    buf.ok = true;
+    buf_append(&buf, &header, sizeof(header));
+    buf_append(&buf, root, root_len);
+    for (size_t i = 0; i < index->count; i++) {
+        const Sysml2PackageIndexEntry *entry = &index->entries[i];
+        size_t path_len = strlen(entry->path);
+        size_t package_len = entry->package ? strlen(entry->package) : 0;
+
+        IndexRecord record;
+        memset(&record, 0, sizeof(record));
+        record.is_directory = entry->is_directory ? 1 : 0;
+        record.path_length = (uint32_t)path_len;
+        record.package_length = entry->package ? (uint32_t)package_len : INDEX_NO_PACKAGE;
+        record.size = entry->size;
+        record.mtime = entry->mtime;
+
+        buf_append(&buf, &record, sizeof(record));
+        buf_append(&buf, entry->path, path_len);
+        if (entry->package) buf_append(&buf, entry->package, package_len);
+    }
+    if (!buf.ok) {
+        free(buf.data);
+        return SYSML2_ERROR_OUT_OF_MEMORY;
+    }
+
+    char *final_path = index_entry_path(cache, root);
+    Sysml2Result result = final_path
+        ? write_entry_file(final_path, buf.data, buf.length)
+        : SYSML2_ERROR_OUT_OF_MEMORY;
+    free(final_path);
+    free(buf.data);
+    return result;
+}
+
+/* ========== Validation Results ========== */
+
+/* Result entry layout: ResultHeader, source path, then for each
+ * dependency a ResultDependencyRecord followed by its path, then the
+ * diagnostics as uint32 words and strings ({ uint32 length; bytes; '\0' },
+ * length RESULT_NULL_STRING for NULL). */
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t config_hash;
+    uint32_t path_length;
+    uint32_t dependency_count;
+    uint32_t diagnostic_count;
+    uint32_t reserved;
+} ResultHeader;
+
+typedef struct {
+    uint64_t size;
+    uint64_t content_hash;
+    uint32_t path_length;
+    uint32_t reserved;
+} ResultDependencyRecord;
+
+#define RESULT_NULL_STRING UINT32_MAX
+
+/* Where a stored diagnostic points: nowhere, the entry's own file, or a
+ * file named by the path that follows */
+enum { RESULT_FILE_NONE, RESULT_FILE_OWN, RESULT_FILE_OTHER };
+
+static char *result_entry_path(const Sysml2ModelCache *cache, const char *abs_path) {
+    size_t len = strlen(abs_path);
+    char *key = malloc(len + sizeof("\n#results"));
+    if (!key) return NULL;
+    memcpy(key, abs_path, len);
+    memcpy(key + len, "\n#results", sizeof("\n#results"));
+    char *path = entry_path(cache, key);
+    free(key);
+    return path;
+}
+
+static void res_u32(ByteBuf *buf, uint32_t value) {
+    buf_append(buf, &value, sizeof(value));
+}
+
+static void res_str(ByteBuf *buf, const char *str) {
+    if (!str) {
+        res_u32(buf, RESULT_NULL_STRING);
+        return;
+    }
+    size_t len = strlen(str);
+    res_u32(buf, (uint32_t)len);
+    buf_append(buf, str, len + 1);
+}
+
+static void res_range(ByteBuf *buf, Sysml2SourceRange range) {
+    res_u32(buf, range.start.line);
+    res_u32(buf, range.start.column);
+    res_u32(buf, range.start.offset);
+    res_u32(buf, range.end.line);
+    res_u32(buf, range.end.column);
+    res_u32(buf, range.end.offset);
+}
+
+static void res_file(ByteBuf *buf, const Sysml2SourceFile *file, const Sysml2SourceFile *own_file) {
+    if (!file) {
+        res_u32(buf, RESULT_FILE_NONE);
+    } else if (file == own_file) {
+        res_u32(buf, RESULT_FILE_OWN);
+    } else {
+        res_u32(buf, RESULT_FILE_OTHER);
+        res_str(buf, file->path);
+    }
+}
+
+static void res_diagnostic(ByteBuf *buf, const Sysml2Diagnostic *diag,
+                           const Sysml2SourceFile *own_file) {
+    res_u32(buf, (uint32_t)diag->code);
+    res_u32(buf, (uint32_t)diag->severity);
+    res_range(buf, diag->range);
+    res_file(buf, diag->file, own_file);
+    res_str(buf, diag->message);
+    res_str(buf, diag->help);
+
+    res_u32(buf, (uint32_t)diag->fixit_count);
+    for (size_t i = 0; i < diag->fixit_count; i++) {
+        res_range(buf, diag->fixits[i].range);
+        res_str(buf, diag->fixits[i].replacement);
+    }
+
+    uint32_t note_count = 0;
+    for (const Sysml2Diagnostic *note = diag->notes; note; note = note->next) note_count++;
+    res_u32(buf, note_count);
+    for (const Sysml2Diagnostic *note = diag->notes; note; note = note->next) {
+        res_u32(buf, (uint32_t)note->code);
+        res_range(buf, note->range);
+        res_file(buf, note->file, own_file);
+        res_str(buf, note->message);
+        res_str(buf, note->help);
+    }
+}
+
+Sysml2Result sysml2_model_cache_store_results(
+    Sysml2ModelCache *cache,
+    const char *abs_path,
+    uint64_t config_hash,
+    const Sysml2ResultDependency *deps,
+    size_t dep_count,
+    const Sysml2Diagnostic *const *diags,
+    size_t diag_count,
+    const Sysml2SourceFile *own_file
+) {
+    if (!cache || !abs_path || (dep_count > 0 && !deps) || (diag_count > 0 && !diags)) {
+        return SYSML2_ERROR_SEMANTIC;
+    }
+    if (dep_count > UINT32_MAX || diag_count > UINT32_MAX) return SYSML2_ERROR_SEMANTIC;
+
+    size_t path_len = strlen(abs_path);
+    ResultHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SYSML2_RESULT_CACHE_MAGIC, sizeof(header.magic));
+    header.version = SYSML2_MODEL_CACHE_VERSION;
+    header.byte_order = CACHE_BYTE_ORDER_MARK;
+    header.config_hash = config_hash;
+    header.path_length = (uint32_t)path_len;
+    header.dependency_count = (uint32_t)dep_count;
+    header.diagnostic_count = (uint32_t)diag_count;
+
+    ByteBuf buf = {0};
+    buf.ok = true;
+    buf_append(&buf, &header, sizeof(header));
+    buf_append(&buf, abs_path, path_len);
+    for (size_t i = 0; i < dep_count; i++) {
+        ResultDependencyRecord record;
+        memset(&record, 0, sizeof(record));
+        record.size = deps[i].size;
+        record.content_hash = deps[i].content_hash;
+        record.path_length = (uint32_t)strlen(deps[i].path);
+        buf_append(&buf, &record, sizeof(record));
+        buf_append(&buf, deps[i].path, record.path_length);
+    }
+    for (size_t i = 0; i < diag_count; i++) {
+        res_diagnostic(&buf, diags[i], own_file);
+    }
+    if (!buf.ok) {
+        free(buf.data);
+        return SYSML2_ERROR_OUT_OF_MEMORY;
+    }
+
+    char *final_path = result_entry_path(cache, abs_path);
+    Sysml2Result result = final_path
+        ? write_entry_file(final_path, buf.data, buf.length)
+        : SYSML2_ERROR_OUT_OF_MEMORY;
+    free(final_path);
+    free(buf.data);
+    return result;
+}
+
+/* Everything needed to turn stored diagnostics back into live ones */
+typedef struct {
+    Decoder dec;
+    Sysml2DiagContext *diag;
+    const Sysml2SourceFile *own_file;
+    Sysml2ResultFileLookup lookup;
+    void *lookup_data;
+} ResultDecoder;
+
+/* Strings point into the mapped entry; diagnostics copy them */
+static const char *res_dec_str(ResultDecoder *rd) {
+    Decoder *dec = &rd->dec;
+    uint32_t len = dec_u32(dec);
+    if (!dec->ok || len == RESULT_NULL_STRING) return NULL;
+    if ((size_t)len >= (size_t)(dec->end - dec->pos) || dec->pos[len] != '\0') {
+        dec->ok = false;
+        return NULL;
+    }
+    const char *str = (const char *)dec->pos;
+    dec->pos += (size_t)len + 1;
+    return str;
+}
+
+static Sysml2SourceRange res_dec_range(ResultDecoder *rd) {
+    Sysml2SourceRange range;
+    range.start = dec_loc(&rd->dec);
+    range.end = dec_loc(&rd->dec);
+    return range;
+}
+
+static const Sysml2SourceFile *res_dec_file(ResultDecoder *rd) {
+    uint32_t tag = dec_u32(&rd->dec);
+    if (tag == RESULT_FILE_NONE) return NULL;
+    if (tag == RESULT_FILE_OWN) return rd->own_file;
+
+    const char *path = res_dec_str(rd);
+    const Sysml2SourceFile *file = NULL;
+    if (tag == RESULT_FILE_OTHER && path && rd->lookup) {
+        file = rd->lookup(rd->lookup_data, path);
+    }
+    /* A file this run does not know cannot be pointed at */
+    if (!file) rd->dec.ok = false;
+    return file;
+}
+
+static Sysml2Diagnostic *res_dec_diagnostic(ResultDecoder *rd) {
+    Decoder *dec = &rd->dec;
+    Sysml2DiagCode code = (Sysml2DiagCode)dec_u32(dec);
+    Sysml2Severity severity = (Sysml2Severity)dec_u32(dec);
+    Sysml2SourceRange range = res_dec_range(rd);
+    const Sysml2SourceFile *file = res_dec_file(rd);
+    const char *message = res_dec_str(rd);
+    const char *help = res_dec_str(rd);
+    if (!dec->ok || !message || severity > SYSML2_SEVERITY_FATAL) {
+        dec->ok = false;
+        return NULL;
+    }
+
+    Sysml2Diagnostic *diag = sysml2_diag_create(rd->diag, code, severity, file, range, message);
+    if (help) sysml2_diag_add_help(diag, rd->diag, help);
+
+    size_t fixit_count = dec_count(dec);
+    for (size_t i = 0; i < fixit_count && dec->ok; i++) {
+        Sysml2SourceRange fixit_range = res_dec_range(rd);
+        const char *replacement = res_dec_str(rd);
+        if (dec->ok && replacement) {
+            sysml2_diag_add_fixit(diag, rd->diag, fixit_range, replacement);
+        } else {
+            dec->ok = false;
+        }
+    }
+
+    size_t note_count = dec_count(dec);
+    for (size_t i = 0; i < note_count && dec->ok; i++) {
+        Sysml2DiagCode note_code = (Sysml2DiagCode)dec_u32(dec);
+        Sysml2SourceRange note_range = res_dec_range(rd);
+        const Sysml2SourceFile *note_file = res_dec_file(rd);
+        const char *note_message = res_dec_str(rd);
+        const char *note_help = res_dec_str(rd);
+        if (!dec->ok || !note_message) {
+            dec->ok = false;
+            break;
+        }
+        Sysml2Diagnostic *note = sysml2_diag_add_note(diag, rd->diag, note_file,
+                                                      note_range, note_message);
+        note->code = note_code;
+        if (note_help) sysml2_diag_add_help(note, rd->diag, note_help);
+    }
+    return dec->ok ? diag : NULL;
+}
+
+static bool decode_results(
+    ResultDecoder *rd,
+    const uint8_t *data,
+    size_t size,
+    const char *abs_path,
+    uint64_t config_hash,
+    const Sysml2ResultDependency *deps,
+    size_t dep_count
+) {
+    ResultHeader header;
+    if (size < sizeof(header)) return false;
+    memcpy(&header, data, sizeof(header));
+
+    if (memcmp(header.magic, SYSML2_RESULT_CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != SYSML2_MODEL_CACHE_VERSION ||
+        header.byte_order != CACHE_BYTE_ORDER_MARK ||
+        header.config_hash != config_hash ||
+        header.dependency_count != dep_count) {
+        return false;
+    }
+
+    size_t pos = sizeof(header);
+    size_t path_len = strlen(abs_path);
+    if (header.path_length != path_len || path_len > size - pos ||
+        memcmp(data + pos, abs_path, path_len) != 0) {
+        return false;
+    }
+    pos += path_len;
+
+    for (size_t i = 0; i < dep_count; i++) {
+        ResultDependencyRecord record;
+        if (sizeof(record) > size - pos) return false;
+        memcpy(&record, data + pos, sizeof(record));
+        pos += sizeof(record);
+
+        size_t dep_len = strlen(deps[i].path);
+        if (record.size != deps[i].size || record.content_hash != deps[i].content_hash ||
+            record.path_length != dep_len || dep_len > size - pos ||
+            memcmp(data + pos, deps[i].path, dep_len) != 0) {
+            return false;
+        }
+        pos += dep_len;
+    }
+
+    /* Every diagnostic takes well over four words, which bounds the count */
+    rd->dec.pos = data + pos;
+    rd->dec.end = data + size;
+    rd->dec.ok = true;
+    if (header.diagnostic_count > (size - pos) / (4 * sizeof(uint32_t))) return false;
+
+    Sysml2Diagnostic **diags = NULL;
+    if (header.diagnostic_count > 0) {
+        diags = malloc(header.diagnostic_count * sizeof(Sysml2Diagnostic *));
+        if (!diags) return false;
+    }
+    for (uint32_t i = 0; i < header.diagnostic_count && rd->dec.ok; i++) {
+        diags[i] = res_dec_diagnostic(rd);
+    }
+    bool ok = rd->dec.ok && rd->dec.pos == rd->dec.end;
+
+    /* Only a whole entry is reported */
+    if (ok) {
+        for (uint32_t i = 0; i < header.diagnostic_count; i++) {
+            sysml2_diag_emit(rd->diag, diags[i]);
+        }
+    }
+    free(diags);
+    return ok;
+}
+
+bool sysml2_model_cache_load_results(
+    Sysml2ModelCache *cache,
+    const char *abs_path,
+    uint64_t config_hash,
+    const Sysml2ResultDependency *deps,
+    size_t dep_count,
+    Sysml2DiagContext *diag,
+    const Sysml2SourceFile *own_file,
+    Sysml2ResultFileLookup lookup,
+    void *lookup_data
+) {
+    if (!cache || !abs_path || !diag || (dep_count > 0 && !deps)) return false;
+
+    char *path = result_entry_path(cache, abs_path);
+    if (!path) return false;
+
+    ResultDecoder rd = {
+        .dec = {0},
+        .diag = diag,
+        .own_file = own_file,
+        .lookup = lookup,
+        .lookup_data = lookup_data,
+    };
+
+    bool ok = false;
+    int fd = open(path, O_RDONLY);
+    if (fd >= 0) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            size_t size = (size_t)st.st_size;
+            void *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED) {
+                ok = decode_results(&rd, (const uint8_t *)data, size, abs_path,
+                                    config_hash, deps, dep_count);
+                munmap(data, size);
+            }
+        }
+        close(fd);
+    }
+    free(path);
+    return ok;
+}
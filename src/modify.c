@@ -5,16 +5,17 @@
  */
 
 #include "sysml2/modify.h"
+#include "sysml2/utils.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
 /*
- * Helper: Check if ID is in a set of IDs
+ * Helper: Check if a name is in a short array of interned names
  */
-static bool id_in_set(const char *id, const char **set, size_t count) {
+static bool id_in_array(const char *id, const char **ids, size_t count) {
     for (size_t i = 0; i < count; i++) {
-        if (strcmp(set[i], id) == 0) {
+        if (sysml2_id_eq(ids[i], id)) {
             return true;
         }
     }
@@ -22,37 +23,73 @@ static bool id_in_set(const char *id, const char **set, size_t count) {
 }
 
 /*
- * Helper: Add ID to a dynamic set
+ * ID set: IDs in insertion order, indexed by the query engine's hash set
+ * so bulk deletes and merges test membership in constant time
  */
-static bool add_to_id_set(
-    const char *id,
-    const char ***set,
-    size_t *count,
-    size_t *capacity,
-    Sysml2Arena *arena
-) {
+typedef struct {
+    const char **ids;
+    size_t count;
+    size_t capacity;
+    Sysml2IdSet index;
+} IdSet;
+
+/*
+ * Helper: Check if ID is in a set of IDs
+ */
+static bool id_in_set(const IdSet *set, const char *id) {
+    return sysml2_id_set_contains(&set->index, id);
+}
+
+/*
+ * Helper: Add ID to a set
+ */
+static bool add_to_id_set(IdSet *set, const char *id, Sysml2Arena *arena) {
     /* Check if already in set */
-    if (id_in_set(id, *set, *count)) {
+    if (id_in_set(set, id)) {
         return true;
     }
 
     /* Grow capacity if needed */
-    if (*count >= *capacity) {
-        size_t new_cap = *capacity == 0 ? 32 : *capacity * 2;
-        const char **new_set = sysml2_arena_alloc(arena, new_cap * sizeof(const char *));
-        if (!new_set) return false;
+    if (set->count >= set->capacity) {
+        size_t new_cap = set->capacity == 0 ? 32 : set->capacity * 2;
+        const char **new_ids = sysml2_arena_alloc(arena, new_cap * sizeof(const char *));
+        if (!new_ids) return false;
 
-        if (*set) {
-            memcpy(new_set, *set, *count * sizeof(const char *));
+        if (set->ids) {
+            memcpy(new_ids, set->ids, set->count * sizeof(const char *));
         }
-        *set = new_set;
-        *capacity = new_cap;
+        set->ids = new_ids;
+        set->capacity = new_cap;
     }
 
-    (*set)[(*count)++] = id;
+    if (!sysml2_id_set_add(&set->index, id, arena)) {
+        return false;
+    }
+    set->ids[set->count++] = id;
     return true;
 }
 
+/*
+ * Helper: Clone a model without copying anything it points to
+ *
+ * Parsed nodes, relationships, imports and aliases are never changed in
+ * place by the modify engine, so an edit only allocates the arrays it
+ * filters and the nodes it replaces; everything else stays shared with
+ * the original.
+ */
+static SysmlSemanticModel *share_model(const SysmlSemanticModel *original, Sysml2Arena *arena) {
+    SysmlSemanticModel *clone = SYSML2_ARENA_NEW(arena, SysmlSemanticModel);
+    if (!clone) return NULL;
+
+    *clone = *original;
+    clone->file_metadata_capacity = clone->file_metadata_count;
+    clone->element_capacity = clone->element_count;
+    clone->relationship_capacity = clone->relationship_count;
+    clone->import_capacity = clone->import_count;
+    clone->alias_capacity = clone->alias_count;
+    return clone;
+}
+
 /*
  * Create a new modification plan
  */
@@ -230,18 +267,22 @@ SysmlSemanticModel *sysml2_modify_clone_with_deletions(
         return NULL;
     }
 
+    Sysml2QueryMatcher *matcher = sysml2_query_compile(patterns, arena);
+    if (!matcher) {
+        if (out_deleted_count) *out_deleted_count = 0;
+        return NULL;
+    }
+
     /* Collect IDs to delete */
-    const char **deleted_ids = NULL;
-    size_t deleted_count = 0;
-    size_t deleted_capacity = 0;
+    IdSet deleted_ids = {0};
 
     /* Pass 1: Direct matches against patterns */
     for (size_t i = 0; i < original->element_count; i++) {
         SysmlNode *node = original->elements[i];
         if (!node || !node->id) continue;
 
-        if (sysml2_query_matches_any(patterns, node->id)) {
-            add_to_id_set(node->id, &deleted_ids, &deleted_count, &deleted_capacity, arena);
+        if (sysml2_query_matcher_matches_node(matcher, node)) {
+            add_to_id_set(&deleted_ids, node->id, arena);
         }
         /* Also match anonymous elements by their redefines targets.
          * Handles: part :>> x { } where node has anonymous ID but redefines[0] = "x"
@@ -260,8 +301,8 @@ SysmlSemanticModel *sysml2_modify_clone_with_deletions(
                 memcpy(synthetic + pid_len + 2, node->redefines[r], ref_len);
                 synthetic[syn_len - 1] = '\0';
 
-                if (sysml2_query_matches_any(patterns, synthetic)) {
-                    add_to_id_set(node->id, &deleted_ids, &deleted_count, &deleted_capacity, arena);
+                if (sysml2_query_matcher_matches(matcher, synthetic)) {
+                    add_to_id_set(&deleted_ids, node->id, arena);
                     break;
                 }
             }
@@ -277,73 +318,40 @@ SysmlSemanticModel *sysml2_modify_clone_with_deletions(
             if (!node || !node->id) continue;
 
             /* Skip if already deleted */
-            if (id_in_set(node->id, deleted_ids, deleted_count)) continue;
+            if (id_in_set(&deleted_ids, node->id)) continue;
 
             /* Check if parent is deleted */
-            if (node->parent_id && id_in_set(node->parent_id, deleted_ids, deleted_count)) {
-                add_to_id_set(node->id, &deleted_ids, &deleted_count, &deleted_capacity, arena);
+            if (node->parent_id && id_in_set(&deleted_ids, node->parent_id)) {
+                add_to_id_set(&deleted_ids, node->id, arena);
                 changed = true;
             }
         }
     }
 
-    if (out_deleted_count) *out_deleted_count = deleted_count;
-
-    /* If nothing to delete, return a shallow clone */
-    if (deleted_count == 0) {
-        /* Create a copy of the model structure */
-        SysmlSemanticModel *clone = sysml2_arena_alloc(arena, sizeof(SysmlSemanticModel));
-        if (!clone) return NULL;
-
-        clone->source_name = original->source_name;
-        clone->element_count = original->element_count;
-        clone->element_capacity = original->element_count;
-        clone->relationship_count = original->relationship_count;
-        clone->relationship_capacity = original->relationship_count;
-        clone->import_count = original->import_count;
-        clone->import_capacity = original->import_count;
+    if (out_deleted_count) *out_deleted_count = deleted_ids.count;
 
-        /* Copy element pointers (they're immutable) */
-        if (original->element_count > 0) {
-            clone->elements = sysml2_arena_alloc(arena, original->element_count * sizeof(SysmlNode *));
-            if (!clone->elements) return NULL;
-            memcpy(clone->elements, original->elements, original->element_count * sizeof(SysmlNode *));
-        } else {
-            clone->elements = NULL;
-        }
-
-        /* Copy relationship pointers */
-        if (original->relationship_count > 0) {
-            clone->relationships = sysml2_arena_alloc(arena, original->relationship_count * sizeof(SysmlRelationship *));
-            if (!clone->relationships) return NULL;
-            memcpy(clone->relationships, original->relationships, original->relationship_count * sizeof(SysmlRelationship *));
-        } else {
-            clone->relationships = NULL;
-        }
-
-        /* Copy import pointers */
-        if (original->import_count > 0) {
-            clone->imports = sysml2_arena_alloc(arena, original->import_count * sizeof(SysmlImport *));
-            if (!clone->imports) return NULL;
-            memcpy(clone->imports, original->imports, original->import_count * sizeof(SysmlImport *));
-        } else {
-            clone->imports = NULL;
-        }
-
-        return clone;
+    /* If nothing to delete, share the original's arrays */
+    if (deleted_ids.count == 0) {
+        return share_model(original, arena);
     }
 
     /* Create new model */
-    SysmlSemanticModel *result = sysml2_arena_alloc(arena, sizeof(SysmlSemanticModel));
+    SysmlSemanticModel *result = SYSML2_ARENA_NEW(arena, SysmlSemanticModel);
     if (!result) return NULL;
 
     result->source_name = original->source_name;
+    result->source_file = original->source_file;
+    result->file_metadata = original->file_metadata;
+    result->file_metadata_count = original->file_metadata_count;
+    result->file_metadata_capacity = original->file_metadata_count;
     result->element_count = 0;
     result->element_capacity = original->element_count;
     result->relationship_count = 0;
     result->relationship_capacity = original->relationship_count;
     result->import_count = 0;
     result->import_capacity = original->import_count;
+    result->alias_count = 0;
+    result->alias_capacity = original->alias_count;
 
     /* Allocate arrays */
     if (original->element_count > 0) {
@@ -367,12 +375,19 @@ SysmlSemanticModel *sysml2_modify_clone_with_deletions(
         result->imports = NULL;
     }
 
+    if (original->alias_count > 0) {
+        result->aliases = sysml2_arena_alloc(arena, original->alias_count * sizeof(SysmlAlias *));
+        if (!result->aliases) return NULL;
+    } else {
+        result->aliases = NULL;
+    }
+
     /* Pass 3: Copy non-deleted elements */
     for (size_t i = 0; i < original->element_count; i++) {
         SysmlNode *node = original->elements[i];
         if (!node || !node->id) continue;
 
-        if (!id_in_set(node->id, deleted_ids, deleted_count)) {
+        if (!id_in_set(&deleted_ids, node->id)) {
             result->elements[result->element_count++] = node;
         }
     }
@@ -382,8 +397,8 @@ SysmlSemanticModel *sysml2_modify_clone_with_deletions(
         SysmlRelationship *rel = original->relationships[i];
         if (!rel) continue;
 
-        bool source_deleted = rel->source && id_in_set(rel->source, deleted_ids, deleted_count);
-        bool target_deleted = rel->target && id_in_set(rel->target, deleted_ids, deleted_count);
+        bool source_deleted = rel->source && id_in_set(&deleted_ids, rel->source);
+        bool target_deleted = rel->target && id_in_set(&deleted_ids, rel->target);
 
         if (!source_deleted && !target_deleted) {
             result->relationships[result->relationship_count++] = rel;
@@ -395,13 +410,23 @@ SysmlSemanticModel *sysml2_modify_clone_with_deletions(
         SysmlImport *imp = original->imports[i];
         if (!imp) continue;
 
-        bool owner_deleted = imp->owner_scope && id_in_set(imp->owner_scope, deleted_ids, deleted_count);
+        bool owner_deleted = imp->owner_scope && id_in_set(&deleted_ids, imp->owner_scope);
 
         if (!owner_deleted) {
             result->imports[result->import_count++] = imp;
         }
     }
 
+    /* Pass 6: Filter aliases (remove if owner scope deleted) */
+    for (size_t i = 0; i < original->alias_count; i++) {
+        SysmlAlias *alias = original->aliases[i];
+        if (!alias) continue;
+
+        if (!(alias->owner_scope && id_in_set(&deleted_ids, alias->owner_scope))) {
+            result->aliases[result->alias_count++] = alias;
+        }
+    }
+
     return result;
 }
 
@@ -469,65 +494,29 @@ SysmlSemanticModel *sysml2_modify_create_scope_chain(
     if (!model || !scope_id || !arena || !intern) return NULL;
 
     /* Collect scopes that need to be created */
-    const char **scopes_to_create = NULL;
-    size_t scope_count = 0;
-    size_t scope_capacity = 0;
+    IdSet scopes_to_create = {0};
 
     /* Walk up the scope chain */
     const char *current = scope_id;
     while (current && *current) {
         if (!sysml2_modify_scope_exists(model, current)) {
-            add_to_id_set(current, &scopes_to_create, &scope_count, &scope_capacity, arena);
+            current = sysml2_intern(intern, current);
+            add_to_id_set(&scopes_to_create, current, arena);
         }
         current = sysml2_query_parent_path(current, arena);
     }
 
-    /* If nothing to create, return a shallow clone */
-    if (scope_count == 0) {
-        SysmlSemanticModel *clone = sysml2_arena_alloc(arena, sizeof(SysmlSemanticModel));
-        if (!clone) return NULL;
-
-        clone->source_name = model->source_name;
-        clone->element_count = model->element_count;
-        clone->element_capacity = model->element_count;
-
-        if (model->element_count > 0) {
-            clone->elements = sysml2_arena_alloc(arena, model->element_count * sizeof(SysmlNode *));
-            if (!clone->elements) return NULL;
-            memcpy(clone->elements, model->elements, model->element_count * sizeof(SysmlNode *));
-        } else {
-            clone->elements = NULL;
-        }
-
-        clone->relationship_count = model->relationship_count;
-        clone->relationship_capacity = model->relationship_count;
-        if (model->relationship_count > 0) {
-            clone->relationships = sysml2_arena_alloc(arena, model->relationship_count * sizeof(SysmlRelationship *));
-            if (!clone->relationships) return NULL;
-            memcpy(clone->relationships, model->relationships, model->relationship_count * sizeof(SysmlRelationship *));
-        } else {
-            clone->relationships = NULL;
-        }
-
-        clone->import_count = model->import_count;
-        clone->import_capacity = model->import_count;
-        if (model->import_count > 0) {
-            clone->imports = sysml2_arena_alloc(arena, model->import_count * sizeof(SysmlImport *));
-            if (!clone->imports) return NULL;
-            memcpy(clone->imports, model->imports, model->import_count * sizeof(SysmlImport *));
-        } else {
-            clone->imports = NULL;
-        }
-
-        return clone;
+    /* If nothing to create, share the original's arrays */
+    if (scopes_to_create.count == 0) {
+        return share_model(model, arena);
     }
 
-    /* Create new model with space for new scopes */
-    size_t new_element_count = model->element_count + scope_count;
-    SysmlSemanticModel *result = sysml2_arena_alloc(arena, sizeof(SysmlSemanticModel));
+    /* Create new model with space for new scopes; relationships, imports
+     * and aliases are unchanged and stay shared */
+    size_t new_element_count = model->element_count + scopes_to_create.count;
+    SysmlSemanticModel *result = share_model(model, arena);
     if (!result) return NULL;
 
-    result->source_name = model->source_name;
     result->element_count = 0;
     result->element_capacity = new_element_count;
     result->elements = sysml2_arena_alloc(arena, new_element_count * sizeof(SysmlNode *));
@@ -539,8 +528,8 @@ SysmlSemanticModel *sysml2_modify_create_scope_chain(
     }
 
     /* Create new scope packages (in reverse order so parents come first) */
-    for (size_t i = scope_count; i > 0; i--) {
-        const char *scope = scopes_to_create[i - 1];
+    for (size_t i = scopes_to_create.count; i > 0; i--) {
+        const char *scope = scopes_to_create.ids[i - 1];
 
         SysmlNode *node = sysml2_arena_alloc(arena, sizeof(SysmlNode));
         if (!node) return NULL;
@@ -553,32 +542,11 @@ SysmlSemanticModel *sysml2_modify_create_scope_chain(
         if (node->parent_id) {
             node->parent_id = sysml2_intern(intern, node->parent_id);
         }
+        sysml2_node_derive_path(node);
 
         result->elements[result->element_count++] = node;
     }
 
-    /* Copy relationships */
-    result->relationship_count = model->relationship_count;
-    result->relationship_capacity = model->relationship_count;
-    if (model->relationship_count > 0) {
-        result->relationships = sysml2_arena_alloc(arena, model->relationship_count * sizeof(SysmlRelationship *));
-        if (!result->relationships) return NULL;
-        memcpy(result->relationships, model->relationships, model->relationship_count * sizeof(SysmlRelationship *));
-    } else {
-        result->relationships = NULL;
-    }
-
-    /* Copy imports */
-    result->import_count = model->import_count;
-    result->import_capacity = model->import_count;
-    if (model->import_count > 0) {
-        result->imports = sysml2_arena_alloc(arena, model->import_count * sizeof(SysmlImport *));
-        if (!result->imports) return NULL;
-        memcpy(result->imports, model->imports, model->import_count * sizeof(SysmlImport *));
-    } else {
-        result->imports = NULL;
-    }
-
     return result;
 }
 
@@ -903,12 +871,127 @@ static SysmlTextualRep *sysml2_modify_copy_textual_rep(
     return dst;
 }
 
+/*
+ * Remapper: fragment IDs moved under the target scope, each built and
+ * interned once per merge (the same IDs come back as parent IDs,
+ * relationship ends and import owners)
+ */
+typedef struct {
+    const char *target_scope;
+    Sysml2IdMap remapped;               /* Fragment ID -> remapped ID */
+    Sysml2Arena *arena;
+    Sysml2Intern *intern;
+} Remapper;
+
+/* Same result as sysml2_modify_remap_id(id, target_scope, ...) */
+static const char *remap(Remapper *remapper, const char *id) {
+    if (!id || *id == '\0') {
+        return sysml2_modify_remap_id(id, remapper->target_scope, remapper->arena, remapper->intern);
+    }
+
+    const char *known = sysml2_id_map_get(&remapper->remapped, id);
+    if (known) return known;
+
+    const char *new_id = sysml2_modify_remap_id(id, remapper->target_scope,
+                                                remapper->arena, remapper->intern);
+    Sysml2IdMapSlot *slot = new_id
+        ? sysml2_id_map_slot(&remapper->remapped, id, remapper->arena) : NULL;
+    if (slot) slot->value = (void *)new_id;
+    return new_id;
+}
+
+/*
+ * Node list: the elements stored under one ID map key, in model order
+ */
+typedef struct NodeLink {
+    SysmlNode *node;
+    size_t index;                       /* Position in the model's element array */
+    struct NodeLink *next;
+} NodeLink;
+
+typedef struct {
+    NodeLink *head;
+    NodeLink *tail;
+} NodeList;
+
+/* Append node to the list stored under key */
+static bool node_list_add(Sysml2IdMap *map, const char *key, SysmlNode *node, size_t index,
+                          Sysml2Arena *arena) {
+    Sysml2IdMapSlot *slot = sysml2_id_map_slot(map, key, arena);
+    if (!slot) return false;
+
+    NodeList *list = slot->value;
+    if (!list) {
+        list = SYSML2_ARENA_NEW(arena, NodeList);
+        if (!list) return false;
+        slot->value = list;
+    }
+
+    NodeLink *link = SYSML2_ARENA_NEW(arena, NodeLink);
+    if (!link) return false;
+    link->node = node;
+    link->index = index;
+    link->next = NULL;
+    if (list->tail) {
+        list->tail->next = link;
+    } else {
+        list->head = link;
+    }
+    list->tail = link;
+    return true;
+}
+
+/* First link of the list stored under key, or NULL */
+static NodeLink *node_list_first(const Sysml2IdMap *map, const char *key) {
+    NodeList *list = sysml2_id_map_get(map, key);
+    return list ? list->head : NULL;
+}
+
+/* Set key for the child called name of the element with ID parent_id */
+static const char *child_key(const char *parent_id, const char *name, Sysml2Arena *arena) {
+    size_t parent_len = strlen(parent_id);
+    size_t name_len = strlen(name);
+    char *key = sysml2_arena_alloc(arena, parent_len + name_len + 2);
+    if (!key) return NULL;
+
+    /* 0x1f cannot occur in a name, so no two pairs share a key */
+    memcpy(key, parent_id, parent_len);
+    key[parent_len] = '\x1f';
+    memcpy(key + parent_len + 1, name, name_len + 1);
+    return key;
+}
+
+/* Offsets of the elements a merge has placed under one parent so far */
+typedef struct {
+    uint32_t max_offset;
+    bool any_nonzero;
+} SiblingOffsets;
+
+/* Append node to a merge result, keeping the sibling offsets up to date */
+static bool append_element(SysmlSemanticModel *result, SysmlNode *node, Sysml2IdMap *siblings,
+                           Sysml2Arena *arena) {
+    result->elements[result->element_count++] = node;
+    if (!node->parent_id) return true;
+
+    Sysml2IdMapSlot *slot = sysml2_id_map_slot(siblings, node->parent_id, arena);
+    if (!slot) return false;
+    SiblingOffsets *offsets = slot->value;
+    if (!offsets) {
+        offsets = SYSML2_ARENA_NEW(arena, SiblingOffsets);
+        if (!offsets) return false;
+        slot->value = offsets;
+    }
+    if (node->loc.offset > offsets->max_offset) offsets->max_offset = node->loc.offset;
+    if (node->loc.offset > 0) offsets->any_nonzero = true;
+    return true;
+}
+
 /*
  * Deep copy a node with all its pointer arrays
  */
 static SysmlNode *sysml2_modify_deep_copy_node(
     SysmlNode *src,
-    const char *target_scope,
+    Remapper *remapper,
     Sysml2Arena *arena,
     Sysml2Intern *intern
 ) {
@@ -921,13 +1004,14 @@ static SysmlNode *sysml2_modify_deep_copy_node(
     memcpy(dst, src, sizeof(SysmlNode));
 
     /* Remap IDs */
-    dst->id = sysml2_modify_remap_id(src->id, target_scope, arena, intern);
+    dst->id = remap(remapper, src->id);
     if (src->parent_id) {
-        dst->parent_id = sysml2_modify_remap_id(src->parent_id, target_scope, arena, intern);
+        dst->parent_id = remap(remapper, src->parent_id);
     } else {
         /* Top-level fragment element → parent is target scope */
-        dst->parent_id = sysml2_intern(intern, target_scope);
+        dst->parent_id = sysml2_intern(intern, remapper->target_scope);
     }
+    sysml2_node_derive_path(dst);
 
     /* Deep copy typed_by array */
     if (src->typed_by_count > 0 && src->typed_by) {
@@ -964,89 +1048,96 @@ static SysmlNode *sysml2_modify_deep_copy_node(
         memcpy(dst->references, src->references, src->references_count * sizeof(const char *));
     }
 
-    /* Deep copy metadata array */
-    if (src->metadata_count > 0 && src->metadata) {
-        dst->metadata = sysml2_arena_alloc(arena, src->metadata_count * sizeof(SysmlMetadataUsage *));
-        if (!dst->metadata) return NULL;
-        for (size_t i = 0; i < src->metadata_count; i++) {
-            dst->metadata[i] = sysml2_modify_copy_metadata_usage(src->metadata[i], arena);
+    /* Deep copy the cold record */
+    if (src->cold) {
+        const SysmlNodeCold *from = src->cold;
+        SysmlNodeCold *cold = sysml2_node_cold_detach(arena, dst);
+        if (!cold) return NULL;
+
+        /* Deep copy metadata array */
+        if (from->metadata_count > 0 && from->metadata) {
+            cold->metadata = sysml2_arena_alloc(arena, from->metadata_count * sizeof(SysmlMetadataUsage *));
+            if (!cold->metadata) return NULL;
+            for (size_t i = 0; i < from->metadata_count; i++) {
+                cold->metadata[i] = sysml2_modify_copy_metadata_usage(from->metadata[i], arena);
+            }
         }
-    }
 
-    /* Deep copy prefix_metadata array (interned strings) */
-    if (src->prefix_metadata_count > 0 && src->prefix_metadata) {
-        dst->prefix_metadata = sysml2_arena_alloc(arena, src->prefix_metadata_count * sizeof(const char *));
-        if (!dst->prefix_metadata) return NULL;
-        memcpy(dst->prefix_metadata, src->prefix_metadata, src->prefix_metadata_count * sizeof(const char *));
-    }
+        /* Deep copy prefix_metadata array (interned strings) */
+        if (from->prefix_metadata_count > 0 && from->prefix_metadata) {
+            cold->prefix_metadata = sysml2_arena_alloc(arena, from->prefix_metadata_count * sizeof(const char *));
+            if (!cold->prefix_metadata) return NULL;
+            memcpy(cold->prefix_metadata, from->prefix_metadata, from->prefix_metadata_count * sizeof(const char *));
+        }
 
-    /* Deep copy prefix_applied_metadata array */
-    if (src->prefix_applied_metadata_count > 0 && src->prefix_applied_metadata) {
-        dst->prefix_applied_metadata = sysml2_arena_alloc(arena, src->prefix_applied_metadata_count * sizeof(SysmlMetadataUsage *));
-        if (!dst->prefix_applied_metadata) return NULL;
-        for (size_t i = 0; i < src->prefix_applied_metadata_count; i++) {
-            dst->prefix_applied_metadata[i] = sysml2_modify_copy_metadata_usage(src->prefix_applied_metadata[i], arena);
+        /* Deep copy prefix_applied_metadata array */
+        if (from->prefix_applied_metadata_count > 0 && from->prefix_applied_metadata) {
+            cold->prefix_applied_metadata = sysml2_arena_alloc(arena, from->prefix_applied_metadata_count * sizeof(SysmlMetadataUsage *));
+            if (!cold->prefix_applied_metadata) return NULL;
+            for (size_t i = 0; i < from->prefix_applied_metadata_count; i++) {
+                cold->prefix_applied_metadata[i] = sysml2_modify_copy_metadata_usage(from->prefix_applied_metadata[i], arena);
+            }
         }
-    }
 
-    /* Deep copy trivia linked lists */
-    dst->leading_trivia = sysml2_modify_copy_trivia(src->leading_trivia, arena);
-    dst->trailing_trivia = sysml2_modify_copy_trivia(src->trailing_trivia, arena);
+        /* Deep copy trivia linked lists */
+        cold->leading_trivia = sysml2_modify_copy_trivia(from->leading_trivia, arena);
+        cold->trailing_trivia = sysml2_modify_copy_trivia(from->trailing_trivia, arena);
 
-    /* Deep copy body_stmts array */
-    if (src->body_stmt_count > 0 && src->body_stmts) {
-        dst->body_stmts = sysml2_arena_alloc(arena, src->body_stmt_count * sizeof(SysmlStatement *));
-        if (!dst->body_stmts) return NULL;
-        for (size_t i = 0; i < src->body_stmt_count; i++) {
-            dst->body_stmts[i] = sysml2_modify_copy_statement(src->body_stmts[i], arena);
-        }
+        /* Deep copy body_stmts array */
+        if (from->body_stmt_count > 0 && from->body_stmts) {
+            cold->body_stmts = sysml2_arena_alloc(arena, from->body_stmt_count * sizeof(SysmlStatement *));
+            if (!cold->body_stmts) return NULL;
+            for (size_t i = 0; i < from->body_stmt_count; i++) {
+                cold->body_stmts[i] = sysml2_modify_copy_statement(from->body_stmts[i], arena);
+            }
 
-        /* Fix comment duplication: if trailing_trivia text appears in any body_stmt's
-         * raw_text, the parser has double-captured it. Clear the duplicate trivia.
-         * This commonly happens with trailing line comments on shorthand features. */
-        if (dst->trailing_trivia && dst->trailing_trivia->text) {
-            const char *trivia_text = dst->trailing_trivia->text;
-            for (size_t i = 0; i < dst->body_stmt_count; i++) {
-                if (dst->body_stmts[i] && dst->body_stmts[i]->raw_text &&
-                    strstr(dst->body_stmts[i]->raw_text, trivia_text)) {
-                    /* Trivia is already in a body statement - clear the duplicate */
-                    dst->trailing_trivia = NULL;
-                    break;
+            /* Fix comment duplication: if trailing_trivia text appears in any body_stmt's
+             * raw_text, the parser has double-captured it. Clear the duplicate trivia.
+             * This commonly happens with trailing line comments on shorthand features. */
+            if (cold->trailing_trivia && cold->trailing_trivia->text) {
+                const char *trivia_text = cold->trailing_trivia->text;
+                for (size_t i = 0; i < cold->body_stmt_count; i++) {
+                    if (cold->body_stmts[i] && cold->body_stmts[i]->raw_text &&
+                        strstr(cold->body_stmts[i]->raw_text, trivia_text)) {
+                        /* Trivia is already in a body statement - clear the duplicate */
+                        cold->trailing_trivia = NULL;
+                        break;
+                    }
                 }
             }
-        }
 
-        /* Fix leading trivia duplication: same logic for leading comments.
-         * This handles cases where comments before an element appear both as
-         * leading_trivia and within a body statement's raw_text during merges. */
-        if (dst->leading_trivia && dst->leading_trivia->text) {
-            const char *trivia_text = dst->leading_trivia->text;
-            for (size_t i = 0; i < dst->body_stmt_count; i++) {
-                if (dst->body_stmts[i] && dst->body_stmts[i]->raw_text &&
-                    strstr(dst->body_stmts[i]->raw_text, trivia_text)) {
-                    /* Trivia is already in a body statement - clear the duplicate */
-                    dst->leading_trivia = NULL;
-                    break;
+            /* Fix leading trivia duplication: same logic for leading comments.
+             * This handles cases where comments before an element appear both as
+             * leading_trivia and within a body statement's raw_text during merges. */
+            if (cold->leading_trivia && cold->leading_trivia->text) {
+                const char *trivia_text = cold->leading_trivia->text;
+                for (size_t i = 0; i < cold->body_stmt_count; i++) {
+                    if (cold->body_stmts[i] && cold->body_stmts[i]->raw_text &&
+                        strstr(cold->body_stmts[i]->raw_text, trivia_text)) {
+                        /* Trivia is already in a body statement - clear the duplicate */
+                        cold->leading_trivia = NULL;
+                        break;
+                    }
                 }
             }
         }
-    }
 
-    /* Deep copy comments array */
-    if (src->comment_count > 0 && src->comments) {
-        dst->comments = sysml2_arena_alloc(arena, src->comment_count * sizeof(SysmlNamedComment *));
-        if (!dst->comments) return NULL;
-        for (size_t i = 0; i < src->comment_count; i++) {
-            dst->comments[i] = sysml2_modify_copy_named_comment(src->comments[i], arena);
+        /* Deep copy comments array */
+        if (from->comment_count > 0 && from->comments) {
+            cold->comments = sysml2_arena_alloc(arena, from->comment_count * sizeof(SysmlNamedComment *));
+            if (!cold->comments) return NULL;
+            for (size_t i = 0; i < from->comment_count; i++) {
+                cold->comments[i] = sysml2_modify_copy_named_comment(from->comments[i], arena);
+            }
         }
-    }
 
-    /* Deep copy textual_reps array */
-    if (src->textual_rep_count > 0 && src->textual_reps) {
-        dst->textual_reps = sysml2_arena_alloc(arena, src->textual_rep_count * sizeof(SysmlTextualRep *));
-        if (!dst->textual_reps) return NULL;
-        for (size_t i = 0; i < src->textual_rep_count; i++) {
-            dst->textual_reps[i] = sysml2_modify_copy_textual_rep(src->textual_reps[i], arena);
+        /* Deep copy textual_reps array */
+        if (from->textual_rep_count > 0 && from->textual_reps) {
+            cold->textual_reps = sysml2_arena_alloc(arena, from->textual_rep_count * sizeof(SysmlTextualRep *));
+            if (!cold->textual_reps) return NULL;
+            for (size_t i = 0; i < from->textual_rep_count; i++) {
+                cold->textual_reps[i] = sysml2_modify_copy_textual_rep(from->textual_reps[i], arena);
+            }
         }
     }
 
@@ -1140,6 +1231,7 @@ SysmlSemanticModel *sysml2_modify_merge_fragment(
                     node->parent_id = sysml2_intern(intern, node->parent_id + wrapper_id_len + 2);
                 }
             }
+            sysml2_node_derive_path(node);
         }
 
         /* Strip wrapper prefix from import owner_scopes too */
@@ -1175,11 +1267,12 @@ SysmlSemanticModel *sysml2_modify_merge_fragment(
     size_t wrapper_prefix_metadata_count = 0;
 
     if (wrapper_to_unwrap) {
-        wrapper_doc = wrapper_to_unwrap->documentation;
-        wrapper_metadata = wrapper_to_unwrap->metadata;
-        wrapper_metadata_count = wrapper_to_unwrap->metadata_count;
-        wrapper_prefix_metadata = wrapper_to_unwrap->prefix_applied_metadata;
-        wrapper_prefix_metadata_count = wrapper_to_unwrap->prefix_applied_metadata_count;
+        const SysmlNodeCold *wrapper_cold = sysml2_node_cold(wrapper_to_unwrap);
+        wrapper_doc = wrapper_cold->documentation;
+        wrapper_metadata = wrapper_cold->metadata;
+        wrapper_metadata_count = wrapper_cold->metadata_count;
+        wrapper_prefix_metadata = wrapper_cold->prefix_applied_metadata;
+        wrapper_prefix_metadata_count = wrapper_cold->prefix_applied_metadata_count;
     }
 
     /* Step 1: Check if target scope exists (or create it) */
@@ -1195,32 +1288,60 @@ SysmlSemanticModel *sysml2_modify_merge_fragment(
         if (!working_base) return NULL;
     }
 
-    /* Step 2: Build mapping of remapped IDs */
+    /* Step 2: Index both models once, so that matching fragment elements
+     * to base elements below is a lookup rather than a scan per element.
+     * The maps compare IDs by pointer, so the scope is interned first. */
+    const char *scope_id = sysml2_intern(intern, target_scope);
+    if (!scope_id) return NULL;
+    Remapper remapper = { .target_scope = target_scope, .arena = arena, .intern = intern };
+
+    Sysml2IdMap base_by_id = {0};       /* ID -> first base element with it */
+    Sysml2IdMap base_children = {0};    /* Parent ID -> NodeList of base elements */
+    for (size_t i = 0; i < working_base->element_count; i++) {
+        SysmlNode *node = working_base->elements[i];
+        if (!node || !node->id) continue;
+
+        Sysml2IdMapSlot *slot = sysml2_id_map_slot(&base_by_id, node->id, arena);
+        if (!slot) return NULL;
+        if (!slot->value) slot->value = node;
+        if (node->parent_id && !node_list_add(&base_children, node->parent_id, node, i, arena)) {
+            return NULL;
+        }
+    }
+
+    Sysml2IdMap frag_by_id = {0};       /* Remapped ID -> NodeList of fragment elements */
+    Sysml2IdSet frag_child_names = {0}; /* child_key() of every named fragment child */
+
     /* Collect IDs that will be replaced */
-    const char **replaced_ids = NULL;
-    size_t replaced_count = 0;
-    size_t replaced_capacity = 0;
+    IdSet replaced_ids = {0};
 
     for (size_t i = 0; i < fragment->element_count; i++) {
         SysmlNode *frag_node = fragment->elements[i];
         if (!frag_node) continue;
 
+        if (frag_node->parent_id && frag_node->name) {
+            const char *key = child_key(frag_node->parent_id, frag_node->name, arena);
+            if (!key || !sysml2_id_set_add(&frag_child_names, key, arena)) return NULL;
+        }
+
         /* Compute the remapped ID */
-        const char *new_id = sysml2_modify_remap_id(frag_node->id, target_scope, arena, intern);
+        const char *new_id = remap(&remapper, frag_node->id);
         if (!new_id) continue;
+        if (!node_list_add(&frag_by_id, new_id, frag_node, i, arena)) return NULL;
+
+        /* Check if this ID exists in the base */
+        bool exists = sysml2_id_map_get(&base_by_id, new_id) != NULL;
 
         /* Debug logging to trace element matching */
         if (getenv("SYSML2_DEBUG_MODIFY")) {
-            bool exists = sysml2_modify_scope_exists(working_base, new_id);
             fprintf(stderr, "DEBUG: Fragment '%s' -> remapped '%s', exists=%d\n",
                     frag_node->id ? frag_node->id : "(null)",
                     new_id,
                     exists);
         }
 
-        /* Check if this ID exists in the base */
-        if (sysml2_modify_scope_exists(working_base, new_id)) {
-            add_to_id_set(new_id, &replaced_ids, &replaced_count, &replaced_capacity, arena);
+        if (exists) {
+            add_to_id_set(&replaced_ids, new_id, arena);
         }
     }
 
@@ -1238,34 +1359,25 @@ SysmlSemanticModel *sysml2_modify_merge_fragment(
      *
      * @SourceFile deduplication is handled in Step 5 when adding fragment elements.
      */
-    const char **ids_to_remove = NULL;
-    size_t remove_count = 0;
-    size_t remove_capacity = 0;
+    IdSet ids_to_remove = {0};
 
     /* Step 1.5: If replace_scope is set, mark ALL direct children for removal.
      * This clears the scope so fragment elements preserve their order.
      * The target scope itself is NOT removed, only its direct children.
      * Also cascade to grandchildren by adding to cascade tracking.
      */
-    const char **replace_scope_removed = NULL;
-    size_t replace_scope_count = 0;
-    size_t replace_scope_capacity = 0;
+    IdSet replace_scope_removed = {0};
 
     if (replace_scope) {
-        for (size_t i = 0; i < working_base->element_count; i++) {
-            SysmlNode *node = working_base->elements[i];
-            if (!node || !node->id || !node->parent_id) continue;
-
-            /* Mark direct children of target scope for removal */
-            if (strcmp(node->parent_id, target_scope) == 0) {
-                add_to_id_set(node->id, &ids_to_remove, &remove_count, &remove_capacity, arena);
-                add_to_id_set(node->id, &replace_scope_removed, &replace_scope_count, &replace_scope_capacity, arena);
-            }
+        /* Mark direct children of target scope for removal */
+        for (NodeLink *child = node_list_first(&base_children, scope_id); child; child = child->next) {
+            add_to_id_set(&ids_to_remove, child->node->id, arena);
+            add_to_id_set(&replace_scope_removed, child->node->id, arena);
         }
 
         if (getenv("SYSML2_DEBUG_MODIFY")) {
             fprintf(stderr, "DEBUG: replace_scope=true, marked %zu direct children for removal\n",
-                    replace_scope_count);
+                    replace_scope_removed.count);
         }
     }
 
@@ -1279,8 +1391,8 @@ SysmlSemanticModel *sysml2_modify_merge_fragment(
      * We track replaced IDs separately from deleted IDs because replaced
      * elements should NOT cascade deletion to their children.
      */
-    for (size_t i = 0; i < replaced_count; i++) {
-        add_to_id_set(replaced_ids[i], &ids_to_remove, &remove_count, &remove_capacity, arena);
+    for (size_t i = 0; i < replaced_ids.count; i++) {
+        add_to_id_set(&ids_to_remove, replaced_ids.ids[i], arena);
     }
 
     /* Step 2b: Only remove children that are also being replaced by fragment.
@@ -1291,48 +1403,28 @@ SysmlSemanticModel *sysml2_modify_merge_fragment(
      *
      * We track these separately for cascade purposes.
      */
-    const char **children_to_remove = NULL;
-    size_t children_remove_count = 0;
-    size_t children_remove_capacity = 0;
+    IdSet children_to_remove = {0};
 
-    for (size_t i = 0; i < replaced_count; i++) {
-        for (size_t j = 0; j < working_base->element_count; j++) {
-            SysmlNode *node = working_base->elements[j];
-            if (!node || !node->id || !node->parent_id) continue;
-            if (strcmp(node->parent_id, replaced_ids[i]) != 0) continue;
+    for (size_t i = 0; i < replaced_ids.count; i++) {
+        /* The fragment element corresponding to replaced_ids.ids[i] (the
+         * first one moved onto it). The fragment parent has a shorter ID
+         * (without target_scope prefix). */
+        NodeLink *frag_parent = node_list_first(&frag_by_id, replaced_ids.ids[i]);
+        if (!frag_parent || !frag_parent->node->id) continue;
+
+        for (NodeLink *child = node_list_first(&base_children, replaced_ids.ids[i]); child; child = child->next) {
+            SysmlNode *node = child->node;
 
             /* Check if fragment has a child with the same name under the
-             * corresponding parent. The fragment parent has a shorter ID
-             * (without target_scope prefix). */
-            const char *child_name = node->name;
-            if (!child_name) continue;
-
-            /* Find the fragment element corresponding to replaced_ids[i] */
-            for (size_t k = 0; k < fragment->element_count; k++) {
-                SysmlNode *frag_elem = fragment->elements[k];
-                if (!frag_elem) continue;
-
-                /* Check if this fragment element's remapped ID matches replaced_ids[i] */
-                const char *frag_remapped_id = sysml2_modify_remap_id(
-                    frag_elem->id, target_scope, arena, intern);
-                if (!frag_remapped_id || strcmp(frag_remapped_id, replaced_ids[i]) != 0)
-                    continue;
-
-                /* Found the fragment parent. Now check its children in fragment. */
-                for (size_t m = 0; m < fragment->element_count; m++) {
-                    SysmlNode *frag_child = fragment->elements[m];
-                    if (!frag_child || !frag_child->parent_id) continue;
-                    if (strcmp(frag_child->parent_id, frag_elem->id) != 0) continue;
-
-                    /* Fragment has a child of the replaced element */
-                    if (frag_child->name && strcmp(frag_child->name, child_name) == 0) {
-                        /* This base child will be replaced by fragment child */
-                        add_to_id_set(node->id, &ids_to_remove, &remove_count, &remove_capacity, arena);
-                        add_to_id_set(node->id, &children_to_remove, &children_remove_count, &children_remove_capacity, arena);
-                        break;
-                    }
-                }
-                break;
+             * corresponding parent */
+            if (!node->name) continue;
+            const char *key = child_key(frag_parent->node->id, node->name, arena);
+            if (!key) return NULL;
+
+            if (sysml2_id_set_contains(&frag_child_names, key)) {
+                /* This base child will be replaced by fragment child */
+                add_to_id_set(&ids_to_remove, node->id, arena);
+                add_to_id_set(&children_to_remove, node->id, arena);
             }
         }
     }
@@ -1342,34 +1434,27 @@ SysmlSemanticModel *sysml2_modify_merge_fragment(
      * Replaced parents preserve their children (unless also matched by name).
      * Only children that are being replaced should cascade to their descendants.
      * When replace_scope is used, ALL descendants of removed elements are also removed.
+     * Elements already removed as replacements do not cascade.
      */
-    bool changed = true;
-    while (changed) {
-        changed = false;
-        for (size_t j = 0; j < working_base->element_count; j++) {
-            SysmlNode *node = working_base->elements[j];
-            if (!node || !node->id) continue;
-            if (id_in_set(node->id, ids_to_remove, remove_count)) continue;
-
-            /* Cascade from children_to_remove (matched by name) */
-            if (node->parent_id && id_in_set(node->parent_id, children_to_remove, children_remove_count)) {
-                add_to_id_set(node->id, &ids_to_remove, &remove_count, &remove_capacity, arena);
-                add_to_id_set(node->id, &children_to_remove, &children_remove_count, &children_remove_capacity, arena);
-                changed = true;
-            }
-            /* Also cascade from replace_scope removed elements */
-            else if (node->parent_id && id_in_set(node->parent_id, replace_scope_removed, replace_scope_count)) {
-                add_to_id_set(node->id, &ids_to_remove, &remove_count, &remove_capacity, arena);
-                add_to_id_set(node->id, &replace_scope_removed, &replace_scope_count, &replace_scope_capacity, arena);
-                changed = true;
-            }
+    IdSet cascade = {0};
+    for (size_t i = 0; i < children_to_remove.count; i++) {
+        add_to_id_set(&cascade, children_to_remove.ids[i], arena);
+    }
+    for (size_t i = 0; i < replace_scope_removed.count; i++) {
+        add_to_id_set(&cascade, replace_scope_removed.ids[i], arena);
+    }
+    for (size_t i = 0; i < cascade.count; i++) {
+        for (NodeLink *child = node_list_first(&base_children, cascade.ids[i]); child; child = child->next) {
+            if (id_in_set(&ids_to_remove, child->node->id)) continue;
+            add_to_id_set(&ids_to_remove, child->node->id, arena);
+            add_to_id_set(&cascade, child->node->id, arena);
         }
     }
 
     /* Debug logging */
     if (getenv("SYSML2_DEBUG_MODIFY")) {
         fprintf(stderr, "DEBUG: Hybrid mode at scope '%s': removing %zu elements (replaced: %zu)\n",
-                target_scope, remove_count, replaced_count);
+                target_scope, ids_to_remove.count, replaced_ids.count);
     }
 
     /* Step 3: Allocate new model */
@@ -1398,6 +1483,17 @@ SysmlSemanticModel *sysml2_modify_merge_fragment(
     result->imports = sysml2_arena_alloc(arena, max_imports * sizeof(SysmlImport *));
     if (!result->imports) return NULL;
 
+    /* File metadata is untouched; aliases are filtered in Step 8 */
+    result->file_metadata = working_base->file_metadata;
+    result->file_metadata_count = working_base->file_metadata_count;
+    result->file_metadata_capacity = working_base->file_metadata_count;
+
+    if (working_base->alias_count > 0) {
+        result->aliases = sysml2_arena_alloc(arena, working_base->alias_count * sizeof(SysmlAlias *));
+        if (!result->aliases) return NULL;
+        result->alias_capacity = working_base->alias_count;
+    }
+
     /* Check if fragment provides top-level scope metadata.
      * Top-level fragment elements have NULL parent_id (they are direct children of the scope).
      * Only clear target scope metadata if the fragment explicitly provides replacement metadata.
@@ -1406,14 +1502,17 @@ SysmlSemanticModel *sysml2_modify_merge_fragment(
     for (size_t j = 0; j < fragment->element_count; j++) {
         SysmlNode *fnode = fragment->elements[j];
         if (fnode && fnode->parent_id == NULL) {
-            if (fnode->prefix_applied_metadata_count > 0 ||
-                fnode->metadata_count > 0) {
+            if (sysml2_node_cold(fnode)->prefix_applied_metadata_count > 0 ||
+                sysml2_node_cold(fnode)->metadata_count > 0) {
                 fragment_has_scope_metadata = true;
                 break;
             }
         }
     }
 
+    /* Parent ID -> SiblingOffsets of the elements placed in result so far */
+    Sysml2IdMap siblings = {0};
+
     /* Track which fragment elements have been processed (for in-place replacement) */
     bool *fragment_processed = sysml2_arena_alloc(arena,
         fragment->element_count * sizeof(bool));
@@ -1435,7 +1534,7 @@ SysmlSemanticModel *sysml2_modify_merge_fragment(
         if (!node || !node->id) continue;
 
         /* Check if this is a replaced element (not just removed) */
-        if (id_in_set(node->id, replaced_ids, replaced_count)) {
+        if (id_in_set(&replaced_ids, node->id)) {
             /* When replace_scope is true and this is a direct child of the target scope,
              * skip in-place replacement. Let Step 5 add fragment elements in fragment order
              * to preserve the order specified in the fragment. */
@@ -1444,61 +1543,46 @@ SysmlSemanticModel *sysml2_modify_merge_fragment(
             }
 
             /* Find and process the corresponding fragment element in-place */
-            for (size_t fi = 0; fi < fragment->element_count; fi++) {
+            for (NodeLink *match = node_list_first(&frag_by_id, node->id); match; match = match->next) {
+                size_t fi = match->index;
                 if (fragment_processed[fi]) continue;
-                SysmlNode *frag_node = fragment->elements[fi];
-                if (!frag_node) continue;
-
-                /* Check if this fragment element replaces the current base element */
-                const char *remapped_id = sysml2_modify_remap_id(
-                    frag_node->id, target_scope, arena, intern);
-                if (!remapped_id || strcmp(remapped_id, node->id) != 0) continue;
+                SysmlNode *frag_node = match->node;
 
                 /* Found the replacement - process it in-place */
                 fragment_processed[fi] = true;
                 replaced++;
 
                 SysmlNode *new_node = sysml2_modify_deep_copy_node(
-                    frag_node, target_scope, arena, intern);
+                    frag_node, &remapper, arena, intern);
                 if (!new_node) return NULL;
 
                 /* Inherit original location to preserve element ordering */
                 new_node->loc = node->loc;
 
+                SysmlNodeCold *new_cold = sysml2_node_cold_mut(arena, new_node);
+                if (!new_cold) return NULL;
+                const SysmlNodeCold *old_cold = sysml2_node_cold(node);
+
                 /* Filter out blank line trivia to prevent accumulation */
-                new_node->leading_trivia = sysml2_modify_filter_blank_trivia(
-                    new_node->leading_trivia, arena);
+                new_cold->leading_trivia = sysml2_modify_filter_blank_trivia(
+                    new_cold->leading_trivia, arena);
 
                 /* Preserve documentation if fragment has none */
-                if (!new_node->documentation && node->documentation) {
-                    new_node->documentation = node->documentation;
+                if (!new_cold->documentation && old_cold->documentation) {
+                    new_cold->documentation = old_cold->documentation;
                 }
 
                 /* Preserve prefix_applied_metadata if fragment has none */
-                if (new_node->prefix_applied_metadata_count == 0 &&
-                    node->prefix_applied_metadata_count > 0) {
-                    new_node->prefix_applied_metadata = sysml2_arena_alloc(
-                        arena, node->prefix_applied_metadata_count * sizeof(SysmlMetadataUsage *));
-                    if (new_node->prefix_applied_metadata) {
-                        for (size_t k = 0; k < node->prefix_applied_metadata_count; k++) {
-                            new_node->prefix_applied_metadata[k] =
-                                sysml2_modify_copy_metadata_usage(node->prefix_applied_metadata[k], arena);
-                        }
-                        new_node->prefix_applied_metadata_count = node->prefix_applied_metadata_count;
-                    }
+                if (new_cold->prefix_applied_metadata_count == 0 &&
+                    old_cold->prefix_applied_metadata_count > 0) {
+                    new_cold->prefix_applied_metadata = old_cold->prefix_applied_metadata;
+                    new_cold->prefix_applied_metadata_count = old_cold->prefix_applied_metadata_count;
                 }
 
                 /* Preserve body metadata if fragment has none */
-                if (new_node->metadata_count == 0 && node->metadata_count > 0) {
-                    new_node->metadata = sysml2_arena_alloc(
-                        arena, node->metadata_count * sizeof(SysmlMetadataUsage *));
-                    if (new_node->metadata) {
-                        for (size_t k = 0; k < node->metadata_count; k++) {
-                            new_node->metadata[k] =
-                                sysml2_modify_copy_metadata_usage(node->metadata[k], arena);
-                        }
-                        new_node->metadata_count = node->metadata_count;
-                    }
+                if (new_cold->metadata_count == 0 && old_cold->metadata_count > 0) {
+                    new_cold->metadata = old_cold->metadata;
+                    new_cold->metadata_count = old_cold->metadata_count;
                 }
 
                 /* Union merge body_stmts: fragment statements take precedence,
@@ -1507,20 +1591,20 @@ SysmlSemanticModel *sysml2_modify_merge_fragment(
                  *
                  * Deduplication uses both name matching AND raw_text equivalence
                  * to handle cases where whitespace differs but content is same. */
-                if (node->body_stmt_count > 0) {
+                if (old_cold->body_stmt_count > 0) {
                     /* Build set of statement names from fragment */
                     const char **frag_names = sysml2_arena_alloc(
-                        arena, (new_node->body_stmt_count + 1) * sizeof(const char *));
+                        arena, (new_cold->body_stmt_count + 1) * sizeof(const char *));
                     size_t frag_name_count = 0;
 
                     /* Also store raw_text for equivalence checking */
                     const char **frag_raw_texts = sysml2_arena_alloc(
-                        arena, (new_node->body_stmt_count + 1) * sizeof(const char *));
+                        arena, (new_cold->body_stmt_count + 1) * sizeof(const char *));
                     size_t frag_raw_count = 0;
 
                     if (frag_names && frag_raw_texts) {
-                        for (size_t k = 0; k < new_node->body_stmt_count; k++) {
-                            SysmlStatement *stmt = new_node->body_stmts[k];
+                        for (size_t k = 0; k < new_cold->body_stmt_count; k++) {
+                            SysmlStatement *stmt = new_cold->body_stmts[k];
                             if (stmt && stmt->kind == SYSML_STMT_SHORTHAND_FEATURE && stmt->raw_text) {
                                 frag_raw_texts[frag_raw_count++] = stmt->raw_text;
                                 const char *name = sysml2_extract_shorthand_stmt_name(
@@ -1537,7 +1621,7 @@ SysmlSemanticModel *sysml2_modify_merge_fragment(
                         bool _dup = false; \
                         const char *_name = sysml2_extract_shorthand_stmt_name( \
                             (orig_stmt)->raw_text, arena, intern); \
-                        if (_name && id_in_set(_name, frag_names, frag_name_count)) { \
+                        if (_name && id_in_array(_name, frag_names, frag_name_count)) { \
                             _dup = true; \
                         } else { \
                             /* Also check raw_text equivalence for whitespace diffs */ \
@@ -1553,8 +1637,8 @@ SysmlSemanticModel *sysml2_modify_merge_fragment(
 
                     /* Count original statements not in fragment */
                     size_t preserve_count = 0;
-                    for (size_t k = 0; k < node->body_stmt_count; k++) {
-                        SysmlStatement *stmt = node->body_stmts[k];
+                    for (size_t k = 0; k < old_cold->body_stmt_count; k++) {
+                        SysmlStatement *stmt = old_cold->body_stmts[k];
                         if (!stmt) continue;
 
                         if (stmt->kind == SYSML_STMT_SHORTHAND_FEATURE && stmt->raw_text) {
@@ -1569,77 +1653,87 @@ SysmlSemanticModel *sysml2_modify_merge_fragment(
 
                     /* Allocate merged array if we have statements to preserve */
                     if (preserve_count > 0) {
-                        size_t new_total = new_node->body_stmt_count + preserve_count;
+                        size_t new_total = new_cold->body_stmt_count + preserve_count;
                         SysmlStatement **merged = sysml2_arena_alloc(
                             arena, new_total * sizeof(SysmlStatement *));
 
                         if (merged) {
                             size_t idx = 0;
-                            for (size_t k = 0; k < new_node->body_stmt_count; k++) {
-                                merged[idx++] = new_node->body_stmts[k];
+                            for (size_t k = 0; k < new_cold->body_stmt_count; k++) {
+                                merged[idx++] = new_cold->body_stmts[k];
                             }
 
-                            for (size_t k = 0; k < node->body_stmt_count; k++) {
-                                SysmlStatement *stmt = node->body_stmts[k];
+                            for (size_t k = 0; k < old_cold->body_stmt_count; k++) {
+                                SysmlStatement *stmt = old_cold->body_stmts[k];
                                 if (!stmt) continue;
 
                                 if (stmt->kind == SYSML_STMT_SHORTHAND_FEATURE && stmt->raw_text) {
                                     const char *_pname = sysml2_extract_shorthand_stmt_name(stmt->raw_text, arena, intern);
                                     if (_pname && strcmp(_pname, "doc") == 0) continue;
                                     if (!STMT_IS_DUPLICATE(stmt)) {
-                                        merged[idx++] = sysml2_modify_copy_statement(stmt, arena);
+                                        merged[idx++] = stmt;
                                     }
                                 }
                             }
 
-                            new_node->body_stmts = merged;
-                            new_node->body_stmt_count = idx;
+                            new_cold->body_stmts = merged;
+                            new_cold->body_stmt_count = idx;
                         }
                     }
 
                     #undef STMT_IS_DUPLICATE
                 }
 
-                result->elements[result->element_count++] = new_node;
+                if (!append_element(result, new_node, &siblings, arena)) return NULL;
                 break;  /* Found and processed the replacement */
             }
             continue;  /* Skip to next base element */
         }
 
-        if (!id_in_set(node->id, ids_to_remove, remove_count)) {
+        if (!id_in_set(&ids_to_remove, node->id)) {
             /* For the target scope element itself, conditionally clear metadata.
              * Only clear if the fragment explicitly provides replacement metadata;
              * otherwise preserve existing metadata to prevent data loss. */
-            if (target_scope && strcmp(node->id, target_scope) == 0) {
+            if (target_scope && strcmp(node->id, target_scope) == 0 &&
+                (fragment_has_scope_metadata || wrapper_doc ||
+                 wrapper_metadata_count > 0 || wrapper_prefix_metadata_count > 0)) {
+                /* The base node is shared with the original model; edit a copy */
+                SysmlNode *scope_copy = SYSML2_ARENA_NEW(arena, SysmlNode);
+                if (!scope_copy) return NULL;
+                *scope_copy = *node;
+                node = scope_copy;
+                SysmlNodeCold *cold = sysml2_node_cold_detach(arena, node);
+                if (!cold) return NULL;
+
                 if (fragment_has_scope_metadata) {
-                    node->prefix_applied_metadata = NULL;
-                    node->prefix_applied_metadata_count = 0;
-                    node->metadata = NULL;
-                    node->metadata_count = 0;
+                    cold->prefix_applied_metadata = NULL;
+                    cold->prefix_applied_metadata_count = 0;
+                    cold->metadata = NULL;
+                    cold->metadata_count = 0;
                 }
 
                 /* Apply wrapper metadata/documentation to target scope if wrapper was unwrapped.
                  * This preserves scope-level annotations when a fragment uses a wrapper package. */
-                if (wrapper_doc && !node->documentation) {
-                    node->documentation = wrapper_doc;
+                if (wrapper_doc && !cold->documentation) {
+                    cold->documentation = wrapper_doc;
                 }
-                if (wrapper_metadata_count > 0 && node->metadata_count == 0) {
-                    node->metadata = wrapper_metadata;
-                    node->metadata_count = wrapper_metadata_count;
+                if (wrapper_metadata_count > 0 && cold->metadata_count == 0) {
+                    cold->metadata = wrapper_metadata;
+                    cold->metadata_count = wrapper_metadata_count;
                 }
-                if (wrapper_prefix_metadata_count > 0 && node->prefix_applied_metadata_count == 0) {
-                    node->prefix_applied_metadata = wrapper_prefix_metadata;
-                    node->prefix_applied_metadata_count = wrapper_prefix_metadata_count;
+                if (wrapper_prefix_metadata_count > 0 && cold->prefix_applied_metadata_count == 0) {
+                    cold->prefix_applied_metadata = wrapper_prefix_metadata;
+                    cold->prefix_applied_metadata_count = wrapper_prefix_metadata_count;
                 }
 
                 /* Only clear trivia when scope metadata was actually replaced,
                  * to preserve blank lines and formatting when just adding elements */
                 if (fragment_has_scope_metadata) {
-                    node->leading_trivia = NULL;
-                    node->trailing_trivia = NULL;
+                    cold->leading_trivia = NULL;
+                    cold->trailing_trivia = NULL;
                 }
             }
-            result->elements[result->element_count++] = node;
+            if (!append_element(result, node, &siblings, arena)) return NULL;
         }
     }
 
@@ -1656,22 +1750,15 @@ SysmlSemanticModel *sysml2_modify_merge_fragment(
         if (!frag_node) continue;
 
         /* Deep copy node with all pointer arrays and remapped IDs */
-        SysmlNode *new_node = sysml2_modify_deep_copy_node(frag_node, target_scope, arena, intern);
+        SysmlNode *new_node = sysml2_modify_deep_copy_node(frag_node, &remapper, arena, intern);
         if (!new_node) return NULL;
 
         /* Check if this was a replacement (shouldn't happen, but handle for safety) */
-        if (id_in_set(new_node->id, replaced_ids, replaced_count)) {
+        if (id_in_set(&replaced_ids, new_node->id)) {
             /* This is a fallback - normally replacements are handled in Step 4 */
 
             /* Find original element once for all preservation logic */
-            SysmlNode *orig = NULL;
-            for (size_t j = 0; j < working_base->element_count; j++) {
-                if (working_base->elements[j] && working_base->elements[j]->id &&
-                    strcmp(working_base->elements[j]->id, new_node->id) == 0) {
-                    orig = working_base->elements[j];
-                    break;
-                }
-            }
+            SysmlNode *orig = sysml2_id_map_get(&base_by_id, new_node->id);
 
             if (orig) {
                 /* Inherit original location to preserve element ordering.
@@ -1679,39 +1766,29 @@ SysmlSemanticModel *sysml2_modify_merge_fragment(
                  * source file offsets would otherwise get reordered. */
                 new_node->loc = orig->loc;
 
+                SysmlNodeCold *new_cold = sysml2_node_cold_mut(arena, new_node);
+                if (!new_cold) return NULL;
+                const SysmlNodeCold *old_cold = sysml2_node_cold(orig);
+
                 /* Filter out blank line trivia to prevent accumulation */
-                new_node->leading_trivia = sysml2_modify_filter_blank_trivia(
-                    new_node->leading_trivia, arena);
+                new_cold->leading_trivia = sysml2_modify_filter_blank_trivia(
+                    new_cold->leading_trivia, arena);
 
                 /* Preserve documentation if fragment has none */
-                if (!new_node->documentation && orig->documentation) {
-                    new_node->documentation = orig->documentation;  /* Interned string */
+                if (!new_cold->documentation && old_cold->documentation) {
+                    new_cold->documentation = old_cold->documentation;  /* Interned string */
                 }
 
                 /* Preserve prefix_applied_metadata if fragment has none */
-                if (new_node->prefix_applied_metadata_count == 0 && orig->prefix_applied_metadata_count > 0) {
-                    new_node->prefix_applied_metadata = sysml2_arena_alloc(
-                        arena, orig->prefix_applied_metadata_count * sizeof(SysmlMetadataUsage *));
-                    if (new_node->prefix_applied_metadata) {
-                        for (size_t k = 0; k < orig->prefix_applied_metadata_count; k++) {
-                            new_node->prefix_applied_metadata[k] =
-                                sysml2_modify_copy_metadata_usage(orig->prefix_applied_metadata[k], arena);
-                        }
-                        new_node->prefix_applied_metadata_count = orig->prefix_applied_metadata_count;
-                    }
+                if (new_cold->prefix_applied_metadata_count == 0 && old_cold->prefix_applied_metadata_count > 0) {
+                    new_cold->prefix_applied_metadata = old_cold->prefix_applied_metadata;
+                    new_cold->prefix_applied_metadata_count = old_cold->prefix_applied_metadata_count;
                 }
 
                 /* Preserve body metadata if fragment has none */
-                if (new_node->metadata_count == 0 && orig->metadata_count > 0) {
-                    new_node->metadata = sysml2_arena_alloc(
-                        arena, orig->metadata_count * sizeof(SysmlMetadataUsage *));
-                    if (new_node->metadata) {
-                        for (size_t k = 0; k < orig->metadata_count; k++) {
-                            new_node->metadata[k] =
-                                sysml2_modify_copy_metadata_usage(orig->metadata[k], arena);
-                        }
-                        new_node->metadata_count = orig->metadata_count;
-                    }
+                if (new_cold->metadata_count == 0 && old_cold->metadata_count > 0) {
+                    new_cold->metadata = old_cold->metadata;
+                    new_cold->metadata_count = old_cold->metadata_count;
                 }
 
                 /* Union merge body_stmts: fragment statements take precedence,
@@ -1720,20 +1797,20 @@ SysmlSemanticModel *sysml2_modify_merge_fragment(
                  *
                  * Deduplication uses both name matching AND raw_text equivalence
                  * to handle cases where whitespace differs but content is same. */
-                if (orig->body_stmt_count > 0) {
+                if (old_cold->body_stmt_count > 0) {
                     /* Build set of statement names from fragment */
                     const char **frag_names = sysml2_arena_alloc(
-                        arena, (new_node->body_stmt_count + 1) * sizeof(const char *));
+                        arena, (new_cold->body_stmt_count + 1) * sizeof(const char *));
                     size_t frag_name_count = 0;
 
                     /* Also store raw_text for equivalence checking */
                     const char **frag_raw_texts = sysml2_arena_alloc(
-                        arena, (new_node->body_stmt_count + 1) * sizeof(const char *));
+                        arena, (new_cold->body_stmt_count + 1) * sizeof(const char *));
                     size_t frag_raw_count = 0;
 
                     if (frag_names && frag_raw_texts) {
-                        for (size_t k = 0; k < new_node->body_stmt_count; k++) {
-                            SysmlStatement *stmt = new_node->body_stmts[k];
+                        for (size_t k = 0; k < new_cold->body_stmt_count; k++) {
+                            SysmlStatement *stmt = new_cold->body_stmts[k];
                             if (stmt && stmt->kind == SYSML_STMT_SHORTHAND_FEATURE && stmt->raw_text) {
                                 frag_raw_texts[frag_raw_count++] = stmt->raw_text;
                                 const char *name = sysml2_extract_shorthand_stmt_name(
@@ -1750,7 +1827,7 @@ SysmlSemanticModel *sysml2_modify_merge_fragment(
                         bool _dup = false; \
                         const char *_name = sysml2_extract_shorthand_stmt_name( \
                             (orig_stmt)->raw_text, arena, intern); \
-                        if (_name && id_in_set(_name, frag_names, frag_name_count)) { \
+                        if (_name && id_in_array(_name, frag_names, frag_name_count)) { \
                             _dup = true; \
                         } else { \
                             /* Also check raw_text equivalence for whitespace diffs */ \
@@ -1766,8 +1843,8 @@ SysmlSemanticModel *sysml2_modify_merge_fragment(
 
                     /* Count original statements not in fragment */
                     size_t preserve_count = 0;
-                    for (size_t k = 0; k < orig->body_stmt_count; k++) {
-                        SysmlStatement *stmt = orig->body_stmts[k];
+                    for (size_t k = 0; k < old_cold->body_stmt_count; k++) {
+                        SysmlStatement *stmt = old_cold->body_stmts[k];
                         if (!stmt) continue;
 
                         /* Only merge shorthand features by name */
@@ -1785,34 +1862,34 @@ SysmlSemanticModel *sysml2_modify_merge_fragment(
 
                     /* Allocate merged array if we have statements to preserve */
                     if (preserve_count > 0) {
-                        size_t new_total = new_node->body_stmt_count + preserve_count;
+                        size_t new_total = new_cold->body_stmt_count + preserve_count;
                         SysmlStatement **merged = sysml2_arena_alloc(
                             arena, new_total * sizeof(SysmlStatement *));
 
                         if (merged) {
                             /* Copy fragment statements first (they take precedence) */
                             size_t idx = 0;
-                            for (size_t k = 0; k < new_node->body_stmt_count; k++) {
-                                merged[idx++] = new_node->body_stmts[k];
+                            for (size_t k = 0; k < new_cold->body_stmt_count; k++) {
+                                merged[idx++] = new_cold->body_stmts[k];
                             }
 
                             /* Append preserved original statements */
-                            for (size_t k = 0; k < orig->body_stmt_count; k++) {
-                                SysmlStatement *stmt = orig->body_stmts[k];
+                            for (size_t k = 0; k < old_cold->body_stmt_count; k++) {
+                                SysmlStatement *stmt = old_cold->body_stmts[k];
                                 if (!stmt) continue;
 
                                 if (stmt->kind == SYSML_STMT_SHORTHAND_FEATURE && stmt->raw_text) {
                                     const char *_pname = sysml2_extract_shorthand_stmt_name(stmt->raw_text, arena, intern);
                                     if (_pname && strcmp(_pname, "doc") == 0) continue;
                                     if (!STMT_IS_DUPLICATE2(stmt)) {
-                                        /* Deep copy the preserved statement */
-                                        merged[idx++] = sysml2_modify_copy_statement(stmt, arena);
+                                        /* Share the preserved statement */
+                                        merged[idx++] = stmt;
                                     }
                                 }
                             }
 
-                            new_node->body_stmts = merged;
-                            new_node->body_stmt_count = idx;
+                            new_cold->body_stmts = merged;
+                            new_cold->body_stmt_count = idx;
                         }
                     }
 
@@ -1833,21 +1910,10 @@ SysmlSemanticModel *sysml2_modify_merge_fragment(
              * - Siblings have offset=0: set new element's offset to 0 (insertion order applies)
              */
             if (new_node->parent_id) {
-                uint32_t max_sibling_offset = 0;
-                bool has_sibling = false;
-                bool has_nonzero_sibling = false;
-                for (size_t j = 0; j < result->element_count; j++) {
-                    if (result->elements[j] && result->elements[j]->parent_id &&
-                        strcmp(result->elements[j]->parent_id, new_node->parent_id) == 0) {
-                        has_sibling = true;
-                        if (result->elements[j]->loc.offset > max_sibling_offset) {
-                            max_sibling_offset = result->elements[j]->loc.offset;
-                        }
-                        if (result->elements[j]->loc.offset > 0) {
-                            has_nonzero_sibling = true;
-                        }
-                    }
-                }
+                const SiblingOffsets *offsets = sysml2_id_map_get(&siblings, new_node->parent_id);
+                uint32_t max_sibling_offset = offsets ? offsets->max_offset : 0;
+                bool has_sibling = offsets != NULL;
+                bool has_nonzero_sibling = offsets && offsets->any_nonzero;
 
                 if (!has_sibling) {
                     /* No existing siblings - keep original offset to preserve
@@ -1862,16 +1928,17 @@ SysmlSemanticModel *sysml2_modify_merge_fragment(
                      * New element should also use offset=0 to appear after them.
                      * Also zero out body_stmt offsets for consistent sorting. */
                     new_node->loc.offset = 0;
-                    for (size_t k = 0; k < new_node->body_stmt_count; k++) {
-                        if (new_node->body_stmts[k]) {
-                            new_node->body_stmts[k]->loc.offset = 0;
+                    const SysmlNodeCold *new_cold = sysml2_node_cold(new_node);
+                    for (size_t k = 0; k < new_cold->body_stmt_count; k++) {
+                        if (new_cold->body_stmts[k]) {
+                            new_cold->body_stmts[k]->loc.offset = 0;
                         }
                     }
                 }
             }
         }
 
-        result->elements[result->element_count++] = new_node;
+        if (!append_element(result, new_node, &siblings, arena)) return NULL;
     }
 
     /* Step 6: Copy non-affected relationships from base */
@@ -1879,8 +1946,8 @@ SysmlSemanticModel *sysml2_modify_merge_fragment(
         SysmlRelationship *rel = working_base->relationships[i];
         if (!rel) continue;
 
-        bool source_removed = rel->source && id_in_set(rel->source, ids_to_remove, remove_count);
-        bool target_removed = rel->target && id_in_set(rel->target, ids_to_remove, remove_count);
+        bool source_removed = rel->source && id_in_set(&ids_to_remove, rel->source);
+        bool target_removed = rel->target && id_in_set(&ids_to_remove, rel->target);
 
         if (!source_removed && !target_removed) {
             result->relationships[result->relationship_count++] = rel;
@@ -1899,19 +1966,19 @@ SysmlSemanticModel *sysml2_modify_merge_fragment(
         memcpy(new_rel, frag_rel, sizeof(SysmlRelationship));
 
         if (frag_rel->id) {
-            new_rel->id = sysml2_modify_remap_id(frag_rel->id, target_scope, arena, intern);
+            new_rel->id = remap(&remapper, frag_rel->id);
         }
         if (frag_rel->source) {
-            new_rel->source = sysml2_modify_remap_id(frag_rel->source, target_scope, arena, intern);
+            new_rel->source = remap(&remapper, frag_rel->source);
         }
         if (frag_rel->target) {
-            new_rel->target = sysml2_modify_remap_id(frag_rel->target, target_scope, arena, intern);
+            new_rel->target = remap(&remapper, frag_rel->target);
         }
 
         result->relationships[result->relationship_count++] = new_rel;
     }
 
-    /* Step 8: Copy non-affected imports from base
+    /* Step 8: Copy non-affected imports and aliases from base
      *
      * HYBRID MODE: Keep imports unless their owner scope was removed.
      * We do NOT remove all imports owned by the target scope - only those
@@ -1921,13 +1988,22 @@ SysmlSemanticModel *sysml2_modify_merge_fragment(
         SysmlImport *imp = working_base->imports[i];
         if (!imp) continue;
 
-        bool owner_removed = imp->owner_scope && id_in_set(imp->owner_scope, ids_to_remove, remove_count);
+        bool owner_removed = imp->owner_scope && id_in_set(&ids_to_remove, imp->owner_scope);
 
         if (!owner_removed) {
             result->imports[result->import_count++] = imp;
         }
     }
 
+    for (size_t i = 0; i < working_base->alias_count; i++) {
+        SysmlAlias *alias = working_base->aliases[i];
+        if (!alias) continue;
+
+        if (!(alias->owner_scope && id_in_set(&ids_to_remove, alias->owner_scope))) {
+            result->aliases[result->alias_count++] = alias;
+        }
+    }
+
     /* Step 9: Add remapped fragment imports, with deduplication
      *
      * Fragment imports often duplicate imports already in the base model
@@ -1948,7 +2024,7 @@ SysmlSemanticModel *sysml2_modify_merge_fragment(
          * so the import becomes scoped to the target rather than staying top-level. */
         const char *new_owner;
         if (frag_imp->owner_scope) {
-            new_owner = sysml2_modify_remap_id(frag_imp->owner_scope, target_scope, arena, intern);
+            new_owner = remap(&remapper, frag_imp->owner_scope);
         } else if (target_scope) {
             /* Unwrapped imports belong to target scope, not top-level */
             new_owner = sysml2_intern(intern, target_scope);
@@ -1992,7 +2068,7 @@ SysmlSemanticModel *sysml2_modify_merge_fragment(
         memcpy(new_imp, frag_imp, sizeof(SysmlImport));
 
         if (frag_imp->id) {
-            new_imp->id = sysml2_modify_remap_id(frag_imp->id, target_scope, arena, intern);
+            new_imp->id = remap(&remapper, frag_imp->id);
         }
         new_imp->owner_scope = new_owner;
         /* Note: target is NOT remapped - it refers to external elements */
@@ -2169,69 +2245,6 @@ bool sysml2_modify_list_scopes_multi(
     return true;
 }
 
-/*
- * Calculate simple edit distance between two strings (for fuzzy matching)
- * Limited to max_dist to avoid expensive comparisons
- */
-static size_t simple_edit_distance(const char *s1, const char *s2, size_t max_dist) {
-    size_t len1 = strlen(s1);
-    size_t len2 = strlen(s2);
-
-    /* Quick length check */
-    if (len1 > len2 + max_dist || len2 > len1 + max_dist) {
-        return max_dist + 1;
-    }
-
-    /* Simple Levenshtein using two rows */
-    size_t *prev = malloc((len2 + 1) * sizeof(size_t));
-    size_t *curr = malloc((len2 + 1) * sizeof(size_t));
-    if (!prev || !curr) {
-        free(prev);
-        free(curr);
-        return max_dist + 1;
-    }
-
-    for (size_t j = 0; j <= len2; j++) {
-        prev[j] = j;
-    }
-
-    for (size_t i = 1; i <= len1; i++) {
-        curr[0] = i;
-        size_t min_in_row = i;
-
-        for (size_t j = 1; j <= len2; j++) {
-            size_t cost = (s1[i - 1] == s2[j - 1]) ? 0 : 1;
-            curr[j] = prev[j] + 1;  /* deletion */
-            if (curr[j - 1] + 1 < curr[j]) {
-                curr[j] = curr[j - 1] + 1;  /* insertion */
-            }
-            if (prev[j - 1] + cost < curr[j]) {
-                curr[j] = prev[j - 1] + cost;  /* substitution */
-            }
-            if (curr[j] < min_in_row) {
-                min_in_row = curr[j];
-            }
-        }
-
-        /* Early termination if all values in row exceed max_dist */
-        if (min_in_row > max_dist) {
-            free(prev);
-            free(curr);
-            return max_dist + 1;
-        }
-
-        /* Swap rows */
-        size_t *tmp = prev;
-        prev = curr;
-        curr = tmp;
-    }
-
-    size_t result = prev[len2];
-    free(prev);
-    free(curr);
-    return result;
-}
-
 /*
  * Find similar scope names
  */
@@ -2258,6 +2271,8 @@ bool sysml2_modify_find_similar_scopes(
 
     /* Get local name of target for comparison */
     const char *target_local = sysml2_modify_get_local_name(target);
+    Sysml2EditPattern target_pattern;
+    sysml2_edit_pattern_init(&target_pattern, target_local, strlen(target_local));
 
     /* Allocate space for suggestions with scores */
     typedef struct {
@@ -2299,7 +2314,8 @@ bool sysml2_modify_find_similar_scopes(
         }
         /* Edit distance on local name */
         else {
-            size_t dist = simple_edit_distance(scope_local, target_local, max_edit_dist);
+            size_t dist = sysml2_edit_distance_bounded(&target_pattern, scope_local,
+                                                       strlen(scope_local), max_edit_dist);
             if (dist <= max_edit_dist) {
                 score = 10 + dist;
             }
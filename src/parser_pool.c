@@ -0,0 +1,184 @@
+/*
+ * SysML v2 Parser - Parser Memory Pool Implementation
+ *
+ * Each block carries a header with its size class; free blocks are
+ * linked through their payload. Blocks are charged to the memory budget
+ * from malloc to free, so cached blocks count as held. A block is charged
+ * for the most bytes ever requested from it, not its whole class: pages
+ * of the rounded-up tail that nobody touches are never made resident.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "sysml2/parser_pool.h"
+#include "sysml2/memory_budget.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Size classes: 32 bytes .. 16 MiB (PackCC's thunk pools are a few MiB) */
+#define POOL_MIN_SHIFT 5
+#define POOL_MAX_SHIFT 24
+#define POOL_CLASSES (POOL_MAX_SHIFT - POOL_MIN_SHIFT + 1)
+
+/* Class of blocks that bypass the free lists */
+#define POOL_LARGE POOL_CLASSES
+
+typedef union {
+    struct {
+        size_t size_class;
+        size_t bytes;           /* Payload bytes charged to the budget */
+    };
+    max_align_t align;          /* Keeps the payload maximally aligned */
+} BlockHeader;
+
+typedef struct FreeBlock {
+    struct FreeBlock *next;
+} FreeBlock;
+
+typedef struct {
+    FreeBlock *free[POOL_CLASSES];
+    size_t cached;              /* Bytes on the free lists */
+    bool registered;            /* Exit destructor installed */
+    bool exiting;               /* Thread is exiting: stop caching */
+} ThreadPool;
+
+static _Thread_local ThreadPool pool;
+
+static pthread_key_t pool_key;
+static pthread_once_t pool_key_once = PTHREAD_ONCE_INIT;
+static bool pool_key_ok;
+
+static void release_on_exit(void *unused) {
+    (void)unused;
+    sysml2_parser_pool_trim();
+    pool.exiting = true;
+}
+
+static void create_key(void) {
+    pool_key_ok = pthread_key_create(&pool_key, release_on_exit) == 0;
+}
+
+/* Make sure the thread's cache is released when it exits */
+static void register_thread(void) {
+    pool.registered = true;
+    pthread_once(&pool_key_once, create_key);
+    if (pool_key_ok) pthread_setspecific(pool_key, &pool);
+}
+
+static void release_block(BlockHeader *block) {
+    sysml2_memory_release(sizeof(BlockHeader) + block->bytes);
+    free(block);
+}
+
+/* Raise a block's charge to cover size payload bytes */
+static void charge_up_to(BlockHeader *block, size_t size) {
+    if (size <= block->bytes) return;
+    sysml2_memory_charge(size - block->bytes);
+    block->bytes = size;
+}
+
+static size_t class_size(size_t size_class) {
+    return (size_t)1 << (size_class + POOL_MIN_SHIFT);
+}
+
+static size_t class_for(size_t size) {
+    size_t size_class = 0;
+    while (size_class < POOL_CLASSES && class_size(size_class) < size) size_class++;
+    return size_class;
+}
+
+static void out_of_memory(void) {
+    fprintf(stderr, "sysml2: out of memory\n");
+    exit(1);
+}
+
+void *sysml2_parser_pool_alloc(size_t size) {
+    size_t size_class = class_for(size);
+
+    if (size_class < POOL_CLASSES && pool.free[size_class]) {
+        FreeBlock *free_block = pool.free[size_class];
+        pool.free[size_class] = free_block->next;
+        pool.cached -= class_size(size_class);
+        charge_up_to((BlockHeader *)free_block - 1, size);
+        return free_block;
+    }
+
+    size_t capacity = size_class < POOL_CLASSES ? class_size(size_class) : size;
+    if (capacity > SIZE_MAX - sizeof(BlockHeader)) out_of_memory();
+    BlockHeader *block = malloc(sizeof(BlockHeader) + capacity);
+    if (!block) out_of_memory();
+    block->size_class = size_class;
+    block->bytes = size;
+    sysml2_memory_charge(sizeof(BlockHeader) + size);
+    return block + 1;
+}
+
+void *sysml2_parser_pool_realloc(void *ptr, size_t size) {
+    if (!ptr) return sysml2_parser_pool_alloc(size);
+
+    BlockHeader *block = (BlockHeader *)ptr - 1;
+    if (block->size_class == POOL_LARGE) {
+        if (size > SIZE_MAX - sizeof(BlockHeader)) out_of_memory();
+        size_t old_bytes = block->bytes;
+        BlockHeader *resized = realloc(block, sizeof(BlockHeader) + size);
+        if (!resized) out_of_memory();
+        resized->bytes = size;
+        if (size > old_bytes) {
+            sysml2_memory_charge(size - old_bytes);
+        } else {
+            sysml2_memory_release(old_bytes - size);
+        }
+        return resized + 1;
+    }
+
+    /* Doubling arrays grow into the slack of their class without copying */
+    size_t capacity = class_size(block->size_class);
+    if (size <= capacity) {
+        charge_up_to(block, size);
+        return ptr;
+    }
+
+    void *grown = sysml2_parser_pool_alloc(size);
+    memcpy(grown, ptr, block->bytes);
+    sysml2_parser_pool_free(ptr);
+    return grown;
+}
+
+void sysml2_parser_pool_free(void *ptr) {
+    if (!ptr) return;
+
+    BlockHeader *block = (BlockHeader *)ptr - 1;
+    size_t size_class = block->size_class;
+    if (size_class == POOL_LARGE || pool.exiting ||
+        pool.cached + class_size(size_class) > SYSML2_PARSER_POOL_MAX_CACHED) {
+        release_block(block);
+        return;
+    }
+
+    if (!pool.registered) register_thread();
+    FreeBlock *free_block = ptr;
+    free_block->next = pool.free[size_class];
+    pool.free[size_class] = free_block;
+    pool.cached += class_size(size_class);
+}
+
+void sysml2_parser_pool_trim(void) {
+    for (size_t i = 0; i < POOL_CLASSES; i++) {
+        FreeBlock *free_block = pool.free[i];
+        while (free_block) {
+            FreeBlock *next = free_block->next;
+            release_block((BlockHeader *)free_block - 1);
+            free_block = next;
+        }
+        pool.free[i] = NULL;
+    }
+    pool.cached = 0;
+}
+
+size_t sysml2_parser_pool_cached(void) {
+    return pool.cached;
+}
@@ -10,14 +10,32 @@
 #include "sysml2/ast_builder.h"
 #include "sysml2/json_writer.h"
 #include "sysml2/sysml_writer.h"
+#include "sysml2/binary_writer.h"
 #include "sysml2/validator.h"
 #include "sysml2/query.h"
+#include "sysml2/model_cache.h"
+#include "sysml2/intern.h"
+#include "sysml2/memory_budget.h"
 #include "sysml_parser.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Rough source bytes per unique interned string, used to pre-size interners */
+#define SOURCE_BYTES_PER_INTERNED_STRING 16
+
+/*
+ * What parses keep beyond the semantic model. With a model cache
+ * everything is kept, so its entries serve any later run.
+ */
+static SysmlCaptureOptions capture_for(const Sysml2CliOptions *options, bool cached) {
+    return options->trim_models && !cached ? SYSML_CAPTURE_NONE : SYSML_CAPTURE_ALL;
+}
 
 Sysml2PipelineContext *sysml2_pipeline_create(
     Sysml2Arena *arena,
@@ -30,10 +48,31 @@ Sysml2PipelineContext *sysml2_pipeline_create(
     ctx->arena = arena;
     ctx->intern = intern;
     ctx->options = options;
+    ctx->err_out = NULL;
+    ctx->on_parsed = NULL;
+    ctx->on_parsed_data = NULL;
+    ctx->reclaim_parsed = false;
+    ctx->files_parsed = 0;
+    ctx->bytes_parsed = 0;
+    ctx->stats = NULL;
+    ctx->trace = NULL;
+    ctx->library_models = NULL;
+    ctx->library_model_count = 0;
+    ctx->library_layer = NULL;
+
+    if (options->stats_format != SYSML2_STATS_NONE) {
+        ctx->stats = malloc(sizeof(Sysml2Stats));
+        if (!ctx->stats) {
+            free(ctx);
+            return NULL;
+        }
+        sysml2_stats_init(ctx->stats, arena);
+    }
 
     /* Initialize diagnostics */
     ctx->diag = malloc(sizeof(Sysml2DiagContext));
     if (!ctx->diag) {
+        free(ctx->stats);
         free(ctx);
         return NULL;
     }
@@ -45,12 +84,33 @@ Sysml2PipelineContext *sysml2_pipeline_create(
     ctx->resolver = sysml2_resolver_create(arena, intern);
     if (!ctx->resolver) {
         free(ctx->diag);
+        free(ctx->stats);
         free(ctx);
         return NULL;
     }
 
+    /* Like the cache, a trace that cannot be written is not worth failing the run */
+    if (options->trace_path) {
+        ctx->trace = sysml2_trace_open(options->trace_path);
+        if (!ctx->trace) {
+            fprintf(stderr, "warning: cannot write trace file '%s': %s, tracing disabled\n",
+                    options->trace_path, strerror(errno));
+        }
+    }
+
     ctx->resolver->verbose = options->verbose;
+    ctx->resolver->stats = ctx->stats;
+    ctx->resolver->trace = ctx->trace;
     ctx->resolver->disabled = options->no_resolve;
+    ctx->resolver->jobs = options->jobs;
+
+    /* Enable the persistent model cache before any library is parsed */
+    if (options->cache_dir &&
+        sysml2_resolver_set_cache_dir(ctx->resolver, options->cache_dir) != SYSML2_OK) {
+        fprintf(stderr, "warning: cannot use cache directory '%s', caching disabled\n",
+                options->cache_dir);
+    }
+    ctx->resolver->capture = capture_for(options, ctx->resolver->model_cache != NULL);
 
     /* Add library paths from environment and CLI */
     sysml2_resolver_add_paths_from_env(ctx->resolver);
@@ -60,25 +120,305 @@ Sysml2PipelineContext *sysml2_pipeline_create(
 
     /* Preload stdlib files if validation is enabled */
     if (!options->parse_only && !options->no_resolve && ctx->resolver->path_count > 0) {
-        sysml2_resolver_preload_libraries(ctx->resolver, ctx->diag);
+        sysml2_pipeline_load_libraries(ctx);
     }
 
     return ctx;
 }
 
+void sysml2_pipeline_load_libraries(Sysml2PipelineContext *ctx) {
+    if (!ctx || ctx->options->no_resolve) return;
+    if (ctx->options->lazy_libraries) {
+        sysml2_resolver_index_libraries(ctx->resolver, ctx->diag);
+    } else if (!ctx->resolver->preloaded) {
+        sysml2_resolver_preload_libraries(ctx->resolver, ctx->diag);
+
+        /* Nothing but libraries is cached before the inputs are read */
+        ctx->library_models = sysml2_resolver_get_all_models(ctx->resolver,
+                                                             &ctx->library_model_count);
+    }
+}
+
+const Sysml2SymbolLayer *sysml2_pipeline_library_layer(Sysml2PipelineContext *ctx) {
+    if (!ctx || !ctx->library_models) return NULL;
+    if (ctx->library_layer) return ctx->library_layer;
+
+    Sysml2SymbolLayer *layer = SYSML2_ARENA_NEW(ctx->arena, Sysml2SymbolLayer);
+    if (!layer || sysml2_validator_build_layer(layer, ctx->library_models,
+                                               ctx->library_model_count,
+                                               ctx->arena, ctx->intern) != SYSML2_OK) {
+        return NULL;
+    }
+    ctx->library_layer = layer;
+    return layer;
+}
+
 void sysml2_pipeline_destroy(Sysml2PipelineContext *ctx) {
     if (!ctx) return;
 
     if (ctx->resolver) {
         sysml2_resolver_destroy(ctx->resolver);
     }
+    free(ctx->library_models);
     /* Note: diag memory is managed by arena, just free the struct */
     if (ctx->diag) {
         free(ctx->diag);
     }
+    if (ctx->trace && sysml2_trace_close(ctx->trace) != SYSML2_OK) {
+        fprintf(stderr, "warning: failed to write trace file '%s'\n", ctx->options->trace_path);
+    }
+    free(ctx->stats);
     free(ctx);
 }
 
+/* Whether create() preloads libraries for these options */
+static bool wants_preload(const Sysml2CliOptions *options) {
+    return !options->parse_only && !options->no_resolve;
+}
+
+/* Compare directory options by the directory they name (NULL = unset) */
+static bool same_directory(const char *a, const char *b) {
+    if (!a || !b) return a == b;
+    char *real_a = sysml2_get_realpath(a);
+    char *real_b = sysml2_get_realpath(b);
+    bool same = strcmp(real_a ? real_a : a, real_b ? real_b : b) == 0;
+    free(real_a);
+    free(real_b);
+    return same;
+}
+
+/* Whether options name the library paths ctx's resolver was given */
+static bool same_library_paths(Sysml2PipelineContext *ctx, const Sysml2CliOptions *options) {
+    Sysml2ImportResolver *probe = sysml2_resolver_create(ctx->arena, ctx->intern);
+    if (!probe) return false;
+    sysml2_resolver_add_paths_from_env(probe);
+    for (size_t i = 0; i < options->library_path_count; i++) {
+        sysml2_resolver_add_path(probe, options->library_paths[i]);
+    }
+
+    const Sysml2ImportResolver *loaded = ctx->resolver;
+    bool same = probe->path_count == loaded->path_count;
+    for (size_t i = 0; same && i < probe->path_count; i++) {
+        same = strcmp(probe->library_paths[i], loaded->library_paths[i]) == 0;
+    }
+    sysml2_resolver_destroy(probe);
+    return same;
+}
+
+bool sysml2_pipeline_reuse(Sysml2PipelineContext *ctx, const Sysml2CliOptions *options) {
+    const Sysml2CliOptions *old = ctx->options;
+    if (wants_preload(options) != wants_preload(old) ||
+        options->no_resolve != old->no_resolve ||
+        options->lazy_libraries != old->lazy_libraries ||
+        options->clear_cache ||
+        !same_directory(options->cache_dir, old->cache_dir) ||
+        !same_library_paths(ctx, options)) {
+        return false;
+    }
+
+    /* Libraries loaded without trivia cannot be written back out */
+    SysmlCaptureOptions capture = capture_for(options, ctx->resolver->model_cache != NULL);
+    if (sysml2_capture_is_all(capture) && !sysml2_capture_is_all(ctx->resolver->capture)) {
+        return false;
+    }
+
+    Sysml2DiagContext *diag = malloc(sizeof(Sysml2DiagContext));
+    Sysml2Stats *stats = NULL;
+    if (options->stats_format != SYSML2_STATS_NONE) {
+        stats = malloc(sizeof(Sysml2Stats));
+        if (stats) sysml2_stats_init(stats, ctx->arena);
+    }
+    if (!diag || (options->stats_format != SYSML2_STATS_NONE && !stats)) {
+        free(diag);
+        free(stats);
+        return false;
+    }
+
+    /* Replay the preload's diagnostics as if reported under the new options */
+    sysml2_diag_context_init(diag, ctx->arena);
+    sysml2_diag_set_max_errors(diag, options->max_errors);
+    diag->treat_warnings_as_errors = options->treat_warnings_as_errors;
+    sysml2_diag_merge(diag, ctx->diag);
+    free(ctx->diag);
+    ctx->diag = diag;
+
+    /* The loading run's stats and trace belong to it */
+    free(ctx->stats);
+    ctx->stats = stats;
+    ctx->trace = NULL;
+    if (options->trace_path) {
+        ctx->trace = sysml2_trace_open(options->trace_path);
+        if (!ctx->trace) {
+            fprintf(stderr, "warning: cannot write trace file '%s': %s, tracing disabled\n",
+                    options->trace_path, strerror(errno));
+        }
+    }
+
+    ctx->options = options;
+    ctx->files_parsed = 0;
+    ctx->bytes_parsed = 0;
+
+    Sysml2ImportResolver *resolver = ctx->resolver;
+    resolver->verbose = options->verbose;
+    resolver->stats = ctx->stats;
+    resolver->trace = ctx->trace;
+    resolver->jobs = options->jobs;
+    resolver->capture = capture;
+    resolver->files_parsed = 0;
+    resolver->bytes_parsed = 0;
+    resolver->file_cache_hits = 0;
+    if (resolver->model_cache) {
+        resolver->model_cache->hits = 0;
+        resolver->model_cache->misses = 0;
+    }
+    return true;
+}
+
+/*
+ * Parse content into a model using the PackCC parser.
+ *
+ * Shared by the serial path and parser worker threads, so it only touches
+ * the given arena/intern and writes syntax errors to err_out (NULL = stderr).
+ * A model is returned whenever the parse completes, even with errors.
+ */
+static Sysml2Result parse_content(
+    Sysml2Arena *arena,
+    Sysml2Intern *intern,
+    SysmlCaptureOptions capture,
+    FILE *err_out,
+    const char *display_name,
+    const char *content,
+    size_t content_length,
+    SysmlSemanticModel **out_model,
+    int *out_error_count
+) {
+    FILE *err = err_out ? err_out : stderr;
+    *out_model = NULL;
+    *out_error_count = 0;
+
+    /* Reported by the caller, which may be merging worker output in order */
+    if (sysml2_memory_exceeded()) return SYSML2_ERROR_OUT_OF_MEMORY;
+
+    /* Everything the builder allocates is garbage if no model comes out */
+    Sysml2ArenaMark mark = sysml2_arena_mark(arena);
+
+    /* Create build context for AST building and semantic validation */
+    SysmlBuildContext *build_ctx = sysml2_build_context_create(arena, intern, display_name);
+    if (!build_ctx) {
+        fprintf(err, "error: failed to create build context\n");
+        return SYSML2_ERROR_OUT_OF_MEMORY;
+    }
+    build_ctx->capture = capture;
+
+    /* Parse input using packcc-generated parser */
+    SysmlParserContext pctx = {
+        .filename = display_name,
+        .input = content,
+        .input_len = content_length,
+        .input_pos = 0,
+        .error_count = 0,
+        /* Furthest failure tracking */
+        .furthest_pos = 0,
+        .failed_rule_count = 0,
+        .context_rule = NULL,
+        /* AST building context */
+        .build_ctx = build_ctx,
+        .err_out = err_out,
+    };
+
+    sysml2_context_t *parser = sysml2_create(&pctx);
+    if (!parser) {
+        fprintf(err, "error: failed to create parser\n");
+        return SYSML2_ERROR_OUT_OF_MEMORY;
+    }
+
+    void *result = NULL;
+    int parse_ok = sysml2_parse(parser, &result);
+    *out_error_count = pctx.error_count;
+
+    /* Finalize model */
+    Sysml2Result final_result = (parse_ok && pctx.error_count == 0) ? SYSML2_OK : SYSML2_ERROR_SYNTAX;
+    if (pctx.memory_stop || sysml2_memory_exceeded()) {
+        /* A cut-off input may still parse; its model is incomplete */
+        *out_error_count = 0;
+        final_result = SYSML2_ERROR_OUT_OF_MEMORY;
+    } else if (parse_ok) {
+        *out_model = sysml2_build_finalize(build_ctx);
+    }
+
+    sysml2_destroy(parser);
+    sysml2_parser_context_release(&pctx);
+
+    if (!*out_model && intern->arena == arena && sysml2_intern_rewind(intern, mark)) {
+        sysml2_arena_rewind(arena, mark);
+    }
+    return final_result;
+}
+
+/*
+ * Run the parser over content as a recognizer: with no build context
+ * every grammar action returns at once, so only syntax errors come out.
+ */
+static Sysml2Result check_content(
+    FILE *err_out,
+    const char *display_name,
+    const char *content,
+    size_t content_length,
+    int *out_error_count
+) {
+    FILE *err = err_out ? err_out : stderr;
+    *out_error_count = 0;
+
+    if (sysml2_memory_exceeded()) return SYSML2_ERROR_OUT_OF_MEMORY;
+
+    SysmlParserContext pctx = {
+        .filename = display_name,
+        .input = content,
+        .input_len = content_length,
+        .build_ctx = NULL,
+        .err_out = err_out,
+    };
+
+    sysml2_context_t *parser = sysml2_create(&pctx);
+    if (!parser) {
+        fprintf(err, "error: failed to create parser\n");
+        return SYSML2_ERROR_OUT_OF_MEMORY;
+    }
+
+    void *result = NULL;
+    int parse_ok = sysml2_parse(parser, &result);
+    *out_error_count = pctx.error_count;
+
+    sysml2_destroy(parser);
+    sysml2_parser_context_release(&pctx);
+    if (pctx.memory_stop || sysml2_memory_exceeded()) {
+        *out_error_count = 0;
+        return SYSML2_ERROR_OUT_OF_MEMORY;
+    }
+    return (parse_ok && pctx.error_count == 0) ? SYSML2_OK : SYSML2_ERROR_SYNTAX;
+}
+
+/* Attach an arena-owned source file (borrowing content) to a model */
+static void attach_source_file(
+    Sysml2PipelineContext *ctx,
+    SysmlSemanticModel *model,
+    const char *display_name,
+    const char *content,
+    size_t content_length
+) {
+    Sysml2SourceFile *sf = sysml2_arena_alloc(ctx->arena, sizeof(Sysml2SourceFile));
+    if (sf) {
+        *sf = (Sysml2SourceFile){
+            .path = sysml2_intern(ctx->intern, display_name),
+            .content = content,
+            .content_length = content_length,
+            .line_offsets = NULL,
+            .line_count = 0,
+        };
+        model->source_file = sf;
+    }
+}
+
 Sysml2Result sysml2_pipeline_process_input(
     Sysml2PipelineContext *ctx,
     const char *display_name,
@@ -133,211 +473,1352 @@ Sysml2Result sysml2_pipeline_process_input(
         free(line_offsets);
     }
 
-    /* Create build context for AST building and semantic validation */
-    SysmlBuildContext *build_ctx = sysml2_build_context_create(ctx->arena, ctx->intern, display_name);
-    if (!build_ctx) {
-        fprintf(stderr, "error: failed to create build context\n");
-        return SYSML2_ERROR_OUT_OF_MEMORY;
-    }
-
-    /* Parse input using packcc-generated parser */
-    SysmlParserContext pctx = {
-        .filename = display_name,
-        .input = content,
-        .input_len = content_length,
-        .input_pos = 0,
-        .error_count = 0,
-        .line = 1,
-        .col = 1,
-        /* Furthest failure tracking */
-        .furthest_pos = 0,
-        .furthest_line = 0,
-        .furthest_col = 0,
-        .failed_rule_count = 0,
-        .context_rule = NULL,
-        /* AST building context */
-        .build_ctx = build_ctx,
-    };
-
-    sysml2_context_t *parser = sysml2_create(&pctx);
-    if (!parser) {
-        fprintf(stderr, "error: failed to create parser\n");
-        return SYSML2_ERROR_OUT_OF_MEMORY;
+    int error_count = 0;
+    SysmlSemanticModel *model = NULL;
+    sysml2_trace_begin(ctx->trace, "parse", "parse", display_name);
+    Sysml2Result final_result = parse_content(
+        ctx->arena, ctx->intern, ctx->resolver->capture, ctx->err_out, display_name,
+        content, content_length, &model, &error_count);
+    sysml2_trace_end(ctx->trace);
+    if (final_result == SYSML2_ERROR_OUT_OF_MEMORY) {
+        sysml2_memory_report(ctx->diag, display_name);
     }
-
-    void *result = NULL;
-    int parse_ok = sysml2_parse(parser, &result);
+    ctx->files_parsed++;
+    ctx->bytes_parsed += content_length;
 
     /* Track errors in the diagnostic context */
-    if (pctx.error_count > 0) {
-        ctx->diag->error_count += pctx.error_count;
-        ctx->diag->parse_error_count += pctx.error_count;
+    if (error_count > 0) {
+        ctx->diag->error_count += error_count;
+        ctx->diag->parse_error_count += error_count;
     }
 
     /* Dump AST if requested - not yet implemented */
     if (ctx->options->dump_ast) {
-        if (parse_ok) {
+        if (model) {
             fprintf(stderr, "note: --dump-ast not yet implemented with new parser\n");
         }
     }
 
-    /* Finalize model */
-    Sysml2Result final_result = (parse_ok && pctx.error_count == 0) ? SYSML2_OK : SYSML2_ERROR_SYNTAX;
-
-    if (parse_ok) {
-        SysmlSemanticModel *model = sysml2_build_finalize(build_ctx);
-        if (model) {
-            /* Create arena-owned source file for diagnostic context.
-             * Store the content pointer directly (no arena copy).
-             * Caller manages content lifetime:
-             * - pipeline_process_file: transfers malloc'd buffer (doesn't free)
-             * - pipeline_process_stdin: copies to arena, replaces pointer, then frees
-             * - direct callers: content must outlive the model
-             * Line offsets are built lazily by ensure_source_loaded() in diagnostics. */
-            Sysml2SourceFile *sf = sysml2_arena_alloc(ctx->arena, sizeof(Sysml2SourceFile));
-            if (sf) {
-                *sf = (Sysml2SourceFile){
-                    .path = sysml2_intern(ctx->intern, display_name),
-                    .content = content,
-                    .content_length = content_length,
-                    .line_offsets = NULL,
-                    .line_count = 0,
-                };
-                model->source_file = sf;
-            }
-            /* If caller wants the model back, return it */
-            if (out_model) {
-                *out_model = model;
-            }
+    if (model) {
+        /* Create arena-owned source file for diagnostic context.
+         * Store the content pointer directly (no arena copy).
+         * Caller manages content lifetime:
+         * - pipeline_process_file: transfers its source buffer (doesn't release)
+         * - pipeline_process_stdin: likewise transfers its stdin buffer
+         * - direct callers: content must outlive the model
+         * Line offsets are built lazily by ensure_source_loaded() in diagnostics. */
+        attach_source_file(ctx, model, display_name, content, content_length);
+        /* If caller wants the model back, return it */
+        if (out_model) {
+            *out_model = model;
         }
     }
 
-    sysml2_destroy(parser);
-
     return final_result;
 }
 
-Sysml2Result sysml2_pipeline_process_file(
+/*
+ * Hand an input's content to its model, or release it
+ *
+ * process_input stores the content pointer in source_file (no copy), so
+ * the buffer is only released if no model's source file took it.
+ */
+static void settle_source(const SysmlSemanticModel *model, Sysml2SourceBuffer *source) {
+    if (model && model->source_file && model->source_file->content == source->data) {
+        memset(source, 0, sizeof(*source));
+    } else {
+        sysml2_source_release(source);
+    }
+}
+
+/* Map and parse one file, leaving its content in source for the caller */
+static Sysml2Result process_source_file(
     Sysml2PipelineContext *ctx,
     const char *path,
+    Sysml2SourceBuffer *source,
     SysmlSemanticModel **out_model
 ) {
-    /* Read file */
-    size_t content_length;
-    char *content = sysml2_read_file(path, &content_length);
-    if (!content) {
+    if (!sysml2_source_open(path, source)) {
         fprintf(stderr, "error: cannot read file '%s': %s\n", path, strerror(errno));
         return SYSML2_ERROR_FILE_READ;
     }
 
-    Sysml2Result result = sysml2_pipeline_process_input(ctx, path, content, content_length, out_model);
-
-    /* process_input stores the content pointer in source_file (no copy).
-     * Only free if source_file didn't take the pointer. */
-    bool content_owned = out_model && *out_model && (*out_model)->source_file &&
-                         (*out_model)->source_file->content == content;
-    if (!content_owned) {
-        free(content);
-    }
-
+    sysml2_stats_phase_start(ctx->stats, SYSML2_PHASE_PARSE);
+    Sysml2Result result = sysml2_pipeline_process_input(ctx, path, source->data, source->length, out_model);
+    sysml2_stats_phase_stop(ctx->stats, SYSML2_PHASE_PARSE);
     return result;
 }
 
-Sysml2Result sysml2_pipeline_process_stdin(
+Sysml2Result sysml2_pipeline_process_file(
     Sysml2PipelineContext *ctx,
+    const char *path,
     SysmlSemanticModel **out_model
 ) {
-    size_t content_length;
-    char *content = sysml2_read_stdin(&content_length);
-    if (!content) {
-        fprintf(stderr, "error: failed to read from stdin\n");
-        return SYSML2_ERROR_FILE_READ;
-    }
+    SysmlSemanticModel *model = NULL;
+    Sysml2SourceBuffer source = {0};
+    Sysml2Result result = process_source_file(ctx, path, &source, &model);
+    settle_source(model, &source);
+    if (out_model) *out_model = model;
+    return result;
+}
 
-    Sysml2Result result = sysml2_pipeline_process_input(ctx, "<stdin>", content, content_length, out_model);
+/* ========== Parallel Parsing ========== */
 
-    /* For stdin: copy content into arena since we can't re-read it later.
-     * process_input stored the content pointer; replace with arena copy
-     * before freeing the original buffer. */
-    if (out_model && *out_model && (*out_model)->source_file) {
-        Sysml2SourceFile *sf = (Sysml2SourceFile *)(*out_model)->source_file;
-        char *arena_content = sysml2_arena_alloc(ctx->arena, content_length + 1);
-        if (arena_content) {
-            memcpy(arena_content, content, content_length);
-            arena_content[content_length] = '\0';
-            sf->content = arena_content;
-        }
-    }
+/* One input file parsed by a worker thread */
+typedef struct {
+    const char *path;
+    Sysml2SourceBuffer source;   /* File content */
+    char *messages;              /* Buffered stderr output (malloc'd) */
+    size_t messages_length;
+    void *blob;                  /* Serialized model (malloc'd), NULL if none */
+    size_t blob_size;
+    int error_count;             /* Syntax errors reported */
+    Sysml2Result result;
+    bool cached;                 /* Loaded from the model cache, nothing to parse */
+    bool done;
+} ParseJob;
 
-    free(content);
-    return result;
-}
+/* Work queue shared by parser worker threads */
+typedef struct {
+    ParseJob *jobs;
+    size_t count;
+    size_t next;                 /* Next job to hand out */
+    bool cancelled;              /* Stop handing out jobs */
+    bool verbose;
+    bool syntax_only;            /* Only check syntax, build no models */
+    SysmlCaptureOptions capture; /* What models keep besides the semantics */
+    Sysml2Trace *trace;          /* Span output (NULL = off) */
+    pthread_mutex_t lock;
+    pthread_cond_t job_done;
+} ParseQueue;
 
-Sysml2Result sysml2_pipeline_resolve_all(Sysml2PipelineContext *ctx) {
-    if (!ctx || ctx->options->no_resolve) {
-        return SYSML2_OK;
+/*
+ * Parse one file into a worker-local arena and serialize the result,
+ * or with syntax_only just report its syntax errors
+ */
+static void run_parse_job(ParseJob *job, const ParseQueue *queue) {
+    FILE *msg = open_memstream(&job->messages, &job->messages_length);
+    if (!msg) {
+        job->result = SYSML2_ERROR_OUT_OF_MEMORY;
+        return;
     }
 
-    /* Get all cached models and resolve their imports */
-    size_t model_count;
-    SysmlSemanticModel **models = sysml2_resolver_get_all_models(ctx->resolver, &model_count);
-    if (!models || model_count == 0) {
-        return SYSML2_OK;
+    if (!sysml2_source_open(job->path, &job->source)) {
+        fprintf(msg, "error: cannot read file '%s': %s\n", job->path, strerror(errno));
+        fclose(msg);
+        job->result = SYSML2_ERROR_FILE_READ;
+        return;
+    }
+    if (queue->verbose) {
+        fprintf(msg, "Processing: %s\n", job->path);
     }
 
-    Sysml2Result overall_result = SYSML2_OK;
-    for (size_t i = 0; i < model_count; i++) {
-        if (models[i]) {
-            Sysml2Result result = sysml2_resolver_resolve_imports(ctx->resolver, models[i], ctx->diag);
-            if (result != SYSML2_OK && overall_result == SYSML2_OK) {
-                overall_result = result;
-            }
-        }
-        if (sysml2_diag_should_stop(ctx->diag)) {
-            break;
-        }
+    if (queue->syntax_only) {
+        sysml2_trace_begin(queue->trace, "parse", "parse", job->path);
+        job->result = check_content(msg, job->path, job->source.data, job->source.length,
+                                    &job->error_count);
+        sysml2_trace_end(queue->trace);
+        fclose(msg);
+        return;
     }
 
-    free(models);
-    return overall_result;
-}
+    Sysml2Arena arena;
+    sysml2_arena_init(&arena);
+    Sysml2Intern intern;
+    sysml2_intern_init(&intern, &arena);
+    sysml2_intern_reserve(&intern, job->source.length / SOURCE_BYTES_PER_INTERNED_STRING);
 
-Sysml2Result sysml2_pipeline_validate_all(Sysml2PipelineContext *ctx) {
-    if (!ctx || ctx->options->parse_only) {
-        return SYSML2_OK;
+    SysmlSemanticModel *model = NULL;
+    sysml2_trace_begin(queue->trace, "parse", "parse", job->path);
+    job->result = parse_content(&arena, &intern, queue->capture, msg, job->path,
+                                job->source.data, job->source.length,
+                                &model, &job->error_count);
+    sysml2_trace_end(queue->trace);
+    if (model && sysml2_model_serialize(model, &job->blob, &job->blob_size) != SYSML2_OK) {
+        fprintf(msg, "error: out of memory\n");
+        job->result = SYSML2_ERROR_OUT_OF_MEMORY;
     }
 
-    /* Get all cached models */
-    size_t model_count;
-    SysmlSemanticModel **models = sysml2_resolver_get_all_models(ctx->resolver, &model_count);
-    if (!models || model_count == 0) {
-        return SYSML2_OK;
-    }
+    sysml2_intern_destroy(&intern);
+    sysml2_arena_destroy(&arena);
+    fclose(msg);
+}
 
-    Sysml2ValidationOptions val_opts = SYSML_VALIDATION_OPTIONS_DEFAULT;
-    Sysml2Result result = sysml2_validate_multi(
-        models, model_count, ctx->diag, ctx->arena, ctx->intern, &val_opts
-    );
+static void *parse_worker(void *arg) {
+    ParseQueue *queue = arg;
 
-    free(models);
-    return result;
+    for (;;) {
+        pthread_mutex_lock(&queue->lock);
+        if (queue->cancelled || queue->next >= queue->count) {
+            pthread_mutex_unlock(&queue->lock);
+            break;
+        }
+        ParseJob *job = &queue->jobs[queue->next++];
+        pthread_mutex_unlock(&queue->lock);
+        if (job->cached) continue;
+
+        run_parse_job(job, queue);
+
+        pthread_mutex_lock(&queue->lock);
+        job->done = true;
+        pthread_cond_broadcast(&queue->job_done);
+        pthread_mutex_unlock(&queue->lock);
+    }
+    return NULL;
 }
 
-Sysml2Result sysml2_pipeline_write_json(
+/* Move a finished job into the pipeline: replay output, rebuild the model */
+static Sysml2Result merge_parse_job(
     Sysml2PipelineContext *ctx,
-    SysmlSemanticModel *model,
-    FILE *out
+    ParseJob *job,
+    SysmlSemanticModel **out_model
 ) {
-    if (!ctx || !model || !out) {
-        return SYSML2_ERROR_SEMANTIC;
+    if (job->messages_length > 0) {
+        fwrite(job->messages, 1, job->messages_length, stderr);
+    }
+    if (job->result == SYSML2_ERROR_OUT_OF_MEMORY) {
+        sysml2_memory_report(ctx->diag, job->path);
     }
 
-    Sysml2JsonOptions json_opts = SYSML_JSON_OPTIONS_DEFAULT;
-    sysml2_json_write(model, out, &json_opts);
-    return SYSML2_OK;
-}
+    if (job->error_count > 0) {
+        ctx->diag->error_count += job->error_count;
+        ctx->diag->parse_error_count += job->error_count;
+    }
+    if (job->source.data) {
+        ctx->files_parsed++;
+        ctx->bytes_parsed += job->source.length;
+    }
 
-Sysml2Result sysml2_pipeline_write_sysml(
+    Sysml2Result result = job->result;
+    SysmlSemanticModel *model = NULL;
+    if (job->blob) {
+        model = sysml2_model_deserialize(job->blob, job->blob_size, ctx->arena, ctx->intern);
+        if (model) {
+            model->source_name = sysml2_intern(ctx->intern, job->path);
+            attach_source_file(ctx, model, job->path, job->source.data, job->source.length);
+        } else {
+            fprintf(stderr, "error: out of memory\n");
+            result = SYSML2_ERROR_OUT_OF_MEMORY;
+        }
+    }
+
+    /* The content stays in the job until the caller settles it */
+    *out_model = model;
+    return result;
+}
+
+/*
+ * Load an unchanged input from the model cache instead of parsing it
+ *
+ * The content is still mapped into source for diagnostics and --fix
+ * comparisons; the caller settles it.
+ */
+static SysmlSemanticModel *load_cached_input(Sysml2PipelineContext *ctx, const char *path,
+                                             Sysml2SourceBuffer *source) {
+    Sysml2ModelCache *cache = ctx->resolver->model_cache;
+    if (!cache || ctx->options->dump_tokens || ctx->options->dump_ast) return NULL;
+
+    char *abs_path = sysml2_get_realpath(path);
+    if (!abs_path) return NULL;
+    SysmlSemanticModel *model = sysml2_model_cache_load(cache, abs_path);
+    sysml2_trace_instant(ctx->trace, "cache", model ? "model cache hit" : "model cache miss",
+                         abs_path);
+    free(abs_path);
+    if (!model) return NULL;
+
+    if (!sysml2_source_open(path, source)) return NULL;
+    if (ctx->options->verbose) {
+        fprintf(stderr, "Processing: %s\n", path);
+    }
+    model->source_name = sysml2_intern(ctx->intern, path);
+    attach_source_file(ctx, model, path, source->data, source->length);
+    return model;
+}
+
+/* Keep an input that parsed cleanly for the next run; failures only cost a reparse */
+static void store_cached_input(Sysml2PipelineContext *ctx, const char *path,
+                               const SysmlSemanticModel *model) {
+    Sysml2ModelCache *cache = ctx->resolver->model_cache;
+    const Sysml2SourceFile *sf = model->source_file;
+    if (!cache || !sf || !sf->content || !sysml2_capture_is_all(ctx->resolver->capture)) return;
+
+    char *abs_path = sysml2_get_realpath(path);
+    if (!abs_path) return;
+    sysml2_model_cache_store(cache, abs_path, sf->content, sf->content_length, model);
+    free(abs_path);
+}
+
+/*
+ * Drop a model on_parsed has seen, and everything allocated since mark
+ *
+ * Only inputs that parsed without a diagnostic go: a diagnostic points
+ * into its file's model and content until the end of the run.
+ */
+static bool reclaim_parsed_model(Sysml2PipelineContext *ctx, Sysml2ArenaMark mark,
+                                 const Sysml2Diagnostic *last, Sysml2Result result) {
+    if (result != SYSML2_OK || ctx->diag->last != last) return false;
+    if (!sysml2_intern_rewind(ctx->intern, mark)) return false;
+    sysml2_arena_rewind(ctx->arena, mark);
+    return true;
+}
+
+static void free_parse_job(ParseJob *job) {
+    sysml2_source_release(&job->source);
+    free(job->messages);
+    free(job->blob);
+}
+
+static Sysml2Result process_files(
+    Sysml2PipelineContext *ctx,
+    const char **paths,
+    size_t count,
+    size_t jobs,
+    bool stop_at_error_limit,
+    SysmlSemanticModel **out_models,
+    size_t *out_processed
+) {
+    Sysml2Result overall = SYSML2_OK;
+    size_t processed = 0;
+
+    for (size_t i = 0; i < count; i++) out_models[i] = NULL;
+
+    /* Models are dropped as on_parsed is done with them; the journal keeps
+     * each rewind down to the strings of the file just streamed */
+    bool reclaim = ctx->reclaim_parsed && ctx->on_parsed && ctx->intern->arena == ctx->arena;
+    if (reclaim) sysml2_intern_start_journal(ctx->intern);
+
+    /* Pre-size the interner for all inputs instead of rehashing as they
+     * load, or for the largest when only one is held at a time */
+    size_t total_bytes = 0;
+    for (size_t i = 0; i < count; i++) {
+        struct stat st;
+        if (stat(paths[i], &st) != 0) continue;
+        if (!reclaim) {
+            total_bytes += (size_t)st.st_size;
+        } else if ((size_t)st.st_size > total_bytes) {
+            total_bytes = (size_t)st.st_size;
+        }
+    }
+    sysml2_intern_reserve(ctx->intern, sysml2_intern_count(ctx->intern) +
+                          total_bytes / SOURCE_BYTES_PER_INTERNED_STRING);
+
+    /* Token/AST dumps print to stdout mid-parse; keep those serial */
+    bool parallel = jobs > 1 && count > 1 &&
+                    !ctx->options->dump_tokens && !ctx->options->dump_ast;
+
+    ParseQueue queue = {0};
+    pthread_t *threads = NULL;
+    size_t thread_count = 0;
+
+    if (parallel) {
+        queue.jobs = calloc(count, sizeof(ParseJob));
+        threads = malloc(SYSML2_MIN(jobs, count) * sizeof(pthread_t));
+        if (!queue.jobs || !threads) {
+            free(queue.jobs);
+            free(threads);
+            queue.jobs = NULL;
+            threads = NULL;
+            parallel = false;
+        }
+    }
+
+    if (parallel) {
+        queue.count = count;
+        queue.verbose = ctx->options->verbose;
+        queue.capture = ctx->resolver->capture;
+        queue.trace = ctx->trace;
+        /* Cached inputs load ahead of every mark, so they are kept */
+        for (size_t i = 0; i < count; i++) {
+            queue.jobs[i].path = paths[i];
+            out_models[i] = load_cached_input(ctx, paths[i], &queue.jobs[i].source);
+            settle_source(out_models[i], &queue.jobs[i].source);
+            queue.jobs[i].cached = queue.jobs[i].done = out_models[i] != NULL;
+        }
+        pthread_mutex_init(&queue.lock, NULL);
+        pthread_cond_init(&queue.job_done, NULL);
+
+        for (size_t t = 0; t < SYSML2_MIN(jobs, count); t++) {
+            if (pthread_create(&threads[thread_count], NULL, parse_worker, &queue) != 0) break;
+            thread_count++;
+        }
+        if (thread_count == 0) {
+            pthread_cond_destroy(&queue.job_done);
+            pthread_mutex_destroy(&queue.lock);
+            free(queue.jobs);
+            free(threads);
+            parallel = false;
+        }
+    }
+
+    if (!parallel) {
+        for (size_t i = 0; i < count; i++) {
+            Sysml2ArenaMark mark = sysml2_arena_mark(ctx->arena);
+            const Sysml2Diagnostic *last = ctx->diag->last;
+            Sysml2SourceBuffer source = {0};
+            Sysml2Result result = SYSML2_OK;
+            out_models[i] = load_cached_input(ctx, paths[i], &source);
+            if (!out_models[i]) {
+                settle_source(NULL, &source);
+                result = process_source_file(ctx, paths[i], &source, &out_models[i]);
+                if (result != SYSML2_OK && overall == SYSML2_OK) overall = result;
+                if (result == SYSML2_OK && out_models[i]) store_cached_input(ctx, paths[i], out_models[i]);
+            }
+            if (out_models[i]) {
+                if (!reclaim) sysml2_resolver_cache_model(ctx->resolver, paths[i], out_models[i]);
+                if (ctx->on_parsed) ctx->on_parsed(ctx, out_models[i], ctx->on_parsed_data);
+                if (reclaim && reclaim_parsed_model(ctx, mark, last, result)) out_models[i] = NULL;
+            }
+            settle_source(out_models[i], &source);
+            processed++;
+            if (stop_at_error_limit && sysml2_diag_should_stop(ctx->diag)) break;
+        }
+        if (out_processed) *out_processed = processed;
+        return overall;
+    }
+
+    /* Merge in input order as jobs complete */
+    for (size_t i = 0; i < count; i++) {
+        pthread_mutex_lock(&queue.lock);
+        while (!queue.jobs[i].done) {
+            pthread_cond_wait(&queue.job_done, &queue.lock);
+        }
+        pthread_mutex_unlock(&queue.lock);
+
+        Sysml2ArenaMark mark = sysml2_arena_mark(ctx->arena);
+        const Sysml2Diagnostic *last = ctx->diag->last;
+        Sysml2Result result = SYSML2_OK;
+        if (!queue.jobs[i].cached) {
+            result = merge_parse_job(ctx, &queue.jobs[i], &out_models[i]);
+            if (result != SYSML2_OK && overall == SYSML2_OK) overall = result;
+            if (result == SYSML2_OK && out_models[i]) store_cached_input(ctx, paths[i], out_models[i]);
+        }
+        if (out_models[i]) {
+            if (!reclaim) sysml2_resolver_cache_model(ctx->resolver, paths[i], out_models[i]);
+            if (ctx->on_parsed) ctx->on_parsed(ctx, out_models[i], ctx->on_parsed_data);
+            if (reclaim && !queue.jobs[i].cached &&
+                reclaim_parsed_model(ctx, mark, last, result)) {
+                out_models[i] = NULL;
+            }
+        }
+        if (!queue.jobs[i].cached) settle_source(out_models[i], &queue.jobs[i].source);
+        processed++;
+
+        if (stop_at_error_limit && sysml2_diag_should_stop(ctx->diag)) {
+            pthread_mutex_lock(&queue.lock);
+            queue.cancelled = true;
+            pthread_mutex_unlock(&queue.lock);
+            break;
+        }
+    }
+
+    for (size_t t = 0; t < thread_count; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    for (size_t i = 0; i < count; i++) {
+        free_parse_job(&queue.jobs[i]);
+    }
+    pthread_cond_destroy(&queue.job_done);
+    pthread_mutex_destroy(&queue.lock);
+    free(queue.jobs);
+    free(threads);
+
+    if (out_processed) *out_processed = processed;
+    return overall;
+}
+
+Sysml2Result sysml2_pipeline_process_files(
+    Sysml2PipelineContext *ctx,
+    const char **paths,
+    size_t count,
+    size_t jobs,
+    bool stop_at_error_limit,
+    SysmlSemanticModel **out_models,
+    size_t *out_processed
+) {
+    sysml2_stats_phase_start(ctx->stats, SYSML2_PHASE_PARSE);
+    Sysml2Result result = process_files(ctx, paths, count, jobs, stop_at_error_limit,
+                                        out_models, out_processed);
+    /* Files after a breach fail at once; a breach between files has no file */
+    if (sysml2_memory_report(ctx->diag, NULL)) result = SYSML2_ERROR_OUT_OF_MEMORY;
+    sysml2_stats_phase_stop(ctx->stats, SYSML2_PHASE_PARSE);
+    return result;
+}
+
+Sysml2Result sysml2_pipeline_process_stdin(
+    Sysml2PipelineContext *ctx,
+    SysmlSemanticModel **out_model
+) {
+    /* Read straight into the buffer the model keeps: stdin cannot be re-read */
+    Sysml2SourceBuffer source;
+    if (!sysml2_source_read_fd(STDIN_FILENO, SYSML2_STDIN_SPOOL_THRESHOLD, &source)) {
+        fprintf(stderr, "error: failed to read from stdin\n");
+        return SYSML2_ERROR_FILE_READ;
+    }
+
+    sysml2_stats_phase_start(ctx->stats, SYSML2_PHASE_PARSE);
+    Sysml2Result result = sysml2_pipeline_process_input(ctx, "<stdin>", source.data, source.length, out_model);
+    sysml2_stats_phase_stop(ctx->stats, SYSML2_PHASE_PARSE);
+
+    /* As for files, the model's source_file owns the buffer if it took it */
+    bool content_owned = out_model && *out_model && (*out_model)->source_file &&
+                         (*out_model)->source_file->content == source.data;
+    if (!content_owned) {
+        sysml2_source_release(&source);
+    }
+    return result;
+}
+
+/* Check stdin as a recognizer */
+static Sysml2Result check_stdin_syntax(Sysml2PipelineContext *ctx) {
+    Sysml2SourceBuffer source;
+    if (!sysml2_source_read_fd(STDIN_FILENO, SYSML2_STDIN_SPOOL_THRESHOLD, &source)) {
+        fprintf(stderr, "error: failed to read from stdin\n");
+        return SYSML2_ERROR_FILE_READ;
+    }
+    if (ctx->options->verbose) {
+        fprintf(stderr, "Processing: <stdin>\n");
+    }
+
+    int error_count = 0;
+    sysml2_trace_begin(ctx->trace, "parse", "parse", "<stdin>");
+    Sysml2Result result = check_content(ctx->err_out, "<stdin>", source.data, source.length,
+                                        &error_count);
+    sysml2_trace_end(ctx->trace);
+    if (result == SYSML2_ERROR_OUT_OF_MEMORY) {
+        sysml2_memory_report(ctx->diag, "<stdin>");
+    }
+    ctx->files_parsed++;
+    ctx->bytes_parsed += source.length;
+    ctx->diag->error_count += error_count;
+    ctx->diag->parse_error_count += error_count;
+    sysml2_source_release(&source);
+    return result;
+}
+
+/* Check files on worker threads (or this one), reporting in input order */
+static Sysml2Result check_files_syntax(Sysml2PipelineContext *ctx, const char **paths, size_t count) {
+    ParseQueue queue = {
+        .count = count,
+        .verbose = ctx->options->verbose,
+        .syntax_only = true,
+        .trace = ctx->trace,
+    };
+    queue.jobs = calloc(count, sizeof(ParseJob));
+    if (!queue.jobs) {
+        fprintf(stderr, "error: out of memory\n");
+        return SYSML2_ERROR_OUT_OF_MEMORY;
+    }
+    for (size_t i = 0; i < count; i++) queue.jobs[i].path = paths[i];
+
+    size_t jobs = ctx->options->jobs;
+    pthread_t *threads = jobs > 1 && count > 1 ? malloc(SYSML2_MIN(jobs, count) * sizeof(pthread_t)) : NULL;
+    size_t thread_count = 0;
+    pthread_mutex_init(&queue.lock, NULL);
+    pthread_cond_init(&queue.job_done, NULL);
+    if (threads) {
+        for (size_t t = 0; t < SYSML2_MIN(jobs, count); t++) {
+            if (pthread_create(&threads[thread_count], NULL, parse_worker, &queue) != 0) break;
+            thread_count++;
+        }
+    }
+
+    Sysml2Result overall = SYSML2_OK;
+    for (size_t i = 0; i < count; i++) {
+        ParseJob *job = &queue.jobs[i];
+        if (thread_count == 0) {
+            run_parse_job(job, &queue);
+        } else {
+            pthread_mutex_lock(&queue.lock);
+            while (!job->done) pthread_cond_wait(&queue.job_done, &queue.lock);
+            pthread_mutex_unlock(&queue.lock);
+        }
+
+        SysmlSemanticModel *unused = NULL;
+        Sysml2Result result = merge_parse_job(ctx, job, &unused);
+        if (result != SYSML2_OK && overall == SYSML2_OK) overall = result;
+
+        if (sysml2_diag_should_stop(ctx->diag)) {
+            pthread_mutex_lock(&queue.lock);
+            queue.cancelled = true;
+            pthread_mutex_unlock(&queue.lock);
+            break;
+        }
+    }
+
+    for (size_t t = 0; t < thread_count; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    for (size_t i = 0; i < count; i++) {
+        free_parse_job(&queue.jobs[i]);
+    }
+    pthread_cond_destroy(&queue.job_done);
+    pthread_mutex_destroy(&queue.lock);
+    free(queue.jobs);
+    free(threads);
+    return overall;
+}
+
+Sysml2Result sysml2_pipeline_check_syntax(
+    Sysml2PipelineContext *ctx,
+    const char **paths,
+    size_t count
+) {
+    sysml2_stats_phase_start(ctx->stats, SYSML2_PHASE_PARSE);
+    Sysml2Result result = count == 0 ? check_stdin_syntax(ctx)
+                                     : check_files_syntax(ctx, paths, count);
+    sysml2_stats_phase_stop(ctx->stats, SYSML2_PHASE_PARSE);
+    return result;
+}
+
+Sysml2Result sysml2_pipeline_resolve_all(Sysml2PipelineContext *ctx) {
+    if (!ctx || ctx->options->no_resolve) {
+        return SYSML2_OK;
+    }
+
+    /* Get all cached models and resolve their imports */
+    size_t model_count;
+    SysmlSemanticModel **models = sysml2_resolver_get_all_models(ctx->resolver, &model_count);
+    if (!models || model_count == 0) {
+        return SYSML2_OK;
+    }
+
+    Sysml2Result overall_result = SYSML2_OK;
+    for (size_t i = 0; i < model_count; i++) {
+        if (models[i]) {
+            Sysml2Result result = sysml2_resolver_resolve_imports(ctx->resolver, models[i], ctx->diag);
+            if (result != SYSML2_OK && overall_result == SYSML2_OK) {
+                overall_result = result;
+            }
+        }
+        if (sysml2_diag_should_stop(ctx->diag)) {
+            break;
+        }
+    }
+
+    free(models);
+    return overall_result;
+}
+
+/* ========== Validation Result Cache ========== */
+
+/*
+ * With --cache-dir, each model's validation diagnostics are stored keyed
+ * by a hash of the configuration and the content of every file the
+ * results depend on: the model itself plus, transitively, every model
+ * defining a root name it mentions (in an import, a type reference or a
+ * root name of its own) and every model with a library package root,
+ * whose names are visible everywhere. A later run that finds the same
+ * files replays the diagnostics and validates only the rest.
+ */
+
+/* What a model's results were computed from */
+typedef struct {
+    char *abs_path;              /* NULL: results cannot be cached */
+    uint64_t size;
+    uint64_t content_hash;
+    size_t *uses;                /* Models it depends on directly */
+    size_t use_count;
+    size_t use_capacity;
+} ResultSource;
+
+/* Root name -> defining models, keyed by interned pointer */
+typedef struct {
+    const char *name;
+    size_t first;                /* Index into RootNames.links */
+} RootSlot;
+
+typedef struct {
+    size_t model;
+    size_t next;                 /* SIZE_MAX ends the chain */
+} RootLink;
+
+typedef struct {
+    RootSlot *slots;
+    size_t capacity;             /* Power of two */
+    RootLink *links;
+    size_t link_count;
+    size_t link_capacity;
+} RootNames;
+
+/* One diagnostic of this validation, placed in run order */
+typedef struct {
+    Sysml2Diagnostic *diag;
+    Sysml2ValidatorPass pass;
+    size_t model;
+    size_t seq;
+} PlacedDiag;
+
+static size_t hash_name(const char *name) {
+    uintptr_t v = (uintptr_t)name;
+    v ^= v >> 33;
+    v *= 0xff51afd7ed558ccdULL;
+    v ^= v >> 33;
+    return (size_t)v;
+}
+
+static RootSlot *root_slot(const RootNames *roots, const char *name) {
+    size_t mask = roots->capacity - 1;
+    for (size_t i = hash_name(name) & mask;; i = (i + 1) & mask) {
+        if (!roots->slots[i].name || roots->slots[i].name == name) return &roots->slots[i];
+    }
+}
+
+static bool root_names_add(RootNames *roots, const char *name, size_t model) {
+    if (!name) return true;
+    if (roots->link_count >= roots->link_capacity) {
+        size_t new_capacity = roots->link_capacity ? roots->link_capacity * 2 : 64;
+        RootLink *links = realloc(roots->links, new_capacity * sizeof(RootLink));
+        if (!links) return false;
+        roots->links = links;
+        roots->link_capacity = new_capacity;
+    }
+    RootSlot *slot = root_slot(roots, name);
+    if (!slot->name) {
+        slot->name = name;
+        slot->first = SIZE_MAX;
+    }
+    roots->links[roots->link_count] = (RootLink){ model, slot->first };
+    slot->first = roots->link_count++;
+    return true;
+}
+
+static void result_source_use(ResultSource *src, size_t model, unsigned *stamps, unsigned stamp) {
+    if (stamps[model] == stamp) return;
+    if (src->use_count >= src->use_capacity) {
+        size_t new_capacity = src->use_capacity ? src->use_capacity * 2 : 8;
+        size_t *uses = realloc(src->uses, new_capacity * sizeof(size_t));
+        if (!uses) {
+            /* A missing edge would let stale results through */
+            free(src->abs_path);
+            src->abs_path = NULL;
+            return;
+        }
+        src->uses = uses;
+        src->use_capacity = new_capacity;
+    }
+    stamps[model] = stamp;
+    src->uses[src->use_count++] = model;
+}
+
+/* Add the models defining the first segment of a reference */
+static void result_source_mention(
+    ResultSource *src,
+    const RootNames *roots,
+    const Sysml2Intern *intern,
+    const char *ref,
+    unsigned *stamps,
+    unsigned stamp
+) {
+    if (!ref) return;
+    if (*ref == '~') ref++;
+
+    size_t length = 0;
+    while (ref[length] && ref[length] != '.' &&
+           !(ref[length] == ':' && ref[length + 1] == ':')) {
+        length++;
+    }
+    const char *segment = sysml2_intern_lookup_sv(intern, sysml2_sv_from_parts(ref, length));
+    if (!segment) return;
+
+    const RootSlot *slot = root_slot(roots, segment);
+    if (!slot->name) return;
+    for (size_t l = slot->first; l != SIZE_MAX; l = roots->links[l].next) {
+        result_source_use(src, roots->links[l].model, stamps, stamp);
+    }
+}
+
+static void result_source_mention_all(
+    ResultSource *src,
+    const RootNames *roots,
+    const Sysml2Intern *intern,
+    const char **refs,
+    size_t count,
+    unsigned *stamps,
+    unsigned stamp
+) {
+    for (size_t i = 0; i < count; i++) {
+        result_source_mention(src, roots, intern, refs[i], stamps, stamp);
+    }
+}
+
+/* Read the file a model came from to fingerprint it */
+static void result_source_fingerprint(ResultSource *src, const SysmlSemanticModel *model) {
+    const char *path = model->source_file ? model->source_file->path : model->source_name;
+    if (!path) return;
+    src->abs_path = sysml2_get_realpath(path);
+    if (!src->abs_path) return;
+
+    const Sysml2SourceFile *sf = model->source_file;
+    if (sf && sf->content) {
+        src->size = sf->content_length;
+        src->content_hash = sysml2_model_cache_hash(sf->content, sf->content_length);
+        return;
+    }
+    Sysml2SourceBuffer source;
+    if (!sysml2_source_open(src->abs_path, &source)) {
+        free(src->abs_path);
+        src->abs_path = NULL;
+        return;
+    }
+    src->size = source.length;
+    src->content_hash = sysml2_model_cache_hash(source.data, source.length);
+    sysml2_source_release(&source);
+}
+
+/* Everything besides file content that results depend on */
+static uint64_t result_config_hash(
+    const Sysml2PipelineContext *ctx,
+    const Sysml2ValidationOptions *val_opts
+) {
+    char *text = NULL;
+    size_t length = 0;
+    FILE *out = open_memstream(&text, &length);
+    if (!out) return 0;
+
+    /* The program version and result revision cover changes to what the
+     * validator reports */
+    fprintf(out, "%s %u %u\n", SYSML2_VERSION_STRING, (unsigned)SYSML2_MODEL_CACHE_VERSION,
+            (unsigned)SYSML2_RESULT_CACHE_REVISION);
+    fprintf(out, "%d%d%d%d%d%d%d%d%d%d %zu %d %d\n",
+            val_opts->check_undefined_types, val_opts->check_undefined_features,
+            val_opts->check_undefined_namespaces, val_opts->check_duplicate_names,
+            val_opts->check_circular_specs, val_opts->check_type_compatibility,
+            val_opts->check_multiplicity, val_opts->check_redefinition_compat,
+            val_opts->warn_abstract_instantiation, val_opts->suggest_corrections,
+            val_opts->max_suggestions, ctx->options->treat_warnings_as_errors,
+            ctx->options->no_resolve);
+    for (size_t i = 0; i < ctx->resolver->path_count; i++) {
+        fprintf(out, "%s\n", ctx->resolver->library_paths[i]);
+    }
+    /* Without every library file loaded, an undefined name may be defined
+     * in one that is not, so lazy results are kept apart */
+    if (ctx->options->lazy_libraries && !ctx->resolver->preloaded) {
+        fprintf(out, "lazy\n");
+    }
+    fclose(out);
+
+    uint64_t hash = text ? sysml2_model_cache_hash(text, length) : 0;
+    free(text);
+    return hash;
+}
+
+static int compare_placed(const void *a, const void *b) {
+    const PlacedDiag *x = a;
+    const PlacedDiag *y = b;
+    if (x->pass != y->pass) return x->pass < y->pass ? -1 : 1;
+    if (x->model != y->model) return x->model < y->model ? -1 : 1;
+    return x->seq < y->seq ? -1 : (x->seq > y->seq);
+}
+
+static int compare_dependency(const void *a, const void *b) {
+    return strcmp(((const Sysml2ResultDependency *)a)->path,
+                  ((const Sysml2ResultDependency *)b)->path);
+}
+
+/* Stored notes may point at other files of the run */
+typedef struct {
+    SysmlSemanticModel **models;
+    size_t count;
+} ResultLookup;
+
+static const Sysml2SourceFile *lookup_result_file(void *data, const char *path) {
+    const ResultLookup *lookup = data;
+    for (size_t i = 0; i < lookup->count; i++) {
+        const Sysml2SourceFile *sf = lookup->models[i]->source_file;
+        if (sf && sf->path && strcmp(sf->path, path) == 0) return sf;
+    }
+    return NULL;
+}
+
+/* Build the direct dependencies of every model */
+static bool collect_result_uses(
+    const Sysml2PipelineContext *ctx,
+    SysmlSemanticModel **models,
+    size_t count,
+    ResultSource *sources
+) {
+    RootNames roots = {0};
+    roots.capacity = 64;
+    size_t names = 0;
+    for (size_t m = 0; m < count; m++) {
+        for (size_t i = 0; i < models[m]->element_count; i++) {
+            if (models[m]->elements[i] && !models[m]->elements[i]->parent_id) names++;
+        }
+        names += models[m]->alias_count;
+    }
+    while (roots.capacity < names * 2) roots.capacity *= 2;
+    roots.slots = calloc(roots.capacity, sizeof(RootSlot));
+    unsigned *stamps = calloc(count, sizeof(unsigned));
+    bool *library = calloc(count, sizeof(bool));
+    bool ok = roots.slots && stamps && library;
+
+    for (size_t m = 0; ok && m < count; m++) {
+        const SysmlSemanticModel *model = models[m];
+        for (size_t i = 0; ok && i < model->element_count; i++) {
+            const SysmlNode *node = model->elements[i];
+            if (!node || node->parent_id) continue;
+            ok = root_names_add(&roots, node->name, m);
+            if (node->kind == SYSML_KIND_LIBRARY_PACKAGE) library[m] = true;
+        }
+        for (size_t i = 0; ok && i < model->alias_count; i++) {
+            const SysmlAlias *alias = model->aliases[i];
+            if (alias && !alias->owner_scope) ok = root_names_add(&roots, alias->name, m);
+        }
+    }
+
+    const Sysml2Intern *intern = ctx->intern;
+    for (size_t m = 0; ok && m < count; m++) {
+        const SysmlSemanticModel *model = models[m];
+        ResultSource *src = &sources[m];
+        unsigned stamp = (unsigned)m + 1;
+        stamps[m] = stamp;
+
+        for (size_t d = 0; d < count; d++) {
+            if (library[d]) result_source_use(src, d, stamps, stamp);
+        }
+        for (size_t i = 0; i < model->element_count; i++) {
+            const SysmlNode *node = model->elements[i];
+            if (!node) continue;
+            if (!node->parent_id) result_source_mention(src, &roots, intern, node->name, stamps, stamp);
+            result_source_mention_all(src, &roots, intern, node->typed_by, node->typed_by_count,
+                                      stamps, stamp);
+            result_source_mention_all(src, &roots, intern, node->specializes,
+                                      node->specializes_count, stamps, stamp);
+            result_source_mention_all(src, &roots, intern, node->redefines, node->redefines_count,
+                                      stamps, stamp);
+            result_source_mention_all(src, &roots, intern, node->references,
+                                      node->references_count, stamps, stamp);
+        }
+        for (size_t i = 0; i < model->import_count; i++) {
+            result_source_mention(src, &roots, intern, model->imports[i]->target, stamps, stamp);
+        }
+        for (size_t i = 0; i < model->alias_count; i++) {
+            result_source_mention(src, &roots, intern, model->aliases[i]->target, stamps, stamp);
+        }
+        for (size_t i = 0; i < model->relationship_count; i++) {
+            result_source_mention(src, &roots, intern, model->relationships[i]->target,
+                                  stamps, stamp);
+        }
+    }
+
+    free(roots.slots);
+    free(roots.links);
+    free(stamps);
+    free(library);
+    return ok;
+}
+
+/*
+ * List everything model m's results depend on: itself first, then its
+ * transitive dependencies by path. Fails if any cannot be fingerprinted.
+ */
+static Sysml2ResultDependency *collect_result_dependencies(
+    const ResultSource *sources,
+    size_t m,
+    size_t *queue,
+    unsigned *seen,
+    size_t *out_count
+) {
+    unsigned stamp = (unsigned)m + 1;
+    size_t head = 0, tail = 0;
+    queue[tail++] = m;
+    seen[m] = stamp;
+    while (head < tail) {
+        const ResultSource *src = &sources[queue[head++]];
+        if (!src->abs_path) return NULL;
+        for (size_t i = 0; i < src->use_count; i++) {
+            size_t d = src->uses[i];
+            if (seen[d] == stamp) continue;
+            seen[d] = stamp;
+            queue[tail++] = d;
+        }
+    }
+
+    Sysml2ResultDependency *deps = malloc(tail * sizeof(Sysml2ResultDependency));
+    if (!deps) return NULL;
+    for (size_t i = 0; i < tail; i++) {
+        const ResultSource *src = &sources[queue[i]];
+        deps[i] = (Sysml2ResultDependency){ src->abs_path, src->size, src->content_hash };
+    }
+    qsort(deps + 1, tail - 1, sizeof(Sysml2ResultDependency), compare_dependency);
+    *out_count = tail;
+    return deps;
+}
+
+/*
+ * List every model of the run as a dependency of model m, itself first
+ *
+ * A name that did not resolve depends on no file in particular: defining
+ * it anywhere, or a name close enough to change the suggestion, alters
+ * the result. Such results are stored against the whole run instead.
+ */
+static Sysml2ResultDependency *collect_all_dependencies(
+    const ResultSource *sources,
+    size_t count,
+    size_t m,
+    size_t *out_count
+) {
+    Sysml2ResultDependency *deps = malloc(count * sizeof(Sysml2ResultDependency));
+    if (!deps) return NULL;
+    size_t n = 0;
+    deps[n++] = (Sysml2ResultDependency){ sources[m].abs_path, sources[m].size,
+                                          sources[m].content_hash };
+    for (size_t d = 0; d < count; d++) {
+        if (d == m) continue;
+        deps[n++] = (Sysml2ResultDependency){ sources[d].abs_path, sources[d].size,
+                                              sources[d].content_hash };
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (!deps[i].path) {
+            free(deps);
+            return NULL;
+        }
+    }
+    qsort(deps + 1, n - 1, sizeof(Sysml2ResultDependency), compare_dependency);
+    *out_count = n;
+    return deps;
+}
+
+static bool is_unresolved_name(Sysml2DiagCode code) {
+    return code == SYSML2_DIAG_E3001_UNDEFINED_TYPE ||
+           code == SYSML2_DIAG_E3002_UNDEFINED_FEATURE ||
+           code == SYSML2_DIAG_E3003_UNDEFINED_NAMESPACE;
+}
+
+/* Validate with cached results: replay the unchanged, check the rest */
+static Sysml2Result validate_cached(
+    Sysml2PipelineContext *ctx,
+    SysmlSemanticModel **models,
+    size_t count,
+    const Sysml2ValidationOptions *val_opts
+) {
+    Sysml2ModelCache *cache = ctx->resolver->model_cache;
+    Sysml2DiagContext *diag = ctx->diag;
+
+    ResultSource *sources = calloc(count, sizeof(ResultSource));
+    Sysml2ResultDependency **deps = calloc(count, sizeof(Sysml2ResultDependency *));
+    size_t *dep_counts = calloc(count, sizeof(size_t));
+    size_t *queue = malloc(count * sizeof(size_t));
+    unsigned *seen = calloc(count, sizeof(unsigned));
+    bool *check = malloc(count * sizeof(bool));
+    if (!sources || !deps || !dep_counts || !queue || !seen || !check) {
+        free(sources);
+        free(deps);
+        free(dep_counts);
+        free(queue);
+        free(seen);
+        free(check);
+        return sysml2_validate_multi(models, count, diag, ctx->arena, ctx->intern, val_opts);
+    }
+
+    /* Results are attributed to models by source file */
+    for (size_t m = 0; m < count; m++) {
+        if (!models[m]->source_file) {
+            Sysml2SourceFile *sf = SYSML2_ARENA_NEW(ctx->arena, Sysml2SourceFile);
+            if (sf) {
+                sf->path = models[m]->source_name;
+                models[m]->source_file = sf;
+            }
+        }
+        result_source_fingerprint(&sources[m], models[m]);
+    }
+    bool cacheable = collect_result_uses(ctx, models, count, sources);
+    uint64_t config_hash = result_config_hash(ctx, val_opts);
+
+    Sysml2Diagnostic *mark = diag->last;
+    ResultLookup lookup = { models, count };
+    bool any_check = false;
+    bool replayed_errors = false;
+    for (size_t m = 0; m < count; m++) {
+        check[m] = true;
+        if (cacheable) {
+            deps[m] = collect_result_dependencies(sources, m, queue, seen, &dep_counts[m]);
+        }
+        if (!deps[m]) {
+            any_check = true;
+            continue;
+        }
+
+        size_t errors_before = diag->semantic_error_count;
+        bool hit = sysml2_model_cache_load_results(cache, sources[m].abs_path, config_hash,
+                                                   deps[m], dep_counts[m], diag,
+                                                   models[m]->source_file, lookup_result_file,
+                                                   &lookup);
+        if (!hit) {
+            /* Results with an unresolved name are stored against every file */
+            size_t all_count = 0;
+            Sysml2ResultDependency *all = collect_all_dependencies(sources, count, m, &all_count);
+            hit = all && all_count != dep_counts[m] &&
+                  sysml2_model_cache_load_results(cache, sources[m].abs_path, config_hash,
+                                                  all, all_count, diag, models[m]->source_file,
+                                                  lookup_result_file, &lookup);
+            free(all);
+        }
+        if (hit) {
+            check[m] = false;
+            if (diag->semantic_error_count > errors_before) replayed_errors = true;
+            sysml2_trace_instant(ctx->trace, "cache", "result cache hit", sources[m].abs_path);
+            if (ctx->options->verbose) {
+                fprintf(stderr, "note: reused validation results for %s\n", sources[m].abs_path);
+            }
+        } else {
+            any_check = true;
+            sysml2_trace_instant(ctx->trace, "cache", "result cache miss", sources[m].abs_path);
+        }
+    }
+
+    Sysml2Result result = SYSML2_OK;
+    if (any_check) {
+        result = sysml2_validate_subset(models, count, check, diag, ctx->arena, ctx->intern,
+                                        val_opts);
+    }
+    if (replayed_errors) result = SYSML2_ERROR_SEMANTIC;
+
+    /* Place every diagnostic of this validation by pass, then model */
+    size_t placed_count = 0;
+    for (Sysml2Diagnostic *d = mark ? mark->next : diag->first; d; d = d->next) placed_count++;
+    PlacedDiag *placed = placed_count ? malloc(placed_count * sizeof(PlacedDiag)) : NULL;
+    bool attributed = placed_count == 0 || placed;
+    if (placed) {
+        size_t seq = 0;
+        size_t last_model = 0;
+        for (Sysml2Diagnostic *d = mark ? mark->next : diag->first; d; d = d->next, seq++) {
+            /* Diagnostics arrive grouped by file, so try the last owner first */
+            size_t owner = SIZE_MAX;
+            if (d->file && models[last_model]->source_file == d->file) {
+                owner = last_model;
+            } else {
+                for (size_t m = 0; d->file && m < count; m++) {
+                    if (models[m]->source_file == d->file) {
+                        owner = m;
+                        break;
+                    }
+                }
+            }
+            if (owner == SIZE_MAX) {
+                attributed = false;
+                break;
+            }
+            last_model = owner;
+            placed[seq] = (PlacedDiag){ d, sysml2_validator_diag_pass(d->code), owner, seq };
+        }
+    }
+
+    if (attributed && placed_count > 0) {
+        qsort(placed, placed_count, sizeof(PlacedDiag), compare_placed);
+        for (size_t i = 0; i < placed_count; i++) {
+            placed[i].diag->next = i + 1 < placed_count ? placed[i + 1].diag : NULL;
+        }
+        if (mark) {
+            mark->next = placed[0].diag;
+        } else {
+            diag->first = placed[0].diag;
+        }
+        diag->last = placed[placed_count - 1].diag;
+    }
+
+    /* A run cut short by the error limit has incomplete results */
+    if (attributed && any_check && !sysml2_diag_should_stop(diag)) {
+        const Sysml2Diagnostic **own = placed_count
+            ? malloc(placed_count * sizeof(Sysml2Diagnostic *)) : NULL;
+        for (size_t m = 0; m < count; m++) {
+            if (!check[m] || !deps[m] || (placed_count && !own)) continue;
+            size_t own_count = 0;
+            bool unresolved = false;
+            for (size_t i = 0; i < placed_count; i++) {
+                if (placed[i].model != m) continue;
+                own[own_count++] = placed[i].diag;
+                if (is_unresolved_name(placed[i].diag->code)) unresolved = true;
+            }
+            if (!unresolved) {
+                sysml2_model_cache_store_results(cache, sources[m].abs_path, config_hash,
+                                                 deps[m], dep_counts[m], own, own_count,
+                                                 models[m]->source_file);
+                continue;
+            }
+            size_t all_count = 0;
+            Sysml2ResultDependency *all = collect_all_dependencies(sources, count, m, &all_count);
+            if (all) {
+                sysml2_model_cache_store_results(cache, sources[m].abs_path, config_hash,
+                                                 all, all_count, own, own_count,
+                                                 models[m]->source_file);
+                free(all);
+            }
+        }
+        free(own);
+    }
+
+    for (size_t m = 0; m < count; m++) {
+        free(sources[m].abs_path);
+        free(sources[m].uses);
+        free(deps[m]);
+    }
+    free(placed);
+    free(sources);
+    free(deps);
+    free(dep_counts);
+    free(queue);
+    free(seen);
+    free(check);
+    return result;
+}
+
+/* Validate every cached model into ctx->diag */
+static Sysml2Result validate_loaded(Sysml2PipelineContext *ctx) {
+    size_t model_count;
+    SysmlSemanticModel **models = sysml2_resolver_get_all_models(ctx->resolver, &model_count);
+    if (!models || model_count == 0) {
+        free(models);
+        return SYSML2_OK;
+    }
+
+    Sysml2ValidationOptions val_opts = SYSML_VALIDATION_OPTIONS_DEFAULT;
+    val_opts.jobs = ctx->options->jobs;
+    val_opts.stats = ctx->stats;
+    val_opts.trace = ctx->trace;
+    sysml2_stats_phase_start(ctx->stats, SYSML2_PHASE_VALIDATE);
+    val_opts.layer = sysml2_pipeline_library_layer(ctx);
+    sysml2_trace_begin(ctx->trace, "validate", "validate", NULL);
+    Sysml2Result result = ctx->resolver->model_cache
+        ? validate_cached(ctx, models, model_count, &val_opts)
+        : sysml2_validate_multi(models, model_count, ctx->diag, ctx->arena, ctx->intern,
+                                &val_opts);
+    sysml2_trace_end(ctx->trace);
+    /* The symbol table and indexes are allocated before this can be checked */
+    if (sysml2_memory_report(ctx->diag, NULL)) result = SYSML2_ERROR_OUT_OF_MEMORY;
+    sysml2_stats_phase_stop(ctx->stats, SYSML2_PHASE_VALIDATE);
+
+    free(models);
+    return result;
+}
+
+/* Whether validation reported a name it could not resolve */
+static bool has_undefined_names(const Sysml2DiagContext *diag) {
+    for (const Sysml2Diagnostic *d = diag->first; d; d = d->next) {
+        if (d->code == SYSML2_DIAG_E3001_UNDEFINED_TYPE ||
+            d->code == SYSML2_DIAG_E3002_UNDEFINED_FEATURE ||
+            d->code == SYSML2_DIAG_E3003_UNDEFINED_NAMESPACE) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * --lazy-libraries: validate with the library files names lead to, and
+ * fall back to all of them when a name is still undefined
+ */
+static Sysml2Result validate_lazy(Sysml2PipelineContext *ctx) {
+    size_t loaded = sysml2_resolver_load_referenced(ctx->resolver, ctx->diag);
+    if (ctx->options->verbose) {
+        fprintf(stderr, "note: loaded %zu referenced library file(s)\n", loaded);
+    }
+
+    /* Validate into a scratch context first: its results are only kept
+     * if no undefined name asks for the rest of the libraries */
+    Sysml2DiagContext scratch;
+    sysml2_diag_context_init(&scratch, ctx->arena);
+    sysml2_diag_set_max_errors(&scratch, ctx->diag->max_errors);
+    scratch.treat_warnings_as_errors = ctx->diag->treat_warnings_as_errors;
+
+    Sysml2DiagContext *diag = ctx->diag;
+    ctx->diag = &scratch;
+    Sysml2Result result = validate_loaded(ctx);
+    ctx->diag = diag;
+
+    if (!has_undefined_names(&scratch)) {
+        sysml2_diag_merge(diag, &scratch);
+        return result;
+    }
+
+    if (ctx->options->verbose) {
+        fprintf(stderr, "note: undefined names remain, loading all library files\n");
+    }
+    sysml2_resolver_preload_libraries(ctx->resolver, diag);
+    return validate_loaded(ctx);
+}
+
+Sysml2Result sysml2_pipeline_validate_all(Sysml2PipelineContext *ctx) {
+    if (!ctx || ctx->options->parse_only) {
+        return SYSML2_OK;
+    }
+    if (sysml2_memory_report(ctx->diag, NULL)) {
+        return SYSML2_ERROR_OUT_OF_MEMORY;
+    }
+
+    if (ctx->options->lazy_libraries && !ctx->options->no_resolve &&
+        !ctx->resolver->preloaded) {
+        return validate_lazy(ctx);
+    }
+    return validate_loaded(ctx);
+}
+
+Sysml2QueryResult *sysml2_pipeline_query_users(
+    Sysml2PipelineContext *ctx,
+    const Sysml2QueryPattern *patterns,
+    size_t depth
+) {
+    if (!ctx || !patterns) {
+        return NULL;
+    }
+
+    size_t model_count;
+    SysmlSemanticModel **models = sysml2_resolver_get_all_models(ctx->resolver, &model_count);
+    if (!models || model_count == 0) {
+        free(models);
+        return NULL;
+    }
+
+    sysml2_trace_begin(ctx->trace, "references", "query", NULL);
+    Sysml2RefIndex index = {0};
+    Sysml2Result indexed = sysml2_validator_index_references(
+        models, model_count, ctx->arena, ctx->intern, &index);
+    sysml2_trace_end(ctx->trace);
+
+    Sysml2QueryResult *result = indexed == SYSML2_OK
+        ? sysml2_query_users(patterns, &index, depth, models, model_count, ctx->arena)
+        : NULL;
+    free(models);
+    return result;
+}
+
+Sysml2Result sysml2_pipeline_write_json(
+    Sysml2PipelineContext *ctx,
+    SysmlSemanticModel *model,
+    FILE *out
+) {
+    if (!ctx || !model || !out) {
+        return SYSML2_ERROR_SEMANTIC;
+    }
+    if (sysml2_memory_report(ctx->diag, NULL)) return SYSML2_ERROR_OUT_OF_MEMORY;
+
+    Sysml2JsonOptions json_opts = SYSML_JSON_OPTIONS_DEFAULT;
+    json_opts.pretty = !ctx->options->compact_json;
+    sysml2_stats_phase_start(ctx->stats, SYSML2_PHASE_WRITE);
+    sysml2_json_write(model, out, &json_opts);
+    /* Compact documents are one per line */
+    if (!json_opts.pretty) fputc('\n', out);
+    sysml2_stats_phase_stop(ctx->stats, SYSML2_PHASE_WRITE);
+    return SYSML2_OK;
+}
+
+Sysml2Result sysml2_pipeline_write_ndjson(
+    Sysml2PipelineContext *ctx,
+    SysmlSemanticModel *model,
+    FILE *out
+) {
+    if (!ctx || !model || !out) {
+        return SYSML2_ERROR_SEMANTIC;
+    }
+    if (sysml2_memory_report(ctx->diag, NULL)) return SYSML2_ERROR_OUT_OF_MEMORY;
+
+    sysml2_stats_phase_start(ctx->stats, SYSML2_PHASE_WRITE);
+    Sysml2Result result = sysml2_json_write_ndjson(model, out, NULL);
+    sysml2_stats_phase_stop(ctx->stats, SYSML2_PHASE_WRITE);
+    return result;
+}
+
+Sysml2Result sysml2_pipeline_write_sysml(
     Sysml2PipelineContext *ctx,
     SysmlSemanticModel *model,
     FILE *out
@@ -345,23 +1826,180 @@ Sysml2Result sysml2_pipeline_write_sysml(
     if (!ctx || !model || !out) {
         return SYSML2_ERROR_SEMANTIC;
     }
+    if (sysml2_memory_report(ctx->diag, NULL)) return SYSML2_ERROR_OUT_OF_MEMORY;
 
+    sysml2_stats_phase_start(ctx->stats, SYSML2_PHASE_WRITE);
     sysml2_sysml_write(model, out);
+    sysml2_stats_phase_stop(ctx->stats, SYSML2_PHASE_WRITE);
     return SYSML2_OK;
 }
 
+/* One model rendered by a --jobs SysML writer thread */
+typedef struct {
+    const SysmlSemanticModel *model;
+    char *text;                  /* Rendered source (malloc'd) */
+    Sysml2Result result;
+    bool done;
+} RenderJob;
+
+/* Work queue shared by SysML writer threads */
+typedef struct {
+    RenderJob *jobs;
+    size_t count;
+    size_t next;                 /* Next job to hand out */
+    Sysml2Trace *trace;          /* Span output (NULL = off) */
+    pthread_mutex_t lock;
+    pthread_cond_t job_done;
+} RenderQueue;
+
+static void *render_worker(void *arg) {
+    RenderQueue *queue = arg;
+
+    for (;;) {
+        pthread_mutex_lock(&queue->lock);
+        if (queue->next >= queue->count) {
+            pthread_mutex_unlock(&queue->lock);
+            break;
+        }
+        RenderJob *job = &queue->jobs[queue->next++];
+        pthread_mutex_unlock(&queue->lock);
+
+        sysml2_trace_begin(queue->trace, "write", "render", job->model->source_name);
+        job->result = sysml2_sysml_write_string(job->model, &job->text);
+        sysml2_trace_end(queue->trace);
+
+        pthread_mutex_lock(&queue->lock);
+        job->done = true;
+        pthread_cond_broadcast(&queue->job_done);
+        pthread_mutex_unlock(&queue->lock);
+    }
+    return NULL;
+}
+
+Sysml2Result sysml2_pipeline_write_sysml_models(
+    Sysml2PipelineContext *ctx,
+    SysmlSemanticModel **models,
+    size_t model_count,
+    FILE *out
+) {
+    if (!ctx || (!models && model_count > 0) || !out) {
+        return SYSML2_ERROR_SEMANTIC;
+    }
+    if (sysml2_memory_report(ctx->diag, NULL)) return SYSML2_ERROR_OUT_OF_MEMORY;
+
+    RenderQueue queue = {0};
+    queue.jobs = calloc(model_count ? model_count : 1, sizeof(RenderJob));
+    if (!queue.jobs) return SYSML2_ERROR_OUT_OF_MEMORY;
+    for (size_t i = 0; i < model_count; i++) {
+        if (models[i]) queue.jobs[queue.count++].model = models[i];
+    }
+
+    size_t jobs = ctx->options->jobs;
+    size_t thread_count = 0;
+    pthread_t *threads = NULL;
+    if (jobs > 1 && queue.count > 1) {
+        threads = malloc(SYSML2_MIN(jobs, queue.count) * sizeof(pthread_t));
+    }
+
+    sysml2_stats_phase_start(ctx->stats, SYSML2_PHASE_WRITE);
+    if (threads) {
+        queue.trace = ctx->trace;
+        pthread_mutex_init(&queue.lock, NULL);
+        pthread_cond_init(&queue.job_done, NULL);
+        for (size_t t = 0; t < SYSML2_MIN(jobs, queue.count); t++) {
+            if (pthread_create(&threads[thread_count], NULL, render_worker, &queue) != 0) break;
+            thread_count++;
+        }
+    }
+
+    /* Without threads, this thread renders each model as it is written */
+    Sysml2Result overall = SYSML2_OK;
+    for (size_t i = 0; i < queue.count; i++) {
+        RenderJob *job = &queue.jobs[i];
+        if (thread_count > 0) {
+            pthread_mutex_lock(&queue.lock);
+            while (!job->done) pthread_cond_wait(&queue.job_done, &queue.lock);
+            pthread_mutex_unlock(&queue.lock);
+        } else {
+            job->result = sysml2_sysml_write_string(job->model, &job->text);
+        }
+
+        if (job->result == SYSML2_OK) {
+            fwrite(job->text, 1, strlen(job->text), out);
+        } else if (overall == SYSML2_OK) {
+            overall = job->result;
+        }
+        free(job->text);
+        job->text = NULL;
+    }
+
+    for (size_t t = 0; t < thread_count; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    if (threads) {
+        pthread_cond_destroy(&queue.job_done);
+        pthread_mutex_destroy(&queue.lock);
+    }
+    sysml2_stats_phase_stop(ctx->stats, SYSML2_PHASE_WRITE);
+
+    free(threads);
+    free(queue.jobs);
+    return overall;
+}
+
+Sysml2Result sysml2_pipeline_write_binary(
+    Sysml2PipelineContext *ctx,
+    SysmlSemanticModel **models,
+    size_t model_count,
+    FILE *out
+) {
+    if (!ctx || !models || !out) {
+        return SYSML2_ERROR_SEMANTIC;
+    }
+    if (sysml2_memory_report(ctx->diag, NULL)) return SYSML2_ERROR_OUT_OF_MEMORY;
+
+    sysml2_stats_phase_start(ctx->stats, SYSML2_PHASE_WRITE);
+    Sysml2Result result = sysml2_binary_write(models, model_count, out);
+    sysml2_stats_phase_stop(ctx->stats, SYSML2_PHASE_WRITE);
+    return result;
+}
+
 void sysml2_pipeline_print_diagnostics(Sysml2PipelineContext *ctx, FILE *output) {
     if (!ctx || !ctx->diag) return;
 
     Sysml2DiagOptions diag_options = {
         .output = output,
+        .format = ctx->options->diag_format,
         .color_mode = ctx->options->color_mode,
         .show_source_context = true,
         .show_column_numbers = true,
         .show_error_codes = true,
     };
     sysml2_diag_print_all(ctx->diag, &diag_options);
-    sysml2_diag_print_summary(ctx->diag, output);
+    /* Tools reading JSON get nothing but diagnostic objects */
+    if (diag_options.format == SYSML2_DIAG_FORMAT_TEXT) {
+        sysml2_diag_print_summary(ctx->diag, output);
+    }
+}
+
+void sysml2_pipeline_print_stats(Sysml2PipelineContext *ctx, FILE *output) {
+    if (!ctx || !ctx->stats) return;
+
+    const Sysml2ImportResolver *resolver = ctx->resolver;
+    Sysml2StatsCounters counters = {
+        .input_files = ctx->files_parsed,
+        .input_bytes = ctx->bytes_parsed,
+        .library_files = resolver->files_parsed,
+        .library_bytes = resolver->bytes_parsed,
+        .model_cache_hits = resolver->model_cache ? resolver->model_cache->hits : 0,
+        .model_cache_misses = resolver->model_cache ? resolver->model_cache->misses : 0,
+        .file_cache_hits = resolver->file_cache_hits,
+        .file_cache_count = resolver->file_cache_count,
+        .intern_count = sysml2_intern_count(ctx->intern),
+        .intern_capacity = ctx->intern->capacity,
+    };
+    sysml2_stats_print(ctx->stats, &counters,
+                       ctx->options->stats_format == SYSML2_STATS_JSON, output);
 }
 
 Sysml2DiagContext *sysml2_pipeline_get_diag(Sysml2PipelineContext *ctx) {
@@ -388,12 +2026,35 @@ Sysml2Result sysml2_pipeline_write_query_json(
     if (!ctx || !result || !out) {
         return SYSML2_ERROR_SEMANTIC;
     }
+    if (sysml2_memory_report(ctx->diag, NULL)) return SYSML2_ERROR_OUT_OF_MEMORY;
 
     Sysml2JsonOptions json_opts = SYSML_JSON_OPTIONS_DEFAULT;
+    json_opts.pretty = !ctx->options->compact_json;
+    json_opts.jobs = ctx->options->jobs;
+    sysml2_stats_phase_start(ctx->stats, SYSML2_PHASE_WRITE);
     sysml2_json_write_query(result, out, &json_opts);
+    /* Compact documents are one per line */
+    if (!json_opts.pretty) fputc('\n', out);
+    sysml2_stats_phase_stop(ctx->stats, SYSML2_PHASE_WRITE);
     return SYSML2_OK;
 }
 
+Sysml2Result sysml2_pipeline_write_query_ndjson(
+    Sysml2PipelineContext *ctx,
+    const Sysml2QueryResult *result,
+    FILE *out
+) {
+    if (!ctx || !result || !out) {
+        return SYSML2_ERROR_SEMANTIC;
+    }
+    if (sysml2_memory_report(ctx->diag, NULL)) return SYSML2_ERROR_OUT_OF_MEMORY;
+
+    sysml2_stats_phase_start(ctx->stats, SYSML2_PHASE_WRITE);
+    Sysml2Result written = sysml2_json_write_query_ndjson(result, out);
+    sysml2_stats_phase_stop(ctx->stats, SYSML2_PHASE_WRITE);
+    return written;
+}
+
 Sysml2Result sysml2_pipeline_write_query_sysml(
     Sysml2PipelineContext *ctx,
     const Sysml2QueryResult *result,
@@ -404,7 +2065,37 @@ Sysml2Result sysml2_pipeline_write_query_sysml(
     if (!ctx || !result || !out) {
         return SYSML2_ERROR_SEMANTIC;
     }
+    if (sysml2_memory_report(ctx->diag, NULL)) return SYSML2_ERROR_OUT_OF_MEMORY;
 
+    sysml2_stats_phase_start(ctx->stats, SYSML2_PHASE_WRITE);
     sysml2_sysml_write_query(result, models, model_count, ctx->arena, out);
+    sysml2_stats_phase_stop(ctx->stats, SYSML2_PHASE_WRITE);
     return SYSML2_OK;
 }
+
+Sysml2Result sysml2_pipeline_write_query_binary(
+    Sysml2PipelineContext *ctx,
+    const Sysml2QueryResult *result,
+    FILE *out
+) {
+    if (!ctx || !result || !out) {
+        return SYSML2_ERROR_SEMANTIC;
+    }
+    if (sysml2_memory_report(ctx->diag, NULL)) return SYSML2_ERROR_OUT_OF_MEMORY;
+
+    /* Present the result as one model; the writer only reads the arrays */
+    SysmlSemanticModel model = {
+        .source_name = "<query>",
+        .elements = result->elements,
+        .element_count = result->element_count,
+        .relationships = result->relationships,
+        .relationship_count = result->relationship_count,
+        .imports = result->imports,
+        .import_count = result->import_count,
+    };
+    SysmlSemanticModel *models[] = { &model };
+    sysml2_stats_phase_start(ctx->stats, SYSML2_PHASE_WRITE);
+    Sysml2Result written = sysml2_binary_write(models, 1, out);
+    sysml2_stats_phase_stop(ctx->stats, SYSML2_PHASE_WRITE);
+    return written;
+}
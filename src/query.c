@@ -5,6 +5,7 @@
  */
 
 #include "sysml2/query.h"
+#include "sysml2/intern.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -144,15 +145,352 @@ bool sysml2_query_matches_any(const Sysml2QueryPattern *patterns, const char *el
     return false;
 }
 
+/* ========== Compiled Matcher ========== */
+
+/*
+ * Check that a base path splits cleanly at "::": non-empty segments and
+ * no ':' outside separators. For such paths, "id starts with base::"
+ * is the same as "base's segments are a prefix of id's segments".
+ */
+static bool is_segment_path(const char *path) {
+    if (!*path) return false;
+    for (size_t i = 0; path[i]; i++) {
+        if (path[i] != ':') continue;
+        if (i == 0 || path[i + 1] != ':' || path[i + 2] == '\0' || path[i + 2] == ':') {
+            return false;
+        }
+        i++;  /* Skip second ':' */
+    }
+    return true;
+}
+
+static Sysml2QueryTrieNode *trie_child(
+    const Sysml2QueryTrieNode *node,
+    const char *segment,
+    size_t length
+) {
+    for (Sysml2QueryTrieNode *c = node->children; c; c = c->next) {
+        if (c->segment_length == length && memcmp(c->segment, segment, length) == 0) {
+            return c;
+        }
+    }
+    return NULL;
+}
+
+static bool trie_insert(Sysml2QueryTrieNode *root, const Sysml2QueryPattern *p, Sysml2Arena *arena) {
+    Sysml2QueryTrieNode *node = root;
+    const char *seg = p->base_path;
+    for (;;) {
+        const char *sep = strstr(seg, "::");
+        size_t len = sep ? (size_t)(sep - seg) : strlen(seg);
+
+        Sysml2QueryTrieNode *child = trie_child(node, seg, len);
+        if (!child) {
+            child = SYSML2_ARENA_NEW(arena, Sysml2QueryTrieNode);
+            if (!child) return false;
+            child->segment = seg;
+            child->segment_length = len;
+            child->next = node->children;
+            node->children = child;
+        }
+        node = child;
+
+        if (!sep) break;
+        seg = sep + 2;
+    }
+    node->kinds |= 1u << p->kind;
+    return true;
+}
+
+/*
+ * Compile a pattern list into a matcher
+ */
+Sysml2QueryMatcher *sysml2_query_compile(const Sysml2QueryPattern *patterns, Sysml2Arena *arena) {
+    Sysml2QueryMatcher *m = SYSML2_ARENA_NEW(arena, Sysml2QueryMatcher);
+    if (!m) return NULL;
+
+    size_t pattern_count = 0;
+    for (const Sysml2QueryPattern *p = patterns; p; p = p->next) pattern_count++;
+
+    for (const Sysml2QueryPattern *p = patterns; p; p = p->next) {
+        if (is_segment_path(p->base_path)) {
+            if (!trie_insert(&m->root, p, arena)) return NULL;
+            continue;
+        }
+        if (!m->fallback) {
+            m->fallback = SYSML2_ARENA_NEW_ARRAY(arena, const Sysml2QueryPattern *, pattern_count);
+            if (!m->fallback) return NULL;
+        }
+        m->fallback[m->fallback_count++] = p;
+    }
+
+    return m;
+}
+
+/*
+ * Check if an element ID matches a compiled matcher
+ */
+bool sysml2_query_matcher_matches(const Sysml2QueryMatcher *matcher, const char *element_id) {
+    if (!matcher || !element_id) {
+        return false;
+    }
+
+    /* Walk the ID's segments down the trie */
+    const Sysml2QueryTrieNode *node = &matcher->root;
+    const char *seg = element_id;
+    for (;;) {
+        const char *sep = strstr(seg, "::");
+        size_t len = sep ? (size_t)(sep - seg) : strlen(seg);
+
+        node = trie_child(node, seg, len);
+        if (!node) break;
+
+        if (!sep) {
+            /* ID ends at this node: it is a base path */
+            if (node->kinds & ((1u << SYSML2_QUERY_EXACT) | (1u << SYSML2_QUERY_RECURSIVE))) {
+                return true;
+            }
+            break;
+        }
+
+        const char *rest = sep + 2;
+        if (*rest) {
+            if (node->kinds & (1u << SYSML2_QUERY_RECURSIVE)) return true;
+            if ((node->kinds & (1u << SYSML2_QUERY_DIRECT)) && !strchr(rest, ':')) return true;
+        }
+        seg = rest;
+    }
+
+    for (size_t i = 0; i < matcher->fallback_count; i++) {
+        if (sysml2_query_matches(matcher->fallback[i], element_id)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Deepest element path sysml2_query_matcher_matches_node walks itself */
+#define MATCH_PATH_MAX 64
+
+bool sysml2_query_matcher_matches_node(const Sysml2QueryMatcher *matcher, const SysmlNode *node) {
+    if (!matcher || !node || !node->id) {
+        return false;
+    }
+    if (matcher->fallback_count > 0 || !node->has_path || node->depth >= MATCH_PATH_MAX) {
+        return sysml2_query_matcher_matches(matcher, node->id);
+    }
+
+    /* The path from the top-level element down, if it is fully linked */
+    const SysmlNode *path[MATCH_PATH_MAX];
+    size_t levels = node->depth + 1;
+    const SysmlNode *at = node;
+    for (size_t k = levels; k > 0; k--) {
+        if (!at || !at->has_path || at->depth != k - 1) {
+            return sysml2_query_matcher_matches(matcher, node->id);
+        }
+        path[k - 1] = at;
+        at = at->parent;
+    }
+
+    /* Colons in a name (or an empty one) make ID splitting the reference */
+    const char *leaf = sysml2_node_local_id(node);
+    if (!*leaf || strchr(leaf, ':')) {
+        return sysml2_query_matcher_matches(matcher, node->id);
+    }
+
+    const Sysml2QueryTrieNode *trie = &matcher->root;
+    for (size_t k = 0; k < levels; k++) {
+        const char *seg = sysml2_node_local_id(path[k]);
+        size_t len = k + 1 < levels
+            ? sysml2_node_parent_length(path[k + 1]) - path[k]->name_offset
+            : strlen(seg);
+        if (len == 0 || memchr(seg, ':', len)) {
+            return sysml2_query_matcher_matches(matcher, node->id);
+        }
+
+        trie = trie_child(trie, seg, len);
+        if (!trie) return false;
+
+        if (k + 1 == levels) {
+            return (trie->kinds & ((1u << SYSML2_QUERY_EXACT) | (1u << SYSML2_QUERY_RECURSIVE))) != 0;
+        }
+        if (trie->kinds & (1u << SYSML2_QUERY_RECURSIVE)) return true;
+        if ((trie->kinds & (1u << SYSML2_QUERY_DIRECT)) && k + 2 == levels) return true;
+    }
+    return false;
+}
+
+/* ========== ID Set ========== */
+
+/* Smallest slot table allocated on first insert */
+#define ID_SET_MIN_CAPACITY 64
+
+/* Probe for id: returns its slot, or the empty slot where it belongs */
+static Sysml2IdSetSlot *id_set_probe(const Sysml2IdSet *set, const char *id, uint32_t hash) {
+    size_t mask = set->capacity - 1;
+    for (size_t i = hash & mask; ; i = (i + 1) & mask) {
+        Sysml2IdSetSlot *slot = &set->slots[i];
+        if (!slot->id) return slot;
+        if (slot->hash == hash && (slot->id == id || strcmp(slot->id, id) == 0)) {
+            return slot;
+        }
+    }
+}
+
+static bool id_set_grow(Sysml2IdSet *set, Sysml2Arena *arena) {
+    size_t new_cap = set->capacity == 0 ? ID_SET_MIN_CAPACITY : set->capacity * 2;
+    Sysml2IdSetSlot *new_slots = SYSML2_ARENA_NEW_ARRAY(arena, Sysml2IdSetSlot, new_cap);
+    if (!new_slots) return false;
+
+    size_t mask = new_cap - 1;
+    for (size_t i = 0; i < set->capacity; i++) {
+        const Sysml2IdSetSlot *slot = &set->slots[i];
+        if (!slot->id) continue;
+        size_t j = slot->hash & mask;
+        while (new_slots[j].id) j = (j + 1) & mask;
+        new_slots[j] = *slot;
+    }
+
+    set->slots = new_slots;
+    set->capacity = new_cap;
+    return true;
+}
+
+bool sysml2_id_set_add(Sysml2IdSet *set, const char *id, Sysml2Arena *arena) {
+    if (!set || !id) return false;
+
+    /* Keep the load factor at or below 3/4 */
+    if ((set->count + 1) * 4 > set->capacity * 3 && !id_set_grow(set, arena)) {
+        return false;
+    }
+
+    uint32_t hash = sysml2_hash_string(id, strlen(id));
+    Sysml2IdSetSlot *slot = id_set_probe(set, id, hash);
+    if (!slot->id) {
+        slot->id = id;
+        slot->hash = hash;
+        set->count++;
+    }
+    return true;
+}
+
+bool sysml2_id_set_contains(const Sysml2IdSet *set, const char *id) {
+    if (!set || !id || set->count == 0) return false;
+
+    uint32_t hash = sysml2_hash_string(id, strlen(id));
+    return id_set_probe(set, id, hash)->id != NULL;
+}
+
+/* ========== ID Map ========== */
+
+/* Smallest slot table allocated on first insert */
+#define ID_MAP_MIN_CAPACITY 64
+
+/* Probe for id: returns its slot, or the empty slot where it belongs */
+static Sysml2IdMapSlot *id_map_probe(const Sysml2IdMap *map, const char *id) {
+    size_t mask = map->capacity - 1;
+    for (size_t i = sysml2_id_hash(id) & mask; ; i = (i + 1) & mask) {
+        Sysml2IdMapSlot *slot = &map->slots[i];
+        if (!slot->id || sysml2_id_eq(slot->id, id)) return slot;
+    }
+}
+
+static bool id_map_grow(Sysml2IdMap *map, Sysml2Arena *arena) {
+    size_t new_cap = map->capacity == 0 ? ID_MAP_MIN_CAPACITY : map->capacity * 2;
+    Sysml2IdMapSlot *new_slots = SYSML2_ARENA_NEW_ARRAY(arena, Sysml2IdMapSlot, new_cap);
+    if (!new_slots) return false;
+
+    size_t mask = new_cap - 1;
+    for (size_t i = 0; i < map->capacity; i++) {
+        const Sysml2IdMapSlot *slot = &map->slots[i];
+        if (!slot->id) continue;
+        size_t j = sysml2_id_hash(slot->id) & mask;
+        while (new_slots[j].id) j = (j + 1) & mask;
+        new_slots[j] = *slot;
+    }
+
+    map->slots = new_slots;
+    map->capacity = new_cap;
+    return true;
+}
+
+void *sysml2_id_map_get(const Sysml2IdMap *map, const char *id) {
+    if (!map || !id || map->count == 0) return NULL;
+    return id_map_probe(map, id)->value;
+}
+
+Sysml2IdMapSlot *sysml2_id_map_slot(Sysml2IdMap *map, const char *id, Sysml2Arena *arena) {
+    if (!map || !id) return NULL;
+
+    /* Keep the load factor at or below 3/4 */
+    if ((map->count + 1) * 4 > map->capacity * 3 && !id_map_grow(map, arena)) {
+        return NULL;
+    }
+
+    Sysml2IdMapSlot *slot = id_map_probe(map, id);
+    if (!slot->id) {
+        slot->id = id;
+        map->count++;
+    }
+    return slot;
+}
+
+/* ========== Reference Index ========== */
+
+/* Users of one element, in the order added */
+typedef struct {
+    Sysml2RefEdge *first;
+    Sysml2RefEdge *last;
+} RefUsers;
+
+bool sysml2_ref_index_add(
+    Sysml2RefIndex *index,
+    const char *id,
+    SysmlNode *user,
+    Sysml2RefKind kind,
+    Sysml2Arena *arena
+) {
+    if (!index || !id || !user || !user->id) return false;
+
+    Sysml2IdMapSlot *slot = sysml2_id_map_slot(&index->users, id, arena);
+    if (!slot) return false;
+    RefUsers *users = slot->value;
+    if (!users) {
+        users = SYSML2_ARENA_NEW(arena, RefUsers);
+        if (!users) return false;
+        slot->value = users;
+    }
+
+    Sysml2RefEdge *edge = SYSML2_ARENA_NEW(arena, Sysml2RefEdge);
+    if (!edge) return false;
+    edge->user = user;
+    edge->kind = kind;
+    edge->next = NULL;
+
+    if (users->last) {
+        users->last->next = edge;
+    } else {
+        users->first = edge;
+    }
+    users->last = edge;
+    index->edge_count++;
+    return true;
+}
+
+const Sysml2RefEdge *sysml2_ref_index_users(const Sysml2RefIndex *index, const char *id) {
+    if (!index) return NULL;
+    const RefUsers *users = sysml2_id_map_get(&index->users, id);
+    return users ? users->first : NULL;
+}
+
+/* ========== Query Result ========== */
+
 /*
  * Add an element ID to the result's ID set
  */
 static bool add_element_id(Sysml2QueryResult *result, const char *id, Sysml2Arena *arena) {
-    /* Check if already present */
-    for (size_t i = 0; i < result->element_id_count; i++) {
-        if (strcmp(result->element_ids[i], id) == 0) {
-            return true;  /* Already in set */
-        }
+    if (sysml2_id_set_contains(&result->element_id_set, id)) {
+        return true;  /* Already in set */
     }
 
     /* Grow capacity if needed */
@@ -168,6 +506,9 @@ static bool add_element_id(Sysml2QueryResult *result, const char *id, Sysml2Aren
         result->element_id_capacity = new_cap;
     }
 
+    if (!sysml2_id_set_add(&result->element_id_set, id, arena)) {
+        return false;
+    }
     result->element_ids[result->element_id_count++] = id;
     return true;
 }
@@ -236,6 +577,52 @@ static bool add_import(Sysml2QueryResult *result, SysmlImport *imp, Sysml2Arena
     return true;
 }
 
+/*
+ * Add the relationships with both endpoints in the result, and the
+ * imports owned by elements in it
+ */
+static void collect_links(
+    Sysml2QueryResult *result,
+    SysmlSemanticModel **models,
+    size_t model_count,
+    Sysml2Arena *arena
+) {
+    /* Collect relationships where both endpoints are in result */
+    for (size_t m = 0; m < model_count; m++) {
+        SysmlSemanticModel *model = models[m];
+        if (!model) continue;
+
+        for (size_t i = 0; i < model->relationship_count; i++) {
+            SysmlRelationship *rel = model->relationships[i];
+            if (!rel) continue;
+
+            /* Include relationship only if both source and target are in result */
+            bool source_in = sysml2_query_result_contains(result, rel->source);
+            bool target_in = sysml2_query_result_contains(result, rel->target);
+
+            if (source_in && target_in) {
+                add_relationship(result, rel, arena);
+            }
+        }
+    }
+
+    /* Collect imports where owner scope is in result */
+    for (size_t m = 0; m < model_count; m++) {
+        SysmlSemanticModel *model = models[m];
+        if (!model) continue;
+
+        for (size_t i = 0; i < model->import_count; i++) {
+            SysmlImport *imp = model->imports[i];
+            if (!imp) continue;
+
+            /* Include import if its owner scope is in result */
+            if (imp->owner_scope && sysml2_query_result_contains(result, imp->owner_scope)) {
+                add_import(result, imp, arena);
+            }
+        }
+    }
+}
+
 /*
  * Execute a query against semantic models
  */
@@ -254,6 +641,9 @@ Sysml2QueryResult *sysml2_query_execute(
 
     memset(result, 0, sizeof(Sysml2QueryResult));
 
+    Sysml2QueryMatcher *matcher = sysml2_query_compile(patterns, arena);
+    if (!matcher) return NULL;
+
     /* Pass 1: Collect matching elements */
     for (size_t m = 0; m < model_count; m++) {
         SysmlSemanticModel *model = models[m];
@@ -261,47 +651,104 @@ Sysml2QueryResult *sysml2_query_execute(
 
         for (size_t i = 0; i < model->element_count; i++) {
             SysmlNode *node = model->elements[i];
-            if (node && node->id && sysml2_query_matches_any(patterns, node->id)) {
+            if (node && node->id && sysml2_query_matcher_matches_node(matcher, node)) {
                 add_element(result, node, arena);
             }
         }
     }
 
-    /* Pass 2: Collect relationships where both endpoints are in result */
-    for (size_t m = 0; m < model_count; m++) {
-        SysmlSemanticModel *model = models[m];
-        if (!model) continue;
+    /* Pass 2: Relationships and imports of the matched elements */
+    collect_links(result, models, model_count, arena);
 
-        for (size_t i = 0; i < model->relationship_count; i++) {
-            SysmlRelationship *rel = model->relationships[i];
-            if (!rel) continue;
+    return result;
+}
 
-            /* Include relationship only if both source and target are in result */
-            bool source_in = sysml2_query_result_contains(result, rel->source);
-            bool target_in = sysml2_query_result_contains(result, rel->target);
+/* Growable list of element IDs (one level of a users search) */
+typedef struct {
+    const char **ids;
+    size_t count;
+    size_t capacity;
+} IdList;
+
+static bool id_list_push(IdList *list, const char *id) {
+    if (list->count >= list->capacity) {
+        size_t new_cap = list->capacity == 0 ? 32 : list->capacity * 2;
+        const char **new_ids = realloc((void *)list->ids, new_cap * sizeof(const char *));
+        if (!new_ids) return false;
+        list->ids = new_ids;
+        list->capacity = new_cap;
+    }
+    list->ids[list->count++] = id;
+    return true;
+}
 
-            if (source_in && target_in) {
-                add_relationship(result, rel, arena);
-            }
-        }
+/*
+ * Find the users of matching elements, level by level
+ */
+Sysml2QueryResult *sysml2_query_users(
+    const Sysml2QueryPattern *patterns,
+    const Sysml2RefIndex *index,
+    size_t depth,
+    SysmlSemanticModel **models,
+    size_t model_count,
+    Sysml2Arena *arena
+) {
+    if (!patterns || !index || !models || model_count == 0) {
+        return NULL;
     }
 
-    /* Pass 3: Collect imports where owner scope is in result */
-    for (size_t m = 0; m < model_count; m++) {
+    Sysml2QueryResult *result = sysml2_arena_alloc(arena, sizeof(Sysml2QueryResult));
+    if (!result) return NULL;
+
+    memset(result, 0, sizeof(Sysml2QueryResult));
+
+    Sysml2QueryMatcher *matcher = sysml2_query_compile(patterns, arena);
+    if (!matcher) return NULL;
+
+    /* Visited elements: the starting ones plus every user found so far */
+    Sysml2IdSet visited = {0};
+    IdList level = {0};
+    IdList next = {0};
+    bool ok = true;
+
+    for (size_t m = 0; m < model_count && ok; m++) {
         SysmlSemanticModel *model = models[m];
         if (!model) continue;
 
-        for (size_t i = 0; i < model->import_count; i++) {
-            SysmlImport *imp = model->imports[i];
-            if (!imp) continue;
+        for (size_t i = 0; i < model->element_count && ok; i++) {
+            SysmlNode *node = model->elements[i];
+            if (node && node->id && !sysml2_id_set_contains(&visited, node->id) &&
+                sysml2_query_matcher_matches_node(matcher, node)) {
+                ok = sysml2_id_set_add(&visited, node->id, arena) && id_list_push(&level, node->id);
+            }
+        }
+    }
 
-            /* Include import if its owner scope is in result */
-            if (imp->owner_scope && sysml2_query_result_contains(result, imp->owner_scope)) {
-                add_import(result, imp, arena);
+    for (size_t d = 0; ok && level.count > 0 && (depth == 0 || d < depth); d++) {
+        next.count = 0;
+        for (size_t i = 0; i < level.count && ok; i++) {
+            for (const Sysml2RefEdge *e = sysml2_ref_index_users(index, level.ids[i]);
+                 e && ok; e = e->next) {
+                SysmlNode *user = e->user;
+                if (!sysml2_query_result_contains(result, user->id)) {
+                    ok = add_element(result, user, arena);
+                }
+                if (ok && !sysml2_id_set_contains(&visited, user->id)) {
+                    ok = sysml2_id_set_add(&visited, user->id, arena) && id_list_push(&next, user->id);
+                }
             }
         }
+
+        IdList swap = level;
+        level = next;
+        next = swap;
     }
 
+    free((void *)level.ids);
+    free((void *)next.ids);
+    if (!ok) return NULL;
+
+    collect_links(result, models, model_count, arena);
     return result;
 }
 
@@ -313,13 +760,7 @@ bool sysml2_query_result_contains(const Sysml2QueryResult *result, const char *e
         return false;
     }
 
-    for (size_t i = 0; i < result->element_id_count; i++) {
-        if (strcmp(result->element_ids[i], element_id) == 0) {
-            return true;
-        }
-    }
-
-    return false;
+    return sysml2_id_set_contains(&result->element_id_set, element_id);
 }
 
 /*
@@ -363,6 +804,26 @@ const char *sysml2_query_parent_path(const char *element_id, Sysml2Arena *arena)
 /*
  * Get ancestors needed for valid SysML output (parent stubs)
  */
+/*
+ * Step from id to its parent's ID
+ *
+ * *at is the node id belongs to while it is known: its linked parent or
+ * parent_id is used then, and the ID is split only past the nodes.
+ */
+static const char *ancestor_step(const SysmlNode **at, const char *id, Sysml2Arena *arena) {
+    const SysmlNode *node = *at;
+    *at = NULL;
+    if (node && node->parent) {
+        *at = node->parent;
+        return node->parent->id;
+    }
+    if (node && node->has_path && node->parent_id &&
+        node->name_offset == strlen(node->parent_id) + 2) {
+        return node->parent_id;
+    }
+    return sysml2_query_parent_path(id, arena);
+}
+
 void sysml2_query_get_ancestors(
     const Sysml2QueryResult *result,
     SysmlSemanticModel **models,
@@ -387,24 +848,18 @@ void sysml2_query_get_ancestors(
         return;
     }
 
-    /* Helper to check if ID is in ancestors array */
-    #define IN_ANCESTORS(id) ({ \
-        bool found = false; \
-        for (size_t i = 0; i < count; i++) { \
-            if (strcmp(ancestors[i], id) == 0) { found = true; break; } \
-        } \
-        found; \
-    })
+    /* IDs whose chain up to the root has been walked already */
+    Sysml2IdSet walked = {0};
 
     /* For each element in result, trace up to root */
     for (size_t i = 0; i < result->element_count; i++) {
-        const char *elem_id = result->elements[i]->id;
+        const SysmlNode *at = result->elements[i];
+        const char *parent_id = ancestor_step(&at, at->id, arena);
+        while (parent_id && !sysml2_id_set_contains(&walked, parent_id)) {
+            if (!sysml2_id_set_add(&walked, parent_id, arena)) break;
 
-        /* Walk up the parent chain */
-        const char *parent_id = sysml2_query_parent_path(elem_id, arena);
-        while (parent_id) {
-            /* Skip if this ancestor is already in result or ancestors list */
-            if (!sysml2_query_result_contains(result, parent_id) && !IN_ANCESTORS(parent_id)) {
+            /* Skip if this ancestor is already in result */
+            if (!sysml2_query_result_contains(result, parent_id)) {
                 /* Grow capacity if needed */
                 if (count >= capacity) {
                     size_t new_cap = capacity * 2;
@@ -417,12 +872,10 @@ void sysml2_query_get_ancestors(
                 ancestors[count++] = parent_id;
             }
 
-            parent_id = sysml2_query_parent_path(parent_id, arena);
+            parent_id = ancestor_step(&at, parent_id, arena);
         }
     }
 
-    #undef IN_ANCESTORS
-
     *out_ancestors = ancestors;
     *out_count = count;
 }
@@ -0,0 +1,1219 @@
+/*
+ * SysML v2 Parser - Workspace Server Implementation
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "sysml2/server.h"
+#include "sysml2/validator.h"
+#include "sysml2/query.h"
+#include "sysml2/utils.h"
+#include "sysml2/memory_budget.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/types.h>
+
+/* JSON-RPC 2.0 error codes */
+#define RPC_PARSE_ERROR      (-32700)
+#define RPC_INVALID_REQUEST  (-32600)
+#define RPC_METHOD_NOT_FOUND (-32601)
+#define RPC_INVALID_PARAMS   (-32602)
+
+/* Nesting limit for request documents */
+#define JSON_MAX_DEPTH 64
+
+/* ========== Request Parsing ========== */
+
+typedef enum {
+    JSON_NULL,
+    JSON_BOOL,
+    JSON_NUMBER,
+    JSON_STRING,
+    JSON_ARRAY,
+    JSON_OBJECT
+} JsonType;
+
+/* Parsed JSON value; everything lives in the request arena */
+typedef struct JsonValue {
+    JsonType type;
+    const char *raw;            /* Source text of the value */
+    size_t raw_length;
+    const char *string;         /* JSON_STRING: decoded, NUL-terminated */
+    size_t string_length;
+    const char **keys;          /* JSON_OBJECT: member names */
+    struct JsonValue **items;   /* JSON_ARRAY elements / JSON_OBJECT values */
+    size_t count;
+} JsonValue;
+
+typedef struct {
+    const char *p;
+    const char *end;
+    Sysml2Arena *arena;
+    int depth;
+} JsonReader;
+
+static JsonValue *json_parse_value(JsonReader *r);
+
+static void json_skip_ws(JsonReader *r) {
+    while (r->p < r->end &&
+           (*r->p == ' ' || *r->p == '\t' || *r->p == '\n' || *r->p == '\r')) {
+        r->p++;
+    }
+}
+
+static int json_hex_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/* Read the four hex digits of a \u escape at p */
+static bool json_read_hex4(const char *p, const char *end, uint32_t *out) {
+    if (end - p < 4) return false;
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+        int digit = json_hex_digit(p[i]);
+        if (digit < 0) return false;
+        value = (value << 4) | (uint32_t)digit;
+    }
+    *out = value;
+    return true;
+}
+
+static size_t json_put_utf8(char *out, uint32_t cp) {
+    if (cp < 0x80) {
+        out[0] = (char)cp;
+        return 1;
+    }
+    if (cp < 0x800) {
+        out[0] = (char)(0xC0 | (cp >> 6));
+        out[1] = (char)(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        out[0] = (char)(0xE0 | (cp >> 12));
+        out[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    out[0] = (char)(0xF0 | (cp >> 18));
+    out[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = (char)(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+/* Parse a string literal at r->p (the opening quote) */
+static bool json_parse_string(JsonReader *r, const char **out, size_t *out_length) {
+    const char *start = ++r->p;
+
+    /* Find the closing quote first; the decoded text is never longer */
+    const char *q = start;
+    while (q < r->end && *q != '"') {
+        if (*q == '\\') {
+            q += 2;
+        } else {
+            if ((unsigned char)*q < 0x20) return false;
+            q++;
+        }
+    }
+    if (q >= r->end) return false;
+
+    char *buf = sysml2_arena_alloc(r->arena, (size_t)(q - start) + 1);
+    if (!buf) return false;
+
+    size_t n = 0;
+    const char *p = start;
+    while (p < q) {
+        if (*p != '\\') {
+            buf[n++] = *p++;
+            continue;
+        }
+        p++;
+        switch (*p++) {
+            case '"':  buf[n++] = '"'; break;
+            case '\\': buf[n++] = '\\'; break;
+            case '/':  buf[n++] = '/'; break;
+            case 'b':  buf[n++] = '\b'; break;
+            case 'f':  buf[n++] = '\f'; break;
+            case 'n':  buf[n++] = '\n'; break;
+            case 'r':  buf[n++] = '\r'; break;
+            case 't':  buf[n++] = '\t'; break;
+            case 'u': {
+                uint32_t cp;
+                if (!json_read_hex4(p, q, &cp)) return false;
+                p += 4;
+                if (cp >= 0xD800 && cp <= 0xDBFF) {
+                    /* Surrogate pair; a lone half becomes U+FFFD */
+                    uint32_t low;
+                    if (q - p >= 6 && p[0] == '\\' && p[1] == 'u' &&
+                        json_read_hex4(p + 2, q, &low) && low >= 0xDC00 && low <= 0xDFFF) {
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                        p += 6;
+                    } else {
+                        cp = 0xFFFD;
+                    }
+                } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                    cp = 0xFFFD;
+                }
+                /* Escapes are six bytes, so UTF-8 output always fits */
+                n += json_put_utf8(buf + n, cp);
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    buf[n] = '\0';
+
+    r->p = q + 1;
+    *out = buf;
+    *out_length = n;
+    return true;
+}
+
+/* Append to an arena array that doubles when full */
+static bool json_push(JsonReader *r, void ***items, size_t *count, size_t *capacity, void *item) {
+    if (*count >= *capacity) {
+        size_t new_capacity = *capacity ? *capacity * 2 : 4;
+        void **grown = sysml2_arena_alloc(r->arena, new_capacity * sizeof(void *));
+        if (!grown) return false;
+        if (*count) memcpy(grown, *items, *count * sizeof(void *));
+        *items = grown;
+        *capacity = new_capacity;
+    }
+    (*items)[(*count)++] = item;
+    return true;
+}
+
+static bool json_parse_members(JsonReader *r, JsonValue *value, bool object) {
+    char close = object ? '}' : ']';
+    size_t capacity = 0, key_capacity = 0, key_count = 0;
+
+    r->p++;
+    json_skip_ws(r);
+    if (r->p < r->end && *r->p == close) {
+        r->p++;
+        return true;
+    }
+
+    for (;;) {
+        json_skip_ws(r);
+        if (object) {
+            const char *key;
+            size_t key_length;
+            if (r->p >= r->end || *r->p != '"' || !json_parse_string(r, &key, &key_length)) {
+                return false;
+            }
+            if (!json_push(r, (void ***)&value->keys, &key_count, &key_capacity, (void *)key)) {
+                return false;
+            }
+            json_skip_ws(r);
+            if (r->p >= r->end || *r->p != ':') return false;
+            r->p++;
+        }
+
+        JsonValue *item = json_parse_value(r);
+        if (!item) return false;
+        if (!json_push(r, (void ***)&value->items, &value->count, &capacity, item)) {
+            return false;
+        }
+
+        json_skip_ws(r);
+        if (r->p >= r->end) return false;
+        if (*r->p == ',') {
+            r->p++;
+            continue;
+        }
+        if (*r->p != close) return false;
+        r->p++;
+        return true;
+    }
+}
+
+static bool json_match_literal(JsonReader *r, const char *literal) {
+    size_t length = strlen(literal);
+    if ((size_t)(r->end - r->p) < length || memcmp(r->p, literal, length) != 0) {
+        return false;
+    }
+    r->p += length;
+    return true;
+}
+
+static JsonValue *json_parse_value(JsonReader *r) {
+    json_skip_ws(r);
+    if (r->p >= r->end || r->depth >= JSON_MAX_DEPTH) return NULL;
+
+    JsonValue *value = sysml2_arena_calloc(r->arena, 1, sizeof(JsonValue));
+    if (!value) return NULL;
+    value->raw = r->p;
+
+    bool ok;
+    char c = *r->p;
+    if (c == '"') {
+        value->type = JSON_STRING;
+        ok = json_parse_string(r, &value->string, &value->string_length);
+    } else if (c == '{' || c == '[') {
+        value->type = c == '{' ? JSON_OBJECT : JSON_ARRAY;
+        r->depth++;
+        ok = json_parse_members(r, value, c == '{');
+        r->depth--;
+    } else if (c == 't' || c == 'f') {
+        value->type = JSON_BOOL;
+        ok = json_match_literal(r, c == 't' ? "true" : "false");
+    } else if (c == 'n') {
+        value->type = JSON_NULL;
+        ok = json_match_literal(r, "null");
+    } else {
+        value->type = JSON_NUMBER;
+        const char *start = r->p;
+        while (r->p < r->end && *r->p && strchr("+-.0123456789eE", *r->p)) r->p++;
+        ok = r->p > start;
+    }
+    if (!ok) return NULL;
+
+    value->raw_length = (size_t)(r->p - value->raw);
+    return value;
+}
+
+/* Parse one request line; NULL if it is not a single JSON value */
+static JsonValue *json_parse_document(const char *text, size_t length, Sysml2Arena *arena) {
+    JsonReader r = { .p = text, .end = text + length, .arena = arena, .depth = 0 };
+    JsonValue *value = json_parse_value(&r);
+    json_skip_ws(&r);
+    return value && r.p == r.end ? value : NULL;
+}
+
+static const JsonValue *json_get(const JsonValue *object, const char *key) {
+    if (!object || object->type != JSON_OBJECT) return NULL;
+    for (size_t i = 0; i < object->count; i++) {
+        if (strcmp(object->keys[i], key) == 0) return object->items[i];
+    }
+    return NULL;
+}
+
+/* ========== Response Writing ========== */
+
+static void write_json_string(FILE *out, const char *str) {
+    fputc('"', out);
+    for (const char *p = str ? str : ""; *p; p++) {
+        char c = *p;
+        switch (c) {
+            case '"':  fputs("\\\"", out); break;
+            case '\\': fputs("\\\\", out); break;
+            case '\n': fputs("\\n", out); break;
+            case '\r': fputs("\\r", out); break;
+            case '\t': fputs("\\t", out); break;
+            case '\f': fputs("\\f", out); break;
+            case '\b': fputs("\\b", out); break;
+            default:
+                if ((unsigned char)c < 0x20) {
+                    fprintf(out, "\\u%04x", (unsigned char)c);
+                } else {
+                    fputc(c, out);
+                }
+                break;
+        }
+    }
+    fputc('"', out);
+}
+
+/* Requests without an id are notifications and get no response */
+static void rpc_write_id(FILE *out, const JsonValue *id) {
+    if (id) {
+        fwrite(id->raw, 1, id->raw_length, out);
+    } else {
+        fputs("null", out);
+    }
+}
+
+static void rpc_reply(FILE *out, const JsonValue *id, const char *result) {
+    fputs("{\"jsonrpc\":\"2.0\",\"id\":", out);
+    rpc_write_id(out, id);
+    fprintf(out, ",\"result\":%s}\n", result);
+    fflush(out);
+}
+
+static void rpc_error(FILE *out, const JsonValue *id, int code, const char *message) {
+    fputs("{\"jsonrpc\":\"2.0\",\"id\":", out);
+    rpc_write_id(out, id);
+    fprintf(out, ",\"error\":{\"code\":%d,\"message\":", code);
+    write_json_string(out, message);
+    fputs("}}\n", out);
+    fflush(out);
+}
+
+/* ========== Workspace State ========== */
+
+/* A file named by the client */
+typedef struct {
+    char *path;                 /* Absolute path (owned) */
+    SysmlSemanticModel *model;  /* Model of the last successful parse, NULL if none */
+    Sysml2Arena *arena;         /* Holds model and nothing else (owned) */
+    char *content;              /* Source text model points into (owned) */
+    char *syntax;               /* Parser output of a failed parse (owned), NULL if clean */
+    char *diagnostics;          /* Last validation results as a JSON array (owned) */
+    bool reported;              /* Scratch: part of the current response */
+    bool affected;              /* Scratch: re-validated by the current request */
+} ServerFile;
+
+typedef struct {
+    Sysml2PipelineContext *ctx;
+    ServerFile *files;
+    size_t file_count;
+    size_t file_capacity;
+    size_t reparsed;            /* Files parsed by the current request */
+    size_t validated;           /* Files validated by the current request */
+} Server;
+
+static char *server_absolute_path(const char *path) {
+    char *abs = sysml2_get_realpath(path);
+    return abs ? abs : strdup(path);
+}
+
+static ServerFile *server_find_file(Server *server, const char *abs_path) {
+    for (size_t i = 0; i < server->file_count; i++) {
+        if (strcmp(server->files[i].path, abs_path) == 0) return &server->files[i];
+    }
+    return NULL;
+}
+
+/* Find or add a workspace file; takes ownership of abs_path */
+static ServerFile *server_add_file(Server *server, char *abs_path) {
+    ServerFile *file = server_find_file(server, abs_path);
+    if (file) {
+        free(abs_path);
+        return file;
+    }
+
+    if (server->file_count >= server->file_capacity) {
+        size_t new_capacity = server->file_capacity ? server->file_capacity * 2 : 16;
+        ServerFile *grown = realloc(server->files, new_capacity * sizeof(ServerFile));
+        if (!grown) {
+            free(abs_path);
+            return NULL;
+        }
+        server->files = grown;
+        server->file_capacity = new_capacity;
+    }
+
+    file = &server->files[server->file_count++];
+    memset(file, 0, sizeof(*file));
+    file->path = abs_path;
+    return file;
+}
+
+/* Free a file's model, its arena and its source text */
+static void server_release_model(ServerFile *file) {
+    if (file->model && file->model->source_file) {
+        /* Built lazily for diagnostics that quote the source */
+        free((void *)file->model->source_file->line_offsets);
+    }
+    if (file->arena) {
+        sysml2_arena_destroy(file->arena);
+        free(file->arena);
+    }
+    free(file->content);
+    file->model = NULL;
+    file->arena = NULL;
+    file->content = NULL;
+}
+
+static void server_destroy(Server *server) {
+    for (size_t i = 0; i < server->file_count; i++) {
+        server_release_model(&server->files[i]);
+        free(server->files[i].path);
+        free(server->files[i].syntax);
+        free(server->files[i].diagnostics);
+    }
+    free(server->files);
+}
+
+/* Make the file's directory searchable, as the CLI does for its inputs */
+static void server_add_directory(Server *server, const char *abs_path) {
+    Sysml2ImportResolver *resolver = server->ctx->resolver;
+    char *dir = strdup(abs_path);
+    if (!dir) return;
+
+    /* Paths are absolute, so there is always a slash */
+    char *last_slash = strrchr(dir, '/');
+    if (last_slash == dir) {
+        dir[1] = '\0';
+    } else if (last_slash) {
+        *last_slash = '\0';
+    }
+    sysml2_resolver_add_path(resolver, dir);
+    if (!server->ctx->options->no_resolve) {
+        sysml2_resolver_discover_packages(resolver, dir, server->ctx->diag);
+    }
+    free(dir);
+}
+
+/* The parser always colors its output; clients get plain text */
+static void strip_ansi_escapes(char *text) {
+    char *out = text;
+    for (const char *p = text; *p; p++) {
+        if (p[0] == '\033' && p[1] == '[') {
+            p += 2;
+            while (*p && !(*p >= '@' && *p <= '~')) p++;
+            if (!*p) break;
+            continue;
+        }
+        *out++ = *p;
+    }
+    *out = '\0';
+}
+
+/*
+ * Parse a workspace file from text (or from disk when text is NULL)
+ *
+ * On success the new model replaces the old one in the resolver cache and
+ * its imports are resolved. The model is built in an arena of its own, so
+ * the old one is freed rather than left in the pipeline arena for the rest
+ * of the session. On failure the old model stays in use and the parser
+ * output is kept for the response.
+ */
+static bool server_parse(Server *server, ServerFile *file, const char *text, size_t text_length) {
+    Sysml2PipelineContext *ctx = server->ctx;
+    server->reparsed++;
+    file->reported = true;
+    free(file->syntax);
+    file->syntax = NULL;
+
+    char *content;
+    size_t content_length;
+    if (text) {
+        content = malloc(text_length + 1);
+        if (content) {
+            memcpy(content, text, text_length);
+            content[text_length] = '\0';
+        }
+        content_length = text_length;
+    } else {
+        content = sysml2_read_file(file->path, &content_length);
+    }
+    if (!content) {
+        char *message = NULL;
+        size_t message_length = 0;
+        FILE *msg = open_memstream(&message, &message_length);
+        if (msg) {
+            fprintf(msg, "error: cannot read file '%s': %s\n", file->path, strerror(errno));
+            fclose(msg);
+        }
+        file->syntax = message ? message : strdup("error: cannot read file\n");
+        return false;
+    }
+
+    Sysml2Arena *arena = malloc(sizeof(Sysml2Arena));
+    if (!arena) {
+        free(content);
+        file->syntax = strdup("error: out of memory\n");
+        return false;
+    }
+    sysml2_arena_init(arena);
+
+    char *messages = NULL;
+    size_t messages_length = 0;
+    FILE *msg = open_memstream(&messages, &messages_length);
+    ctx->err_out = msg;
+
+    /* Only the model goes to its arena; strings are interned as usual */
+    Sysml2Arena *shared_arena = ctx->arena;
+    ctx->arena = arena;
+    SysmlSemanticModel *model = NULL;
+    Sysml2Result result = sysml2_pipeline_process_input(ctx, file->path, content,
+                                                        content_length, &model);
+    ctx->arena = shared_arena;
+    ctx->err_out = NULL;
+    if (msg) fclose(msg);
+
+    if (result != SYSML2_OK || !model) {
+        /* The model (if any) is dropped, so nothing references content */
+        sysml2_arena_destroy(arena);
+        free(arena);
+        free(content);
+        if (!messages || messages_length == 0) {
+            free(messages);
+            messages = strdup("error: parse failed\n");
+        }
+        if (messages) strip_ansi_escapes(messages);
+        file->syntax = messages;
+        return false;
+    }
+    free(messages);
+
+    /* Nothing outside the file refers to the model it replaces */
+    server_release_model(file);
+    file->model = model;
+    file->arena = arena;
+    file->content = content;
+    sysml2_resolver_cache_model(ctx->resolver, file->path, model);
+    if (!ctx->options->no_resolve) {
+        sysml2_resolver_resolve_imports(ctx->resolver, model, ctx->diag);
+    }
+    return true;
+}
+
+/* ========== Dependency Tracking ========== */
+
+static bool model_has_library_root(const SysmlSemanticModel *model) {
+    for (size_t i = 0; i < model->element_count; i++) {
+        const SysmlNode *node = model->elements[i];
+        if (node && !node->parent_id && node->kind == SYSML_KIND_LIBRARY_PACKAGE) return true;
+    }
+    return false;
+}
+
+static void add_root_names(Sysml2IdSet *names, const SysmlSemanticModel *model, Sysml2Arena *arena) {
+    if (!model) return;
+    for (size_t i = 0; i < model->element_count; i++) {
+        const SysmlNode *node = model->elements[i];
+        if (node && !node->parent_id && node->name) {
+            sysml2_id_set_add(names, node->name, arena);
+        }
+    }
+}
+
+/* Check the first segment of a qualified reference against the name set */
+static bool ref_mentions(const Sysml2Intern *intern, const Sysml2IdSet *names, const char *ref) {
+    if (!ref) return false;
+
+    size_t length = 0;
+    while (ref[length] && ref[length] != '.' &&
+           !(ref[length] == ':' && ref[length + 1] == ':')) {
+        length++;
+    }
+    /* Names never seen by the interner cannot be root names */
+    const char *segment = sysml2_intern_lookup_sv(intern, sysml2_sv_from_parts(ref, length));
+    return segment && sysml2_id_set_contains(names, segment);
+}
+
+static bool refs_mention(
+    const Sysml2Intern *intern,
+    const Sysml2IdSet *names,
+    const char **refs,
+    size_t count
+) {
+    for (size_t i = 0; i < count; i++) {
+        if (ref_mentions(intern, names, refs[i])) return true;
+    }
+    return false;
+}
+
+static bool model_mentions(const Sysml2Intern *intern, const Sysml2IdSet *names,
+                           const SysmlSemanticModel *model) {
+    for (size_t i = 0; i < model->element_count; i++) {
+        const SysmlNode *node = model->elements[i];
+        if (!node) continue;
+        if ((!node->parent_id && node->name && sysml2_id_set_contains(names, node->name)) ||
+            refs_mention(intern, names, node->typed_by, node->typed_by_count) ||
+            refs_mention(intern, names, node->specializes, node->specializes_count) ||
+            refs_mention(intern, names, node->redefines, node->redefines_count) ||
+            refs_mention(intern, names, node->references, node->references_count)) {
+            return true;
+        }
+    }
+    for (size_t i = 0; i < model->import_count; i++) {
+        if (ref_mentions(intern, names, model->imports[i]->target)) return true;
+    }
+    for (size_t i = 0; i < model->relationship_count; i++) {
+        if (ref_mentions(intern, names, model->relationships[i]->target)) return true;
+    }
+    return false;
+}
+
+/*
+ * Mark every workspace file that may depend on the given root names,
+ * transitively: a newly marked file's own roots join the set
+ */
+static void server_mark_dependents(Server *server, Sysml2IdSet *names, Sysml2Arena *arena) {
+    const Sysml2Intern *intern = server->ctx->intern;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 0; i < server->file_count; i++) {
+            ServerFile *file = &server->files[i];
+            if (file->affected || file->syntax || !file->model) continue;
+            if (model_mentions(intern, names, file->model)) {
+                file->affected = true;
+                add_root_names(names, file->model, arena);
+                changed = true;
+            }
+        }
+    }
+}
+
+/* ========== Validation ========== */
+
+static void write_diagnostic(FILE *out, const Sysml2Diagnostic *diag) {
+    fprintf(out, "{\"severity\":\"%s\",\"code\":\"%s\",\"line\":%u,\"column\":%u,\"message\":",
+            sysml2_severity_to_string(diag->severity), sysml2_diag_code_to_string(diag->code),
+            diag->range.start.line, diag->range.start.column);
+    write_json_string(out, diag->message);
+    if (diag->help) {
+        fputs(",\"help\":", out);
+        write_json_string(out, diag->help);
+    }
+    if (diag->notes) {
+        fputs(",\"notes\":[", out);
+        for (const Sysml2Diagnostic *note = diag->notes; note; note = note->next) {
+            if (note != diag->notes) fputc(',', out);
+            write_json_string(out, note->message);
+        }
+        fputc(']', out);
+    }
+    fputc('}', out);
+}
+
+/* Validate the affected files and store their diagnostics */
+static void server_validate(Server *server) {
+    Sysml2PipelineContext *ctx = server->ctx;
+
+    size_t affected = 0;
+    for (size_t i = 0; i < server->file_count; i++) {
+        ServerFile *file = &server->files[i];
+        if (file->affected) {
+            affected++;
+            file->reported = true;
+        }
+    }
+    if (affected == 0 || ctx->options->parse_only) return;
+
+    size_t model_count = 0;
+    SysmlSemanticModel **models = sysml2_resolver_get_all_models(ctx->resolver, &model_count);
+    if (!models || model_count == 0) {
+        free(models);
+        return;
+    }
+
+    bool *check = calloc(model_count, sizeof(bool));
+    ServerFile **owners = calloc(model_count, sizeof(ServerFile *));
+    FILE **streams = calloc(server->file_count, sizeof(FILE *));
+    char **buffers = calloc(server->file_count, sizeof(char *));
+    size_t *buffer_lengths = calloc(server->file_count, sizeof(size_t));
+    if (!check || !owners || !streams || !buffers || !buffer_lengths) {
+        free(check);
+        free(owners);
+        free(streams);
+        free(buffers);
+        free(buffer_lengths);
+        free(models);
+        return;
+    }
+
+    for (size_t m = 0; m < model_count; m++) {
+        for (size_t i = 0; i < server->file_count; i++) {
+            if (server->files[i].affected && server->files[i].model == models[m]) {
+                check[m] = true;
+                owners[m] = &server->files[i];
+                break;
+            }
+        }
+    }
+
+    /* Validation results only live until they are rendered */
+    Sysml2Arena arena;
+    sysml2_arena_init(&arena);
+    Sysml2DiagContext diag;
+    sysml2_diag_context_init(&diag, &arena);
+    sysml2_diag_set_max_errors(&diag, 0);
+    diag.treat_warnings_as_errors = ctx->options->treat_warnings_as_errors;
+
+    Sysml2ValidationOptions val_opts = SYSML_VALIDATION_OPTIONS_DEFAULT;
+    val_opts.jobs = ctx->options->jobs;
+    val_opts.layer = sysml2_pipeline_library_layer(ctx);
+    sysml2_validate_subset(models, model_count, check, &diag, &arena, ctx->intern, &val_opts);
+
+    /* Diagnostics arrive grouped by file, so remember the last owner */
+    const Sysml2SourceFile *last_source = NULL;
+    ServerFile *last_owner = NULL;
+    for (const Sysml2Diagnostic *d = diag.first; d; d = d->next) {
+        if (!d->file) continue;
+        if (d->file != last_source) {
+            last_source = d->file;
+            last_owner = NULL;
+            for (size_t m = 0; m < model_count; m++) {
+                if (owners[m] && models[m]->source_file == d->file) {
+                    last_owner = owners[m];
+                    break;
+                }
+            }
+        }
+        /* Libraries pulled in by imports are not reported */
+        if (!last_owner) continue;
+
+        size_t index = (size_t)(last_owner - server->files);
+        if (!streams[index]) {
+            streams[index] = open_memstream(&buffers[index], &buffer_lengths[index]);
+            if (!streams[index]) continue;
+            fputc('[', streams[index]);
+        } else {
+            fputc(',', streams[index]);
+        }
+        write_diagnostic(streams[index], d);
+    }
+
+    for (size_t i = 0; i < server->file_count; i++) {
+        ServerFile *file = &server->files[i];
+        if (!file->affected) continue;
+        free(file->diagnostics);
+        file->diagnostics = NULL;
+        if (streams[i]) {
+            fputc(']', streams[i]);
+            fclose(streams[i]);
+            file->diagnostics = buffers[i];
+        }
+        server->validated++;
+    }
+
+    sysml2_arena_destroy(&arena);
+    free(buffer_lengths);
+    free(buffers);
+    free(streams);
+    free(owners);
+    free(check);
+    free(models);
+}
+
+/* ========== Requests ========== */
+
+static void write_file_result(FILE *out, const ServerFile *file) {
+    fputs("{\"path\":", out);
+    write_json_string(out, file->path);
+    fputs(",\"syntax\":", out);
+    if (file->syntax) {
+        write_json_string(out, file->syntax);
+    } else {
+        fputs("null", out);
+    }
+    fprintf(out, ",\"diagnostics\":%s}", file->diagnostics ? file->diagnostics : "[]");
+}
+
+/* Render the reported files into a malloc'd result object */
+static char *server_render_result(Server *server, bool counts) {
+    char *result = NULL;
+    size_t result_length = 0;
+    FILE *out = open_memstream(&result, &result_length);
+    if (!out) return NULL;
+
+    fputc('{', out);
+    if (counts) {
+        fprintf(out, "\"reparsed\":%zu,\"validated\":%zu,", server->reparsed, server->validated);
+    }
+    fputs("\"files\":[", out);
+    bool first = true;
+    for (size_t i = 0; i < server->file_count; i++) {
+        if (!server->files[i].reported) continue;
+        if (!first) fputc(',', out);
+        first = false;
+        write_file_result(out, &server->files[i]);
+    }
+    fputs("]}", out);
+    fclose(out);
+    return result;
+}
+
+/*
+ * Re-parse the given files, then validate them and their dependents
+ *
+ * @return false if a path could not be added to the workspace
+ */
+static bool server_update(
+    Server *server,
+    const JsonValue **paths,
+    const JsonValue **texts,
+    size_t count,
+    Sysml2Arena *arena
+) {
+    Sysml2IdSet names = {0};
+    bool everything = false;
+
+    for (size_t i = 0; i < count; i++) {
+        ServerFile *file = server_add_file(server, server_absolute_path(paths[i]->string));
+        if (!file) return false;
+        server_add_directory(server, file->path);
+
+        /* A successful parse frees the old model, so take its roots
+         * first (root names are interned and outlive it) */
+        Sysml2IdSet old_names = {0};
+        add_root_names(&old_names, file->model, arena);
+        bool old_library = file->model && model_has_library_root(file->model);
+
+        const JsonValue *text = texts ? texts[i] : NULL;
+        if (!server_parse(server, file, text ? text->string : NULL,
+                          text ? text->string_length : 0)) {
+            /* Dependents keep seeing the previous version */
+            continue;
+        }
+
+        file->affected = true;
+        for (size_t j = 0; j < old_names.capacity; j++) {
+            if (old_names.slots[j].id) sysml2_id_set_add(&names, old_names.slots[j].id, arena);
+        }
+        add_root_names(&names, file->model, arena);
+        if (old_library || model_has_library_root(file->model)) {
+            everything = true;
+        }
+    }
+
+    if (everything) {
+        for (size_t i = 0; i < server->file_count; i++) {
+            ServerFile *file = &server->files[i];
+            if (file->model && !file->syntax) file->affected = true;
+        }
+    } else if (names.count > 0) {
+        server_mark_dependents(server, &names, arena);
+    }
+
+    server_validate(server);
+    return true;
+}
+
+static void server_handle_load(Server *server, const JsonValue *id, const JsonValue *params,
+                               FILE *out, Sysml2Arena *arena) {
+    const JsonValue *files = json_get(params, "files");
+    if (!files || files->type != JSON_ARRAY) {
+        rpc_error(out, id, RPC_INVALID_PARAMS, "load expects {\"files\": [path, ...]}");
+        return;
+    }
+    for (size_t i = 0; i < files->count; i++) {
+        if (files->items[i]->type != JSON_STRING) {
+            rpc_error(out, id, RPC_INVALID_PARAMS, "file paths must be strings");
+            return;
+        }
+    }
+
+    if (!server_update(server, (const JsonValue **)files->items, NULL, files->count, arena)) {
+        rpc_error(out, id, RPC_INVALID_REQUEST, "out of memory");
+        return;
+    }
+    char *result = server_render_result(server, true);
+    if (id) rpc_reply(out, id, result ? result : "null");
+    free(result);
+}
+
+static void server_handle_change(Server *server, const JsonValue *id, const JsonValue *params,
+                                 FILE *out, Sysml2Arena *arena) {
+    const JsonValue *path = json_get(params, "path");
+    const JsonValue *text = json_get(params, "text");
+    if (!path || path->type != JSON_STRING ||
+        (text && text->type != JSON_STRING && text->type != JSON_NULL)) {
+        rpc_error(out, id, RPC_INVALID_PARAMS,
+                  "change expects {\"path\": path, \"text\"?: string}");
+        return;
+    }
+    if (text && text->type == JSON_NULL) text = NULL;
+
+    if (!server_update(server, &path, &text, 1, arena)) {
+        rpc_error(out, id, RPC_INVALID_REQUEST, "out of memory");
+        return;
+    }
+    char *result = server_render_result(server, true);
+    if (id) rpc_reply(out, id, result ? result : "null");
+    free(result);
+}
+
+static void server_handle_diagnostics(Server *server, const JsonValue *id,
+                                      const JsonValue *params, FILE *out) {
+    const JsonValue *path = json_get(params, "path");
+    if (path && path->type != JSON_STRING) {
+        rpc_error(out, id, RPC_INVALID_PARAMS, "path must be a string");
+        return;
+    }
+
+    if (path) {
+        char *abs_path = server_absolute_path(path->string);
+        ServerFile *file = abs_path ? server_find_file(server, abs_path) : NULL;
+        free(abs_path);
+        if (!file) {
+            rpc_error(out, id, RPC_INVALID_PARAMS, "file is not loaded");
+            return;
+        }
+        file->reported = true;
+    } else {
+        for (size_t i = 0; i < server->file_count; i++) {
+            server->files[i].reported = true;
+        }
+    }
+
+    char *result = server_render_result(server, false);
+    if (id) rpc_reply(out, id, result ? result : "null");
+    free(result);
+}
+
+/* Handle one request line; returns false after shutdown */
+static bool server_handle_line(Server *server, const char *line, size_t length, FILE *out) {
+    /* Blank lines are keep-alives */
+    size_t start = 0;
+    while (start < length && line[start] && strchr(" \t\r\n", line[start])) start++;
+    if (start == length) return true;
+
+    Sysml2Arena arena;
+    sysml2_arena_init(&arena);
+
+    bool running = true;
+    JsonValue *request = json_parse_document(line, length, &arena);
+    if (!request) {
+        rpc_error(out, NULL, RPC_PARSE_ERROR, "parse error");
+        sysml2_arena_destroy(&arena);
+        return true;
+    }
+
+    const JsonValue *id = json_get(request, "id");
+    const JsonValue *method = json_get(request, "method");
+    const JsonValue *params = json_get(request, "params");
+    if (!method || method->type != JSON_STRING) {
+        rpc_error(out, id, RPC_INVALID_REQUEST, "request has no method");
+        sysml2_arena_destroy(&arena);
+        return true;
+    }
+
+    /* Every request starts from a clean diagnostic context, so the error
+     * limit and counts never carry over between requests */
+    sysml2_diag_clear(server->ctx->diag);
+    server->reparsed = 0;
+    server->validated = 0;
+    for (size_t i = 0; i < server->file_count; i++) {
+        server->files[i].reported = false;
+        server->files[i].affected = false;
+    }
+
+    const char *name = method->string;
+    if (strcmp(name, "load") == 0) {
+        server_handle_load(server, id, params, out, &arena);
+    } else if (strcmp(name, "change") == 0) {
+        server_handle_change(server, id, params, out, &arena);
+    } else if (strcmp(name, "diagnostics") == 0) {
+        server_handle_diagnostics(server, id, params, out);
+    } else if (strcmp(name, "shutdown") == 0) {
+        if (id) rpc_reply(out, id, "null");
+        running = false;
+    } else {
+        rpc_error(out, id, RPC_METHOD_NOT_FOUND, "unknown method");
+    }
+
+    sysml2_arena_destroy(&arena);
+    return running;
+}
+
+int sysml2_server_run(Sysml2PipelineContext *ctx, FILE *in, FILE *out) {
+    if (!ctx || !in || !out) return 1;
+
+    Server server = { .ctx = ctx };
+    char *line = NULL;
+    size_t line_capacity = 0;
+    ssize_t length;
+
+    while ((length = getline(&line, &line_capacity, in)) >= 0) {
+        if (!server_handle_line(&server, line, (size_t)length, out)) break;
+    }
+
+    free(line);
+    server_destroy(&server);
+    return 0;
+}
+
+/* ========== Batch Mode ========== */
+
+typedef struct {
+    Sysml2PipelineContext *ctx;
+    Sysml2ArenaMark mark;       /* Pipeline arena holding just the libraries */
+    size_t documents;           /* Documents read so far */
+    bool syntax_failed;         /* Some document did not parse (or read) */
+    bool validation_failed;     /* Some document had validation errors */
+} Batch;
+
+/* Validate one parsed document against the libraries; returns its error count */
+static size_t batch_validate(Batch *batch, SysmlSemanticModel *model, FILE *out) {
+    Sysml2PipelineContext *ctx = batch->ctx;
+    if (ctx->options->parse_only) return 0;
+
+    size_t library_count = ctx->library_model_count;
+    size_t model_count = library_count + 1;
+    SysmlSemanticModel **models = sysml2_arena_alloc(ctx->arena, model_count * sizeof(*models));
+    bool *check = SYSML2_ARENA_NEW_ARRAY(ctx->arena, bool, model_count);
+    if (!models || !check) return 0;
+    if (library_count > 0) memcpy(models, ctx->library_models, library_count * sizeof(*models));
+    models[library_count] = model;
+    check[library_count] = true;
+
+    Sysml2DiagContext diag;
+    sysml2_diag_context_init(&diag, ctx->arena);
+    sysml2_diag_set_max_errors(&diag, ctx->options->max_errors);
+    diag.treat_warnings_as_errors = ctx->options->treat_warnings_as_errors;
+
+    Sysml2ValidationOptions val_opts = SYSML_VALIDATION_OPTIONS_DEFAULT;
+    val_opts.jobs = ctx->options->jobs;
+    val_opts.stats = ctx->stats;
+    val_opts.layer = ctx->library_layer;
+    sysml2_stats_phase_start(ctx->stats, SYSML2_PHASE_VALIDATE);
+    sysml2_validate_subset(models, model_count, check, &diag, ctx->arena, ctx->intern, &val_opts);
+    sysml2_memory_report(&diag, model->source_name);
+    sysml2_stats_phase_stop(ctx->stats, SYSML2_PHASE_VALIDATE);
+
+    for (const Sysml2Diagnostic *d = diag.first; d; d = d->next) {
+        if (d != diag.first) fputc(',', out);
+        write_diagnostic(out, d);
+    }
+    return diag.error_count;
+}
+
+/*
+ * Parse and validate one document, write its result line, then drop
+ * everything it allocated; takes ownership of content
+ */
+static void batch_document(Batch *batch, const char *name, char *content, size_t length,
+                           FILE *out) {
+    Sysml2PipelineContext *ctx = batch->ctx;
+    batch->documents++;
+
+    char *syntax = NULL;
+    size_t syntax_length = 0;
+    char *diagnostics = NULL;
+    size_t diagnostics_length = 0;
+    size_t errors = 0;
+
+    if (!content) {
+        FILE *msg = open_memstream(&syntax, &syntax_length);
+        if (msg) {
+            fprintf(msg, "error: cannot read file '%s': %s\n", name, strerror(errno));
+            fclose(msg);
+        }
+    } else {
+        /* A memory limit breach is reported to the pipeline's context,
+         * whose arena is rewound below: keep it only for this document */
+        Sysml2DiagContext before = *ctx->diag;
+        FILE *msg = open_memstream(&syntax, &syntax_length);
+        ctx->err_out = msg;
+        SysmlSemanticModel *model = NULL;
+        sysml2_stats_phase_start(ctx->stats, SYSML2_PHASE_PARSE);
+        Sysml2Result result = sysml2_pipeline_process_input(ctx, name, content, length, &model);
+        sysml2_stats_phase_stop(ctx->stats, SYSML2_PHASE_PARSE);
+        ctx->err_out = NULL;
+        if (msg) fclose(msg);
+
+        if (result == SYSML2_ERROR_OUT_OF_MEMORY) {
+            free(syntax);
+            syntax = NULL;
+            FILE *diag_out = open_memstream(&diagnostics, &diagnostics_length);
+            const Sysml2Diagnostic *d = before.last ? before.last->next : ctx->diag->first;
+            for (; d && diag_out; d = d->next) {
+                if (errors++ > 0) fputc(',', diag_out);
+                write_diagnostic(diag_out, d);
+            }
+            if (diag_out) fclose(diag_out);
+        } else if (result == SYSML2_OK && model) {
+            free(syntax);
+            syntax = NULL;
+            FILE *diag_out = open_memstream(&diagnostics, &diagnostics_length);
+            if (diag_out) {
+                errors = batch_validate(batch, model, diag_out);
+                fclose(diag_out);
+            }
+        } else if (!syntax || syntax_length == 0) {
+            free(syntax);
+            syntax = strdup("error: parse failed\n");
+        }
+
+        if (before.last) before.last->next = NULL;
+        *ctx->diag = before;
+    }
+    if (syntax) {
+        strip_ansi_escapes(syntax);
+        batch->syntax_failed = true;
+    } else if (errors > 0) {
+        batch->validation_failed = true;
+    }
+
+    fputs("{\"path\":", out);
+    write_json_string(out, name);
+    fprintf(out, ",\"ok\":%s,\"syntax\":", !syntax && errors == 0 ? "true" : "false");
+    if (syntax) {
+        write_json_string(out, syntax);
+    } else {
+        fputs("null", out);
+    }
+    fprintf(out, ",\"diagnostics\":[%s]}\n", diagnostics ? diagnostics : "");
+    fflush(out);
+
+    free(diagnostics);
+    free(syntax);
+
+    /* The model, its strings and the validation state go; the content
+     * they pointed into can go after them */
+    if (ctx->intern->arena == ctx->arena && sysml2_intern_rewind(ctx->intern, batch->mark)) {
+        sysml2_arena_rewind(ctx->arena, batch->mark);
+    }
+    free(content);
+}
+
+/* Read an inline document announced by an "@<length> [name]" header */
+static bool batch_inline(Batch *batch, const char *header, FILE *in, FILE *out) {
+    char *end = NULL;
+    errno = 0;
+    unsigned long long length = strtoull(header + 1, &end, 10);
+    if (end == header + 1 || errno != 0 || (*end && *end != ' ') || length >= SIZE_MAX) {
+        fprintf(stderr, "error: invalid batch header '%s'\n", header);
+        return false;
+    }
+
+    char default_name[32];
+    const char *name = *end ? end + 1 : NULL;
+    if (!name || !*name) {
+        snprintf(default_name, sizeof(default_name), "<document %zu>", batch->documents + 1);
+        name = default_name;
+    }
+
+    char *content = malloc((size_t)length + 1);
+    if (!content) {
+        fprintf(stderr, "error: out of memory reading '%s'\n", name);
+        return false;
+    }
+    if (fread(content, 1, (size_t)length, in) != (size_t)length) {
+        fprintf(stderr, "error: truncated batch document '%s'\n", name);
+        free(content);
+        return false;
+    }
+    content[length] = '\0';
+    batch_document(batch, name, content, (size_t)length, out);
+    return true;
+}
+
+int sysml2_batch_run(Sysml2PipelineContext *ctx, FILE *in, FILE *out) {
+    if (!ctx || !in || !out) return 1;
+
+    /* Everything allocated from here on belongs to one document */
+    sysml2_pipeline_library_layer(ctx);
+    sysml2_intern_start_journal(ctx->intern);
+    Batch batch = { .ctx = ctx, .mark = sysml2_arena_mark(ctx->arena) };
+
+    char *line = NULL;
+    size_t line_capacity = 0;
+    ssize_t length;
+    bool input_ok = true;
+
+    while ((length = getline(&line, &line_capacity, in)) >= 0) {
+        while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r')) {
+            line[--length] = '\0';
+        }
+        if (length == 0) continue;
+
+        if (line[0] == '@') {
+            if (!batch_inline(&batch, line, in, out)) {
+                input_ok = false;
+                break;
+            }
+        } else {
+            size_t content_length = 0;
+            char *content = sysml2_read_file(line, &content_length);
+            batch_document(&batch, line, content, content_length, out);
+        }
+    }
+    free(line);
+
+    if (!input_ok || batch.syntax_failed) return 1;
+    return batch.validation_failed ? 2 : 0;
+}
@@ -0,0 +1,196 @@
+/*
+ * SysML v2 Parser - Run Statistics Implementation
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "sysml2/stats.h"
+#include "sysml2/memory_budget.h"
+
+#include <string.h>
+#include <time.h>
+
+static const char *const phase_names[SYSML2_PHASE_COUNT] = {
+    [SYSML2_PHASE_LIBRARIES] = "libraries",
+    [SYSML2_PHASE_PARSE]     = "parse",
+    [SYSML2_PHASE_RESOLVE]   = "resolve",
+    [SYSML2_PHASE_VALIDATE]  = "validate",
+    [SYSML2_PHASE_WRITE]     = "write",
+};
+
+static const char *const pass_names[SYSML2_PASS_COUNT] = {
+    [SYSML2_PASS_SYMTAB]         = "symtab",
+    [SYSML2_PASS_TYPES]          = "types",
+    [SYSML2_PASS_CYCLES]         = "cycles",
+    [SYSML2_PASS_MULTIPLICITIES] = "multiplicities",
+    [SYSML2_PASS_REDEFINES]      = "redefines",
+    [SYSML2_PASS_IMPORTS]        = "imports",
+    [SYSML2_PASS_ABSTRACT]       = "abstract",
+};
+
+static uint64_t clock_ns(clockid_t id) {
+    struct timespec ts;
+    if (clock_gettime(id, &ts) != 0) return 0;
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+uint64_t sysml2_stats_wall_ns(void) {
+    return clock_ns(CLOCK_MONOTONIC);
+}
+
+uint64_t sysml2_stats_thread_cpu_ns(void) {
+    return clock_ns(CLOCK_THREAD_CPUTIME_ID);
+}
+
+static uint64_t process_cpu_ns(void) {
+    return clock_ns(CLOCK_PROCESS_CPUTIME_ID);
+}
+
+static void note_arena(Sysml2Stats *stats) {
+    if (!stats->arena) return;
+    size_t used = sysml2_arena_used(stats->arena);
+    if (used > stats->arena_peak) stats->arena_peak = used;
+}
+
+void sysml2_stats_init(Sysml2Stats *stats, const Sysml2Arena *arena) {
+    memset(stats, 0, sizeof(*stats));
+    stats->arena = arena;
+    stats->start_wall_ns = sysml2_stats_wall_ns();
+    stats->start_cpu_ns = process_cpu_ns();
+    note_arena(stats);
+}
+
+void sysml2_stats_phase_start(Sysml2Stats *stats, Sysml2Phase phase) {
+    sysml2_memory_phase_push(phase_names[phase]);
+    if (!stats || stats->depth[phase]++ > 0) return;
+
+    stats->phase_wall[phase] = sysml2_stats_wall_ns();
+    stats->phase_cpu[phase] = process_cpu_ns();
+    stats->phase_arena[phase] = stats->arena ? sysml2_arena_used(stats->arena) : 0;
+    stats->phase_outer_peak[phase] = sysml2_memory_begin_peak();
+}
+
+void sysml2_stats_phase_stop(Sysml2Stats *stats, Sysml2Phase phase) {
+    sysml2_memory_phase_pop();
+    if (!stats || stats->depth[phase] == 0 || --stats->depth[phase] > 0) return;
+
+    Sysml2StatsTimer *t = &stats->phases[phase];
+    size_t peak = sysml2_memory_end_peak(stats->phase_outer_peak[phase]);
+    if (peak > t->memory_peak) t->memory_peak = peak;
+    t->wall_ns += sysml2_stats_wall_ns() - stats->phase_wall[phase];
+    t->cpu_ns += process_cpu_ns() - stats->phase_cpu[phase];
+    t->runs++;
+    if (stats->arena) {
+        /* A rewind inside the phase can leave the arena smaller */
+        size_t used = sysml2_arena_used(stats->arena);
+        if (used > stats->phase_arena[phase]) t->arena_bytes += used - stats->phase_arena[phase];
+    }
+    note_arena(stats);
+}
+
+void sysml2_stats_add_pass(Sysml2Stats *stats, Sysml2ValidatorPass pass,
+                           uint64_t wall_ns, uint64_t cpu_ns) {
+    if (!stats) return;
+    Sysml2StatsTimer *t = &stats->passes[pass];
+    t->wall_ns += wall_ns;
+    t->cpu_ns += cpu_ns;
+    t->runs++;
+}
+
+const char *sysml2_stats_phase_name(Sysml2Phase phase) {
+    return phase_names[phase];
+}
+
+const char *sysml2_stats_pass_name(Sysml2ValidatorPass pass) {
+    return pass_names[pass];
+}
+
+static double ms(uint64_t ns) {
+    return (double)ns / 1e6;
+}
+
+static double load_factor(const Sysml2StatsCounters *c) {
+    return c->intern_capacity ? (double)c->intern_count / (double)c->intern_capacity : 0.0;
+}
+
+static void print_text(const Sysml2Stats *stats, const Sysml2StatsCounters *c,
+                       uint64_t total_wall, uint64_t total_cpu, FILE *out) {
+    fprintf(out, "%-20s %10s %10s %6s %12s %12s\n",
+            "phase", "wall_ms", "cpu_ms", "runs", "arena_bytes", "peak_bytes");
+    for (int p = 0; p < SYSML2_PHASE_COUNT; p++) {
+        const Sysml2StatsTimer *t = &stats->phases[p];
+        fprintf(out, "%-20s %10.3f %10.3f %6zu %12zu %12zu\n", phase_names[p],
+                ms(t->wall_ns), ms(t->cpu_ns), t->runs, t->arena_bytes, t->memory_peak);
+
+        if (p != SYSML2_PHASE_VALIDATE) continue;
+        for (int q = 0; q < SYSML2_PASS_COUNT; q++) {
+            const Sysml2StatsTimer *pt = &stats->passes[q];
+            if (pt->runs == 0) continue;
+            fprintf(out, "  %d %-16s %10.3f %10.3f %6zu\n",
+                    q + 1, pass_names[q], ms(pt->wall_ns), ms(pt->cpu_ns), pt->runs);
+        }
+    }
+    fprintf(out, "%-20s %10.3f %10.3f\n", "total", ms(total_wall), ms(total_cpu));
+
+    fprintf(out, "files: %zu input (%zu bytes), %zu library (%zu bytes)\n",
+            c->input_files, c->input_bytes, c->library_files, c->library_bytes);
+    fprintf(out, "model cache: %zu hits, %zu misses; file cache: %zu hits, %zu files\n",
+            c->model_cache_hits, c->model_cache_misses, c->file_cache_hits, c->file_cache_count);
+    fprintf(out, "arena: %zu bytes peak\n", stats->arena_peak);
+    fprintf(out, "memory: %zu bytes peak", sysml2_memory_peak());
+    if (sysml2_memory_limit() > 0) fprintf(out, ", limit %zu", sysml2_memory_limit());
+    fprintf(out, "%s\n", sysml2_memory_exceeded() ? " (exceeded)" : "");
+    fprintf(out, "intern: %zu strings, %zu slots, load %.2f\n",
+            c->intern_count, c->intern_capacity, load_factor(c));
+    fprintf(out, "symtab: %zu symbols in %zu scopes\n", stats->symbol_count, stats->scope_count);
+}
+
+static void print_timer_json(const char *name, const Sysml2StatsTimer *t, bool arena, FILE *out) {
+    fprintf(out, "\"%s\":{\"wall_ms\":%.3f,\"cpu_ms\":%.3f,\"runs\":%zu",
+            name, ms(t->wall_ns), ms(t->cpu_ns), t->runs);
+    if (arena) fprintf(out, ",\"arena_bytes\":%zu,\"peak_bytes\":%zu", t->arena_bytes, t->memory_peak);
+    fputc('}', out);
+}
+
+static void print_json(const Sysml2Stats *stats, const Sysml2StatsCounters *c,
+                       uint64_t total_wall, uint64_t total_cpu, FILE *out) {
+    fprintf(out, "{\"wall_ms\":%.3f,\"cpu_ms\":%.3f,\"phases\":{", ms(total_wall), ms(total_cpu));
+    for (int p = 0; p < SYSML2_PHASE_COUNT; p++) {
+        if (p > 0) fputc(',', out);
+        print_timer_json(phase_names[p], &stats->phases[p], true, out);
+    }
+    fprintf(out, "},\"passes\":{");
+    for (int q = 0; q < SYSML2_PASS_COUNT; q++) {
+        if (q > 0) fputc(',', out);
+        print_timer_json(pass_names[q], &stats->passes[q], false, out);
+    }
+    fprintf(out, "},\"files\":{\"input\":%zu,\"input_bytes\":%zu,\"library\":%zu,"
+                 "\"library_bytes\":%zu,\"model_cache_hits\":%zu,\"model_cache_misses\":%zu,"
+                 "\"file_cache_hits\":%zu,\"file_cache_files\":%zu}",
+            c->input_files, c->input_bytes, c->library_files, c->library_bytes,
+            c->model_cache_hits, c->model_cache_misses, c->file_cache_hits, c->file_cache_count);
+    fprintf(out, ",\"arena_peak_bytes\":%zu", stats->arena_peak);
+    fprintf(out, ",\"memory\":{\"peak_bytes\":%zu,\"limit_bytes\":%zu,\"exceeded\":%s}",
+            sysml2_memory_peak(), sysml2_memory_limit(),
+            sysml2_memory_exceeded() ? "true" : "false");
+    fprintf(out, ",\"intern\":{\"strings\":%zu,\"slots\":%zu,\"load_factor\":%.3f}",
+            c->intern_count, c->intern_capacity, load_factor(c));
+    fprintf(out, ",\"symtab\":{\"symbols\":%zu,\"scopes\":%zu}}\n",
+            stats->symbol_count, stats->scope_count);
+}
+
+void sysml2_stats_print(const Sysml2Stats *stats, const Sysml2StatsCounters *counters,
+                        bool json, FILE *out) {
+    uint64_t total_wall = sysml2_stats_wall_ns() - stats->start_wall_ns;
+    uint64_t total_cpu = process_cpu_ns() - stats->start_cpu_ns;
+
+    /* Count what the arena holds now as well as the phase boundaries */
+    Sysml2Stats final = *stats;
+    note_arena(&final);
+
+    if (json) {
+        print_json(&final, counters, total_wall, total_cpu, out);
+    } else {
+        print_text(&final, counters, total_wall, total_cpu, out);
+    }
+}
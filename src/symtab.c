@@ -5,19 +5,21 @@
  */
 
 #include "sysml2/symtab.h"
+#include "sysml2/utils.h"
 #include <stdlib.h>
 #include <string.h>
 
 /* ========== Hash Function ========== */
 
-static uint32_t hash_string(const char *str) {
-    if (!str) return 0;
-    uint32_t hash = 5381;
-    int c;
-    while ((c = *str++)) {
-        hash = ((hash << 5) + hash) + c; /* hash * 33 + c */
-    }
-    return hash;
+static uint32_t symbol_hash(const char *name) {
+    return sysml2_hash_string(name, strlen(name));
+}
+
+/* A scope with no members; member storage is set up by the first add */
+static Sysml2Scope *new_scope(Sysml2Arena *arena, const char *id) {
+    Sysml2Scope *scope = SYSML2_ARENA_NEW(arena, Sysml2Scope);
+    if (scope) scope->id = id;
+    return scope;
 }
 
 /* ========== Symbol Table Implementation ========== */
@@ -37,16 +39,50 @@ void sysml2_symtab_init(
     memset(symtab->scopes, 0, symtab->scope_capacity * sizeof(Sysml2Scope *));
 
     /* Create root scope */
-    symtab->root_scope = sysml2_arena_alloc(arena, sizeof(Sysml2Scope));
-    symtab->root_scope->id = NULL;
-    symtab->root_scope->parent = NULL;
-    symtab->root_scope->symbol_capacity = SYSML_SYMTAB_DEFAULT_SYMBOL_CAPACITY;
-    symtab->root_scope->symbol_count = 0;
-    symtab->root_scope->symbols = sysml2_arena_alloc(arena,
-        symtab->root_scope->symbol_capacity * sizeof(Sysml2Symbol *));
-    memset(symtab->root_scope->symbols, 0,
-        symtab->root_scope->symbol_capacity * sizeof(Sysml2Symbol *));
-    symtab->root_scope->imports = NULL;
+    symtab->root_scope = new_scope(arena, NULL);
+    symtab->symbol_block = NULL;
+    symtab->symbol_block_used = 0;
+
+    symtab->resolve_cache = NULL;
+    symtab->resolve_cache_count = 0;
+    symtab->resolve_cache_capacity = 0;
+    symtab->import_visits = NULL;
+    symtab->import_visit_capacity = 0;
+    symtab->import_visit_epoch = 0;
+    symtab->base = NULL;
+    symtab->lower = NULL;
+    symtab->shadow_count = 0;
+    symtab->frozen = false;
+}
+
+void sysml2_symtab_init_overlay(
+    Sysml2SymbolTable *overlay,
+    const Sysml2SymbolTable *lower,
+    Sysml2Arena *arena,
+    Sysml2Intern *intern
+) {
+    sysml2_symtab_init(overlay, arena, intern);
+    overlay->lower = lower;
+
+    /* The overlay's root shadows the frozen root; stamps follow its scopes */
+    overlay->root_scope->lower = lower->root_scope;
+    overlay->root_scope->index = lower->scope_count + 1;
+}
+
+void sysml2_symtab_init_view(
+    Sysml2SymbolTable *view,
+    const Sysml2SymbolTable *base,
+    Sysml2Arena *arena
+) {
+    *view = *base;
+    view->arena = arena;
+    view->resolve_cache = NULL;
+    view->resolve_cache_count = 0;
+    view->resolve_cache_capacity = 0;
+    view->import_visits = NULL;
+    view->import_visit_capacity = 0;
+    view->import_visit_epoch = 0;
+    view->base = base;
 }
 
 void sysml2_symtab_destroy(Sysml2SymbolTable *symtab) {
@@ -55,25 +91,150 @@ void sysml2_symtab_destroy(Sysml2SymbolTable *symtab) {
     symtab->scope_count = 0;
     symtab->scope_capacity = 0;
     symtab->root_scope = NULL;
+    symtab->symbol_block = NULL;
+    symtab->symbol_block_used = 0;
+    symtab->resolve_cache = NULL;
+    symtab->resolve_cache_count = 0;
+    symtab->resolve_cache_capacity = 0;
+    symtab->import_visits = NULL;
+    symtab->import_visit_capacity = 0;
+    symtab->lower = NULL;
+    symtab->shadow_count = 0;
 }
 
-/* Find scope by ID in the hash table */
-static Sysml2Scope *find_scope(Sysml2SymbolTable *symtab, const char *scope_id) {
-    if (!scope_id) return symtab->root_scope;
+/* ========== Resolution Cache ========== */
 
-    uint32_t hash = hash_string(scope_id);
-    size_t idx = hash % symtab->scope_capacity;
+/* Drop all cached resolutions (symbols or imports changed) */
+static void resolve_cache_clear(Sysml2SymbolTable *symtab) {
+    if (symtab->resolve_cache_count == 0) return;
+    memset(symtab->resolve_cache, 0,
+        symtab->resolve_cache_capacity * sizeof(Sysml2ResolveCacheEntry));
+    symtab->resolve_cache_count = 0;
+}
 
-    /* Linear probing */
-    for (size_t i = 0; i < symtab->scope_capacity; i++) {
-        size_t probe = (idx + i) % symtab->scope_capacity;
-        Sysml2Scope *scope = symtab->scopes[probe];
+static uint32_t resolve_cache_hash(const Sysml2Scope *scope, const char *name) {
+    return sysml2_id_hash(scope->id) ^ sysml2_hash_string(name, strlen(name));
+}
+
+static Sysml2ResolveCacheEntry *resolve_cache_find(
+    Sysml2SymbolTable *symtab,
+    const Sysml2Scope *scope,
+    const char *name,
+    uint32_t hash
+) {
+    if (symtab->resolve_cache_capacity == 0) return NULL;
+
+    size_t mask = symtab->resolve_cache_capacity - 1;
+    for (size_t idx = hash & mask; symtab->resolve_cache[idx].name; idx = (idx + 1) & mask) {
+        Sysml2ResolveCacheEntry *entry = &symtab->resolve_cache[idx];
+        if (entry->hash == hash && entry->scope == scope &&
+            (entry->name == name || strcmp(entry->name, name) == 0)) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static void resolve_cache_insert(
+    Sysml2SymbolTable *symtab,
+    const Sysml2Scope *scope,
+    const char *name,
+    uint32_t hash,
+    Sysml2Symbol *symbol
+) {
+    /* Grow at 1/2 load (power-of-two capacity) */
+    if ((symtab->resolve_cache_count + 1) * 2 > symtab->resolve_cache_capacity) {
+        size_t new_capacity = symtab->resolve_cache_capacity
+            ? symtab->resolve_cache_capacity * 2 : 256;
+        Sysml2ResolveCacheEntry *new_cache = sysml2_arena_calloc(symtab->arena,
+            new_capacity, sizeof(Sysml2ResolveCacheEntry));
+        if (!new_cache) return;
+
+        for (size_t i = 0; i < symtab->resolve_cache_capacity; i++) {
+            Sysml2ResolveCacheEntry *entry = &symtab->resolve_cache[i];
+            if (!entry->name) continue;
+            size_t idx = entry->hash & (new_capacity - 1);
+            while (new_cache[idx].name) idx = (idx + 1) & (new_capacity - 1);
+            new_cache[idx] = *entry;
+        }
+        symtab->resolve_cache = new_cache;
+        symtab->resolve_cache_capacity = new_capacity;
+    }
+
+    size_t mask = symtab->resolve_cache_capacity - 1;
+    size_t idx = hash & mask;
+    while (symtab->resolve_cache[idx].name) idx = (idx + 1) & mask;
+
+    /* Views must not write the shared interner */
+    Sysml2ResolveCacheEntry *entry = &symtab->resolve_cache[idx];
+    entry->scope = scope;
+    entry->name = symtab->base
+        ? sysml2_arena_strdup(symtab->arena, name)
+        : sysml2_intern(symtab->intern, name);
+    if (!entry->name) return;
+    entry->hash = hash;
+    entry->symbol = symbol;
+    symtab->resolve_cache_count++;
+}
+
+/*
+ * Find scope by ID in the hash table
+ *
+ * Scope IDs are interned (see intern.h), so the table is keyed by
+ * address. A string equal to a scope ID but not interned misses here.
+ */
+static Sysml2Scope *find_own_scope(const Sysml2SymbolTable *symtab, const char *scope_id) {
+    if (!scope_id) return symtab->root_scope;
+
+    /* Linear probing; the table is never full */
+    size_t mask = symtab->scope_capacity - 1;
+    for (size_t idx = sysml2_id_hash(scope_id) & mask;; idx = (idx + 1) & mask) {
+        Sysml2Scope *scope = symtab->scopes[idx];
         if (!scope) return NULL;
-        if (scope->id && strcmp(scope->id, scope_id) == 0) {
+        if (scope->id == scope_id) {
             return scope;
         }
     }
-    return NULL;
+}
+
+/* Find scope by ID in the table, then in the frozen layer under it */
+static Sysml2Scope *find_scope(const Sysml2SymbolTable *symtab, const char *scope_id) {
+    Sysml2Scope *scope = find_own_scope(symtab, scope_id);
+    if (!scope && symtab->lower) scope = find_own_scope(symtab->lower, scope_id);
+    return scope;
+}
+
+/* A frozen-layer scope as the table sees it: its shadow if there is one */
+static const Sysml2Scope *layer_scope(const Sysml2SymbolTable *symtab, const Sysml2Scope *scope) {
+    if (!scope || !scope->frozen || !symtab->lower) return scope;
+    if (!scope->id) return symtab->root_scope;
+    if (symtab->shadow_count == 0) return scope;
+
+    Sysml2Scope *own = find_own_scope(symtab, scope->id);
+    return own ? own : scope;
+}
+
+const Sysml2Scope *sysml2_symtab_parent(
+    const Sysml2SymbolTable *symtab,
+    const Sysml2Scope *scope
+) {
+    return scope ? layer_scope(symtab, scope->parent) : NULL;
+}
+
+void sysml2_symtab_freeze(Sysml2SymbolTable *symtab) {
+    if (symtab->base || symtab->lower || symtab->frozen) return;
+
+    /* Overlays may not write import entries, so resolve their targets now */
+    for (size_t i = 0; i <= symtab->scope_capacity; i++) {
+        Sysml2Scope *scope = i < symtab->scope_capacity ? symtab->scopes[i] : symtab->root_scope;
+        if (!scope) continue;
+        scope->frozen = true;
+        for (Sysml2ImportEntry *imp = scope->imports; imp; imp = imp->next) {
+            if (!imp->target_scope) imp->target_scope = find_own_scope(symtab, imp->target);
+        }
+    }
+    resolve_cache_clear(symtab);
+    symtab->frozen = true;
 }
 
 /* Get parent scope ID by removing last "::" segment */
@@ -102,16 +263,39 @@ static const char *get_parent_scope_id(
     return sysml2_intern(symtab->intern, buf);
 }
 
-Sysml2Scope *sysml2_symtab_get_or_create_scope(
-    Sysml2SymbolTable *symtab,
+Sysml2Scope *sysml2_symtab_find_scope(
+    const Sysml2SymbolTable *symtab,
     const char *scope_id
 ) {
-    if (!scope_id) return symtab->root_scope;
+    return find_scope(symtab, scope_id);
+}
 
-    /* Check if scope already exists */
-    Sysml2Scope *existing = find_scope(symtab, scope_id);
-    if (existing) return existing;
+/*
+ * Nearest existing scope for an ID in a read-only view
+ *
+ * Strips trailing segments until an existing scope is found, using
+ * only non-mutating interner lookups.
+ */
+static Sysml2Scope *find_enclosing_scope(const Sysml2SymbolTable *symtab, const char *scope_id) {
+    size_t len = strlen(scope_id);
+    for (;;) {
+        const char *interned = sysml2_intern_lookup_sv(symtab->intern,
+            (Sysml2StringView){ .data = scope_id, .length = len });
+        Sysml2Scope *scope = interned ? find_scope(symtab, interned) : NULL;
+        if (scope) return scope;
+
+        /* Drop the last "::" segment */
+        size_t sep = len;
+        for (size_t i = 0; i + 1 < len; i++) {
+            if (scope_id[i] == ':' && scope_id[i + 1] == ':') sep = i;
+        }
+        if (sep == len) return symtab->root_scope;
+        len = sep;
+    }
+}
 
+/* Add a new scope to the table's index */
+static void insert_scope(Sysml2SymbolTable *symtab, Sysml2Scope *scope) {
     /* Resize if needed (before adding) */
     if (symtab->scope_count >= symtab->scope_capacity * 3 / 4) {
         size_t new_capacity = symtab->scope_capacity * 2;
@@ -123,10 +307,9 @@ Sysml2Scope *sysml2_symtab_get_or_create_scope(
         for (size_t i = 0; i < symtab->scope_capacity; i++) {
             Sysml2Scope *scope = symtab->scopes[i];
             if (scope && scope->id) {
-                uint32_t hash = hash_string(scope->id);
-                size_t idx = hash % new_capacity;
+                size_t idx = sysml2_id_hash(scope->id) & (new_capacity - 1);
                 while (new_scopes[idx]) {
-                    idx = (idx + 1) % new_capacity;
+                    idx = (idx + 1) & (new_capacity - 1);
                 }
                 new_scopes[idx] = scope;
             }
@@ -135,32 +318,139 @@ Sysml2Scope *sysml2_symtab_get_or_create_scope(
         symtab->scope_capacity = new_capacity;
     }
 
+    /* Insert into hash table */
+    size_t mask = symtab->scope_capacity - 1;
+    size_t idx = sysml2_id_hash(scope->id) & mask;
+    while (symtab->scopes[idx]) {
+        idx = (idx + 1) & mask;
+    }
+    symtab->scopes[idx] = scope;
+    symtab->scope_count++;
+
+    /* Overlay scopes are numbered after the frozen layer's and the root */
+    scope->index = symtab->scope_count + (symtab->lower ? symtab->lower->scope_count + 1 : 0);
+
+    /* A new (empty) scope can still change qualified-name results:
+     * "A::x" descends into A's scope once it exists */
+    resolve_cache_clear(symtab);
+}
+
+Sysml2Scope *sysml2_symtab_get_or_create_scope(
+    Sysml2SymbolTable *symtab,
+    const char *scope_id
+) {
+    if (!scope_id) return symtab->root_scope;
+
+    /* Check if scope already exists; model IDs are usually interned
+     * already, so only canonicalize on a miss */
+    Sysml2Scope *existing = find_scope(symtab, scope_id);
+    if (existing) return existing;
+
+    if (symtab->base || symtab->frozen) return find_enclosing_scope(symtab, scope_id);
+
+    scope_id = sysml2_intern(symtab->intern, scope_id);
+    existing = find_scope(symtab, scope_id);
+    if (existing) return existing;
+
     /* Create new scope */
-    Sysml2Scope *scope = sysml2_arena_alloc(symtab->arena, sizeof(Sysml2Scope));
-    scope->id = sysml2_intern(symtab->intern, scope_id);
-    scope->symbol_capacity = SYSML_SYMTAB_DEFAULT_SYMBOL_CAPACITY;
-    scope->symbol_count = 0;
-    scope->symbols = sysml2_arena_alloc(symtab->arena,
-        scope->symbol_capacity * sizeof(Sysml2Symbol *));
-    memset(scope->symbols, 0, scope->symbol_capacity * sizeof(Sysml2Symbol *));
-    scope->imports = NULL;
+    Sysml2Scope *scope = new_scope(symtab->arena, scope_id);
 
     /* Link to parent scope */
     const char *parent_id = get_parent_scope_id(symtab, scope_id);
     scope->parent = sysml2_symtab_get_or_create_scope(symtab, parent_id);
 
-    /* Insert into hash table */
-    uint32_t hash = hash_string(scope->id);
-    size_t idx = hash % symtab->scope_capacity;
-    while (symtab->scopes[idx]) {
-        idx = (idx + 1) % symtab->scope_capacity;
+    insert_scope(symtab, scope);
+    return scope;
+}
+
+Sysml2Scope *sysml2_symtab_get_or_create_node_scope(
+    Sysml2SymbolTable *symtab,
+    const SysmlNode *node
+) {
+    if (!node || !node->parent_id) return symtab->root_scope;
+
+    const SysmlNode *owner = node->parent;
+    if (!owner || !node->has_path || symtab->base || symtab->frozen) {
+        return sysml2_symtab_get_or_create_scope(symtab, node->parent_id);
     }
-    symtab->scopes[idx] = scope;
-    symtab->scope_count++;
 
+    Sysml2Scope *existing = find_scope(symtab, node->parent_id);
+    if (existing) return existing;
+
+    const char *scope_id = sysml2_intern(symtab->intern, node->parent_id);
+    existing = find_scope(symtab, scope_id);
+    if (existing) return existing;
+
+    /* The owner's own parent_id names the enclosing scope, so the ID
+     * need not be split */
+    Sysml2Scope *scope = new_scope(symtab->arena, scope_id);
+    scope->parent = sysml2_symtab_get_or_create_node_scope(symtab, owner);
+
+    insert_scope(symtab, scope);
     return scope;
 }
 
+/* The overlay's writable scope for scope: itself, or a shadow of a frozen one */
+static Sysml2Scope *own_scope(Sysml2SymbolTable *symtab, Sysml2Scope *scope) {
+    if (!scope->frozen) return scope;
+    if (!scope->id) return symtab->root_scope;
+
+    Sysml2Scope *own = find_own_scope(symtab, scope->id);
+    if (own) return own;
+
+    Sysml2Scope *shadow = new_scope(symtab->arena, scope->id);
+    if (!shadow) return NULL;
+    shadow->parent = scope->parent;
+    shadow->lower = scope;
+    insert_scope(symtab, shadow);
+    symtab->shadow_count++;
+    return shadow;
+}
+
+/* Find a member of the scope itself by name and precomputed hash */
+static Sysml2Symbol *lookup_members(const Sysml2Scope *scope, const char *name, uint32_t hash) {
+    if (scope->symbol_slots) {
+        size_t mask = scope->slot_capacity - 1;
+        for (size_t idx = hash & mask; scope->symbol_slots[idx]; idx = (idx + 1) & mask) {
+            Sysml2Symbol *sym = scope->symbols[scope->symbol_slots[idx] - 1];
+            if (sym->hash == hash && (sym->name == name || strcmp(sym->name, name) == 0)) {
+                return sym;
+            }
+        }
+        return NULL;
+    }
+
+    for (size_t i = 0; i < scope->symbol_count; i++) {
+        Sysml2Symbol *sym = scope->symbols[i];
+        if (sym->hash == hash && (sym->name == name || strcmp(sym->name, name) == 0)) {
+            return sym;
+        }
+    }
+    return NULL;
+}
+
+/* Find a member by name and precomputed hash, in a shadow's frozen scope too */
+static Sysml2Symbol *lookup_hashed(const Sysml2Scope *scope, const char *name, uint32_t hash) {
+    Sysml2Symbol *sym = lookup_members(scope, name, hash);
+    if (!sym && scope->lower) sym = lookup_members(scope->lower, name, hash);
+    return sym;
+}
+
+/* Rebuild a scope's hash index at 1/2 load for its current members */
+static bool index_members(Sysml2SymbolTable *symtab, Sysml2Scope *scope, size_t capacity) {
+    uint32_t *slots = sysml2_arena_calloc(symtab->arena, capacity, sizeof(uint32_t));
+    if (!slots) return false;
+
+    for (size_t i = 0; i < scope->symbol_count; i++) {
+        size_t idx = scope->symbols[i]->hash & (capacity - 1);
+        while (slots[idx]) idx = (idx + 1) & (capacity - 1);
+        slots[idx] = (uint32_t)(i + 1);
+    }
+    scope->symbol_slots = slots;
+    scope->slot_capacity = capacity;
+    return true;
+}
+
 Sysml2Symbol *sysml2_symtab_add(
     Sysml2SymbolTable *symtab,
     Sysml2Scope *scope,
@@ -168,47 +458,65 @@ Sysml2Symbol *sysml2_symtab_add(
     const char *qualified_id,
     SysmlNode *node
 ) {
-    if (!name || !scope) return NULL;
+    if (!name || !scope || symtab->base || symtab->frozen) return NULL;
 
     /* Check for existing symbol with same name */
-    Sysml2Symbol *existing = sysml2_symtab_lookup(scope, name);
+    size_t name_length = strlen(name);
+    uint32_t hash = sysml2_hash_string(name, name_length);
+    Sysml2Symbol *existing = lookup_hashed(layer_scope(symtab, scope), name, hash);
     if (existing) return existing; /* Return existing (duplicate) */
 
-    /* Resize symbols hash table if needed */
-    if (scope->symbol_count >= scope->symbol_capacity * 3 / 4) {
-        size_t new_capacity = scope->symbol_capacity * 2;
-        Sysml2Symbol **new_symbols = sysml2_arena_alloc(symtab->arena,
-            new_capacity * sizeof(Sysml2Symbol *));
-        memset(new_symbols, 0, new_capacity * sizeof(Sysml2Symbol *));
-
-        /* Rehash */
-        for (size_t i = 0; i < scope->symbol_capacity; i++) {
-            Sysml2Symbol *sym = scope->symbols[i];
-            while (sym) {
-                Sysml2Symbol *next = sym->next;
-                uint32_t hash = hash_string(sym->name);
-                size_t idx = hash % new_capacity;
-                sym->next = new_symbols[idx];
-                new_symbols[idx] = sym;
-                sym = next;
-            }
+    scope = own_scope(symtab, scope);
+    if (!scope) return NULL;
+
+    /* Grow the member list: inline first, then doubling in the arena */
+    if (scope->symbol_count >= scope->symbol_capacity) {
+        if (!scope->symbols) {
+            scope->symbols = scope->inline_symbols;
+            scope->symbol_capacity = SYSML_SYMTAB_INLINE_SYMBOLS;
+        } else {
+            size_t new_capacity = scope->symbol_capacity * 2;
+            Sysml2Symbol **new_symbols = SYSML2_ARENA_NEW_ARRAY(symtab->arena,
+                Sysml2Symbol *, new_capacity);
+            if (!new_symbols) return NULL;
+            memcpy(new_symbols, scope->symbols, scope->symbol_count * sizeof(Sysml2Symbol *));
+            scope->symbols = new_symbols;
+            scope->symbol_capacity = new_capacity;
         }
-        scope->symbols = new_symbols;
-        scope->symbol_capacity = new_capacity;
     }
 
+    if (!symtab->symbol_block || symtab->symbol_block_used == SYSML_SYMTAB_SYMBOL_BLOCK) {
+        symtab->symbol_block = SYSML2_ARENA_NEW_ARRAY(symtab->arena, Sysml2Symbol,
+            SYSML_SYMTAB_SYMBOL_BLOCK);
+        symtab->symbol_block_used = 0;
+        if (!symtab->symbol_block) return NULL;
+    }
+
+    resolve_cache_clear(symtab);
+
     /* Create new symbol */
-    Sysml2Symbol *sym = sysml2_arena_alloc(symtab->arena, sizeof(Sysml2Symbol));
+    Sysml2Symbol *sym = &symtab->symbol_block[symtab->symbol_block_used++];
     sym->name = sysml2_intern(symtab->intern, name);
     sym->qualified_id = sysml2_intern(symtab->intern, qualified_id);
     sym->node = node;
-
-    /* Insert into hash chain */
-    uint32_t hash = hash_string(name);
-    size_t idx = hash % scope->symbol_capacity;
-    sym->next = scope->symbols[idx];
-    scope->symbols[idx] = sym;
-    scope->symbol_count++;
+    sym->hash = hash;
+    sym->name_length = (uint32_t)name_length;
+
+    scope->symbols[scope->symbol_count++] = sym;
+
+    /* Index large scopes; a failed index leaves the linear scan working */
+    if (scope->symbol_slots && scope->symbol_count * 2 <= scope->slot_capacity) {
+        size_t mask = scope->slot_capacity - 1;
+        size_t idx = hash & mask;
+        while (scope->symbol_slots[idx]) idx = (idx + 1) & mask;
+        scope->symbol_slots[idx] = (uint32_t)scope->symbol_count;
+    } else if (scope->symbol_count > SYSML_SYMTAB_INDEX_THRESHOLD) {
+        size_t capacity = scope->slot_capacity ? scope->slot_capacity * 2 : 32;
+        if (!index_members(symtab, scope, capacity)) {
+            scope->symbol_slots = NULL;
+            scope->slot_capacity = 0;
+        }
+    }
 
     return sym;
 }
@@ -218,60 +526,79 @@ Sysml2Symbol *sysml2_symtab_lookup(
     const char *name
 ) {
     if (!scope || !name) return NULL;
-
-    uint32_t hash = hash_string(name);
-    size_t idx = hash % scope->symbol_capacity;
-
-    Sysml2Symbol *sym = scope->symbols[idx];
-    while (sym) {
-        if (strcmp(sym->name, name) == 0) {
-            return sym;
-        }
-        sym = sym->next;
-    }
-    return NULL;
+    return lookup_hashed(scope, name, symbol_hash(name));
 }
 
 /* Forward declaration for resolve_via_imports */
 static Sysml2Symbol *resolve_via_imports(
     Sysml2SymbolTable *symtab,
     const Sysml2Scope *scope,
-    const char *name
+    const char *name,
+    uint32_t hash
 );
 
-Sysml2Symbol *sysml2_symtab_resolve(
+/* Forward declaration for the final-segment helper used by imports */
+static const char *get_final_segment(const char *qname);
+
+Sysml2ImportEntry *sysml2_symtab_add_import(
+    Sysml2SymbolTable *symtab,
+    Sysml2Scope *scope,
+    const char *target,
+    SysmlNodeKind import_kind
+) {
+    if (!scope || !target || symtab->base || symtab->frozen) return NULL;
+
+    scope = own_scope(symtab, scope);
+    if (!scope) return NULL;
+
+    Sysml2ImportEntry *entry = sysml2_arena_alloc(symtab->arena, sizeof(Sysml2ImportEntry));
+    if (!entry) return NULL;
+
+    entry->target = sysml2_intern(symtab->intern, target);
+    entry->import_kind = import_kind;
+    entry->imported_name = get_final_segment(entry->target);
+    entry->target_scope = NULL;
+    entry->next = scope->imports;
+    scope->imports = entry;
+
+    resolve_cache_clear(symtab);
+    return entry;
+}
+
+static Sysml2Symbol *resolve_uncached(
     Sysml2SymbolTable *symtab,
     const Sysml2Scope *scope,
     const char *name
 ) {
-    if (!name) return NULL;
-
     /* Check for qualified name (contains "::") */
     const char *sep = strstr(name, "::");
     if (!sep) {
         /* Simple name - walk up scope chain */
-        const Sysml2Scope *s = scope ? scope : symtab->root_scope;
+        uint32_t hash = symbol_hash(name);
+        const Sysml2Scope *s = layer_scope(symtab, scope);
         while (s) {
             /* 1. Check direct symbols */
-            Sysml2Symbol *sym = sysml2_symtab_lookup(s, name);
+            Sysml2Symbol *sym = lookup_hashed(s, name, hash);
             if (sym) return sym;
 
             /* 2. Check imports in this scope */
-            sym = resolve_via_imports(symtab, s, name);
+            sym = resolve_via_imports(symtab, s, name, hash);
             if (sym) return sym;
 
             /* 3. Walk up */
-            s = s->parent;
+            s = layer_scope(symtab, s->parent);
         }
         return NULL;
     }
 
-    /* Qualified name - resolve first segment, then descend */
-    size_t first_len = sep - name;
-    char *first = sysml2_arena_alloc(symtab->arena, first_len + 1);
-    memcpy(first, name, first_len);
-    first[first_len] = '\0';
-
+    /* Qualified name - resolve first segment, then descend. A view may
+     * only look up: a segment that was never interned names no symbol. */
+    size_t first_len = (size_t)(sep - name);
+    const char *first = symtab->base
+        ? sysml2_intern_lookup_sv(symtab->intern,
+              (Sysml2StringView){ .data = name, .length = first_len })
+        : sysml2_intern_n(symtab->intern, name, first_len);
+    if (!first) return NULL;
     const char *rest = sep + 2; /* Skip "::" */
 
     /* Resolve first segment */
@@ -285,45 +612,25 @@ Sysml2Symbol *sysml2_symtab_resolve(
     return sysml2_symtab_resolve(symtab, child_scope, rest);
 }
 
-/* ========== Levenshtein Distance for Suggestions ========== */
-
-static size_t levenshtein_distance(const char *s1, const char *s2) {
-    size_t len1 = strlen(s1);
-    size_t len2 = strlen(s2);
-
-    if (len1 == 0) return len2;
-    if (len2 == 0) return len1;
-
-    /* Use two rows for space efficiency */
-    size_t *prev = malloc((len2 + 1) * sizeof(size_t));
-    size_t *curr = malloc((len2 + 1) * sizeof(size_t));
-
-    for (size_t j = 0; j <= len2; j++) {
-        prev[j] = j;
-    }
-
-    for (size_t i = 1; i <= len1; i++) {
-        curr[0] = i;
-        for (size_t j = 1; j <= len2; j++) {
-            size_t cost = (s1[i - 1] == s2[j - 1]) ? 0 : 1;
-            size_t del = prev[j] + 1;
-            size_t ins = curr[j - 1] + 1;
-            size_t sub = prev[j - 1] + cost;
+Sysml2Symbol *sysml2_symtab_resolve(
+    Sysml2SymbolTable *symtab,
+    const Sysml2Scope *scope,
+    const char *name
+) {
+    if (!name) return NULL;
+    if (!scope) scope = symtab->root_scope;
 
-            curr[j] = del < ins ? del : ins;
-            if (sub < curr[j]) curr[j] = sub;
-        }
-        size_t *tmp = prev;
-        prev = curr;
-        curr = tmp;
-    }
+    uint32_t hash = resolve_cache_hash(scope, name);
+    Sysml2ResolveCacheEntry *cached = resolve_cache_find(symtab, scope, name, hash);
+    if (cached) return cached->symbol;
 
-    size_t result = prev[len2];
-    free(prev);
-    free(curr);
-    return result;
+    Sysml2Symbol *sym = resolve_uncached(symtab, scope, name);
+    resolve_cache_insert(symtab, scope, name, hash, sym);
+    return sym;
 }
 
+/* ========== Suggestions ========== */
+
 /* Get max allowed edit distance based on name length */
 static size_t max_edit_distance(size_t name_len) {
     if (name_len < 4) return 1;
@@ -337,42 +644,39 @@ typedef struct {
     size_t distance;
 } SuggestionCandidate;
 
-/* Collect suggestions from a scope */
+/* Collect suggestions from a scope, members in declaration order */
 static void collect_suggestions_from_scope(
     const Sysml2Scope *scope,
-    const char *name,
+    const Sysml2EditPattern *name,
     size_t max_dist,
     SuggestionCandidate *candidates,
     size_t *candidate_count,
     size_t max_candidates
 ) {
-    for (size_t i = 0; i < scope->symbol_capacity; i++) {
+    for (size_t i = 0; i < scope->symbol_count; i++) {
         Sysml2Symbol *sym = scope->symbols[i];
-        while (sym) {
-            size_t dist = levenshtein_distance(name, sym->name);
-            if (dist <= max_dist && dist > 0) { /* Exclude exact match */
-                /* Insert into sorted candidates */
-                size_t insert_pos = *candidate_count;
-                for (size_t j = 0; j < *candidate_count; j++) {
-                    if (dist < candidates[j].distance) {
-                        insert_pos = j;
-                        break;
-                    }
-                }
+        size_t dist = sysml2_edit_distance_bounded(name, sym->name, sym->name_length, max_dist);
+        if (dist == 0 || dist > max_dist) continue; /* Exclude exact match */
+
+        /* Insert into sorted candidates */
+        size_t insert_pos = *candidate_count;
+        for (size_t j = 0; j < *candidate_count; j++) {
+            if (dist < candidates[j].distance) {
+                insert_pos = j;
+                break;
+            }
+        }
 
-                if (insert_pos < max_candidates) {
-                    /* Shift elements */
-                    if (*candidate_count < max_candidates) {
-                        (*candidate_count)++;
-                    }
-                    for (size_t j = *candidate_count - 1; j > insert_pos; j--) {
-                        candidates[j] = candidates[j - 1];
-                    }
-                    candidates[insert_pos].name = sym->name;
-                    candidates[insert_pos].distance = dist;
-                }
+        if (insert_pos < max_candidates) {
+            /* Shift elements */
+            if (*candidate_count < max_candidates) {
+                (*candidate_count)++;
+            }
+            for (size_t j = *candidate_count - 1; j > insert_pos; j--) {
+                candidates[j] = candidates[j - 1];
             }
-            sym = sym->next;
+            candidates[insert_pos].name = sym->name;
+            candidates[insert_pos].distance = dist;
         }
     }
 }
@@ -389,16 +693,25 @@ size_t sysml2_symtab_find_similar(
     size_t name_len = strlen(name);
     size_t max_dist = max_edit_distance(name_len);
 
+    /* The name is compared with every member of the scope chain */
+    Sysml2EditPattern pattern;
+    sysml2_edit_pattern_init(&pattern, name, name_len);
+
     /* Allocate candidate array */
     SuggestionCandidate *candidates = malloc(max_suggestions * sizeof(SuggestionCandidate));
     size_t candidate_count = 0;
 
-    /* Search current scope and ancestors */
-    const Sysml2Scope *s = scope ? scope : symtab->root_scope;
+    /* Search current scope and ancestors; a shadow's frozen members
+     * were declared before its own */
+    const Sysml2Scope *s = layer_scope(symtab, scope ? scope : symtab->root_scope);
     while (s) {
-        collect_suggestions_from_scope(s, name, max_dist, candidates,
+        if (s->lower) {
+            collect_suggestions_from_scope(s->lower, &pattern, max_dist, candidates,
+                &candidate_count, max_suggestions);
+        }
+        collect_suggestions_from_scope(s, &pattern, max_dist, candidates,
             &candidate_count, max_suggestions);
-        s = s->parent;
+        s = layer_scope(symtab, s->parent);
     }
 
     /* Copy results */
@@ -428,72 +741,69 @@ static const char *get_final_segment(const char *qname) {
     return last;
 }
 
+/* Target namespace of an import, looked up once it exists */
+static const Sysml2Scope *import_target_scope(
+    Sysml2SymbolTable *symtab,
+    const Sysml2Scope *owner,
+    Sysml2ImportEntry *imp
+) {
+    Sysml2Scope *target = imp->target_scope;
+    if (!target) {
+        /* Import entries are shared with views and overlays; only the
+         * table that owns them caches */
+        target = find_scope(symtab, imp->target);
+        if (!symtab->base && !owner->frozen) imp->target_scope = target;
+    }
+    return layer_scope(symtab, target);
+}
+
 /*
  * Transitive import resolution with cycle detection.
  *
  * SysML v2 imports are public by default, so `import A::*;` inside
  * package B makes A's members visible to anyone who imports B::*.
- * We track visited scopes on a small stack to break cycles.
+ * Each traversal stamps the scopes it enters with a fresh epoch (kept
+ * per table, so views traverse independently), so every scope is
+ * searched at most once and there is no depth limit.
  */
-#define MAX_IMPORT_DEPTH 32
-
-static Sysml2Symbol *resolve_via_imports_depth(
+static Sysml2Symbol *resolve_via_imports_epoch(
     Sysml2SymbolTable *symtab,
     const Sysml2Scope *scope,
     const char *name,
-    const Sysml2Scope **visited,
-    size_t *visited_count
-) {
-    if (!scope || !name) return NULL;
-
-    /* Cycle check — have we already visited this scope? */
-    for (size_t v = 0; v < *visited_count; v++) {
-        if (visited[v] == scope) return NULL;
-    }
-    if (*visited_count >= MAX_IMPORT_DEPTH) return NULL;
-
-    /* Mark current scope as visited (shared set — avoids re-exploring from other paths) */
-    visited[*visited_count] = scope;
-    (*visited_count)++;
+    uint32_t hash,
+    uint32_t epoch
+);
 
-    for (Sysml2ImportEntry *imp = scope->imports; imp; imp = imp->next) {
+/* Search one scope's own import list (owner is the scope holding it) */
+static Sysml2Symbol *resolve_import_list(
+    Sysml2SymbolTable *symtab,
+    const Sysml2Scope *owner,
+    const char *name,
+    uint32_t hash,
+    uint32_t epoch
+) {
+    for (Sysml2ImportEntry *imp = owner->imports; imp; imp = imp->next) {
         switch (imp->import_kind) {
             case SYSML_KIND_IMPORT: {
                 /* Direct import: import A::B::Engine -> check if name matches "Engine" */
-                const char *imported_name = get_final_segment(imp->target);
-                if (imported_name && strcmp(imported_name, name) == 0) {
-                    Sysml2Scope *target_parent = find_scope(symtab, NULL);
-                    return sysml2_symtab_resolve(symtab, target_parent, imp->target);
+                if (imp->imported_name && strcmp(imp->imported_name, name) == 0) {
+                    return sysml2_symtab_resolve(symtab, symtab->root_scope, imp->target);
                 }
                 break;
             }
 
-            case SYSML_KIND_IMPORT_ALL: {
+            case SYSML_KIND_IMPORT_ALL:
                 /* Namespace import: import A::B::* -> look in A::B scope */
-                Sysml2Scope *target_scope = find_scope(symtab, imp->target);
-                if (target_scope) {
-                    /* 1. Check direct symbols in target scope */
-                    Sysml2Symbol *sym = sysml2_symtab_lookup(target_scope, name);
-                    if (sym) return sym;
-
-                    /* 2. Transitively check target scope's own imports */
-                    sym = resolve_via_imports_depth(symtab, target_scope,
-                        name, visited, visited_count);
-                    if (sym) return sym;
-                }
-                break;
-            }
-
             case SYSML_KIND_IMPORT_RECURSIVE: {
                 /* Recursive import: import A::B::** -> search A::B and all nested */
-                Sysml2Scope *target_scope = find_scope(symtab, imp->target);
+                const Sysml2Scope *target_scope = import_target_scope(symtab, owner, imp);
                 if (target_scope) {
-                    Sysml2Symbol *sym = sysml2_symtab_lookup(target_scope, name);
+                    /* 1. Check direct symbols in target scope */
+                    Sysml2Symbol *sym = lookup_hashed(target_scope, name, hash);
                     if (sym) return sym;
 
-                    /* Transitively check target scope's own imports */
-                    sym = resolve_via_imports_depth(symtab, target_scope,
-                        name, visited, visited_count);
+                    /* 2. Transitively check target scope's own imports */
+                    sym = resolve_via_imports_epoch(symtab, target_scope, name, hash, epoch);
                     if (sym) return sym;
                 }
                 break;
@@ -507,13 +817,56 @@ static Sysml2Symbol *resolve_via_imports_depth(
     return NULL;
 }
 
+static Sysml2Symbol *resolve_via_imports_epoch(
+    Sysml2SymbolTable *symtab,
+    const Sysml2Scope *scope,
+    const char *name,
+    uint32_t hash,
+    uint32_t epoch
+) {
+    if (!scope || !name) return NULL;
+
+    /* Cycle check — have we already visited this scope? */
+    if (symtab->import_visits[scope->index] == epoch) return NULL;
+    symtab->import_visits[scope->index] = epoch;
+
+    /* A shadow's imports were added after those of its frozen scope */
+    Sysml2Symbol *sym = resolve_import_list(symtab, scope, name, hash, epoch);
+    if (!sym && scope->lower) sym = resolve_import_list(symtab, scope->lower, name, hash, epoch);
+    return sym;
+}
+
 /* Public entry point — resolve a simple name via imports in a scope */
 static Sysml2Symbol *resolve_via_imports(
     Sysml2SymbolTable *symtab,
     const Sysml2Scope *scope,
-    const char *name
+    const char *name,
+    uint32_t hash
 ) {
-    const Sysml2Scope *visited[MAX_IMPORT_DEPTH];
-    size_t count = 0;
-    return resolve_via_imports_depth(symtab, scope, name, visited, &count);
+    if (!scope || (!scope->imports && !(scope->lower && scope->lower->imports))) return NULL;
+
+    /* One stamp per scope of every layer, roots included */
+    size_t stamps = symtab->scope_count + 1 +
+        (symtab->lower ? symtab->lower->scope_count + 1 : 0);
+    if (symtab->import_visit_capacity < stamps) {
+        size_t new_capacity = symtab->import_visit_capacity
+            ? symtab->import_visit_capacity : 256;
+        while (new_capacity < stamps) new_capacity *= 2;
+        uint32_t *visits = sysml2_arena_calloc(symtab->arena, new_capacity, sizeof(uint32_t));
+        if (!visits) return NULL;
+        if (symtab->import_visits) {
+            memcpy(visits, symtab->import_visits,
+                symtab->import_visit_capacity * sizeof(uint32_t));
+        }
+        symtab->import_visits = visits;
+        symtab->import_visit_capacity = new_capacity;
+    }
+
+    /* On wrap-around, clear old stamps so none matches the new epoch */
+    if (++symtab->import_visit_epoch == 0) {
+        memset(symtab->import_visits, 0,
+            symtab->import_visit_capacity * sizeof(uint32_t));
+        symtab->import_visit_epoch = 1;
+    }
+    return resolve_via_imports_epoch(symtab, scope, name, hash, symtab->import_visit_epoch);
 }
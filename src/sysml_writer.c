@@ -6,6 +6,7 @@
 
 #include "sysml2/sysml_writer.h"
 #include "sysml2/query.h"
+#include "sysml2/intern.h"
 #include "sysml2/lexer.h"
 #include <stdlib.h>
 #include <string.h>
@@ -77,22 +78,221 @@ static int compare_nodes_by_position(const void *a, const void *b) {
            (na->loc.offset > nb->loc.offset) ? 1 : 0;
 }
 
+/*
+ * Scope index entry: the children, imports and aliases owned by one scope
+ *
+ * Each member list is a contiguous range of the index arrays, in model
+ * order. Scopes are keyed by interned ID (see intern.h).
+ */
+typedef struct {
+    const char *id;            /* Scope ID (NULL: empty slot / file level) */
+    const SysmlNode *node;     /* First element with this ID, if any */
+    size_t child_start, child_count;
+    size_t import_start, import_count;
+    size_t alias_start, alias_count;
+} WriterScope;
+
+/*
+ * Scope index for one model
+ *
+ * Built once per write so visiting a scope costs its own body size
+ * instead of a scan over the whole model.
+ */
+typedef struct {
+    Sysml2Arena arena;
+    WriterScope root;          /* File-level scope (parent/owner NULL) */
+    WriterScope *slots;        /* Open-addressed table (power of two) */
+    size_t capacity;
+    const SysmlNode **children;
+    const SysmlImport **imports;
+    const SysmlAlias **aliases;
+} WriterIndex;
+
+/*
+ * Output buffer: a file is rendered in memory and written in one call
+ */
+typedef struct {
+    char *data;                /* malloc'd, NUL-terminated */
+    size_t length;
+    size_t capacity;
+    bool failed;               /* An allocation failed; output is incomplete */
+} WriterBuffer;
+
 /*
  * Internal writer state
+ *
+ * Writers share nothing but the (read-only) model, so several models can
+ * be rendered on different threads at once.
  */
 typedef struct {
-    FILE *out;
+    WriterBuffer out;
     int indent_level;
     bool at_line_start;
+    const WriterIndex *index;  /* Scope index of the model being written */
+    Sysml2Arena scratch;       /* Body element arrays, rewound per body */
 } Sysml2Writer;
 
+#define WRITER_INITIAL_CAPACITY 4096
+
+static void writer_init(Sysml2Writer *w, const WriterIndex *index) {
+    memset(w, 0, sizeof(*w));
+    w->at_line_start = true;
+    w->index = index;
+    sysml2_arena_init(&w->scratch);
+}
+
+static void writer_destroy(Sysml2Writer *w) {
+    free(w->out.data);
+    sysml2_arena_destroy(&w->scratch);
+}
+
+/* Make room for n more bytes plus the terminator */
+static bool out_reserve(WriterBuffer *b, size_t n) {
+    if (b->failed) return false;
+    if (b->length + n < b->capacity) return true;
+
+    size_t capacity = b->capacity ? b->capacity : WRITER_INITIAL_CAPACITY;
+    while (b->length + n >= capacity) capacity *= 2;
+    char *data = realloc(b->data, capacity);
+    if (!data) {
+        b->failed = true;
+        return false;
+    }
+    b->data = data;
+    b->capacity = capacity;
+    return true;
+}
+
+static void out_write(Sysml2Writer *w, const char *s, size_t n) {
+    if (!out_reserve(&w->out, n)) return;
+    memcpy(w->out.data + w->out.length, s, n);
+    w->out.length += n;
+    w->out.data[w->out.length] = '\0';
+}
+
+static void out_puts(Sysml2Writer *w, const char *s) {
+    out_write(w, s, strlen(s));
+}
+
+static void out_putc(Sysml2Writer *w, char c) {
+    if (!out_reserve(&w->out, 1)) return;
+    w->out.data[w->out.length++] = c;
+    w->out.data[w->out.length] = '\0';
+}
+
+/*
+ * Find (or insert) the index entry for a scope ID
+ */
+static WriterScope *index_scope(const WriterIndex *ix, const char *id, bool insert) {
+    if (!id) return (WriterScope *)&ix->root;
+
+    size_t mask = ix->capacity - 1;
+    for (size_t i = sysml2_id_hash(id) & mask; ; i = (i + 1) & mask) {
+        WriterScope *scope = &ix->slots[i];
+        if (scope->id == id) return scope;
+        if (!scope->id) {
+            if (!insert) return NULL;
+            scope->id = id;
+            return scope;
+        }
+    }
+}
+
+/*
+ * Turn per-scope counts into range starts (counts are reset for filling)
+ */
+static void index_assign_ranges(WriterScope *scope, size_t *child_pos,
+                                size_t *import_pos, size_t *alias_pos) {
+    scope->child_start = *child_pos;
+    *child_pos += scope->child_count;
+    scope->child_count = 0;
+    scope->import_start = *import_pos;
+    *import_pos += scope->import_count;
+    scope->import_count = 0;
+    scope->alias_start = *alias_pos;
+    *alias_pos += scope->alias_count;
+    scope->alias_count = 0;
+}
+
+/*
+ * Build the scope index of a model
+ *
+ * @return false on allocation failure (index must still be destroyed)
+ */
+static bool writer_index_build(WriterIndex *ix, const SysmlSemanticModel *model) {
+    memset(ix, 0, sizeof(*ix));
+    sysml2_arena_init(&ix->arena);
+
+    /* Every scope is a parent, owner or element ID, so this bounds the
+     * number of entries; keep the table at most half full */
+    size_t keys = model->element_count * 2 + model->import_count + model->alias_count;
+    ix->capacity = 16;
+    while (ix->capacity < keys * 2) ix->capacity *= 2;
+
+    ix->slots = SYSML2_ARENA_NEW_ARRAY(&ix->arena, WriterScope, ix->capacity);
+    ix->children = SYSML2_ARENA_NEW_ARRAY(&ix->arena, const SysmlNode *, model->element_count + 1);
+    ix->imports = SYSML2_ARENA_NEW_ARRAY(&ix->arena, const SysmlImport *, model->import_count + 1);
+    ix->aliases = SYSML2_ARENA_NEW_ARRAY(&ix->arena, const SysmlAlias *, model->alias_count + 1);
+    if (!ix->slots || !ix->children || !ix->imports || !ix->aliases) return false;
+
+    /* Count members per scope */
+    for (size_t i = 0; i < model->element_count; i++) {
+        const SysmlNode *node = model->elements[i];
+        index_scope(ix, node->parent_id, true)->child_count++;
+        if (node->id) {
+            WriterScope *self = index_scope(ix, node->id, true);
+            if (!self->node) self->node = node;
+        }
+    }
+    for (size_t i = 0; i < model->import_count; i++) {
+        index_scope(ix, model->imports[i]->owner_scope, true)->import_count++;
+    }
+    for (size_t i = 0; i < model->alias_count; i++) {
+        index_scope(ix, model->aliases[i]->owner_scope, true)->alias_count++;
+    }
+
+    size_t child_pos = 0, import_pos = 0, alias_pos = 0;
+    index_assign_ranges(&ix->root, &child_pos, &import_pos, &alias_pos);
+    for (size_t i = 0; i < ix->capacity; i++) {
+        if (ix->slots[i].id) {
+            index_assign_ranges(&ix->slots[i], &child_pos, &import_pos, &alias_pos);
+        }
+    }
+
+    /* Fill ranges in model order */
+    for (size_t i = 0; i < model->element_count; i++) {
+        const SysmlNode *node = model->elements[i];
+        WriterScope *scope = index_scope(ix, node->parent_id, false);
+        ix->children[scope->child_start + scope->child_count++] = node;
+    }
+    for (size_t i = 0; i < model->import_count; i++) {
+        const SysmlImport *imp = model->imports[i];
+        WriterScope *scope = index_scope(ix, imp->owner_scope, false);
+        ix->imports[scope->import_start + scope->import_count++] = imp;
+    }
+    for (size_t i = 0; i < model->alias_count; i++) {
+        const SysmlAlias *alias = model->aliases[i];
+        WriterScope *scope = index_scope(ix, alias->owner_scope, false);
+        ix->aliases[scope->alias_start + scope->alias_count++] = alias;
+    }
+
+    return true;
+}
+
+static void writer_index_destroy(WriterIndex *ix) {
+    sysml2_arena_destroy(&ix->arena);
+}
+
 /*
  * Write indentation at the current level
  */
 static void write_indent(Sysml2Writer *w) {
     if (!w->at_line_start) return;
-    for (int i = 0; i < w->indent_level * SYSML_WRITER_INDENT_SIZE; i++) {
-        fputc(' ', w->out);
+    size_t n = w->indent_level > 0 ? (size_t)w->indent_level * SYSML_WRITER_INDENT_SIZE : 0;
+    if (n > 0 && out_reserve(&w->out, n)) {
+        memset(w->out.data + w->out.length, ' ', n);
+        w->out.length += n;
+        w->out.data[w->out.length] = '\0';
     }
     w->at_line_start = false;
 }
@@ -101,7 +301,7 @@ static void write_indent(Sysml2Writer *w) {
  * Write a newline
  */
 static void write_newline(Sysml2Writer *w) {
-    fputc('\n', w->out);
+    out_putc(w, '\n');
     w->at_line_start = true;
 }
 
@@ -113,30 +313,30 @@ static void write_trivia(Sysml2Writer *w, SysmlTrivia *trivia) {
         switch (trivia->kind) {
             case SYSML_TRIVIA_LINE_COMMENT:
                 write_indent(w);
-                fputs("// ", w->out);
+                out_puts(w, "// ");
                 if (trivia->text) {
-                    fputs(trivia->text, w->out);
+                    out_puts(w, trivia->text);
                 }
                 write_newline(w);
                 break;
 
             case SYSML_TRIVIA_BLOCK_COMMENT:
                 write_indent(w);
-                fputs("/**", w->out);
+                out_puts(w, "/**");
                 if (trivia->text) {
-                    fputs(trivia->text, w->out);
+                    out_puts(w, trivia->text);
                 }
-                fputs("*/", w->out);
+                out_puts(w, "*/");
                 write_newline(w);
                 break;
 
             case SYSML_TRIVIA_REGULAR_COMMENT:
                 write_indent(w);
-                fputs("/*", w->out);
+                out_puts(w, "/*");
                 if (trivia->text) {
-                    fputs(trivia->text, w->out);
+                    out_puts(w, trivia->text);
                 }
-                fputs("*/", w->out);
+                out_puts(w, "*/");
                 write_newline(w);
                 break;
 
@@ -163,26 +363,26 @@ static void write_trailing_trivia(Sysml2Writer *w, SysmlTrivia *trivia) {
     while (trivia) {
         switch (trivia->kind) {
             case SYSML_TRIVIA_LINE_COMMENT:
-                fputs("  // ", w->out);
+                out_puts(w, "  // ");
                 if (trivia->text) {
-                    fputs(trivia->text, w->out);
+                    out_puts(w, trivia->text);
                 }
                 break;
 
             case SYSML_TRIVIA_BLOCK_COMMENT:
-                fputs("  /**", w->out);
+                out_puts(w, "  /**");
                 if (trivia->text) {
-                    fputs(trivia->text, w->out);
+                    out_puts(w, trivia->text);
                 }
-                fputs("*/", w->out);
+                out_puts(w, "*/");
                 break;
 
             case SYSML_TRIVIA_REGULAR_COMMENT:
-                fputs("  /*", w->out);
+                out_puts(w, "  /*");
                 if (trivia->text) {
-                    fputs(trivia->text, w->out);
+                    out_puts(w, trivia->text);
                 }
-                fputs("*/", w->out);
+                out_puts(w, "*/");
                 break;
 
             case SYSML_TRIVIA_BLANK_LINE:
@@ -229,24 +429,24 @@ static void write_name(Sysml2Writer *w, const char *name) {
     if (!name) return;
 
     if (needs_quoting(name)) {
-        fputc('\'', w->out);
+        out_putc(w, '\'');
         /* Escape single quotes and backslashes */
         for (const char *p = name; *p; p++) {
             if (*p == '\'' || *p == '\\') {
-                fputc('\\', w->out);
+                out_putc(w, '\\');
             }
-            fputc(*p, w->out);
+            out_putc(w, *p);
         }
-        fputc('\'', w->out);
+        out_putc(w, '\'');
     } else {
-        fputs(name, w->out);
+        out_puts(w, name);
     }
 }
 
 /*
  * Forward declarations
  */
-static void write_node(Sysml2Writer *w, const SysmlNode *node, const SysmlSemanticModel *model);
+static void write_node(Sysml2Writer *w, const SysmlNode *node);
 
 /*
  * Comparison function for sorting imports alphabetically by target
@@ -265,94 +465,40 @@ static int compare_imports(const void *a, const void *b) {
 
 
 /*
- * Get child nodes for a parent
+ * Get child nodes for a parent (range owned by the index)
  */
-static size_t get_children(const SysmlSemanticModel *model, const char *parent_id,
+static size_t get_children(const WriterIndex *ix, const char *parent_id,
                            const SysmlNode ***out_children) {
-    /* Count children first */
-    size_t count = 0;
-    for (size_t i = 0; i < model->element_count; i++) {
-        const SysmlNode *node = model->elements[i];
-        if (parent_id == NULL && node->parent_id == NULL) {
-            count++;
-        } else if (parent_id && node->parent_id && strcmp(parent_id, node->parent_id) == 0) {
-            count++;
-        }
-    }
-
-    if (count == 0) {
+    const WriterScope *scope = index_scope(ix, parent_id, false);
+    if (!scope || scope->child_count == 0) {
         *out_children = NULL;
         return 0;
     }
-
-    /* Allocate and collect children */
-    const SysmlNode **children = malloc(count * sizeof(SysmlNode *));
-    if (!children) {
-        *out_children = NULL;
-        return 0;
-    }
-
-    size_t idx = 0;
-    for (size_t i = 0; i < model->element_count; i++) {
-        const SysmlNode *node = model->elements[i];
-        if (parent_id == NULL && node->parent_id == NULL) {
-            children[idx++] = node;
-        } else if (parent_id && node->parent_id && strcmp(parent_id, node->parent_id) == 0) {
-            children[idx++] = node;
-        }
-    }
-
-    *out_children = children;
-    return count;
+    *out_children = &ix->children[scope->child_start];
+    return scope->child_count;
 }
 
 /*
- * Get imports for a scope
+ * Get imports for a scope (range owned by the index)
+ *
+ * Imports keep their original order; sorting alphabetically reordered
+ * them during upsert operations.
  */
-static size_t get_imports(const SysmlSemanticModel *model, const char *scope_id,
+static size_t get_imports(const WriterIndex *ix, const char *scope_id,
                           const SysmlImport ***out_imports) {
-    size_t count = 0;
-    for (size_t i = 0; i < model->import_count; i++) {
-        const SysmlImport *imp = model->imports[i];
-        if (scope_id == NULL && imp->owner_scope == NULL) {
-            count++;
-        } else if (scope_id && imp->owner_scope && strcmp(scope_id, imp->owner_scope) == 0) {
-            count++;
-        }
-    }
-
-    if (count == 0) {
+    const WriterScope *scope = index_scope(ix, scope_id, false);
+    if (!scope || scope->import_count == 0) {
         *out_imports = NULL;
         return 0;
     }
-
-    const SysmlImport **imports = malloc(count * sizeof(SysmlImport *));
-    if (!imports) {
-        *out_imports = NULL;
-        return 0;
-    }
-
-    size_t idx = 0;
-    for (size_t i = 0; i < model->import_count; i++) {
-        const SysmlImport *imp = model->imports[i];
-        if (scope_id == NULL && imp->owner_scope == NULL) {
-            imports[idx++] = imp;
-        } else if (scope_id && imp->owner_scope && strcmp(scope_id, imp->owner_scope) == 0) {
-            imports[idx++] = imp;
-        }
-    }
-
-    /* Preserve original import order instead of sorting alphabetically.
-     * Sorting was causing imports to be reordered during upsert operations. */
-
-    *out_imports = imports;
-    return count;
+    *out_imports = &ix->imports[scope->import_start];
+    return scope->import_count;
 }
 
 /*
  * Forward declarations
  */
-static void write_node(Sysml2Writer *w, const SysmlNode *node, const SysmlSemanticModel *model);
+static void write_node(Sysml2Writer *w, const SysmlNode *node);
 static void write_applied_metadata(Sysml2Writer *w, const SysmlNode *node);
 
 /*
@@ -363,30 +509,30 @@ static void write_import(Sysml2Writer *w, const SysmlImport *imp) {
 
     /* Write visibility */
     if (imp->is_private) {
-        fputs("private ", w->out);
+        out_puts(w, "private ");
     } else if (imp->is_public_explicit) {
-        fputs("public ", w->out);
+        out_puts(w, "public ");
     }
 
-    fputs("import ", w->out);
+    out_puts(w, "import ");
 
     if (imp->target) {
-        fputs(imp->target, w->out);
+        out_puts(w, imp->target);
     }
 
     /* Add suffix based on kind */
     switch (imp->kind) {
         case SYSML_KIND_IMPORT_ALL:
-            fputs("::*", w->out);
+            out_puts(w, "::*");
             break;
         case SYSML_KIND_IMPORT_RECURSIVE:
-            fputs("::**", w->out);
+            out_puts(w, "::**");
             break;
         default:
             break;
     }
 
-    fputc(';', w->out);
+    out_putc(w, ';');
     write_newline(w);
 }
 
@@ -400,57 +546,57 @@ static void write_statement(Sysml2Writer *w, const SysmlStatement *stmt) {
 
     switch (stmt->kind) {
         case SYSML_STMT_BIND:
-            fputs("bind ", w->out);
+            out_puts(w, "bind ");
             if (stmt->source.target) {
-                fputs(stmt->source.target, w->out);
+                out_puts(w, stmt->source.target);
             }
-            fputs(" = ", w->out);
+            out_puts(w, " = ");
             if (stmt->target.target) {
-                fputs(stmt->target.target, w->out);
+                out_puts(w, stmt->target.target);
             }
-            fputs(";", w->out);
+            out_puts(w, ";");
             break;
 
         case SYSML_STMT_CONNECT:
-            fputs("connect ", w->out);
+            out_puts(w, "connect ");
             if (stmt->source.target) {
-                fputs(stmt->source.target, w->out);
+                out_puts(w, stmt->source.target);
             }
-            fputs(" to ", w->out);
+            out_puts(w, " to ");
             if (stmt->target.target) {
-                fputs(stmt->target.target, w->out);
+                out_puts(w, stmt->target.target);
             }
-            fputs(";", w->out);
+            out_puts(w, ";");
             break;
 
         case SYSML_STMT_FLOW:
-            fputs("flow ", w->out);
+            out_puts(w, "flow ");
             if (stmt->payload) {
-                fputs("of ", w->out);
-                fputs(stmt->payload, w->out);
-                fputc(' ', w->out);
+                out_puts(w, "of ");
+                out_puts(w, stmt->payload);
+                out_putc(w, ' ');
             }
-            fputs("from ", w->out);
+            out_puts(w, "from ");
             if (stmt->source.target) {
-                fputs(stmt->source.target, w->out);
+                out_puts(w, stmt->source.target);
             }
-            fputs(" to ", w->out);
+            out_puts(w, " to ");
             if (stmt->target.target) {
-                fputs(stmt->target.target, w->out);
+                out_puts(w, stmt->target.target);
             }
-            fputs(";", w->out);
+            out_puts(w, ";");
             break;
 
         case SYSML_STMT_ALLOCATE:
-            fputs("allocate ", w->out);
+            out_puts(w, "allocate ");
             if (stmt->source.target) {
-                fputs(stmt->source.target, w->out);
+                out_puts(w, stmt->source.target);
             }
-            fputs(" to ", w->out);
+            out_puts(w, " to ");
             if (stmt->target.target) {
-                fputs(stmt->target.target, w->out);
+                out_puts(w, stmt->target.target);
             }
-            fputs(";", w->out);
+            out_puts(w, ";");
             break;
 
         case SYSML_STMT_SUCCESSION:
@@ -458,156 +604,156 @@ static void write_statement(Sysml2Writer *w, const SysmlStatement *stmt) {
             if (!stmt->source.target && !stmt->target.target) {
                 return;  /* Don't write anything, skip newline too */
             }
-            fputs("first ", w->out);
+            out_puts(w, "first ");
             if (stmt->source.target) {
                 /* Check if source already contains " then " (parser captured full succession) */
                 const char *then_pos = strstr(stmt->source.target, " then ");
                 if (then_pos && !stmt->target.target) {
                     /* Source contains full succession, write as-is without adding another "then" */
-                    fputs(stmt->source.target, w->out);
+                    out_puts(w, stmt->source.target);
                     /* Already has semicolon if source ends with it */
                     if (stmt->source.target[strlen(stmt->source.target) - 1] != ';') {
-                        fputs(";", w->out);
+                        out_puts(w, ";");
                     }
                     break;
                 }
-                fputs(stmt->source.target, w->out);
+                out_puts(w, stmt->source.target);
             }
             if (stmt->guard) {
-                fputs(" if ", w->out);
-                fputs(stmt->guard, w->out);
+                out_puts(w, " if ");
+                out_puts(w, stmt->guard);
             }
             if (stmt->target.target) {
-                fputs(" then ", w->out);
-                fputs(stmt->target.target, w->out);
-                fputs(";", w->out);
+                out_puts(w, " then ");
+                out_puts(w, stmt->target.target);
+                out_puts(w, ";");
             } else {
                 /* No target - check if source already ends with semicolon */
                 if (!stmt->source.target || stmt->source.target[strlen(stmt->source.target) - 1] != ';') {
-                    fputs(";", w->out);
+                    out_puts(w, ";");
                 }
             }
             break;
 
         case SYSML_STMT_ENTRY:
-            fputs("entry ", w->out);
+            out_puts(w, "entry ");
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
             break;
 
         case SYSML_STMT_EXIT:
-            fputs("exit ", w->out);
+            out_puts(w, "exit ");
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
             break;
 
         case SYSML_STMT_DO:
-            fputs("do ", w->out);
+            out_puts(w, "do ");
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
             break;
 
         case SYSML_STMT_TRANSITION:
-            fputs("transition ", w->out);
+            out_puts(w, "transition ");
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
             break;
 
         case SYSML_STMT_ACCEPT:
-            fputs("accept ", w->out);
+            out_puts(w, "accept ");
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
             break;
 
         case SYSML_STMT_SEND:
-            fputs("send ", w->out);
+            out_puts(w, "send ");
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
-            fputs(";", w->out);
+            out_puts(w, ";");
             break;
 
         case SYSML_STMT_ACCEPT_ACTION:
-            fputs("accept ", w->out);
+            out_puts(w, "accept ");
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
             break;
 
         case SYSML_STMT_ASSIGN:
-            fputs("assign ", w->out);
+            out_puts(w, "assign ");
             if (stmt->target.target) {
-                fputs(stmt->target.target, w->out);
+                out_puts(w, stmt->target.target);
             }
-            fputs(" := ", w->out);
+            out_puts(w, " := ");
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
-            fputs(";", w->out);
+            out_puts(w, ";");
             break;
 
         case SYSML_STMT_IF:
-            fputs("if ", w->out);
+            out_puts(w, "if ");
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
             break;
 
         case SYSML_STMT_WHILE:
-            fputs("while ", w->out);
+            out_puts(w, "while ");
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
             break;
 
         case SYSML_STMT_FOR:
-            fputs("for ", w->out);
+            out_puts(w, "for ");
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
             break;
 
         case SYSML_STMT_LOOP:
-            fputs("loop ", w->out);
+            out_puts(w, "loop ");
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
             break;
 
         case SYSML_STMT_TERMINATE:
-            fputs("terminate;", w->out);
+            out_puts(w, "terminate;");
             break;
 
         case SYSML_STMT_MERGE:
-            fputs("merge ", w->out);
+            out_puts(w, "merge ");
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
             break;
 
         case SYSML_STMT_DECIDE:
-            fputs("decide ", w->out);
+            out_puts(w, "decide ");
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
             break;
 
         case SYSML_STMT_JOIN:
-            fputs("join ", w->out);
+            out_puts(w, "join ");
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
             break;
 
         case SYSML_STMT_FORK:
-            fputs("fork ", w->out);
+            out_puts(w, "fork ");
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
             break;
 
@@ -616,8 +762,8 @@ static void write_statement(Sysml2Writer *w, const SysmlStatement *stmt) {
             if (!stmt->raw_text || stmt->raw_text[0] == '\0') {
                 return;
             }
-            fputs("first ", w->out);
-            fputs(stmt->raw_text, w->out);
+            out_puts(w, "first ");
+            out_puts(w, stmt->raw_text);
             break;
 
         case SYSML_STMT_THEN:
@@ -639,24 +785,24 @@ static void write_statement(Sysml2Writer *w, const SysmlStatement *stmt) {
                     return;
                 }
             }
-            fputs(stmt->raw_text, w->out);
+            out_puts(w, stmt->raw_text);
             break;
 
         case SYSML_STMT_RESULT_EXPR:
             /* Just the expression, no keyword */
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
             break;
 
         case SYSML_STMT_METADATA_USAGE:
             /* metadata X about Y, Z; or metadata X { ... } */
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
                 /* Only add semicolon if not already ending with } or ; */
                 size_t len = strlen(stmt->raw_text);
                 if (len > 0 && stmt->raw_text[len-1] != '}' && stmt->raw_text[len-1] != ';') {
-                    fputs(";", w->out);
+                    out_puts(w, ";");
                 }
             }
             break;
@@ -664,112 +810,112 @@ static void write_statement(Sysml2Writer *w, const SysmlStatement *stmt) {
         case SYSML_STMT_SHORTHAND_FEATURE:
             /* :> name : Type; or :>> name = value; */
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
             break;
 
         case SYSML_STMT_REQUIRE_CONSTRAINT:
-            fputs("require ", w->out);
+            out_puts(w, "require ");
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
             break;
 
         case SYSML_STMT_ASSUME_CONSTRAINT:
-            fputs("assume ", w->out);
+            out_puts(w, "assume ");
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
             break;
 
         case SYSML_STMT_SUBJECT:
-            fputs("subject ", w->out);
+            out_puts(w, "subject ");
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
             break;
 
         case SYSML_STMT_END_MEMBER:
-            fputs("end ", w->out);
+            out_puts(w, "end ");
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
             break;
 
         case SYSML_STMT_RETURN:
-            fputs("return ", w->out);
+            out_puts(w, "return ");
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
             break;
 
         case SYSML_STMT_ACTOR:
-            fputs("actor ", w->out);
+            out_puts(w, "actor ");
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
             break;
 
         case SYSML_STMT_STAKEHOLDER:
-            fputs("stakeholder ", w->out);
+            out_puts(w, "stakeholder ");
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
             break;
 
         case SYSML_STMT_OBJECTIVE:
-            fputs("objective ", w->out);
+            out_puts(w, "objective ");
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
             break;
 
         case SYSML_STMT_FRAME:
-            fputs("frame ", w->out);
+            out_puts(w, "frame ");
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
             break;
 
         case SYSML_STMT_SATISFY:
             /* raw_text already includes the full statement */
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
             break;
 
         case SYSML_STMT_INCLUDE_USE_CASE:
             /* raw_text already includes the full statement */
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
             break;
 
         case SYSML_STMT_EXPOSE:
             /* raw_text already includes the full statement */
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
             break;
 
         case SYSML_STMT_RENDER:
             /* raw_text already includes the full statement */
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
             break;
 
         case SYSML_STMT_VERIFY:
             /* raw_text already includes the full statement */
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
             break;
 
         default:
             /* Unknown statement - write raw_text if available */
             if (stmt->raw_text) {
-                fputs(stmt->raw_text, w->out);
+                out_puts(w, stmt->raw_text);
             }
             break;
     }
@@ -784,29 +930,29 @@ static void write_named_comment(Sysml2Writer *w, const SysmlNamedComment *commen
     if (!comment) return;
 
     write_indent(w);
-    fputs("comment", w->out);
+    out_puts(w, "comment");
 
     if (comment->name) {
-        fputc(' ', w->out);
+        out_putc(w, ' ');
         write_name(w, comment->name);
     }
 
     if (comment->about_count > 0 && comment->about) {
-        fputs(" about ", w->out);
+        out_puts(w, " about ");
         for (size_t i = 0; i < comment->about_count; i++) {
-            if (i > 0) fputs(", ", w->out);
-            fputs(comment->about[i], w->out);
+            if (i > 0) out_puts(w, ", ");
+            out_puts(w, comment->about[i]);
         }
     }
 
     if (comment->locale) {
-        fputs(" locale ", w->out);
-        fputs(comment->locale, w->out);
+        out_puts(w, " locale ");
+        out_puts(w, comment->locale);
     }
 
-    fputc(' ', w->out);
+    out_putc(w, ' ');
     if (comment->text) {
-        fputs(comment->text, w->out);
+        out_puts(w, comment->text);
     }
 
     write_newline(w);
@@ -819,21 +965,21 @@ static void write_textual_rep(Sysml2Writer *w, const SysmlTextualRep *rep) {
     if (!rep) return;
 
     write_indent(w);
-    fputs("rep", w->out);
+    out_puts(w, "rep");
 
     if (rep->name) {
-        fputc(' ', w->out);
+        out_putc(w, ' ');
         write_name(w, rep->name);
     }
 
-    fputs(" language ", w->out);
+    out_puts(w, " language ");
     if (rep->language) {
-        fputs(rep->language, w->out);
+        out_puts(w, rep->language);
     }
 
-    fputc(' ', w->out);
+    out_putc(w, ' ');
     if (rep->text) {
-        fputs(rep->text, w->out);
+        out_puts(w, rep->text);
     }
 
     write_newline(w);
@@ -844,110 +990,81 @@ static void write_textual_rep(Sysml2Writer *w, const SysmlTextualRep *rep) {
  */
 static void write_alias(Sysml2Writer *w, const SysmlAlias *alias) {
     write_indent(w);
-    fputs("alias ", w->out);
+    out_puts(w, "alias ");
 
     if (alias->name) {
         write_name(w, alias->name);
     }
 
-    fputs(" for ", w->out);
+    out_puts(w, " for ");
 
     if (alias->target) {
-        fputs(alias->target, w->out);
+        out_puts(w, alias->target);
     }
 
-    fputc(';', w->out);
+    out_putc(w, ';');
     write_newline(w);
 }
 
 /*
- * Get aliases for a scope
+ * Get aliases for a scope (range owned by the index)
+ *
+ * Aliases keep their original order, like imports.
  */
-static size_t get_aliases(const SysmlSemanticModel *model, const char *scope_id,
+static size_t get_aliases(const WriterIndex *ix, const char *scope_id,
                           const SysmlAlias ***out_aliases) {
-    size_t count = 0;
-    for (size_t i = 0; i < model->alias_count; i++) {
-        const SysmlAlias *alias = model->aliases[i];
-        if (scope_id == NULL && alias->owner_scope == NULL) {
-            count++;
-        } else if (scope_id && alias->owner_scope && strcmp(scope_id, alias->owner_scope) == 0) {
-            count++;
-        }
-    }
-
-    if (count == 0) {
-        *out_aliases = NULL;
-        return 0;
-    }
-
-    const SysmlAlias **aliases = malloc(count * sizeof(SysmlAlias *));
-    if (!aliases) {
+    const WriterScope *scope = index_scope(ix, scope_id, false);
+    if (!scope || scope->alias_count == 0) {
         *out_aliases = NULL;
         return 0;
     }
-
-    size_t idx = 0;
-    for (size_t i = 0; i < model->alias_count; i++) {
-        const SysmlAlias *alias = model->aliases[i];
-        if (scope_id == NULL && alias->owner_scope == NULL) {
-            aliases[idx++] = alias;
-        } else if (scope_id && alias->owner_scope && strcmp(scope_id, alias->owner_scope) == 0) {
-            aliases[idx++] = alias;
-        }
-    }
-
-    /* Preserve original alias order instead of sorting alphabetically.
-     * Sorting was causing aliases to be reordered during upsert operations. */
-
-    *out_aliases = aliases;
-    return count;
+    *out_aliases = &ix->aliases[scope->alias_start];
+    return scope->alias_count;
 }
 
 /*
  * Collect all body elements into unified array for source-order sorting
+ *
+ * The array lives in the writer's scratch arena until the caller rewinds.
  */
 static BodyElement *collect_body_elements(
+    Sysml2Writer *w,
     const SysmlNode *node,
-    const SysmlSemanticModel *model,
     size_t *out_count
 ) {
+    const WriterIndex *ix = w->index;
+    const SysmlNodeCold *cold = sysml2_node_cold(node);
     /* Get imports for this scope */
     const SysmlImport **imports = NULL;
-    size_t import_count = get_imports(model, node->id, &imports);
+    size_t import_count = get_imports(ix, node->id, &imports);
 
     /* Get aliases for this scope */
     const SysmlAlias **aliases = NULL;
-    size_t alias_count = get_aliases(model, node->id, &aliases);
+    size_t alias_count = get_aliases(ix, node->id, &aliases);
 
     /* Get children */
     const SysmlNode **children = NULL;
-    size_t child_count = get_children(model, node->id, &children);
+    size_t child_count = get_children(ix, node->id, &children);
 
     /* Count total elements */
     size_t total = 0;
-    if (node->documentation) total++;
-    total += node->metadata_count;
+    if (cold->documentation) total++;
+    total += cold->metadata_count;
     total += import_count;
     total += alias_count;
-    total += node->body_stmt_count;
+    total += cold->body_stmt_count;
     total += child_count;
-    total += node->comment_count;
-    total += node->textual_rep_count;
+    total += cold->comment_count;
+    total += cold->textual_rep_count;
 
     if (total == 0) {
-        free((void *)imports);
-        free((void *)aliases);
-        free((void *)children);
         *out_count = 0;
         return NULL;
     }
 
     /* Allocate elements array */
-    BodyElement *elements = malloc(total * sizeof(BodyElement));
+    BodyElement *elements = SYSML2_ARENA_NEW_ARRAY(&w->scratch, BodyElement, total);
     if (!elements) {
-        free((void *)imports);
-        free((void *)aliases);
-        free((void *)children);
         *out_count = 0;
         return NULL;
     }
@@ -956,20 +1073,20 @@ static BodyElement *collect_body_elements(
     size_t insertion_order = 0;
 
     /* Add documentation */
-    if (node->documentation) {
+    if (cold->documentation) {
         elements[idx].kind = BODY_ELEM_DOC;
-        elements[idx].offset = node->doc_loc.offset;
+        elements[idx].offset = cold->doc_loc.offset;
         elements[idx].insertion_order = insertion_order++;
-        elements[idx].data.doc_text = node->documentation;
+        elements[idx].data.doc_text = cold->documentation;
         idx++;
     }
 
     /* Add metadata */
-    for (size_t i = 0; i < node->metadata_count; i++) {
+    for (size_t i = 0; i < cold->metadata_count; i++) {
         elements[idx].kind = BODY_ELEM_METADATA;
-        elements[idx].offset = node->metadata[i]->loc.offset;
+        elements[idx].offset = cold->metadata[i]->loc.offset;
         elements[idx].insertion_order = insertion_order++;
-        elements[idx].data.metadata = node->metadata[i];
+        elements[idx].data.metadata = cold->metadata[i];
         idx++;
     }
 
@@ -992,11 +1109,11 @@ static BodyElement *collect_body_elements(
     }
 
     /* Add body statements */
-    for (size_t i = 0; i < node->body_stmt_count; i++) {
+    for (size_t i = 0; i < cold->body_stmt_count; i++) {
         elements[idx].kind = BODY_ELEM_STATEMENT;
-        elements[idx].offset = node->body_stmts[i]->loc.offset;
+        elements[idx].offset = cold->body_stmts[i]->loc.offset;
         elements[idx].insertion_order = insertion_order++;
-        elements[idx].data.statement = node->body_stmts[i];
+        elements[idx].data.statement = cold->body_stmts[i];
         idx++;
     }
 
@@ -1010,27 +1127,23 @@ static BodyElement *collect_body_elements(
     }
 
     /* Add named comments */
-    for (size_t i = 0; i < node->comment_count; i++) {
+    for (size_t i = 0; i < cold->comment_count; i++) {
         elements[idx].kind = BODY_ELEM_COMMENT;
-        elements[idx].offset = node->comments[i]->loc.offset;
+        elements[idx].offset = cold->comments[i]->loc.offset;
         elements[idx].insertion_order = insertion_order++;
-        elements[idx].data.comment = node->comments[i];
+        elements[idx].data.comment = cold->comments[i];
         idx++;
     }
 
     /* Add textual representations */
-    for (size_t i = 0; i < node->textual_rep_count; i++) {
+    for (size_t i = 0; i < cold->textual_rep_count; i++) {
         elements[idx].kind = BODY_ELEM_TEXTUAL_REP;
-        elements[idx].offset = node->textual_reps[i]->loc.offset;
+        elements[idx].offset = cold->textual_reps[i]->loc.offset;
         elements[idx].insertion_order = insertion_order++;
-        elements[idx].data.textual_rep = node->textual_reps[i];
+        elements[idx].data.textual_rep = cold->textual_reps[i];
         idx++;
     }
 
-    free((void *)imports);
-    free((void *)aliases);
-    free((void *)children);
-
     *out_count = idx;
     return elements;
 }
@@ -1040,45 +1153,44 @@ static BodyElement *collect_body_elements(
  */
 static void write_body_element(
     Sysml2Writer *w,
-    const BodyElement *elem,
-    const SysmlSemanticModel *model
+    const BodyElement *elem
 ) {
     switch (elem->kind) {
         case BODY_ELEM_DOC:
             write_indent(w);
-            fputs("doc ", w->out);
-            fputs(elem->data.doc_text, w->out);
+            out_puts(w, "doc ");
+            out_puts(w, elem->data.doc_text);
             write_newline(w);
             break;
 
         case BODY_ELEM_METADATA: {
             SysmlMetadataUsage *m = elem->data.metadata;
             write_indent(w);
-            fputc('@', w->out);
-            fputs(m->type_ref, w->out);
+            out_putc(w, '@');
+            out_puts(w, m->type_ref);
 
             if (m->feature_count > 0) {
-                fputs(" {", w->out);
+                out_puts(w, " {");
                 write_newline(w);
                 w->indent_level++;
                 for (size_t j = 0; j < m->feature_count; j++) {
                     SysmlMetadataFeature *f = m->features[j];
                     if (!f) continue;
                     write_indent(w);
-                    fputs(":>> ", w->out);
-                    fputs(f->name, w->out);
+                    out_puts(w, ":>> ");
+                    out_puts(w, f->name);
                     if (f->value) {
-                        fputs(" = ", w->out);
-                        fputs(f->value, w->out);
+                        out_puts(w, " = ");
+                        out_puts(w, f->value);
                     }
-                    fputc(';', w->out);
+                    out_putc(w, ';');
                     write_newline(w);
                 }
                 w->indent_level--;
                 write_indent(w);
-                fputc('}', w->out);
+                out_putc(w, '}');
             } else {
-                fputc(';', w->out);
+                out_putc(w, ';');
             }
             write_newline(w);
             break;
@@ -1097,7 +1209,7 @@ static void write_body_element(
             break;
 
         case BODY_ELEM_CHILD:
-            write_node(w, elem->data.child, model);
+            write_node(w, elem->data.child);
             break;
 
         case BODY_ELEM_COMMENT:
@@ -1113,24 +1225,27 @@ static void write_body_element(
 /*
  * Write a body with children - source-ordered implementation
  */
-static void write_body(Sysml2Writer *w, const SysmlNode *node, const SysmlSemanticModel *model) {
+static void write_body(Sysml2Writer *w, const SysmlNode *node) {
+    const SysmlNodeCold *cold = sysml2_node_cold(node);
     size_t count = 0;
-    BodyElement *elements = collect_body_elements(node, model, &count);
+    Sysml2ArenaMark mark = sysml2_arena_mark(&w->scratch);
+    BodyElement *elements = collect_body_elements(w, node, &count);
 
-    bool has_result = (node->result_expression != NULL);
+    bool has_result = (cold->result_expression != NULL);
 
     if (count == 0 && !has_result) {
         /* Empty body: use semicolon */
-        fputc(';', w->out);
-        if (node->trailing_trivia) {
-            write_trailing_trivia(w, node->trailing_trivia);
+        out_putc(w, ';');
+        if (cold->trailing_trivia) {
+            write_trailing_trivia(w, cold->trailing_trivia);
         }
         write_newline(w);
+        sysml2_arena_rewind(&w->scratch, mark);
         return;
     }
 
     /* Non-empty body: use braces */
-    fputs(" {", w->out);
+    out_puts(w, " {");
     write_newline(w);
     w->indent_level++;
 
@@ -1141,19 +1256,19 @@ static void write_body(Sysml2Writer *w, const SysmlNode *node, const SysmlSemant
 
     /* Write in sorted order */
     for (size_t i = 0; i < count; i++) {
-        write_body_element(w, &elements[i], model);
+        write_body_element(w, &elements[i]);
     }
 
     /* Result expression always last (semantic requirement for calc/constraint bodies) */
     if (has_result) {
         write_indent(w);
-        fputs(node->result_expression, w->out);
+        out_puts(w, cold->result_expression);
         write_newline(w);
     }
 
     /* Write trailing trivia (comments at end of body before closing brace) */
-    if (node->trailing_trivia) {
-        for (SysmlTrivia *t = node->trailing_trivia; t; t = t->next) {
+    if (cold->trailing_trivia) {
+        for (SysmlTrivia *t = cold->trailing_trivia; t; t = t->next) {
             if (t->kind == SYSML_TRIVIA_BLANK_LINE) {
                 /* Output count blank lines (or 1 if count is 0) */
                 for (int i = 0; i < (t->count > 0 ? t->count : 1); i++) {
@@ -1161,20 +1276,20 @@ static void write_body(Sysml2Writer *w, const SysmlNode *node, const SysmlSemant
                 }
             } else if (t->kind == SYSML_TRIVIA_LINE_COMMENT) {
                 write_indent(w);
-                fputs("// ", w->out);
-                if (t->text) fputs(t->text, w->out);
+                out_puts(w, "// ");
+                if (t->text) out_puts(w, t->text);
                 write_newline(w);
             } else if (t->kind == SYSML_TRIVIA_BLOCK_COMMENT) {
                 write_indent(w);
-                fputs("/**", w->out);
-                if (t->text) fputs(t->text, w->out);
-                fputs("*/", w->out);
+                out_puts(w, "/**");
+                if (t->text) out_puts(w, t->text);
+                out_puts(w, "*/");
                 write_newline(w);
             } else if (t->kind == SYSML_TRIVIA_REGULAR_COMMENT) {
                 write_indent(w);
-                fputs("/*", w->out);
-                if (t->text) fputs(t->text, w->out);
-                fputs("*/", w->out);
+                out_puts(w, "/*");
+                if (t->text) out_puts(w, t->text);
+                out_puts(w, "*/");
                 write_newline(w);
             }
         }
@@ -1182,26 +1297,27 @@ static void write_body(Sysml2Writer *w, const SysmlNode *node, const SysmlSemant
 
     w->indent_level--;
     write_indent(w);
-    fputc('}', w->out);
+    out_putc(w, '}');
     write_newline(w);
 
-    free(elements);
+    sysml2_arena_rewind(&w->scratch, mark);
 }
 
 /*
  * Write applied metadata (@Type { ... })
  */
 static void write_applied_metadata(Sysml2Writer *w, const SysmlNode *node) {
-    for (size_t i = 0; i < node->metadata_count; i++) {
-        SysmlMetadataUsage *m = node->metadata[i];
+    const SysmlNodeCold *cold = sysml2_node_cold(node);
+    for (size_t i = 0; i < cold->metadata_count; i++) {
+        SysmlMetadataUsage *m = cold->metadata[i];
         if (!m) continue;
 
         write_indent(w);
-        fputc('@', w->out);
-        fputs(m->type_ref, w->out);
+        out_putc(w, '@');
+        out_puts(w, m->type_ref);
 
         if (m->feature_count > 0) {
-            fputs(" {", w->out);
+            out_puts(w, " {");
             write_newline(w);
             w->indent_level++;
             for (size_t j = 0; j < m->feature_count; j++) {
@@ -1209,20 +1325,20 @@ static void write_applied_metadata(Sysml2Writer *w, const SysmlNode *node) {
                 if (!f) continue;
                 write_indent(w);
                 /* Use :>> syntax for metadata attribute redefinitions */
-                fputs(":>> ", w->out);
-                fputs(f->name, w->out);
+                out_puts(w, ":>> ");
+                out_puts(w, f->name);
                 if (f->value) {
-                    fputs(" = ", w->out);
-                    fputs(f->value, w->out);
+                    out_puts(w, " = ");
+                    out_puts(w, f->value);
                 }
-                fputc(';', w->out);
+                out_putc(w, ';');
                 write_newline(w);
             }
             w->indent_level--;
             write_indent(w);
-            fputc('}', w->out);
+            out_putc(w, '}');
         } else {
-            fputc(';', w->out);
+            out_putc(w, ';');
         }
         write_newline(w);
     }
@@ -1231,26 +1347,27 @@ static void write_applied_metadata(Sysml2Writer *w, const SysmlNode *node) {
 /*
  * Write a definition or usage node
  */
-static void write_node(Sysml2Writer *w, const SysmlNode *node, const SysmlSemanticModel *model) {
+static void write_node(Sysml2Writer *w, const SysmlNode *node) {
     if (!node) return;
+    const SysmlNodeCold *cold = sysml2_node_cold(node);
 
     /* Write leading trivia */
-    if (node->leading_trivia) {
-        write_trivia(w, node->leading_trivia);
+    if (cold->leading_trivia) {
+        write_trivia(w, cold->leading_trivia);
     }
 
     write_indent(w);
 
     /* Write prefix applied metadata (@Type {...}) before element */
-    for (size_t i = 0; i < node->prefix_applied_metadata_count; i++) {
-        SysmlMetadataUsage *m = node->prefix_applied_metadata[i];
+    for (size_t i = 0; i < cold->prefix_applied_metadata_count; i++) {
+        SysmlMetadataUsage *m = cold->prefix_applied_metadata[i];
         if (!m) continue;
 
-        fputc('@', w->out);
-        fputs(m->type_ref, w->out);
+        out_putc(w, '@');
+        out_puts(w, m->type_ref);
 
         if (m->feature_count > 0) {
-            fputs(" {", w->out);
+            out_puts(w, " {");
             write_newline(w);
             w->indent_level++;
             for (size_t j = 0; j < m->feature_count; j++) {
@@ -1258,20 +1375,20 @@ static void write_node(Sysml2Writer *w, const SysmlNode *node, const SysmlSemant
                 if (!f) continue;
                 write_indent(w);
                 /* Use :>> syntax for metadata attribute redefinitions */
-                fputs(":>> ", w->out);
-                fputs(f->name, w->out);
+                out_puts(w, ":>> ");
+                out_puts(w, f->name);
                 if (f->value) {
-                    fputs(" = ", w->out);
-                    fputs(f->value, w->out);
+                    out_puts(w, " = ");
+                    out_puts(w, f->value);
                 }
-                fputc(';', w->out);
+                out_putc(w, ';');
                 write_newline(w);
             }
             w->indent_level--;
             write_indent(w);
-            fputc('}', w->out);
+            out_putc(w, '}');
         } else {
-            fputc(';', w->out);
+            out_putc(w, ';');
         }
         write_newline(w);
         write_indent(w);
@@ -1280,15 +1397,15 @@ static void write_node(Sysml2Writer *w, const SysmlNode *node, const SysmlSemant
     /* Write visibility modifier (public/private/protected) */
     switch (node->visibility) {
         case SYSML_VIS_PRIVATE:
-            fputs("private ", w->out);
+            out_puts(w, "private ");
             break;
         case SYSML_VIS_PROTECTED:
-            fputs("protected ", w->out);
+            out_puts(w, "protected ");
             break;
         case SYSML_VIS_PUBLIC:
             /* Public is the default, only write if explicitly marked */
             if (node->is_public_explicit) {
-                fputs("public ", w->out);
+                out_puts(w, "public ");
             }
             break;
         default:
@@ -1296,10 +1413,10 @@ static void write_node(Sysml2Writer *w, const SysmlNode *node, const SysmlSemant
     }
 
     /* Write prefix metadata before keyword (#Type) */
-    for (size_t i = 0; i < node->prefix_metadata_count; i++) {
-        fputc('#', w->out);
-        fputs(node->prefix_metadata[i], w->out);
-        fputc(' ', w->out);
+    for (size_t i = 0; i < cold->prefix_metadata_count; i++) {
+        out_putc(w, '#');
+        out_puts(w, cold->prefix_metadata[i]);
+        out_putc(w, ' ');
     }
 
     /* Write direction for parameters/usages (in/out/inout).
@@ -1307,13 +1424,13 @@ static void write_node(Sysml2Writer *w, const SysmlNode *node, const SysmlSemant
     if (!SYSML_KIND_IS_DEFINITION(node->kind)) {
         switch (node->direction) {
             case SYSML_DIR_IN:
-                fputs("in ", w->out);
+                out_puts(w, "in ");
                 break;
             case SYSML_DIR_OUT:
-                fputs("out ", w->out);
+                out_puts(w, "out ");
                 break;
             case SYSML_DIR_INOUT:
-                fputs("inout ", w->out);
+                out_puts(w, "inout ");
                 break;
             default:
                 break;
@@ -1322,55 +1439,55 @@ static void write_node(Sysml2Writer *w, const SysmlNode *node, const SysmlSemant
 
     /* Write assert modifier (for asserted constraints) */
     if (node->is_asserted) {
-        fputs("assert ", w->out);
+        out_puts(w, "assert ");
         if (node->is_negated) {
-            fputs("not ", w->out);
+            out_puts(w, "not ");
         }
     }
 
     /* Write abstract modifier */
     if (node->is_abstract) {
-        fputs("abstract ", w->out);
+        out_puts(w, "abstract ");
     }
 
     /* Write variation modifier */
     if (node->is_variation) {
-        fputs("variation ", w->out);
+        out_puts(w, "variation ");
     }
 
     /* Write parallel modifier (for states) */
     if (node->is_parallel && node->kind == SYSML_KIND_STATE_USAGE) {
-        fputs("parallel ", w->out);
+        out_puts(w, "parallel ");
     }
 
     /* Write attribute prefixes */
     if (node->is_readonly) {
-        fputs("readonly ", w->out);
+        out_puts(w, "readonly ");
     }
     if (node->is_derived) {
-        fputs("derived ", w->out);
+        out_puts(w, "derived ");
     }
     if (node->is_constant) {
-        fputs("constant ", w->out);
+        out_puts(w, "constant ");
     }
 
     /* Write ref modifier */
     if (node->is_ref) {
-        fputs("ref ", w->out);
-        if (node->ref_behavioral_keyword) {
-            fputs(node->ref_behavioral_keyword, w->out);
-            fputc(' ', w->out);
+        out_puts(w, "ref ");
+        if (cold->ref_behavioral_keyword) {
+            out_puts(w, cold->ref_behavioral_keyword);
+            out_putc(w, ' ');
         }
     }
 
     /* Write end modifier */
     if (node->is_end) {
-        fputs("end ", w->out);
+        out_puts(w, "end ");
     }
 
     /* Write exhibit modifier (for state usages) */
     if (node->is_exhibit && node->kind == SYSML_KIND_STATE_USAGE) {
-        fputs("exhibit ", w->out);
+        out_puts(w, "exhibit ");
     }
 
     /* Write keyword */
@@ -1378,13 +1495,13 @@ static void write_node(Sysml2Writer *w, const SysmlNode *node, const SysmlSemant
     /* Handle event occurrence: use "event occurrence" instead of just "event" */
     if (node->kind == SYSML_KIND_EVENT_USAGE && node->is_event_occurrence) {
         keyword = "event occurrence";
-    } else if (node->kind == SYSML_KIND_PORTION_USAGE && node->portion_kind) {
+    } else if (node->kind == SYSML_KIND_PORTION_USAGE && cold->portion_kind) {
         /* Use snapshot/timeslice instead of generic "portion" */
-        keyword = node->portion_kind;
+        keyword = cold->portion_kind;
     } else if (node->kind == SYSML_KIND_PERFORM_ACTION_USAGE && node->has_action_keyword) {
         /* Use "perform action" when action keyword was present, otherwise just "perform" */
         keyword = "perform action";
-    } else if (node->ref_behavioral_keyword) {
+    } else if (cold->ref_behavioral_keyword) {
         /* If ref behavioral keyword is set, it replaces the kind keyword */
         keyword = NULL;
     } else {
@@ -1397,36 +1514,31 @@ static void write_node(Sysml2Writer *w, const SysmlNode *node, const SysmlSemant
      * - Otherwise skip the keyword (they're written as bare names like "Unit;") */
     if (has_keyword && node->kind == SYSML_KIND_ENUMERATION_USAGE && node->parent_id) {
         /* Check if parent is an enumeration def */
-        for (size_t i = 0; i < model->element_count; i++) {
-            if (model->elements[i] && model->elements[i]->id &&
-                strcmp(model->elements[i]->id, node->parent_id) == 0) {
-                if (model->elements[i]->kind == SYSML_KIND_ENUMERATION_DEF) {
-                    /* Inside enum def - only write keyword if explicitly marked */
-                    has_keyword = node->has_enum_keyword;
-                }
-                break;
-            }
+        const WriterScope *parent = index_scope(w->index, node->parent_id, false);
+        if (parent && parent->node && parent->node->kind == SYSML_KIND_ENUMERATION_DEF) {
+            /* Inside enum def - only write keyword if explicitly marked */
+            has_keyword = node->has_enum_keyword;
         }
     }
 
     if (has_keyword) {
         /* Handle standard library package prefix */
         if (node->kind == SYSML_KIND_LIBRARY_PACKAGE && node->is_standard_library) {
-            fputs("standard ", w->out);
+            out_puts(w, "standard ");
         }
-        fputs(keyword, w->out);
+        out_puts(w, keyword);
     }
 
     /* For end features, multiplicity comes right after keyword */
     bool end_feature_mult_written = false;
     if (node->kind == SYSML_KIND_END_FEATURE && node->multiplicity_lower) {
-        fputs(" [", w->out);
-        fputs(node->multiplicity_lower, w->out);
+        out_puts(w, " [");
+        out_puts(w, node->multiplicity_lower);
         if (node->multiplicity_upper) {
-            fputs("..", w->out);
-            fputs(node->multiplicity_upper, w->out);
+            out_puts(w, "..");
+            out_puts(w, node->multiplicity_upper);
         }
-        fputc(']', w->out);
+        out_putc(w, ']');
         end_feature_mult_written = true;
     }
 
@@ -1435,14 +1547,14 @@ static void write_node(Sysml2Writer *w, const SysmlNode *node, const SysmlSemant
         /* Only add space before name if there was a keyword
            (direction/abstract/variation already added their own trailing space) */
         if (has_keyword) {
-            fputc(' ', w->out);
+            out_putc(w, ' ');
         }
         write_name(w, node->name);
     }
 
     /* Write parameter list if present (for action/state definitions) */
-    if (node->parameter_list) {
-        fputs(node->parameter_list, w->out);
+    if (cold->parameter_list) {
+        out_puts(w, cold->parameter_list);
     }
 
     /* Write type relationships with correct operators */
@@ -1450,22 +1562,22 @@ static void write_node(Sysml2Writer *w, const SysmlNode *node, const SysmlSemant
 
     /* :> specializations first (most common for definitions) */
     for (size_t i = 0; i < node->specializes_count; i++) {
-        fputs(first_rel ? " :> " : ", ", w->out);
-        fputs(node->specializes[i], w->out);
+        out_puts(w, first_rel ? " :> " : ", ");
+        out_puts(w, node->specializes[i]);
         first_rel = false;
     }
 
     /* :>> redefinitions */
     for (size_t i = 0; i < node->redefines_count; i++) {
-        fputs(first_rel ? " :>> " : ", ", w->out);
-        fputs(node->redefines[i], w->out);
+        out_puts(w, first_rel ? " :>> " : ", ");
+        out_puts(w, node->redefines[i]);
         first_rel = false;
     }
 
     /* ::> references */
     for (size_t i = 0; i < node->references_count; i++) {
-        fputs(first_rel ? " ::> " : ", ", w->out);
-        fputs(node->references[i], w->out);
+        out_puts(w, first_rel ? " ::> " : ", ");
+        out_puts(w, node->references[i]);
         first_rel = false;
     }
 
@@ -1474,17 +1586,17 @@ static void write_node(Sysml2Writer *w, const SysmlNode *node, const SysmlSemant
     if (node->typed_by_count > 0) {
         /* End features use compact format (no spaces around colon) */
         if (node->kind == SYSML_KIND_END_FEATURE) {
-            fputc(':', w->out);
+            out_putc(w, ':');
         } else {
-            fputs(" : ", w->out);
+            out_puts(w, " : ");
         }
         for (size_t i = 0; i < node->typed_by_count; i++) {
-            if (i > 0) fputs(", ", w->out);  /* Comma only between multiple types */
+            if (i > 0) out_puts(w, ", ");  /* Comma only between multiple types */
             /* Output ~ prefix for conjugated port types */
             if (node->typed_by_conjugated && node->typed_by_conjugated[i]) {
-                fputc('~', w->out);
+                out_putc(w, '~');
             }
-            fputs(node->typed_by[i], w->out);
+            out_puts(w, node->typed_by[i]);
         }
     }
 
@@ -1492,78 +1604,79 @@ static void write_node(Sysml2Writer *w, const SysmlNode *node, const SysmlSemant
     if (node->multiplicity_lower && !end_feature_mult_written) {
         /* Add space before [ for non-end features to preserve spacing: "String [0..1]" */
         if (node->kind != SYSML_KIND_END_FEATURE) {
-            fputc(' ', w->out);
+            out_putc(w, ' ');
         }
-        fputc('[', w->out);
-        fputs(node->multiplicity_lower, w->out);
+        out_putc(w, '[');
+        out_puts(w, node->multiplicity_lower);
         if (node->multiplicity_upper) {
-            fputs("..", w->out);
-            fputs(node->multiplicity_upper, w->out);
+            out_puts(w, "..");
+            out_puts(w, node->multiplicity_upper);
         }
-        fputc(']', w->out);
+        out_putc(w, ']');
     }
 
     /* Write default value - only for usages, not definitions */
-    if (node->default_value && !SYSML_KIND_IS_DEFINITION(node->kind)) {
+    if (cold->default_value && !SYSML_KIND_IS_DEFINITION(node->kind)) {
         if (node->has_default_keyword) {
-            fputs(" default", w->out);
+            out_puts(w, " default");
         }
-        fputs(" = ", w->out);
-        fputs(node->default_value, w->out);
+        out_puts(w, " = ");
+        out_puts(w, cold->default_value);
     }
 
     /* Write connector/allocation part (connect (a, b, c) or allocate X to Y) */
-    if (node->connector_part) {
-        fputc(' ', w->out);
+    if (cold->connector_part) {
+        out_putc(w, ' ');
         /* Interface usages: output "connect" keyword if it was present */
         if (node->has_connect_keyword && node->kind == SYSML_KIND_INTERFACE_USAGE) {
-            fputs("connect ", w->out);
+            out_puts(w, "connect ");
         }
-        fputs(node->connector_part, w->out);
+        out_puts(w, cold->connector_part);
     }
 
     /* Write body for container elements */
     if (SYSML_KIND_IS_PACKAGE(node->kind) ||
         SYSML_KIND_IS_DEFINITION(node->kind) ||
         SYSML_KIND_IS_USAGE(node->kind)) {
-        write_body(w, node, model);
+        write_body(w, node);
     } else {
         /* Simple element: just semicolon */
-        fputc(';', w->out);
-        if (node->trailing_trivia) {
-            write_trailing_trivia(w, node->trailing_trivia);
+        out_putc(w, ';');
+        if (cold->trailing_trivia) {
+            write_trailing_trivia(w, cold->trailing_trivia);
         }
         write_newline(w);
     }
 }
 
 /*
- * Write the semantic model as formatted SysML/KerML source to a file
+ * Render a model into a malloc'd string (NUL-terminated, length in
+ * *out_length)
  */
-Sysml2Result sysml2_sysml_write(
+static Sysml2Result render_model(
     const SysmlSemanticModel *model,
-    FILE *out
+    char **out_text,
+    size_t *out_length
 ) {
-    if (!model || !out) {
-        return SYSML2_ERROR_SYNTAX;
+    WriterIndex index;
+    if (!writer_index_build(&index, model)) {
+        writer_index_destroy(&index);
+        return SYSML2_ERROR_OUT_OF_MEMORY;
     }
 
-    Sysml2Writer w = {
-        .out = out,
-        .indent_level = 0,
-        .at_line_start = true
-    };
+    Sysml2Writer w;
+    writer_init(&w, &index);
 
     /* Write file-level metadata first (annotations that weren't attached to any element) */
     for (size_t i = 0; i < model->file_metadata_count; i++) {
         SysmlMetadataUsage *m = model->file_metadata[i];
         if (!m) continue;
 
-        fputc('@', w.out);
-        fputs(m->type_ref, w.out);
+        out_putc(&w, '@');
+        out_puts(&w, m->type_ref);
 
         if (m->feature_count > 0) {
-            fputs(" {", w.out);
+            out_puts(&w, " {");
             write_newline(&w);
             w.indent_level++;
             for (size_t j = 0; j < m->feature_count; j++) {
@@ -1571,35 +1684,35 @@ Sysml2Result sysml2_sysml_write(
                 if (!f) continue;
                 write_indent(&w);
                 /* Use :>> syntax for metadata attribute redefinitions */
-                fputs(":>> ", w.out);
-                fputs(f->name, w.out);
+                out_puts(&w, ":>> ");
+                out_puts(&w, f->name);
                 if (f->value) {
-                    fputs(" = ", w.out);
-                    fputs(f->value, w.out);
+                    out_puts(&w, " = ");
+                    out_puts(&w, f->value);
                 }
-                fputc(';', w.out);
+                out_putc(&w, ';');
                 write_newline(&w);
             }
             w.indent_level--;
             write_indent(&w);
-            fputc('}', w.out);
+            out_putc(&w, '}');
         } else {
-            fputc(';', w.out);
+            out_putc(&w, ';');
         }
         write_newline(&w);
     }
 
     /* Get top-level imports (scope = NULL) */
     const SysmlImport **imports = NULL;
-    size_t import_count = get_imports(model, NULL, &imports);
+    size_t import_count = get_imports(&index, NULL, &imports);
 
     /* Get top-level aliases (scope = NULL) */
     const SysmlAlias **aliases = NULL;
-    size_t alias_count = get_aliases(model, NULL, &aliases);
+    size_t alias_count = get_aliases(&index, NULL, &aliases);
 
     /* Get top-level elements (parent = NULL) */
     const SysmlNode **children = NULL;
-    size_t child_count = get_children(model, NULL, &children);
+    size_t child_count = get_children(&index, NULL, &children);
 
     /* Sort top-level elements by source position to preserve original order */
     if (child_count > 1) {
@@ -1623,15 +1736,15 @@ Sysml2Result sysml2_sysml_write(
 
     /* Write top-level elements */
     for (size_t i = 0; i < child_count; i++) {
-        write_node(&w, children[i], model);
+        write_node(&w, children[i]);
 
         /* Add blank line between top-level elements, unless next element
          * already has blank line trivia (to prevent accumulation) */
         if (i + 1 < child_count) {
             const SysmlNode *next = children[i + 1];
             bool next_has_blank = false;
-            if (next && next->leading_trivia) {
-                for (SysmlTrivia *t = next->leading_trivia; t; t = t->next) {
+            if (next && sysml2_node_cold(next)->leading_trivia) {
+                for (SysmlTrivia *t = sysml2_node_cold(next)->leading_trivia; t; t = t->next) {
                     if (t->kind == SYSML_TRIVIA_BLANK_LINE) {
                         next_has_blank = true;
                         break;
@@ -1644,13 +1757,42 @@ Sysml2Result sysml2_sysml_write(
         }
     }
 
-    free((void *)imports);
-    free((void *)aliases);
-    free((void *)children);
+    writer_index_destroy(&index);
 
+    /* An empty model still renders as "" */
+    if (w.out.failed || !out_reserve(&w.out, 0)) {
+        writer_destroy(&w);
+        return SYSML2_ERROR_OUT_OF_MEMORY;
+    }
+    w.out.data[w.out.length] = '\0';
+    *out_text = w.out.data;
+    *out_length = w.out.length;
+    w.out.data = NULL;
+    writer_destroy(&w);
     return SYSML2_OK;
 }
 
+/*
+ * Write the semantic model as formatted SysML/KerML source to a file
+ */
+Sysml2Result sysml2_sysml_write(
+    const SysmlSemanticModel *model,
+    FILE *out
+) {
+    if (!model || !out) {
+        return SYSML2_ERROR_SYNTAX;
+    }
+
+    char *text;
+    size_t length;
+    Sysml2Result result = render_model(model, &text, &length);
+    if (result == SYSML2_OK) {
+        fwrite(text, 1, length, out);
+        free(text);
+    }
+    return result;
+}
+
 /*
  * Write the semantic model as formatted SysML/KerML source to a string
  */
@@ -1662,24 +1804,11 @@ Sysml2Result sysml2_sysml_write_string(
         return SYSML2_ERROR_SYNTAX;
     }
 
-    /* Use memory stream */
-    char *buffer = NULL;
-    size_t size = 0;
-    FILE *memstream = open_memstream(&buffer, &size);
-    if (!memstream) {
-        return SYSML2_ERROR_OUT_OF_MEMORY;
-    }
-
-    Sysml2Result result = sysml2_sysml_write(model, memstream);
-    fclose(memstream);
-
-    if (result == SYSML2_OK) {
-        *out_str = buffer;
-    } else {
-        free(buffer);
+    size_t length;
+    Sysml2Result result = render_model(model, out_str, &length);
+    if (result != SYSML2_OK) {
         *out_str = NULL;
     }
-
     return result;
 }
 
@@ -1725,6 +1854,121 @@ static const char *get_local_name(const char *id) {
     return id;
 }
 
+/*
+ * Query output group: matched elements and ancestor stubs sharing one
+ * parent path (the ID prefix before the last "::")
+ */
+typedef struct {
+    const char *parent;        /* Parent path, points into a member ID (NULL: empty slot) */
+    size_t parent_len;
+    size_t elem_start, elem_count;
+    size_t anc_start, anc_count;
+} QueryGroup;
+
+/*
+ * Query output index: result elements and ancestors grouped by parent path
+ */
+typedef struct {
+    QueryGroup root;           /* Top-level members (no "::" in the ID) */
+    QueryGroup *slots;         /* Open-addressed table (power of two) */
+    size_t capacity;
+    const SysmlNode **elems;
+    const char **ancs;
+} QueryIndex;
+
+/*
+ * Length of the parent path of an ID, or SIZE_MAX for top-level IDs
+ */
+static size_t parent_path_length(const char *id) {
+    const char *last_sep = NULL;
+    for (const char *p = id; *p; p++) {
+        if (p[0] == ':' && p[1] == ':') {
+            last_sep = p;
+        }
+    }
+    return last_sep ? (size_t)(last_sep - id) : SIZE_MAX;
+}
+
+/*
+ * Find (or insert) the group for a parent path (NULL for top level)
+ */
+static QueryGroup *query_group(QueryIndex *qx, const char *parent, size_t len, bool insert) {
+    if (!parent) return &qx->root;
+
+    size_t mask = qx->capacity - 1;
+    for (size_t i = sysml2_hash_string(parent, len) & mask; ; i = (i + 1) & mask) {
+        QueryGroup *group = &qx->slots[i];
+        if (!group->parent) {
+            if (!insert) return NULL;
+            group->parent = parent;
+            group->parent_len = len;
+            return group;
+        }
+        if (group->parent_len == len && memcmp(group->parent, parent, len) == 0) {
+            return group;
+        }
+    }
+}
+
+static QueryGroup *query_group_of(QueryIndex *qx, const char *id, bool insert) {
+    size_t len = parent_path_length(id);
+    return query_group(qx, len == SIZE_MAX ? NULL : id, len, insert);
+}
+
+/*
+ * Group result elements and ancestors by parent path, keeping their order
+ */
+static bool query_index_build(
+    QueryIndex *qx,
+    const Sysml2QueryResult *result,
+    const char **ancestors,
+    size_t ancestor_count,
+    Sysml2Arena *arena
+) {
+    memset(qx, 0, sizeof(*qx));
+    qx->capacity = 16;
+    while (qx->capacity < (result->element_count + ancestor_count) * 2) qx->capacity *= 2;
+
+    qx->slots = SYSML2_ARENA_NEW_ARRAY(arena, QueryGroup, qx->capacity);
+    qx->elems = SYSML2_ARENA_NEW_ARRAY(arena, const SysmlNode *, result->element_count + 1);
+    qx->ancs = SYSML2_ARENA_NEW_ARRAY(arena, const char *, ancestor_count + 1);
+    if (!qx->slots || !qx->elems || !qx->ancs) return false;
+
+    for (size_t i = 0; i < result->element_count; i++) {
+        const SysmlNode *node = result->elements[i];
+        if (node && node->id) query_group_of(qx, node->id, true)->elem_count++;
+    }
+    for (size_t i = 0; i < ancestor_count; i++) {
+        if (ancestors[i]) query_group_of(qx, ancestors[i], true)->anc_count++;
+    }
+
+    size_t elem_pos = 0, anc_pos = 0;
+    for (size_t i = 0; i <= qx->capacity; i++) {
+        QueryGroup *group = i < qx->capacity ? &qx->slots[i] : &qx->root;
+        if (i < qx->capacity && !group->parent) continue;
+        group->elem_start = elem_pos;
+        elem_pos += group->elem_count;
+        group->elem_count = 0;
+        group->anc_start = anc_pos;
+        anc_pos += group->anc_count;
+        group->anc_count = 0;
+    }
+
+    for (size_t i = 0; i < result->element_count; i++) {
+        const SysmlNode *node = result->elements[i];
+        if (!node || !node->id) continue;
+        QueryGroup *group = query_group_of(qx, node->id, false);
+        qx->elems[group->elem_start + group->elem_count++] = node;
+    }
+    for (size_t i = 0; i < ancestor_count; i++) {
+        if (!ancestors[i]) continue;
+        QueryGroup *group = query_group_of(qx, ancestors[i], false);
+        qx->ancs[group->anc_start + group->anc_count++] = ancestors[i];
+    }
+
+    return true;
+}
+
 /*
  * Recursive function to write query result as SysML
  *
@@ -1732,129 +1976,70 @@ static const char *get_local_name(const char *id) {
  */
 static void write_query_children(
     Sysml2Writer *w,
-    const Sysml2QueryResult *result,
+    QueryIndex *qx,
     SysmlSemanticModel **models,
     size_t model_count,
-    const char **ancestors,
-    size_t ancestor_count,
     const char *parent_path,
     size_t parent_path_len
 ) {
+    const QueryGroup *group = query_group(qx, parent_path, parent_path_len, false);
+    if (!group) return;
+
     bool first = true;
 
     /* Write elements that are direct children of parent_path */
-    for (size_t i = 0; i < result->element_count; i++) {
-        const SysmlNode *node = result->elements[i];
-        if (!node || !node->id) continue;
-
-        /* Check if this node's parent matches parent_path */
-        const char *last_sep = NULL;
-        const char *p = node->id;
-        while (*p) {
-            if (p[0] == ':' && p[1] == ':') {
-                last_sep = p;
-            }
-            p++;
-        }
-
-        bool is_direct_child;
-        if (parent_path == NULL) {
-            /* Top-level: no :: in the ID */
-            is_direct_child = (last_sep == NULL);
-        } else {
-            /* Check if parent matches exactly */
-            if (!last_sep) {
-                is_direct_child = false;
-            } else {
-                size_t parent_len = last_sep - node->id;
-                is_direct_child = (parent_len == parent_path_len &&
-                                   strncmp(node->id, parent_path, parent_len) == 0);
-            }
-        }
-
-        if (is_direct_child) {
-            if (!first) {
-                write_newline(w);
-            }
-            first = false;
-            write_node(w, node, models[0]);  /* Use first model for structure */
+    for (size_t i = 0; i < group->elem_count; i++) {
+        if (!first) {
+            write_newline(w);
         }
+        first = false;
+        write_node(w, qx->elems[group->elem_start + i]);
     }
 
     /* Write ancestor stubs that are direct children of parent_path */
-    for (size_t i = 0; i < ancestor_count; i++) {
-        const char *anc_id = ancestors[i];
-        if (!anc_id) continue;
-
-        /* Check if this ancestor's parent matches parent_path */
-        const char *last_sep = NULL;
-        const char *p = anc_id;
-        while (*p) {
-            if (p[0] == ':' && p[1] == ':') {
-                last_sep = p;
-            }
-            p++;
-        }
+    for (size_t i = 0; i < group->anc_count; i++) {
+        const char *anc_id = qx->ancs[group->anc_start + i];
 
-        bool is_direct_child;
-        if (parent_path == NULL) {
-            is_direct_child = (last_sep == NULL);
-        } else {
-            if (!last_sep) {
-                is_direct_child = false;
-            } else {
-                size_t parent_len = last_sep - anc_id;
-                is_direct_child = (parent_len == parent_path_len &&
-                                   strncmp(anc_id, parent_path, parent_len) == 0);
-            }
+        if (!first) {
+            write_newline(w);
         }
+        first = false;
 
-        if (is_direct_child) {
-            if (!first) {
-                write_newline(w);
-            }
-            first = false;
-
-            /* Write the ancestor as a stub package */
-            const SysmlNode *anc_node = find_node_by_id(models, model_count, anc_id);
-            const char *local_name = get_local_name(anc_id);
+        /* Write the ancestor as a stub package */
+        const SysmlNode *anc_node = find_node_by_id(models, model_count, anc_id);
+        const char *local_name = get_local_name(anc_id);
 
-            write_indent(w);
+        write_indent(w);
 
-            /* Determine keyword based on node kind or default to package */
-            const char *keyword = "package";
-            if (anc_node) {
-                keyword = sysml2_kind_to_keyword(anc_node->kind);
-            }
-            fputs(keyword, w->out);
-
-            if (local_name) {
-                fputc(' ', w->out);
-                if (needs_quoting(local_name)) {
-                    fputc('\'', w->out);
-                    fputs(local_name, w->out);
-                    fputc('\'', w->out);
-                } else {
-                    fputs(local_name, w->out);
-                }
+        /* Determine keyword based on node kind or default to package */
+        const char *keyword = "package";
+        if (anc_node) {
+            keyword = sysml2_kind_to_keyword(anc_node->kind);
+        }
+        out_puts(w, keyword);
+
+        if (local_name) {
+            out_putc(w, ' ');
+            if (needs_quoting(local_name)) {
+                out_putc(w, '\'');
+                out_puts(w, local_name);
+                out_putc(w, '\'');
+            } else {
+                out_puts(w, local_name);
             }
+        }
 
-            fputs(" {", w->out);
-            write_newline(w);
-            w->indent_level++;
+        out_puts(w, " {");
+        write_newline(w);
+        w->indent_level++;
 
-            /* Recursively write children of this ancestor */
-            write_query_children(
-                w, result, models, model_count,
-                ancestors, ancestor_count,
-                anc_id, strlen(anc_id)
-            );
+        /* Recursively write children of this ancestor */
+        write_query_children(w, qx, models, model_count, anc_id, strlen(anc_id));
 
-            w->indent_level--;
-            write_indent(w);
-            fputc('}', w->out);
-            write_newline(w);
-        }
+        w->indent_level--;
+        write_indent(w);
+        out_putc(w, '}');
+        write_newline(w);
     }
 }
 
@@ -1877,18 +2062,33 @@ Sysml2Result sysml2_sysml_write_query(
     size_t ancestor_count = 0;
     sysml2_query_get_ancestors(result, models, model_count, arena, &ancestors, &ancestor_count);
 
-    Sysml2Writer w = {
-        .out = out,
-        .indent_level = 0,
-        .at_line_start = true
-    };
+    QueryIndex qindex;
+    if (!query_index_build(&qindex, result, ancestors, ancestor_count, arena)) {
+        return SYSML2_ERROR_OUT_OF_MEMORY;
+    }
+
+    /* Matched elements are written with the first model's structure */
+    WriterIndex index;
+    bool have_index = model_count > 0 && models && models[0];
+    if (have_index && !writer_index_build(&index, models[0])) {
+        writer_index_destroy(&index);
+        return SYSML2_ERROR_OUT_OF_MEMORY;
+    }
+
+    Sysml2Writer w;
+    writer_init(&w, have_index ? &index : NULL);
 
     /* Write hierarchical output starting from root (NULL parent) */
-    write_query_children(
-        &w, result, models, model_count,
-        ancestors, ancestor_count,
-        NULL, 0
-    );
+    write_query_children(&w, &qindex, models, model_count, NULL, 0);
 
-    return SYSML2_OK;
+    if (have_index) {
+        writer_index_destroy(&index);
+    }
+
+    Sysml2Result written = w.out.failed ? SYSML2_ERROR_OUT_OF_MEMORY : SYSML2_OK;
+    if (written == SYSML2_OK && w.out.length > 0) {
+        fwrite(w.out.data, 1, w.out.length, out);
+    }
+    writer_destroy(&w);
+    return written;
 }
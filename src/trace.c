@@ -0,0 +1,106 @@
+/*
+ * SysML v2 Parser - Trace Event Output Implementation
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "sysml2/trace.h"
+#include "sysml2/stats.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+/* Small per-thread ids in order of first event; the main thread is 1 */
+static _Thread_local unsigned thread_id;
+static unsigned next_thread_id;
+
+Sysml2Trace *sysml2_trace_open(const char *path) {
+    FILE *out = fopen(path, "w");
+    if (!out) return NULL;
+
+    Sysml2Trace *trace = malloc(sizeof(Sysml2Trace));
+    if (!trace) {
+        fclose(out);
+        return NULL;
+    }
+    trace->out = out;
+    trace->start_ns = sysml2_stats_wall_ns();
+    trace->event_count = 0;
+    pthread_mutex_init(&trace->lock, NULL);
+
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", out);
+    return trace;
+}
+
+Sysml2Result sysml2_trace_close(Sysml2Trace *trace) {
+    if (!trace) return SYSML2_OK;
+
+    fputs("\n]}\n", trace->out);
+    bool failed = ferror(trace->out) != 0;
+    if (fclose(trace->out) != 0) failed = true;
+
+    pthread_mutex_destroy(&trace->lock);
+    free(trace);
+    return failed ? SYSML2_ERROR_FILE_READ : SYSML2_OK;
+}
+
+static void write_string(FILE *out, const char *s) {
+    fputc('"', out);
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            fputc('\\', out);
+            fputc(c, out);
+        } else if (c < 0x20) {
+            fprintf(out, "\\u%04x", c);
+        } else {
+            fputc(c, out);
+        }
+    }
+    fputc('"', out);
+}
+
+/* Write one event; name and category are omitted for "E" */
+static void write_event(Sysml2Trace *trace, char phase, const char *category,
+                        const char *name, const char *detail) {
+    uint64_t now = sysml2_stats_wall_ns();
+
+    pthread_mutex_lock(&trace->lock);
+    if (thread_id == 0) thread_id = ++next_thread_id;
+
+    FILE *out = trace->out;
+    fputs(trace->event_count++ > 0 ? ",\n" : "\n", out);
+    fprintf(out, "{\"ph\":\"%c\",\"pid\":%ld,\"tid\":%u,\"ts\":%.3f",
+            phase, (long)getpid(), thread_id, (double)(now - trace->start_ns) / 1e3);
+    if (name) {
+        fputs(",\"cat\":", out);
+        write_string(out, category);
+        fputs(",\"name\":", out);
+        write_string(out, name);
+    }
+    if (phase == 'i') fputs(",\"s\":\"t\"", out);
+    if (detail) {
+        fputs(",\"args\":{\"detail\":", out);
+        write_string(out, detail);
+        fputc('}', out);
+    }
+    fputc('}', out);
+    pthread_mutex_unlock(&trace->lock);
+}
+
+void sysml2_trace_begin(Sysml2Trace *trace, const char *category,
+                        const char *name, const char *detail) {
+    if (!trace) return;
+    write_event(trace, 'B', category, name, detail);
+}
+
+void sysml2_trace_end(Sysml2Trace *trace) {
+    if (!trace) return;
+    write_event(trace, 'E', NULL, NULL, NULL);
+}
+
+void sysml2_trace_instant(Sysml2Trace *trace, const char *category,
+                          const char *name, const char *detail) {
+    if (!trace) return;
+    write_event(trace, 'i', category, name, detail);
+}
@@ -5,6 +5,7 @@
  */
 
 #include "sysml2/utils.h"
+#include "sysml2/memory_budget.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -13,37 +14,280 @@
 #include <dirent.h>
 #include <limits.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+/* Read an open descriptor to the end into a NUL-terminated malloc'd buffer */
+static char *read_fd(int fd, size_t size_hint, size_t *out_size) {
+    size_t capacity = size_hint + 1 > 4096 ? size_hint + 1 : 4096;
+    size_t length = 0;
+    char *content = malloc(capacity);
+    if (!content) return NULL;
+
+    for (;;) {
+        if (length + 1 == capacity) {
+            char *new_content = realloc(content, capacity * 2);
+            if (!new_content) {
+                free(content);
+                errno = ENOMEM;
+                return NULL;
+            }
+            content = new_content;
+            capacity *= 2;
+        }
+        ssize_t n = read(fd, content + length, capacity - length - 1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            int saved = errno;
+            free(content);
+            errno = saved;
+            return NULL;
+        }
+        if (n == 0) break;
+        length += (size_t)n;
+    }
+
+    content[length] = '\0';
+    if (out_size) *out_size = length;
+    return content;
+}
 
 char *sysml2_read_file(const char *path, size_t *out_size) {
-    FILE *file = fopen(path, "rb");
-    if (!file) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
         return NULL;
     }
 
-    fseek(file, 0, SEEK_END);
-    long size = ftell(file);
-    fseek(file, 0, SEEK_SET);
+    struct stat st;
+    size_t size_hint = 0;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        size_hint = (size_t)st.st_size;
+    }
 
-    if (size < 0) {
-        fclose(file);
-        return NULL;
+    char *content = read_fd(fd, size_hint, out_size);
+    int saved = errno;
+    close(fd);
+    errno = saved;
+    return content;
+}
+
+/* Map the size bytes of a regular file; false if they would not end in a zero byte */
+static bool map_regular_file(int fd, size_t size, Sysml2SourceBuffer *out) {
+    /* The zero-filled tail of the last page terminates the mapping */
+    long page_size = sysconf(_SC_PAGESIZE);
+    if (size == 0 || page_size <= 0 || size % (size_t)page_size == 0) return false;
+
+    void *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) return false;
+    out->data = data;
+    out->length = size;
+    out->mapped_size = size;
+    sysml2_memory_charge(size);
+    return true;
+}
+
+bool sysml2_source_open(const char *path, Sysml2SourceBuffer *out) {
+    memset(out, 0, sizeof(*out));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return false;
     }
 
-    char *content = malloc(size + 1);
+    size_t size = S_ISREG(st.st_mode) ? (size_t)st.st_size : 0;
+    if (map_regular_file(fd, size, out)) {
+        close(fd);
+        return true;
+    }
+
+    size_t length = 0;
+    char *content = read_fd(fd, size, &length);
+    int saved = errno;
+    close(fd);
     if (!content) {
-        fclose(file);
-        return NULL;
+        errno = saved;
+        return false;
     }
+    out->data = content;
+    out->length = length;
+    sysml2_memory_charge(length);
+    return true;
+}
 
-    size_t read = fread(content, 1, size, file);
-    fclose(file);
+/* Write all of data to fd */
+static bool write_all(int fd, const char *data, size_t length) {
+    while (length > 0) {
+        ssize_t n = write(fd, data, length);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        length -= (size_t)n;
+    }
+    return true;
+}
+
+/* Create an anonymous temporary file (already unlinked) */
+static int create_spool_file(void) {
+    const char *dir = getenv("TMPDIR");
+    if (!dir || !*dir) dir = "/tmp";
 
-    content[read] = '\0';
-    if (out_size) {
-        *out_size = read;
+    char path[PATH_MAX];
+    int written = snprintf(path, sizeof(path), "%s/sysml2-stdin-XXXXXX", dir);
+    if (written < 0 || (size_t)written >= sizeof(path)) {
+        errno = ENAMETOOLONG;
+        return -1;
     }
+    int fd = mkstemp(path);
+    if (fd >= 0) unlink(path);
+    return fd;
+}
 
-    return content;
+/* Copy buffer used once the head has been spooled */
+#define SPOOL_COPY_SIZE (64u * 1024)
+
+/*
+ * Move the head already read from fd into a temporary file, copy the
+ * rest of fd after it and map the whole file
+ *
+ * The head is freed as soon as it is written, so heap use drops to one
+ * small copy buffer while the rest of the input streams through.
+ */
+static bool spool_fd(int fd, char *head, size_t head_length, Sysml2SourceBuffer *out) {
+    int spool = create_spool_file();
+    if (spool < 0) {
+        int saved = errno;
+        free(head);
+        errno = saved;
+        return false;
+    }
+
+    bool ok = write_all(spool, head, head_length);
+    free(head);
+    char *copy = ok ? malloc(SPOOL_COPY_SIZE) : NULL;
+    if (ok && !copy) {
+        errno = ENOMEM;
+        ok = false;
+    }
+    size_t length = head_length;
+    while (ok) {
+        ssize_t n = read(fd, copy, SPOOL_COPY_SIZE);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            ok = false;
+            break;
+        }
+        if (n == 0) break;
+        ok = write_all(spool, copy, (size_t)n);
+        length += (size_t)n;
+    }
+    free(copy);
+
+    /* One byte past the end terminates the content, whatever its length */
+    if (ok) ok = ftruncate(spool, (off_t)length + 1) == 0;
+    void *data = MAP_FAILED;
+    if (ok) {
+        data = mmap(NULL, length + 1, PROT_READ, MAP_PRIVATE, spool, 0);
+        ok = data != MAP_FAILED;
+    }
+    int saved = errno;
+    close(spool);
+    if (!ok) {
+        errno = saved;
+        return false;
+    }
+
+    out->data = data;
+    out->length = length;
+    out->mapped_size = length + 1;
+    sysml2_memory_charge(length);
+    return true;
+}
+
+bool sysml2_source_read_fd(int fd, size_t spool_threshold, Sysml2SourceBuffer *out) {
+    memset(out, 0, sizeof(*out));
+
+    /* A redirected regular file read from its start maps like a path */
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && lseek(fd, 0, SEEK_CUR) == 0 &&
+        map_regular_file(fd, (size_t)st.st_size, out)) {
+        return true;
+    }
+
+    size_t capacity = 4096;
+    size_t length = 0;
+    char *content = malloc(capacity);
+    if (!content) return false;
+
+    for (;;) {
+        if (length + 1 == capacity) {
+            if (spool_threshold > 0 && length >= spool_threshold) {
+                return spool_fd(fd, content, length, out);
+            }
+            /* Never grow past the threshold: the buffer fills up to it
+             * exactly and is spooled then */
+            size_t new_capacity = capacity * 2;
+            if (spool_threshold > 0 && new_capacity > spool_threshold + 1) {
+                new_capacity = spool_threshold + 1;
+            }
+            char *new_content = realloc(content, new_capacity);
+            if (!new_content) {
+                free(content);
+                errno = ENOMEM;
+                return false;
+            }
+            content = new_content;
+            capacity = new_capacity;
+        }
+        ssize_t n = read(fd, content + length, capacity - length - 1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            int saved = errno;
+            free(content);
+            errno = saved;
+            return false;
+        }
+        if (n == 0) break;
+        length += (size_t)n;
+    }
+
+    content[length] = '\0';
+    out->data = content;
+    out->length = length;
+    sysml2_memory_charge(length);
+    return true;
+}
+
+void sysml2_read_ahead(const char *path) {
+#ifdef POSIX_FADV_WILLNEED
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return;
+    (void)posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+    close(fd);
+#else
+    (void)path;
+#endif
+}
+
+void sysml2_source_release(Sysml2SourceBuffer *buffer) {
+    if (!buffer || !buffer->data) return;
+    sysml2_memory_release(buffer->length);
+    if (buffer->mapped_size > 0) {
+        munmap((void *)buffer->data, buffer->mapped_size);
+    } else {
+        free((void *)buffer->data);
+    }
+    memset(buffer, 0, sizeof(*buffer));
 }
 
 char *sysml2_read_stdin(size_t *out_size) {
@@ -81,6 +325,28 @@ bool sysml2_is_directory(const char *path) {
     return stat(path, &st) == 0 && S_ISDIR(st.st_mode);
 }
 
+Sysml2EntryKind sysml2_dir_entry_kind(DIR *dir, const struct dirent *entry, bool *out_link) {
+    if (out_link) *out_link = entry->d_type == DT_LNK;
+    switch (entry->d_type) {
+        case DT_REG: return SYSML2_ENTRY_FILE;
+        case DT_DIR: return SYSML2_ENTRY_DIRECTORY;
+        case DT_LNK:
+        case DT_UNKNOWN: break;
+        default: return SYSML2_ENTRY_OTHER;
+    }
+
+    struct stat st;
+    if (fstatat(dirfd(dir), entry->d_name, &st, 0) != 0) return SYSML2_ENTRY_OTHER;
+    if (out_link && entry->d_type == DT_UNKNOWN) {
+        struct stat lst;
+        *out_link = fstatat(dirfd(dir), entry->d_name, &lst, AT_SYMLINK_NOFOLLOW) == 0 &&
+                    S_ISLNK(lst.st_mode);
+    }
+    if (S_ISREG(st.st_mode)) return SYSML2_ENTRY_FILE;
+    if (S_ISDIR(st.st_mode)) return SYSML2_ENTRY_DIRECTORY;
+    return SYSML2_ENTRY_OTHER;
+}
+
 char *sysml2_path_join(const char *dir, const char *name) {
     size_t dir_len = strlen(dir);
     size_t name_len = strlen(name);
@@ -107,12 +373,15 @@ char *sysml2_get_realpath(const char *path) {
 }
 
 uint32_t *sysml2_build_line_offsets(const char *content, size_t length, uint32_t *out_count) {
+    if (length > UINT32_MAX) return NULL;
+
     /* Count lines first */
     uint32_t count = 1;
-    for (size_t i = 0; i < length; i++) {
-        if (content[i] == '\n') {
-            count++;
-        }
+    const char *end = content + length;
+    for (const char *p = content; p < end; p++) {
+        p = memchr(p, '\n', (size_t)(end - p));
+        if (!p) break;
+        count++;
     }
 
     uint32_t *offsets = malloc(count * sizeof(uint32_t));
@@ -122,16 +391,155 @@ uint32_t *sysml2_build_line_offsets(const char *content, size_t length, uint32_t
 
     offsets[0] = 0;
     uint32_t line = 1;
-    for (size_t i = 0; i < length; i++) {
-        if (content[i] == '\n' && line < count) {
-            offsets[line++] = i + 1;
-        }
+    for (const char *p = content; p < end; p++) {
+        p = memchr(p, '\n', (size_t)(end - p));
+        if (!p) break;
+        offsets[line++] = (uint32_t)(p - content) + 1;
     }
 
     *out_count = count;
     return offsets;
 }
 
+uint32_t sysml2_line_index_find(const uint32_t *offsets, uint32_t count, size_t offset) {
+    /* Last line starting at or before offset */
+    uint32_t low = 0;
+    uint32_t high = count;
+    while (high - low > 1) {
+        uint32_t mid = low + (high - low) / 2;
+        if (offsets[mid] <= offset) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+/* ========== Bounded Edit Distance ========== */
+
+static uint64_t char_mask(const char *text, size_t length) {
+    uint64_t mask = 0;
+    for (size_t i = 0; i < length; i++) {
+        mask |= (uint64_t)1 << ((unsigned char)text[i] & 63);
+    }
+    return mask;
+}
+
+static unsigned popcount64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_popcountll(x);
+#else
+    unsigned count = 0;
+    for (; x; x &= x - 1) count++;
+    return count;
+#endif
+}
+
+void sysml2_edit_pattern_init(Sysml2EditPattern *pattern, const char *text, size_t length) {
+    pattern->text = text;
+    pattern->length = length;
+    pattern->char_mask = char_mask(text, length);
+    if (length > SYSML2_EDIT_PATTERN_MAX) return;
+
+    memset(pattern->peq, 0, sizeof(pattern->peq));
+    for (size_t i = 0; i < length; i++) {
+        pattern->peq[(unsigned char)text[i]] |= (uint64_t)1 << i;
+    }
+}
+
+/*
+ * Myers' algorithm in Hyyro's formulation for global distance: the
+ * vertical deltas of the current column of the DP matrix are kept as
+ * bit vectors, and the score tracks the bottom cell.
+ */
+static size_t myers_distance(const Sysml2EditPattern *pattern,
+                             const char *text, size_t length, size_t max_dist) {
+    uint64_t pv = ~(uint64_t)0;
+    uint64_t mv = 0;
+    uint64_t high = (uint64_t)1 << (pattern->length - 1);
+    size_t score = pattern->length;
+
+    for (size_t j = 0; j < length; j++) {
+        uint64_t eq = pattern->peq[(unsigned char)text[j]];
+        uint64_t xv = eq | mv;
+        uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        uint64_t ph = mv | ~(xh | pv);
+        uint64_t mh = pv & xh;
+
+        if (ph & high) {
+            score++;
+        } else if (mh & high) {
+            score--;
+        }
+
+        /* Row 0 of the matrix grows by one per column */
+        ph = (ph << 1) | 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+
+        /* Each remaining byte can lower the score by at most one */
+        if (score > max_dist + (length - j - 1)) return max_dist + 1;
+    }
+    return score <= max_dist ? score : max_dist + 1;
+}
+
+/* Two-row dynamic program for patterns too long for one word */
+static size_t dp_distance(const Sysml2EditPattern *pattern,
+                          const char *text, size_t length, size_t max_dist) {
+    const char *p = pattern->text;
+    size_t m = pattern->length;
+    size_t *prev = malloc((length + 1) * sizeof(size_t));
+    size_t *curr = malloc((length + 1) * sizeof(size_t));
+    size_t result = max_dist + 1;
+    if (!prev || !curr) goto done;
+
+    for (size_t j = 0; j <= length; j++) prev[j] = j;
+
+    for (size_t i = 1; i <= m; i++) {
+        curr[0] = i;
+        size_t row_min = i;
+        for (size_t j = 1; j <= length; j++) {
+            size_t best = prev[j - 1] + (p[i - 1] == text[j - 1] ? 0 : 1);
+            if (prev[j] + 1 < best) best = prev[j] + 1;
+            if (curr[j - 1] + 1 < best) best = curr[j - 1] + 1;
+            curr[j] = best;
+            if (best < row_min) row_min = best;
+        }
+        /* Distances never fall below a row's minimum */
+        if (row_min > max_dist) goto done;
+
+        size_t *tmp = prev;
+        prev = curr;
+        curr = tmp;
+    }
+    if (prev[length] <= max_dist) result = prev[length];
+
+done:
+    free(prev);
+    free(curr);
+    return result;
+}
+
+size_t sysml2_edit_distance_bounded(const Sysml2EditPattern *pattern,
+                                    const char *text, size_t length, size_t max_dist) {
+    size_t m = pattern->length;
+    size_t diff = m > length ? m - length : length - m;
+    if (diff > max_dist) return max_dist + 1;
+    if (m == 0) return length;
+    if (length == 0) return m;
+
+    /* Every byte class present on one side only costs at least one edit */
+    uint64_t mask = char_mask(text, length);
+    unsigned only_pattern = popcount64(pattern->char_mask & ~mask);
+    unsigned only_text = popcount64(mask & ~pattern->char_mask);
+    if ((only_pattern > only_text ? only_pattern : only_text) > max_dist) return max_dist + 1;
+
+    if (m <= SYSML2_EDIT_PATTERN_MAX) return myers_distance(pattern, text, length, max_dist);
+    return dp_distance(pattern, text, length, max_dist);
+}
+
 /* ========== Recursive Directory Traversal ========== */
 
 /* Inode tracking to detect symlink cycles */
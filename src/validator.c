@@ -12,6 +12,7 @@
 #include <limits.h>
 #include <errno.h>
 #include <stdint.h>
+#include <pthread.h>
 
 /* Symbol table implementation is now in symtab.c */
 
@@ -216,7 +217,52 @@ bool sysml2_is_type_compatible(SysmlNodeKind usage_kind, SysmlNodeKind def_kind)
     }
 }
 
-/* ========== Validation Passes ========== */
+/* ========== Type Hierarchy Cache ========== */
+
+/*
+ * Per-validation cache of resolved type references, shared by passes
+ * 2, 3, 5 and 7. Each node's typed_by and specializes references are
+ * resolved once; subtype and inherited-feature queries are memoized per
+ * (type node, name). The symbol table is complete after pass 1, so
+ * entries never go stale within a run.
+ */
+
+/* Resolved direct bases of one node */
+typedef struct {
+    const SysmlNode *node;
+    Sysml2Symbol **bases;       /* typed_by then specializes; NULL if unresolved */
+} TypeInfo;
+
+typedef enum {
+    TYPE_MEMO_EMPTY = 0,
+    TYPE_MEMO_BUSY,             /* Being computed (guards against cycles) */
+    TYPE_MEMO_DONE
+} TypeMemoState;
+
+/* Memoized answer for one (type node, name) query */
+typedef struct {
+    const SysmlNode *node;
+    const char *name;
+    uint32_t hash;
+    TypeMemoState state;
+    bool subtype;               /* Subtype memo: name is among node's supertypes */
+    SysmlNode *feature;         /* Feature memo: inherited feature, NULL if none */
+} TypeMemo;
+
+typedef struct {
+    TypeMemo *slots;
+    size_t count;
+    size_t capacity;
+} TypeMemoTable;
+
+typedef struct {
+    Sysml2Arena *arena;
+    TypeInfo *infos;
+    size_t info_count;
+    size_t info_capacity;
+    TypeMemoTable subtypes;
+    TypeMemoTable features;
+} TypeCache;
 
 /* Context for validation passes */
 typedef struct {
@@ -224,9 +270,129 @@ typedef struct {
     Sysml2DiagContext *diag_ctx;
     const Sysml2SourceFile *source_file;
     const Sysml2ValidationOptions *options;
+    TypeCache *types;
     bool has_errors;
+    size_t duplicate_count;     /* Duplicates met by pass 1, reported or not */
 } ValidationContext;
 
+static void type_cache_init(TypeCache *tc, Sysml2Arena *arena) {
+    memset(tc, 0, sizeof(*tc));
+    tc->arena = arena;
+}
+
+static bool type_infos_grow(TypeCache *tc) {
+    size_t new_capacity = tc->info_capacity ? tc->info_capacity * 2 : 256;
+    TypeInfo *infos = sysml2_arena_calloc(tc->arena, new_capacity, sizeof(TypeInfo));
+    if (!infos) return false;
+    for (size_t i = 0; i < tc->info_capacity; i++) {
+        const SysmlNode *node = tc->infos[i].node;
+        if (!node) continue;
+        size_t pos = sysml2_id_hash(node->id) & (new_capacity - 1);
+        while (infos[pos].node) pos = (pos + 1) & (new_capacity - 1);
+        infos[pos] = tc->infos[i];
+    }
+    tc->infos = infos;
+    tc->info_capacity = new_capacity;
+    return true;
+}
+
+/*
+ * Get a node's resolved direct bases, resolving them on first use
+ *
+ * References are resolved from the node's owning scope, in the order
+ * typed_by then specializes. Returns NULL only when out of memory.
+ */
+static Sysml2Symbol **type_bases(ValidationContext *vctx, const SysmlNode *node) {
+    TypeCache *tc = vctx->types;
+    if (tc->info_capacity) {
+        size_t pos = sysml2_id_hash(node->id) & (tc->info_capacity - 1);
+        while (tc->infos[pos].node) {
+            if (tc->infos[pos].node == node) return tc->infos[pos].bases;
+            pos = (pos + 1) & (tc->info_capacity - 1);
+        }
+    }
+
+    size_t count = node->typed_by_count + node->specializes_count;
+    Sysml2Symbol **bases = sysml2_arena_calloc(tc->arena, count ? count : 1, sizeof(Sysml2Symbol *));
+    if (!bases) return NULL;
+
+    Sysml2Scope *scope = sysml2_symtab_get_or_create_node_scope(vctx->symtab, node);
+    for (size_t i = 0; i < node->typed_by_count; i++) {
+        bases[i] = sysml2_symtab_resolve(vctx->symtab, scope, node->typed_by[i]);
+    }
+    for (size_t i = 0; i < node->specializes_count; i++) {
+        bases[node->typed_by_count + i] = sysml2_symtab_resolve(
+            vctx->symtab, scope, node->specializes[i]);
+    }
+
+    if ((tc->info_count + 1) * 2 > tc->info_capacity && !type_infos_grow(tc)) {
+        return bases;
+    }
+    size_t pos = sysml2_id_hash(node->id) & (tc->info_capacity - 1);
+    while (tc->infos[pos].node) pos = (pos + 1) & (tc->info_capacity - 1);
+    tc->infos[pos] = (TypeInfo){ .node = node, .bases = bases };
+    tc->info_count++;
+    return bases;
+}
+
+/* Name of a node's i-th base reference (same order as type_bases) */
+static const char *type_base_ref(const SysmlNode *node, size_t i) {
+    return i < node->typed_by_count
+        ? node->typed_by[i]
+        : node->specializes[i - node->typed_by_count];
+}
+
+static uint32_t type_memo_hash(const SysmlNode *node, const char *name) {
+    return sysml2_id_hash(node->id) ^ sysml2_hash_string(name, strlen(name));
+}
+
+static TypeMemo *type_memo_find(TypeMemoTable *t, const SysmlNode *node, const char *name, uint32_t hash) {
+    if (!t->capacity) return NULL;
+    size_t pos = hash & (t->capacity - 1);
+    while (t->slots[pos].node) {
+        TypeMemo *m = &t->slots[pos];
+        if (m->node == node && m->hash == hash &&
+            (m->name == name || strcmp(m->name, name) == 0)) {
+            return m;
+        }
+        pos = (pos + 1) & (t->capacity - 1);
+    }
+    return NULL;
+}
+
+/*
+ * Get or add the memo for (node, name)
+ *
+ * The returned pointer is only valid until the next insertion.
+ */
+static TypeMemo *type_memo_get(TypeCache *tc, TypeMemoTable *t, const SysmlNode *node, const char *name) {
+    uint32_t hash = type_memo_hash(node, name);
+    TypeMemo *m = type_memo_find(t, node, name, hash);
+    if (m) return m;
+
+    if ((t->count + 1) * 2 > t->capacity) {
+        size_t new_capacity = t->capacity ? t->capacity * 2 : 256;
+        TypeMemo *slots = sysml2_arena_calloc(tc->arena, new_capacity, sizeof(TypeMemo));
+        if (!slots) return NULL;
+        for (size_t i = 0; i < t->capacity; i++) {
+            if (!t->slots[i].node) continue;
+            size_t pos = t->slots[i].hash & (new_capacity - 1);
+            while (slots[pos].node) pos = (pos + 1) & (new_capacity - 1);
+            slots[pos] = t->slots[i];
+        }
+        t->slots = slots;
+        t->capacity = new_capacity;
+    }
+
+    size_t pos = hash & (t->capacity - 1);
+    while (t->slots[pos].node) pos = (pos + 1) & (t->capacity - 1);
+    t->slots[pos] = (TypeMemo){ .node = node, .name = name, .hash = hash };
+    t->count++;
+    return &t->slots[pos];
+}
+
+/* ========== Validation Passes ========== */
+
 /* Pass 1: Build symbol table and detect duplicates */
 static void pass1_build_symtab(
     ValidationContext *vctx,
@@ -234,11 +400,13 @@ static void pass1_build_symtab(
 ) {
     for (size_t i = 0; i < model->element_count; i++) {
         SysmlNode *node = model->elements[i];
-        if (!node->name) continue; /* Skip anonymous elements */
 
-        /* Get or create scope from parent_id */
-        Sysml2Scope *scope = sysml2_symtab_get_or_create_scope(
-            vctx->symtab, node->parent_id);
+        /* Get or create scope from parent_id. Every element's scope is
+         * created here, anonymous ones included, so the later passes
+         * never add scopes and can share the table read-only. */
+        Sysml2Scope *scope = sysml2_symtab_get_or_create_node_scope(
+            vctx->symtab, node);
+        if (!node->name) continue; /* Skip anonymous elements */
 
         /* Try to add symbol */
         Sysml2Symbol *existing = sysml2_symtab_lookup(scope, node->name);
@@ -256,6 +424,7 @@ static void pass1_build_symtab(
 
             if (!is_package_merge) {
                 /* Genuine duplicate — not a package merge */
+                vctx->duplicate_count++;
                 if (vctx->options->check_duplicate_names) {
                     char msg[256];
                     snprintf(msg, sizeof(msg),
@@ -271,7 +440,7 @@ static void pass1_build_symtab(
                         SYSML2_SEVERITY_ERROR,
                         vctx->source_file,
                         range,
-                        sysml2_intern(vctx->symtab->intern, msg)
+                        msg
                     );
 
                     if (existing->node) {
@@ -286,7 +455,7 @@ static void pass1_build_symtab(
 
                         sysml2_diag_add_note(diag, vctx->diag_ctx,
                             vctx->source_file, prev_range,
-                            sysml2_intern(vctx->symtab->intern, note_msg));
+                            note_msg);
                     }
 
                     sysml2_diag_emit(vctx->diag_ctx, diag);
@@ -310,14 +479,8 @@ static void pass1_build_symtab(
         SysmlNode *node = model->elements[i];
         if (node->kind == SYSML_KIND_LIBRARY_PACKAGE && node->id) {
             /* Add implicit import entry to root scope */
-            Sysml2Scope *root = vctx->symtab->root_scope;
-            Sysml2ImportEntry *entry = sysml2_arena_alloc(vctx->symtab->arena, sizeof(Sysml2ImportEntry));
-            if (entry) {
-                entry->target = node->id;
-                entry->import_kind = SYSML_KIND_IMPORT_ALL;
-                entry->next = root->imports;
-                root->imports = entry;
-            }
+            sysml2_symtab_add_import(vctx->symtab, vctx->symtab->root_scope,
+                node->id, SYSML_KIND_IMPORT_ALL);
         }
     }
 
@@ -327,290 +490,537 @@ static void pass1_build_symtab(
         Sysml2Scope *scope = sysml2_symtab_get_or_create_scope(
             vctx->symtab, imp->owner_scope);
 
-        /* Create import entry and add to scope's import list */
-        Sysml2ImportEntry *entry = sysml2_arena_alloc(vctx->symtab->arena, sizeof(Sysml2ImportEntry));
-        if (entry) {
-            entry->target = imp->target;
-            entry->import_kind = imp->kind;
-            entry->next = scope->imports;
-            scope->imports = entry;
-        }
+        /* Add to scope's import list */
+        sysml2_symtab_add_import(vctx->symtab, scope, imp->target, imp->kind);
     }
 }
 
-/* Pass 2: Resolve types and check compatibility */
-static void pass2_resolve_types(
+/* Pass 2 on one typed element */
+static void check_types(
     ValidationContext *vctx,
-    const SysmlSemanticModel *model
+    SysmlNode *node,
+    Sysml2Scope *scope,
+    Sysml2Symbol **bases
 ) {
-    for (size_t i = 0; i < model->element_count; i++) {
-        SysmlNode *node = model->elements[i];
-        if (node->typed_by_count == 0) continue;
-
-        /* Get scope for this element */
-        Sysml2Scope *scope = sysml2_symtab_get_or_create_scope(
-            vctx->symtab, node->parent_id);
+    for (size_t j = 0; j < node->typed_by_count; j++) {
+        const char *type_ref = node->typed_by[j];
 
-        for (size_t j = 0; j < node->typed_by_count; j++) {
-            const char *type_ref = node->typed_by[j];
+        /* Try to resolve the type */
+        Sysml2Symbol *type_sym = bases ? bases[j] : sysml2_symtab_resolve(
+            vctx->symtab, scope, type_ref);
 
-            /* Try to resolve the type */
-            Sysml2Symbol *type_sym = sysml2_symtab_resolve(
-                vctx->symtab, scope, type_ref);
+        if (!type_sym) {
+            /* E3001: Undefined type */
+            if (vctx->options->check_undefined_types) {
+                char msg[256];
+                snprintf(msg, sizeof(msg),
+                    "undefined type '%s'", type_ref);
 
-            if (!type_sym) {
-                /* E3001: Undefined type */
-                if (vctx->options->check_undefined_types) {
-                    char msg[256];
-                    snprintf(msg, sizeof(msg),
-                        "undefined type '%s'", type_ref);
+                Sysml2SourceRange range = SYSML2_RANGE_INVALID;
+                range.start = node->loc;
+                range.end = node->loc;
 
-                    Sysml2SourceRange range = SYSML2_RANGE_INVALID;
-                    range.start = node->loc;
-                    range.end = node->loc;
+                Sysml2Diagnostic *diag = sysml2_diag_create(
+                    vctx->diag_ctx,
+                    SYSML2_DIAG_E3001_UNDEFINED_TYPE,
+                    SYSML2_SEVERITY_ERROR,
+                    vctx->source_file,
+                    range,
+                    msg
+                );
 
-                    Sysml2Diagnostic *diag = sysml2_diag_create(
-                        vctx->diag_ctx,
-                        SYSML2_DIAG_E3001_UNDEFINED_TYPE,
-                        SYSML2_SEVERITY_ERROR,
-                        vctx->source_file,
-                        range,
-                        sysml2_intern(vctx->symtab->intern, msg)
-                    );
+                /* Add suggestions if enabled */
+                if (vctx->options->suggest_corrections) {
+                    const char *suggestions[8];
+                    size_t count = sysml2_symtab_find_similar(
+                        vctx->symtab, scope, type_ref,
+                        suggestions, vctx->options->max_suggestions);
 
-                    /* Add suggestions if enabled */
-                    if (vctx->options->suggest_corrections) {
-                        const char *suggestions[8];
-                        size_t count = sysml2_symtab_find_similar(
-                            vctx->symtab, scope, type_ref,
-                            suggestions, vctx->options->max_suggestions);
-
-                        if (count > 0) {
-                            char help[512];
-                            snprintf(help, sizeof(help), "did you mean '%s'?", suggestions[0]);
-                            sysml2_diag_add_help(diag, vctx->diag_ctx,
-                                sysml2_intern(vctx->symtab->intern, help));
-                        } else {
-                            sysml2_diag_add_help(diag, vctx->diag_ctx,
-                                sysml2_intern(vctx->symtab->intern,
-                                    "define this type before use, or add an import for the package that defines it"));
-                        }
+                    if (count > 0) {
+                        char help[512];
+                        snprintf(help, sizeof(help), "did you mean '%s'?", suggestions[0]);
+                        sysml2_diag_add_help(diag, vctx->diag_ctx,
+                            help);
+                    } else {
+                        sysml2_diag_add_help(diag, vctx->diag_ctx,
+                            "define this type before use, or add an import for the package that defines it");
                     }
-
-                    sysml2_diag_emit(vctx->diag_ctx, diag);
-                    vctx->has_errors = true;
                 }
-            } else if (vctx->options->check_type_compatibility && type_sym->node) {
-                /* E3006: Type compatibility check */
-                if (!sysml2_is_type_compatible(node->kind, type_sym->node->kind)) {
-                    char msg[256];
-                    snprintf(msg, sizeof(msg),
-                        "'%s' cannot be typed by '%s' (%s)",
-                        node->name ? node->name : "<anonymous>",
-                        type_ref,
-                        sysml2_kind_to_string(type_sym->node->kind));
 
-                    Sysml2SourceRange range = SYSML2_RANGE_INVALID;
-                    range.start = node->loc;
-                    range.end = node->loc;
+                sysml2_diag_emit(vctx->diag_ctx, diag);
+                vctx->has_errors = true;
+            }
+        } else if (vctx->options->check_type_compatibility && type_sym->node) {
+            /* E3006: Type compatibility check */
+            if (!sysml2_is_type_compatible(node->kind, type_sym->node->kind)) {
+                char msg[256];
+                snprintf(msg, sizeof(msg),
+                    "'%s' cannot be typed by '%s' (%s)",
+                    node->name ? node->name : "<anonymous>",
+                    type_ref,
+                    sysml2_kind_to_string(type_sym->node->kind));
 
-                    Sysml2Diagnostic *diag = sysml2_diag_create(
-                        vctx->diag_ctx,
-                        SYSML2_DIAG_E3006_TYPE_MISMATCH,
-                        SYSML2_SEVERITY_ERROR,
-                        vctx->source_file,
-                        range,
-                        sysml2_intern(vctx->symtab->intern, msg)
-                    );
+                Sysml2SourceRange range = SYSML2_RANGE_INVALID;
+                range.start = node->loc;
+                range.end = node->loc;
 
-                    sysml2_diag_emit(vctx->diag_ctx, diag);
-                    vctx->has_errors = true;
-                }
+                Sysml2Diagnostic *diag = sysml2_diag_create(
+                    vctx->diag_ctx,
+                    SYSML2_DIAG_E3006_TYPE_MISMATCH,
+                    SYSML2_SEVERITY_ERROR,
+                    vctx->source_file,
+                    range,
+                    msg
+                );
+
+                sysml2_diag_emit(vctx->diag_ctx, diag);
+                vctx->has_errors = true;
             }
         }
     }
 }
 
-/* DFS state for cycle detection */
+/* Pass 2: Resolve types and check compatibility */
+static void pass2_resolve_types(
+    ValidationContext *vctx,
+    const SysmlSemanticModel *model,
+    size_t begin,
+    size_t end
+) {
+    for (size_t i = begin; i < end; i++) {
+        SysmlNode *node = model->elements[i];
+        if (node->typed_by_count == 0) continue;
+
+        /* Get scope for this element */
+        Sysml2Scope *scope = sysml2_symtab_get_or_create_node_scope(
+            vctx->symtab, node);
+        check_types(vctx, node, scope, type_bases(vctx, node));
+    }
+}
+
+/*
+ * Cycle detection works on the resolved type graph: one vertex per
+ * element ID, one edge per typed_by/specializes/references target.
+ * Tarjan's algorithm finds the strongly connected components in a single
+ * traversal; every element of a component with more than one vertex (or
+ * a self-edge) lies on a cycle.
+ */
+
+/* Elements printed per half of a cycle note before eliding the rest */
+#define CYCLE_NOTE_MAX_STEPS 32
+
+#define CYCLE_NONE SIZE_MAX
+
+typedef struct {
+    SysmlNode *node;
+    size_t edge_start;          /* First successor in CycleGraph.edges */
+    size_t edge_count;
+    size_t index;               /* DFS discovery order, CYCLE_NONE if unvisited */
+    size_t lowlink;
+    size_t root;                /* Component root, CYCLE_NONE while on the stack */
+    size_t to_root;             /* Next vertex on a shortest path to the root */
+    size_t from_root;           /* Previous vertex on a shortest path from the root */
+    size_t local;               /* Position within its component (scratch) */
+    bool on_stack;
+    bool cyclic;
+} CycleVertex;
+
 typedef struct {
-    const char **stack;
+    size_t vertex;
+    size_t next_edge;
+} CycleFrame;
+
+typedef struct {
+    CycleVertex *vertices;
+    size_t vertex_count;
+    size_t vertex_capacity;
+
+    size_t *slots;              /* Vertex index + 1 per slot, 0 = empty */
+    size_t slot_capacity;
+
+    size_t *edges;
+    size_t edge_count;
+    size_t edge_capacity;
+
+    size_t *stack;              /* Tarjan component stack */
     size_t stack_count;
     size_t stack_capacity;
-    const char **visited;
-    size_t visited_count;
-    size_t visited_capacity;
-} CycleDetector;
-
-static void cycle_detector_init(CycleDetector *cd, Sysml2Arena *arena) {
-    cd->stack_capacity = 64;
-    cd->stack_count = 0;
-    cd->stack = sysml2_arena_alloc(arena, cd->stack_capacity * sizeof(const char *));
-
-    cd->visited_capacity = 256;
-    cd->visited_count = 0;
-    cd->visited = sysml2_arena_alloc(arena, cd->visited_capacity * sizeof(const char *));
-}
 
-static bool cycle_in_stack(CycleDetector *cd, const char *id) {
-    for (size_t i = 0; i < cd->stack_count; i++) {
-        if (strcmp(cd->stack[i], id) == 0) return true;
-    }
-    return false;
+    CycleFrame *frames;         /* Explicit DFS call stack */
+    size_t frame_count;
+    size_t frame_capacity;
+
+    size_t next_index;
+    bool failed;                /* Allocation failure, results incomplete */
+} CycleGraph;
+
+static bool cycle_reserve(void **items, size_t *capacity, size_t needed, size_t item_size) {
+    if (needed <= *capacity) return true;
+    size_t new_capacity = *capacity ? *capacity * 2 : 64;
+    while (new_capacity < needed) new_capacity *= 2;
+    void *grown = realloc(*items, new_capacity * item_size);
+    if (!grown) return false;
+    *items = grown;
+    *capacity = new_capacity;
+    return true;
 }
 
-static bool cycle_is_visited(CycleDetector *cd, const char *id) {
-    for (size_t i = 0; i < cd->visited_count; i++) {
-        if (strcmp(cd->visited[i], id) == 0) return true;
-    }
-    return false;
+static void cycle_graph_destroy(CycleGraph *g) {
+    free(g->vertices);
+    free(g->slots);
+    free(g->edges);
+    free(g->stack);
+    free(g->frames);
 }
 
-static void cycle_push(CycleDetector *cd, const char *id) {
-    if (cd->stack_count < cd->stack_capacity) {
-        cd->stack[cd->stack_count++] = id;
+static bool cycle_graph_rehash(CycleGraph *g, size_t new_capacity) {
+    size_t *slots = calloc(new_capacity, sizeof(size_t));
+    if (!slots) return false;
+    for (size_t v = 0; v < g->vertex_count; v++) {
+        size_t pos = sysml2_id_hash(g->vertices[v].node->id) & (new_capacity - 1);
+        while (slots[pos]) pos = (pos + 1) & (new_capacity - 1);
+        slots[pos] = v + 1;
     }
+    free(g->slots);
+    g->slots = slots;
+    g->slot_capacity = new_capacity;
+    return true;
 }
 
-static void cycle_pop(CycleDetector *cd) {
-    if (cd->stack_count > 0) {
-        cd->stack_count--;
+static size_t cycle_graph_find(const CycleGraph *g, const char *id) {
+    if (!g->slot_capacity) return CYCLE_NONE;
+    size_t pos = sysml2_id_hash(id) & (g->slot_capacity - 1);
+    while (g->slots[pos]) {
+        size_t v = g->slots[pos] - 1;
+        if (sysml2_id_eq(g->vertices[v].node->id, id)) return v;
+        pos = (pos + 1) & (g->slot_capacity - 1);
     }
+    return CYCLE_NONE;
 }
 
-static void cycle_mark_visited(CycleDetector *cd, const char *id) {
-    if (cd->visited_count < cd->visited_capacity) {
-        cd->visited[cd->visited_count++] = id;
+/* Get or add the vertex for a node, keyed by its interned ID */
+static size_t cycle_graph_vertex(CycleGraph *g, SysmlNode *node) {
+    size_t v = cycle_graph_find(g, node->id);
+    if (v != CYCLE_NONE) return v;
+
+    if ((g->vertex_count + 1) * 2 > g->slot_capacity &&
+        !cycle_graph_rehash(g, g->slot_capacity ? g->slot_capacity * 2 : 128)) {
+        g->failed = true;
+        return CYCLE_NONE;
+    }
+    if (!cycle_reserve((void **)&g->vertices, &g->vertex_capacity,
+                       g->vertex_count + 1, sizeof(CycleVertex))) {
+        g->failed = true;
+        return CYCLE_NONE;
     }
+
+    v = g->vertex_count++;
+    g->vertices[v] = (CycleVertex){
+        .node = node,
+        .index = CYCLE_NONE,
+        .root = CYCLE_NONE,
+        .to_root = CYCLE_NONE,
+        .from_root = CYCLE_NONE,
+    };
+
+    size_t pos = sysml2_id_hash(node->id) & (g->slot_capacity - 1);
+    while (g->slots[pos]) pos = (pos + 1) & (g->slot_capacity - 1);
+    g->slots[pos] = v + 1;
+    return v;
 }
 
-/* Build cycle path string */
-static const char *build_cycle_path(
-    CycleDetector *cd,
-    const char *cycle_start,
-    Sysml2Arena *arena
+static void cycle_add_edges(
+    ValidationContext *vctx,
+    CycleGraph *g,
+    Sysml2Scope *scope,
+    const char **refs,
+    Sysml2Symbol **resolved,
+    size_t ref_count
 ) {
-    /* Find start of cycle in stack */
-    size_t start_idx = 0;
-    for (size_t i = 0; i < cd->stack_count; i++) {
-        if (strcmp(cd->stack[i], cycle_start) == 0) {
-            start_idx = i;
-            break;
+    for (size_t i = 0; i < ref_count; i++) {
+        Sysml2Symbol *sym = resolved ? resolved[i]
+            : sysml2_symtab_resolve(vctx->symtab, scope, refs[i]);
+        if (!sym || !sym->node || !sym->node->id) continue;
+
+        size_t w = cycle_graph_vertex(g, sym->node);
+        if (w == CYCLE_NONE ||
+            !cycle_reserve((void **)&g->edges, &g->edge_capacity,
+                           g->edge_count + 1, sizeof(size_t))) {
+            g->failed = true;
+            return;
         }
+        g->edges[g->edge_count++] = w;
     }
+}
 
-    /* Calculate required buffer size */
-    size_t buf_size = 0;
-    for (size_t i = start_idx; i < cd->stack_count; i++) {
-        buf_size += strlen(cd->stack[i]) + 4; /* " -> " */
+/* Resolve a vertex's outgoing edges and push it on both stacks */
+static bool cycle_visit(ValidationContext *vctx, CycleGraph *g, size_t v) {
+    if (!cycle_reserve((void **)&g->stack, &g->stack_capacity,
+                       g->stack_count + 1, sizeof(size_t)) ||
+        !cycle_reserve((void **)&g->frames, &g->frame_capacity,
+                       g->frame_count + 1, sizeof(CycleFrame))) {
+        g->failed = true;
+        return false;
     }
-    buf_size += strlen(cycle_start) + 1;
 
-    char *buf = sysml2_arena_alloc(arena, buf_size);
-    buf[0] = '\0';
+    SysmlNode *node = g->vertices[v].node;
+    Sysml2Scope *scope = sysml2_symtab_get_or_create_node_scope(
+        vctx->symtab, node);
 
-    for (size_t i = start_idx; i < cd->stack_count; i++) {
-        strcat(buf, cd->stack[i]);
-        strcat(buf, " -> ");
-    }
-    strcat(buf, cycle_start);
+    size_t edge_start = g->edge_count;
 
-    return buf;
+    /* NOTE: We intentionally SKIP redefines references (:>>) for cycle detection.
+     * Redefinitions are OVERRIDES that narrow inherited features, not type cycles.
+     * Example: attribute :>> unitConversion redefines parent's unitConversion -
+     * this is valid inheritance, not a circular dependency.
+     * See SysML v2 spec: redefinitions allow child types to specialize/narrow
+     * features inherited from parent types without creating cycles. */
+    Sysml2Symbol **bases = type_bases(vctx, node);
+    cycle_add_edges(vctx, g, scope, node->typed_by,
+        bases, node->typed_by_count);
+    cycle_add_edges(vctx, g, scope, node->specializes,
+        bases ? bases + node->typed_by_count : NULL, node->specializes_count);
+    cycle_add_edges(vctx, g, scope, node->references,
+        NULL, node->references_count);
+    if (g->failed) return false;
+
+    CycleVertex *vx = &g->vertices[v];
+    vx->edge_start = edge_start;
+    vx->edge_count = g->edge_count - edge_start;
+    vx->index = vx->lowlink = g->next_index++;
+    vx->on_stack = true;
+
+    g->stack[g->stack_count++] = v;
+    g->frames[g->frame_count++] = (CycleFrame){ .vertex = v, .next_edge = 0 };
+    return true;
 }
 
-/* Check for cycles starting from a node */
-static bool check_cycles_from_node(
-    ValidationContext *vctx,
-    CycleDetector *cd,
-    SysmlNode *node
-) {
-    if (!node->id) return false;
-    if (cycle_is_visited(cd, node->id)) return false;
-
-    if (cycle_in_stack(cd, node->id)) {
-        /* Cycle detected! */
-        if (vctx->options->check_circular_specs) {
-            const char *cycle_path = build_cycle_path(cd, node->id, vctx->symtab->arena);
+/*
+ * Record shortest paths to and from the component root for each member
+ * of a cyclic component (members = stack[first..stack_count)), so every
+ * member's note can show a concrete cycle without another search.
+ */
+static bool cycle_record_paths(CycleGraph *g, size_t first) {
+    size_t r = g->stack[first];
+    size_t count = g->stack_count - first;
+    size_t *members = &g->stack[first];
 
-            char msg[128];
-            snprintf(msg, sizeof(msg), "circular specialization detected");
+    for (size_t j = 0; j < count; j++) {
+        g->vertices[members[j]].local = j;
+    }
 
-            Sysml2SourceRange range = SYSML2_RANGE_INVALID;
-            range.start = node->loc;
-            range.end = node->loc;
+    /* Incoming edges within the component, grouped per member */
+    size_t *in_start = calloc(count + 1, sizeof(size_t));
+    size_t *queue = malloc(count * sizeof(size_t));
+    size_t *in_edges = NULL;
+    bool ok = in_start && queue;
+
+    size_t in_total = 0;
+    for (size_t j = 0; ok && j < count; j++) {
+        const CycleVertex *u = &g->vertices[members[j]];
+        for (size_t e = 0; e < u->edge_count; e++) {
+            size_t w = g->edges[u->edge_start + e];
+            if (g->vertices[w].root == r) {
+                in_start[g->vertices[w].local + 1]++;
+                in_total++;
+            }
+        }
+    }
+    if (ok) {
+        for (size_t j = 0; j < count; j++) in_start[j + 1] += in_start[j];
+        in_edges = malloc((in_total ? in_total : 1) * sizeof(size_t));
+        ok = in_edges != NULL;
+    }
+    if (ok) {
+        size_t *fill = queue; /* Reused as per-member fill cursor */
+        memcpy(fill, in_start, count * sizeof(size_t));
+        for (size_t j = 0; j < count; j++) {
+            const CycleVertex *u = &g->vertices[members[j]];
+            for (size_t e = 0; e < u->edge_count; e++) {
+                size_t w = g->edges[u->edge_start + e];
+                if (g->vertices[w].root == r) {
+                    in_edges[fill[g->vertices[w].local]++] = members[j];
+                }
+            }
+        }
 
-            Sysml2Diagnostic *diag = sysml2_diag_create(
-                vctx->diag_ctx,
-                SYSML2_DIAG_E3005_CIRCULAR_SPECIALIZATION,
-                SYSML2_SEVERITY_ERROR,
-                vctx->source_file,
-                range,
-                sysml2_intern(vctx->symtab->intern, msg)
-            );
+        /* Backward BFS: shortest path from each member to the root */
+        size_t head = 0, tail = 0;
+        queue[tail++] = r;
+        while (head < tail) {
+            size_t x = queue[head++];
+            size_t lx = g->vertices[x].local;
+            for (size_t k = in_start[lx]; k < in_start[lx + 1]; k++) {
+                size_t u = in_edges[k];
+                if (u != r && g->vertices[u].to_root == CYCLE_NONE) {
+                    g->vertices[u].to_root = x;
+                    queue[tail++] = u;
+                }
+            }
+        }
 
-            char note_msg[512];
-            snprintf(note_msg, sizeof(note_msg), "cycle: %s", cycle_path);
-            sysml2_diag_add_note(diag, vctx->diag_ctx,
-                vctx->source_file, SYSML2_RANGE_INVALID,
-                sysml2_intern(vctx->symtab->intern, note_msg));
+        /* The root's own first step: a successor closest to the root
+         * (BFS order means the first one dequeued wins) */
+        const CycleVertex *rv = &g->vertices[r];
+        for (size_t k = 0; k < tail && g->vertices[r].to_root == CYCLE_NONE; k++) {
+            for (size_t e = 0; e < rv->edge_count; e++) {
+                if (g->edges[rv->edge_start + e] == queue[k]) {
+                    g->vertices[r].to_root = queue[k];
+                    break;
+                }
+            }
+        }
 
-            sysml2_diag_emit(vctx->diag_ctx, diag);
-            vctx->has_errors = true;
+        /* Forward BFS: shortest path from the root to each member */
+        head = tail = 0;
+        queue[tail++] = r;
+        while (head < tail) {
+            size_t x = queue[head++];
+            const CycleVertex *xv = &g->vertices[x];
+            for (size_t e = 0; e < xv->edge_count; e++) {
+                size_t w = g->edges[xv->edge_start + e];
+                if (w != r && g->vertices[w].root == r &&
+                    g->vertices[w].from_root == CYCLE_NONE) {
+                    g->vertices[w].from_root = x;
+                    queue[tail++] = w;
+                }
+            }
         }
-        return true;
     }
 
-    cycle_push(cd, node->id);
+    free(in_start);
+    free(queue);
+    free(in_edges);
+    return ok;
+}
+
+/* Pop the component rooted at v off the Tarjan stack */
+static void cycle_close_component(CycleGraph *g, size_t v) {
+    size_t first = g->stack_count;
+    do {
+        first--;
+    } while (g->stack[first] != v);
+
+    bool cyclic = g->stack_count - first > 1;
+    const CycleVertex *vx = &g->vertices[v];
+    for (size_t e = 0; !cyclic && e < vx->edge_count; e++) {
+        cyclic = g->edges[vx->edge_start + e] == v;
+    }
 
-    /* Follow all type relationship references */
-    Sysml2Scope *scope = sysml2_symtab_get_or_create_scope(
-        vctx->symtab, node->parent_id);
+    for (size_t j = first; j < g->stack_count; j++) {
+        CycleVertex *m = &g->vertices[g->stack[j]];
+        m->root = v;
+        m->on_stack = false;
+        m->cyclic = cyclic;
+    }
+    if (cyclic && !cycle_record_paths(g, first)) {
+        g->failed = true;
+    }
+    g->stack_count = first;
+}
 
-    /* Check typed_by references */
-    for (size_t i = 0; i < node->typed_by_count; i++) {
-        Sysml2Symbol *type_sym = sysml2_symtab_resolve(
-            vctx->symtab, scope, node->typed_by[i]);
-        if (type_sym && type_sym->node) {
-            if (check_cycles_from_node(vctx, cd, type_sym->node)) {
-                cycle_pop(cd);
-                return true;
+/* Tarjan's strongconnect with an explicit stack (no recursion) */
+static void cycle_strongconnect(ValidationContext *vctx, CycleGraph *g, size_t start) {
+    if (!cycle_visit(vctx, g, start)) return;
+
+    while (g->frame_count > 0 && !g->failed) {
+        CycleFrame *f = &g->frames[g->frame_count - 1];
+        size_t v = f->vertex;
+
+        if (f->next_edge < g->vertices[v].edge_count) {
+            size_t w = g->edges[g->vertices[v].edge_start + f->next_edge++];
+            if (g->vertices[w].index == CYCLE_NONE) {
+                cycle_visit(vctx, g, w);
+            } else if (g->vertices[w].on_stack &&
+                       g->vertices[w].index < g->vertices[v].lowlink) {
+                g->vertices[v].lowlink = g->vertices[w].index;
             }
+            continue;
         }
-    }
 
-    /* Check specializes references */
-    for (size_t i = 0; i < node->specializes_count; i++) {
-        Sysml2Symbol *type_sym = sysml2_symtab_resolve(
-            vctx->symtab, scope, node->specializes[i]);
-        if (type_sym && type_sym->node) {
-            if (check_cycles_from_node(vctx, cd, type_sym->node)) {
-                cycle_pop(cd);
-                return true;
+        g->frame_count--;
+        if (g->frame_count > 0) {
+            size_t u = g->frames[g->frame_count - 1].vertex;
+            if (g->vertices[v].lowlink < g->vertices[u].lowlink) {
+                g->vertices[u].lowlink = g->vertices[v].lowlink;
             }
         }
+        if (g->vertices[v].lowlink == g->vertices[v].index) {
+            cycle_close_component(g, v);
+        }
     }
+}
 
-    /* NOTE: We intentionally SKIP redefines references (:>>) for cycle detection.
-     * Redefinitions are OVERRIDES that narrow inherited features, not type cycles.
-     * Example: attribute :>> unitConversion redefines parent's unitConversion -
-     * this is valid inheritance, not a circular dependency.
-     * See SysML v2 spec: redefinitions allow child types to specialize/narrow
-     * features inherited from parent types without creating cycles. */
+static void cycle_note_append(char *buf, size_t size, size_t *len, const char *text) {
+    if (*len >= size) return;
+    int n = snprintf(buf + *len, size - *len, "%s", text);
+    if (n > 0) *len += (size_t)n;
+}
 
-    /* Check references references */
-    for (size_t i = 0; i < node->references_count; i++) {
-        Sysml2Symbol *type_sym = sysml2_symtab_resolve(
-            vctx->symtab, scope, node->references[i]);
-        if (type_sym && type_sym->node) {
-            if (check_cycles_from_node(vctx, cd, type_sym->node)) {
-                cycle_pop(cd);
-                return true;
-            }
+/* Build "cycle: v -> ... -> root -> ... -> v" for a cyclic vertex */
+static const char *build_cycle_note(const CycleGraph *g, size_t v, Sysml2Intern *intern) {
+    char buf[512];
+    size_t len = 0;
+    size_t r = g->vertices[v].root;
+
+    cycle_note_append(buf, sizeof(buf), &len, "cycle: ");
+    cycle_note_append(buf, sizeof(buf), &len, g->vertices[v].node->id);
+
+    /* v to the root */
+    size_t cur = v;
+    size_t steps = 0;
+    do {
+        cur = g->vertices[cur].to_root;
+        if (++steps > CYCLE_NOTE_MAX_STEPS && cur != r) {
+            cycle_note_append(buf, sizeof(buf), &len, " -> ...");
+            cur = r;
+        }
+        cycle_note_append(buf, sizeof(buf), &len, " -> ");
+        cycle_note_append(buf, sizeof(buf), &len, g->vertices[cur].node->id);
+    } while (cur != r);
+
+    /* The root back to v: collect the tail nearest v, then print it forward */
+    if (v != r) {
+        size_t tail[CYCLE_NOTE_MAX_STEPS];
+        size_t tail_count = 0;
+        for (cur = v; cur != r && tail_count < CYCLE_NOTE_MAX_STEPS;
+             cur = g->vertices[cur].from_root) {
+            tail[tail_count++] = cur;
+        }
+        if (cur != r) {
+            cycle_note_append(buf, sizeof(buf), &len, " -> ...");
+        }
+        while (tail_count > 0) {
+            cycle_note_append(buf, sizeof(buf), &len, " -> ");
+            cycle_note_append(buf, sizeof(buf), &len, g->vertices[tail[--tail_count]].node->id);
         }
     }
 
-    cycle_pop(cd);
-    cycle_mark_visited(cd, node->id);
-    return false;
+    return sysml2_intern(intern, buf);
+}
+
+static void report_cycle(ValidationContext *vctx, const CycleGraph *g, size_t v) {
+    SysmlNode *node = g->vertices[v].node;
+
+    Sysml2SourceRange range = SYSML2_RANGE_INVALID;
+    range.start = node->loc;
+    range.end = node->loc;
+
+    Sysml2Diagnostic *diag = sysml2_diag_create(
+        vctx->diag_ctx,
+        SYSML2_DIAG_E3005_CIRCULAR_SPECIALIZATION,
+        SYSML2_SEVERITY_ERROR,
+        vctx->source_file,
+        range,
+        "circular specialization detected"
+    );
+
+    sysml2_diag_add_note(diag, vctx->diag_ctx,
+        vctx->source_file, SYSML2_RANGE_INVALID,
+        build_cycle_note(g, v, vctx->symtab->intern));
+
+    sysml2_diag_emit(vctx->diag_ctx, diag);
+    vctx->has_errors = true;
 }
 
 /* Pass 3: Detect circular specializations */
@@ -618,89 +1028,112 @@ static void pass3_detect_cycles(
     ValidationContext *vctx,
     const SysmlSemanticModel *model
 ) {
-    CycleDetector cd;
-    cycle_detector_init(&cd, vctx->symtab->arena);
+    CycleGraph g = {0};
 
-    for (size_t i = 0; i < model->element_count; i++) {
+    for (size_t i = 0; i < model->element_count && !g.failed; i++) {
         SysmlNode *node = model->elements[i];
-        /* Check if node has any type relationships */
-        if (node->typed_by_count > 0 ||
-            node->specializes_count > 0 ||
-            node->redefines_count > 0 ||
-            node->references_count > 0) {
-            check_cycles_from_node(vctx, &cd, node);
+        if (!node->id) continue;
+        /* Only elements with type relationships have outgoing edges */
+        if (node->typed_by_count == 0 &&
+            node->specializes_count == 0 &&
+            node->references_count == 0) {
+            continue;
+        }
+        size_t v = cycle_graph_vertex(&g, node);
+        if (v != CYCLE_NONE && g.vertices[v].index == CYCLE_NONE) {
+            cycle_strongconnect(vctx, &g, v);
         }
     }
-}
-
-/* ========== Pass 4: Validate Multiplicities (E3007) ========== */
-
-static void pass4_validate_multiplicities(
-    ValidationContext *vctx,
-    const SysmlSemanticModel *model
-) {
-    for (size_t i = 0; i < model->element_count; i++) {
-        SysmlNode *node = model->elements[i];
-        if (!node->multiplicity_lower) continue;
 
-        ParsedMultiplicity m = parse_multiplicity(
-            node->multiplicity_lower,
-            node->multiplicity_upper
-        );
+    /* Report each element on a cycle once, in element order */
+    if (!g.failed) {
+        for (size_t i = 0; i < model->element_count; i++) {
+            SysmlNode *node = model->elements[i];
+            if (!node->id) continue;
+            size_t v = cycle_graph_find(&g, node->id);
+            if (v != CYCLE_NONE && g.vertices[v].node == node && g.vertices[v].cyclic) {
+                report_cycle(vctx, &g, v);
+            }
+        }
+    }
 
-        Sysml2SourceRange range = SYSML2_RANGE_INVALID;
-        range.start = node->loc;
-        range.end = node->loc;
+    cycle_graph_destroy(&g);
+}
 
-        if (!m.valid) {
-            /* E3007: invalid multiplicity format */
-            char msg[256];
-            if (node->multiplicity_upper) {
-                snprintf(msg, sizeof(msg),
-                    "invalid multiplicity bounds [%s..%s]",
-                    node->multiplicity_lower, node->multiplicity_upper);
-            } else {
-                snprintf(msg, sizeof(msg),
-                    "invalid multiplicity bound [%s]",
-                    node->multiplicity_lower);
-            }
+/* ========== Pass 4: Validate Multiplicities (E3007) ========== */
 
-            Sysml2Diagnostic *diag = sysml2_diag_create(
-                vctx->diag_ctx,
-                SYSML2_DIAG_E3007_MULTIPLICITY_ERROR,
-                SYSML2_SEVERITY_ERROR,
-                vctx->source_file,
-                range,
-                sysml2_intern(vctx->symtab->intern, msg)
-            );
-            sysml2_diag_emit(vctx->diag_ctx, diag);
-            vctx->has_errors = true;
-        } else if (m.upper != INT64_MAX && m.lower > m.upper) {
-            /* E3007: lower bound exceeds upper bound */
-            char msg[256];
+/* Pass 4 on one element with a multiplicity */
+static void check_multiplicity(ValidationContext *vctx, SysmlNode *node) {
+    ParsedMultiplicity m = parse_multiplicity(
+        node->multiplicity_lower,
+        node->multiplicity_upper
+    );
+
+    Sysml2SourceRange range = SYSML2_RANGE_INVALID;
+    range.start = node->loc;
+    range.end = node->loc;
+
+    if (!m.valid) {
+        /* E3007: invalid multiplicity format */
+        char msg[256];
+        if (node->multiplicity_upper) {
             snprintf(msg, sizeof(msg),
-                "multiplicity lower bound (%s) exceeds upper bound (%s)",
+                "invalid multiplicity bounds [%s..%s]",
                 node->multiplicity_lower, node->multiplicity_upper);
+        } else {
+            snprintf(msg, sizeof(msg),
+                "invalid multiplicity bound [%s]",
+                node->multiplicity_lower);
+        }
 
-            Sysml2Diagnostic *diag = sysml2_diag_create(
-                vctx->diag_ctx,
-                SYSML2_DIAG_E3007_MULTIPLICITY_ERROR,
-                SYSML2_SEVERITY_ERROR,
-                vctx->source_file,
-                range,
-                sysml2_intern(vctx->symtab->intern, msg)
-            );
+        Sysml2Diagnostic *diag = sysml2_diag_create(
+            vctx->diag_ctx,
+            SYSML2_DIAG_E3007_MULTIPLICITY_ERROR,
+            SYSML2_SEVERITY_ERROR,
+            vctx->source_file,
+            range,
+            msg
+        );
+        sysml2_diag_emit(vctx->diag_ctx, diag);
+        vctx->has_errors = true;
+    } else if (m.upper != INT64_MAX && m.lower > m.upper) {
+        /* E3007: lower bound exceeds upper bound */
+        char msg[256];
+        snprintf(msg, sizeof(msg),
+            "multiplicity lower bound (%s) exceeds upper bound (%s)",
+            node->multiplicity_lower, node->multiplicity_upper);
+
+        Sysml2Diagnostic *diag = sysml2_diag_create(
+            vctx->diag_ctx,
+            SYSML2_DIAG_E3007_MULTIPLICITY_ERROR,
+            SYSML2_SEVERITY_ERROR,
+            vctx->source_file,
+            range,
+            msg
+        );
 
-            char help_msg[128];
-            snprintf(help_msg, sizeof(help_msg),
-                "swap the bounds: [%s..%s]",
-                node->multiplicity_upper, node->multiplicity_lower);
-            sysml2_diag_add_help(diag, vctx->diag_ctx,
-                sysml2_intern(vctx->symtab->intern, help_msg));
+        char help_msg[128];
+        snprintf(help_msg, sizeof(help_msg),
+            "swap the bounds: [%s..%s]",
+            node->multiplicity_upper, node->multiplicity_lower);
+        sysml2_diag_add_help(diag, vctx->diag_ctx,
+            help_msg);
 
-            sysml2_diag_emit(vctx->diag_ctx, diag);
-            vctx->has_errors = true;
-        }
+        sysml2_diag_emit(vctx->diag_ctx, diag);
+        vctx->has_errors = true;
+    }
+}
+
+static void pass4_validate_multiplicities(
+    ValidationContext *vctx,
+    const SysmlSemanticModel *model,
+    size_t begin,
+    size_t end
+) {
+    for (size_t i = begin; i < end; i++) {
+        SysmlNode *node = model->elements[i];
+        if (!node->multiplicity_lower) continue;
+        check_multiplicity(vctx, node);
     }
 }
 
@@ -716,7 +1149,7 @@ static SysmlNode *find_feature_in_scope(
 ) {
     if (!scope_id || !feature_name) return NULL;
 
-    Sysml2Scope *scope = sysml2_symtab_get_or_create_scope(vctx->symtab, scope_id);
+    Sysml2Scope *scope = sysml2_symtab_find_scope(vctx->symtab, scope_id);
     Sysml2Symbol *sym = sysml2_symtab_lookup(scope, feature_name);
     if (sym && sym->node) {
         return sym->node;
@@ -724,6 +1157,51 @@ static SysmlNode *find_feature_in_scope(
     return NULL;
 }
 
+/*
+ * Find a feature in a type or its supertypes (memoized per type and name)
+ *
+ * @param cyclic Set when the answer depended on a query still in progress
+ *               (a cyclic hierarchy); such answers are not memoized
+ */
+static SysmlNode *find_type_feature(
+    ValidationContext *vctx,
+    SysmlNode *type_node,
+    const char *feature_name,
+    bool *cyclic
+) {
+    TypeMemo *memo = type_memo_get(vctx->types, &vctx->types->features, type_node, feature_name);
+    if (!memo) return NULL;
+    if (memo->state == TYPE_MEMO_DONE) return memo->feature;
+    if (memo->state == TYPE_MEMO_BUSY) {
+        *cyclic = true;
+        return NULL;
+    }
+    memo->state = TYPE_MEMO_BUSY;
+
+    bool hit_cycle = false;
+    SysmlNode *found = find_feature_in_scope(vctx, type_node->id, feature_name);
+    if (!found) {
+        Sysml2Symbol **bases = type_bases(vctx, type_node);
+        size_t count = type_node->typed_by_count + type_node->specializes_count;
+        for (size_t i = 0; bases && i < count && !found; i++) {
+            if (bases[i] && bases[i]->node) {
+                found = find_type_feature(vctx, bases[i]->node, feature_name, &hit_cycle);
+            }
+        }
+    }
+
+    memo = type_memo_find(&vctx->types->features, type_node, feature_name,
+                          type_memo_hash(type_node, feature_name));
+    if (found || !hit_cycle) {
+        memo->state = TYPE_MEMO_DONE;
+        memo->feature = found;
+    } else {
+        memo->state = TYPE_MEMO_EMPTY;
+        *cyclic = true;
+    }
+    return found;
+}
+
 /*
  * Find a feature in a type's inheritance chain (typed_by + specializes)
  * Returns the feature node if found, NULL otherwise.
@@ -734,40 +1212,23 @@ static SysmlNode *find_inherited_feature(
     ValidationContext *vctx,
     SysmlNode *type_node,
     const char *feature_name,
-    int depth,
     bool skip_self
 ) {
-    if (!type_node || !feature_name || depth > 20) return NULL;
+    if (!type_node || !feature_name) return NULL;
 
-    /* Check direct features of this type (unless skip_self) */
+    bool cyclic = false;
     if (!skip_self) {
-        SysmlNode *found = find_feature_in_scope(vctx, type_node->id, feature_name);
-        if (found) return found;
+        return find_type_feature(vctx, type_node, feature_name, &cyclic);
     }
 
-    /* Check base types (typed_by) */
-    Sysml2Scope *type_scope = sysml2_symtab_get_or_create_scope(
-        vctx->symtab, type_node->parent_id);
-
-    for (size_t i = 0; i < type_node->typed_by_count; i++) {
-        Sysml2Symbol *base_sym = sysml2_symtab_resolve(
-            vctx->symtab, type_scope, type_node->typed_by[i]);
-        if (base_sym && base_sym->node) {
-            SysmlNode *found = find_inherited_feature(vctx, base_sym->node, feature_name, depth + 1, false);
+    Sysml2Symbol **bases = type_bases(vctx, type_node);
+    size_t count = type_node->typed_by_count + type_node->specializes_count;
+    for (size_t i = 0; bases && i < count; i++) {
+        if (bases[i] && bases[i]->node) {
+            SysmlNode *found = find_type_feature(vctx, bases[i]->node, feature_name, &cyclic);
             if (found) return found;
         }
     }
-
-    /* Check specialized types */
-    for (size_t i = 0; i < type_node->specializes_count; i++) {
-        Sysml2Symbol *base_sym = sysml2_symtab_resolve(
-            vctx->symtab, type_scope, type_node->specializes[i]);
-        if (base_sym && base_sym->node) {
-            SysmlNode *found = find_inherited_feature(vctx, base_sym->node, feature_name, depth + 1, false);
-            if (found) return found;
-        }
-    }
-
     return NULL;
 }
 
@@ -781,18 +1242,24 @@ static SysmlNode *get_parent_type_node(
     if (!node || !node->parent_id) return NULL;
 
     /* Look up the parent in the symbol table */
-    Sysml2Scope *parent_scope = sysml2_symtab_get_or_create_scope(
-        vctx->symtab, node->parent_id);
+    Sysml2Scope *parent_scope = sysml2_symtab_get_or_create_node_scope(
+        vctx->symtab, node);
 
     /* The parent scope ID is the parent's qualified ID */
     /* Find the symbol for that ID in the parent's parent scope */
-    const char *last_sep = strrchr(node->parent_id, ':');
-    const char *parent_name = last_sep ? (last_sep + 1) : node->parent_id;
+    const char *parent_name;
+    if (node->parent && node->parent->has_path) {
+        parent_name = sysml2_node_local_id(node->parent);
+    } else {
+        const char *last_sep = strrchr(node->parent_id, ':');
+        parent_name = last_sep ? (last_sep + 1) : node->parent_id;
 
-    /* Skip second colon if present (::) */
-    while (*parent_name == ':') parent_name++;
+        /* Skip second colon if present (::) */
+        while (*parent_name == ':') parent_name++;
+    }
 
-    Sysml2Symbol *parent_sym = sysml2_symtab_lookup(parent_scope->parent, parent_name);
+    Sysml2Symbol *parent_sym = sysml2_symtab_lookup(
+        sysml2_symtab_parent(vctx->symtab, parent_scope), parent_name);
     if (parent_sym && parent_sym->node) {
         return parent_sym->node;
     }
@@ -807,6 +1274,50 @@ static SysmlNode *get_parent_type_node(
     return NULL;
 }
 
+/*
+ * Check if orig_type names one of type_node's supertypes (memoized)
+ *
+ * @param cyclic Set when the answer depended on a query still in progress
+ */
+static bool type_has_supertype(
+    ValidationContext *vctx,
+    SysmlNode *type_node,
+    const char *orig_type,
+    bool *cyclic
+) {
+    TypeMemo *memo = type_memo_get(vctx->types, &vctx->types->subtypes, type_node, orig_type);
+    if (!memo) return false;
+    if (memo->state == TYPE_MEMO_DONE) return memo->subtype;
+    if (memo->state == TYPE_MEMO_BUSY) {
+        *cyclic = true;
+        return false;
+    }
+    memo->state = TYPE_MEMO_BUSY;
+
+    bool hit_cycle = false;
+    bool found = false;
+    Sysml2Symbol **bases = type_bases(vctx, type_node);
+    size_t count = type_node->typed_by_count + type_node->specializes_count;
+    for (size_t i = 0; bases && i < count && !found; i++) {
+        if (strcmp(type_base_ref(type_node, i), orig_type) == 0) {
+            found = true;
+        } else if (bases[i] && bases[i]->node) {
+            found = type_has_supertype(vctx, bases[i]->node, orig_type, &hit_cycle);
+        }
+    }
+
+    memo = type_memo_find(&vctx->types->subtypes, type_node, orig_type,
+                          type_memo_hash(type_node, orig_type));
+    if (found || !hit_cycle) {
+        memo->state = TYPE_MEMO_DONE;
+        memo->subtype = found;
+    } else {
+        memo->state = TYPE_MEMO_EMPTY;
+        *cyclic = true;
+    }
+    return found;
+}
+
 /*
  * Check if new_type specializes or is the same as orig_type
  */
@@ -814,37 +1325,19 @@ static bool is_subtype_of(
     ValidationContext *vctx,
     const char *new_type,
     const char *orig_type,
-    Sysml2Scope *scope,
-    int depth
+    Sysml2Scope *scope
 ) {
-    if (!new_type || !orig_type || depth > 20) return false;
+    if (!new_type || !orig_type) return false;
 
     /* Same type is valid */
     if (strcmp(new_type, orig_type) == 0) return true;
 
-    /* Resolve new_type and check its base types */
+    /* Resolve new_type and check its supertypes */
     Sysml2Symbol *new_sym = sysml2_symtab_resolve(vctx->symtab, scope, new_type);
     if (!new_sym || !new_sym->node) return false;
 
-    SysmlNode *new_node = new_sym->node;
-    Sysml2Scope *new_scope = sysml2_symtab_get_or_create_scope(
-        vctx->symtab, new_node->parent_id);
-
-    /* Check typed_by */
-    for (size_t i = 0; i < new_node->typed_by_count; i++) {
-        if (is_subtype_of(vctx, new_node->typed_by[i], orig_type, new_scope, depth + 1)) {
-            return true;
-        }
-    }
-
-    /* Check specializes */
-    for (size_t i = 0; i < new_node->specializes_count; i++) {
-        if (is_subtype_of(vctx, new_node->specializes[i], orig_type, new_scope, depth + 1)) {
-            return true;
-        }
-    }
-
-    return false;
+    bool cyclic = false;
+    return type_has_supertype(vctx, new_sym->node, orig_type, &cyclic);
 }
 
 /*
@@ -866,42 +1359,94 @@ static bool is_valid_multiplicity_narrowing(
     return true;
 }
 
-static void pass5_validate_redefines(
+/* Pass 5 on one element with redefinitions */
+static void check_redefines(
     ValidationContext *vctx,
-    const SysmlSemanticModel *model
+    SysmlNode *node,
+    Sysml2Scope *scope
 ) {
-    for (size_t i = 0; i < model->element_count; i++) {
-        SysmlNode *node = model->elements[i];
-        if (node->redefines_count == 0) continue;
+    /* Get the parent type for context */
+    SysmlNode *parent_type = get_parent_type_node(vctx, node);
+
+    for (size_t j = 0; j < node->redefines_count; j++) {
+        const char *ref = node->redefines[j];
+        SysmlNode *orig_feature = NULL;
+
+        /* If simple name, must exist in parent type hierarchy */
+        if (!strchr(ref, ':')) {
+            if (parent_type) {
+                /* Skip self (B) and look only in inherited types (A, etc.) */
+                orig_feature = find_inherited_feature(vctx, parent_type, ref, true);
+            }
 
-        /* Get the parent type for context */
-        SysmlNode *parent_type = get_parent_type_node(vctx, node);
+            if (!orig_feature && vctx->options->check_undefined_features) {
+                /* E3002: feature not found in parent type */
+                char msg[256];
+                snprintf(msg, sizeof(msg),
+                    "feature '%s' not found in parent type%s%s",
+                    ref,
+                    parent_type && parent_type->name ? " '" : "",
+                    parent_type && parent_type->name ? parent_type->name : "");
+                if (parent_type && parent_type->name) {
+                    strcat(msg, "'");
+                }
 
-        Sysml2Scope *scope = sysml2_symtab_get_or_create_scope(
-            vctx->symtab, node->parent_id);
+                Sysml2SourceRange range = SYSML2_RANGE_INVALID;
+                range.start = node->loc;
+                range.end = node->loc;
+
+                Sysml2Diagnostic *diag = sysml2_diag_create(
+                    vctx->diag_ctx,
+                    SYSML2_DIAG_E3002_UNDEFINED_FEATURE,
+                    SYSML2_SEVERITY_ERROR,
+                    vctx->source_file,
+                    range,
+                    msg
+                );
+                sysml2_diag_emit(vctx->diag_ctx, diag);
+                vctx->has_errors = true;
+                continue;
+            }
+        } else {
+            /* Qualified name - resolve it */
+            Sysml2Symbol *ref_sym = sysml2_symtab_resolve(vctx->symtab, scope, ref);
+            if (ref_sym && ref_sym->node) {
+                orig_feature = ref_sym->node;
+            } else if (vctx->options->check_undefined_features) {
+                /* E3002: qualified feature not found */
+                char msg[256];
+                snprintf(msg, sizeof(msg), "undefined feature '%s'", ref);
 
-        for (size_t j = 0; j < node->redefines_count; j++) {
-            const char *ref = node->redefines[j];
-            SysmlNode *orig_feature = NULL;
+                Sysml2SourceRange range = SYSML2_RANGE_INVALID;
+                range.start = node->loc;
+                range.end = node->loc;
 
-            /* If simple name, must exist in parent type hierarchy */
-            if (!strchr(ref, ':')) {
-                if (parent_type) {
-                    /* Skip self (B) and look only in inherited types (A, etc.) */
-                    orig_feature = find_inherited_feature(vctx, parent_type, ref, 0, true);
-                }
+                Sysml2Diagnostic *diag = sysml2_diag_create(
+                    vctx->diag_ctx,
+                    SYSML2_DIAG_E3002_UNDEFINED_FEATURE,
+                    SYSML2_SEVERITY_ERROR,
+                    vctx->source_file,
+                    range,
+                    msg
+                );
+                sysml2_diag_emit(vctx->diag_ctx, diag);
+                vctx->has_errors = true;
+                continue;
+            }
+        }
 
-                if (!orig_feature && vctx->options->check_undefined_features) {
-                    /* E3002: feature not found in parent type */
+        /* E3008: Check redefinition compatibility */
+        if (orig_feature && vctx->options->check_redefinition_compat) {
+            /* Check type narrowing if redefining node has a type */
+            if (node->typed_by_count > 0 && orig_feature->typed_by_count > 0) {
+                const char *new_type = node->typed_by[0];
+                const char *orig_type = orig_feature->typed_by[0];
+
+                if (!is_subtype_of(vctx, new_type, orig_type, scope)) {
                     char msg[256];
                     snprintf(msg, sizeof(msg),
-                        "feature '%s' not found in parent type%s%s",
-                        ref,
-                        parent_type && parent_type->name ? " '" : "",
-                        parent_type && parent_type->name ? parent_type->name : "");
-                    if (parent_type && parent_type->name) {
-                        strcat(msg, "'");
-                    }
+                        "redefinition type '%s' is not a subtype of '%s'",
+                        new_type, orig_type);
 
                     Sysml2SourceRange range = SYSML2_RANGE_INVALID;
                     range.start = node->loc;
@@ -909,25 +1454,48 @@ static void pass5_validate_redefines(
 
                     Sysml2Diagnostic *diag = sysml2_diag_create(
                         vctx->diag_ctx,
-                        SYSML2_DIAG_E3002_UNDEFINED_FEATURE,
+                        SYSML2_DIAG_E3008_REDEFINITION_ERROR,
                         SYSML2_SEVERITY_ERROR,
                         vctx->source_file,
                         range,
-                        sysml2_intern(vctx->symtab->intern, msg)
+                        msg
                     );
+
+                    char help_msg[256];
+                    snprintf(help_msg, sizeof(help_msg),
+                        "redefinition must use same type or a subtype of '%s'",
+                        orig_type);
+                    sysml2_diag_add_help(diag, vctx->diag_ctx,
+                        help_msg);
+
                     sysml2_diag_emit(vctx->diag_ctx, diag);
                     vctx->has_errors = true;
-                    continue;
                 }
-            } else {
-                /* Qualified name - resolve it */
-                Sysml2Symbol *ref_sym = sysml2_symtab_resolve(vctx->symtab, scope, ref);
-                if (ref_sym && ref_sym->node) {
-                    orig_feature = ref_sym->node;
-                } else if (vctx->options->check_undefined_features) {
-                    /* E3002: qualified feature not found */
+            }
+
+            /* Check multiplicity narrowing */
+            if (node->multiplicity_lower && orig_feature->multiplicity_lower) {
+                ParsedMultiplicity new_mult = parse_multiplicity(
+                    node->multiplicity_lower, node->multiplicity_upper);
+                ParsedMultiplicity orig_mult = parse_multiplicity(
+                    orig_feature->multiplicity_lower, orig_feature->multiplicity_upper);
+
+                if (!is_valid_multiplicity_narrowing(orig_mult, new_mult)) {
                     char msg[256];
-                    snprintf(msg, sizeof(msg), "undefined feature '%s'", ref);
+                    if (orig_feature->multiplicity_upper) {
+                        snprintf(msg, sizeof(msg),
+                            "redefinition multiplicity [%s..%s] widens original [%s..%s]",
+                            node->multiplicity_lower,
+                            node->multiplicity_upper ? node->multiplicity_upper : node->multiplicity_lower,
+                            orig_feature->multiplicity_lower,
+                            orig_feature->multiplicity_upper);
+                    } else {
+                        snprintf(msg, sizeof(msg),
+                            "redefinition multiplicity [%s..%s] widens original [%s]",
+                            node->multiplicity_lower,
+                            node->multiplicity_upper ? node->multiplicity_upper : node->multiplicity_lower,
+                            orig_feature->multiplicity_lower);
+                    }
 
                     Sysml2SourceRange range = SYSML2_RANGE_INVALID;
                     range.start = node->loc;
@@ -935,106 +1503,40 @@ static void pass5_validate_redefines(
 
                     Sysml2Diagnostic *diag = sysml2_diag_create(
                         vctx->diag_ctx,
-                        SYSML2_DIAG_E3002_UNDEFINED_FEATURE,
+                        SYSML2_DIAG_E3008_REDEFINITION_ERROR,
                         SYSML2_SEVERITY_ERROR,
                         vctx->source_file,
                         range,
-                        sysml2_intern(vctx->symtab->intern, msg)
+                        msg
                     );
-                    sysml2_diag_emit(vctx->diag_ctx, diag);
-                    vctx->has_errors = true;
-                    continue;
-                }
-            }
-
-            /* E3008: Check redefinition compatibility */
-            if (orig_feature && vctx->options->check_redefinition_compat) {
-                /* Check type narrowing if redefining node has a type */
-                if (node->typed_by_count > 0 && orig_feature->typed_by_count > 0) {
-                    const char *new_type = node->typed_by[0];
-                    const char *orig_type = orig_feature->typed_by[0];
-
-                    if (!is_subtype_of(vctx, new_type, orig_type, scope, 0)) {
-                        char msg[256];
-                        snprintf(msg, sizeof(msg),
-                            "redefinition type '%s' is not a subtype of '%s'",
-                            new_type, orig_type);
-
-                        Sysml2SourceRange range = SYSML2_RANGE_INVALID;
-                        range.start = node->loc;
-                        range.end = node->loc;
-
-                        Sysml2Diagnostic *diag = sysml2_diag_create(
-                            vctx->diag_ctx,
-                            SYSML2_DIAG_E3008_REDEFINITION_ERROR,
-                            SYSML2_SEVERITY_ERROR,
-                            vctx->source_file,
-                            range,
-                            sysml2_intern(vctx->symtab->intern, msg)
-                        );
-
-                        char help_msg[256];
-                        snprintf(help_msg, sizeof(help_msg),
-                            "redefinition must use same type or a subtype of '%s'",
-                            orig_type);
-                        sysml2_diag_add_help(diag, vctx->diag_ctx,
-                            sysml2_intern(vctx->symtab->intern, help_msg));
 
-                        sysml2_diag_emit(vctx->diag_ctx, diag);
-                        vctx->has_errors = true;
-                    }
-                }
-
-                /* Check multiplicity narrowing */
-                if (node->multiplicity_lower && orig_feature->multiplicity_lower) {
-                    ParsedMultiplicity new_mult = parse_multiplicity(
-                        node->multiplicity_lower, node->multiplicity_upper);
-                    ParsedMultiplicity orig_mult = parse_multiplicity(
-                        orig_feature->multiplicity_lower, orig_feature->multiplicity_upper);
-
-                    if (!is_valid_multiplicity_narrowing(orig_mult, new_mult)) {
-                        char msg[256];
-                        if (orig_feature->multiplicity_upper) {
-                            snprintf(msg, sizeof(msg),
-                                "redefinition multiplicity [%s..%s] widens original [%s..%s]",
-                                node->multiplicity_lower,
-                                node->multiplicity_upper ? node->multiplicity_upper : node->multiplicity_lower,
-                                orig_feature->multiplicity_lower,
-                                orig_feature->multiplicity_upper);
-                        } else {
-                            snprintf(msg, sizeof(msg),
-                                "redefinition multiplicity [%s..%s] widens original [%s]",
-                                node->multiplicity_lower,
-                                node->multiplicity_upper ? node->multiplicity_upper : node->multiplicity_lower,
-                                orig_feature->multiplicity_lower);
-                        }
-
-                        Sysml2SourceRange range = SYSML2_RANGE_INVALID;
-                        range.start = node->loc;
-                        range.end = node->loc;
-
-                        Sysml2Diagnostic *diag = sysml2_diag_create(
-                            vctx->diag_ctx,
-                            SYSML2_DIAG_E3008_REDEFINITION_ERROR,
-                            SYSML2_SEVERITY_ERROR,
-                            vctx->source_file,
-                            range,
-                            sysml2_intern(vctx->symtab->intern, msg)
-                        );
-
-                        sysml2_diag_add_help(diag, vctx->diag_ctx,
-                            sysml2_intern(vctx->symtab->intern,
-                                "redefinition can only narrow (not widen) the multiplicity"));
+                    sysml2_diag_add_help(diag, vctx->diag_ctx,
+                        "redefinition can only narrow (not widen) the multiplicity");
 
-                        sysml2_diag_emit(vctx->diag_ctx, diag);
-                        vctx->has_errors = true;
-                    }
+                    sysml2_diag_emit(vctx->diag_ctx, diag);
+                    vctx->has_errors = true;
                 }
             }
         }
     }
 }
 
+static void pass5_validate_redefines(
+    ValidationContext *vctx,
+    const SysmlSemanticModel *model,
+    size_t begin,
+    size_t end
+) {
+    for (size_t i = begin; i < end; i++) {
+        SysmlNode *node = model->elements[i];
+        if (node->redefines_count == 0) continue;
+
+        Sysml2Scope *scope = sysml2_symtab_get_or_create_node_scope(
+            vctx->symtab, node);
+        check_redefines(vctx, node, scope);
+    }
+}
+
 /* ========== Pass 6: Validate Imports (E3003) ========== */
 
 /*
@@ -1094,7 +1596,7 @@ static void pass6_validate_imports(
                 SYSML2_SEVERITY_ERROR,
                 vctx->source_file,
                 range,
-                sysml2_intern(vctx->symtab->intern, msg)
+                msg
             );
 
             /* Try to find similar namespaces */
@@ -1108,7 +1610,7 @@ static void pass6_validate_imports(
                     char help[512];
                     snprintf(help, sizeof(help), "did you mean '%s'?", suggestions[0]);
                     sysml2_diag_add_help(diag, vctx->diag_ctx,
-                        sysml2_intern(vctx->symtab->intern, help));
+                        help);
                 }
             }
 
@@ -1120,58 +1622,326 @@ static void pass6_validate_imports(
 
 /* ========== Pass 7: Abstract Instantiation Warnings ========== */
 
+/* Pass 7 on one concrete typed usage */
+static void check_abstract(
+    ValidationContext *vctx,
+    SysmlNode *node,
+    Sysml2Scope *scope,
+    Sysml2Symbol **bases
+) {
+    for (size_t j = 0; j < node->typed_by_count; j++) {
+        const char *type_ref = node->typed_by[j];
+
+        Sysml2Symbol *type_sym = bases ? bases[j] : sysml2_symtab_resolve(
+            vctx->symtab, scope, type_ref);
+
+        if (type_sym && type_sym->node && type_sym->node->is_abstract) {
+            /* Warning: instantiating abstract type */
+            char msg[256];
+            snprintf(msg, sizeof(msg),
+                "instantiation of abstract type '%s'",
+                type_ref);
+
+            Sysml2SourceRange range = SYSML2_RANGE_INVALID;
+            range.start = node->loc;
+            range.end = node->loc;
+
+            Sysml2Diagnostic *diag = sysml2_diag_create(
+                vctx->diag_ctx,
+                SYSML2_DIAG_W1003_DEPRECATED, /* Reuse deprecated code for warning */
+                SYSML2_SEVERITY_WARNING,
+                vctx->source_file,
+                range,
+                msg
+            );
+
+            sysml2_diag_add_help(diag, vctx->diag_ctx,
+                "abstract types should not be directly instantiated; use a concrete subtype");
+
+            sysml2_diag_emit(vctx->diag_ctx, diag);
+            /* Note: this is a warning, not an error */
+        }
+    }
+}
+
 static void pass7_check_abstract_instantiation(
     ValidationContext *vctx,
-    const SysmlSemanticModel *model
+    const SysmlSemanticModel *model,
+    size_t begin,
+    size_t end
 ) {
-    for (size_t i = 0; i < model->element_count; i++) {
+    for (size_t i = begin; i < end; i++) {
         SysmlNode *node = model->elements[i];
 
         /* Only check usages (not definitions) */
         if (!SYSML_KIND_IS_USAGE(node->kind)) continue;
 
         /* Skip abstract usages - they're not concrete instantiations */
-        if (node->is_abstract) continue;
+        if (node->is_abstract || node->typed_by_count == 0) continue;
 
         /* Get scope for type resolution */
-        Sysml2Scope *scope = sysml2_symtab_get_or_create_scope(
-            vctx->symtab, node->parent_id);
+        Sysml2Scope *scope = sysml2_symtab_get_or_create_node_scope(
+            vctx->symtab, node);
+        check_abstract(vctx, node, scope, type_bases(vctx, node));
+    }
+}
 
-        for (size_t j = 0; j < node->typed_by_count; j++) {
-            const char *type_ref = node->typed_by[j];
+/* ========== Pass Order ========== */
+
+Sysml2ValidatorPass sysml2_validator_diag_pass(Sysml2DiagCode code) {
+    switch (code) {
+        case SYSML2_DIAG_E3004_DUPLICATE_NAME: return SYSML2_PASS_SYMTAB;
+        case SYSML2_DIAG_E3001_UNDEFINED_TYPE:
+        case SYSML2_DIAG_E3006_TYPE_MISMATCH: return SYSML2_PASS_TYPES;
+        case SYSML2_DIAG_E3005_CIRCULAR_SPECIALIZATION: return SYSML2_PASS_CYCLES;
+        case SYSML2_DIAG_E3007_MULTIPLICITY_ERROR: return SYSML2_PASS_MULTIPLICITIES;
+        case SYSML2_DIAG_E3002_UNDEFINED_FEATURE:
+        case SYSML2_DIAG_E3008_REDEFINITION_ERROR: return SYSML2_PASS_REDEFINES;
+        case SYSML2_DIAG_E3003_UNDEFINED_NAMESPACE: return SYSML2_PASS_IMPORTS;
+        case SYSML2_DIAG_W1003_DEPRECATED: return SYSML2_PASS_ABSTRACT;
+        default: return SYSML2_PASS_COUNT;
+    }
+}
 
-            Sysml2Symbol *type_sym = sysml2_symtab_resolve(
-                vctx->symtab, scope, type_ref);
+/* ========== Pass Timing (--stats, --trace) ========== */
 
-            if (type_sym && type_sym->node && type_sym->node->is_abstract) {
-                /* Warning: instantiating abstract type */
-                char msg[256];
-                snprintf(msg, sizeof(msg),
-                    "instantiation of abstract type '%s'",
-                    type_ref);
+typedef struct {
+    uint64_t wall_ns;
+    uint64_t cpu_ns;
+} PassClock;
+
+/* Start a pass: open its trace span and read the clocks if timing */
+static PassClock pass_clock_start(const Sysml2ValidationOptions *options, Sysml2ValidatorPass pass) {
+    sysml2_trace_begin(options->trace, "validate", sysml2_stats_pass_name(pass), NULL);
+    if (!options->stats) return (PassClock){0, 0};
+    return (PassClock){ sysml2_stats_wall_ns(), sysml2_stats_thread_cpu_ns() };
+}
 
-                Sysml2SourceRange range = SYSML2_RANGE_INVALID;
-                range.start = node->loc;
-                range.end = node->loc;
+static void pass_clock_stop(const Sysml2ValidationOptions *options, Sysml2ValidatorPass pass,
+                            PassClock start) {
+    sysml2_trace_end(options->trace);
+    if (!options->stats) return;
+    sysml2_stats_add_pass(options->stats, pass, sysml2_stats_wall_ns() - start.wall_ns,
+                          sysml2_stats_thread_cpu_ns() - start.cpu_ns);
+}
 
-                Sysml2Diagnostic *diag = sysml2_diag_create(
-                    vctx->diag_ctx,
-                    SYSML2_DIAG_W1003_DEPRECATED, /* Reuse deprecated code for warning */
-                    SYSML2_SEVERITY_WARNING,
-                    vctx->source_file,
-                    range,
-                    sysml2_intern(vctx->symtab->intern, msg)
-                );
+/* Record the size of the symbol table built by pass 1 (all layers; a
+ * shadow and the frozen scope under it count as one scope) */
+static void record_symtab_size(Sysml2Stats *stats, const Sysml2SymbolTable *symtab) {
+    if (!stats) return;
+    stats->scope_count = 0;
+    stats->symbol_count = 0;
+    for (const Sysml2SymbolTable *t = symtab; t; t = t->lower) {
+        stats->scope_count += t->scope_count - t->shadow_count;
+        for (size_t i = 0; i < t->scope_capacity; i++) {
+            if (t->scopes[i]) stats->symbol_count += t->scopes[i]->symbol_count;
+        }
+    }
+}
 
-                sysml2_diag_add_help(diag, vctx->diag_ctx,
-                    sysml2_intern(vctx->symtab->intern,
-                        "abstract types should not be directly instantiated; use a concrete subtype"));
+/* ========== Range Passes ========== */
 
-                sysml2_diag_emit(vctx->diag_ctx, diag);
-                /* Note: this is a warning, not an error */
+/*
+ * Passes 2, 4, 5 and 7 check one element at a time against the complete
+ * symbol table, so they can run over any range of a model's elements.
+ * They run either one after the other, each over the whole range, or
+ * (options->fuse_passes) as a single sweep: each element's scope and
+ * resolved bases are looked up once and every enabled check runs on it
+ * while it is in cache. A sweep reports each check into its own pass's
+ * list; merging the lists pass by pass, with passes 3 and 6 run over the
+ * whole models in between, gives the output of separate passes. Pass 3
+ * then finds the bases of typed elements in the type cache the sweep
+ * filled.
+ */
+
+/* Range passes, in reporting order */
+enum {
+    RANGE_PASS_TYPES,           /* Pass 2 */
+    RANGE_PASS_MULTIPLICITIES,  /* Pass 4 */
+    RANGE_PASS_REDEFINES,       /* Pass 5 */
+    RANGE_PASS_ABSTRACT,        /* Pass 7 */
+    RANGE_PASS_COUNT
+};
+
+static const Sysml2ValidatorPass range_pass_ids[RANGE_PASS_COUNT] = {
+    [RANGE_PASS_TYPES] = SYSML2_PASS_TYPES,
+    [RANGE_PASS_MULTIPLICITIES] = SYSML2_PASS_MULTIPLICITIES,
+    [RANGE_PASS_REDEFINES] = SYSML2_PASS_REDEFINES,
+    [RANGE_PASS_ABSTRACT] = SYSML2_PASS_ABSTRACT,
+};
+
+typedef void (*RangePass)(
+    ValidationContext *vctx,
+    const SysmlSemanticModel *model,
+    size_t begin,
+    size_t end
+);
+
+/* Elements [begin, end) of one model, with a diagnostic list per pass */
+typedef struct {
+    const SysmlSemanticModel *model;
+    size_t begin;
+    size_t end;
+    Sysml2DiagContext diags[RANGE_PASS_COUNT];
+    bool has_errors;
+} ValidateTask;
+
+/* Get the range passes the options enable (NULL where disabled) */
+static void range_passes_init(const Sysml2ValidationOptions *options,
+                              RangePass passes[RANGE_PASS_COUNT]) {
+    /* Pass 2 always runs: with its checks off it reports nothing */
+    passes[RANGE_PASS_TYPES] = pass2_resolve_types;
+    passes[RANGE_PASS_MULTIPLICITIES] = options->check_multiplicity
+        ? pass4_validate_multiplicities : NULL;
+    passes[RANGE_PASS_REDEFINES] =
+        options->check_undefined_features || options->check_redefinition_compat
+        ? pass5_validate_redefines : NULL;
+    passes[RANGE_PASS_ABSTRACT] = options->warn_abstract_instantiation
+        ? pass7_check_abstract_instantiation : NULL;
+}
+
+/* Whether to sweep once; per-pass timings and spans need separate passes */
+static bool fuse_passes(const Sysml2ValidationOptions *options) {
+    return options->fuse_passes && !options->stats && !options->trace;
+}
+
+/* Set up one context per range pass, each reporting into the task's list */
+static void task_contexts(
+    ValidationContext vctx[RANGE_PASS_COUNT],
+    ValidateTask *task,
+    const ValidationContext *base,
+    Sysml2Arena *arena
+) {
+    for (size_t p = 0; p < RANGE_PASS_COUNT; p++) {
+        sysml2_diag_context_init(&task->diags[p], arena);
+        vctx[p] = *base;
+        vctx[p].diag_ctx = &task->diags[p];
+        vctx[p].has_errors = false;
+    }
+}
+
+/* Run the enabled range passes over a task's elements in one sweep */
+static void fused_sweep(
+    ValidationContext vctx[RANGE_PASS_COUNT],
+    const RangePass passes[RANGE_PASS_COUNT],
+    const ValidateTask *task
+) {
+    bool types = passes[RANGE_PASS_TYPES] != NULL;
+    bool multiplicities = passes[RANGE_PASS_MULTIPLICITIES] != NULL;
+    bool redefines = passes[RANGE_PASS_REDEFINES] != NULL;
+    bool abstract = passes[RANGE_PASS_ABSTRACT] != NULL;
+    ValidationContext *shared = &vctx[RANGE_PASS_TYPES]; /* Same table and cache in all */
+
+    for (size_t i = task->begin; i < task->end; i++) {
+        SysmlNode *node = task->model->elements[i];
+
+        if (multiplicities && node->multiplicity_lower) {
+            check_multiplicity(&vctx[RANGE_PASS_MULTIPLICITIES], node);
+        }
+
+        bool typed = types && node->typed_by_count > 0;
+        bool concrete = abstract && node->typed_by_count > 0 &&
+                        SYSML_KIND_IS_USAGE(node->kind) && !node->is_abstract;
+        bool redefining = redefines && node->redefines_count > 0;
+        if (!typed && !concrete && !redefining) continue;
+
+        Sysml2Scope *scope = sysml2_symtab_get_or_create_node_scope(shared->symtab, node);
+        Sysml2Symbol **bases = typed || concrete ? type_bases(shared, node) : NULL;
+        if (typed) check_types(&vctx[RANGE_PASS_TYPES], node, scope, bases);
+        if (redefining) check_redefines(&vctx[RANGE_PASS_REDEFINES], node, scope);
+        if (concrete) check_abstract(&vctx[RANGE_PASS_ABSTRACT], node, scope, bases);
+    }
+}
+
+/*
+ * Report the tasks' lists pass by pass in task order, running passes 3
+ * and 6 over the models in between: the serial order 2, 3, 4, 5, 6, 7
+ *
+ * @param own_files Report passes 3 and 6 in each model's source file
+ *                  (false: in vctx->source_file)
+ */
+static void report_range_passes(
+    ValidationContext *vctx,
+    SysmlSemanticModel **models,
+    size_t model_count,
+    ValidateTask *tasks,
+    size_t task_count,
+    bool own_files
+) {
+    const Sysml2ValidationOptions *options = vctx->options;
+
+    for (size_t i = 0; i < task_count; i++) {
+        if (tasks[i].has_errors) vctx->has_errors = true;
+    }
+
+    for (size_t p = 0; p < RANGE_PASS_COUNT; p++) {
+        for (size_t i = 0; i < task_count; i++) {
+            sysml2_diag_merge(vctx->diag_ctx, &tasks[i].diags[p]);
+        }
+
+        if (p == RANGE_PASS_TYPES && options->check_circular_specs) {
+            PassClock clock = pass_clock_start(options, SYSML2_PASS_CYCLES);
+            for (size_t i = 0; i < model_count; i++) {
+                if (models[i]) {
+                    if (own_files) vctx->source_file = models[i]->source_file;
+                    pass3_detect_cycles(vctx, models[i]);
+                }
+            }
+            pass_clock_stop(options, SYSML2_PASS_CYCLES, clock);
+        }
+        if (p == RANGE_PASS_REDEFINES && options->check_undefined_namespaces) {
+            PassClock clock = pass_clock_start(options, SYSML2_PASS_IMPORTS);
+            for (size_t i = 0; i < model_count; i++) {
+                if (models[i]) {
+                    if (own_files) vctx->source_file = models[i]->source_file;
+                    pass6_validate_imports(vctx, models[i]);
+                }
             }
+            pass_clock_stop(options, SYSML2_PASS_IMPORTS, clock);
+        }
+    }
+}
+
+/*
+ * Run passes 2 to 7 on the calling thread, sweeping each model once
+ *
+ * Returns false without reporting anything if out of memory; the caller
+ * then runs the passes separately.
+ *
+ * @param own_files Report in each model's source file (false: in
+ *                  vctx->source_file)
+ */
+static bool validate_fused(
+    ValidationContext *vctx,
+    SysmlSemanticModel **models,
+    size_t model_count,
+    bool own_files
+) {
+    ValidateTask *tasks = SYSML2_ARENA_NEW_ARRAY(vctx->types->arena, ValidateTask, model_count);
+    if (!tasks) return false;
+
+    RangePass passes[RANGE_PASS_COUNT];
+    range_passes_init(vctx->options, passes);
+
+    size_t task_count = 0;
+    for (size_t i = 0; i < model_count; i++) {
+        if (!models[i]) continue;
+        ValidateTask *task = &tasks[task_count++];
+        task->model = models[i];
+        task->end = models[i]->element_count;
+
+        ValidationContext base = *vctx;
+        if (own_files) base.source_file = models[i]->source_file;
+        ValidationContext task_vctx[RANGE_PASS_COUNT];
+        task_contexts(task_vctx, task, &base, vctx->types->arena);
+        fused_sweep(task_vctx, passes, task);
+        for (size_t p = 0; p < RANGE_PASS_COUNT; p++) {
+            if (task_vctx[p].has_errors) task->has_errors = true;
         }
     }
+
+    report_range_passes(vctx, models, model_count, tasks, task_count, own_files);
+    return true;
 }
 
 /* ========== Main Validation Entry Point ========== */
@@ -1199,14 +1969,21 @@ Sysml2Result sysml2_validate(
     sysml2_symtab_init(&symtab, arena, intern);
 
     /* Set up validation context */
+    TypeCache types;
+    type_cache_init(&types, arena);
+
     ValidationContext vctx = {
         .symtab = &symtab,
         .diag_ctx = diag_ctx,
         .source_file = source_file,
         .options = options,
+        .types = &types,
         .has_errors = false
     };
 
+    Sysml2Stats *stats = options->stats;
+    PassClock clock = pass_clock_start(options, SYSML2_PASS_SYMTAB);
+
     /* Pass 1: Build symbol table + detect duplicates (E3004) */
     if (options->check_duplicate_names) {
         pass1_build_symtab(&vctx, model);
@@ -1218,35 +1995,56 @@ Sysml2Result sysml2_validate(
         pass1_build_symtab(&vctx, model);
         vctx.options = options;
     }
+    pass_clock_stop(options, SYSML2_PASS_SYMTAB, clock);
+    record_symtab_size(stats, &symtab);
+
+    /* Passes 2-7 in one sweep */
+    SysmlSemanticModel *swept[] = { (SysmlSemanticModel *)model };
+    if (fuse_passes(options) && validate_fused(&vctx, swept, 1, false)) {
+        sysml2_symtab_destroy(&symtab);
+        return vctx.has_errors ? SYSML2_ERROR_SEMANTIC : SYSML2_OK;
+    }
 
     /* Pass 2: Resolve types + check compatibility (E3001, E3006) */
     if (options->check_undefined_types || options->check_type_compatibility) {
-        pass2_resolve_types(&vctx, model);
+        clock = pass_clock_start(options, SYSML2_PASS_TYPES);
+        pass2_resolve_types(&vctx, model, 0, model->element_count);
+        pass_clock_stop(options, SYSML2_PASS_TYPES, clock);
     }
 
     /* Pass 3: Detect circular specializations (E3005) */
     if (options->check_circular_specs) {
+        clock = pass_clock_start(options, SYSML2_PASS_CYCLES);
         pass3_detect_cycles(&vctx, model);
+        pass_clock_stop(options, SYSML2_PASS_CYCLES, clock);
     }
 
     /* Pass 4: Validate multiplicities (E3007) */
     if (options->check_multiplicity) {
-        pass4_validate_multiplicities(&vctx, model);
+        clock = pass_clock_start(options, SYSML2_PASS_MULTIPLICITIES);
+        pass4_validate_multiplicities(&vctx, model, 0, model->element_count);
+        pass_clock_stop(options, SYSML2_PASS_MULTIPLICITIES, clock);
     }
 
     /* Pass 5: Validate redefines (E3002, E3008) */
     if (options->check_undefined_features || options->check_redefinition_compat) {
-        pass5_validate_redefines(&vctx, model);
+        clock = pass_clock_start(options, SYSML2_PASS_REDEFINES);
+        pass5_validate_redefines(&vctx, model, 0, model->element_count);
+        pass_clock_stop(options, SYSML2_PASS_REDEFINES, clock);
     }
 
     /* Pass 6: Validate imports (E3003) */
     if (options->check_undefined_namespaces) {
+        clock = pass_clock_start(options, SYSML2_PASS_IMPORTS);
         pass6_validate_imports(&vctx, model);
+        pass_clock_stop(options, SYSML2_PASS_IMPORTS, clock);
     }
 
     /* Pass 7: Abstract instantiation warnings */
     if (options->warn_abstract_instantiation) {
-        pass7_check_abstract_instantiation(&vctx, model);
+        clock = pass_clock_start(options, SYSML2_PASS_ABSTRACT);
+        pass7_check_abstract_instantiation(&vctx, model, 0, model->element_count);
+        pass_clock_stop(options, SYSML2_PASS_ABSTRACT, clock);
     }
 
     /* Cleanup */
@@ -1255,6 +2053,265 @@ Sysml2Result sysml2_validate(
     return vctx.has_errors ? SYSML2_ERROR_SEMANTIC : SYSML2_OK;
 }
 
+/* ========== Parallel Validation ========== */
+
+/*
+ * After pass 1 the symbol table is complete and passes 2, 4, 5 and 7
+ * only read it, one element at a time. With jobs > 1 these passes run
+ * over element chunks on a worker pool: each worker resolves through a
+ * read-only view of the table with its own arena and type cache, and
+ * each chunk reports into its own diagnostic list per pass (swept once
+ * when the passes are fused, see Range Passes above). The lists
+ * are merged pass by pass in model and element order, interleaved with
+ * the serial passes 3 and 6, which reproduces the serial output exactly.
+ */
+
+/* Elements per parallel validation task */
+#define VALIDATE_CHUNK_ELEMENTS 4096
+
+/* Work queue shared by validation workers */
+typedef struct {
+    ValidateTask *tasks;
+    size_t count;
+    size_t next;                /* Next task to hand out */
+    const Sysml2SymbolTable *symtab;
+    const Sysml2ValidationOptions *options;
+    RangePass passes[RANGE_PASS_COUNT]; /* NULL where disabled */
+    bool fused;                 /* Sweep each task once (see fused_sweep) */
+    pthread_mutex_t lock;
+} ValidateQueue;
+
+/* Worker state; the arena holds its task diagnostics until merged */
+typedef struct {
+    ValidateQueue *queue;
+    Sysml2Arena arena;
+    uint64_t pass_wall_ns[RANGE_PASS_COUNT];    /* Time per pass (with stats) */
+    uint64_t pass_cpu_ns[RANGE_PASS_COUNT];
+} ValidateWorker;
+
+static void *validate_worker(void *arg) {
+    ValidateWorker *worker = arg;
+    ValidateQueue *queue = worker->queue;
+
+    Sysml2SymbolTable view;
+    sysml2_symtab_init_view(&view, queue->symtab, &worker->arena);
+    TypeCache types;
+    type_cache_init(&types, &worker->arena);
+
+    for (;;) {
+        pthread_mutex_lock(&queue->lock);
+        if (queue->next >= queue->count) {
+            pthread_mutex_unlock(&queue->lock);
+            break;
+        }
+        ValidateTask *task = &queue->tasks[queue->next++];
+        pthread_mutex_unlock(&queue->lock);
+
+        ValidationContext base = {
+            .symtab = &view,
+            .source_file = task->model->source_file,
+            .options = queue->options,
+            .types = &types,
+        };
+        ValidationContext vctx[RANGE_PASS_COUNT];
+        task_contexts(vctx, task, &base, &worker->arena);
+
+        if (queue->fused) {
+            fused_sweep(vctx, queue->passes, task);
+        } else {
+            for (size_t p = 0; p < RANGE_PASS_COUNT; p++) {
+                if (!queue->passes[p]) continue;
+
+                /* Each chunk is its own span on the worker's track */
+                PassClock clock = pass_clock_start(queue->options, range_pass_ids[p]);
+                queue->passes[p](&vctx[p], task->model, task->begin, task->end);
+                sysml2_trace_end(queue->options->trace);
+                if (queue->options->stats) {
+                    worker->pass_wall_ns[p] += sysml2_stats_wall_ns() - clock.wall_ns;
+                    worker->pass_cpu_ns[p] += sysml2_stats_thread_cpu_ns() - clock.cpu_ns;
+                }
+            }
+        }
+        for (size_t p = 0; p < RANGE_PASS_COUNT; p++) {
+            if (vctx[p].has_errors) task->has_errors = true;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Run passes 2, 4, 5 and 7 on the worker pool, then report everything
+ * from pass 2 onwards in serial order
+ *
+ * Returns false without reporting anything if the pool could not be
+ * set up; the caller then validates serially.
+ */
+static bool validate_parallel(
+    ValidationContext *vctx,
+    SysmlSemanticModel **models,
+    size_t model_count,
+    size_t jobs
+) {
+    const Sysml2ValidationOptions *options = vctx->options;
+
+    size_t task_count = 0;
+    for (size_t i = 0; i < model_count; i++) {
+        if (models[i]) {
+            task_count += (models[i]->element_count + VALIDATE_CHUNK_ELEMENTS - 1) /
+                          VALIDATE_CHUNK_ELEMENTS;
+        }
+    }
+    if (task_count < 2) return false;
+
+    size_t worker_count = SYSML2_MIN(jobs, task_count);
+    ValidateTask *tasks = calloc(task_count, sizeof(ValidateTask));
+    ValidateWorker *workers = calloc(worker_count, sizeof(ValidateWorker));
+    pthread_t *threads = malloc(worker_count * sizeof(pthread_t));
+    if (!tasks || !workers || !threads) {
+        free(tasks);
+        free(workers);
+        free(threads);
+        return false;
+    }
+
+    size_t t = 0;
+    for (size_t i = 0; i < model_count; i++) {
+        if (!models[i]) continue;
+        for (size_t begin = 0; begin < models[i]->element_count; begin += VALIDATE_CHUNK_ELEMENTS) {
+            tasks[t].model = models[i];
+            tasks[t].begin = begin;
+            tasks[t].end = SYSML2_MIN(begin + VALIDATE_CHUNK_ELEMENTS, models[i]->element_count);
+            t++;
+        }
+    }
+
+    ValidateQueue queue = {
+        .tasks = tasks,
+        .count = task_count,
+        .next = 0,
+        .symtab = vctx->symtab,
+        .options = options,
+        .fused = fuse_passes(options)
+    };
+    range_passes_init(options, queue.passes);
+    pthread_mutex_init(&queue.lock, NULL);
+
+    /* The calling thread is the last worker, so every task runs even if
+     * fewer threads could be started */
+    size_t started = 0;
+    for (size_t w = 0; w < worker_count; w++) {
+        workers[w].queue = &queue;
+        sysml2_arena_init(&workers[w].arena);
+    }
+    for (size_t w = 0; w + 1 < worker_count; w++) {
+        if (pthread_create(&threads[w], NULL, validate_worker, &workers[w]) != 0) break;
+        started++;
+    }
+    validate_worker(&workers[worker_count - 1]);
+    for (size_t w = 0; w < started; w++) {
+        pthread_join(threads[w], NULL);
+    }
+    pthread_mutex_destroy(&queue.lock);
+
+    /* Worker pass times are summed over threads */
+    for (size_t p = 0; options->stats && p < RANGE_PASS_COUNT; p++) {
+        if (!queue.passes[p]) continue;
+        uint64_t wall = 0, cpu = 0;
+        for (size_t w = 0; w < worker_count; w++) {
+            wall += workers[w].pass_wall_ns[p];
+            cpu += workers[w].pass_cpu_ns[p];
+        }
+        sysml2_stats_add_pass(options->stats, range_pass_ids[p], wall, cpu);
+    }
+
+    report_range_passes(vctx, models, model_count, tasks, task_count, true);
+
+    for (size_t w = 0; w < worker_count; w++) {
+        sysml2_arena_destroy(&workers[w].arena);
+    }
+    free(threads);
+    free(workers);
+    free(tasks);
+    return true;
+}
+
+/* ========== Symbol Layers ========== */
+
+Sysml2Result sysml2_validator_build_layer(
+    Sysml2SymbolLayer *layer,
+    SysmlSemanticModel **models,
+    size_t model_count,
+    Sysml2Arena *arena,
+    Sysml2Intern *intern
+) {
+    memset(layer, 0, sizeof(*layer));
+    if (!arena || !intern || (model_count > 0 && !models)) return SYSML2_ERROR_SEMANTIC;
+
+    layer->models = model_count > 0
+        ? SYSML2_ARENA_NEW_ARRAY(arena, SysmlSemanticModel *, model_count) : NULL;
+    if (model_count > 0 && !layer->models) return SYSML2_ERROR_OUT_OF_MEMORY;
+
+    Sysml2ValidationOptions index_opts = SYSML_VALIDATION_OPTIONS_DEFAULT;
+    index_opts.check_duplicate_names = false;
+    sysml2_symtab_init(&layer->symtab, arena, intern);
+    ValidationContext vctx = {
+        .symtab = &layer->symtab,
+        .options = &index_opts,
+    };
+    for (size_t i = 0; i < model_count; i++) {
+        if (!models[i]) continue;
+        layer->models[layer->model_count++] = models[i];
+        vctx.source_file = models[i]->source_file;
+        pass1_build_symtab(&vctx, models[i]);
+    }
+    sysml2_symtab_freeze(&layer->symtab);
+    layer->has_duplicates = vctx.duplicate_count > 0;
+    return SYSML2_OK;
+}
+
+/*
+ * Which of models a layer has indexed, if it can serve this validation
+ *
+ * @return Per model: in the layer; NULL when the layer does not apply
+ */
+static bool *layer_members(
+    const Sysml2SymbolLayer *layer,
+    SysmlSemanticModel **models,
+    size_t model_count,
+    SysmlSemanticModel **targets,
+    bool check_duplicates,
+    Sysml2Arena *arena
+) {
+    if (!layer || layer->model_count == 0 || layer->model_count > model_count) return NULL;
+
+    /* Open-addressed index of models by address: model index + 1, 0 = empty */
+    size_t capacity = 16;
+    while (capacity < model_count * 2) capacity *= 2;
+    size_t mask = capacity - 1;
+    size_t *slots = sysml2_arena_calloc(arena, capacity, sizeof(size_t));
+    bool *members = SYSML2_ARENA_NEW_ARRAY(arena, bool, model_count);
+    if (!slots || !members) return NULL;
+    for (size_t i = 0; i < model_count; i++) {
+        if (!models[i]) continue;
+        size_t idx = sysml2_id_hash((const char *)models[i]) & mask;
+        while (slots[idx]) idx = (idx + 1) & mask;
+        slots[idx] = i + 1;
+    }
+
+    for (size_t j = 0; j < layer->model_count; j++) {
+        const SysmlSemanticModel *model = layer->models[j];
+        size_t idx = sysml2_id_hash((const char *)model) & mask;
+        while (slots[idx] && models[slots[idx] - 1] != model) idx = (idx + 1) & mask;
+        if (!slots[idx]) return NULL;
+
+        /* Duplicates within the layer were never reported */
+        size_t i = slots[idx] - 1;
+        if (layer->has_duplicates && check_duplicates && targets[i]) return NULL;
+        members[i] = true;
+    }
+    return members;
+}
+
 /* ========== Multi-Model Validation ========== */
 
 Sysml2Result sysml2_validate_multi(
@@ -1264,6 +2321,18 @@ Sysml2Result sysml2_validate_multi(
     Sysml2Arena *arena,
     Sysml2Intern *intern,
     const Sysml2ValidationOptions *options
+) {
+    return sysml2_validate_subset(models, model_count, NULL, diag_ctx, arena, intern, options);
+}
+
+Sysml2Result sysml2_validate_subset(
+    SysmlSemanticModel **models,
+    size_t model_count,
+    const bool *check,
+    Sysml2DiagContext *diag_ctx,
+    Sysml2Arena *arena,
+    Sysml2Intern *intern,
+    const Sysml2ValidationOptions *options
 ) {
     if (!models || model_count == 0 || !diag_ctx || !arena || !intern) {
         return SYSML2_ERROR_SEMANTIC;
@@ -1275,83 +2344,138 @@ Sysml2Result sysml2_validate_multi(
         options = &default_opts;
     }
 
-    /* Initialize unified symbol table */
+    /* Models to validate; passes 2-7 skip NULL entries */
+    SysmlSemanticModel **targets = models;
+    if (check) {
+        targets = SYSML2_ARENA_NEW_ARRAY(arena, SysmlSemanticModel *, model_count);
+        if (!targets) return SYSML2_ERROR_OUT_OF_MEMORY;
+        for (size_t i = 0; i < model_count; i++) {
+            targets[i] = check[i] ? models[i] : NULL;
+        }
+    }
+
+    /* Initialize unified symbol table, on the layer when it applies */
+    bool *layered = layer_members(options->layer, models, model_count, targets,
+                                  options->check_duplicate_names, arena);
     Sysml2SymbolTable symtab;
-    sysml2_symtab_init(&symtab, arena, intern);
+    if (layered) {
+        sysml2_symtab_init_overlay(&symtab, &options->layer->symtab, arena, intern);
+    } else {
+        sysml2_symtab_init(&symtab, arena, intern);
+    }
 
     /* Set up validation context (source_file set per-model in each pass) */
+    TypeCache types;
+    type_cache_init(&types, arena);
+
     ValidationContext vctx = {
         .symtab = &symtab,
         .diag_ctx = diag_ctx,
         .source_file = NULL,
         .options = options,
+        .types = &types,
         .has_errors = false
     };
 
-    /* Pass 1: Build unified symbol table from ALL models */
+    /* Pass 1: Build unified symbol table from ALL models, reporting
+     * duplicates only in the models being validated. The layer's models
+     * are indexed already. */
+    Sysml2Stats *stats = options->stats;
+    PassClock clock = pass_clock_start(options, SYSML2_PASS_SYMTAB);
+    Sysml2ValidationOptions index_opts = *options;
+    index_opts.check_duplicate_names = false;
     for (size_t i = 0; i < model_count; i++) {
-        if (models[i]) {
+        if (models[i] && !(layered && layered[i])) {
             vctx.source_file = models[i]->source_file;
+            vctx.options = targets[i] ? options : &index_opts;
             pass1_build_symtab(&vctx, models[i]);
         }
     }
+    vctx.options = options;
+    pass_clock_stop(options, SYSML2_PASS_SYMTAB, clock);
+    record_symtab_size(stats, &symtab);
+    models = targets;           /* Passes 2-7 only see the checked models */
+
+    /* Passes 2-7 on the worker pool when it pays off */
+    if (options->jobs > 1 && validate_parallel(&vctx, models, model_count, options->jobs)) {
+        sysml2_symtab_destroy(&symtab);
+        return vctx.has_errors ? SYSML2_ERROR_SEMANTIC : SYSML2_OK;
+    }
+
+    /* Passes 2-7 with one sweep per model */
+    if (fuse_passes(options) && validate_fused(&vctx, models, model_count, true)) {
+        sysml2_symtab_destroy(&symtab);
+        return vctx.has_errors ? SYSML2_ERROR_SEMANTIC : SYSML2_OK;
+    }
 
     /* Pass 2: Resolve types across all models */
+    clock = pass_clock_start(options, SYSML2_PASS_TYPES);
     for (size_t i = 0; i < model_count; i++) {
         if (models[i]) {
             vctx.source_file = models[i]->source_file;
-            pass2_resolve_types(&vctx, models[i]);
+            pass2_resolve_types(&vctx, models[i], 0, models[i]->element_count);
         }
     }
+    pass_clock_stop(options, SYSML2_PASS_TYPES, clock);
 
     /* Pass 3: Detect cycles across all models */
     if (options->check_circular_specs) {
+        clock = pass_clock_start(options, SYSML2_PASS_CYCLES);
         for (size_t i = 0; i < model_count; i++) {
             if (models[i]) {
                 vctx.source_file = models[i]->source_file;
                 pass3_detect_cycles(&vctx, models[i]);
             }
         }
+        pass_clock_stop(options, SYSML2_PASS_CYCLES, clock);
     }
 
     /* Pass 4: Validate multiplicities (E3007) */
     if (options->check_multiplicity) {
+        clock = pass_clock_start(options, SYSML2_PASS_MULTIPLICITIES);
         for (size_t i = 0; i < model_count; i++) {
             if (models[i]) {
                 vctx.source_file = models[i]->source_file;
-                pass4_validate_multiplicities(&vctx, models[i]);
+                pass4_validate_multiplicities(&vctx, models[i], 0, models[i]->element_count);
             }
         }
+        pass_clock_stop(options, SYSML2_PASS_MULTIPLICITIES, clock);
     }
 
     /* Pass 5: Validate redefines (E3002, E3008) */
     if (options->check_undefined_features || options->check_redefinition_compat) {
+        clock = pass_clock_start(options, SYSML2_PASS_REDEFINES);
         for (size_t i = 0; i < model_count; i++) {
             if (models[i]) {
                 vctx.source_file = models[i]->source_file;
-                pass5_validate_redefines(&vctx, models[i]);
+                pass5_validate_redefines(&vctx, models[i], 0, models[i]->element_count);
             }
         }
+        pass_clock_stop(options, SYSML2_PASS_REDEFINES, clock);
     }
 
     /* Pass 6: Validate imports (E3003) */
     if (options->check_undefined_namespaces) {
+        clock = pass_clock_start(options, SYSML2_PASS_IMPORTS);
         for (size_t i = 0; i < model_count; i++) {
             if (models[i]) {
                 vctx.source_file = models[i]->source_file;
                 pass6_validate_imports(&vctx, models[i]);
             }
         }
+        pass_clock_stop(options, SYSML2_PASS_IMPORTS, clock);
     }
 
     /* Pass 7: Abstract instantiation warnings */
     if (options->warn_abstract_instantiation) {
+        clock = pass_clock_start(options, SYSML2_PASS_ABSTRACT);
         for (size_t i = 0; i < model_count; i++) {
             if (models[i]) {
                 vctx.source_file = models[i]->source_file;
-                pass7_check_abstract_instantiation(&vctx, models[i]);
+                pass7_check_abstract_instantiation(&vctx, models[i], 0, models[i]->element_count);
             }
         }
+        pass_clock_stop(options, SYSML2_PASS_ABSTRACT, clock);
     }
 
     /* Cleanup */
@@ -1359,3 +2483,118 @@ Sysml2Result sysml2_validate_multi(
 
     return vctx.has_errors ? SYSML2_ERROR_SEMANTIC : SYSML2_OK;
 }
+
+/* ========== Reference Index ========== */
+
+/* Index the resolved targets of one reference list */
+static bool index_refs(
+    ValidationContext *vctx,
+    Sysml2RefIndex *index,
+    SysmlNode *node,
+    Sysml2Scope *scope,
+    const char **refs,
+    Sysml2Symbol **resolved,
+    size_t ref_count,
+    Sysml2RefKind kind
+) {
+    for (size_t i = 0; i < ref_count; i++) {
+        Sysml2Symbol *sym = resolved ? resolved[i]
+            : sysml2_symtab_resolve(vctx->symtab, scope, refs[i]);
+        if (!sym || !sym->node || !sym->node->id) continue;
+        if (!sysml2_ref_index_add(index, sym->node->id, node, kind, vctx->types->arena)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Index one element's redefinitions, resolved as in pass 5 */
+static bool index_redefines(ValidationContext *vctx, Sysml2RefIndex *index, SysmlNode *node) {
+    SysmlNode *parent_type = get_parent_type_node(vctx, node);
+    Sysml2Scope *scope = sysml2_symtab_get_or_create_node_scope(vctx->symtab, node);
+
+    for (size_t i = 0; i < node->redefines_count; i++) {
+        const char *ref = node->redefines[i];
+        SysmlNode *orig_feature = NULL;
+        if (!strchr(ref, ':')) {
+            orig_feature = find_inherited_feature(vctx, parent_type, ref, true);
+        } else {
+            Sysml2Symbol *sym = sysml2_symtab_resolve(vctx->symtab, scope, ref);
+            orig_feature = sym ? sym->node : NULL;
+        }
+        if (orig_feature && orig_feature->id &&
+            !sysml2_ref_index_add(index, orig_feature->id, node, SYSML2_REF_REDEFINES,
+                                  vctx->types->arena)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Sysml2Result sysml2_validator_index_references(
+    SysmlSemanticModel **models,
+    size_t model_count,
+    Sysml2Arena *arena,
+    Sysml2Intern *intern,
+    Sysml2RefIndex *index
+) {
+    Sysml2SymbolTable symtab;
+    sysml2_symtab_init(&symtab, arena, intern);
+    TypeCache types;
+    type_cache_init(&types, arena);
+
+    /* Same symbol table as validation, without its diagnostics */
+    Sysml2ValidationOptions options = SYSML_VALIDATION_OPTIONS_DEFAULT;
+    options.check_duplicate_names = false;
+    ValidationContext vctx = {
+        .symtab = &symtab,
+        .options = &options,
+        .types = &types,
+    };
+    for (size_t i = 0; i < model_count; i++) {
+        if (models[i]) pass1_build_symtab(&vctx, models[i]);
+    }
+
+    bool ok = true;
+    for (size_t m = 0; m < model_count && ok; m++) {
+        SysmlSemanticModel *model = models[m];
+        if (!model) continue;
+
+        for (size_t i = 0; i < model->element_count && ok; i++) {
+            SysmlNode *node = model->elements[i];
+            if (!node->id) continue;
+
+            Sysml2Scope *scope = sysml2_symtab_get_or_create_node_scope(&symtab, node);
+            if (node->typed_by_count + node->specializes_count > 0) {
+                Sysml2Symbol **bases = type_bases(&vctx, node);
+                ok = index_refs(&vctx, index, node, scope, node->typed_by, bases,
+                                node->typed_by_count, SYSML2_REF_TYPED_BY) &&
+                     index_refs(&vctx, index, node, scope, node->specializes,
+                                bases ? bases + node->typed_by_count : NULL,
+                                node->specializes_count, SYSML2_REF_SPECIALIZES);
+            }
+            if (ok && node->redefines_count > 0) {
+                ok = index_redefines(&vctx, index, node);
+            }
+            if (ok && node->references_count > 0) {
+                ok = index_refs(&vctx, index, node, scope, node->references, NULL,
+                                node->references_count, SYSML2_REF_REFERENCES);
+            }
+        }
+
+        /* Relationship endpoints are qualified IDs: the source uses the target */
+        for (size_t i = 0; i < model->relationship_count && ok; i++) {
+            SysmlRelationship *rel = model->relationships[i];
+            if (!rel || !rel->source || !rel->target) continue;
+            Sysml2Symbol *source = sysml2_symtab_resolve(&symtab, symtab.root_scope, rel->source);
+            Sysml2Symbol *target = sysml2_symtab_resolve(&symtab, symtab.root_scope, rel->target);
+            if (source && source->node && target && target->node && target->node->id) {
+                ok = sysml2_ref_index_add(index, target->node->id, source->node,
+                                          SYSML2_REF_RELATIONSHIP, arena);
+            }
+        }
+    }
+
+    sysml2_symtab_destroy(&symtab);
+    return ok ? SYSML2_OK : SYSML2_ERROR_OUT_OF_MEMORY;
+}
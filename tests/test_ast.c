@@ -397,6 +397,40 @@ TEST(node_with_parent) {
     FIXTURE_TEARDOWN();
 }
 
+TEST(node_path_fields) {
+    FIXTURE_SETUP();
+
+    SysmlBuildContext *ctx = sysml2_build_context_create(&arena, &intern, "test");
+
+    SysmlNode *pkg = sysml2_build_node(ctx, SYSML_KIND_PACKAGE, "Pkg");
+    sysml2_build_add_element(ctx, pkg);
+    sysml2_build_push_scope(ctx, pkg->id);
+    SysmlNode *def = sysml2_build_node(ctx, SYSML_KIND_PART_DEF, "Engine");
+    sysml2_build_add_element(ctx, def);
+    sysml2_build_push_scope(ctx, def->id);
+    SysmlNode *attr = sysml2_build_node(ctx, SYSML_KIND_ATTRIBUTE_USAGE, "mass");
+
+    ASSERT(pkg->has_path);
+    ASSERT_NULL(pkg->parent);
+    ASSERT_EQ(pkg->depth, 0);
+    ASSERT(def->parent == pkg);
+    ASSERT(attr->parent == def);
+    ASSERT_EQ(attr->depth, 2);
+    ASSERT_STR_EQ(sysml2_node_local_id(attr), "mass");
+    ASSERT_EQ(sysml2_node_parent_length(attr), strlen("Pkg::Engine"));
+
+    /* A scope without an element: the path comes from the IDs */
+    sysml2_build_push_scope(ctx, "Pkg::Engine::Ghost");
+    SysmlNode *orphan = sysml2_build_node(ctx, SYSML_KIND_PART_USAGE, "p");
+    ASSERT_STR_EQ(orphan->id, "Pkg::Engine::Ghost::p");
+    ASSERT_NULL(orphan->parent);
+    ASSERT_EQ(orphan->depth, 3);
+    ASSERT_STR_EQ(sysml2_node_local_id(orphan), "p");
+
+    sysml2_build_context_destroy(ctx);
+    FIXTURE_TEARDOWN();
+}
+
 TEST(node_anonymous) {
     FIXTURE_SETUP();
 
@@ -603,10 +637,10 @@ TEST(node_initializes_new_fields) {
     ASSERT_EQ(node->redefines_count, 0);
     ASSERT_NULL(node->references);
     ASSERT_EQ(node->references_count, 0);
-    ASSERT_NULL(node->metadata);
-    ASSERT_EQ(node->metadata_count, 0);
-    ASSERT_NULL(node->prefix_metadata);
-    ASSERT_EQ(node->prefix_metadata_count, 0);
+    ASSERT_NULL(sysml2_node_cold(node)->metadata);
+    ASSERT_EQ(sysml2_node_cold(node)->metadata_count, 0);
+    ASSERT_NULL(sysml2_node_cold(node)->prefix_metadata);
+    ASSERT_EQ(sysml2_node_cold(node)->prefix_metadata_count, 0);
 
     sysml2_build_context_destroy(ctx);
     FIXTURE_TEARDOWN();
@@ -656,8 +690,8 @@ TEST(add_prefix_metadata_single) {
     SysmlNode *node = sysml2_build_node(ctx, SYSML_KIND_PART_DEF, "Engine");
     sysml2_build_add_prefix_metadata(ctx, node, "SourceLink");
 
-    ASSERT_EQ(node->prefix_metadata_count, 1);
-    ASSERT_STR_EQ(node->prefix_metadata[0], "SourceLink");
+    ASSERT_EQ(sysml2_node_cold(node)->prefix_metadata_count, 1);
+    ASSERT_STR_EQ(sysml2_node_cold(node)->prefix_metadata[0], "SourceLink");
 
     sysml2_build_context_destroy(ctx);
     FIXTURE_TEARDOWN();
@@ -672,9 +706,9 @@ TEST(add_prefix_metadata_multiple) {
     sysml2_build_add_prefix_metadata(ctx, node, "Deprecated");
     sysml2_build_add_prefix_metadata(ctx, node, "SourceLink");
 
-    ASSERT_EQ(node->prefix_metadata_count, 2);
-    ASSERT_STR_EQ(node->prefix_metadata[0], "Deprecated");
-    ASSERT_STR_EQ(node->prefix_metadata[1], "SourceLink");
+    ASSERT_EQ(sysml2_node_cold(node)->prefix_metadata_count, 2);
+    ASSERT_STR_EQ(sysml2_node_cold(node)->prefix_metadata[0], "Deprecated");
+    ASSERT_STR_EQ(sysml2_node_cold(node)->prefix_metadata[1], "SourceLink");
 
     sysml2_build_context_destroy(ctx);
     FIXTURE_TEARDOWN();
@@ -690,10 +724,10 @@ TEST(add_metadata_to_node) {
     sysml2_build_metadata_add_feature(ctx, meta, "filePath", "\"engine.cpp\"");
     sysml2_build_add_metadata(ctx, node, meta);
 
-    ASSERT_EQ(node->metadata_count, 1);
-    ASSERT_STR_EQ(node->metadata[0]->type_ref, "SourceLink");
-    ASSERT_EQ(node->metadata[0]->feature_count, 1);
-    ASSERT_STR_EQ(node->metadata[0]->features[0]->name, "filePath");
+    ASSERT_EQ(sysml2_node_cold(node)->metadata_count, 1);
+    ASSERT_STR_EQ(sysml2_node_cold(node)->metadata[0]->type_ref, "SourceLink");
+    ASSERT_EQ(sysml2_node_cold(node)->metadata[0]->feature_count, 1);
+    ASSERT_STR_EQ(sysml2_node_cold(node)->metadata[0]->features[0]->name, "filePath");
 
     sysml2_build_context_destroy(ctx);
     FIXTURE_TEARDOWN();
@@ -904,6 +938,7 @@ int main(void) {
     printf("\n  Node creation tests:\n");
     RUN_TEST(node_creation);
     RUN_TEST(node_with_parent);
+    RUN_TEST(node_path_fields);
     RUN_TEST(node_anonymous);
     RUN_TEST(node_location_fields);
 
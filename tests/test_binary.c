@@ -0,0 +1,417 @@
+/*
+ * SysML v2 Parser - Binary Model Format Tests
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "sysml2/common.h"
+#include "sysml2/arena.h"
+#include "sysml2/intern.h"
+#include "sysml2/ast.h"
+#include "sysml2/binary_model.h"
+#include "sysml2/binary_writer.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define TEST(name) static void test_##name(void)
+#define RUN_TEST(name) do { \
+    printf("  Running %s...", #name); \
+    fflush(stdout); \
+    tests_run++; \
+    test_##name(); \
+    tests_passed++; \
+    printf(" PASSED\n"); \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("\n    FAILED: %s at %s:%d\n", #cond, __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a, b) ASSERT((a) == (b))
+#define ASSERT_TRUE(a) ASSERT((a) == true)
+#define ASSERT_FALSE(a) ASSERT((a) == false)
+#define ASSERT_NOT_NULL(a) ASSERT((a) != NULL)
+#define ASSERT_SV_EQ(sv, str) ASSERT(sysml2_sv_equals_cstr((sv), (str)))
+
+/* Test fixture macros for arena/intern setup and teardown */
+#define FIXTURE_SETUP() \
+    Sysml2Arena arena; \
+    sysml2_arena_init(&arena); \
+    Sysml2Intern intern; \
+    sysml2_intern_init(&intern, &arena)
+
+#define FIXTURE_TEARDOWN() \
+    sysml2_intern_destroy(&intern); \
+    sysml2_arena_destroy(&arena)
+
+/* Helper: Create an empty model */
+static SysmlSemanticModel *create_test_model(Sysml2Arena *arena, const char *source_name) {
+    SysmlSemanticModel *model = SYSML2_ARENA_NEW(arena, SysmlSemanticModel);
+    model->source_name = source_name;
+    return model;
+}
+
+/* Helper: Append an element */
+static SysmlNode *add_element(
+    Sysml2Arena *arena,
+    SysmlSemanticModel *model,
+    const char *id,
+    const char *name,
+    SysmlNodeKind kind,
+    const char *parent_id
+) {
+    SysmlNode **elements = SYSML2_ARENA_NEW_ARRAY(arena, SysmlNode *, model->element_count + 1);
+    if (model->element_count) {
+        memcpy(elements, model->elements, model->element_count * sizeof(SysmlNode *));
+    }
+    SysmlNode *node = SYSML2_ARENA_NEW(arena, SysmlNode);
+    node->id = id;
+    node->name = name;
+    node->kind = kind;
+    node->parent_id = parent_id;
+    elements[model->element_count++] = node;
+    model->elements = elements;
+    return node;
+}
+
+/* Helper: Serialize models into a malloc'd buffer */
+static uint8_t *write_to_buffer(SysmlSemanticModel **models, size_t count, size_t *size) {
+    char *data = NULL;
+    FILE *out = open_memstream(&data, size);
+    ASSERT_NOT_NULL(out);
+    ASSERT_EQ(sysml2_binary_write(models, count, out), SYSML2_OK);
+    fclose(out);
+    return (uint8_t *)data;
+}
+
+/* Helper: Find an element by ID */
+static uint32_t find_element(const Sysml2BinaryModel *bm, const char *id) {
+    Sysml2BinaryElement e;
+    for (uint32_t i = 0; sysml2_binary_element(bm, i, &e); i++) {
+        if (sysml2_sv_equals_cstr(sysml2_binary_string(bm, e.id), id)) return i;
+    }
+    return SYSML2_BINARY_NONE;
+}
+
+/* Shared model: Pkg { part def Engine; part def Car { part engine : Engine; } } */
+static SysmlSemanticModel *create_vehicle_model(Sysml2Arena *arena, Sysml2Intern *intern) {
+    SysmlSemanticModel *model = create_test_model(arena, "vehicle.sysml");
+    add_element(arena, model, sysml2_intern(intern, "Pkg"), sysml2_intern(intern, "Pkg"),
+                SYSML_KIND_PACKAGE, NULL);
+    add_element(arena, model, sysml2_intern(intern, "Pkg::Engine"),
+                sysml2_intern(intern, "Engine"), SYSML_KIND_PART_DEF, sysml2_intern(intern, "Pkg"));
+    add_element(arena, model, sysml2_intern(intern, "Pkg::Car"), sysml2_intern(intern, "Car"),
+                SYSML_KIND_PART_DEF, sysml2_intern(intern, "Pkg"));
+    SysmlNode *engine = add_element(arena, model, sysml2_intern(intern, "Pkg::Car::engine"),
+                                    sysml2_intern(intern, "engine"), SYSML_KIND_PART_USAGE,
+                                    sysml2_intern(intern, "Pkg::Car"));
+
+    /* One reference by ID, one as written in the source */
+    engine->typed_by = SYSML2_ARENA_NEW_ARRAY(arena, const char *, 2);
+    engine->typed_by[0] = sysml2_intern(intern, "Pkg::Engine");
+    engine->typed_by[1] = sysml2_intern(intern, "Engine");
+    engine->typed_by_count = 2;
+
+    SysmlRelationship *rel = SYSML2_ARENA_NEW(arena, SysmlRelationship);
+    rel->id = sysml2_intern(intern, "rel1");
+    rel->kind = SYSML_KIND_REL_SPECIALIZATION;
+    rel->source = sysml2_intern(intern, "Pkg::Car");
+    rel->target = sysml2_intern(intern, "Base::Vehicle");
+    model->relationships = SYSML2_ARENA_NEW_ARRAY(arena, SysmlRelationship *, 1);
+    model->relationships[0] = rel;
+    model->relationship_count = 1;
+
+    SysmlImport *imp = SYSML2_ARENA_NEW(arena, SysmlImport);
+    imp->id = sysml2_intern(intern, "Pkg::import0");
+    imp->kind = SYSML_KIND_IMPORT_ALL;
+    imp->target = sysml2_intern(intern, "Base");
+    imp->owner_scope = sysml2_intern(intern, "Pkg");
+    imp->is_private = true;
+    model->imports = SYSML2_ARENA_NEW_ARRAY(arena, SysmlImport *, 1);
+    model->imports[0] = imp;
+    model->import_count = 1;
+
+    SysmlAlias *alias = SYSML2_ARENA_NEW(arena, SysmlAlias);
+    alias->id = sysml2_intern(intern, "Pkg::Motor");
+    alias->name = sysml2_intern(intern, "Motor");
+    alias->target = sysml2_intern(intern, "Pkg::Engine");
+    alias->owner_scope = sysml2_intern(intern, "Pkg");
+    model->aliases = SYSML2_ARENA_NEW_ARRAY(arena, SysmlAlias *, 1);
+    model->aliases[0] = alias;
+    model->alias_count = 1;
+
+    return model;
+}
+
+/* ========== Round Trip Tests ========== */
+
+TEST(binary_write_empty) {
+    size_t size;
+    uint8_t *data = write_to_buffer(NULL, 0, &size);
+    ASSERT_EQ(size, SYSML2_BINARY_HEADER_SIZE);
+    ASSERT(memcmp(data, SYSML2_BINARY_MAGIC, 8) == 0);
+
+    Sysml2BinaryModel bm;
+    ASSERT_EQ(sysml2_binary_open(&bm, data, size), SYSML2_OK);
+    for (int i = 0; i < SYSML2_BINARY_SECTION_COUNT; i++) {
+        ASSERT_EQ(sysml2_binary_count(&bm, (Sysml2BinarySection)i), 0);
+    }
+    free(data);
+}
+
+TEST(binary_round_trip_elements) {
+    FIXTURE_SETUP();
+
+    SysmlSemanticModel *model = create_vehicle_model(&arena, &intern);
+    size_t size;
+    uint8_t *data = write_to_buffer(&model, 1, &size);
+
+    Sysml2BinaryModel bm;
+    ASSERT_EQ(sysml2_binary_open(&bm, data, size), SYSML2_OK);
+    ASSERT_EQ(sysml2_binary_count(&bm, SYSML2_BINARY_SOURCES), 1);
+    ASSERT_EQ(sysml2_binary_count(&bm, SYSML2_BINARY_ELEMENTS), 4);
+
+    Sysml2BinarySource src;
+    ASSERT_TRUE(sysml2_binary_source(&bm, 0, &src));
+    ASSERT_SV_EQ(sysml2_binary_string(&bm, src.name), "vehicle.sysml");
+    ASSERT_EQ(src.elements.first, 0);
+    ASSERT_EQ(src.elements.count, 4);
+
+    Sysml2BinaryElement e;
+    ASSERT_TRUE(sysml2_binary_element(&bm, 0, &e));
+    ASSERT_SV_EQ(sysml2_binary_string(&bm, e.type), "Package");
+    ASSERT_EQ(e.parent, SYSML2_BINARY_NONE);
+
+    ASSERT_TRUE(sysml2_binary_element(&bm, 3, &e));
+    ASSERT_SV_EQ(sysml2_binary_string(&bm, e.id), "Pkg::Car::engine");
+    ASSERT_SV_EQ(sysml2_binary_string(&bm, e.name), "engine");
+    ASSERT_SV_EQ(sysml2_binary_string(&bm, e.type), "Part");
+
+    /* Parent and typing by ID become element indices */
+    ASSERT_EQ(e.parent, 2);
+    ASSERT_EQ(e.typed_by.count, 2);
+    ASSERT_EQ(sysml2_binary_ref(&bm, e.typed_by.first), 1);
+
+    /* Unresolved text stays a string */
+    uint32_t ref = sysml2_binary_ref(&bm, e.typed_by.first + 1);
+    ASSERT(ref & SYSML2_BINARY_REF_STRING);
+    ASSERT_SV_EQ(sysml2_binary_ref_text(&bm, ref), "Engine");
+    ASSERT_SV_EQ(sysml2_binary_ref_text(&bm, e.parent), "Pkg::Car");
+    ASSERT_EQ(e.specializes.count, 0);
+
+    free(data);
+    FIXTURE_TEARDOWN();
+}
+
+TEST(binary_round_trip_relationships) {
+    FIXTURE_SETUP();
+
+    SysmlSemanticModel *model = create_vehicle_model(&arena, &intern);
+    size_t size;
+    uint8_t *data = write_to_buffer(&model, 1, &size);
+
+    Sysml2BinaryModel bm;
+    ASSERT_EQ(sysml2_binary_open(&bm, data, size), SYSML2_OK);
+
+    Sysml2BinaryRelationship rel;
+    ASSERT_TRUE(sysml2_binary_relationship(&bm, 0, &rel));
+    ASSERT_FALSE(sysml2_binary_relationship(&bm, 1, &rel));
+    ASSERT_SV_EQ(sysml2_binary_string(&bm, rel.id), "rel1");
+    ASSERT_SV_EQ(sysml2_binary_string(&bm, rel.type), "Specialization");
+    ASSERT_EQ(rel.source, find_element(&bm, "Pkg::Car"));
+    ASSERT_SV_EQ(sysml2_binary_ref_text(&bm, rel.target), "Base::Vehicle");
+
+    Sysml2BinaryImport imp;
+    ASSERT_TRUE(sysml2_binary_import(&bm, 0, &imp));
+    ASSERT_SV_EQ(sysml2_binary_string(&bm, imp.type), "ImportAll");
+    ASSERT_SV_EQ(sysml2_binary_ref_text(&bm, imp.target), "Base");
+    ASSERT_EQ(imp.owner, 0);
+    ASSERT_EQ(imp.flags, SYSML2_BINARY_IMPORT_PRIVATE);
+
+    Sysml2BinaryAlias alias;
+    ASSERT_TRUE(sysml2_binary_alias(&bm, 0, &alias));
+    ASSERT_SV_EQ(sysml2_binary_string(&bm, alias.name), "Motor");
+    ASSERT_EQ(alias.target, 1);
+
+    free(data);
+    FIXTURE_TEARDOWN();
+}
+
+TEST(binary_strings_deduplicated) {
+    FIXTURE_SETUP();
+
+    /* Equal content from distinct buffers is stored once */
+    char a[] = "Shared";
+    char b[] = "Shared";
+    SysmlSemanticModel *model = create_test_model(&arena, "dedup.sysml");
+    add_element(&arena, model, "X", a, SYSML_KIND_PART_DEF, NULL);
+    add_element(&arena, model, "Y", b, SYSML_KIND_PART_DEF, NULL);
+
+    size_t size;
+    uint8_t *data = write_to_buffer(&model, 1, &size);
+    Sysml2BinaryModel bm;
+    ASSERT_EQ(sysml2_binary_open(&bm, data, size), SYSML2_OK);
+
+    Sysml2BinaryElement x, y;
+    ASSERT_TRUE(sysml2_binary_element(&bm, 0, &x));
+    ASSERT_TRUE(sysml2_binary_element(&bm, 1, &y));
+    ASSERT_EQ(x.name, y.name);
+    ASSERT_EQ(x.type, y.type);
+
+    /* dedup.sysml, X, Shared, PartDef, Y */
+    ASSERT_EQ(sysml2_binary_count(&bm, SYSML2_BINARY_STRINGS), 5);
+
+    free(data);
+    FIXTURE_TEARDOWN();
+}
+
+TEST(binary_multiple_models) {
+    FIXTURE_SETUP();
+
+    SysmlSemanticModel *models[2];
+    models[0] = create_vehicle_model(&arena, &intern);
+    models[1] = create_test_model(&arena, "other.sysml");
+    add_element(&arena, models[1], "Other", "Other", SYSML_KIND_PACKAGE, NULL);
+    SysmlNode *use = add_element(&arena, models[1], "Other::e", "e", SYSML_KIND_PART_USAGE, "Other");
+    use->typed_by = SYSML2_ARENA_NEW_ARRAY(&arena, const char *, 1);
+    use->typed_by[0] = "Pkg::Engine";
+    use->typed_by_count = 1;
+
+    size_t size;
+    uint8_t *data = write_to_buffer(models, 2, &size);
+    Sysml2BinaryModel bm;
+    ASSERT_EQ(sysml2_binary_open(&bm, data, size), SYSML2_OK);
+    ASSERT_EQ(sysml2_binary_count(&bm, SYSML2_BINARY_SOURCES), 2);
+
+    Sysml2BinarySource src;
+    ASSERT_TRUE(sysml2_binary_source(&bm, 1, &src));
+    ASSERT_SV_EQ(sysml2_binary_string(&bm, src.name), "other.sysml");
+    ASSERT_EQ(src.elements.first, 4);
+    ASSERT_EQ(src.elements.count, 2);
+    ASSERT_EQ(src.relationships.first, 1);
+    ASSERT_EQ(src.relationships.count, 0);
+
+    /* Indices are global; references only resolve within their model */
+    Sysml2BinaryElement e;
+    ASSERT_TRUE(sysml2_binary_element(&bm, 5, &e));
+    ASSERT_EQ(e.parent, 4);
+    uint32_t ref = sysml2_binary_ref(&bm, e.typed_by.first);
+    ASSERT(ref & SYSML2_BINARY_REF_STRING);
+    ASSERT_SV_EQ(sysml2_binary_ref_text(&bm, ref), "Pkg::Engine");
+
+    free(data);
+    FIXTURE_TEARDOWN();
+}
+
+TEST(binary_map_file) {
+    FIXTURE_SETUP();
+
+    char path[] = "/tmp/sysml2_binary_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT(fd >= 0);
+    FILE *out = fdopen(fd, "wb");
+    ASSERT_NOT_NULL(out);
+    SysmlSemanticModel *model = create_vehicle_model(&arena, &intern);
+    ASSERT_EQ(sysml2_binary_write(&model, 1, out), SYSML2_OK);
+    fclose(out);
+
+    Sysml2BinaryModel bm;
+    ASSERT_EQ(sysml2_binary_map(&bm, path), SYSML2_OK);
+    ASSERT_EQ(find_element(&bm, "Pkg::Car::engine"), 3);
+    sysml2_binary_unmap(&bm);
+    unlink(path);
+
+    ASSERT_EQ(sysml2_binary_map(&bm, path), SYSML2_ERROR_FILE_NOT_FOUND);
+
+    FIXTURE_TEARDOWN();
+}
+
+/* ========== Malformed Input Tests ========== */
+
+TEST(binary_rejects_bad_header) {
+    FIXTURE_SETUP();
+
+    SysmlSemanticModel *model = create_vehicle_model(&arena, &intern);
+    size_t size;
+    uint8_t *data = write_to_buffer(&model, 1, &size);
+    Sysml2BinaryModel bm;
+
+    /* Truncated at every length */
+    for (size_t len = 0; len < size; len++) {
+        ASSERT_EQ(sysml2_binary_open(&bm, data, len), SYSML2_ERROR_SYNTAX);
+    }
+
+    data[0] ^= 0xFF;
+    ASSERT_EQ(sysml2_binary_open(&bm, data, size), SYSML2_ERROR_SYNTAX);
+    data[0] ^= 0xFF;
+
+    data[8]++;
+    ASSERT_EQ(sysml2_binary_open(&bm, data, size), SYSML2_ERROR_SYNTAX);
+    data[8]--;
+
+    /* Element section running past the end */
+    data[16 + SYSML2_BINARY_ELEMENTS * 8 + 4] = 0xFF;
+    ASSERT_EQ(sysml2_binary_open(&bm, data, size), SYSML2_ERROR_SYNTAX);
+
+    free(data);
+    FIXTURE_TEARDOWN();
+}
+
+TEST(binary_rejects_bad_records) {
+    FIXTURE_SETUP();
+
+    SysmlSemanticModel *model = create_vehicle_model(&arena, &intern);
+    size_t size;
+    uint8_t *data = write_to_buffer(&model, 1, &size);
+    Sysml2BinaryModel bm;
+    ASSERT_EQ(sysml2_binary_open(&bm, data, size), SYSML2_OK);
+
+    /* Out-of-range indices */
+    Sysml2BinaryElement e;
+    ASSERT_FALSE(sysml2_binary_element(&bm, 4, &e));
+    ASSERT_EQ(sysml2_binary_ref(&bm, 1000), SYSML2_BINARY_NONE);
+    ASSERT_EQ(sysml2_binary_string(&bm, 1000).data, NULL);
+    ASSERT_EQ(sysml2_binary_string(&bm, SYSML2_BINARY_NONE).data, NULL);
+    ASSERT_EQ(sysml2_binary_ref_text(&bm, 1000).data, NULL);
+    ASSERT_EQ(sysml2_binary_ref_text(&bm, SYSML2_BINARY_NONE).data, NULL);
+
+    /* String entry whose length runs past the end of the file */
+    uint32_t offsets = (uint32_t)data[16 + SYSML2_BINARY_STRINGS * 8] |
+                       ((uint32_t)data[16 + SYSML2_BINARY_STRINGS * 8 + 1] << 8);
+    uint32_t entry = (uint32_t)data[offsets] | ((uint32_t)data[offsets + 1] << 8);
+    data[entry + 3] = 0x7F;
+    ASSERT_EQ(sysml2_binary_string(&bm, 0).data, NULL);
+
+    free(data);
+    FIXTURE_TEARDOWN();
+}
+
+/* ========== Main ========== */
+
+int main(void) {
+    printf("Running binary model tests...\n");
+
+    /* Round trip */
+    RUN_TEST(binary_write_empty);
+    RUN_TEST(binary_round_trip_elements);
+    RUN_TEST(binary_round_trip_relationships);
+    RUN_TEST(binary_strings_deduplicated);
+    RUN_TEST(binary_multiple_models);
+    RUN_TEST(binary_map_file);
+
+    /* Malformed input */
+    RUN_TEST(binary_rejects_bad_header);
+    RUN_TEST(binary_rejects_bad_records);
+
+    printf("\n%d/%d tests passed.\n", tests_passed, tests_run);
+    return tests_passed == tests_run ? 0 : 1;
+}
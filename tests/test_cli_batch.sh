@@ -0,0 +1,203 @@
+#!/bin/bash
+#
+# Integration test for --batch
+#
+# Tests: file and inline records, one result line per document with its
+# syntax errors and diagnostics, exit codes, library types seen by every
+# document, results that match single-file runs, repeated documents,
+# malformed input and rejected option combinations
+#
+# SPDX-License-Identifier: MIT
+
+PARSER="${1:-./sysml2}"
+WORKDIR=$(mktemp -d)
+trap "rm -rf $WORKDIR" EXIT
+
+# Colors for output
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+NC='\033[0m' # No Color
+
+TESTS_PASSED=0
+TESTS_FAILED=0
+
+pass() {
+    echo -e "${GREEN}PASS${NC}: $1"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+}
+
+fail() {
+    echo -e "${RED}FAIL${NC}: $1"
+    echo "  Expected: $2"
+    echo "  Got:      $3"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+}
+
+assert_contains() {
+    local output="$1"
+    local expected="$2"
+    local testname="$3"
+
+    if echo "$output" | grep -q -- "$expected"; then
+        pass "$testname"
+    else
+        fail "$testname" "contains '$expected'" "not found in: $output"
+    fi
+}
+
+assert_equals() {
+    local actual="$1"
+    local expected="$2"
+    local testname="$3"
+
+    if [ "$actual" = "$expected" ]; then
+        pass "$testname"
+    else
+        fail "$testname" "$expected" "$actual"
+    fi
+}
+
+
+echo "=== CLI Batch Tests ==="
+echo "Parser: $PARSER"
+echo "Workdir: $WORKDIR"
+echo ""
+
+if [ ! -x "$PARSER" ]; then
+    echo "ERROR: Parser not found or not executable: $PARSER"
+    exit 1
+fi
+
+mkdir -p "$WORKDIR/lib" "$WORKDIR/docs"
+
+cat > "$WORKDIR/lib/Parts.sysml" << 'SYSML'
+package Parts {
+    part def Engine;
+}
+SYSML
+
+cat > "$WORKDIR/docs/good.sysml" << 'SYSML'
+package Good {
+    import Parts::*;
+    part e : Engine;
+}
+SYSML
+
+cat > "$WORKDIR/docs/undefined.sysml" << 'SYSML'
+package Undefined {
+    part w : Wheel;
+}
+SYSML
+
+cat > "$WORKDIR/docs/broken.sysml" << 'SYSML'
+package Broken {
+    part def
+SYSML
+
+# Print an inline record for a string
+inline() {
+    printf '@%d %s\n%s\n' "${#2}" "$1" "$2"
+}
+
+# ============================================================
+# TEST 1: file records
+# ============================================================
+echo "--- Test 1: files ---"
+
+OUTPUT=$(printf '%s\n' "$WORKDIR/docs/good.sysml" | "$PARSER" --batch -I "$WORKDIR/lib")
+assert_equals "$?" "0" "Clean document exits 0"
+assert_equals "$OUTPUT" "{\"path\":\"$WORKDIR/docs/good.sysml\",\"ok\":true,\"syntax\":null,\"diagnostics\":[]}" "Clean result line"
+
+OUTPUT=$(printf '%s\n' "$WORKDIR/docs/good.sysml" "$WORKDIR/docs/undefined.sysml" | "$PARSER" --batch -I "$WORKDIR/lib")
+assert_equals "$?" "2" "Validation error exits 2"
+assert_equals "$(echo "$OUTPUT" | wc -l)" "2" "One line per document"
+assert_contains "$(echo "$OUTPUT" | sed -n 2p)" '"ok":false,"syntax":null,"diagnostics":\[{"severity":"error","code":"E3001","line":2,"column":10' "Undefined type reported"
+
+OUTPUT=$(printf '%s\n' "$WORKDIR/docs/broken.sysml" "$WORKDIR/docs/missing.sysml" "$WORKDIR/docs/good.sysml" | "$PARSER" --batch -I "$WORKDIR/lib")
+assert_equals "$?" "1" "Syntax error exits 1"
+assert_contains "$(echo "$OUTPUT" | sed -n 1p)" '"ok":false,"syntax":".*broken.sysml:3:1: error' "Syntax error kept"
+assert_contains "$(echo "$OUTPUT" | sed -n 2p)" "\"syntax\":\"error: cannot read file '$WORKDIR/docs/missing.sysml'" "Unreadable file reported"
+assert_contains "$(echo "$OUTPUT" | sed -n 3p)" '"ok":true' "Documents after failures still validate"
+
+# ============================================================
+# TEST 2: inline records
+# ============================================================
+echo ""
+echo "--- Test 2: inline documents ---"
+
+OUTPUT=$({ inline a.sysml 'package A { part e : Parts::Engine; }'; inline "" 'package B { part x : Nope; }'; } |
+         "$PARSER" --batch -I "$WORKDIR/lib")
+assert_equals "$?" "2" "Inline validation error exits 2"
+assert_contains "$(echo "$OUTPUT" | sed -n 1p)" '{"path":"a.sysml","ok":true' "Named inline document"
+assert_contains "$(echo "$OUTPUT" | sed -n 2p)" '{"path":"<document 2>","ok":false' "Unnamed inline document"
+
+# Without the trailing newline, the next header follows the text at once
+OUTPUT=$(printf '@10 x.sysml\npackage X;@10 y.sysml\npackage Y;' | "$PARSER" --batch)
+assert_equals "$(echo "$OUTPUT" | grep -c '"ok":true')" "2" "Back-to-back documents"
+
+OUTPUT=$(printf '@100 cut.sysml\npackage C;' | "$PARSER" --batch 2>"$WORKDIR/err.txt")
+assert_equals "$?" "1" "Truncated document exits 1"
+assert_contains "$(cat "$WORKDIR/err.txt")" "error: truncated batch document 'cut.sysml'" "Truncated document reported"
+
+OUTPUT=$(printf '@x1 bad\n' | "$PARSER" --batch 2>"$WORKDIR/err.txt")
+assert_equals "$?" "1" "Bad header exits 1"
+assert_contains "$(cat "$WORKDIR/err.txt")" "error: invalid batch header '@x1 bad'" "Bad header reported"
+
+# ============================================================
+# TEST 3: results match single-file runs
+# ============================================================
+echo ""
+echo "--- Test 3: same results ---"
+
+# Each document is rewound before the next, so repeats come out the same
+LIST=""
+for i in $(seq 1 50); do
+    LIST="$LIST$WORKDIR/docs/undefined.sysml
+$WORKDIR/docs/good.sysml
+"
+done
+OUTPUT=$(printf '%s' "$LIST" | "$PARSER" --batch -I "$WORKDIR/lib")
+assert_equals "$(echo "$OUTPUT" | sort -u | wc -l)" "2" "Repeated documents give repeated results"
+
+SINGLE=$("$PARSER" -I "$WORKDIR/lib" --diagnostics-format json "$WORKDIR/docs/undefined.sysml" 2>&1 |
+         sed 's/.*"code":"\([^"]*\)","message":"\([^"]*\)".*/\1 \2/')
+BATCH=$(echo "$OUTPUT" | sed -n 1p | sed 's/.*"code":"\([^"]*\)".*"message":"\([^"]*\)".*/\1 \2/')
+assert_equals "$BATCH" "$SINGLE" "Diagnostics match a single-file run"
+
+OUTPUT=$(printf '%s\n' "$WORKDIR/docs/undefined.sysml" | "$PARSER" --batch --parse-only)
+assert_equals "$?" "0" "--parse-only skips validation"
+
+# ============================================================
+# TEST 4: rejected combinations
+# ============================================================
+echo ""
+echo "--- Test 4: option combinations ---"
+
+OUTPUT=$("$PARSER" --batch "$WORKDIR/docs/good.sysml" < /dev/null 2>&1)
+assert_equals "$?" "1" "File arguments rejected"
+assert_contains "$OUTPUT" "error: --batch cannot be combined with file arguments or other modes" "File arguments reported"
+
+OUTPUT=$("$PARSER" --batch --lazy-libraries -I "$WORKDIR/lib" < /dev/null 2>&1)
+assert_equals "$?" "1" "--lazy-libraries rejected"
+assert_contains "$OUTPUT" "error: --batch cannot be combined with --lazy-libraries" "--lazy-libraries reported"
+
+OUTPUT=$("$PARSER" --batch < /dev/null)
+assert_equals "$?" "0" "Empty batch exits 0"
+assert_equals "$OUTPUT" "" "Empty batch writes nothing"
+
+# ============================================================
+# Summary
+# ============================================================
+echo ""
+echo "=== Test Summary ==="
+echo "Passed: $TESTS_PASSED"
+echo "Failed: $TESTS_FAILED"
+echo ""
+
+if [ $TESTS_FAILED -gt 0 ]; then
+    echo -e "${RED}Some tests failed!${NC}"
+    exit 1
+else
+    echo -e "${GREEN}All tests passed!${NC}"
+    exit 0
+fi
@@ -0,0 +1,282 @@
+#!/bin/bash
+#
+# Integration test for --daemon fork server mode
+#
+# Tests: forwarded runs matching local ones, reuse of loaded libraries,
+# client stdin/cwd/SYSML2_LIBRARY_PATH, isolation between requests,
+# fallback without a daemon, stale and live sockets, access by other users
+#
+# SPDX-License-Identifier: MIT
+
+PARSER="${1:-./sysml2}"
+WORKDIR=$(mktemp -d)
+trap "rm -rf $WORKDIR" EXIT
+
+# Colors for output
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+NC='\033[0m' # No Color
+
+TESTS_PASSED=0
+TESTS_FAILED=0
+
+pass() {
+    echo -e "${GREEN}PASS${NC}: $1"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+}
+
+fail() {
+    echo -e "${RED}FAIL${NC}: $1"
+    echo "  Expected: $2"
+    echo "  Got:      $3"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+}
+
+assert_contains() {
+    local output="$1"
+    local expected="$2"
+    local testname="$3"
+
+    if echo "$output" | grep -q -- "$expected"; then
+        pass "$testname"
+    else
+        fail "$testname" "contains '$expected'" "not found in: $output"
+    fi
+}
+
+assert_equals() {
+    local actual="$1"
+    local expected="$2"
+    local testname="$3"
+
+    if [ "$actual" = "$expected" ]; then
+        pass "$testname"
+    else
+        fail "$testname" "$expected" "$actual"
+    fi
+}
+
+echo "=== CLI Fork Server Tests ==="
+echo "Parser: $PARSER"
+echo "Workdir: $WORKDIR"
+echo ""
+
+if [ ! -x "$PARSER" ]; then
+    echo "ERROR: Parser not found or not executable: $PARSER"
+    exit 1
+fi
+
+SOCKET="$WORKDIR/sysml2.sock"
+DAEMON_PID=""
+trap '[ -n "$DAEMON_PID" ] && kill $DAEMON_PID 2>/dev/null; rm -rf "$WORKDIR"' EXIT
+
+mkdir -p "$WORKDIR/lib" "$WORKDIR/model" "$WORKDIR/other"
+
+cat > "$WORKDIR/lib/Parts.sysml" << 'EOF2'
+package Parts {
+    part def Engine;
+}
+EOF2
+
+cat > "$WORKDIR/model/app.sysml" << 'EOF2'
+package App {
+    import Parts::*;
+    import Extra::*;
+    part e : Engine;
+    part f : Engin;
+}
+EOF2
+
+cat > "$WORKDIR/model/Extra.sysml" << 'EOF2'
+package Extra {
+    part def Wheel;
+}
+EOF2
+
+cat > "$WORKDIR/other/app.sysml" << 'EOF2'
+package Other {
+    import Parts::*;
+    import Extra::*;
+    part w : Wheel;
+}
+EOF2
+
+# Wait up to 10 s for the daemon to listen
+wait_for_socket() {
+    for _ in $(seq 100); do
+        [ -S "$SOCKET" ] && return 0
+        sleep 0.1
+    done
+    return 1
+}
+
+# A permissive umask must not open the socket to the group
+(umask 002; exec "$PARSER" --daemon "$SOCKET" -I "$WORKDIR/lib") 2>"$WORKDIR/daemon.err" &
+DAEMON_PID=$!
+if ! wait_for_socket; then
+    echo "ERROR: daemon did not start: $(cat "$WORKDIR/daemon.err")"
+    exit 1
+fi
+
+# ============================================================
+# TEST 1: forwarded runs match local runs
+# ============================================================
+echo "--- Test 1: forwarded output ---"
+
+LOCAL_OUT=$("$PARSER" -I "$WORKDIR/lib" -f json "$WORKDIR/model/app.sysml" 2>"$WORKDIR/local.err")
+LOCAL_EXIT=$?
+REMOTE_OUT=$(SYSML2_DAEMON="$SOCKET" "$PARSER" -I "$WORKDIR/lib" -f json "$WORKDIR/model/app.sysml" 2>"$WORKDIR/remote.err")
+REMOTE_EXIT=$?
+
+assert_equals "$REMOTE_OUT" "$LOCAL_OUT" "stdout matches"
+assert_equals "$(cat "$WORKDIR/remote.err")" "$(cat "$WORKDIR/local.err")" "stderr matches"
+assert_equals "$REMOTE_EXIT" "$LOCAL_EXIT" "Exit code matches"
+assert_equals "$REMOTE_EXIT" "2" "Semantic error exits 2"
+
+OUTPUT=$(SYSML2_DAEMON="$SOCKET" "$PARSER" -v -I "$WORKDIR/lib" "$WORKDIR/model/app.sysml" 2>&1)
+assert_contains "$OUTPUT" "reusing libraries loaded by the daemon" "Loaded libraries reused"
+if echo "$OUTPUT" | grep -q "preloading library files"; then
+    fail "Libraries not parsed again" "no preload" "$OUTPUT"
+else
+    pass "Libraries not parsed again"
+fi
+
+# ============================================================
+# TEST 2: stdin, working directory and SYSML2_LIBRARY_PATH
+# ============================================================
+echo ""
+echo "--- Test 2: client environment ---"
+
+OUTPUT=$(printf 'package S { part x : Parts::Engine; part y : Nope; }\n' | \
+    SYSML2_DAEMON="$SOCKET" "$PARSER" -I "$WORKDIR/lib" 2>&1)
+EXIT_CODE=$?
+assert_contains "$OUTPUT" "<stdin>:1:.*undefined type 'Nope'" "stdin forwarded"
+assert_equals "$EXIT_CODE" "2" "stdin exit code"
+
+OUTPUT=$(cd "$WORKDIR/model" && SYSML2_DAEMON="$SOCKET" "$PARSER" -v -I ../lib app.sysml 2>&1)
+assert_contains "$OUTPUT" "reusing libraries loaded by the daemon" "Relative -I resolved in client directory"
+LOCAL=$(cd "$WORKDIR/model" && "$PARSER" -I ../lib app.sysml 2>&1)
+REMOTE=$(cd "$WORKDIR/model" && SYSML2_DAEMON="$SOCKET" "$PARSER" -I ../lib app.sysml 2>&1)
+assert_equals "$REMOTE" "$LOCAL" "Relative input path resolved"
+assert_contains "$REMOTE" "app.sysml:5:.*undefined type 'Engin'" "Relative input validated"
+
+OUTPUT=$(SYSML2_LIBRARY_PATH="$WORKDIR/lib" SYSML2_DAEMON="$SOCKET" "$PARSER" -v "$WORKDIR/model/app.sysml" 2>&1)
+assert_contains "$OUTPUT" "reusing libraries loaded by the daemon" "SYSML2_LIBRARY_PATH forwarded"
+
+# ============================================================
+# TEST 3: other libraries and isolation between requests
+# ============================================================
+echo ""
+echo "--- Test 3: fresh state ---"
+
+OUTPUT=$(SYSML2_DAEMON="$SOCKET" "$PARSER" -v "$WORKDIR/model/app.sysml" 2>&1)
+EXIT_CODE=$?
+if echo "$OUTPUT" | grep -q "reusing libraries"; then
+    fail "Different library paths load from scratch" "no reuse" "$OUTPUT"
+else
+    pass "Different library paths load from scratch"
+fi
+assert_contains "$OUTPUT" "undefined type 'Engine'" "Without -I, Parts is missing"
+assert_equals "$EXIT_CODE" "2" "Exit code 2"
+
+# A previous request found Extra next to app.sysml; this one must not
+LOCAL=$("$PARSER" -I "$WORKDIR/lib" "$WORKDIR/other/app.sysml" 2>&1)
+REMOTE=$(SYSML2_DAEMON="$SOCKET" "$PARSER" -I "$WORKDIR/lib" "$WORKDIR/other/app.sysml" 2>&1)
+assert_equals "$REMOTE" "$LOCAL" "No state leaks between requests"
+assert_contains "$REMOTE" "undefined type 'Wheel'" "Extra not visible"
+
+# ============================================================
+# TEST 4: access by other users
+# ============================================================
+echo ""
+echo "--- Test 4: access ---"
+
+assert_equals "$(stat -c %a "$SOCKET")" "600" "Socket is owner-only"
+
+# Root passes the file mode, so a daemon run by nobody must check the peer
+if [ "$(id -u)" = "0" ] && command -v setpriv > /dev/null; then
+    SHARED="$WORKDIR/shared"
+    mkdir -p "$SHARED"
+    chmod 711 "$WORKDIR"
+    chmod 777 "$SHARED"
+    setpriv --reuid=65534 --regid=65534 --clear-groups \
+        "$PARSER" --daemon "$SHARED/nobody.sock" 2>"$SHARED/daemon.err" &
+    NOBODY_PID=$!
+    for _ in $(seq 100); do
+        [ -S "$SHARED/nobody.sock" ] && break
+        sleep 0.1
+    done
+    # A request run by that daemon would write its output as nobody
+    cp "$WORKDIR/model/Extra.sysml" "$SHARED/"
+    chmod 644 "$SHARED/Extra.sysml"
+    (cd "$SHARED" && SYSML2_DAEMON="$SHARED/nobody.sock" "$PARSER" -f json -o out.json \
+        Extra.sysml > /dev/null 2>&1)
+    if [ -e "$SHARED/out.json" ] && [ "$(stat -c %u "$SHARED/out.json")" = "65534" ]; then
+        fail "Other user's request not run" "no output written by nobody" "owned by 65534"
+    else
+        pass "Other user's request not run"
+    fi
+    assert_contains "$(cat "$SHARED/daemon.err")" "rejected a request from another user" "Daemon reports rejection"
+    kill -TERM $NOBODY_PID
+    wait $NOBODY_PID 2>/dev/null
+else
+    echo "SKIP: peer check needs root and setpriv"
+fi
+
+# ============================================================
+# TEST 5: fallback and daemon lifetime
+# ============================================================
+echo ""
+echo "--- Test 5: lifetime ---"
+
+OUTPUT=$(SYSML2_DAEMON="$WORKDIR/missing.sock" "$PARSER" -I "$WORKDIR/lib" "$WORKDIR/model/app.sysml" 2>&1)
+EXIT_CODE=$?
+assert_contains "$OUTPUT" "undefined type 'Engin'" "No daemon: command runs locally"
+assert_equals "$EXIT_CODE" "2" "Local exit code"
+
+OUTPUT=$("$PARSER" --daemon "$SOCKET" 2>&1)
+EXIT_CODE=$?
+assert_contains "$OUTPUT" "already listening" "Second daemon refused"
+assert_equals "$EXIT_CODE" "1" "Second daemon exits 1"
+
+OUTPUT=$("$PARSER" --daemon "$SOCKET" "$WORKDIR/model/app.sysml" 2>&1)
+assert_contains "$OUTPUT" "cannot be combined" "--daemon with files rejected"
+
+kill -TERM $DAEMON_PID
+wait $DAEMON_PID
+assert_equals "$?" "0" "Daemon exits 0 on SIGTERM"
+DAEMON_PID=""
+if [ -e "$SOCKET" ]; then
+    fail "Socket removed" "no $SOCKET" "still present"
+else
+    pass "Socket removed"
+fi
+
+# A daemon that was killed leaves its socket behind
+"$PARSER" --daemon "$SOCKET" -I "$WORKDIR/lib" 2>/dev/null &
+DAEMON_PID=$!
+wait_for_socket
+kill -KILL $DAEMON_PID
+wait $DAEMON_PID 2>/dev/null
+"$PARSER" --daemon "$SOCKET" -I "$WORKDIR/lib" 2>"$WORKDIR/daemon.err" &
+DAEMON_PID=$!
+sleep 0.5
+OUTPUT=$(SYSML2_DAEMON="$SOCKET" "$PARSER" -v -I "$WORKDIR/lib" "$WORKDIR/model/app.sysml" 2>&1)
+assert_contains "$OUTPUT" "reusing libraries loaded by the daemon" "Stale socket replaced"
+
+# ============================================================
+# Summary
+# ============================================================
+echo ""
+echo "=== Test Summary ==="
+echo "Passed: $TESTS_PASSED"
+echo "Failed: $TESTS_FAILED"
+echo ""
+
+if [ $TESTS_FAILED -gt 0 ]; then
+    echo -e "${RED}Some tests failed!${NC}"
+    exit 1
+else
+    echo -e "${GREEN}All tests passed!${NC}"
+    exit 0
+fi
@@ -0,0 +1,162 @@
+#!/bin/bash
+#
+# Integration test for --fix file writes
+#
+# Tests: already formatted files are not rewritten, parallel (-j)
+# rewrites match serial ones with messages in input order, write errors
+#
+# SPDX-License-Identifier: MIT
+
+PARSER="${1:-./sysml2}"
+WORKDIR=$(mktemp -d)
+trap "rm -rf $WORKDIR" EXIT
+
+# Colors for output
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+NC='\033[0m' # No Color
+
+TESTS_PASSED=0
+TESTS_FAILED=0
+
+pass() {
+    echo -e "${GREEN}PASS${NC}: $1"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+}
+
+fail() {
+    echo -e "${RED}FAIL${NC}: $1"
+    echo "  Expected: $2"
+    echo "  Got:      $3"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+}
+
+assert_contains() {
+    local output="$1"
+    local expected="$2"
+    local testname="$3"
+
+    if echo "$output" | grep -q -- "$expected"; then
+        pass "$testname"
+    else
+        fail "$testname" "contains '$expected'" "not found in: $output"
+    fi
+}
+
+assert_equals() {
+    local actual="$1"
+    local expected="$2"
+    local testname="$3"
+
+    if [ "$actual" = "$expected" ]; then
+        pass "$testname"
+    else
+        fail "$testname" "$expected" "$actual"
+    fi
+}
+
+echo "=== CLI --fix Write Tests ==="
+echo "Parser: $PARSER"
+echo "Workdir: $WORKDIR"
+echo ""
+
+if [ ! -x "$PARSER" ]; then
+    echo "ERROR: Parser not found or not executable: $PARSER"
+    exit 1
+fi
+
+# Write n files into dir; odd-numbered ones need reformatting
+make_files() {
+    local dir="$1"
+    local n="$2"
+    mkdir -p "$dir"
+    for i in $(seq 1 "$n"); do
+        if [ $((i % 2)) -eq 1 ]; then
+            printf 'package P%d {\npart def   Part%d;\n}\n' "$i" "$i" > "$dir/p$i.sysml"
+        else
+            printf 'package P%d {\n    part def Part%d;\n}\n' "$i" "$i" > "$dir/p$i.sysml"
+        fi
+    done
+}
+
+# ============================================================
+# TEST 1: formatted files are not rewritten
+# ============================================================
+echo "--- Test 1: skip unchanged files ---"
+
+make_files "$WORKDIR/one" 2
+INODE_BEFORE=$(stat -c %i "$WORKDIR/one/p2.sysml")
+OUTPUT=$("$PARSER" --fix -v "$WORKDIR/one/p1.sysml" "$WORKDIR/one/p2.sysml" 2>&1)
+EXIT_CODE=$?
+INODE_AFTER=$(stat -c %i "$WORKDIR/one/p2.sysml")
+
+assert_equals "$EXIT_CODE" "0" "Exit code 0"
+assert_equals "$INODE_AFTER" "$INODE_BEFORE" "Formatted file is left in place"
+assert_contains "$OUTPUT" "Unchanged: .*p2.sysml" "Unchanged file reported"
+assert_contains "$OUTPUT" "Formatted: .*p1.sysml" "Changed file reported"
+assert_equals "$(sed -n 2p "$WORKDIR/one/p1.sysml")" "    part def Part1;" "Changed file is rewritten"
+
+INODE_BEFORE=$(stat -c %i "$WORKDIR/one/p1.sysml")
+"$PARSER" --fix "$WORKDIR/one/p1.sysml" "$WORKDIR/one/p2.sysml" 2>/dev/null
+assert_equals "$(stat -c %i "$WORKDIR/one/p1.sysml")" "$INODE_BEFORE" "Second run rewrites nothing"
+
+# ============================================================
+# TEST 2: parallel writes match serial ones
+# ============================================================
+echo ""
+echo "--- Test 2: -j4 ---"
+
+make_files "$WORKDIR/serial" 12
+make_files "$WORKDIR/parallel" 12
+"$PARSER" --fix -r "$WORKDIR/serial" 2>/dev/null
+OUTPUT=$("$PARSER" --fix -v -j4 -r "$WORKDIR/parallel" 2>&1)
+EXIT_CODE=$?
+
+assert_equals "$EXIT_CODE" "0" "Exit code 0"
+if diff -r "$WORKDIR/serial" "$WORKDIR/parallel" > /dev/null; then
+    pass "Parallel output matches serial output"
+else
+    fail "Parallel output matches serial output" "identical trees" \
+        "$(diff -r "$WORKDIR/serial" "$WORKDIR/parallel")"
+fi
+assert_equals "$(echo "$OUTPUT" | grep -c '^Formatted: ')" "6" "Six files rewritten"
+assert_equals "$(echo "$OUTPUT" | grep -c '^Unchanged: ')" "6" "Six files left alone"
+WRITE_ORDER=$(echo "$OUTPUT" | grep -E '^(Formatted|Unchanged): ' | sed 's/^[A-Za-z]*: //')
+EXPECTED_ORDER=$(echo "$OUTPUT" | grep '^Processing: ' | sed 's/^Processing: //')
+assert_equals "$WRITE_ORDER" "$EXPECTED_ORDER" "Messages are in input order"
+assert_equals "$(ls "$WORKDIR/parallel" | grep -c '\.tmp\.')" "0" "No temp files left behind"
+
+# ============================================================
+# TEST 3: write errors are still reported
+# ============================================================
+echo ""
+echo "--- Test 3: unwritable directory ---"
+
+if [ "$(id -u)" != "0" ]; then
+    make_files "$WORKDIR/ro" 2
+    chmod a-w "$WORKDIR/ro"
+    OUTPUT=$("$PARSER" --fix -j2 "$WORKDIR/ro/p1.sysml" "$WORKDIR/ro/p2.sysml" 2>&1)
+    EXIT_CODE=$?
+    chmod u+w "$WORKDIR/ro"
+    assert_equals "$EXIT_CODE" "2" "Write failure exits 2"
+    assert_contains "$OUTPUT" "cannot create temp file" "Write failure reported"
+else
+    echo "SKIP: running as root, directory permissions are not enforced"
+fi
+
+# ============================================================
+# Summary
+# ============================================================
+echo ""
+echo "=== Test Summary ==="
+echo "Passed: $TESTS_PASSED"
+echo "Failed: $TESTS_FAILED"
+echo ""
+
+if [ $TESTS_FAILED -gt 0 ]; then
+    echo -e "${RED}Some tests failed!${NC}"
+    exit 1
+else
+    echo -e "${GREEN}All tests passed!${NC}"
+    exit 0
+fi
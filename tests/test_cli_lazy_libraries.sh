@@ -0,0 +1,230 @@
+#!/bin/bash
+#
+# Integration test for --lazy-libraries
+#
+# Tests: only imported and referenced library files are parsed, the
+# fallback for names from unimported library packages, diagnostics
+# matching an eager run, output limited to loaded files, the cached
+# package index
+#
+# SPDX-License-Identifier: MIT
+
+PARSER="${1:-./sysml2}"
+WORKDIR=$(mktemp -d)
+trap "rm -rf $WORKDIR" EXIT
+
+# Colors for output
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+NC='\033[0m' # No Color
+
+TESTS_PASSED=0
+TESTS_FAILED=0
+
+pass() {
+    echo -e "${GREEN}PASS${NC}: $1"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+}
+
+fail() {
+    echo -e "${RED}FAIL${NC}: $1"
+    echo "  Expected: $2"
+    echo "  Got:      $3"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+}
+
+assert_contains() {
+    local output="$1"
+    local expected="$2"
+    local testname="$3"
+
+    if echo "$output" | grep -q -- "$expected"; then
+        pass "$testname"
+    else
+        fail "$testname" "contains '$expected'" "not found in: $output"
+    fi
+}
+
+assert_equals() {
+    local actual="$1"
+    local expected="$2"
+    local testname="$3"
+
+    if [ "$actual" = "$expected" ]; then
+        pass "$testname"
+    else
+        fail "$testname" "$expected" "$actual"
+    fi
+}
+
+echo "=== CLI --lazy-libraries Tests ==="
+echo "Parser: $PARSER"
+echo "Workdir: $WORKDIR"
+echo ""
+
+if [ ! -x "$PARSER" ]; then
+    echo "ERROR: Parser not found or not executable: $PARSER"
+    exit 1
+fi
+
+mkdir -p "$WORKDIR/lib/sub" "$WORKDIR/model"
+
+cat > "$WORKDIR/lib/Parts.sysml" << 'EOF'
+package Parts {
+    import Base::*;
+    part def Engine :> Thing;
+}
+EOF
+
+cat > "$WORKDIR/lib/sub/base.sysml" << 'EOF'
+package Base {
+    part def Thing;
+}
+EOF
+
+cat > "$WORKDIR/lib/Units.sysml" << 'EOF'
+package Units {
+    attribute def Length;
+}
+EOF
+
+cat > "$WORKDIR/lib/Unused.sysml" << 'EOF'
+package Unused {
+    part def Gadget;
+}
+EOF
+
+cat > "$WORKDIR/lib/Implicit.sysml" << 'EOF'
+library package Implicit {
+    part def Widget;
+}
+EOF
+
+cat > "$WORKDIR/model/app.sysml" << 'EOF'
+package App {
+    import Parts::*;
+    part e : Engine;
+    attribute len : Units::Length;
+}
+EOF
+
+cat > "$WORKDIR/model/implicit.sysml" << 'EOF'
+package UsesImplicit {
+    part w : Widget;
+}
+EOF
+
+cat > "$WORKDIR/model/broken.sysml" << 'EOF'
+package Broken {
+    import Parts::*;
+    part e : Engine;
+    part n : Nope;
+}
+EOF
+
+# Number of library files a run loaded, from --stats=json
+library_files() {
+    "$PARSER" --stats=json "$@" 2>&1 >/dev/null | tail -1 | grep -o '"library":[0-9]*' | cut -d: -f2
+}
+
+# ============================================================
+# TEST 1: only imported and referenced files are parsed
+# ============================================================
+echo "--- Test 1: on-demand loading ---"
+
+OUTPUT=$("$PARSER" --lazy-libraries -I "$WORKDIR/lib" "$WORKDIR/model/app.sysml" 2>&1)
+EXIT_CODE=$?
+assert_equals "$EXIT_CODE" "0" "Exit code 0"
+assert_equals "$OUTPUT" "" "No diagnostics"
+assert_equals "$(library_files -I "$WORKDIR/lib" "$WORKDIR/model/app.sysml")" "5" "Eager run loads every library file"
+assert_equals "$(library_files --lazy-libraries -I "$WORKDIR/lib" "$WORKDIR/model/app.sysml")" "3" \
+    "Lazy run loads the import, its import and the qualified reference"
+
+OUTPUT=$("$PARSER" -v --lazy-libraries -I "$WORKDIR/lib" "$WORKDIR/model/app.sysml" 2>&1)
+assert_contains "$OUTPUT" "discovering packages in $WORKDIR/lib" "Library path is indexed"
+assert_contains "$OUTPUT" "loaded 1 referenced library file" "Qualified name loads Units"
+if echo "$OUTPUT" | grep -v "registered package" | grep -q "Unused.sysml"; then
+    fail "Unused file is not parsed" "no mention of Unused.sysml" "$OUTPUT"
+else
+    pass "Unused file is not parsed"
+fi
+
+# ============================================================
+# TEST 2: names from unimported library packages fall back
+# ============================================================
+echo ""
+echo "--- Test 2: fallback ---"
+
+OUTPUT=$("$PARSER" -v --lazy-libraries -I "$WORKDIR/lib" "$WORKDIR/model/implicit.sysml" 2>&1)
+EXIT_CODE=$?
+assert_equals "$EXIT_CODE" "0" "Exit code 0"
+assert_contains "$OUTPUT" "loading all library files" "Fallback loads every library file"
+if echo "$OUTPUT" | grep -q "E3001"; then
+    fail "No error from the first attempt" "no E3001" "$OUTPUT"
+else
+    pass "No error from the first attempt"
+fi
+if echo "$OUTPUT" | grep -q "preloading library files from $WORKDIR/model"; then
+    fail "Input directory is not preloaded" "library paths only" "$OUTPUT"
+else
+    pass "Input directory is not preloaded"
+fi
+
+# ============================================================
+# TEST 3: diagnostics match an eager run
+# ============================================================
+echo ""
+echo "--- Test 3: same diagnostics ---"
+
+EAGER=$("$PARSER" -I "$WORKDIR/lib" "$WORKDIR/model/broken.sysml" 2>&1)
+EAGER_EXIT=$?
+LAZY=$("$PARSER" --lazy-libraries -I "$WORKDIR/lib" "$WORKDIR/model/broken.sysml" 2>&1)
+LAZY_EXIT=$?
+assert_equals "$LAZY" "$EAGER" "Output matches"
+assert_equals "$LAZY_EXIT" "$EAGER_EXIT" "Exit code matches"
+assert_contains "$LAZY" "undefined type 'Nope'" "Undefined type reported"
+
+# Output covers the files that were loaded
+OUTPUT=$("$PARSER" -f json --lazy-libraries -I "$WORKDIR/lib" "$WORKDIR/model/app.sysml" 2>&1)
+assert_contains "$OUTPUT" '"id": "Parts::Engine"' "Imported library in JSON output"
+if echo "$OUTPUT" | grep -q '"id": "Unused"'; then
+    fail "Unloaded library not in JSON output" "no Unused package" "$OUTPUT"
+else
+    pass "Unloaded library not in JSON output"
+fi
+
+# ============================================================
+# TEST 4: the package index is cached
+# ============================================================
+echo ""
+echo "--- Test 4: cached package index ---"
+
+CACHE="$WORKDIR/cache"
+# Entries for files modified within the last second are not trusted
+find "$WORKDIR/lib" "$WORKDIR/model" -exec touch -d '1 hour ago' {} +
+"$PARSER" --lazy-libraries --cache-dir "$CACHE" -I "$WORKDIR/lib" "$WORKDIR/model/app.sysml" > /dev/null 2>&1
+OUTPUT=$("$PARSER" -v --lazy-libraries --cache-dir "$CACHE" -I "$WORKDIR/lib" "$WORKDIR/model/app.sysml" 2>&1)
+EXIT_CODE=$?
+assert_equals "$EXIT_CODE" "0" "Exit code 0"
+assert_contains "$OUTPUT" "using cached package index for $WORKDIR/lib" "Package index reused"
+OUTPUT=$("$PARSER" --lazy-libraries --cache-dir "$CACHE" -I "$WORKDIR/lib" "$WORKDIR/model/broken.sysml" 2>&1)
+assert_contains "$OUTPUT" "undefined type 'Nope'" "Cached run still reports errors"
+OUTPUT=$("$PARSER" --lazy-libraries --cache-dir "$CACHE" -I "$WORKDIR/lib" "$WORKDIR/model/implicit.sysml" 2>&1)
+assert_equals "$OUTPUT" "" "Cached lazy results do not hide the fallback"
+
+# ============================================================
+# Summary
+# ============================================================
+echo ""
+echo "=== Test Summary ==="
+echo "Passed: $TESTS_PASSED"
+echo "Failed: $TESTS_FAILED"
+echo ""
+
+if [ $TESTS_FAILED -gt 0 ]; then
+    echo -e "${RED}Some tests failed!${NC}"
+    exit 1
+else
+    echo -e "${GREEN}All tests passed!${NC}"
+    exit 0
+fi
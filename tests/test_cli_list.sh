@@ -364,6 +364,49 @@ FILE_CONTENT=$(cat "$WORKDIR/list_output.txt")
 assert_contains "$FILE_CONTENT" "Vehicles" "Output file has root element"
 assert_contains "$FILE_CONTENT" "package" "Output file has kind"
 
+# ============================================================
+# TEST 19: --list and --select skip libraries and validation
+# ============================================================
+echo ""
+echo "--- Test 19: queries parse only the inputs ---"
+
+mkdir -p "$WORKDIR/lib"
+cat > "$WORKDIR/lib/Base.sysml" << 'EOF'
+package Base {
+    part def Engine;
+}
+EOF
+
+cat > "$WORKDIR/app.sysml" << 'EOF'
+package App {
+    private import Base::*;
+    part def Car {
+        part engine : Engine;
+        part wheel : Missing;
+    }
+}
+EOF
+
+set +e
+OUTPUT=$("$PARSER" --list -I "$WORKDIR/lib" "$WORKDIR/app.sysml" 2>&1)
+EXIT_CODE=$?
+assert_exit_code $EXIT_CODE 0 "List without --validate exits 0"
+assert_contains "$OUTPUT" "App" "List without --validate lists root"
+assert_not_contains "$OUTPUT" "E3001" "List without --validate reports nothing"
+
+STATS=$("$PARSER" -s 'App::*' -f json -I "$WORKDIR/lib" --stats=json "$WORKDIR/app.sysml" 2>&1 >/dev/null | tail -1)
+assert_contains "$STATS" '"library":0,' "Select loads no library file"
+
+OUTPUT=$("$PARSER" --list --validate -I "$WORKDIR/lib" "$WORKDIR/app.sysml" 2>&1)
+EXIT_CODE=$?
+assert_exit_code $EXIT_CODE 2 "List with --validate exits 2"
+assert_contains "$OUTPUT" "undefined type 'Missing'" "List with --validate reports errors"
+assert_not_contains "$OUTPUT" "'Engine'" "List with --validate resolves imports"
+
+STATS=$("$PARSER" -s 'App::*' -f json --validate -I "$WORKDIR/lib" --stats=json "$WORKDIR/app.sysml" 2>&1 >/dev/null | tail -1)
+assert_contains "$STATS" '"library":1,' "Select with --validate loads the import"
+set -e
+
 # ============================================================
 # Summary
 # ============================================================
@@ -0,0 +1,199 @@
+#!/bin/bash
+#
+# Integration test for --memory-limit
+#
+# Tests: a breach fails cleanly with one message naming the phase and file,
+# serial and -j runs, library loading, stdin, --syntax-only, invalid sizes,
+# a generous limit leaving output unchanged, and the --stats memory report
+#
+# SPDX-License-Identifier: MIT
+
+PARSER="${1:-./sysml2}"
+WORKDIR=$(mktemp -d)
+trap "rm -rf $WORKDIR" EXIT
+
+# Colors for output
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+NC='\033[0m' # No Color
+
+TESTS_PASSED=0
+TESTS_FAILED=0
+
+pass() {
+    echo -e "${GREEN}PASS${NC}: $1"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+}
+
+fail() {
+    echo -e "${RED}FAIL${NC}: $1"
+    echo "  Expected: $2"
+    echo "  Got:      $3"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+}
+
+assert_contains() {
+    local output="$1"
+    local expected="$2"
+    local testname="$3"
+
+    if echo "$output" | grep -q -- "$expected"; then
+        pass "$testname"
+    else
+        fail "$testname" "contains '$expected'" "not found in: $output"
+    fi
+}
+
+assert_equals() {
+    local actual="$1"
+    local expected="$2"
+    local testname="$3"
+
+    if [ "$actual" = "$expected" ]; then
+        pass "$testname"
+    else
+        fail "$testname" "$expected" "$actual"
+    fi
+}
+
+
+echo "=== CLI Memory Limit Tests ==="
+echo "Parser: $PARSER"
+echo "Workdir: $WORKDIR"
+echo ""
+
+if [ ! -x "$PARSER" ]; then
+    echo "ERROR: Parser not found or not executable: $PARSER"
+    exit 1
+fi
+
+mkdir -p "$WORKDIR/lib" "$WORKDIR/model"
+
+{
+    echo "package Big {"
+    for i in $(seq 1 2000); do
+        echo "    part def P$i { attribute a$i; }"
+    done
+    echo "}"
+} > "$WORKDIR/model/big.sysml"
+
+{
+    echo "package Parts {"
+    echo "    part def Engine;"
+    for i in $(seq 1 2000); do
+        echo "    part def Q$i { attribute a$i; }"
+    done
+    echo "}"
+} > "$WORKDIR/lib/Parts.sysml"
+
+cat > "$WORKDIR/model/small.sysml" << 'SYSML'
+package Small {
+    import Parts::*;
+    part e : Engine;
+}
+SYSML
+
+# ============================================================
+# TEST 1: a breach fails cleanly
+# ============================================================
+echo "--- Test 1: breach ---"
+
+# Parsing big.sysml holds over ten megabytes, so 4M always trips
+OUTPUT=$("$PARSER" --memory-limit 4M -f json "$WORKDIR/model/big.sysml" 2>"$WORKDIR/err.txt")
+EXIT_CODE=$?
+ERRORS=$(cat "$WORKDIR/err.txt")
+assert_equals "$EXIT_CODE" "1" "Exit code 1"
+assert_equals "$OUTPUT" "" "Nothing written"
+assert_contains "$ERRORS" "$WORKDIR/model/big.sysml:fatal error\[E4001\]: memory limit of 4194304 bytes exceeded in parse phase" "Breach names phase and file"
+assert_equals "$(echo "$ERRORS" | grep -c "E4001")" "1" "Reported once"
+if echo "$ERRORS" | grep -q "expected\|syntax"; then
+    fail "No syntax errors for the cut-off input" "no syntax errors" "$ERRORS"
+else
+    pass "No syntax errors for the cut-off input"
+fi
+
+SERIAL=$("$PARSER" --memory-limit 4M -j1 "$WORKDIR/model/big.sysml" "$WORKDIR/model/small.sysml" 2>&1)
+SERIAL_EXIT=$?
+PARALLEL=$("$PARSER" --memory-limit 4M -j4 "$WORKDIR/model/big.sysml" "$WORKDIR/model/small.sysml" 2>&1)
+assert_equals "$?" "$SERIAL_EXIT" "-j4 exit code matches -j1"
+assert_equals "$(echo "$PARALLEL" | sed 's/ (.*//')" "$(echo "$SERIAL" | sed 's/ (.*//')" "-j4 report matches -j1"
+
+# ============================================================
+# TEST 2: libraries, stdin and --syntax-only
+# ============================================================
+echo ""
+echo "--- Test 2: other inputs ---"
+
+OUTPUT=$("$PARSER" --memory-limit 4M -I "$WORKDIR/lib" "$WORKDIR/model/small.sysml" 2>&1)
+assert_equals "$?" "1" "Library breach exits 1"
+assert_contains "$OUTPUT" "$WORKDIR/lib/Parts.sysml:fatal error\[E4001\]: memory limit of 4194304 bytes exceeded in libraries phase" "Library breach names the library file"
+
+OUTPUT=$("$PARSER" --memory-limit 4M < "$WORKDIR/model/big.sysml" 2>&1)
+assert_equals "$?" "1" "stdin breach exits 1"
+assert_contains "$OUTPUT" "<stdin>:fatal error\[E4001\]" "stdin breach reported"
+
+OUTPUT=$("$PARSER" --syntax-only --memory-limit 4M "$WORKDIR/model/big.sysml" 2>&1)
+assert_equals "$?" "1" "--syntax-only breach exits 1"
+assert_contains "$OUTPUT" "exceeded in parse phase" "--syntax-only breach reported"
+
+OUTPUT=$("$PARSER" --memory-limit 4M --diagnostics-format=json "$WORKDIR/model/big.sysml" 2>&1)
+assert_equals "$?" "1" "JSON diagnostics breach exits 1"
+assert_contains "$OUTPUT" '"severity":"fatal error","code":"E4001","message":"memory limit of 4194304 bytes exceeded in parse phase' "Breach is a JSON diagnostic"
+
+OUTPUT=$(echo "$WORKDIR/model/big.sysml" | "$PARSER" --batch --memory-limit 4M 2>&1)
+assert_contains "$OUTPUT" '"ok":false' "Batch breach fails the document"
+assert_contains "$OUTPUT" '"code":"E4001"' "Batch breach is in the document's diagnostics"
+
+# ============================================================
+# TEST 3: invalid sizes
+# ============================================================
+echo ""
+echo "--- Test 3: invalid sizes ---"
+
+for SIZE in 0 4x -1 K; do
+    OUTPUT=$("$PARSER" --memory-limit "$SIZE" "$WORKDIR/model/small.sysml" 2>&1)
+    assert_equals "$?" "1" "'$SIZE' rejected"
+    assert_contains "$OUTPUT" "error: invalid memory limit '$SIZE'" "'$SIZE' reported"
+done
+
+# ============================================================
+# TEST 4: a generous limit changes nothing
+# ============================================================
+echo ""
+echo "--- Test 4: generous limit ---"
+
+EXPECTED=$("$PARSER" -f json -I "$WORKDIR/lib" "$WORKDIR/model/small.sysml" "$WORKDIR/model/big.sysml" 2>&1)
+EXPECTED_EXIT=$?
+OUTPUT=$("$PARSER" --memory-limit 4G -f json -I "$WORKDIR/lib" "$WORKDIR/model/small.sysml" "$WORKDIR/model/big.sysml" 2>&1)
+assert_equals "$?" "$EXPECTED_EXIT" "Exit code unchanged"
+assert_equals "$OUTPUT" "$EXPECTED" "Output unchanged"
+
+echo 'package Tiny { part def A; }' > "$WORKDIR/tiny.sysml"
+OUTPUT=$("$PARSER" --memory-limit 10M -f json "$WORKDIR/tiny.sysml" 2>&1)
+assert_equals "$?" "0" "A tiny file fits a small limit"
+
+REPORT=$("$PARSER" --memory-limit 4G --stats=json "$WORKDIR/model/big.sysml" 2>&1 >/dev/null)
+assert_contains "$REPORT" '"memory":{"peak_bytes":' "Stats report memory"
+assert_contains "$REPORT" '"limit_bytes":4294967296,"exceeded":false}' "Stats report the limit"
+assert_contains "$REPORT" '"peak_bytes":' "Stats report per-phase peaks"
+
+REPORT=$("$PARSER" --stats "$WORKDIR/model/big.sysml" 2>&1 >/dev/null)
+assert_contains "$REPORT" "peak_bytes" "Text stats have a peak column"
+assert_contains "$REPORT" "memory: .* bytes peak" "Text stats have a memory line"
+
+# ============================================================
+# Summary
+# ============================================================
+echo ""
+echo "=== Test Summary ==="
+echo "Passed: $TESTS_PASSED"
+echo "Failed: $TESTS_FAILED"
+echo ""
+
+if [ $TESTS_FAILED -gt 0 ]; then
+    echo -e "${RED}Some tests failed!${NC}"
+    exit 1
+else
+    echo -e "${GREEN}All tests passed!${NC}"
+    exit 0
+fi
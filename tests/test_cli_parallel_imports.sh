@@ -0,0 +1,190 @@
+#!/bin/bash
+#
+# Integration test for parsing imported files on worker threads (-j)
+#
+# Tests: diagnostics, verbose notes, JSON and SysML output and file counters match
+# a serial run; syntax errors in imports, cycles, the model cache and chunked
+# JSON query output
+#
+# SPDX-License-Identifier: MIT
+
+PARSER="${1:-./sysml2}"
+WORKDIR=$(mktemp -d)
+trap "rm -rf $WORKDIR" EXIT
+
+# Colors for output
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+NC='\033[0m' # No Color
+
+TESTS_PASSED=0
+TESTS_FAILED=0
+
+pass() {
+    echo -e "${GREEN}PASS${NC}: $1"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+}
+
+fail() {
+    echo -e "${RED}FAIL${NC}: $1"
+    echo "  Expected: $2"
+    echo "  Got:      $3"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+}
+
+assert_contains() {
+    local output="$1"
+    local expected="$2"
+    local testname="$3"
+
+    if echo "$output" | grep -q -- "$expected"; then
+        pass "$testname"
+    else
+        fail "$testname" "contains '$expected'" "not found in: $output"
+    fi
+}
+
+assert_equals() {
+    local actual="$1"
+    local expected="$2"
+    local testname="$3"
+
+    if [ "$actual" = "$expected" ]; then
+        pass "$testname"
+    else
+        fail "$testname" "$expected" "$actual"
+    fi
+}
+
+echo "=== CLI Parallel Import Resolution Tests ==="
+echo "Parser: $PARSER"
+echo "Workdir: $WORKDIR"
+echo ""
+
+if [ ! -x "$PARSER" ]; then
+    echo "ERROR: Parser not found or not executable: $PARSER"
+    exit 1
+fi
+
+# Chained packages next to the input: Lib<i> imports Lib<i+1> and Lib<i+2>.
+# Files found through the input's directory are parsed at resolve time;
+# -I directories are preloaded instead.
+mkdir -p "$WORKDIR/model"
+for i in $(seq 1 8); do
+    {
+        echo "package Lib$i {"
+        [ "$i" -lt 8 ] && echo "    import Lib$((i + 1))::*;"
+        [ "$i" -lt 7 ] && echo "    import Lib$((i + 2))::*;"
+        echo "    part def Part$i;"
+        echo "}"
+    } > "$WORKDIR/model/Lib$i.sysml"
+done
+
+cat > "$WORKDIR/model/Broken.sysml" << 'EOF'
+package Broken {
+    part def Bad {
+}
+EOF
+
+cat > "$WORKDIR/model/Cycle.sysml" << 'EOF'
+package Cycle {
+    import App::*;
+    part def Loop;
+}
+EOF
+
+cat > "$WORKDIR/model/App.sysml" << 'EOF'
+package App {
+    import Lib1::*;
+    import Lib4::*;
+    import Broken::*;
+    import Cycle::*;
+    import Missing::*;
+    part a : Part8;
+    part b : Nope;
+}
+EOF
+
+run() {
+    "$PARSER" "$@" "$WORKDIR/model/App.sysml"
+}
+
+# ============================================================
+# TEST 1: output matches a serial run
+# ============================================================
+echo "--- Test 1: -j4 matches -j1 ---"
+
+SERIAL=$(run -j1 2>&1)
+SERIAL_EXIT=$?
+PARALLEL=$(run -j4 2>&1)
+PARALLEL_EXIT=$?
+
+assert_equals "$PARALLEL" "$SERIAL" "Diagnostics match"
+assert_equals "$PARALLEL_EXIT" "$SERIAL_EXIT" "Exit code matches"
+assert_contains "$PARALLEL" "Broken.sysml" "Syntax error in an import reported"
+assert_contains "$PARALLEL" "undefined type 'Nope'" "Input validated"
+
+# Only the notes: arena statistics (SYSML2_ARENA_STATS) differ by job count
+assert_equals "$(run -j4 -v 2>&1 | grep 'note:')" "$(run -j1 -v 2>&1 | grep 'note:')" "Verbose notes match"
+assert_equals "$(run -j4 -f json 2>/dev/null)" "$(run -j1 -f json 2>/dev/null)" "JSON output matches"
+assert_equals "$(run -j4 -f sysml 2>/dev/null)" "$(run -j1 -f sysml 2>/dev/null)" "SysML output matches"
+
+# ============================================================
+# TEST 2: every file is parsed once
+# ============================================================
+echo ""
+echo "--- Test 2: file counts ---"
+
+SERIAL=$(run -j1 --stats=json 2>&1 >/dev/null | tail -1 | grep -o '"files":{[^}]*}')
+PARALLEL=$(run -j4 --stats=json 2>&1 >/dev/null | tail -1 | grep -o '"files":{[^}]*}')
+assert_contains "$PARALLEL" '"library":10,' "Each imported file parsed once"
+assert_equals "$PARALLEL" "$SERIAL" "File counters match"
+
+# ============================================================
+# TEST 3: cached models are reused
+# ============================================================
+echo ""
+echo "--- Test 3: model cache ---"
+
+CACHE="$WORKDIR/cache"
+run -j4 --cache-dir "$CACHE" > /dev/null 2>&1
+WARM=$(run -j4 --cache-dir "$CACHE" 2>&1)
+assert_equals "$WARM" "$(run -j1 2>&1)" "Warm output matches"
+REPORT=$(run -j4 --cache-dir "$CACHE" --stats=json 2>&1 >/dev/null | tail -1)
+assert_contains "$REPORT" '"library":1,' "Only the broken file is reparsed"
+
+# ============================================================
+# TEST 4: large query results are rendered in chunks
+# ============================================================
+echo ""
+echo "--- Test 4: chunked JSON query output ---"
+
+{
+    echo "package Big {"
+    for i in $(seq 1 3000); do
+        echo "    part def P$i :> P1;"
+    done
+    echo "}"
+} > "$WORKDIR/Big.sysml"
+
+SERIAL=$("$PARSER" -j1 -s 'Big::**' -f json "$WORKDIR/Big.sysml" 2>/dev/null)
+assert_equals "$("$PARSER" -j4 -s 'Big::**' -f json "$WORKDIR/Big.sysml" 2>/dev/null)" "$SERIAL" "Pretty query output matches"
+assert_equals "$("$PARSER" -j4 -s 'Big::**' -f json --compact "$WORKDIR/Big.sysml" 2>/dev/null)" \
+    "$("$PARSER" -j1 -s 'Big::**' -f json --compact "$WORKDIR/Big.sysml" 2>/dev/null)" "Compact query output matches"
+assert_contains "$SERIAL" '"Big::P3000"' "All elements written"
+
+# Summary
+# ============================================================
+echo ""
+echo "=== Test Summary ==="
+echo "Passed: $TESTS_PASSED"
+echo "Failed: $TESTS_FAILED"
+echo ""
+
+if [ $TESTS_FAILED -gt 0 ]; then
+    echo -e "${RED}Some tests failed!${NC}"
+    exit 1
+else
+    echo -e "${GREEN}All tests passed!${NC}"
+    exit 0
+fi
@@ -0,0 +1,245 @@
+#!/bin/bash
+#
+# Integration test for the validation result cache (--cache-dir)
+#
+# Tests: warm runs replay the uncached diagnostics and exit code without
+# running validation, edits invalidate importers only, unresolved names
+# are rechecked when any file changes, options and library paths are part
+# of the key, stdin is not cached
+#
+# SPDX-License-Identifier: MIT
+
+PARSER="${1:-./sysml2}"
+WORKDIR=$(mktemp -d)
+trap "rm -rf $WORKDIR" EXIT
+
+# Colors for output
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+NC='\033[0m' # No Color
+
+TESTS_PASSED=0
+TESTS_FAILED=0
+
+pass() {
+    echo -e "${GREEN}PASS${NC}: $1"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+}
+
+fail() {
+    echo -e "${RED}FAIL${NC}: $1"
+    echo "  Expected: $2"
+    echo "  Got:      $3"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+}
+
+assert_contains() {
+    local output="$1"
+    local expected="$2"
+    local testname="$3"
+
+    if echo "$output" | grep -q -- "$expected"; then
+        pass "$testname"
+    else
+        fail "$testname" "contains '$expected'" "not found in: $output"
+    fi
+}
+
+assert_equals() {
+    local actual="$1"
+    local expected="$2"
+    local testname="$3"
+
+    if [ "$actual" = "$expected" ]; then
+        pass "$testname"
+    else
+        fail "$testname" "$expected" "$actual"
+    fi
+}
+
+echo "=== CLI Validation Result Cache Tests ==="
+echo "Parser: $PARSER"
+echo "Workdir: $WORKDIR"
+echo ""
+
+if [ ! -x "$PARSER" ]; then
+    echo "ERROR: Parser not found or not executable: $PARSER"
+    exit 1
+fi
+
+CACHE="$WORKDIR/cache"
+mkdir -p "$WORKDIR/lib" "$WORKDIR/model"
+
+cat > "$WORKDIR/lib/Parts.sysml" << 'EOF'
+package Parts {
+    part def Engine;
+    abstract part def Vehicle;
+}
+EOF
+
+cat > "$WORKDIR/model/app.sysml" << 'EOF'
+package App {
+    import Parts::*;
+    part car : Vehicle;
+    part e : Engin;
+    part d;
+    part d;
+}
+EOF
+
+cat > "$WORKDIR/model/other.sysml" << 'EOF'
+package Other {
+    part x;
+    part x;
+}
+EOF
+
+run() {
+    "$PARSER" -I "$WORKDIR/lib" --cache-dir "$CACHE" "$@" \
+        "$WORKDIR/model/app.sysml" "$WORKDIR/model/other.sysml"
+}
+
+# ============================================================
+# TEST 1: a warm run replays the same diagnostics
+# ============================================================
+echo "--- Test 1: warm run ---"
+
+COLD=$("$PARSER" -I "$WORKDIR/lib" "$WORKDIR/model/app.sysml" "$WORKDIR/model/other.sysml" 2>&1)
+COLD_EXIT=$?
+run > /dev/null 2>&1
+WARM=$(run 2>&1)
+WARM_EXIT=$?
+
+assert_equals "$WARM" "$COLD" "Warm output matches an uncached run"
+assert_equals "$WARM_EXIT" "$COLD_EXIT" "Warm exit code matches"
+assert_contains "$WARM" "undefined type 'Engin'" "Cached error replayed"
+
+OUTPUT=$(run -v 2>&1)
+assert_equals "$(echo "$OUTPUT" | grep -c 'reused validation results')" "3" "Every file reused"
+
+REPORT=$(run --stats=json 2>&1 >/dev/null | tail -1)
+assert_contains "$REPORT" '"symtab":{"wall_ms":0.000,"cpu_ms":0.000,"runs":0}' "No validation pass runs"
+assert_contains "$REPORT" '"input":0,' "No input is parsed"
+
+# ============================================================
+# TEST 2: editing an import invalidates its importers
+# ============================================================
+echo ""
+echo "--- Test 2: changed import ---"
+
+cat > "$WORKDIR/lib/Parts.sysml" << 'EOF'
+package Parts {
+    part def Engine;
+    part def Engin;
+    abstract part def Vehicle;
+}
+EOF
+
+OUTPUT=$(run -v 2>&1)
+assert_contains "$OUTPUT" "reused validation results for .*other.sysml" "Unrelated file reused"
+if echo "$OUTPUT" | grep -q "reused validation results for .*app.sysml"; then
+    fail "Importer is revalidated" "no reuse of app.sysml" "$OUTPUT"
+else
+    pass "Importer is revalidated"
+fi
+if echo "$OUTPUT" | grep -q "undefined type 'Engin'"; then
+    fail "Stale error dropped" "no E3001 for Engin" "$OUTPUT"
+else
+    pass "Stale error dropped"
+fi
+COLD=$("$PARSER" -I "$WORKDIR/lib" "$WORKDIR/model/app.sysml" "$WORKDIR/model/other.sysml" 2>&1)
+assert_equals "$(run 2>&1)" "$COLD" "Partly cached output matches an uncached run"
+
+# ============================================================
+# TEST 3: options are part of the key
+# ============================================================
+echo ""
+echo "--- Test 3: changed options ---"
+
+OUTPUT=$(run -v -Werror 2>&1)
+EXIT_CODE=$?
+assert_equals "$(echo "$OUTPUT" | grep -c 'reused validation results')" "0" "-Werror revalidates"
+assert_contains "$OUTPUT" "error\[W1003\]" "Warning promoted"
+assert_equals "$EXIT_CODE" "2" "Exit code 2"
+
+OUTPUT=$(run -v -Werror 2>&1)
+assert_equals "$(echo "$OUTPUT" | grep -c 'reused validation results')" "3" "-Werror results cached"
+assert_contains "$OUTPUT" "error\[W1003\]" "Promoted warning replayed"
+
+OUTPUT=$(run -v -I "$WORKDIR" 2>&1)
+assert_equals "$(echo "$OUTPUT" | grep -c 'reused validation results')" "0" "New library path revalidates"
+
+# ============================================================
+# TEST 4: stdin is never cached
+# ============================================================
+echo ""
+echo "--- Test 4: stdin ---"
+
+OUTPUT=$(printf 'package S { part s : Gone; }\n' | "$PARSER" --cache-dir "$CACHE" -v 2>&1)
+assert_contains "$OUTPUT" "undefined type 'Gone'" "stdin validated"
+OUTPUT=$(printf 'package S { part s : Gone; }\n' | "$PARSER" --cache-dir "$CACHE" -v 2>&1)
+if echo "$OUTPUT" | grep -q "reused validation results"; then
+    fail "stdin not reused" "no reuse" "$OUTPUT"
+else
+    pass "stdin not reused"
+fi
+
+# ============================================================
+# TEST 5: unresolved names depend on every file
+# ============================================================
+echo ""
+echo "--- Test 5: unresolved names ---"
+
+mkdir -p "$WORKDIR/typo"
+cat > "$WORKDIR/typo/a.sysml" << 'EOF'
+part x : Vehicel;
+EOF
+cat > "$WORKDIR/typo/b.sysml" << 'EOF'
+part def Engine;
+EOF
+
+run_typo() {
+    "$PARSER" --cache-dir "$CACHE" "$@"
+}
+
+run_typo "$WORKDIR/typo/a.sysml" "$WORKDIR/typo/b.sysml" > /dev/null 2>&1
+cat > "$WORKDIR/typo/b.sysml" << 'EOF'
+part def Engine;
+part def Vehicle;
+EOF
+
+COLD=$("$PARSER" "$WORKDIR/typo/a.sysml" "$WORKDIR/typo/b.sysml" 2>&1)
+OUTPUT=$(run_typo "$WORKDIR/typo/a.sysml" "$WORKDIR/typo/b.sysml" 2>&1)
+assert_contains "$OUTPUT" "did you mean 'Vehicle'" "Suggestion from an edited file"
+assert_equals "$OUTPUT" "$COLD" "Edited file output matches an uncached run"
+
+OUTPUT=$(run_typo -v "$WORKDIR/typo/a.sysml" "$WORKDIR/typo/b.sysml" 2>&1)
+assert_contains "$OUTPUT" "reused validation results for .*a.sysml" "Unchanged run reuses the file"
+
+cat > "$WORKDIR/typo/c.sysml" << 'EOF'
+part def Vehicel;
+EOF
+COLD=$("$PARSER" "$WORKDIR/typo/a.sysml" "$WORKDIR/typo/b.sysml" "$WORKDIR/typo/c.sysml" 2>&1)
+OUTPUT=$(run_typo "$WORKDIR/typo/a.sysml" "$WORKDIR/typo/b.sysml" "$WORKDIR/typo/c.sysml" 2>&1)
+assert_equals "$OUTPUT" "$COLD" "Added file output matches an uncached run"
+if echo "$OUTPUT" | grep -q "undefined type 'Vehicel'"; then
+    fail "Added definition resolves the name" "no E3001 for Vehicel" "$OUTPUT"
+else
+    pass "Added definition resolves the name"
+fi
+
+# Summary
+# ============================================================
+echo ""
+echo "=== Test Summary ==="
+echo "Passed: $TESTS_PASSED"
+echo "Failed: $TESTS_FAILED"
+echo ""
+
+if [ $TESTS_FAILED -gt 0 ]; then
+    echo -e "${RED}Some tests failed!${NC}"
+    exit 1
+else
+    echo -e "${GREEN}All tests passed!${NC}"
+    exit 0
+fi
@@ -0,0 +1,182 @@
+#!/bin/bash
+#
+# Integration test for --select-users
+#
+# Tests: direct and transitive users through typing, specialization and
+# redefinition, users across library files, --list and JSON output,
+# option validation
+#
+# SPDX-License-Identifier: MIT
+
+PARSER="${1:-./sysml2}"
+WORKDIR=$(mktemp -d)
+trap "rm -rf $WORKDIR" EXIT
+
+# Colors for output
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+NC='\033[0m' # No Color
+
+TESTS_PASSED=0
+TESTS_FAILED=0
+
+pass() {
+    echo -e "${GREEN}PASS${NC}: $1"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+}
+
+fail() {
+    echo -e "${RED}FAIL${NC}: $1"
+    echo "  Expected: $2"
+    echo "  Got:      $3"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+}
+
+assert_contains() {
+    local output="$1"
+    local expected="$2"
+    local testname="$3"
+
+    if echo "$output" | grep -q -- "$expected"; then
+        pass "$testname"
+    else
+        fail "$testname" "contains '$expected'" "not found in: $output"
+    fi
+}
+
+assert_equals() {
+    local actual="$1"
+    local expected="$2"
+    local testname="$3"
+
+    if [ "$actual" = "$expected" ]; then
+        pass "$testname"
+    else
+        fail "$testname" "$expected" "$actual"
+    fi
+}
+
+echo "=== CLI --select-users Tests ==="
+echo "Parser: $PARSER"
+echo "Workdir: $WORKDIR"
+echo ""
+
+if [ ! -x "$PARSER" ]; then
+    echo "ERROR: Parser not found or not executable: $PARSER"
+    exit 1
+fi
+
+mkdir -p "$WORKDIR/lib"
+
+cat > "$WORKDIR/lib/Base.sysml" << 'EOF2'
+package Base {
+    part def Engine {
+        attribute power;
+    }
+    part def Motor :> Engine;
+}
+EOF2
+
+cat > "$WORKDIR/app.sysml" << 'EOF2'
+package App {
+    import Base::*;
+    part def Car {
+        part engine : Engine;
+        part motor : Motor;
+    }
+    part def SportsCar :> Car {
+        part engine :>> engine;
+    }
+    part e2 : Engine {
+        attribute power :>> power;
+    }
+    part unrelated;
+}
+EOF2
+
+users() {
+    "$PARSER" -I "$WORKDIR/lib" --list "$@" "$WORKDIR/app.sysml"
+}
+
+# ============================================================
+# TEST 1: direct users
+# ============================================================
+echo "--- Test 1: direct users ---"
+
+OUTPUT=$(users --select-users 'Base::Engine' 2>&1)
+EXIT_CODE=$?
+assert_equals "$EXIT_CODE" "0" "Exit code 0"
+# Users come in loaded-model order, which varies with the file paths
+assert_equals "$(echo "$OUTPUT" | cut -f1 | sort)" "App::Car::engine
+App::e2
+Base::Motor" "Library and model users of Engine"
+
+OUTPUT=$(users --select-users 'Base::Engine::power' 2>&1)
+assert_equals "$(echo "$OUTPUT" | cut -f1)" "App::e2::power" "Redefinition of an inherited feature"
+
+OUTPUT=$(users --select-users 'App::unrelated' 2>&1)
+EXIT_CODE=$?
+assert_equals "$EXIT_CODE" "0" "Unused element exits 0"
+assert_equals "$OUTPUT" "" "Unused element has no users"
+
+# ============================================================
+# TEST 2: transitive users
+# ============================================================
+echo ""
+echo "--- Test 2: --users-depth ---"
+
+OUTPUT=$(users --select-users 'Base::Engine' --users-depth 2 2>&1)
+assert_contains "$OUTPUT" "App::Car::motor" "Users of Motor at depth 2"
+assert_contains "$OUTPUT" "App::SportsCar::engine" "Redefinition of a user at depth 2"
+
+ALL=$(users --select-users 'Base::Engine' --users-depth 0 2>&1)
+assert_equals "$ALL" "$OUTPUT" "Depth 0 follows every level"
+assert_equals "$(echo "$ALL" | wc -l | tr -d ' ')" "5" "Five users in total"
+
+OUTPUT=$(users --select-users 'Base::*' 2>&1)
+assert_contains "$OUTPUT" "App::Car::motor" "Wildcard selects users of every match"
+
+# ============================================================
+# TEST 3: element output
+# ============================================================
+echo ""
+echo "--- Test 3: output formats ---"
+
+OUTPUT=$("$PARSER" -I "$WORKDIR/lib" -f json --compact --select-users 'Base::Motor' \
+    "$WORKDIR/app.sysml" 2>&1)
+assert_contains "$OUTPUT" '"type": "query_result"' "JSON query result"
+assert_contains "$OUTPUT" '"id": "App::Car::motor"' "User written as an element"
+assert_equals "$(echo "$OUTPUT" | grep -o '"id": ' | wc -l | tr -d ' ')" "1" "Only the user is written"
+
+# ============================================================
+# TEST 4: option errors
+# ============================================================
+echo ""
+echo "--- Test 4: option errors ---"
+
+OUTPUT=$(users --select-users 'Base::Engine' --select 'App::*' 2>&1)
+EXIT_CODE=$?
+assert_equals "$EXIT_CODE" "1" "--select with --select-users rejected"
+assert_contains "$OUTPUT" "cannot be combined with --select" "Combination error reported"
+
+OUTPUT=$(users --select-users 'Base::Engine' --users-depth -1 2>&1)
+EXIT_CODE=$?
+assert_equals "$EXIT_CODE" "1" "Negative depth rejected"
+assert_contains "$OUTPUT" "invalid --users-depth" "Depth error reported"
+
+# ============================================================
+# Summary
+# ============================================================
+echo ""
+echo "=== Test Summary ==="
+echo "Passed: $TESTS_PASSED"
+echo "Failed: $TESTS_FAILED"
+echo ""
+
+if [ $TESTS_FAILED -gt 0 ]; then
+    echo -e "${RED}Some tests failed!${NC}"
+    exit 1
+else
+    echo -e "${GREEN}All tests passed!${NC}"
+    exit 0
+fi
@@ -0,0 +1,174 @@
+#!/bin/bash
+#
+# Integration test for --stats
+#
+# Tests: text and JSON reports on stderr, stdout left untouched,
+# library and model cache counters, per-pass rows, bad format values
+#
+# SPDX-License-Identifier: MIT
+
+PARSER="${1:-./sysml2}"
+WORKDIR=$(mktemp -d)
+trap "rm -rf $WORKDIR" EXIT
+
+# Colors for output
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+NC='\033[0m' # No Color
+
+TESTS_PASSED=0
+TESTS_FAILED=0
+
+pass() {
+    echo -e "${GREEN}PASS${NC}: $1"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+}
+
+fail() {
+    echo -e "${RED}FAIL${NC}: $1"
+    echo "  Expected: $2"
+    echo "  Got:      $3"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+}
+
+assert_contains() {
+    local output="$1"
+    local expected="$2"
+    local testname="$3"
+
+    if echo "$output" | grep -q -- "$expected"; then
+        pass "$testname"
+    else
+        fail "$testname" "contains '$expected'" "not found in: $output"
+    fi
+}
+
+assert_equals() {
+    local actual="$1"
+    local expected="$2"
+    local testname="$3"
+
+    if [ "$actual" = "$expected" ]; then
+        pass "$testname"
+    else
+        fail "$testname" "$expected" "$actual"
+    fi
+}
+
+echo "=== CLI --stats Tests ==="
+echo "Parser: $PARSER"
+echo "Workdir: $WORKDIR"
+echo ""
+
+if [ ! -x "$PARSER" ]; then
+    echo "ERROR: Parser not found or not executable: $PARSER"
+    exit 1
+fi
+
+mkdir -p "$WORKDIR/lib" "$WORKDIR/model" "$WORKDIR/cache"
+cat > "$WORKDIR/lib/Units.sysml" << 'EOF'
+package Units {
+    attribute def Mass;
+}
+EOF
+cat > "$WORKDIR/model/model.sysml" << 'EOF'
+package Vehicles {
+    private import Units::*;
+    part def Car {
+        attribute mass : Mass;
+    }
+    part car : Car;
+}
+EOF
+
+# ============================================================
+# TEST 1: text report goes to stderr, stdout is unchanged
+# ============================================================
+echo "--- Test 1: text report ---"
+
+PLAIN=$("$PARSER" -I "$WORKDIR/lib" -f json "$WORKDIR/model/model.sysml" 2>/dev/null)
+WITH_STATS=$("$PARSER" -I "$WORKDIR/lib" -f json --stats "$WORKDIR/model/model.sysml" 2>"$WORKDIR/stats.txt")
+EXIT_CODE=$?
+REPORT=$(cat "$WORKDIR/stats.txt")
+
+assert_equals "$EXIT_CODE" "0" "Exit code is unchanged"
+assert_equals "$WITH_STATS" "$PLAIN" "Stdout is unchanged"
+assert_contains "$REPORT" "^parse " "Parse phase row"
+assert_contains "$REPORT" "^validate " "Validate phase row"
+assert_contains "$REPORT" "^  2 types " "Validator pass row"
+assert_contains "$REPORT" "^write " "Write phase row"
+assert_contains "$REPORT" "files: 1 input" "Input files counted"
+assert_contains "$REPORT" "1 library" "Library file counted"
+assert_contains "$REPORT" "^intern: " "Intern table row"
+assert_contains "$REPORT" "^symtab: " "Symbol table row"
+
+# ============================================================
+# TEST 2: JSON report
+# ============================================================
+echo ""
+echo "--- Test 2: JSON report ---"
+
+"$PARSER" -I "$WORKDIR/lib" --stats=json "$WORKDIR/model/model.sysml" 2>"$WORKDIR/stats.json" >/dev/null
+REPORT=$(cat "$WORKDIR/stats.json")
+
+assert_contains "$REPORT" '"phases":{"libraries":' "Phases object"
+assert_contains "$REPORT" '"passes":{"symtab":' "Passes object"
+assert_contains "$REPORT" '"library":1,' "Library count"
+assert_contains "$REPORT" '"arena_peak_bytes":' "Arena peak"
+if command -v python3 > /dev/null; then
+    if python3 -c 'import json,sys; json.load(sys.stdin)' < "$WORKDIR/stats.json"; then
+        pass "Report is valid JSON"
+    else
+        fail "Report is valid JSON" "parsable JSON" "$REPORT"
+    fi
+fi
+
+# ============================================================
+# TEST 3: --parse-only skips validation
+# ============================================================
+echo ""
+echo "--- Test 3: --parse-only ---"
+
+REPORT=$("$PARSER" -P --stats=json "$WORKDIR/model/model.sysml" 2>&1 >/dev/null)
+assert_contains "$REPORT" '"validate":{"wall_ms":0.000,"cpu_ms":0.000,"runs":0' "No validation run"
+
+# ============================================================
+# TEST 4: model cache hits on a warm run
+# ============================================================
+echo ""
+echo "--- Test 4: --cache-dir ---"
+
+"$PARSER" -I "$WORKDIR/lib" --cache-dir "$WORKDIR/cache" "$WORKDIR/model/model.sysml" 2>/dev/null
+REPORT=$("$PARSER" -I "$WORKDIR/lib" --cache-dir "$WORKDIR/cache" --stats=json \
+    "$WORKDIR/model/model.sysml" 2>&1 >/dev/null)
+assert_contains "$REPORT" '"library":0,' "Warm run parses no library"
+assert_contains "$REPORT" '"input":0,' "Warm run parses no input"
+assert_contains "$REPORT" '"model_cache_hits":2,' "Warm run hits the model cache"
+
+# ============================================================
+# TEST 5: invalid format
+# ============================================================
+echo ""
+echo "--- Test 5: invalid format ---"
+
+OUTPUT=$("$PARSER" --stats=xml "$WORKDIR/model/model.sysml" 2>&1)
+EXIT_CODE=$?
+assert_equals "$EXIT_CODE" "1" "Invalid format exits 1"
+assert_contains "$OUTPUT" "invalid --stats format 'xml'" "Invalid format message"
+
+# ============================================================
+# Summary
+# ============================================================
+echo ""
+echo "=== Test Summary ==="
+echo "Passed: $TESTS_PASSED"
+echo "Failed: $TESTS_FAILED"
+echo ""
+
+if [ $TESTS_FAILED -gt 0 ]; then
+    echo -e "${RED}Some tests failed!${NC}"
+    exit 1
+else
+    echo -e "${GREEN}All tests passed!${NC}"
+    exit 0
+fi
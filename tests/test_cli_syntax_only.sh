@@ -0,0 +1,173 @@
+#!/bin/bash
+#
+# Integration test for --syntax-only
+#
+# Tests: clean and broken inputs, errors and exit codes matching --parse-only,
+# nothing written to stdout, no imports or libraries loaded, stdin, -r and -j
+#
+# SPDX-License-Identifier: MIT
+
+PARSER="${1:-./sysml2}"
+WORKDIR=$(mktemp -d)
+trap "rm -rf $WORKDIR" EXIT
+
+# Colors for output
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+NC='\033[0m' # No Color
+
+TESTS_PASSED=0
+TESTS_FAILED=0
+
+pass() {
+    echo -e "${GREEN}PASS${NC}: $1"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+}
+
+fail() {
+    echo -e "${RED}FAIL${NC}: $1"
+    echo "  Expected: $2"
+    echo "  Got:      $3"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+}
+
+assert_contains() {
+    local output="$1"
+    local expected="$2"
+    local testname="$3"
+
+    if echo "$output" | grep -q -- "$expected"; then
+        pass "$testname"
+    else
+        fail "$testname" "contains '$expected'" "not found in: $output"
+    fi
+}
+
+assert_equals() {
+    local actual="$1"
+    local expected="$2"
+    local testname="$3"
+
+    if [ "$actual" = "$expected" ]; then
+        pass "$testname"
+    else
+        fail "$testname" "$expected" "$actual"
+    fi
+}
+
+
+echo "=== CLI Syntax-Only Tests ==="
+echo "Parser: $PARSER"
+echo "Workdir: $WORKDIR"
+echo ""
+
+if [ ! -x "$PARSER" ]; then
+    echo "ERROR: Parser not found or not executable: $PARSER"
+    exit 1
+fi
+
+mkdir -p "$WORKDIR/lib" "$WORKDIR/model"
+
+cat > "$WORKDIR/lib/Parts.sysml" << 'SYSML'
+package Parts {
+    part def Engine {
+}
+SYSML
+
+cat > "$WORKDIR/model/good.sysml" << 'SYSML'
+package Good {
+    import Parts::*;
+    // An undefined type is a semantic error, not a syntax error
+    part e : Nope;
+}
+SYSML
+
+cat > "$WORKDIR/model/bad.sysml" << 'SYSML'
+package Bad {
+    part def A
+    part b : A;
+}
+SYSML
+
+# ============================================================
+# TEST 1: clean input
+# ============================================================
+echo "--- Test 1: clean input ---"
+
+OUTPUT=$("$PARSER" --syntax-only -I "$WORKDIR/lib" "$WORKDIR/model/good.sysml" 2>&1)
+EXIT_CODE=$?
+assert_equals "$EXIT_CODE" "0" "Exit code 0"
+assert_equals "$OUTPUT" "" "No output"
+
+OUTPUT=$("$PARSER" --syntax-only -f json "$WORKDIR/model/good.sysml" 2>/dev/null)
+assert_equals "$OUTPUT" "" "Nothing written with -f json"
+
+# ============================================================
+# TEST 2: syntax errors match --parse-only
+# ============================================================
+echo ""
+echo "--- Test 2: syntax errors ---"
+
+EXPECTED=$("$PARSER" --parse-only --no-resolve --color=never "$WORKDIR/model/bad.sysml" 2>&1)
+EXPECTED_EXIT=$?
+OUTPUT=$("$PARSER" --syntax-only --color=never "$WORKDIR/model/bad.sysml" 2>&1)
+EXIT_CODE=$?
+assert_equals "$EXIT_CODE" "1" "Exit code 1"
+assert_equals "$EXIT_CODE" "$EXPECTED_EXIT" "Exit code matches --parse-only"
+assert_equals "$OUTPUT" "$EXPECTED" "Errors match --parse-only"
+assert_contains "$OUTPUT" "bad.sysml:3:" "Error location reported"
+
+# ============================================================
+# TEST 3: imports and libraries are not loaded
+# ============================================================
+echo ""
+echo "--- Test 3: no imports ---"
+
+# The library file is broken; checking good.sysml must not parse it
+REPORT=$("$PARSER" --syntax-only -I "$WORKDIR/lib" --stats=json "$WORKDIR/model/good.sysml" 2>&1)
+assert_contains "$REPORT" '"input":1,' "One input checked"
+assert_contains "$REPORT" '"library":0,' "No library parsed"
+assert_contains "$REPORT" '"symtab":{"wall_ms":0.000,"cpu_ms":0.000,"runs":0}' "No validation"
+PEAK=$(echo "$REPORT" | grep -o '"arena_peak_bytes":[0-9]*' | cut -d: -f2)
+assert_equals "${PEAK:-missing}" "0" "No arena memory used"
+
+# ============================================================
+# TEST 4: stdin, -r and -j
+# ============================================================
+echo ""
+echo "--- Test 4: stdin, -r and -j ---"
+
+printf 'package S { part def P; }\n' | "$PARSER" --syntax-only
+assert_equals "$?" "0" "Clean stdin accepted"
+OUTPUT=$(printf 'package S { part def P }\n' | "$PARSER" --syntax-only --color=never 2>&1)
+assert_equals "$?" "1" "Broken stdin rejected"
+assert_contains "$OUTPUT" "<stdin>:1:" "stdin error location"
+
+SERIAL=$("$PARSER" --syntax-only -r -j1 --color=never "$WORKDIR" 2>&1)
+SERIAL_EXIT=$?
+PARALLEL=$("$PARSER" --syntax-only -r -j4 --color=never "$WORKDIR" 2>&1)
+assert_equals "$?" "$SERIAL_EXIT" "-j4 exit code matches -j1"
+assert_equals "$PARALLEL" "$SERIAL" "-j4 errors match -j1"
+assert_contains "$SERIAL" "Parts.sysml" "-r checks every file"
+assert_contains "$SERIAL" "bad.sysml" "-r reports each broken file"
+
+OUTPUT=$("$PARSER" --syntax-only "$WORKDIR/missing.sysml" 2>&1)
+assert_equals "$?" "1" "Unreadable file fails"
+assert_contains "$OUTPUT" "cannot read file" "Read error reported"
+
+# ============================================================
+# Summary
+# ============================================================
+echo ""
+echo "=== Test Summary ==="
+echo "Passed: $TESTS_PASSED"
+echo "Failed: $TESTS_FAILED"
+echo ""
+
+if [ $TESTS_FAILED -gt 0 ]; then
+    echo -e "${RED}Some tests failed!${NC}"
+    exit 1
+else
+    echo -e "${GREEN}All tests passed!${NC}"
+    exit 0
+fi
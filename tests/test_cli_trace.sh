@@ -0,0 +1,208 @@
+#!/bin/bash
+#
+# Integration test for --trace
+#
+# Tests: Trace Event Format output, stdout left untouched, balanced
+# spans, library search and failed-lookup events, model cache events,
+# worker thread tracks, unwritable trace paths
+#
+# SPDX-License-Identifier: MIT
+
+PARSER="${1:-./sysml2}"
+WORKDIR=$(mktemp -d)
+trap "rm -rf $WORKDIR" EXIT
+
+# Colors for output
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+NC='\033[0m' # No Color
+
+TESTS_PASSED=0
+TESTS_FAILED=0
+
+pass() {
+    echo -e "${GREEN}PASS${NC}: $1"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+}
+
+fail() {
+    echo -e "${RED}FAIL${NC}: $1"
+    echo "  Expected: $2"
+    echo "  Got:      $3"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+}
+
+assert_contains() {
+    local output="$1"
+    local expected="$2"
+    local testname="$3"
+
+    if echo "$output" | grep -q -- "$expected"; then
+        pass "$testname"
+    else
+        fail "$testname" "contains '$expected'" "not found in: $output"
+    fi
+}
+
+assert_equals() {
+    local actual="$1"
+    local expected="$2"
+    local testname="$3"
+
+    if [ "$actual" = "$expected" ]; then
+        pass "$testname"
+    else
+        fail "$testname" "$expected" "$actual"
+    fi
+}
+
+echo "=== CLI --trace Tests ==="
+echo "Parser: $PARSER"
+echo "Workdir: $WORKDIR"
+echo ""
+
+if [ ! -x "$PARSER" ]; then
+    echo "ERROR: Parser not found or not executable: $PARSER"
+    exit 1
+fi
+
+mkdir -p "$WORKDIR/lib/sub" "$WORKDIR/model" "$WORKDIR/cache"
+cat > "$WORKDIR/lib/sub/Units.sysml" << 'EOF'
+package Units {
+    attribute def Mass;
+}
+EOF
+cat > "$WORKDIR/model/model.sysml" << 'EOF'
+package Vehicles {
+    private import Units::*;
+    private import Missing::*;
+    part def Car {
+        attribute mass : Mass;
+    }
+}
+EOF
+cat > "$WORKDIR/model/other.sysml" << 'EOF'
+package Fleet {
+    private import Missing::*;
+    private import Vehicles::*;
+    part car : Car;
+}
+EOF
+
+# Check that every thread's begin/end events pair up
+check_balanced() {
+    python3 -c '
+import json, sys
+events = json.load(open(sys.argv[1]))["traceEvents"]
+depth = {}
+for e in events:
+    tid = e["tid"]
+    if e["ph"] == "B":
+        depth[tid] = depth.get(tid, 0) + 1
+    elif e["ph"] == "E":
+        depth[tid] = depth.get(tid, 0) - 1
+        if depth[tid] < 0:
+            sys.exit(1)
+sys.exit(1 if any(depth.values()) else 0)
+' "$1"
+}
+
+# ============================================================
+# TEST 1: spans for parsing, resolution and validation
+# ============================================================
+echo "--- Test 1: trace file ---"
+
+PLAIN=$("$PARSER" -I "$WORKDIR/lib" -f json "$WORKDIR/model/model.sysml" 2>/dev/null)
+WITH_TRACE=$("$PARSER" -I "$WORKDIR/lib" -f json --trace "$WORKDIR/trace.json" \
+    "$WORKDIR/model/model.sysml" 2>/dev/null)
+EXIT_CODE=$?
+TRACE=$(cat "$WORKDIR/trace.json")
+
+assert_equals "$EXIT_CODE" "2" "Exit code is unchanged"
+assert_equals "$WITH_TRACE" "$PLAIN" "Stdout is unchanged"
+assert_contains "$TRACE" '^{"displayTimeUnit":"ms","traceEvents":\[' "Trace Event Format header"
+assert_contains "$TRACE" '"name":"preload","args":{"detail":"'"$WORKDIR/lib"'"}' "Library preload span"
+assert_contains "$TRACE" '"name":"parse","args":{"detail":"'"$WORKDIR/model/model.sysml"'"}' "Input parse span"
+assert_contains "$TRACE" '"name":"parse","args":{"detail":"[^"]*/lib/sub/Units.sysml"}' "Library parse span"
+assert_contains "$TRACE" '"cat":"resolve","name":"Units"' "Import span"
+assert_contains "$TRACE" '"name":"package map hit","s":"t","args":{"detail":"Units"}' "Package map event"
+assert_contains "$TRACE" '"name":"index","args":{"detail":"'"$WORKDIR/lib"'"}' "Library index span"
+assert_contains "$TRACE" '"name":"lookup failed","s":"t","args":{"detail":"Missing"}' "Failed lookup event"
+assert_contains "$TRACE" '"cat":"validate","name":"types"' "Validator pass span"
+if command -v python3 > /dev/null; then
+    if check_balanced "$WORKDIR/trace.json"; then
+        pass "Trace is valid JSON with balanced spans"
+    else
+        fail "Trace is valid JSON with balanced spans" "balanced B/E events" "$TRACE"
+    fi
+fi
+
+# ============================================================
+# TEST 2: the negative cache answers the second lookup
+# ============================================================
+echo ""
+echo "--- Test 2: failed-lookup hits ---"
+
+"$PARSER" -I "$WORKDIR/lib" --trace "$WORKDIR/trace2.json" \
+    "$WORKDIR/model/model.sysml" "$WORKDIR/model/other.sysml" 2>/dev/null
+TRACE=$(cat "$WORKDIR/trace2.json")
+assert_contains "$TRACE" '"name":"failed lookup hit","s":"t","args":{"detail":"Missing"}' "Failed lookup hit event"
+
+# ============================================================
+# TEST 3: model cache events
+# ============================================================
+echo ""
+echo "--- Test 3: --cache-dir ---"
+
+"$PARSER" -I "$WORKDIR/lib" --cache-dir "$WORKDIR/cache" --trace "$WORKDIR/cold.json" \
+    "$WORKDIR/model/model.sysml" 2>/dev/null
+"$PARSER" -I "$WORKDIR/lib" --cache-dir "$WORKDIR/cache" --trace "$WORKDIR/warm.json" \
+    "$WORKDIR/model/model.sysml" 2>/dev/null
+assert_contains "$(cat "$WORKDIR/cold.json")" '"name":"model cache miss"' "Cold run misses the model cache"
+assert_contains "$(cat "$WORKDIR/warm.json")" '"name":"model cache hit"' "Warm run hits the model cache"
+
+# ============================================================
+# TEST 4: parser workers get their own tracks
+# ============================================================
+echo ""
+echo "--- Test 4: -j2 ---"
+
+"$PARSER" -P -j2 --trace "$WORKDIR/jobs.json" \
+    "$WORKDIR/model/model.sysml" "$WORKDIR/model/other.sysml" 2>/dev/null
+TRACE=$(cat "$WORKDIR/jobs.json")
+assert_contains "$TRACE" '"tid":2' "Worker thread track"
+if command -v python3 > /dev/null; then
+    if check_balanced "$WORKDIR/jobs.json"; then
+        pass "Worker spans are balanced"
+    else
+        fail "Worker spans are balanced" "balanced B/E events" "$TRACE"
+    fi
+fi
+
+# ============================================================
+# TEST 5: unwritable trace path
+# ============================================================
+echo ""
+echo "--- Test 5: unwritable path ---"
+
+OUTPUT=$("$PARSER" -P --trace "$WORKDIR/missing/trace.json" "$WORKDIR/model/model.sysml" 2>&1)
+EXIT_CODE=$?
+assert_equals "$EXIT_CODE" "0" "Run still succeeds"
+assert_contains "$OUTPUT" "cannot write trace file" "Warning is printed"
+
+# ============================================================
+# Summary
+# ============================================================
+echo ""
+echo "=== Test Summary ==="
+echo "Passed: $TESTS_PASSED"
+echo "Failed: $TESTS_FAILED"
+echo ""
+
+if [ $TESTS_FAILED -gt 0 ]; then
+    echo -e "${RED}Some tests failed!${NC}"
+    exit 1
+else
+    echo -e "${GREEN}All tests passed!${NC}"
+    exit 0
+fi
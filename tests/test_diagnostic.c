@@ -543,6 +543,115 @@ TEST(diag_list_ordering) {
     FIXTURE_ARENA_TEARDOWN();
 }
 
+/* ========== Printing Tests ========== */
+
+/* Print ctx's diagnostics and return the output (caller frees) */
+static char *print_to_string(const Sysml2DiagContext *ctx, Sysml2DiagFormat format) {
+    FILE *out = tmpfile();
+    ASSERT_NOT_NULL(out);
+    Sysml2DiagOptions options = {
+        .output = out,
+        .format = format,
+        .color_mode = SYSML2_COLOR_NEVER,
+        .show_source_context = true,
+        .show_column_numbers = true,
+        .show_error_codes = true,
+    };
+    sysml2_diag_print_all(ctx, &options);
+
+    long length = ftell(out);
+    char *text = malloc((size_t)length + 1);
+    rewind(out);
+    ASSERT_EQ(fread(text, 1, (size_t)length, out), (size_t)length);
+    text[length] = '\0';
+    fclose(out);
+    return text;
+}
+
+static Sysml2SourceRange range_at(uint32_t line, uint32_t column, uint32_t end_column) {
+    return (Sysml2SourceRange){ {line, column, 0}, {line, end_column, 0} };
+}
+
+TEST(diag_print_text) {
+    FIXTURE_ARENA_SETUP();
+
+    Sysml2DiagContext ctx;
+    sysml2_diag_context_init(&ctx, &arena);
+
+    static const char content[] = "package P {\n\tpart a : Engin;\n}\n";
+    Sysml2SourceFile file = { .path = "m.sysml", .content = content, .content_length = strlen(content) };
+
+    Sysml2Diagnostic *d = sysml2_diag_create(
+        &ctx, SYSML2_DIAG_E3001_UNDEFINED_TYPE, SYSML2_SEVERITY_ERROR,
+        &file, range_at(2, 11, 16), "undefined type 'Engin'"
+    );
+    sysml2_diag_add_help(d, &ctx, "did you mean 'Engine'?");
+    sysml2_diag_add_note(d, &ctx, &file, range_at(1, 9, 10), "in package 'P'");
+    sysml2_diag_emit(&ctx, d);
+
+    char *text = print_to_string(&ctx, SYSML2_DIAG_FORMAT_TEXT);
+    ASSERT_STR_EQ(text,
+        "m.sysml:2:11: error[E3001]: undefined type 'Engin'\n"
+        "   |\n"
+        "  2| \tpart a : Engin;\n"
+        "   | \t         ^^^^^\n"
+        "   |\n"
+        "   = help: did you mean 'Engine'?\n"
+        "m.sysml:1:9: note[E3001]: in package 'P'\n"
+        "   |\n"
+        "  1| package P {\n"
+        "   |         ^\n"
+        "   |\n"
+        "\n"
+        "\n");
+    free(text);
+
+    /* The line table is built once and kept on the file */
+    ASSERT_NOT_NULL(file.line_offsets);
+    ASSERT_EQ(file.line_count, 4);
+    free((void *)file.line_offsets);
+
+    FIXTURE_ARENA_TEARDOWN();
+}
+
+TEST(diag_print_json) {
+    FIXTURE_ARENA_SETUP();
+
+    Sysml2DiagContext ctx;
+    sysml2_diag_context_init(&ctx, &arena);
+
+    static const char content[] = "part x;\n";
+    Sysml2SourceFile file = { .path = "dir/\"q\".sysml", .content = content, .content_length = strlen(content) };
+
+    Sysml2Diagnostic *d = sysml2_diag_create(
+        &ctx, SYSML2_DIAG_E3004_DUPLICATE_NAME, SYSML2_SEVERITY_ERROR,
+        &file, range_at(1, 6, 7), "duplicate\tname"
+    );
+    sysml2_diag_add_fixit(d, &ctx, range_at(1, 6, 7), "y");
+    sysml2_diag_add_note(d, &ctx, &file, range_at(1, 1, 1), "first here");
+    sysml2_diag_emit(&ctx, d);
+    sysml2_diag_emit(&ctx, sysml2_diag_create(
+        &ctx, SYSML2_DIAG_W1003_DEPRECATED, SYSML2_SEVERITY_WARNING,
+        NULL, SYSML2_RANGE_INVALID, "no file"
+    ));
+
+    char *text = print_to_string(&ctx, SYSML2_DIAG_FORMAT_JSON);
+    ASSERT_STR_EQ(text,
+        "{\"file\":\"dir/\\\"q\\\".sysml\",\"line\":1,\"column\":6,\"end_line\":1,\"end_column\":7,"
+        "\"severity\":\"error\",\"code\":\"E3004\",\"message\":\"duplicate\\tname\","
+        "\"fixits\":[{\"line\":1,\"column\":6,\"end_line\":1,\"end_column\":7,\"replacement\":\"y\"}],"
+        "\"notes\":[{\"file\":\"dir/\\\"q\\\".sysml\",\"line\":1,\"column\":1,\"end_line\":1,\"end_column\":1,"
+        "\"severity\":\"note\",\"code\":\"E3004\",\"message\":\"first here\"}]}\n"
+        "{\"file\":null,\"line\":0,\"column\":0,\"end_line\":0,\"end_column\":0,"
+        "\"severity\":\"warning\",\"code\":\"W1003\",\"message\":\"no file\"}\n");
+    free(text);
+
+    /* No snippets, so the source is never indexed */
+    ASSERT_NULL(file.line_offsets);
+
+    FIXTURE_ARENA_TEARDOWN();
+}
+
 /* ========== Main ========== */
 
 int main(void) {
@@ -591,6 +700,10 @@ int main(void) {
     /* List ordering */
     RUN_TEST(diag_list_ordering);
 
+    /* Printing tests */
+    RUN_TEST(diag_print_text);
+    RUN_TEST(diag_print_json);
+
     printf("\n%d/%d tests passed.\n", tests_passed, tests_run);
     return tests_passed == tests_run ? 0 : 1;
 }
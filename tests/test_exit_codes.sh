@@ -173,6 +173,28 @@ echo 'package P { attribute x = "unterminated string; }' > "$LEXICAL_ERROR"
 run_test "lexical error returns 1" 1 "$SYSML2" "$LEXICAL_ERROR"
 rm -f "$LEXICAL_ERROR"
 
+# Parallel parsing keeps serial exit codes and output
+MULTI_A="$TMPDIR/sysml2_test_jobs_a_$$.sysml"
+MULTI_B="$TMPDIR/sysml2_test_jobs_b_$$.sysml"
+LEXICAL_ERROR_J="$TMPDIR/sysml2_test_jobs_err_$$.sysml"
+echo 'package A { part def X; }' > "$MULTI_A"
+echo 'package B { part p: Missing; }' > "$MULTI_B"
+echo 'package C {{{' > "$LEXICAL_ERROR_J"
+run_test "parallel parse of valid files returns 0" 0 "$SYSML2" -j 2 "$MULTI_A" "$MULTI_A"
+run_test "parallel parse with semantic error returns 2" 2 "$SYSML2" -j 2 "$MULTI_A" "$MULTI_B"
+run_test "parallel parse with parse error returns 1" 1 "$SYSML2" -j 2 "$MULTI_A" "$LEXICAL_ERROR_J"
+serial_out=$("$SYSML2" -f json "$MULTI_A" "$MULTI_B" 2>&1 || true)
+parallel_out=$("$SYSML2" -j 2 -f json "$MULTI_A" "$MULTI_B" 2>&1 || true)
+if [ "$serial_out" = "$parallel_out" ]; then
+    echo "PASS: -j 2 output matches serial output"
+    PASSED=$((PASSED + 1))
+else
+    echo "FAIL: -j 2 output differs from serial output"
+    FAILED=$((FAILED + 1))
+fi
+run_test "invalid job count returns 1" 1 "$SYSML2" -j abc "$MULTI_A"
+rm -f "$MULTI_A" "$MULTI_B" "$LEXICAL_ERROR_J"
+
 echo ""
 echo "=== Summary ==="
 echo "Passed: $PASSED"
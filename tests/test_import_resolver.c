@@ -14,6 +14,8 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 static int tests_run = 0;
 static int tests_passed = 0;
@@ -356,6 +358,166 @@ TEST(resolver_find_file_no_paths) {
     FIXTURE_TEARDOWN();
 }
 
+/* Create dir/rel (and its parent directories) as an empty file */
+static void make_file(const char *dir, const char *rel) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", dir, rel);
+    for (char *p = path + strlen(dir) + 1; *p; p++) {
+        if (*p != '/') continue;
+        *p = '\0';
+        mkdir(path, 0755);
+        *p = '/';
+    }
+    FILE *f = fopen(path, "w");
+    ASSERT_NOT_NULL(f);
+    fclose(f);
+}
+
+static bool ends_with(const char *s, const char *suffix) {
+    size_t n = strlen(s), m = strlen(suffix);
+    return n >= m && strcmp(s + n - m, suffix) == 0;
+}
+
+TEST(resolver_find_file_indexed_search) {
+    FIXTURE_SETUP();
+
+    char dir[] = "/tmp/sysml2_resolver_XXXXXX";
+    ASSERT_NOT_NULL(mkdtemp(dir));
+    make_file(dir, "Top.kerml");
+    make_file(dir, "a/b/Deep.sysml");
+    make_file(dir, "1/2/3/4/5/TooDeep.sysml");
+
+    Sysml2ImportResolver *resolver = sysml2_resolver_create(&arena, &intern);
+    sysml2_resolver_add_path(resolver, dir);
+
+    char *found = sysml2_resolver_find_file(resolver, "Deep::*");
+    ASSERT_NOT_NULL(found);
+    ASSERT_TRUE(ends_with(found, "/a/b/Deep.sysml"));
+    free(found);
+    ASSERT_EQ(resolver->indexed_paths, 1);
+
+    /* Direct files are still checked first */
+    found = sysml2_resolver_find_file(resolver, "Top");
+    ASSERT_NOT_NULL(found);
+    ASSERT_TRUE(ends_with(found, "/Top.kerml"));
+    free(found);
+
+    /* Same depth limit as the directory search */
+    ASSERT_NULL(sysml2_resolver_find_file(resolver, "TooDeep"));
+
+    sysml2_resolver_destroy(resolver);
+    FIXTURE_TEARDOWN();
+
+    char cmd[600];
+    snprintf(cmd, sizeof(cmd), "rm -rf '%s'", dir);
+    ASSERT_EQ(system(cmd), 0);
+}
+
+/* ========== Preload Tests ========== */
+
+TEST(resolver_preload_whole_tree) {
+    FIXTURE_SETUP();
+
+    char dir[] = "/tmp/sysml2_resolver_XXXXXX";
+    ASSERT_NOT_NULL(mkdtemp(dir));
+    /* More files than the read-ahead window, spread over nested dirs */
+    char path[600];
+    for (int i = 0; i < 20; i++) {
+        snprintf(path, sizeof(path), "d%d/sub/F%d.%s", i % 3, i, i % 2 ? "kerml" : "sysml");
+        make_file(dir, path);
+        snprintf(path, sizeof(path), "%s/d%d/sub/F%d.%s", dir, i % 3, i, i % 2 ? "kerml" : "sysml");
+        FILE *f = fopen(path, "w");
+        ASSERT_NOT_NULL(f);
+        fprintf(f, "package F%d;\n", i);
+        fclose(f);
+    }
+    make_file(dir, ".hidden/Skipped.sysml");
+    make_file(dir, "notes.txt");
+
+    Sysml2ImportResolver *resolver = sysml2_resolver_create(&arena, &intern);
+    sysml2_resolver_add_path(resolver, dir);
+    Sysml2DiagContext diag;
+    sysml2_diag_context_init(&diag, &arena);
+    ASSERT_EQ(sysml2_resolver_preload_libraries(resolver, &diag), SYSML2_OK);
+    ASSERT_EQ(diag.error_count, 0);
+
+    ASSERT_EQ(resolver->file_cache_count, 20);
+    ASSERT_EQ(resolver->files_parsed, 20);
+    for (int i = 0; i < 20; i++) {
+        snprintf(path, sizeof(path), "%s/d%d/sub/F%d.%s", dir, i % 3, i, i % 2 ? "kerml" : "sysml");
+        char *abs_path = realpath(path, NULL);
+        ASSERT_NOT_NULL(abs_path);
+        ASSERT_NOT_NULL(sysml2_resolver_get_cached(resolver, abs_path));
+        free(abs_path);
+    }
+
+    sysml2_resolver_destroy(resolver);
+    FIXTURE_TEARDOWN();
+
+    char cmd[600];
+    snprintf(cmd, sizeof(cmd), "rm -rf '%s'", dir);
+    ASSERT_EQ(system(cmd), 0);
+}
+
+/* ========== Package Scanner Tests ========== */
+
+/* Scan a string and return the package name (static buffer) or a marker */
+static const char *scan(const char *text) {
+    static char buf[128];
+    const char *name = NULL;
+    size_t len = 0;
+    Sysml2PackageScan result = sysml2_scan_top_level_package(text, strlen(text), &name, &len);
+    if (result == SYSML2_SCAN_NO_PACKAGE) return "<none>";
+    if (result == SYSML2_SCAN_AMBIGUOUS) return "<ambiguous>";
+    snprintf(buf, sizeof(buf), "%.*s", (int)len, name);
+    return buf;
+}
+
+TEST(scan_plain_package) {
+    ASSERT_STR_EQ(scan("package Vehicle { part def Engine; }"), "Vehicle");
+    ASSERT_STR_EQ(scan("package Empty;"), "Empty");
+}
+
+TEST(scan_library_package) {
+    ASSERT_STR_EQ(scan("standard library package ScalarValues { }"), "ScalarValues");
+    ASSERT_STR_EQ(scan("library #Meta package Lib {}"), "Lib");
+    ASSERT_STR_EQ(scan("#Approved package P {}"), "P");
+}
+
+TEST(scan_quoted_name) {
+    ASSERT_STR_EQ(scan("package 'My Package' { }"), "My Package");
+    ASSERT_STR_EQ(scan("package 'Esc\\'aped' { }"), "<ambiguous>");
+}
+
+TEST(scan_skips_trivia_and_nested_bodies) {
+    ASSERT_STR_EQ(scan(
+        "// package Fake1 {}\n"
+        "/* package Fake2 {} */\n"
+        "//* package Fake3 */\n"
+        "part def X { doc /* package Fake4 */ attribute a = \"package Fake5 {\"; }\n"
+        "part def Y { package Nested {} }\n"
+        "package Real {}"), "Real");
+}
+
+TEST(scan_no_package) {
+    ASSERT_STR_EQ(scan(""), "<none>");
+    ASSERT_STR_EQ(scan("part def X; mypackage y;"), "<none>");
+}
+
+TEST(scan_ambiguous_cases) {
+    ASSERT_STR_EQ(scan("package <SN> Named {}"), "<ambiguous>");
+    ASSERT_STR_EQ(scan("package {}"), "<ambiguous>");
+    ASSERT_STR_EQ(scan("/* unterminated package P {}"), "<ambiguous>");
+    ASSERT_STR_EQ(scan("part def X { package P {}"), "<ambiguous>");
+    ASSERT_STR_EQ(scan("} package P {}"), "<ambiguous>");
+}
+
+TEST(scan_null_handling) {
+    const char *name = NULL;
+    size_t len = 0;
+    ASSERT_EQ(sysml2_scan_top_level_package(NULL, 0, &name, &len), SYSML2_SCAN_AMBIGUOUS);
+}
+
 /* ========== Main ========== */
 
 int main(void) {
@@ -386,6 +548,19 @@ int main(void) {
     /* Find file tests */
     RUN_TEST(resolver_find_file_null_handling);
     RUN_TEST(resolver_find_file_no_paths);
+    RUN_TEST(resolver_find_file_indexed_search);
+
+    /* Preload tests */
+    RUN_TEST(resolver_preload_whole_tree);
+
+    /* Package scanner tests */
+    RUN_TEST(scan_plain_package);
+    RUN_TEST(scan_library_package);
+    RUN_TEST(scan_quoted_name);
+    RUN_TEST(scan_skips_trivia_and_nested_bodies);
+    RUN_TEST(scan_no_package);
+    RUN_TEST(scan_ambiguous_cases);
+    RUN_TEST(scan_null_handling);
 
     printf("\n%d/%d tests passed.\n", tests_passed, tests_run);
     return tests_passed == tests_run ? 0 : 1;
@@ -9,6 +9,7 @@
 #include "sysml2/intern.h"
 #include "sysml2/ast.h"
 #include "sysml2/json_writer.h"
+#include "sysml2/query.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -262,6 +263,130 @@ TEST(json_write_with_relationships) {
     FIXTURE_TEARDOWN();
 }
 
+TEST(json_write_escapes_long_strings) {
+    FIXTURE_SETUP();
+
+    SysmlSemanticModel *model = create_test_model(&arena, &intern, "test.sysml");
+
+    /* Special characters on both sides of 16-byte boundaries */
+    SysmlNode *node = SYSML2_ARENA_NEW(&arena, SysmlNode);
+    node->id = sysml2_intern(&intern, "Pkg::Long");
+    node->name = sysml2_intern(&intern,
+        "abcdefghijklmno\"pqrstuvwxyz012345\\6789ABCDEFGHIJ\x01KLMNOP\xc3\xa9QRSTUVWXYZabcde\n");
+    node->kind = SYSML_KIND_PART_DEF;
+
+    model->elements = SYSML2_ARENA_NEW_ARRAY(&arena, SysmlNode *, 1);
+    model->elements[0] = node;
+    model->element_count = 1;
+
+    char *output = NULL;
+    Sysml2Result result = sysml2_json_write_string(model, NULL, &output);
+    ASSERT_EQ(result, SYSML2_OK);
+    ASSERT_NOT_NULL(output);
+
+    ASSERT(strstr(output,
+        "\"abcdefghijklmno\\\"pqrstuvwxyz012345\\\\6789ABCDEFGHIJ\\u0001KLMNOP\xc3\xa9QRSTUVWXYZabcde\\n\"")
+        != NULL);
+
+    free(output);
+    FIXTURE_TEARDOWN();
+}
+
+TEST(json_write_output_larger_than_buffer) {
+    FIXTURE_SETUP();
+
+    SysmlSemanticModel *model = create_test_model(&arena, &intern, "test.sysml");
+
+    size_t count = 5000;
+    model->elements = SYSML2_ARENA_NEW_ARRAY(&arena, SysmlNode *, count);
+    char id[32];
+    for (size_t i = 0; i < count; i++) {
+        SysmlNode *node = SYSML2_ARENA_NEW(&arena, SysmlNode);
+        snprintf(id, sizeof(id), "Pkg::E%zu", i);
+        node->id = sysml2_intern(&intern, id);
+        node->name = node->id + 5;
+        node->kind = SYSML_KIND_PART_DEF;
+        model->elements[model->element_count++] = node;
+    }
+
+    char *output = NULL;
+    Sysml2Result result = sysml2_json_write_string(model, NULL, &output);
+    ASSERT_EQ(result, SYSML2_OK);
+    ASSERT_NOT_NULL(output);
+
+    ASSERT(strlen(output) > 64 * 1024);
+    ASSERT(strstr(output, "\"Pkg::E0\"") != NULL);
+    ASSERT(strstr(output, "\"Pkg::E4999\"") != NULL);
+    size_t length = strlen(output);
+    ASSERT(output[length - 2] == '}' && output[length - 1] == '\n');
+
+    free(output);
+    FIXTURE_TEARDOWN();
+}
+
+/* Render a query result with the given thread count */
+static char *write_query_with_jobs(const Sysml2QueryResult *query, size_t jobs, bool pretty) {
+    Sysml2JsonOptions options = SYSML_JSON_OPTIONS_DEFAULT;
+    options.jobs = jobs;
+    options.pretty = pretty;
+
+    char *text = NULL;
+    size_t length = 0;
+    FILE *out = open_memstream(&text, &length);
+    ASSERT_NOT_NULL(out);
+    ASSERT_EQ(sysml2_json_write_query(query, out, &options), SYSML2_OK);
+    fclose(out);
+    return text;
+}
+
+TEST(json_write_query_parallel_matches_serial) {
+    FIXTURE_SETUP();
+
+    /* Enough items for several chunks per array, the last one partial */
+    size_t count = 5000;
+    Sysml2QueryResult query = {0};
+    query.elements = SYSML2_ARENA_NEW_ARRAY(&arena, SysmlNode *, count);
+    query.relationships = SYSML2_ARENA_NEW_ARRAY(&arena, SysmlRelationship *, count);
+    char id[32];
+    for (size_t i = 0; i < count; i++) {
+        SysmlNode *node = SYSML2_ARENA_NEW(&arena, SysmlNode);
+        snprintf(id, sizeof(id), "Pkg::E%zu", i);
+        node->id = sysml2_intern(&intern, id);
+        node->name = node->id + 5;
+        node->kind = SYSML_KIND_PART_DEF;
+        query.elements[query.element_count++] = node;
+
+        SysmlRelationship *rel = SYSML2_ARENA_NEW(&arena, SysmlRelationship);
+        snprintf(id, sizeof(id), "rel%zu", i);
+        rel->id = sysml2_intern(&intern, id);
+        rel->kind = SYSML_KIND_REL_SPECIALIZATION;
+        rel->source = node->id;
+        rel->target = query.elements[0]->id;
+        query.relationships[query.relationship_count++] = rel;
+    }
+
+    for (int pretty = 0; pretty <= 1; pretty++) {
+        char *serial = write_query_with_jobs(&query, 1, pretty);
+        char *parallel = write_query_with_jobs(&query, 4, pretty);
+        ASSERT_STR_EQ(parallel, serial);
+        ASSERT(strstr(serial, "\"Pkg::E4999\"") != NULL);
+        ASSERT(strstr(serial, "\"rel4999\"") != NULL);
+        free(serial);
+        free(parallel);
+    }
+
+    /* Below the threshold the serial path is taken */
+    query.element_count = 10;
+    query.relationship_count = 10;
+    char *serial = write_query_with_jobs(&query, 1, true);
+    char *parallel = write_query_with_jobs(&query, 4, true);
+    ASSERT_STR_EQ(parallel, serial);
+    free(serial);
+    free(parallel);
+
+    FIXTURE_TEARDOWN();
+}
+
 /* ========== Options Tests ========== */
 
 TEST(json_write_compact) {
@@ -283,11 +408,78 @@ TEST(json_write_compact) {
     /* Compact output should not have leading spaces for indentation */
     /* But it's still valid JSON */
     ASSERT(strstr(output, "\"meta\"") != NULL);
+    ASSERT(strchr(output, '\n') == NULL);
+
+    free(output);
+    FIXTURE_TEARDOWN();
+}
+
+/* ========== NDJSON Tests ========== */
+
+TEST(json_write_ndjson_records) {
+    FIXTURE_SETUP();
+
+    SysmlSemanticModel *model = create_test_model(&arena, &intern, "test.sysml");
+
+    SysmlNode *node = SYSML2_ARENA_NEW(&arena, SysmlNode);
+    node->id = sysml2_intern(&intern, "Pkg");
+    node->name = sysml2_intern(&intern, "Pkg");
+    node->kind = SYSML_KIND_PACKAGE;
+    model->elements = SYSML2_ARENA_NEW_ARRAY(&arena, SysmlNode *, 1);
+    model->elements[0] = node;
+    model->element_count = 1;
+
+    SysmlRelationship *rel = SYSML2_ARENA_NEW(&arena, SysmlRelationship);
+    rel->id = sysml2_intern(&intern, "rel1");
+    rel->kind = SYSML_KIND_REL_SPECIALIZATION;
+    rel->source = sysml2_intern(&intern, "A");
+    rel->target = sysml2_intern(&intern, "B");
+    model->relationships = SYSML2_ARENA_NEW_ARRAY(&arena, SysmlRelationship *, 1);
+    model->relationships[0] = rel;
+    model->relationship_count = 1;
+
+    SysmlImport *imp = SYSML2_ARENA_NEW(&arena, SysmlImport);
+    imp->id = sysml2_intern(&intern, "Pkg::import0");
+    imp->kind = SYSML_KIND_IMPORT_ALL;
+    imp->target = sysml2_intern(&intern, "Base");
+    imp->owner_scope = sysml2_intern(&intern, "Pkg");
+    imp->is_private = true;
+    model->imports = SYSML2_ARENA_NEW_ARRAY(&arena, SysmlImport *, 1);
+    model->imports[0] = imp;
+    model->import_count = 1;
+
+    /* Pretty options are ignored: one record per line */
+    char *output = NULL;
+    size_t size = 0;
+    FILE *out = open_memstream(&output, &size);
+    ASSERT_NOT_NULL(out);
+    ASSERT_EQ(sysml2_json_write_ndjson(model, out, NULL), SYSML2_OK);
+    fclose(out);
+
+    const char *expected =
+        "{\"meta\": {\"version\": \"1.0\",\"source\": \"test.sysml\"}}\n"
+        "{\"element\": {\"id\": \"Pkg\",\"name\": \"Pkg\",\"type\": \"Package\",\"parent\": null}}\n"
+        "{\"relationship\": {\"id\": \"rel1\",\"type\": \"Specialization\","
+        "\"source\": \"A\",\"target\": \"B\"}}\n"
+        "{\"import\": {\"id\": \"Pkg::import0\",\"type\": \"ImportAll\","
+        "\"target\": \"Base\",\"owner\": \"Pkg\",\"private\": true}}\n";
+    ASSERT_STR_EQ(output, expected);
 
     free(output);
     FIXTURE_TEARDOWN();
 }
 
+TEST(json_write_ndjson_null_args) {
+    FIXTURE_SETUP();
+
+    SysmlSemanticModel *model = create_test_model(&arena, &intern, "test.sysml");
+    ASSERT_EQ(sysml2_json_write_ndjson(NULL, stdout, NULL), SYSML2_ERROR_SYNTAX);
+    ASSERT_EQ(sysml2_json_write_ndjson(model, NULL, NULL), SYSML2_ERROR_SYNTAX);
+    ASSERT_EQ(sysml2_json_write_query_ndjson(NULL, stdout), SYSML2_ERROR_SYNTAX);
+
+    FIXTURE_TEARDOWN();
+}
+
 TEST(json_write_no_source) {
     FIXTURE_SETUP();
 
@@ -366,11 +558,18 @@ int main(void) {
     RUN_TEST(json_write_empty_model);
     RUN_TEST(json_write_single_element);
     RUN_TEST(json_write_with_relationships);
+    RUN_TEST(json_write_escapes_long_strings);
+    RUN_TEST(json_write_output_larger_than_buffer);
+    RUN_TEST(json_write_query_parallel_matches_serial);
 
     /* Options */
     RUN_TEST(json_write_compact);
     RUN_TEST(json_write_no_source);
 
+    /* NDJSON */
+    RUN_TEST(json_write_ndjson_records);
+    RUN_TEST(json_write_ndjson_null_args);
+
     /* Error handling */
     RUN_TEST(json_write_null_model);
     RUN_TEST(json_write_null_output);
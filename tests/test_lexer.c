@@ -288,11 +288,39 @@ TEST(full_declaration) {
     sysml2_arena_destroy(&arena);
 }
 
+TEST(keyword_lookup_all) {
+    static const struct {
+        const char *name;
+        Sysml2TokenType type;
+    } all[] = {
+#define SYSML2_KEYWORD(spelling, token) {spelling, SYSML2_TOKEN_KW_##token},
+#include "keywords.def"
+#undef SYSML2_KEYWORD
+    };
+
+    char buf[32];
+    for (size_t i = 0; i < sizeof(all) / sizeof(all[0]); i++) {
+        size_t len = strlen(all[i].name);
+        ASSERT_EQ(sysml2_keyword_lookup(all[i].name, len), all[i].type);
+
+        /* Prefixes and extensions don't match (some prefixes are other
+         * keywords, e.g. "subset" of "subsets") */
+        ASSERT(sysml2_keyword_lookup(all[i].name, len - 1) != all[i].type);
+        snprintf(buf, sizeof(buf), "%s_", all[i].name);
+        ASSERT_EQ(sysml2_keyword_lookup(buf, len + 1), SYSML2_TOKEN_IDENTIFIER);
+    }
+
+    ASSERT_EQ(sysml2_keyword_lookup("", 0), SYSML2_TOKEN_IDENTIFIER);
+    ASSERT_EQ(sysml2_keyword_lookup("Part", 4), SYSML2_TOKEN_IDENTIFIER);
+    ASSERT_EQ(sysml2_keyword_lookup("specializationx", 15), SYSML2_TOKEN_IDENTIFIER);
+}
+
 int main(void) {
     printf("Running lexer tests:\n");
 
     RUN_TEST(empty_input);
     RUN_TEST(single_keyword);
+    RUN_TEST(keyword_lookup_all);
     RUN_TEST(identifier);
     RUN_TEST(unrestricted_name);
     RUN_TEST(integer_literal);
@@ -7,10 +7,15 @@
 #include "sysml2/common.h"
 #include "sysml2/arena.h"
 #include "sysml2/intern.h"
+#include "sysml2/parser_pool.h"
+#include "sysml2/memory_budget.h"
+#include "sysml2/diagnostic.h"
+#include "sysml2/utils.h"
 
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <unistd.h>
 
 static int tests_run = 0;
 static int tests_passed = 0;
@@ -220,6 +225,88 @@ TEST(arena_many_allocations) {
     sysml2_arena_destroy(&arena);
 }
 
+/* ========== Arena Mark/Rewind Tests ========== */
+
+TEST(arena_rewind_same_block) {
+    Sysml2Arena arena;
+    sysml2_arena_init(&arena);
+
+    char *kept = sysml2_arena_strdup(&arena, "kept");
+    Sysml2ArenaMark mark = sysml2_arena_mark(&arena);
+    size_t used = sysml2_arena_used(&arena);
+
+    void *dropped = sysml2_arena_alloc(&arena, 100);
+    ASSERT(sysml2_arena_allocated_since(&arena, mark, dropped));
+    ASSERT(!sysml2_arena_allocated_since(&arena, mark, kept));
+
+    sysml2_arena_rewind(&arena, mark);
+    ASSERT_EQ(sysml2_arena_used(&arena), used);
+    ASSERT_STR_EQ(kept, "kept");
+
+    /* Space is handed out again */
+    void *again = sysml2_arena_alloc(&arena, 100);
+    ASSERT(again == dropped);
+
+    sysml2_arena_destroy(&arena);
+}
+
+TEST(arena_rewind_frees_blocks) {
+    Sysml2Arena arena;
+    sysml2_arena_init_with_size(&arena, 256);
+
+    char *kept = sysml2_arena_strdup(&arena, "kept");
+    Sysml2ArenaMark mark = sysml2_arena_mark(&arena);
+    Sysml2ArenaBlock *block = arena.head;
+
+    for (int i = 0; i < 100; i++) {
+        ASSERT_NOT_NULL(sysml2_arena_alloc(&arena, 64));
+    }
+    ASSERT(arena.head != block);
+
+    sysml2_arena_rewind(&arena, mark);
+    ASSERT(arena.head == block);
+    ASSERT(arena.blocks == block);
+    ASSERT_NULL(block->next);
+    ASSERT_STR_EQ(kept, "kept");
+
+    sysml2_arena_destroy(&arena);
+}
+
+TEST(arena_rewind_empty) {
+    Sysml2Arena arena;
+    sysml2_arena_init(&arena);
+
+    /* A mark on an empty arena rewinds to empty */
+    Sysml2ArenaMark mark = sysml2_arena_mark(&arena);
+    ASSERT_NOT_NULL(sysml2_arena_alloc(&arena, 16));
+    sysml2_arena_rewind(&arena, mark);
+    ASSERT_NULL(arena.head);
+    ASSERT_NULL(arena.blocks);
+    ASSERT_EQ(sysml2_arena_used(&arena), 0);
+
+    sysml2_arena_destroy(&arena);
+}
+
+TEST(arena_rewind_nested) {
+    Sysml2Arena arena;
+    sysml2_arena_init_with_size(&arena, 128);
+
+    Sysml2ArenaMark outer = sysml2_arena_mark(&arena);
+    char *a = sysml2_arena_strdup(&arena, "a");
+    Sysml2ArenaMark inner = sysml2_arena_mark(&arena);
+    for (int i = 0; i < 20; i++) sysml2_arena_alloc(&arena, 64);
+
+    sysml2_arena_rewind(&arena, inner);
+    ASSERT_STR_EQ(a, "a");
+    ASSERT(!sysml2_arena_allocated_since(&arena, inner, a));
+    ASSERT(sysml2_arena_allocated_since(&arena, outer, a));
+
+    sysml2_arena_rewind(&arena, outer);
+    ASSERT_EQ(sysml2_arena_used(&arena), 0);
+
+    sysml2_arena_destroy(&arena);
+}
+
 /* ========== Intern Basic Tests ========== */
 
 TEST(intern_init) {
@@ -395,6 +482,477 @@ TEST(intern_hash_collision) {
     sysml2_arena_destroy(&arena);
 }
 
+TEST(intern_growth) {
+    Sysml2Arena arena;
+    sysml2_arena_init(&arena);
+
+    Sysml2Intern intern;
+    sysml2_intern_init_with_capacity(&intern, &arena, 16);
+
+    /* Grow well past the initial capacity; pointers must stay stable */
+    enum { N = 20000 };
+    const char **strings = malloc(N * sizeof(char *));
+    ASSERT_NOT_NULL(strings);
+    for (int i = 0; i < N; i++) {
+        char buf[48];
+        snprintf(buf, sizeof(buf), "Pkg::Part_%d::attr", i);
+        strings[i] = sysml2_intern(&intern, buf);
+        ASSERT_NOT_NULL(strings[i]);
+    }
+
+    ASSERT_EQ(sysml2_intern_count(&intern), N);
+    ASSERT_EQ(intern.capacity & (intern.capacity - 1), 0);
+    ASSERT(intern.count * 100 <= intern.capacity * SYSML2_INTERN_MAX_LOAD_PERCENT);
+
+    for (int i = 0; i < N; i++) {
+        char buf[48];
+        snprintf(buf, sizeof(buf), "Pkg::Part_%d::attr", i);
+        ASSERT_EQ(sysml2_intern_lookup(&intern, buf), strings[i]);
+        ASSERT_EQ(sysml2_intern(&intern, buf), strings[i]);
+    }
+
+    free(strings);
+    sysml2_intern_destroy(&intern);
+    sysml2_arena_destroy(&arena);
+}
+
+TEST(intern_reserve) {
+    Sysml2Arena arena;
+    sysml2_arena_init(&arena);
+
+    Sysml2Intern intern;
+    sysml2_intern_init(&intern, &arena);
+    const char *before = sysml2_intern(&intern, "kept");
+
+    ASSERT_TRUE(sysml2_intern_reserve(&intern, 5000));
+    size_t reserved = intern.capacity;
+    ASSERT(5000 * 100 <= reserved * SYSML2_INTERN_MAX_LOAD_PERCENT);
+    ASSERT_EQ(sysml2_intern_lookup(&intern, "kept"), before);
+
+    /* Filling up to the reservation does not rehash */
+    for (int i = 0; i < 4999; i++) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "r%d", i);
+        ASSERT_NOT_NULL(sysml2_intern(&intern, buf));
+    }
+    ASSERT_EQ(intern.capacity, reserved);
+
+    /* Reserve never shrinks */
+    ASSERT_TRUE(sysml2_intern_reserve(&intern, 1));
+    ASSERT_EQ(intern.capacity, reserved);
+
+    sysml2_intern_destroy(&intern);
+    sysml2_arena_destroy(&arena);
+}
+
+TEST(intern_embedded_lengths) {
+    Sysml2Arena arena;
+    sysml2_arena_init(&arena);
+
+    Sysml2Intern intern;
+    sysml2_intern_init(&intern, &arena);
+
+    /* Prefixes around the 8-byte hash word boundary are distinct */
+    const char *text = "ABCDEFGHIJKLMNOPQ";
+    const char *prefixes[17];
+    for (size_t len = 0; len <= 16; len++) {
+        prefixes[len] = sysml2_intern_n(&intern, text, len);
+        ASSERT_NOT_NULL(prefixes[len]);
+        ASSERT_EQ(strlen(prefixes[len]), len);
+    }
+    for (size_t a = 0; a <= 16; a++) {
+        for (size_t b = a + 1; b <= 16; b++) {
+            ASSERT(prefixes[a] != prefixes[b]);
+        }
+    }
+    ASSERT_EQ(sysml2_intern_count(&intern), 17);
+
+    sysml2_intern_destroy(&intern);
+    sysml2_arena_destroy(&arena);
+}
+
+TEST(intern_rewind) {
+    Sysml2Arena arena;
+    sysml2_arena_init_with_size(&arena, 256);
+
+    Sysml2Intern intern;
+    sysml2_intern_init(&intern, &arena);
+
+    const char *kept = sysml2_intern(&intern, "kept");
+    Sysml2ArenaMark mark = sysml2_arena_mark(&arena);
+
+    /* Enough strings to grow the table and add blocks */
+    char buf[32];
+    for (int i = 0; i < 200; i++) {
+        snprintf(buf, sizeof(buf), "speculative_%d", i);
+        ASSERT_NOT_NULL(sysml2_intern(&intern, buf));
+    }
+    ASSERT_EQ(sysml2_intern_count(&intern), 201);
+
+    ASSERT(sysml2_intern_rewind(&intern, mark));
+    sysml2_arena_rewind(&arena, mark);
+
+    ASSERT_EQ(sysml2_intern_count(&intern), 1);
+    ASSERT(sysml2_intern_lookup(&intern, "kept") == kept);
+    ASSERT_NULL(sysml2_intern_lookup(&intern, "speculative_7"));
+
+    /* Re-interning after the rewind still deduplicates */
+    const char *again = sysml2_intern(&intern, "speculative_7");
+    ASSERT_NOT_NULL(again);
+    ASSERT(sysml2_intern(&intern, "speculative_7") == again);
+    ASSERT(sysml2_intern(&intern, "kept") == kept);
+
+    sysml2_intern_destroy(&intern);
+    sysml2_arena_destroy(&arena);
+}
+
+TEST(intern_rewind_journal) {
+    Sysml2Arena arena;
+    sysml2_arena_init_with_size(&arena, 256);
+
+    Sysml2Intern intern;
+    sysml2_intern_init_with_capacity(&intern, &arena, 16);
+
+    char buf[32];
+    for (int i = 0; i < 500; i++) {
+        snprintf(buf, sizeof(buf), "base_%d", i);
+        ASSERT_NOT_NULL(sysml2_intern(&intern, buf));
+    }
+    sysml2_intern_start_journal(&intern);
+    Sysml2ArenaMark outer = sysml2_arena_mark(&arena);
+
+    ASSERT_NOT_NULL(sysml2_intern(&intern, "outer"));
+    Sysml2ArenaMark inner = sysml2_arena_mark(&arena);
+    for (int i = 0; i < 1000; i++) {
+        snprintf(buf, sizeof(buf), "doc_%d", i);
+        ASSERT_NOT_NULL(sysml2_intern(&intern, buf));
+    }
+    ASSERT(sysml2_intern(&intern, "base_3") == sysml2_intern_lookup(&intern, "base_3"));
+    ASSERT_EQ(sysml2_intern_count(&intern), 1501);
+
+    /* Only the inner strings go; the rest still probe correctly */
+    ASSERT(sysml2_intern_rewind(&intern, inner));
+    sysml2_arena_rewind(&arena, inner);
+    ASSERT_EQ(sysml2_intern_count(&intern), 501);
+    ASSERT_NOT_NULL(sysml2_intern_lookup(&intern, "outer"));
+    ASSERT_NULL(sysml2_intern_lookup(&intern, "doc_10"));
+
+    ASSERT(sysml2_intern_rewind(&intern, outer));
+    sysml2_arena_rewind(&arena, outer);
+    ASSERT_EQ(sysml2_intern_count(&intern), 500);
+    ASSERT_NULL(sysml2_intern_lookup(&intern, "outer"));
+    for (int i = 0; i < 500; i++) {
+        snprintf(buf, sizeof(buf), "base_%d", i);
+        ASSERT_NOT_NULL(sysml2_intern_lookup(&intern, buf));
+    }
+
+    /* New strings still deduplicate after removals */
+    const char *again = sysml2_intern(&intern, "doc_10");
+    ASSERT(sysml2_intern(&intern, "doc_10") == again);
+
+    sysml2_intern_destroy(&intern);
+    sysml2_arena_destroy(&arena);
+}
+
+/* ========== Parser Pool Tests ========== */
+
+TEST(parser_pool_reuse) {
+    sysml2_parser_pool_trim();
+
+    char *a = sysml2_parser_pool_alloc(100);
+    ASSERT_NOT_NULL(a);
+    memset(a, 'x', 100);
+    sysml2_parser_pool_free(a);
+    ASSERT_EQ(sysml2_parser_pool_cached(), 128);
+
+    /* Same size class comes back from the free list */
+    char *b = sysml2_parser_pool_alloc(120);
+    ASSERT(b == a);
+    ASSERT_EQ(sysml2_parser_pool_cached(), 0);
+
+    sysml2_parser_pool_free(b);
+    sysml2_parser_pool_trim();
+    ASSERT_EQ(sysml2_parser_pool_cached(), 0);
+}
+
+TEST(parser_pool_realloc) {
+    sysml2_parser_pool_trim();
+
+    char *p = sysml2_parser_pool_realloc(NULL, 10);
+    ASSERT_NOT_NULL(p);
+    memcpy(p, "abcdefghi", 10);
+
+    /* Growth within the class keeps the block */
+    ASSERT(sysml2_parser_pool_realloc(p, 32) == p);
+
+    char *q = sysml2_parser_pool_realloc(p, 1000);
+    ASSERT_STR_EQ(q, "abcdefghi");
+
+    /* Beyond the largest class */
+    char *big = sysml2_parser_pool_realloc(q, 32u * 1024 * 1024);
+    ASSERT_STR_EQ(big, "abcdefghi");
+    big = sysml2_parser_pool_realloc(big, 40u * 1024 * 1024);
+    ASSERT_STR_EQ(big, "abcdefghi");
+    sysml2_parser_pool_free(big);
+
+    sysml2_parser_pool_free(NULL);
+    sysml2_parser_pool_trim();
+}
+
+/* ========== Memory Budget Tests ========== */
+
+TEST(memory_budget_arena_blocks) {
+    sysml2_memory_reset();
+
+    Sysml2Arena arena;
+    sysml2_arena_init(&arena);
+    ASSERT_EQ(sysml2_memory_used(), 0);
+
+    ASSERT_NOT_NULL(sysml2_arena_alloc(&arena, 100));
+    size_t one_block = sysml2_memory_used();
+    ASSERT(one_block >= SYSML2_ARENA_DEFAULT_BLOCK_SIZE);
+
+    /* Blocks given back by a rewind are released */
+    Sysml2ArenaMark mark = sysml2_arena_mark(&arena);
+    ASSERT_NOT_NULL(sysml2_arena_alloc(&arena, 3 * SYSML2_ARENA_DEFAULT_BLOCK_SIZE));
+    ASSERT(sysml2_memory_used() > one_block);
+    sysml2_arena_rewind(&arena, mark);
+    ASSERT_EQ(sysml2_memory_used(), one_block);
+
+    sysml2_arena_destroy(&arena);
+    ASSERT_EQ(sysml2_memory_used(), 0);
+    ASSERT(sysml2_memory_peak() > 3 * SYSML2_ARENA_DEFAULT_BLOCK_SIZE);
+}
+
+TEST(memory_budget_parser_pool) {
+    sysml2_parser_pool_trim();
+    sysml2_memory_reset();
+
+    char *a = sysml2_parser_pool_alloc(100);
+    size_t charged = sysml2_memory_used();
+    ASSERT(charged >= 128);
+
+    /* Cached blocks are still held */
+    sysml2_parser_pool_free(a);
+    ASSERT_EQ(sysml2_memory_used(), charged);
+    char *b = sysml2_parser_pool_alloc(100);
+    ASSERT_EQ(sysml2_memory_used(), charged);
+    sysml2_parser_pool_free(b);
+
+    /* Large blocks are charged at their size through reallocs */
+    char *big = sysml2_parser_pool_alloc(32u * 1024 * 1024);
+    ASSERT(sysml2_memory_used() >= charged + 32u * 1024 * 1024);
+    big = sysml2_parser_pool_realloc(big, 40u * 1024 * 1024);
+    ASSERT(sysml2_memory_used() >= charged + 40u * 1024 * 1024);
+    big = sysml2_parser_pool_realloc(big, 33u * 1024 * 1024);
+    ASSERT(sysml2_memory_used() < charged + 34u * 1024 * 1024);
+    sysml2_parser_pool_free(big);
+    ASSERT_EQ(sysml2_memory_used(), charged);
+
+    sysml2_parser_pool_trim();
+    ASSERT_EQ(sysml2_memory_used(), 0);
+}
+
+TEST(memory_budget_limit) {
+    Sysml2Arena arena;
+    sysml2_arena_init(&arena);
+    Sysml2DiagContext diag;
+    sysml2_diag_context_init(&diag, &arena);
+
+    sysml2_memory_reset();
+    sysml2_memory_set_limit(1000);
+
+    sysml2_memory_charge(900);
+    ASSERT_FALSE(sysml2_memory_exceeded());
+    ASSERT_FALSE(sysml2_memory_report(&diag, "a.sysml"));
+    ASSERT_NULL(diag.first);
+
+    /* Crossing the limit trips the budget; reported once, naming the
+     * phase and file */
+    sysml2_memory_phase_push("parse");
+    sysml2_memory_charge(200);
+    ASSERT_TRUE(sysml2_memory_exceeded());
+    size_t used = sysml2_memory_used();
+    ASSERT_TRUE(sysml2_memory_report(&diag, "b.sysml"));
+    sysml2_memory_phase_pop();
+
+    /* Releasing does not reset it */
+    sysml2_memory_release(used);
+    ASSERT_TRUE(sysml2_memory_exceeded());
+    ASSERT_TRUE(sysml2_memory_report(&diag, "c.sysml"));
+
+    ASSERT_NOT_NULL(diag.first);
+    ASSERT(diag.first == diag.last);
+    ASSERT_EQ(diag.first->code, SYSML2_DIAG_E4001_MEMORY_LIMIT);
+    ASSERT_EQ(diag.first->severity, SYSML2_SEVERITY_FATAL);
+    ASSERT_NOT_NULL(diag.first->file);
+    ASSERT_STR_EQ(diag.first->file->path, "b.sysml");
+    char expected[128];
+    snprintf(expected, sizeof(expected),
+             "memory limit of 1000 bytes exceeded in parse phase (%zu bytes in use)", used);
+    ASSERT_STR_EQ(diag.first->message, expected);
+    ASSERT_TRUE(diag.has_fatal);
+    ASSERT_EQ(diag.semantic_error_count, 0);
+
+    sysml2_arena_destroy(&arena);
+    sysml2_memory_reset();
+    ASSERT_FALSE(sysml2_memory_exceeded());
+    ASSERT_EQ(sysml2_memory_limit(), 0);
+}
+
+TEST(memory_budget_peak_windows) {
+    sysml2_memory_reset();
+    sysml2_memory_charge(100);
+
+    size_t outer = sysml2_memory_begin_peak();
+    sysml2_memory_charge(50);
+    sysml2_memory_release(50);
+
+    /* A nested window starts from current use */
+    size_t inner_outer = sysml2_memory_begin_peak();
+    sysml2_memory_charge(20);
+    sysml2_memory_release(20);
+    ASSERT_EQ(sysml2_memory_end_peak(inner_outer), 120);
+
+    /* ...and folds back into the enclosing one */
+    ASSERT_EQ(sysml2_memory_end_peak(outer), 150);
+    ASSERT_EQ(sysml2_memory_peak(), 150);
+    sysml2_memory_reset();
+}
+
+TEST(memory_parse_size) {
+    size_t bytes = 0;
+    ASSERT_TRUE(sysml2_memory_parse_size("512", &bytes));
+    ASSERT_EQ(bytes, 512);
+    ASSERT_TRUE(sysml2_memory_parse_size("4K", &bytes));
+    ASSERT_EQ(bytes, 4096);
+    ASSERT_TRUE(sysml2_memory_parse_size("2m", &bytes));
+    ASSERT_EQ(bytes, 2u * 1024 * 1024);
+    ASSERT_TRUE(sysml2_memory_parse_size("1G", &bytes));
+    ASSERT_EQ(bytes, 1024u * 1024 * 1024);
+
+    ASSERT_FALSE(sysml2_memory_parse_size("", &bytes));
+    ASSERT_FALSE(sysml2_memory_parse_size("-1", &bytes));
+    ASSERT_FALSE(sysml2_memory_parse_size("K", &bytes));
+    ASSERT_FALSE(sysml2_memory_parse_size("4x", &bytes));
+    ASSERT_FALSE(sysml2_memory_parse_size("4KB", &bytes));
+    ASSERT_FALSE(sysml2_memory_parse_size("99999999999999999999", &bytes));
+}
+
+/* ========== Source Buffer Tests ========== */
+
+/* Pipe whose read end yields length bytes of a repeating pattern, then EOF */
+static int pattern_pipe(size_t length) {
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    char chunk[256];
+    for (size_t i = 0; i < sizeof(chunk); i++) chunk[i] = (char)('a' + i % 26);
+    for (size_t done = 0; done < length; ) {
+        size_t n = length - done < sizeof(chunk) ? length - done : sizeof(chunk);
+        ASSERT_EQ(write(fds[1], chunk, n), (ssize_t)n);
+        done += n;
+    }
+    close(fds[1]);
+    return fds[0];
+}
+
+TEST(source_read_fd_pipe) {
+    sysml2_memory_reset();
+    int fd = pattern_pipe(10000);
+
+    Sysml2SourceBuffer source;
+    ASSERT_TRUE(sysml2_source_read_fd(fd, 0, &source));
+    close(fd);
+    ASSERT_EQ(source.length, 10000);
+    ASSERT_EQ(source.mapped_size, 0);
+    ASSERT_EQ(source.data[0], 'a');
+    ASSERT_EQ(source.data[9999], (char)('a' + 9999 % 256 % 26));
+    ASSERT_EQ(source.data[10000], '\0');
+    ASSERT_EQ(sysml2_memory_used(), 10000);
+
+    sysml2_source_release(&source);
+    ASSERT_EQ(sysml2_memory_used(), 0);
+}
+
+TEST(source_read_fd_spools) {
+    sysml2_memory_reset();
+    int fd = pattern_pipe(10000);
+
+    /* Past the threshold the input moves to a mapped temporary file */
+    Sysml2SourceBuffer source;
+    ASSERT_TRUE(sysml2_source_read_fd(fd, 4096, &source));
+    close(fd);
+    ASSERT_EQ(source.length, 10000);
+    ASSERT_EQ(source.mapped_size, 10001);
+    for (size_t i = 0; i < source.length; i++) {
+        ASSERT_EQ(source.data[i], (char)('a' + i % 256 % 26));
+    }
+    ASSERT_EQ(source.data[10000], '\0');
+    ASSERT_EQ(sysml2_memory_used(), 10000);
+
+    sysml2_source_release(&source);
+    ASSERT_EQ(sysml2_memory_used(), 0);
+}
+
+TEST(source_read_fd_spool_boundary) {
+    sysml2_memory_reset();
+
+    /* The buffer stops growing at the threshold: one byte short stays on
+     * the heap, exactly the threshold spools */
+    int fd = pattern_pipe(4999);
+    Sysml2SourceBuffer source;
+    ASSERT_TRUE(sysml2_source_read_fd(fd, 5000, &source));
+    close(fd);
+    ASSERT_EQ(source.length, 4999);
+    ASSERT_EQ(source.mapped_size, 0);
+    sysml2_source_release(&source);
+
+    fd = pattern_pipe(5000);
+    ASSERT_TRUE(sysml2_source_read_fd(fd, 5000, &source));
+    close(fd);
+    ASSERT_EQ(source.length, 5000);
+    ASSERT_EQ(source.mapped_size, 5001);
+    ASSERT_EQ(source.data[4999], (char)('a' + 4999 % 256 % 26));
+    ASSERT_EQ(source.data[5000], '\0');
+    sysml2_source_release(&source);
+
+    /* Far past the threshold, the rest streams through the copy buffer */
+    fd = pattern_pipe(60000);
+    ASSERT_TRUE(sysml2_source_read_fd(fd, 5000, &source));
+    close(fd);
+    ASSERT_EQ(source.length, 60000);
+    for (size_t i = 0; i < source.length; i++) {
+        ASSERT_EQ(source.data[i], (char)('a' + i % 256 % 26));
+    }
+    sysml2_source_release(&source);
+    ASSERT_EQ(sysml2_memory_used(), 0);
+}
+
+TEST(source_read_fd_regular_file) {
+    FILE *file = tmpfile();
+    ASSERT_NOT_NULL(file);
+    fputs("package P;", file);
+    fflush(file);
+    int fd = fileno(file);
+
+    /* Read from the start, a regular file is mapped */
+    ASSERT_EQ(lseek(fd, 0, SEEK_SET), 0);
+    Sysml2SourceBuffer source;
+    ASSERT_TRUE(sysml2_source_read_fd(fd, 0, &source));
+    ASSERT_EQ(source.mapped_size, 10);
+    ASSERT_STR_EQ(source.data, "package P;");
+    sysml2_source_release(&source);
+
+    /* Part-way through, only the rest is read */
+    ASSERT_EQ(lseek(fd, 8, SEEK_SET), 8);
+    ASSERT_TRUE(sysml2_source_read_fd(fd, 0, &source));
+    ASSERT_EQ(source.mapped_size, 0);
+    ASSERT_STR_EQ(source.data, "P;");
+    sysml2_source_release(&source);
+    fclose(file);
+    sysml2_memory_reset();
+}
+
 /* ========== Hash Function Tests ========== */
 
 TEST(hash_string_basic) {
@@ -434,6 +992,12 @@ int main(void) {
     RUN_TEST(arena_large_allocation);
     RUN_TEST(arena_many_allocations);
 
+    /* Arena mark/rewind tests */
+    RUN_TEST(arena_rewind_same_block);
+    RUN_TEST(arena_rewind_frees_blocks);
+    RUN_TEST(arena_rewind_empty);
+    RUN_TEST(arena_rewind_nested);
+
     /* Intern tests */
     RUN_TEST(intern_init);
     RUN_TEST(intern_basic);
@@ -444,6 +1008,28 @@ int main(void) {
     RUN_TEST(intern_lookup);
     RUN_TEST(intern_many_strings);
     RUN_TEST(intern_hash_collision);
+    RUN_TEST(intern_growth);
+    RUN_TEST(intern_reserve);
+    RUN_TEST(intern_embedded_lengths);
+    RUN_TEST(intern_rewind);
+    RUN_TEST(intern_rewind_journal);
+
+    /* Parser pool tests */
+    RUN_TEST(parser_pool_reuse);
+    RUN_TEST(parser_pool_realloc);
+
+    /* Memory budget tests */
+    RUN_TEST(memory_budget_arena_blocks);
+    RUN_TEST(memory_budget_parser_pool);
+    RUN_TEST(memory_budget_limit);
+    RUN_TEST(memory_budget_peak_windows);
+    RUN_TEST(memory_parse_size);
+
+    /* Source buffer tests */
+    RUN_TEST(source_read_fd_pipe);
+    RUN_TEST(source_read_fd_spools);
+    RUN_TEST(source_read_fd_spool_boundary);
+    RUN_TEST(source_read_fd_regular_file);
 
     /* Hash function tests */
     RUN_TEST(hash_string_basic);
@@ -0,0 +1,588 @@
+/*
+ * SysML v2 Parser - Persistent Model Cache Tests
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "sysml2/common.h"
+#include "sysml2/arena.h"
+#include "sysml2/intern.h"
+#include "sysml2/ast.h"
+#include "sysml2/model_cache.h"
+#include "sysml2/diagnostic.h"
+#include "sysml2/utils.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define TEST(name) static void test_##name(void)
+#define RUN_TEST(name) do { \
+    printf("  Running %s...", #name); \
+    fflush(stdout); \
+    tests_run++; \
+    test_##name(); \
+    tests_passed++; \
+    printf(" PASSED\n"); \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("\n    FAILED: %s at %s:%d\n", #cond, __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a, b) ASSERT((a) == (b))
+#define ASSERT_TRUE(a) ASSERT((a) == true)
+#define ASSERT_FALSE(a) ASSERT((a) == false)
+#define ASSERT_STR_EQ(a, b) ASSERT(strcmp((a), (b)) == 0)
+#define ASSERT_NULL(a) ASSERT((a) == NULL)
+#define ASSERT_NOT_NULL(a) ASSERT((a) != NULL)
+
+#define FIXTURE_SETUP() \
+    Sysml2Arena arena; \
+    sysml2_arena_init(&arena); \
+    Sysml2Intern intern; \
+    sysml2_intern_init(&intern, &arena); \
+    char dir[] = "/tmp/sysml2_cache_test_XXXXXX"; \
+    ASSERT_NOT_NULL(mkdtemp(dir)); \
+    char *source = sysml2_path_join(dir, "lib.sysml"); \
+    char *cache_dir = sysml2_path_join(dir, "cache")
+
+#define FIXTURE_TEARDOWN() \
+    sysml2_model_cache_clear(cache_dir, NULL); \
+    rmdir(cache_dir); \
+    unlink(source); \
+    rmdir(dir); \
+    free(cache_dir); \
+    free(source); \
+    sysml2_intern_destroy(&intern); \
+    sysml2_arena_destroy(&arena)
+
+static const char *SOURCE_TEXT = "package Lib { part def Engine; part engine : Engine; }\n";
+
+static void write_text(const char *path, const char *text) {
+    FILE *f = fopen(path, "w");
+    ASSERT_NOT_NULL(f);
+    fputs(text, f);
+    fclose(f);
+}
+
+/* Build a small model resembling what the AST builder produces */
+static SysmlSemanticModel *build_model(Sysml2Arena *arena, Sysml2Intern *intern) {
+    SysmlSemanticModel *model = SYSML2_ARENA_NEW(arena, SysmlSemanticModel);
+    model->source_name = sysml2_intern(intern, "lib.sysml");
+    model->element_count = 3;
+    model->elements = SYSML2_ARENA_NEW_ARRAY(arena, SysmlNode *, 3);
+
+    SysmlNode *pkg = SYSML2_ARENA_NEW(arena, SysmlNode);
+    pkg->id = sysml2_intern(intern, "Lib");
+    pkg->name = pkg->id;
+    pkg->kind = SYSML_KIND_PACKAGE;
+    SysmlNodeCold *pkg_cold = sysml2_node_cold_mut(arena, pkg);
+    pkg_cold->documentation = sysml2_intern(intern, "Library package");
+    pkg_cold->leading_trivia = SYSML2_ARENA_NEW(arena, SysmlTrivia);
+    pkg_cold->leading_trivia->kind = SYSML_TRIVIA_LINE_COMMENT;
+    pkg_cold->leading_trivia->text = sysml2_intern(intern, " header");
+    pkg_cold->leading_trivia->next = SYSML2_ARENA_NEW(arena, SysmlTrivia);
+    pkg_cold->leading_trivia->next->kind = SYSML_TRIVIA_BLANK_LINE;
+    pkg_cold->leading_trivia->next->count = 2;
+    model->elements[0] = pkg;
+
+    SysmlNode *def = SYSML2_ARENA_NEW(arena, SysmlNode);
+    def->id = sysml2_intern(intern, "Lib::Engine");
+    def->name = sysml2_intern(intern, "Engine");
+    def->kind = SYSML_KIND_PART_DEF;
+    def->parent_id = pkg->id;
+    def->is_abstract = true;
+    def->loc = (Sysml2SourceLoc){1, 15, 14};
+    SysmlNodeCold *def_cold = sysml2_node_cold_mut(arena, def);
+    def_cold->body_stmt_count = 1;
+    def_cold->body_stmts = SYSML2_ARENA_NEW_ARRAY(arena, SysmlStatement *, 1);
+    SysmlStatement *stmt = SYSML2_ARENA_NEW(arena, SysmlStatement);
+    stmt->kind = SYSML_STMT_IF;
+    stmt->raw_text = sysml2_intern(intern, "if x { }");
+    stmt->nested_count = 1;
+    stmt->nested = SYSML2_ARENA_NEW_ARRAY(arena, SysmlStatement *, 1);
+    stmt->nested[0] = SYSML2_ARENA_NEW(arena, SysmlStatement);
+    stmt->nested[0]->kind = SYSML_STMT_TERMINATE;
+    def_cold->body_stmts[0] = stmt;
+    model->elements[1] = def;
+
+    SysmlNode *usage = SYSML2_ARENA_NEW(arena, SysmlNode);
+    usage->id = sysml2_intern(intern, "Lib::engine");
+    usage->name = sysml2_intern(intern, "engine");
+    usage->kind = SYSML_KIND_PART_USAGE;
+    usage->parent_id = pkg->id;
+    usage->typed_by_count = 1;
+    usage->typed_by = SYSML2_ARENA_NEW_ARRAY(arena, const char *, 1);
+    usage->typed_by[0] = sysml2_intern(intern, "Engine");
+    usage->typed_by_conjugated = SYSML2_ARENA_NEW_ARRAY(arena, bool, 1);
+    usage->typed_by_conjugated[0] = true;
+    usage->multiplicity_lower = sysml2_intern(intern, "1");
+    usage->multiplicity_upper = sysml2_intern(intern, "*");
+    SysmlNodeCold *usage_cold = sysml2_node_cold_mut(arena, usage);
+    usage_cold->metadata_count = 1;
+    usage_cold->metadata = SYSML2_ARENA_NEW_ARRAY(arena, SysmlMetadataUsage *, 1);
+    usage_cold->metadata[0] = SYSML2_ARENA_NEW(arena, SysmlMetadataUsage);
+    usage_cold->metadata[0]->type_ref = sysml2_intern(intern, "SourceLink");
+    usage_cold->metadata[0]->feature_count = 1;
+    usage_cold->metadata[0]->features = SYSML2_ARENA_NEW_ARRAY(arena, SysmlMetadataFeature *, 1);
+    usage_cold->metadata[0]->features[0] = SYSML2_ARENA_NEW(arena, SysmlMetadataFeature);
+    usage_cold->metadata[0]->features[0]->name = sysml2_intern(intern, "path");
+    usage_cold->metadata[0]->features[0]->value = sysml2_intern(intern, "\"a.c\"");
+    model->elements[2] = usage;
+
+    model->import_count = 1;
+    model->imports = SYSML2_ARENA_NEW_ARRAY(arena, SysmlImport *, 1);
+    model->imports[0] = SYSML2_ARENA_NEW(arena, SysmlImport);
+    model->imports[0]->id = sysml2_intern(intern, "Lib::import_0");
+    model->imports[0]->kind = SYSML_KIND_IMPORT_ALL;
+    model->imports[0]->target = sysml2_intern(intern, "ScalarValues");
+    model->imports[0]->owner_scope = pkg->id;
+    model->imports[0]->is_private = true;
+
+    model->alias_count = 1;
+    model->aliases = SYSML2_ARENA_NEW_ARRAY(arena, SysmlAlias *, 1);
+    model->aliases[0] = SYSML2_ARENA_NEW(arena, SysmlAlias);
+    model->aliases[0]->name = sysml2_intern(intern, "E");
+    model->aliases[0]->target = def->id;
+    model->aliases[0]->owner_scope = pkg->id;
+
+    model->relationship_count = 1;
+    model->relationships = SYSML2_ARENA_NEW_ARRAY(arena, SysmlRelationship *, 1);
+    model->relationships[0] = SYSML2_ARENA_NEW(arena, SysmlRelationship);
+    model->relationships[0]->kind = SYSML_KIND_REL_CONNECTION;
+    model->relationships[0]->source = usage->id;
+    model->relationships[0]->target = def->id;
+    return model;
+}
+
+/* ========== Round-trip Tests ========== */
+
+TEST(cache_store_and_load) {
+    FIXTURE_SETUP();
+    write_text(source, SOURCE_TEXT);
+
+    Sysml2ModelCache *cache = sysml2_model_cache_create(cache_dir, &arena, &intern);
+    ASSERT_NOT_NULL(cache);
+    ASSERT_TRUE(sysml2_is_directory(cache_dir));
+
+    ASSERT_NULL(sysml2_model_cache_load(cache, source));
+    ASSERT_EQ(cache->misses, 1);
+
+    SysmlSemanticModel *model = build_model(&arena, &intern);
+    ASSERT_EQ(sysml2_model_cache_store(cache, source, SOURCE_TEXT, strlen(SOURCE_TEXT), model), SYSML2_OK);
+    ASSERT_EQ(cache->stores, 1);
+
+    SysmlSemanticModel *loaded = sysml2_model_cache_load(cache, source);
+    ASSERT_NOT_NULL(loaded);
+    ASSERT_EQ(cache->hits, 1);
+    ASSERT_NULL(loaded->source_file);
+    ASSERT_STR_EQ(loaded->source_name, source);
+    ASSERT_EQ(loaded->element_count, 3);
+    ASSERT_EQ(loaded->import_count, 1);
+    ASSERT_EQ(loaded->alias_count, 1);
+    ASSERT_EQ(loaded->relationship_count, 1);
+
+    /* Identifiers are re-interned, so pointer identity holds */
+    ASSERT_EQ(loaded->elements[0]->id, model->elements[0]->id);
+    ASSERT_EQ(loaded->elements[1]->parent_id, model->elements[0]->id);
+    ASSERT_EQ(loaded->imports[0]->owner_scope, model->elements[0]->id);
+
+    /* Paths are relinked within the loaded model */
+    ASSERT_TRUE(loaded->elements[1]->has_path);
+    ASSERT(loaded->elements[1]->parent == loaded->elements[0]);
+    ASSERT_EQ(loaded->elements[1]->depth, 1);
+    ASSERT_STR_EQ(sysml2_node_local_id(loaded->elements[2]), "engine");
+
+    const SysmlNode *pkg = loaded->elements[0];
+    ASSERT_STR_EQ(sysml2_node_cold(pkg)->documentation, "Library package");
+    ASSERT_NOT_NULL(sysml2_node_cold(pkg)->leading_trivia);
+    ASSERT_EQ(sysml2_node_cold(pkg)->leading_trivia->kind, SYSML_TRIVIA_LINE_COMMENT);
+    ASSERT_NOT_NULL(sysml2_node_cold(pkg)->leading_trivia->next);
+    ASSERT_EQ(sysml2_node_cold(pkg)->leading_trivia->next->count, 2);
+    ASSERT_NULL(sysml2_node_cold(pkg)->leading_trivia->next->next);
+    ASSERT_NULL(pkg->typed_by);
+
+    const SysmlNode *def = loaded->elements[1];
+    ASSERT_TRUE(def->is_abstract);
+    ASSERT_FALSE(def->is_ref);
+    ASSERT_EQ(def->loc.column, 15);
+    ASSERT_EQ(sysml2_node_cold(def)->body_stmt_count, 1);
+    ASSERT_EQ(sysml2_node_cold(def)->body_stmts[0]->kind, SYSML_STMT_IF);
+    ASSERT_EQ(sysml2_node_cold(def)->body_stmts[0]->nested_count, 1);
+    ASSERT_EQ(sysml2_node_cold(def)->body_stmts[0]->nested[0]->kind, SYSML_STMT_TERMINATE);
+
+    const SysmlNode *usage = loaded->elements[2];
+    ASSERT_EQ(usage->typed_by_count, 1);
+    ASSERT_STR_EQ(usage->typed_by[0], "Engine");
+    ASSERT_NOT_NULL(usage->typed_by_conjugated);
+    ASSERT_TRUE(usage->typed_by_conjugated[0]);
+    ASSERT_STR_EQ(usage->multiplicity_upper, "*");
+    ASSERT_EQ(sysml2_node_cold(usage)->metadata_count, 1);
+    ASSERT_STR_EQ(sysml2_node_cold(usage)->metadata[0]->features[0]->value, "\"a.c\"");
+
+    ASSERT_EQ(loaded->imports[0]->kind, SYSML_KIND_IMPORT_ALL);
+    ASSERT_TRUE(loaded->imports[0]->is_private);
+    ASSERT_FALSE(loaded->imports[0]->is_public_explicit);
+    ASSERT_EQ(loaded->aliases[0]->target, model->elements[1]->id);
+    ASSERT_EQ(loaded->relationships[0]->kind, SYSML_KIND_REL_CONNECTION);
+
+    sysml2_model_cache_destroy(cache);
+    FIXTURE_TEARDOWN();
+}
+
+TEST(cache_empty_model) {
+    FIXTURE_SETUP();
+    write_text(source, "");
+
+    Sysml2ModelCache *cache = sysml2_model_cache_create(cache_dir, &arena, &intern);
+    SysmlSemanticModel *model = SYSML2_ARENA_NEW(&arena, SysmlSemanticModel);
+    ASSERT_EQ(sysml2_model_cache_store(cache, source, "", 0, model), SYSML2_OK);
+
+    SysmlSemanticModel *loaded = sysml2_model_cache_load(cache, source);
+    ASSERT_NOT_NULL(loaded);
+    ASSERT_EQ(loaded->element_count, 0);
+    ASSERT_NULL(loaded->elements);
+
+    sysml2_model_cache_destroy(cache);
+    FIXTURE_TEARDOWN();
+}
+
+/* ========== Invalidation Tests ========== */
+
+TEST(cache_miss_on_changed_content) {
+    FIXTURE_SETUP();
+    write_text(source, SOURCE_TEXT);
+
+    Sysml2ModelCache *cache = sysml2_model_cache_create(cache_dir, &arena, &intern);
+    SysmlSemanticModel *model = build_model(&arena, &intern);
+    ASSERT_EQ(sysml2_model_cache_store(cache, source, SOURCE_TEXT, strlen(SOURCE_TEXT), model), SYSML2_OK);
+
+    /* Same size, different bytes: caught by the content hash */
+    char *changed = strdup(SOURCE_TEXT);
+    changed[8] = 'X';
+    write_text(source, changed);
+    free(changed);
+    ASSERT_NULL(sysml2_model_cache_load(cache, source));
+
+    /* Different size */
+    write_text(source, "package Other;\n");
+    ASSERT_NULL(sysml2_model_cache_load(cache, source));
+
+    /* Restoring the original content makes the entry valid again */
+    write_text(source, SOURCE_TEXT);
+    ASSERT_NOT_NULL(sysml2_model_cache_load(cache, source));
+
+    sysml2_model_cache_destroy(cache);
+    FIXTURE_TEARDOWN();
+}
+
+TEST(cache_miss_on_other_program_version) {
+    FIXTURE_SETUP();
+    write_text(source, SOURCE_TEXT);
+
+    Sysml2ModelCache *cache = sysml2_model_cache_create(cache_dir, &arena, &intern);
+    SysmlSemanticModel *model = build_model(&arena, &intern);
+    ASSERT_EQ(sysml2_model_cache_store(cache, source, SOURCE_TEXT, strlen(SOURCE_TEXT), model), SYSML2_OK);
+    ASSERT_NOT_NULL(sysml2_model_cache_load(cache, source));
+
+    /* Rewrite the program version hash, which follows the magic, the
+     * format version and the byte order mark */
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx" SYSML2_MODEL_CACHE_EXT,
+             (unsigned long long)sysml2_model_cache_hash(source, strlen(source)));
+    char *entry = sysml2_path_join(cache_dir, name);
+    FILE *f = fopen(entry, "r+b");
+    ASSERT_NOT_NULL(f);
+    uint64_t other = sysml2_model_cache_hash("0.0.0", 5);
+    ASSERT_EQ(fseek(f, 16, SEEK_SET), 0);
+    ASSERT_EQ(fwrite(&other, sizeof(other), 1, f), 1);
+    fclose(f);
+    free(entry);
+    ASSERT_NULL(sysml2_model_cache_load(cache, source));
+
+    sysml2_model_cache_destroy(cache);
+    FIXTURE_TEARDOWN();
+}
+
+TEST(cache_miss_on_deleted_source) {
+    FIXTURE_SETUP();
+    write_text(source, SOURCE_TEXT);
+
+    Sysml2ModelCache *cache = sysml2_model_cache_create(cache_dir, &arena, &intern);
+    SysmlSemanticModel *model = build_model(&arena, &intern);
+    ASSERT_EQ(sysml2_model_cache_store(cache, source, SOURCE_TEXT, strlen(SOURCE_TEXT), model), SYSML2_OK);
+
+    unlink(source);
+    ASSERT_NULL(sysml2_model_cache_load(cache, source));
+
+    sysml2_model_cache_destroy(cache);
+    FIXTURE_TEARDOWN();
+}
+
+TEST(cache_invalidate_and_clear) {
+    FIXTURE_SETUP();
+    write_text(source, SOURCE_TEXT);
+
+    Sysml2ModelCache *cache = sysml2_model_cache_create(cache_dir, &arena, &intern);
+    SysmlSemanticModel *model = build_model(&arena, &intern);
+    ASSERT_EQ(sysml2_model_cache_store(cache, source, SOURCE_TEXT, strlen(SOURCE_TEXT), model), SYSML2_OK);
+
+    ASSERT_EQ(sysml2_model_cache_invalidate(cache, source), SYSML2_OK);
+    ASSERT_NULL(sysml2_model_cache_load(cache, source));
+    /* Invalidating a missing entry is not an error */
+    ASSERT_EQ(sysml2_model_cache_invalidate(cache, source), SYSML2_OK);
+
+    ASSERT_EQ(sysml2_model_cache_store(cache, source, SOURCE_TEXT, strlen(SOURCE_TEXT), model), SYSML2_OK);
+    size_t removed = 0;
+    ASSERT_EQ(sysml2_model_cache_clear(cache_dir, &removed), SYSML2_OK);
+    ASSERT_EQ(removed, 1);
+    ASSERT_NULL(sysml2_model_cache_load(cache, source));
+
+    /* Clearing a directory that does not exist succeeds */
+    ASSERT_EQ(sysml2_model_cache_clear("/tmp/sysml2_cache_test_missing_dir", &removed), SYSML2_OK);
+    ASSERT_EQ(removed, 0);
+
+    sysml2_model_cache_destroy(cache);
+    FIXTURE_TEARDOWN();
+}
+
+TEST(cache_rejects_corrupt_entry) {
+    FIXTURE_SETUP();
+    write_text(source, SOURCE_TEXT);
+
+    Sysml2ModelCache *cache = sysml2_model_cache_create(cache_dir, &arena, &intern);
+    SysmlSemanticModel *model = build_model(&arena, &intern);
+    ASSERT_EQ(sysml2_model_cache_store(cache, source, SOURCE_TEXT, strlen(SOURCE_TEXT), model), SYSML2_OK);
+
+    /* Truncate the single entry in the cache directory */
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx" SYSML2_MODEL_CACHE_EXT,
+             (unsigned long long)sysml2_model_cache_hash(source, strlen(source)));
+    char *entry = sysml2_path_join(cache_dir, name);
+    struct stat st;
+    ASSERT_EQ(stat(entry, &st), 0);
+    ASSERT_EQ(truncate(entry, st.st_size - 8), 0);
+    ASSERT_NULL(sysml2_model_cache_load(cache, source));
+
+    /* Garbage header */
+    write_text(entry, "not a cache entry");
+    ASSERT_NULL(sysml2_model_cache_load(cache, source));
+    free(entry);
+
+    sysml2_model_cache_destroy(cache);
+    FIXTURE_TEARDOWN();
+}
+
+TEST(cache_null_handling) {
+    Sysml2Arena arena;
+    sysml2_arena_init(&arena);
+    Sysml2Intern intern;
+    sysml2_intern_init(&intern, &arena);
+
+    ASSERT_NULL(sysml2_model_cache_create(NULL, &arena, &intern));
+    ASSERT_NULL(sysml2_model_cache_load(NULL, "/tmp/x.sysml"));
+    ASSERT_EQ(sysml2_model_cache_store(NULL, "/tmp/x.sysml", "", 0, NULL), SYSML2_ERROR_SEMANTIC);
+    sysml2_model_cache_destroy(NULL);
+
+    sysml2_intern_destroy(&intern);
+    sysml2_arena_destroy(&arena);
+}
+
+/* ========== Package Index Tests ========== */
+
+/* Move a path's mtime out of the racy window */
+static void backdate(const char *path, long seconds_ago) {
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    struct timeval times[2] = {
+        { now.tv_sec - seconds_ago, 0 },
+        { now.tv_sec - seconds_ago, 0 },
+    };
+    ASSERT_EQ(utimes(path, times), 0);
+}
+
+TEST(package_index_store_and_load) {
+    FIXTURE_SETUP();
+    Sysml2ModelCache *cache = sysml2_model_cache_create(cache_dir, &arena, &intern);
+    write_text(source, SOURCE_TEXT);
+    backdate(source, 3600);
+    backdate(dir, 3600);
+
+    Sysml2PackageIndex index;
+    sysml2_package_index_init(&index);
+    ASSERT_TRUE(sysml2_package_index_add(&index, dir, NULL, 0, true));
+    ASSERT_TRUE(sysml2_package_index_add(&index, source, "LibXYZ", 3, false));
+    ASSERT_EQ(sysml2_model_cache_store_package_index(cache, dir, &index), SYSML2_OK);
+    sysml2_package_index_free(&index);
+
+    Sysml2PackageIndex loaded;
+    ASSERT_TRUE(sysml2_model_cache_load_package_index(cache, dir, &loaded));
+    ASSERT_EQ(loaded.count, 2);
+    ASSERT_TRUE(loaded.entries[0].is_directory);
+    ASSERT_NULL(loaded.entries[0].package);
+    ASSERT_STR_EQ(loaded.entries[1].path, source);
+    ASSERT_STR_EQ(loaded.entries[1].package, "Lib");
+    ASSERT_EQ(loaded.entries[1].size, strlen(SOURCE_TEXT));
+    sysml2_package_index_free(&loaded);
+
+    /* Another root has no index */
+    ASSERT_FALSE(sysml2_model_cache_load_package_index(cache, cache_dir, &loaded));
+
+    /* Touching a recorded file makes the index stale */
+    backdate(source, 1800);
+    ASSERT_FALSE(sysml2_model_cache_load_package_index(cache, dir, &loaded));
+    ASSERT_EQ(loaded.count, 0);
+
+    sysml2_model_cache_destroy(cache);
+    FIXTURE_TEARDOWN();
+}
+
+TEST(package_index_untrusted_mtime) {
+    FIXTURE_SETUP();
+    Sysml2ModelCache *cache = sysml2_model_cache_create(cache_dir, &arena, &intern);
+    write_text(source, SOURCE_TEXT);
+
+    /* Just written: the index must not be trusted on the next run */
+    Sysml2PackageIndex index;
+    sysml2_package_index_init(&index);
+    ASSERT_TRUE(sysml2_package_index_add(&index, source, "Lib", 3, false));
+    ASSERT_FALSE(sysml2_package_index_add(&index, "/tmp/sysml2_cache_test_missing.sysml", NULL, 0, false));
+    ASSERT_EQ(sysml2_model_cache_store_package_index(cache, dir, &index), SYSML2_OK);
+    sysml2_package_index_free(&index);
+
+    Sysml2PackageIndex loaded;
+    ASSERT_FALSE(sysml2_model_cache_load_package_index(cache, dir, &loaded));
+
+    /* Index entries are removed by clear */
+    size_t removed = 0;
+    ASSERT_EQ(sysml2_model_cache_clear(cache_dir, &removed), SYSML2_OK);
+    ASSERT_EQ(removed, 1);
+
+    sysml2_model_cache_destroy(cache);
+    FIXTURE_TEARDOWN();
+}
+
+static const Sysml2SourceFile *lookup_other(void *data, const char *path) {
+    const Sysml2SourceFile *other = data;
+    return strcmp(path, other->path) == 0 ? other : NULL;
+}
+
+TEST(results_store_and_load) {
+    FIXTURE_SETUP();
+    Sysml2ModelCache *cache = sysml2_model_cache_create(cache_dir, &arena, &intern);
+    Sysml2SourceFile own = { .path = "lib.sysml" };
+    Sysml2SourceFile other = { .path = "other.sysml" };
+    Sysml2ResultDependency deps[] = {
+        { "/work/lib.sysml", 10, 0x1234 },
+        { "/work/other.sysml", 20, 0x5678 },
+    };
+
+    Sysml2DiagContext diag;
+    sysml2_diag_context_init(&diag, &arena);
+    Sysml2SourceRange range = {{3, 5, 40}, {3, 9, 44}};
+    Sysml2Diagnostic *d = sysml2_diag_create(&diag, SYSML2_DIAG_E3004_DUPLICATE_NAME,
+                                             SYSML2_SEVERITY_ERROR, &own, range, "duplicate 'x'");
+    sysml2_diag_add_help(d, &diag, "rename one");
+    sysml2_diag_add_fixit(d, &diag, range, "y");
+    sysml2_diag_add_note(d, &diag, &other, range, "previous definition");
+    const Sysml2Diagnostic *stored[] = { d };
+    ASSERT_EQ(sysml2_model_cache_store_results(cache, "/work/lib.sysml", 42, deps, 2,
+                                               stored, 1, &own), SYSML2_OK);
+
+    Sysml2DiagContext loaded;
+    sysml2_diag_context_init(&loaded, &arena);
+    ASSERT_TRUE(sysml2_model_cache_load_results(cache, "/work/lib.sysml", 42, deps, 2,
+                                                &loaded, &own, lookup_other, &other));
+    ASSERT_EQ(loaded.error_count, 1);
+    ASSERT_EQ(loaded.semantic_error_count, 1);
+    const Sysml2Diagnostic *r = loaded.first;
+    ASSERT_NOT_NULL(r);
+    ASSERT_NULL(r->next);
+    ASSERT_EQ(r->code, SYSML2_DIAG_E3004_DUPLICATE_NAME);
+    ASSERT_TRUE(r->file == &own);
+    ASSERT_EQ(r->range.end.offset, 44);
+    ASSERT_STR_EQ(r->message, "duplicate 'x'");
+    ASSERT_STR_EQ(r->help, "rename one");
+    ASSERT_EQ(r->fixit_count, 1);
+    ASSERT_STR_EQ(r->fixits[0].replacement, "y");
+    ASSERT_NOT_NULL(r->notes);
+    ASSERT_TRUE(r->notes->file == &other);
+    ASSERT_STR_EQ(r->notes->message, "previous definition");
+
+    sysml2_model_cache_destroy(cache);
+    FIXTURE_TEARDOWN();
+}
+
+TEST(results_miss_on_changed_inputs) {
+    FIXTURE_SETUP();
+    Sysml2ModelCache *cache = sysml2_model_cache_create(cache_dir, &arena, &intern);
+    Sysml2SourceFile own = { .path = "lib.sysml" };
+    Sysml2ResultDependency deps[] = {
+        { "/work/lib.sysml", 10, 0x1234 },
+        { "/work/other.sysml", 20, 0x5678 },
+    };
+    ASSERT_EQ(sysml2_model_cache_store_results(cache, "/work/lib.sysml", 42, deps, 2,
+                                               NULL, 0, &own), SYSML2_OK);
+
+    Sysml2DiagContext diag;
+    sysml2_diag_context_init(&diag, &arena);
+    ASSERT_TRUE(sysml2_model_cache_load_results(cache, "/work/lib.sysml", 42, deps, 2,
+                                                &diag, &own, NULL, NULL));
+    ASSERT_NULL(diag.first);
+
+    /* Other configuration, a dependency dropped or changed */
+    ASSERT_FALSE(sysml2_model_cache_load_results(cache, "/work/lib.sysml", 43, deps, 2,
+                                                 &diag, &own, NULL, NULL));
+    ASSERT_FALSE(sysml2_model_cache_load_results(cache, "/work/lib.sysml", 42, deps, 1,
+                                                 &diag, &own, NULL, NULL));
+    deps[1].content_hash++;
+    ASSERT_FALSE(sysml2_model_cache_load_results(cache, "/work/lib.sysml", 42, deps, 2,
+                                                 &diag, &own, NULL, NULL));
+    ASSERT_FALSE(sysml2_model_cache_load_results(cache, "/work/other.sysml", 42, deps, 2,
+                                                 &diag, &own, NULL, NULL));
+
+    /* Result entries are removed by clear */
+    size_t removed = 0;
+    ASSERT_EQ(sysml2_model_cache_clear(cache_dir, &removed), SYSML2_OK);
+    ASSERT_EQ(removed, 1);
+
+    sysml2_model_cache_destroy(cache);
+    FIXTURE_TEARDOWN();
+}
+
+int main(void) {
+    printf("Running model cache tests...\n");
+
+    /* Round-trip tests */
+    RUN_TEST(cache_store_and_load);
+    RUN_TEST(cache_empty_model);
+
+    /* Invalidation tests */
+    RUN_TEST(cache_miss_on_changed_content);
+    RUN_TEST(cache_miss_on_other_program_version);
+    RUN_TEST(cache_miss_on_deleted_source);
+    RUN_TEST(cache_invalidate_and_clear);
+    RUN_TEST(cache_rejects_corrupt_entry);
+    RUN_TEST(cache_null_handling);
+
+    /* Package index tests */
+    RUN_TEST(package_index_store_and_load);
+    RUN_TEST(package_index_untrusted_mtime);
+
+    /* Validation result tests */
+    RUN_TEST(results_store_and_load);
+    RUN_TEST(results_miss_on_changed_inputs);
+
+    printf("\n%d/%d tests passed.\n", tests_passed, tests_run);
+    return tests_passed == tests_run ? 0 : 1;
+}
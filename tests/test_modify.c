@@ -79,6 +79,17 @@ static SysmlSemanticModel *create_test_model(
 
     model->source_name = sysml2_intern(intern, "test.sysml");
 
+    /* Model IDs are compared by pointer, so intern the literals */
+    for (size_t i = 0; i < node_count; i++) {
+        nodes[i].id = sysml2_intern(intern, nodes[i].id);
+        nodes[i].parent_id = sysml2_intern(intern, nodes[i].parent_id);
+    }
+    for (size_t i = 0; i < rel_count; i++) {
+        rels[i].id = sysml2_intern(intern, rels[i].id);
+        rels[i].source = sysml2_intern(intern, rels[i].source);
+        rels[i].target = sysml2_intern(intern, rels[i].target);
+    }
+
     if (node_count > 0) {
         model->elements = sysml2_arena_alloc(arena, node_count * sizeof(SysmlNode *));
         if (!model->elements) return NULL;
@@ -361,6 +372,61 @@ TEST(delete_nonexistent_returns_copy) {
     FIXTURE_TEARDOWN();
 }
 
+TEST(delete_bulk_recursive) {
+    FIXTURE_SETUP();
+
+    /* Pkg with 5000 part defs, each with one child; Keep::K specializes
+     * every tenth definition */
+    enum { DEFS = 5000 };
+    size_t node_count = 2 + DEFS * 2;
+    size_t rel_count = DEFS / 10;
+    SysmlNode *nodes = SYSML2_ARENA_NEW_ARRAY(&arena, SysmlNode, node_count);
+    SysmlRelationship *rels = SYSML2_ARENA_NEW_ARRAY(&arena, SysmlRelationship, rel_count);
+    ASSERT_NOT_NULL(nodes);
+    ASSERT_NOT_NULL(rels);
+
+    nodes[0] = (SysmlNode){.id = "Pkg", .name = "Pkg", .kind = SYSML_KIND_PACKAGE};
+    nodes[1] = (SysmlNode){.id = "Keep", .name = "Keep", .kind = SYSML_KIND_PACKAGE};
+    char id[64];
+    for (size_t i = 0; i < DEFS; i++) {
+        snprintf(id, sizeof(id), "Pkg::D%zu", i);
+        SysmlNode *def = &nodes[2 + i * 2];
+        def->id = sysml2_arena_strdup(&arena, id);
+        def->parent_id = "Pkg";
+        def->kind = SYSML_KIND_PART_DEF;
+
+        snprintf(id, sizeof(id), "Pkg::D%zu::p", i);
+        SysmlNode *child = &nodes[3 + i * 2];
+        child->id = sysml2_arena_strdup(&arena, id);
+        child->parent_id = def->id;
+        child->kind = SYSML_KIND_PART_USAGE;
+
+        if (i % 10 == 0) {
+            rels[i / 10] = (SysmlRelationship){
+                .id = "rel", .kind = SYSML_KIND_REL_SPECIALIZATION,
+                .source = "Keep", .target = def->id
+            };
+        }
+    }
+    SysmlSemanticModel *model = create_test_model(&arena, &intern, nodes, node_count, rels, rel_count);
+
+    Sysml2QueryPattern *pattern = sysml2_query_parse("Pkg::**", &arena);
+    size_t deleted_count = 0;
+    SysmlSemanticModel *result = sysml2_modify_clone_with_deletions(
+        model, pattern, &arena, &intern, &deleted_count
+    );
+
+    ASSERT_NOT_NULL(result);
+    ASSERT_EQ(deleted_count, node_count - 1);
+    ASSERT_EQ(result->element_count, 1);
+    ASSERT_STR_EQ(result->elements[0]->id, "Keep");
+    ASSERT_EQ(result->relationship_count, 0);
+    ASSERT_EQ(result->alias_count, 0);
+    ASSERT_EQ(result->file_metadata_count, 0);
+
+    FIXTURE_TEARDOWN();
+}
+
 /* ========== Scope Tests ========== */
 
 TEST(scope_exists_true) {
@@ -847,7 +913,7 @@ TEST(merge_preserves_element_properties) {
     /* Fragment: Element with documentation */
     SysmlNode frag_nodes[1] = {
         {.id = "Elem", .name = "Elem", .kind = SYSML_KIND_PART_DEF, .parent_id = NULL,
-         .documentation = "Test documentation"},
+         .cold = &(SysmlNodeCold){.documentation = "Test documentation"}},
     };
     SysmlSemanticModel *fragment = create_test_model(&arena, &intern, frag_nodes, 1, NULL, 0);
 
@@ -862,8 +928,8 @@ TEST(merge_preserves_element_properties) {
     /* Find merged element and check documentation preserved */
     for (size_t i = 0; i < result->element_count; i++) {
         if (strcmp(result->elements[i]->name, "Elem") == 0) {
-            ASSERT_NOT_NULL(result->elements[i]->documentation);
-            ASSERT_STR_EQ(result->elements[i]->documentation, "Test documentation");
+            ASSERT_NOT_NULL(sysml2_node_cold(result->elements[i])->documentation);
+            ASSERT_STR_EQ(sysml2_node_cold(result->elements[i])->documentation, "Test documentation");
         }
     }
 
@@ -1155,9 +1221,9 @@ TEST(merge_no_metadata_accumulation) {
     SysmlMetadataUsage *old_meta = sysml2_arena_alloc(&arena, sizeof(SysmlMetadataUsage));
     memset(old_meta, 0, sizeof(SysmlMetadataUsage));
     old_meta->type_ref = "SourceFile";
-    base_nodes[0].prefix_applied_metadata = sysml2_arena_alloc(&arena, sizeof(SysmlMetadataUsage *));
-    base_nodes[0].prefix_applied_metadata[0] = old_meta;
-    base_nodes[0].prefix_applied_metadata_count = 1;
+    sysml2_node_cold_mut(&arena, &base_nodes[0])->prefix_applied_metadata = sysml2_arena_alloc(&arena, sizeof(SysmlMetadataUsage *));
+    sysml2_node_cold(&base_nodes[0])->prefix_applied_metadata[0] = old_meta;
+    sysml2_node_cold_mut(&arena, &base_nodes[0])->prefix_applied_metadata_count = 1;
 
     base_nodes[1].id = "Pkg::A";
     base_nodes[1].name = "A";
@@ -1176,9 +1242,9 @@ TEST(merge_no_metadata_accumulation) {
     SysmlMetadataUsage *new_meta = sysml2_arena_alloc(&arena, sizeof(SysmlMetadataUsage));
     memset(new_meta, 0, sizeof(SysmlMetadataUsage));
     new_meta->type_ref = "SourceFile";
-    frag_nodes[0].prefix_applied_metadata = sysml2_arena_alloc(&arena, sizeof(SysmlMetadataUsage *));
-    frag_nodes[0].prefix_applied_metadata[0] = new_meta;
-    frag_nodes[0].prefix_applied_metadata_count = 1;
+    sysml2_node_cold_mut(&arena, &frag_nodes[0])->prefix_applied_metadata = sysml2_arena_alloc(&arena, sizeof(SysmlMetadataUsage *));
+    sysml2_node_cold(&frag_nodes[0])->prefix_applied_metadata[0] = new_meta;
+    sysml2_node_cold_mut(&arena, &frag_nodes[0])->prefix_applied_metadata_count = 1;
 
     SysmlSemanticModel *fragment = create_test_model(&arena, &intern, frag_nodes, 1, NULL, 0);
 
@@ -1193,14 +1259,14 @@ TEST(merge_no_metadata_accumulation) {
     /* Verify: Package should have NO prefix_applied_metadata (cleared) */
     for (size_t i = 0; i < result->element_count; i++) {
         if (strcmp(result->elements[i]->id, "Pkg") == 0) {
-            ASSERT_EQ(result->elements[i]->prefix_applied_metadata_count, 0);
+            ASSERT_EQ(sysml2_node_cold(result->elements[i])->prefix_applied_metadata_count, 0);
         }
     }
 
     /* Verify: Pkg::A should have exactly 1 @SourceFile (from fragment) */
     for (size_t i = 0; i < result->element_count; i++) {
         if (strcmp(result->elements[i]->id, "Pkg::A") == 0) {
-            ASSERT_EQ(result->elements[i]->prefix_applied_metadata_count, 1);
+            ASSERT_EQ(sysml2_node_cold(result->elements[i])->prefix_applied_metadata_count, 1);
         }
     }
 
@@ -1232,9 +1298,9 @@ TEST(merge_preserves_sibling_metadata) {
     SysmlMetadataUsage *b_meta = sysml2_arena_alloc(&arena, sizeof(SysmlMetadataUsage));
     memset(b_meta, 0, sizeof(SysmlMetadataUsage));
     b_meta->type_ref = "PreservedMeta";
-    base_nodes[2].prefix_applied_metadata = sysml2_arena_alloc(&arena, sizeof(SysmlMetadataUsage *));
-    base_nodes[2].prefix_applied_metadata[0] = b_meta;
-    base_nodes[2].prefix_applied_metadata_count = 1;
+    sysml2_node_cold_mut(&arena, &base_nodes[2])->prefix_applied_metadata = sysml2_arena_alloc(&arena, sizeof(SysmlMetadataUsage *));
+    sysml2_node_cold(&base_nodes[2])->prefix_applied_metadata[0] = b_meta;
+    sysml2_node_cold_mut(&arena, &base_nodes[2])->prefix_applied_metadata_count = 1;
 
     SysmlSemanticModel *base = create_test_model(&arena, &intern, base_nodes, 3, NULL, 0);
 
@@ -1258,8 +1324,8 @@ TEST(merge_preserves_sibling_metadata) {
     /* Verify: Pkg::B still has its metadata (sibling not touched) */
     for (size_t i = 0; i < result->element_count; i++) {
         if (strcmp(result->elements[i]->id, "Pkg::B") == 0) {
-            ASSERT_EQ(result->elements[i]->prefix_applied_metadata_count, 1);
-            ASSERT_STR_EQ(result->elements[i]->prefix_applied_metadata[0]->type_ref, "PreservedMeta");
+            ASSERT_EQ(sysml2_node_cold(result->elements[i])->prefix_applied_metadata_count, 1);
+            ASSERT_STR_EQ(sysml2_node_cold(result->elements[i])->prefix_applied_metadata[0]->type_ref, "PreservedMeta");
         }
     }
 
@@ -1281,9 +1347,9 @@ TEST(merge_clears_body_metadata) {
     SysmlMetadataUsage *body_meta = sysml2_arena_alloc(&arena, sizeof(SysmlMetadataUsage));
     memset(body_meta, 0, sizeof(SysmlMetadataUsage));
     body_meta->type_ref = "OldBodyMeta";
-    base_nodes[0].metadata = sysml2_arena_alloc(&arena, sizeof(SysmlMetadataUsage *));
-    base_nodes[0].metadata[0] = body_meta;
-    base_nodes[0].metadata_count = 1;
+    sysml2_node_cold_mut(&arena, &base_nodes[0])->metadata = sysml2_arena_alloc(&arena, sizeof(SysmlMetadataUsage *));
+    sysml2_node_cold(&base_nodes[0])->metadata[0] = body_meta;
+    sysml2_node_cold_mut(&arena, &base_nodes[0])->metadata_count = 1;
 
     SysmlSemanticModel *base = create_test_model(&arena, &intern, base_nodes, 1, NULL, 0);
 
@@ -1307,8 +1373,8 @@ TEST(merge_clears_body_metadata) {
     /* Verify: Package body metadata is PRESERVED (fragment had no metadata) */
     for (size_t i = 0; i < result->element_count; i++) {
         if (strcmp(result->elements[i]->id, "Pkg") == 0) {
-            ASSERT_EQ(result->elements[i]->metadata_count, 1);
-            ASSERT_STR_EQ(result->elements[i]->metadata[0]->type_ref, "OldBodyMeta");
+            ASSERT_EQ(sysml2_node_cold(result->elements[i])->metadata_count, 1);
+            ASSERT_STR_EQ(sysml2_node_cold(result->elements[i])->metadata[0]->type_ref, "OldBodyMeta");
         }
     }
 
@@ -1332,7 +1398,7 @@ TEST(merge_clears_trailing_trivia) {
     trivia->kind = SYSML_TRIVIA_LINE_COMMENT;
     trivia->text = "// accumulated trailing comment";
     trivia->next = NULL;
-    base_nodes[0].trailing_trivia = trivia;
+    sysml2_node_cold_mut(&arena, &base_nodes[0])->trailing_trivia = trivia;
 
     SysmlSemanticModel *base = create_test_model(&arena, &intern, base_nodes, 1, NULL, 0);
 
@@ -1357,7 +1423,7 @@ TEST(merge_clears_trailing_trivia) {
      * This ensures blank lines and formatting are not lost during simple element additions */
     for (size_t i = 0; i < result->element_count; i++) {
         if (strcmp(result->elements[i]->id, "Pkg") == 0) {
-            ASSERT_NOT_NULL(result->elements[i]->trailing_trivia);
+            ASSERT_NOT_NULL(sysml2_node_cold(result->elements[i])->trailing_trivia);
         }
     }
 
@@ -1381,7 +1447,7 @@ TEST(merge_clears_leading_trivia) {
     trivia->kind = SYSML_TRIVIA_BLOCK_COMMENT;
     trivia->text = "/* accumulated comment */";
     trivia->next = NULL;
-    base_nodes[0].leading_trivia = trivia;
+    sysml2_node_cold_mut(&arena, &base_nodes[0])->leading_trivia = trivia;
 
     SysmlSemanticModel *base = create_test_model(&arena, &intern, base_nodes, 1, NULL, 0);
 
@@ -1406,7 +1472,7 @@ TEST(merge_clears_leading_trivia) {
      * This ensures blank lines and formatting are not lost during simple element additions */
     for (size_t i = 0; i < result->element_count; i++) {
         if (strcmp(result->elements[i]->id, "Pkg") == 0) {
-            ASSERT_NOT_NULL(result->elements[i]->leading_trivia);
+            ASSERT_NOT_NULL(sysml2_node_cold(result->elements[i])->leading_trivia);
         }
     }
 
@@ -1431,7 +1497,7 @@ TEST(trivia_blank_line_count_preserved) {
     trivia->text = NULL;
     trivia->count = 3;  /* 3 consecutive blank lines */
     trivia->next = NULL;
-    base_nodes[0].trailing_trivia = trivia;
+    sysml2_node_cold_mut(&arena, &base_nodes[0])->trailing_trivia = trivia;
 
     SysmlSemanticModel *base = create_test_model(&arena, &intern, base_nodes, 1, NULL, 0);
 
@@ -1455,9 +1521,9 @@ TEST(trivia_blank_line_count_preserved) {
     /* Verify: Package trailing trivia count is preserved */
     for (size_t i = 0; i < result->element_count; i++) {
         if (strcmp(result->elements[i]->id, "Pkg") == 0) {
-            ASSERT_NOT_NULL(result->elements[i]->trailing_trivia);
-            ASSERT_EQ(result->elements[i]->trailing_trivia->kind, SYSML_TRIVIA_BLANK_LINE);
-            ASSERT_EQ(result->elements[i]->trailing_trivia->count, 3);
+            ASSERT_NOT_NULL(sysml2_node_cold(result->elements[i])->trailing_trivia);
+            ASSERT_EQ(sysml2_node_cold(result->elements[i])->trailing_trivia->kind, SYSML_TRIVIA_BLANK_LINE);
+            ASSERT_EQ(sysml2_node_cold(result->elements[i])->trailing_trivia->count, 3);
         }
     }
 
@@ -1479,9 +1545,9 @@ TEST(merge_preserves_scope_metadata_when_fragment_has_none) {
     SysmlMetadataUsage *pkg_meta = sysml2_arena_alloc(&arena, sizeof(SysmlMetadataUsage));
     memset(pkg_meta, 0, sizeof(SysmlMetadataUsage));
     pkg_meta->type_ref = "SourceFile";
-    base_nodes[0].prefix_applied_metadata = sysml2_arena_alloc(&arena, sizeof(SysmlMetadataUsage *));
-    base_nodes[0].prefix_applied_metadata[0] = pkg_meta;
-    base_nodes[0].prefix_applied_metadata_count = 1;
+    sysml2_node_cold_mut(&arena, &base_nodes[0])->prefix_applied_metadata = sysml2_arena_alloc(&arena, sizeof(SysmlMetadataUsage *));
+    sysml2_node_cold(&base_nodes[0])->prefix_applied_metadata[0] = pkg_meta;
+    sysml2_node_cold_mut(&arena, &base_nodes[0])->prefix_applied_metadata_count = 1;
 
     SysmlSemanticModel *base = create_test_model(&arena, &intern, base_nodes, 1, NULL, 0);
 
@@ -1505,8 +1571,8 @@ TEST(merge_preserves_scope_metadata_when_fragment_has_none) {
     /* Verify: Package prefix_applied_metadata is PRESERVED (fragment had no metadata) */
     for (size_t i = 0; i < result->element_count; i++) {
         if (strcmp(result->elements[i]->id, "Pkg") == 0) {
-            ASSERT_EQ(result->elements[i]->prefix_applied_metadata_count, 1);
-            ASSERT_STR_EQ(result->elements[i]->prefix_applied_metadata[0]->type_ref, "SourceFile");
+            ASSERT_EQ(sysml2_node_cold(result->elements[i])->prefix_applied_metadata_count, 1);
+            ASSERT_STR_EQ(sysml2_node_cold(result->elements[i])->prefix_applied_metadata[0]->type_ref, "SourceFile");
         }
     }
 
@@ -1533,9 +1599,9 @@ TEST(merge_preserves_replaced_element_metadata) {
     SysmlMetadataUsage *a_meta = sysml2_arena_alloc(&arena, sizeof(SysmlMetadataUsage));
     memset(a_meta, 0, sizeof(SysmlMetadataUsage));
     a_meta->type_ref = "SourceFile";
-    base_nodes[1].prefix_applied_metadata = sysml2_arena_alloc(&arena, sizeof(SysmlMetadataUsage *));
-    base_nodes[1].prefix_applied_metadata[0] = a_meta;
-    base_nodes[1].prefix_applied_metadata_count = 1;
+    sysml2_node_cold_mut(&arena, &base_nodes[1])->prefix_applied_metadata = sysml2_arena_alloc(&arena, sizeof(SysmlMetadataUsage *));
+    sysml2_node_cold(&base_nodes[1])->prefix_applied_metadata[0] = a_meta;
+    sysml2_node_cold_mut(&arena, &base_nodes[1])->prefix_applied_metadata_count = 1;
 
     SysmlSemanticModel *base = create_test_model(&arena, &intern, base_nodes, 2, NULL, 0);
 
@@ -1561,8 +1627,8 @@ TEST(merge_preserves_replaced_element_metadata) {
     /* Verify: Pkg::A still has its metadata (preserved from original) */
     for (size_t i = 0; i < result->element_count; i++) {
         if (strcmp(result->elements[i]->id, "Pkg::A") == 0) {
-            ASSERT_EQ(result->elements[i]->prefix_applied_metadata_count, 1);
-            ASSERT_STR_EQ(result->elements[i]->prefix_applied_metadata[0]->type_ref, "SourceFile");
+            ASSERT_EQ(sysml2_node_cold(result->elements[i])->prefix_applied_metadata_count, 1);
+            ASSERT_STR_EQ(sysml2_node_cold(result->elements[i])->prefix_applied_metadata[0]->type_ref, "SourceFile");
         }
     }
 
@@ -1594,9 +1660,9 @@ TEST(merge_repeated_upserts_no_accumulation) {
         SysmlMetadataUsage *meta = sysml2_arena_alloc(&arena, sizeof(SysmlMetadataUsage));
         memset(meta, 0, sizeof(SysmlMetadataUsage));
         meta->type_ref = "SourceFile";
-        frag_nodes[0].prefix_applied_metadata = sysml2_arena_alloc(&arena, sizeof(SysmlMetadataUsage *));
-        frag_nodes[0].prefix_applied_metadata[0] = meta;
-        frag_nodes[0].prefix_applied_metadata_count = 1;
+        sysml2_node_cold_mut(&arena, &frag_nodes[0])->prefix_applied_metadata = sysml2_arena_alloc(&arena, sizeof(SysmlMetadataUsage *));
+        sysml2_node_cold(&frag_nodes[0])->prefix_applied_metadata[0] = meta;
+        sysml2_node_cold_mut(&arena, &frag_nodes[0])->prefix_applied_metadata_count = 1;
 
         SysmlSemanticModel *fragment = create_test_model(&arena, &intern, frag_nodes, 1, NULL, 0);
 
@@ -1610,14 +1676,14 @@ TEST(merge_repeated_upserts_no_accumulation) {
     /* After 3 rounds, Pkg should have 0 metadata (cleared each time) */
     for (size_t i = 0; i < model->element_count; i++) {
         if (strcmp(model->elements[i]->id, "Pkg") == 0) {
-            ASSERT_EQ(model->elements[i]->prefix_applied_metadata_count, 0);
+            ASSERT_EQ(sysml2_node_cold(model->elements[i])->prefix_applied_metadata_count, 0);
         }
     }
 
     /* And Pkg::Elem should have exactly 1 @SourceFile (not 3) */
     for (size_t i = 0; i < model->element_count; i++) {
         if (strcmp(model->elements[i]->id, "Pkg::Elem") == 0) {
-            ASSERT_EQ(model->elements[i]->prefix_applied_metadata_count, 1);
+            ASSERT_EQ(sysml2_node_cold(model->elements[i])->prefix_applied_metadata_count, 1);
         }
     }
 
@@ -1895,7 +1961,7 @@ TEST(merge_replaces_matching_children) {
     base_nodes[2].name = "Attr";
     base_nodes[2].kind = SYSML_KIND_ATTRIBUTE_USAGE;
     base_nodes[2].parent_id = "Pkg::Parent";
-    base_nodes[2].documentation = "Old doc";
+    sysml2_node_cold_mut(&arena, &base_nodes[2])->documentation = "Old doc";
 
     SysmlSemanticModel *base = create_test_model(&arena, &intern, base_nodes, 3, NULL, 0);
 
@@ -1910,7 +1976,7 @@ TEST(merge_replaces_matching_children) {
     frag_nodes[1].name = "Attr";
     frag_nodes[1].kind = SYSML_KIND_ATTRIBUTE_USAGE;
     frag_nodes[1].parent_id = "Parent";
-    frag_nodes[1].documentation = "New doc";
+    sysml2_node_cold_mut(&arena, &frag_nodes[1])->documentation = "New doc";
 
     SysmlSemanticModel *fragment = create_test_model(&arena, &intern, frag_nodes, 2, NULL, 0);
 
@@ -1925,13 +1991,105 @@ TEST(merge_replaces_matching_children) {
     /* Verify: Attr is replaced (has new doc) */
     for (size_t i = 0; i < result->element_count; i++) {
         if (strcmp(result->elements[i]->id, "Pkg::Parent::Attr") == 0) {
-            ASSERT_STR_EQ(result->elements[i]->documentation, "New doc");
+            ASSERT_STR_EQ(sysml2_node_cold(result->elements[i])->documentation, "New doc");
         }
     }
 
     FIXTURE_TEARDOWN();
 }
 
+/* Test: Matching stays exact when the models are large enough to need the ID index */
+TEST(merge_many_elements_matches_by_id) {
+    FIXTURE_SETUP();
+
+    /* Base: Pkg with 300 parts P<i>, each with Attr (which owns Sub) and Keep */
+    enum { PARTS = 300 };
+    SysmlNode *base_nodes = sysml2_arena_alloc(&arena, (1 + PARTS * 4) * sizeof(SysmlNode));
+    memset(base_nodes, 0, (1 + PARTS * 4) * sizeof(SysmlNode));
+    base_nodes[0].id = "Pkg";
+    base_nodes[0].name = "Pkg";
+    base_nodes[0].kind = SYSML_KIND_PACKAGE;
+
+    char buf[64];
+    for (size_t i = 0; i < PARTS; i++) {
+        SysmlNode *part = &base_nodes[1 + i * 4];
+        snprintf(buf, sizeof(buf), "Pkg::P%zu", i);
+        part->id = sysml2_intern(&intern, buf);
+        part->name = part->id + 5;
+        part->kind = SYSML_KIND_PART_USAGE;
+        part->parent_id = "Pkg";
+
+        SysmlNode *attr = part + 1;
+        snprintf(buf, sizeof(buf), "Pkg::P%zu::Attr", i);
+        attr->id = sysml2_intern(&intern, buf);
+        attr->name = "Attr";
+        attr->kind = SYSML_KIND_ATTRIBUTE_USAGE;
+        attr->parent_id = part->id;
+
+        SysmlNode *sub = part + 2;
+        snprintf(buf, sizeof(buf), "Pkg::P%zu::Attr::Sub", i);
+        sub->id = sysml2_intern(&intern, buf);
+        sub->name = "Sub";
+        sub->kind = SYSML_KIND_ATTRIBUTE_USAGE;
+        sub->parent_id = attr->id;
+
+        SysmlNode *keep = part + 3;
+        snprintf(buf, sizeof(buf), "Pkg::P%zu::Keep", i);
+        keep->id = sysml2_intern(&intern, buf);
+        keep->name = "Keep";
+        keep->kind = SYSML_KIND_ATTRIBUTE_USAGE;
+        keep->parent_id = part->id;
+    }
+    SysmlSemanticModel *base = create_test_model(&arena, &intern, base_nodes, 1 + PARTS * 4, NULL, 0);
+
+    /* Fragment: every even part again with a new Attr, plus a new part */
+    size_t frag_count = (PARTS / 2) * 2 + 1;
+    SysmlNode *frag_nodes = sysml2_arena_alloc(&arena, frag_count * sizeof(SysmlNode));
+    memset(frag_nodes, 0, frag_count * sizeof(SysmlNode));
+    for (size_t i = 0; i < PARTS / 2; i++) {
+        SysmlNode *part = &frag_nodes[i * 2];
+        snprintf(buf, sizeof(buf), "P%zu", i * 2);
+        part->id = sysml2_intern(&intern, buf);
+        part->name = part->id;
+        part->kind = SYSML_KIND_PART_USAGE;
+
+        SysmlNode *attr = part + 1;
+        snprintf(buf, sizeof(buf), "P%zu::Attr", i * 2);
+        attr->id = sysml2_intern(&intern, buf);
+        attr->name = "Attr";
+        attr->kind = SYSML_KIND_ATTRIBUTE_USAGE;
+        attr->parent_id = part->id;
+    }
+    frag_nodes[frag_count - 1].id = "Extra";
+    frag_nodes[frag_count - 1].name = "Extra";
+    frag_nodes[frag_count - 1].kind = SYSML_KIND_PART_USAGE;
+    SysmlSemanticModel *fragment = create_test_model(&arena, &intern, frag_nodes, frag_count, NULL, 0);
+
+    size_t added = 0, replaced = 0;
+    SysmlSemanticModel *result = sysml2_modify_merge_fragment(
+        base, fragment, "Pkg", false, false, &arena, &intern, &added, &replaced
+    );
+
+    ASSERT_NOT_NULL(result);
+    ASSERT_EQ(replaced, PARTS);  /* Even parts and their Attr */
+    ASSERT_EQ(added, 1);         /* Extra */
+
+    /* Even parts lose Attr::Sub with the old Attr; odd parts are untouched */
+    ASSERT_EQ(result->element_count, 1 + PARTS * 4 - PARTS / 2 + 1);
+
+    /* Replacements stay in place: Pkg, then P0's new element before P1 */
+    ASSERT_STR_EQ(result->elements[0]->id, "Pkg");
+    ASSERT_STR_EQ(result->elements[1]->id, "Pkg::P0");
+    size_t sub_count = 0;
+    for (size_t i = 0; i < result->element_count; i++) {
+        if (result->elements[i]->name && strcmp(result->elements[i]->name, "Sub") == 0) sub_count++;
+    }
+    ASSERT_EQ(sub_count, PARTS / 2);
+    ASSERT_STR_EQ(result->elements[result->element_count - 1]->id, "Pkg::Extra");
+
+    FIXTURE_TEARDOWN();
+}
+
 /* ========== Auto-Unwrap Tests ========== */
 
 /* Test: Single top-level package matching target scope is auto-unwrapped */
@@ -2203,8 +2361,8 @@ TEST(auto_unwrap_strips_import_owner_scopes) {
     SysmlImport imp = {0};
     imp.id = "imp1";
     imp.kind = SYSML_KIND_IMPORT_ALL;
-    imp.target = "External";
-    imp.owner_scope = "Foo";  /* Owned by the wrapper package */
+    imp.target = sysml2_intern(&intern, "External");
+    imp.owner_scope = sysml2_intern(&intern, "Foo");  /* Owned by the wrapper package */
 
     fragment->imports = sysml2_arena_alloc(&arena, sizeof(SysmlImport *));
     fragment->imports[0] = &imp;
@@ -2251,9 +2409,9 @@ TEST(merge_preserves_replaced_element_body_stmts) {
     stmt->kind = SYSML_STMT_SHORTHAND_FEATURE;
     stmt->raw_text = sysml2_intern(&intern, ":>> layer = \"presentation\";");
 
-    base_nodes[1].body_stmts = sysml2_arena_alloc(&arena, sizeof(SysmlStatement *));
-    base_nodes[1].body_stmts[0] = stmt;
-    base_nodes[1].body_stmt_count = 1;
+    sysml2_node_cold_mut(&arena, &base_nodes[1])->body_stmts = sysml2_arena_alloc(&arena, sizeof(SysmlStatement *));
+    sysml2_node_cold(&base_nodes[1])->body_stmts[0] = stmt;
+    sysml2_node_cold_mut(&arena, &base_nodes[1])->body_stmt_count = 1;
 
     SysmlSemanticModel *base = create_test_model(&arena, &intern, base_nodes, 2, NULL, 0);
 
@@ -2270,9 +2428,9 @@ TEST(merge_preserves_replaced_element_body_stmts) {
     frag_stmt->kind = SYSML_STMT_SHORTHAND_FEATURE;
     frag_stmt->raw_text = sysml2_intern(&intern, ":>> name = \"Updated\";");
 
-    frag_nodes[0].body_stmts = sysml2_arena_alloc(&arena, sizeof(SysmlStatement *));
-    frag_nodes[0].body_stmts[0] = frag_stmt;
-    frag_nodes[0].body_stmt_count = 1;
+    sysml2_node_cold_mut(&arena, &frag_nodes[0])->body_stmts = sysml2_arena_alloc(&arena, sizeof(SysmlStatement *));
+    sysml2_node_cold(&frag_nodes[0])->body_stmts[0] = frag_stmt;
+    sysml2_node_cold_mut(&arena, &frag_nodes[0])->body_stmt_count = 1;
 
     SysmlSemanticModel *fragment = create_test_model(&arena, &intern, frag_nodes, 1, NULL, 0);
 
@@ -2289,12 +2447,12 @@ TEST(merge_preserves_replaced_element_body_stmts) {
     for (size_t i = 0; i < result->element_count; i++) {
         if (strcmp(result->elements[i]->id, "Pkg::A") == 0) {
             /* Should have 2 statements: name (from fragment) + layer (preserved) */
-            ASSERT_EQ(result->elements[i]->body_stmt_count, 2);
+            ASSERT_EQ(sysml2_node_cold(result->elements[i])->body_stmt_count, 2);
 
             /* Verify both statements exist */
             bool found_name = false, found_layer = false;
-            for (size_t j = 0; j < result->elements[i]->body_stmt_count; j++) {
-                SysmlStatement *s = result->elements[i]->body_stmts[j];
+            for (size_t j = 0; j < sysml2_node_cold(result->elements[i])->body_stmt_count; j++) {
+                SysmlStatement *s = sysml2_node_cold(result->elements[i])->body_stmts[j];
                 if (s && s->raw_text) {
                     if (strstr(s->raw_text, "name")) found_name = true;
                     if (strstr(s->raw_text, "layer")) found_layer = true;
@@ -2323,7 +2481,7 @@ TEST(merge_preserves_replaced_element_doc) {
     base_nodes[1].name = "A";
     base_nodes[1].kind = SYSML_KIND_PART_DEF;
     base_nodes[1].parent_id = "Pkg";
-    base_nodes[1].documentation = sysml2_intern(&intern, "Contract between module provider and consumer");
+    sysml2_node_cold_mut(&arena, &base_nodes[1])->documentation = sysml2_intern(&intern, "Contract between module provider and consumer");
 
     SysmlSemanticModel *base = create_test_model(&arena, &intern, base_nodes, 2, NULL, 0);
 
@@ -2349,8 +2507,8 @@ TEST(merge_preserves_replaced_element_doc) {
     /* Verify: Pkg::A still has its documentation (preserved from original) */
     for (size_t i = 0; i < result->element_count; i++) {
         if (strcmp(result->elements[i]->id, "Pkg::A") == 0) {
-            ASSERT_NOT_NULL(result->elements[i]->documentation);
-            ASSERT_STR_EQ(result->elements[i]->documentation, "Contract between module provider and consumer");
+            ASSERT_NOT_NULL(sysml2_node_cold(result->elements[i])->documentation);
+            ASSERT_STR_EQ(sysml2_node_cold(result->elements[i])->documentation, "Contract between module provider and consumer");
         }
     }
 
@@ -2470,7 +2628,7 @@ TEST(merge_preserves_wrapper_documentation) {
         if (result->elements[i] && result->elements[i]->id &&
             strcmp(result->elements[i]->id, "MyPkg") == 0) {
             found = true;
-            ASSERT_NOT_NULL(result->elements[i]->documentation);
+            ASSERT_NOT_NULL(sysml2_node_cold(result->elements[i])->documentation);
             break;
         }
     }
@@ -2891,12 +3049,11 @@ TEST(merge_preserves_element_order) {
 
     Sysml2Arena result_arena;
     sysml2_arena_init(&result_arena);
-    Sysml2Intern result_intern;
-    sysml2_intern_init(&result_intern, &result_arena);
 
+    /* IDs must stay in the interner the inputs were built with */
     size_t added = 0, replaced = 0;
     SysmlSemanticModel *result = sysml2_modify_merge_fragment(
-        base_model, frag_model, "Container", true, false, &result_arena, &result_intern, &added, &replaced);
+        base_model, frag_model, "Container", true, false, &result_arena, &intern, &added, &replaced);
     ASSERT_NOT_NULL(result);
 
     char *output = NULL;
@@ -2918,11 +3075,122 @@ TEST(merge_preserves_element_order) {
     ASSERT(second_pos < third_pos);
 
     free(output);
-    sysml2_intern_destroy(&result_intern);
     sysml2_arena_destroy(&result_arena);
     FIXTURE_TEARDOWN();
 }
 
+TEST(merge_shares_untouched_nodes) {
+    FIXTURE_SETUP();
+
+    /* Base model: Pkg with @SourceFile, Pkg::A, Pkg::B, and an alias in Pkg */
+    SysmlNode base_nodes[3];
+    memset(base_nodes, 0, sizeof(base_nodes));
+    base_nodes[0].id = "Pkg";
+    base_nodes[0].name = "Pkg";
+    base_nodes[0].kind = SYSML_KIND_PACKAGE;
+
+    SysmlMetadataUsage *old_meta = sysml2_arena_alloc(&arena, sizeof(SysmlMetadataUsage));
+    memset(old_meta, 0, sizeof(SysmlMetadataUsage));
+    old_meta->type_ref = "SourceFile";
+    sysml2_node_cold_mut(&arena, &base_nodes[0])->prefix_applied_metadata = sysml2_arena_alloc(&arena, sizeof(SysmlMetadataUsage *));
+    sysml2_node_cold(&base_nodes[0])->prefix_applied_metadata[0] = old_meta;
+    sysml2_node_cold_mut(&arena, &base_nodes[0])->prefix_applied_metadata_count = 1;
+
+    base_nodes[1].id = "Pkg::A";
+    base_nodes[1].name = "A";
+    base_nodes[1].kind = SYSML_KIND_PART_DEF;
+    base_nodes[1].parent_id = "Pkg";
+
+    base_nodes[2].id = "Pkg::B";
+    base_nodes[2].name = "B";
+    base_nodes[2].kind = SYSML_KIND_PART_DEF;
+    base_nodes[2].parent_id = "Pkg";
+
+    SysmlSemanticModel *base = create_test_model(&arena, &intern, base_nodes, 3, NULL, 0);
+
+    SysmlAlias alias = {.id = "Pkg::BB", .name = "BB", .target = "B", .owner_scope = base_nodes[0].id};
+    SysmlAlias *aliases[1] = {&alias};
+    base->aliases = aliases;
+    base->alias_count = 1;
+    base->alias_capacity = 1;
+
+    /* Fragment: A with its own @SourceFile (replaces the scope's) */
+    SysmlNode frag_nodes[1];
+    memset(frag_nodes, 0, sizeof(frag_nodes));
+    frag_nodes[0].id = "A";
+    frag_nodes[0].name = "A";
+    frag_nodes[0].kind = SYSML_KIND_PART_DEF;
+
+    SysmlMetadataUsage *new_meta = sysml2_arena_alloc(&arena, sizeof(SysmlMetadataUsage));
+    memset(new_meta, 0, sizeof(SysmlMetadataUsage));
+    new_meta->type_ref = "SourceFile";
+    sysml2_node_cold_mut(&arena, &frag_nodes[0])->prefix_applied_metadata = sysml2_arena_alloc(&arena, sizeof(SysmlMetadataUsage *));
+    sysml2_node_cold(&frag_nodes[0])->prefix_applied_metadata[0] = new_meta;
+    sysml2_node_cold_mut(&arena, &frag_nodes[0])->prefix_applied_metadata_count = 1;
+
+    SysmlSemanticModel *fragment = create_test_model(&arena, &intern, frag_nodes, 1, NULL, 0);
+
+    size_t added = 0, replaced = 0;
+    SysmlSemanticModel *result = sysml2_modify_merge_fragment(
+        base, fragment, "Pkg", false, false, &arena, &intern, &added, &replaced
+    );
+
+    ASSERT_NOT_NULL(result);
+    ASSERT_EQ(replaced, 1);
+    ASSERT_EQ(result->element_count, 3);
+
+    /* Untouched B is shared; the edited scope is a copy */
+    ASSERT_TRUE(result->elements[2] == &base_nodes[2]);
+    ASSERT_TRUE(result->elements[0] != &base_nodes[0]);
+    ASSERT_EQ(sysml2_node_cold(result->elements[0])->prefix_applied_metadata_count, 0);
+    ASSERT_EQ(sysml2_node_cold(&base_nodes[0])->prefix_applied_metadata_count, 1);
+
+    /* Aliases carry over */
+    ASSERT_EQ(result->alias_count, 1);
+    ASSERT_TRUE(result->aliases[0] == &alias);
+
+    FIXTURE_TEARDOWN();
+}
+
+TEST(delete_filters_aliases) {
+    FIXTURE_SETUP();
+
+    SysmlNode nodes[3] = {
+        {.id = "Pkg", .name = "Pkg", .kind = SYSML_KIND_PACKAGE, .parent_id = NULL},
+        {.id = "Pkg::A", .name = "A", .kind = SYSML_KIND_PACKAGE, .parent_id = "Pkg"},
+        {.id = "Pkg::B", .name = "B", .kind = SYSML_KIND_PART_DEF, .parent_id = "Pkg"},
+    };
+    SysmlSemanticModel *model = create_test_model(&arena, &intern, nodes, 3, NULL, 0);
+
+    SysmlAlias kept = {.id = "Pkg::BB", .name = "BB", .target = "B", .owner_scope = nodes[0].id};
+    SysmlAlias dropped = {.id = "Pkg::A::X", .name = "X", .target = "B", .owner_scope = nodes[1].id};
+    SysmlAlias *aliases[2] = {&kept, &dropped};
+    model->aliases = aliases;
+    model->alias_count = 2;
+    model->alias_capacity = 2;
+
+    /* Deleting nothing shares the alias list */
+    Sysml2QueryPattern *none = sysml2_query_parse("Pkg::Missing", &arena);
+    size_t deleted_count = 0;
+    SysmlSemanticModel *result = sysml2_modify_clone_with_deletions(
+        model, none, &arena, &intern, &deleted_count
+    );
+    ASSERT_NOT_NULL(result);
+    ASSERT_EQ(deleted_count, 0);
+    ASSERT_TRUE(result->elements == model->elements);
+    ASSERT_EQ(result->alias_count, 2);
+
+    /* Deleting Pkg::A drops the alias it owns */
+    Sysml2QueryPattern *pattern = sysml2_query_parse("Pkg::A", &arena);
+    result = sysml2_modify_clone_with_deletions(model, pattern, &arena, &intern, &deleted_count);
+    ASSERT_NOT_NULL(result);
+    ASSERT_EQ(deleted_count, 1);
+    ASSERT_EQ(result->alias_count, 1);
+    ASSERT_TRUE(result->aliases[0] == &kept);
+
+    FIXTURE_TEARDOWN();
+}
+
 /* ========== Round-Trip Merge Regression Tests ========== */
 
 /* Test: Shorthand statements with same name are not duplicated across merges */
@@ -3414,6 +3682,7 @@ int main(void) {
     RUN_TEST(delete_recursive);
     RUN_TEST(delete_removes_relationships);
     RUN_TEST(delete_nonexistent_returns_copy);
+    RUN_TEST(delete_bulk_recursive);
 
     /* Additional delete tests */
     RUN_TEST(delete_preserves_unrelated_sibling);
@@ -3471,6 +3740,7 @@ int main(void) {
     /* Child preservation tests */
     RUN_TEST(merge_preserves_children_of_replaced_parent);
     RUN_TEST(merge_replaces_matching_children);
+    RUN_TEST(merge_many_elements_matches_by_id);
 
     /* Auto-unwrap tests */
     RUN_TEST(auto_unwrap_single_matching_package);
@@ -3508,6 +3778,8 @@ int main(void) {
 
     /* Element reordering regression test */
     RUN_TEST(merge_preserves_element_order);
+    RUN_TEST(merge_shares_untouched_nodes);
+    RUN_TEST(delete_filters_aliases);
 
     /* Round-trip merge regression tests */
     RUN_TEST(upsert_shorthand_stmt_not_duplicated);
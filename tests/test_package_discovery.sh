@@ -99,6 +99,84 @@ else
     FAILED=$((FAILED + 1))
 fi
 
+echo ""
+echo "--- Test 4: --cache-dir reuses parsed files across runs ---"
+CACHE_DIR=$(mktemp -d)
+trap 'rm -rf "$CACHE_DIR"' EXIT
+
+set +e
+cold_output=$("$SYSML2" --cache-dir "$CACHE_DIR" -f json "$FIXTURES_DIR/main.sysml" 2>&1)
+cold_exit=$?
+warm_output=$("$SYSML2" -v --cache-dir "$CACHE_DIR" "$FIXTURES_DIR/main.sysml" 2>&1)
+warm_exit=$?
+warm_json=$("$SYSML2" --cache-dir "$CACHE_DIR" -f json "$FIXTURES_DIR/main.sysml" 2>&1)
+set -e
+
+if [ "$cold_exit" -eq 0 ] && [ "$warm_exit" -eq 0 ] && \
+   echo "$warm_output" | grep -q "loaded .*_index.sysml from model cache"; then
+    echo "PASS: warm run loads library file from cache"
+    PASSED=$((PASSED + 1))
+else
+    echo "FAIL: warm run should load _index.sysml from the model cache"
+    echo "  Output: $warm_output"
+    FAILED=$((FAILED + 1))
+fi
+
+if [ "$cold_output" = "$warm_json" ]; then
+    echo "PASS: cached run output matches uncached run"
+    PASSED=$((PASSED + 1))
+else
+    echo "FAIL: cached run output differs from uncached run"
+    FAILED=$((FAILED + 1))
+fi
+
+# Package discovery results are indexed per directory. Use a copy with
+# old timestamps so the index is trusted on the next run.
+INDEX_DIR="$CACHE_DIR/tree"
+cp -R "$FIXTURES_DIR" "$INDEX_DIR"
+find "$INDEX_DIR" -exec touch -d '1 hour ago' {} +
+set +e
+"$SYSML2" --cache-dir "$CACHE_DIR/smc" "$INDEX_DIR/main.sysml" >/dev/null 2>&1
+index_output=$("$SYSML2" -v --cache-dir "$CACHE_DIR/smc" "$INDEX_DIR/main.sysml" 2>&1)
+index_exit=$?
+set -e
+
+if [ "$index_exit" -eq 0 ] && \
+   echo "$index_output" | grep -q "using cached package index" && \
+   echo "$index_output" | grep -q "found 'SystemBehavior' via package map"; then
+    echo "PASS: warm run reuses the package index"
+    PASSED=$((PASSED + 1))
+else
+    echo "FAIL: warm run should resolve SystemBehavior from the package index"
+    echo "  Output: $index_output"
+    FAILED=$((FAILED + 1))
+fi
+
+# Adding a file changes the directory and forces a rescan
+echo 'package Extra;' > "$INDEX_DIR/extra.sysml"
+set +e
+rescan_output=$("$SYSML2" -v --cache-dir "$CACHE_DIR/smc" "$INDEX_DIR/main.sysml" 2>&1)
+set -e
+if echo "$rescan_output" | grep -q "registered package 'Extra'"; then
+    echo "PASS: changed directory is rescanned"
+    PASSED=$((PASSED + 1))
+else
+    echo "FAIL: changed directory should be rescanned"
+    echo "  Output: $rescan_output"
+    FAILED=$((FAILED + 1))
+fi
+rm -rf "$CACHE_DIR/smc" "$INDEX_DIR"
+
+run_test "--clear-cache without files exits cleanly" 0 "$SYSML2" --cache-dir "$CACHE_DIR" --clear-cache
+if ! ls "$CACHE_DIR"/*.smc >/dev/null 2>&1; then
+    echo "PASS: --clear-cache removes cache entries"
+    PASSED=$((PASSED + 1))
+else
+    echo "FAIL: --clear-cache left cache entries behind"
+    FAILED=$((FAILED + 1))
+fi
+run_test "--clear-cache requires --cache-dir" 1 "$SYSML2" --clear-cache
+
 echo ""
 echo "=== Summary ==="
 echo "Passed: $PASSED"
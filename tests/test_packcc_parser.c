@@ -55,12 +55,8 @@ int main(int argc, char **argv) {
         .input_len = input_len,
         .input_pos = 0,
         .error_count = 0,
-        .line = 1,
-        .col = 1,
         /* Furthest failure tracking */
         .furthest_pos = 0,
-        .furthest_line = 0,
-        .furthest_col = 0,
         .failed_rule_count = 0,
         .context_rule = NULL,
     };
@@ -89,6 +85,7 @@ int main(int argc, char **argv) {
 
     /* Cleanup */
     sysml2_destroy(parser);
+    sysml2_parser_context_release(&ctx);
     free(input);
 
     return success ? 0 : 1;
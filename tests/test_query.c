@@ -7,6 +7,7 @@
 #include "sysml2/common.h"
 #include "sysml2/arena.h"
 #include "sysml2/ast.h"
+#include "sysml2/intern.h"
 #include "sysml2/query.h"
 
 #include <stdio.h>
@@ -268,6 +269,180 @@ TEST(parent_path_one_level) {
     FIXTURE_ARENA_TEARDOWN();
 }
 
+/* ========== Compiled Matcher Tests ========== */
+
+TEST(matcher_agrees_with_patterns) {
+    FIXTURE_ARENA_SETUP();
+
+    const char *pattern_strs[] = {
+        "Pkg::A", "Pkg::*", "Other::**", "Deep::X::*", "Deep::X::Y::**",
+        "Odd:::*", "'q:a'::*", "Solo",
+    };
+    Sysml2QueryPattern *patterns = sysml2_query_parse_multi(pattern_strs, 8, &arena);
+    Sysml2QueryMatcher *m = sysml2_query_compile(patterns, &arena);
+    ASSERT_NOT_NULL(m);
+
+    const char *ids[] = {
+        "Pkg", "Pkg::A", "Pkg::B", "Pkg::A::C", "Pkg::", "Pkg::B:C",
+        "Other", "Other::X", "Other::X::Y", "Other::", "Other:::X", "OtherX",
+        "Deep", "Deep::X", "Deep::X::Z", "Deep::X::Z::W", "Deep::X::Y",
+        "Deep::X::Y::Q::R", "Odd:", "Odd:::Z", "'q:a'::Z", "'q:a'::Z::W",
+        "Solo", "Solo::A", "::Solo", "Pkg:::A", "",
+    };
+    for (size_t i = 0; i < sizeof(ids) / sizeof(ids[0]); i++) {
+        bool expected = sysml2_query_matches_any(patterns, ids[i]);
+        ASSERT_EQ(sysml2_query_matcher_matches(m, ids[i]), expected);
+    }
+    ASSERT_TRUE(sysml2_query_matcher_matches(m, "Other::X::Y"));
+    ASSERT_FALSE(sysml2_query_matcher_matches(m, "Pkg::A::C"));
+    ASSERT_FALSE(sysml2_query_matcher_matches(m, NULL));
+
+    FIXTURE_ARENA_TEARDOWN();
+}
+
+TEST(matcher_shared_prefixes) {
+    FIXTURE_ARENA_SETUP();
+
+    const char *pattern_strs[] = {"A::B", "A::B::*", "A::C::**"};
+    Sysml2QueryPattern *patterns = sysml2_query_parse_multi(pattern_strs, 3, &arena);
+    Sysml2QueryMatcher *m = sysml2_query_compile(patterns, &arena);
+    ASSERT_NOT_NULL(m);
+    ASSERT_EQ(m->fallback_count, 0);
+
+    ASSERT_TRUE(sysml2_query_matcher_matches(m, "A::B"));
+    ASSERT_TRUE(sysml2_query_matcher_matches(m, "A::B::X"));
+    ASSERT_FALSE(sysml2_query_matcher_matches(m, "A::B::X::Y"));
+    ASSERT_TRUE(sysml2_query_matcher_matches(m, "A::C"));
+    ASSERT_TRUE(sysml2_query_matcher_matches(m, "A::C::X::Y"));
+    ASSERT_FALSE(sysml2_query_matcher_matches(m, "A"));
+    ASSERT_FALSE(sysml2_query_matcher_matches(m, "A::D"));
+
+    FIXTURE_ARENA_TEARDOWN();
+}
+
+/* Elements with interned IDs, linked like a model read from the cache */
+#define PATH_NODE_COUNT 8
+
+static void build_path_model(
+    SysmlSemanticModel *model,
+    SysmlNode *nodes,
+    SysmlNode **node_ptrs,
+    Sysml2Intern *intern
+) {
+    static const char *const ids[PATH_NODE_COUNT][2] = {
+        {"Pkg", NULL},
+        {"Pkg::A", "Pkg"},
+        {"Pkg::A::C", "Pkg::A"},
+        {"Pkg::A::C::D", "Pkg::A::C"},
+        {"Pkg::B", "Pkg"},
+        {"Other::X::Y", "Other::X"},   /* Parent not in the model */
+        {"Pkg::'q:a'", "Pkg"},
+        {"Pkg::'q:a'::Z", "Pkg::'q:a'"},
+    };
+    memset(model, 0, sizeof(*model));
+    memset(nodes, 0, PATH_NODE_COUNT * sizeof(SysmlNode));
+    for (size_t i = 0; i < PATH_NODE_COUNT; i++) {
+        nodes[i].id = sysml2_intern(intern, ids[i][0]);
+        nodes[i].parent_id = ids[i][1] ? sysml2_intern(intern, ids[i][1]) : NULL;
+        nodes[i].kind = SYSML_KIND_PART_USAGE;
+        node_ptrs[i] = &nodes[i];
+    }
+    model->elements = node_ptrs;
+    model->element_count = PATH_NODE_COUNT;
+    ASSERT_TRUE(sysml2_model_link_paths(model));
+}
+
+TEST(link_paths_sets_parents) {
+    FIXTURE_ARENA_SETUP();
+    Sysml2Intern intern;
+    sysml2_intern_init(&intern, &arena);
+
+    SysmlSemanticModel model;
+    SysmlNode nodes[PATH_NODE_COUNT];
+    SysmlNode *node_ptrs[PATH_NODE_COUNT];
+    build_path_model(&model, nodes, node_ptrs, &intern);
+
+    ASSERT_NULL(nodes[0].parent);
+    ASSERT_EQ(nodes[0].depth, 0);
+    ASSERT(nodes[3].parent == &nodes[2]);
+    ASSERT(nodes[2].parent == &nodes[1]);
+    ASSERT_EQ(nodes[3].depth, 3);
+    ASSERT_STR_EQ(sysml2_node_local_id(&nodes[3]), "D");
+    ASSERT_EQ(sysml2_node_parent_length(&nodes[3]), strlen("Pkg::A::C"));
+
+    /* Unlinked: the depth still follows parent_id */
+    ASSERT_NULL(nodes[5].parent);
+    ASSERT_EQ(nodes[5].depth, 2);
+    ASSERT_STR_EQ(sysml2_node_local_id(&nodes[5]), "Y");
+
+    sysml2_intern_destroy(&intern);
+    FIXTURE_ARENA_TEARDOWN();
+}
+
+TEST(matcher_node_agrees_with_ids) {
+    FIXTURE_ARENA_SETUP();
+    Sysml2Intern intern;
+    sysml2_intern_init(&intern, &arena);
+
+    SysmlSemanticModel model;
+    SysmlNode nodes[PATH_NODE_COUNT];
+    SysmlNode *node_ptrs[PATH_NODE_COUNT];
+    build_path_model(&model, nodes, node_ptrs, &intern);
+
+    const char *pattern_sets[][3] = {
+        {"Pkg::*", "Other::X::Y", NULL},
+        {"Pkg::A::**", "Pkg::B", NULL},
+        {"Pkg::A::C::*", "Other::**", "Pkg"},
+        {"Pkg::'q:a'::*", NULL, NULL},
+        {"Pkg::**", NULL, NULL},
+    };
+    for (size_t s = 0; s < sizeof(pattern_sets) / sizeof(pattern_sets[0]); s++) {
+        size_t n = 0;
+        while (n < 3 && pattern_sets[s][n]) n++;
+        Sysml2QueryPattern *patterns = sysml2_query_parse_multi(pattern_sets[s], n, &arena);
+        Sysml2QueryMatcher *m = sysml2_query_compile(patterns, &arena);
+        ASSERT_NOT_NULL(m);
+        for (size_t i = 0; i < PATH_NODE_COUNT; i++) {
+            ASSERT_EQ(sysml2_query_matcher_matches_node(m, &nodes[i]),
+                      sysml2_query_matcher_matches(m, nodes[i].id));
+        }
+    }
+
+    sysml2_intern_destroy(&intern);
+    FIXTURE_ARENA_TEARDOWN();
+}
+
+TEST(ancestors_follow_parents) {
+    FIXTURE_ARENA_SETUP();
+    Sysml2Intern intern;
+    sysml2_intern_init(&intern, &arena);
+
+    SysmlSemanticModel model;
+    SysmlNode nodes[PATH_NODE_COUNT];
+    SysmlNode *node_ptrs[PATH_NODE_COUNT];
+    build_path_model(&model, nodes, node_ptrs, &intern);
+    SysmlSemanticModel *models[] = {&model};
+
+    const char *pattern_strs[] = {"Pkg::A::C::D", "Pkg::B", "Other::X::Y"};
+    Sysml2QueryPattern *patterns = sysml2_query_parse_multi(pattern_strs, 3, &arena);
+    Sysml2QueryResult *result = sysml2_query_execute(patterns, models, 1, &arena);
+    ASSERT_NOT_NULL(result);
+    ASSERT_EQ(result->element_count, 3);
+
+    const char **ancestors = NULL;
+    size_t count = 0;
+    sysml2_query_get_ancestors(result, models, 1, &arena, &ancestors, &count);
+    ASSERT_EQ(count, 5);
+    ASSERT_STR_EQ(ancestors[0], "Pkg::A::C");
+    ASSERT_STR_EQ(ancestors[1], "Pkg::A");
+    ASSERT_STR_EQ(ancestors[2], "Pkg");
+    ASSERT_STR_EQ(ancestors[3], "Other::X");
+    ASSERT_STR_EQ(ancestors[4], "Other");
+
+    sysml2_intern_destroy(&intern);
+    FIXTURE_ARENA_TEARDOWN();
+}
+
 /* ========== Query Execution Tests ========== */
 
 TEST(execute_exact_query) {
@@ -414,6 +589,235 @@ TEST(result_contains) {
     FIXTURE_ARENA_TEARDOWN();
 }
 
+TEST(execute_filters_relationships) {
+    FIXTURE_ARENA_SETUP();
+
+    SysmlSemanticModel model = {0};
+    SysmlNode nodes[3] = {
+        {.id = "Pkg", .name = "Pkg", .kind = SYSML_KIND_PACKAGE},
+        {.id = "Pkg::A", .name = "A", .kind = SYSML_KIND_PART_DEF, .parent_id = "Pkg"},
+        {.id = "Other", .name = "Other", .kind = SYSML_KIND_PART_DEF},
+    };
+    SysmlNode *node_ptrs[3] = {&nodes[0], &nodes[1], &nodes[2]};
+    model.elements = node_ptrs;
+    model.element_count = 3;
+
+    SysmlRelationship rels[2] = {
+        {.id = "r1", .kind = SYSML_KIND_REL_SPECIALIZATION, .source = "Pkg::A", .target = "Pkg"},
+        {.id = "r2", .kind = SYSML_KIND_REL_SPECIALIZATION, .source = "Pkg::A", .target = "Other"},
+    };
+    SysmlRelationship *rel_ptrs[2] = {&rels[0], &rels[1]};
+    model.relationships = rel_ptrs;
+    model.relationship_count = 2;
+
+    SysmlSemanticModel *models[] = {&model};
+
+    Sysml2QueryPattern *p = sysml2_query_parse("Pkg::**", &arena);
+    Sysml2QueryResult *result = sysml2_query_execute(p, models, 1, &arena);
+
+    ASSERT_NOT_NULL(result);
+    ASSERT_EQ(result->element_count, 2);
+    ASSERT_EQ(result->relationship_count, 1);
+    ASSERT_STR_EQ(result->relationships[0]->id, "r1");
+
+    FIXTURE_ARENA_TEARDOWN();
+}
+
+/* ========== ID Set Tests ========== */
+
+TEST(id_set_add_contains) {
+    FIXTURE_ARENA_SETUP();
+
+    Sysml2IdSet set = {0};
+    ASSERT_FALSE(sysml2_id_set_contains(&set, "A"));
+
+    ASSERT_TRUE(sysml2_id_set_add(&set, "A", &arena));
+    ASSERT_TRUE(sysml2_id_set_add(&set, "A::B", &arena));
+    ASSERT_TRUE(sysml2_id_set_add(&set, "A", &arena));
+    ASSERT_EQ(set.count, 2);
+
+    /* Lookup is by content, not by pointer */
+    char copy[] = "A::B";
+    ASSERT_TRUE(sysml2_id_set_contains(&set, copy));
+    ASSERT_FALSE(sysml2_id_set_contains(&set, "A::C"));
+    ASSERT_FALSE(sysml2_id_set_contains(&set, NULL));
+
+    FIXTURE_ARENA_TEARDOWN();
+}
+
+TEST(id_set_growth) {
+    FIXTURE_ARENA_SETUP();
+
+    Sysml2IdSet set = {0};
+    const char *ids[1000];
+    for (int i = 0; i < 1000; i++) {
+        ids[i] = sysml2_arena_sprintf(&arena, "Pkg::E%d", i);
+        ASSERT_TRUE(sysml2_id_set_add(&set, ids[i], &arena));
+    }
+    ASSERT_EQ(set.count, 1000);
+    ASSERT(set.count * 4 <= set.capacity * 3);
+
+    char buf[32];
+    for (int i = 0; i < 1000; i++) {
+        snprintf(buf, sizeof(buf), "Pkg::E%d", i);
+        ASSERT_TRUE(sysml2_id_set_contains(&set, buf));
+    }
+    ASSERT_FALSE(sysml2_id_set_contains(&set, "Pkg::E1000"));
+
+    FIXTURE_ARENA_TEARDOWN();
+}
+
+/* ========== ID Map Tests ========== */
+
+TEST(id_map_slot_get) {
+    FIXTURE_ARENA_SETUP();
+    Sysml2Intern intern;
+    sysml2_intern_init(&intern, &arena);
+
+    Sysml2IdMap map = {0};
+    const char *a = sysml2_intern(&intern, "A");
+    ASSERT_NULL(sysml2_id_map_get(&map, a));
+
+    int one = 1, two = 2;
+    Sysml2IdMapSlot *slot = sysml2_id_map_slot(&map, a, &arena);
+    ASSERT_NOT_NULL(slot);
+    ASSERT_NULL(slot->value);
+    slot->value = &one;
+    slot = sysml2_id_map_slot(&map, sysml2_intern(&intern, "A::B"), &arena);
+    slot->value = &two;
+    ASSERT_EQ(sysml2_id_map_slot(&map, a, &arena)->value, &one);
+    ASSERT_EQ(map.count, 2);
+
+    /* Keys are interned, so the same string finds the same slot */
+    ASSERT_EQ(sysml2_id_map_get(&map, sysml2_intern(&intern, "A::B")), &two);
+    ASSERT_NULL(sysml2_id_map_get(&map, sysml2_intern(&intern, "A::C")));
+    ASSERT_NULL(sysml2_id_map_get(&map, NULL));
+
+    sysml2_intern_destroy(&intern);
+    FIXTURE_ARENA_TEARDOWN();
+}
+
+TEST(id_map_growth) {
+    FIXTURE_ARENA_SETUP();
+    Sysml2Intern intern;
+    sysml2_intern_init(&intern, &arena);
+
+    Sysml2IdMap map = {0};
+    const char *ids[1000];
+    char buf[32];
+    for (int i = 0; i < 1000; i++) {
+        snprintf(buf, sizeof(buf), "Pkg::E%d", i);
+        ids[i] = sysml2_intern(&intern, buf);
+        Sysml2IdMapSlot *slot = sysml2_id_map_slot(&map, ids[i], &arena);
+        ASSERT_NOT_NULL(slot);
+        slot->value = (void *)ids[i];
+    }
+    ASSERT_EQ(map.count, 1000);
+    ASSERT(map.count * 4 <= map.capacity * 3);
+
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_EQ(sysml2_id_map_get(&map, ids[i]), ids[i]);
+    }
+    ASSERT_NULL(sysml2_id_map_get(&map, sysml2_intern(&intern, "Pkg::E1000")));
+
+    sysml2_intern_destroy(&intern);
+    FIXTURE_ARENA_TEARDOWN();
+}
+
+/* ========== Reference Index Tests ========== */
+
+TEST(ref_index_users_in_order) {
+    FIXTURE_ARENA_SETUP();
+    Sysml2Intern intern;
+    sysml2_intern_init(&intern, &arena);
+
+    SysmlNode a = {.id = sysml2_intern(&intern, "Pkg::A"), .name = "A"};
+    SysmlNode b = {.id = sysml2_intern(&intern, "Pkg::B"), .name = "B"};
+    const char *t = sysml2_intern(&intern, "Pkg::T");
+    Sysml2RefIndex index = {0};
+    ASSERT_NULL(sysml2_ref_index_users(&index, t));
+
+    ASSERT_TRUE(sysml2_ref_index_add(&index, t, &a, SYSML2_REF_TYPED_BY, &arena));
+    ASSERT_TRUE(sysml2_ref_index_add(&index, t, &b, SYSML2_REF_SPECIALIZES, &arena));
+    char buf[32];
+    for (int i = 0; i < 200; i++) {
+        snprintf(buf, sizeof(buf), "Pkg::E%d", i);
+        const char *id = sysml2_intern(&intern, buf);
+        ASSERT_TRUE(sysml2_ref_index_add(&index, id, &a, SYSML2_REF_REFERENCES, &arena));
+    }
+    ASSERT_EQ(index.users.count, 201);
+    ASSERT_EQ(index.edge_count, 202);
+
+    /* Users come back in the order added */
+    const Sysml2RefEdge *e = sysml2_ref_index_users(&index, t);
+    ASSERT_NOT_NULL(e);
+    ASSERT_EQ(e->user, &a);
+    ASSERT_EQ(e->kind, SYSML2_REF_TYPED_BY);
+    ASSERT_NOT_NULL(e->next);
+    ASSERT_EQ(e->next->user, &b);
+    ASSERT_NULL(e->next->next);
+    ASSERT_NOT_NULL(sysml2_ref_index_users(&index, sysml2_intern(&intern, "Pkg::E199")));
+    ASSERT_NULL(sysml2_ref_index_users(&index, sysml2_intern(&intern, "Pkg::E200")));
+
+    sysml2_intern_destroy(&intern);
+    FIXTURE_ARENA_TEARDOWN();
+}
+
+TEST(query_users_depth) {
+    FIXTURE_ARENA_SETUP();
+    Sysml2Intern intern;
+    sysml2_intern_init(&intern, &arena);
+    const char *ida = sysml2_intern(&intern, "Pkg::A");
+    const char *idb = sysml2_intern(&intern, "Pkg::B");
+    const char *idc = sysml2_intern(&intern, "Pkg::C");
+    const char *idd = sysml2_intern(&intern, "Pkg::D");
+
+    /* C uses B, B uses A, A uses C (a cycle); D uses A */
+    SysmlSemanticModel model = {0};
+    SysmlNode nodes[4] = {
+        {.id = ida, .name = "A", .kind = SYSML_KIND_PART_DEF},
+        {.id = idb, .name = "B", .kind = SYSML_KIND_PART_DEF},
+        {.id = idc, .name = "C", .kind = SYSML_KIND_PART_DEF},
+        {.id = idd, .name = "D", .kind = SYSML_KIND_PART_USAGE},
+    };
+    SysmlNode *node_ptrs[4] = {&nodes[0], &nodes[1], &nodes[2], &nodes[3]};
+    model.elements = node_ptrs;
+    model.element_count = 4;
+    SysmlSemanticModel *models[] = {&model};
+
+    Sysml2RefIndex index = {0};
+    sysml2_ref_index_add(&index, idb, &nodes[2], SYSML2_REF_SPECIALIZES, &arena);
+    sysml2_ref_index_add(&index, ida, &nodes[1], SYSML2_REF_SPECIALIZES, &arena);
+    sysml2_ref_index_add(&index, idc, &nodes[0], SYSML2_REF_SPECIALIZES, &arena);
+    sysml2_ref_index_add(&index, ida, &nodes[3], SYSML2_REF_TYPED_BY, &arena);
+
+    Sysml2QueryPattern *p = sysml2_query_parse("Pkg::A", &arena);
+
+    Sysml2QueryResult *result = sysml2_query_users(p, &index, 1, models, 1, &arena);
+    ASSERT_NOT_NULL(result);
+    ASSERT_EQ(result->element_count, 2);
+    ASSERT_STR_EQ(result->elements[0]->id, "Pkg::B");
+    ASSERT_STR_EQ(result->elements[1]->id, "Pkg::D");
+
+    result = sysml2_query_users(p, &index, 2, models, 1, &arena);
+    ASSERT_EQ(result->element_count, 3);
+    ASSERT_STR_EQ(result->elements[2]->id, "Pkg::C");
+
+    /* Unlimited depth stops at the cycle; A is reached as a user of C */
+    result = sysml2_query_users(p, &index, 0, models, 1, &arena);
+    ASSERT_EQ(result->element_count, 4);
+    ASSERT_STR_EQ(result->elements[3]->id, "Pkg::A");
+
+    /* Nothing uses D */
+    p = sysml2_query_parse("Pkg::D", &arena);
+    result = sysml2_query_users(p, &index, 0, models, 1, &arena);
+    ASSERT_NOT_NULL(result);
+    ASSERT_EQ(result->element_count, 0);
+
+    sysml2_intern_destroy(&intern);
+    FIXTURE_ARENA_TEARDOWN();
+}
+
 /* ========== Main ========== */
 
 int main(void) {
@@ -443,12 +847,32 @@ int main(void) {
     RUN_TEST(parent_path_top_level);
     RUN_TEST(parent_path_one_level);
 
+    /* Compiled matcher tests */
+    RUN_TEST(matcher_agrees_with_patterns);
+    RUN_TEST(matcher_shared_prefixes);
+    RUN_TEST(link_paths_sets_parents);
+    RUN_TEST(matcher_node_agrees_with_ids);
+    RUN_TEST(ancestors_follow_parents);
+
     /* Query execution tests */
     RUN_TEST(execute_exact_query);
     RUN_TEST(execute_direct_query);
     RUN_TEST(execute_recursive_query);
     RUN_TEST(execute_multi_pattern_query);
     RUN_TEST(result_contains);
+    RUN_TEST(execute_filters_relationships);
+
+    /* ID set tests */
+    RUN_TEST(id_set_add_contains);
+    RUN_TEST(id_set_growth);
+
+    /* ID map tests */
+    RUN_TEST(id_map_slot_get);
+    RUN_TEST(id_map_growth);
+
+    /* Reference index tests */
+    RUN_TEST(ref_index_users_in_order);
+    RUN_TEST(query_users_depth);
 
     printf("\n%d/%d tests passed.\n", tests_passed, tests_run);
     return tests_passed == tests_run ? 0 : 1;
@@ -0,0 +1,241 @@
+#!/bin/bash
+#
+# Integration test for --serve workspace server mode
+#
+# Tests: load/change/diagnostics/shutdown requests, incremental
+# re-validation of dependents only, syntax errors keeping the previous
+# model, JSON-RPC error replies, freeing replaced models
+#
+# SPDX-License-Identifier: MIT
+
+set -e
+
+PARSER="${1:-./sysml2}"
+WORKDIR=$(mktemp -d)
+trap "rm -rf $WORKDIR" EXIT
+
+# Colors for output
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+NC='\033[0m' # No Color
+
+TESTS_PASSED=0
+TESTS_FAILED=0
+
+# Test helper functions
+pass() {
+    echo -e "${GREEN}PASS${NC}: $1"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+}
+
+fail() {
+    echo -e "${RED}FAIL${NC}: $1"
+    echo "  Expected: $2"
+    echo "  Got:      $3"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+}
+
+assert_contains() {
+    local output="$1"
+    local expected="$2"
+    local testname="$3"
+
+    if echo "$output" | grep -q -- "$expected"; then
+        pass "$testname"
+    else
+        fail "$testname" "contains '$expected'" "not found in: $output"
+    fi
+}
+
+assert_not_contains() {
+    local output="$1"
+    local pattern="$2"
+    local testname="$3"
+
+    if echo "$output" | grep -q -- "$pattern"; then
+        fail "$testname" "should not contain '$pattern'" "found in: $output"
+    else
+        pass "$testname"
+    fi
+}
+
+assert_exit_code() {
+    local actual="$1"
+    local expected="$2"
+    local testname="$3"
+
+    if [ "$actual" -eq "$expected" ]; then
+        pass "$testname"
+    else
+        fail "$testname" "exit code $expected" "exit code $actual"
+    fi
+}
+
+# Response line for the request with the given id
+response() {
+    grep "\"id\":$1," "$WORKDIR/responses.txt" || true
+}
+
+# ============================================================
+# Setup: B depends on A, C is unrelated
+# ============================================================
+cat > "$WORKDIR/a.sysml" << 'EOF'
+package A {
+    part def Engine;
+}
+EOF
+
+cat > "$WORKDIR/b.sysml" << 'EOF'
+package B {
+    import A::*;
+    part car : Engine;
+}
+EOF
+
+cat > "$WORKDIR/c.sysml" << 'EOF'
+package C {
+    part def Wheel;
+}
+EOF
+
+A="$WORKDIR/a.sysml"
+B="$WORKDIR/b.sysml"
+C="$WORKDIR/c.sysml"
+
+cat > "$WORKDIR/requests.txt" << EOF
+{"jsonrpc":"2.0","id":1,"method":"load","params":{"files":["$A","$B","$C"]}}
+{"jsonrpc":"2.0","id":2,"method":"change","params":{"path":"$A","text":"package A {\n    part def Motor;\n}\n"}}
+{"jsonrpc":"2.0","id":3,"method":"change","params":{"path":"$A","text":"package A { part def ; "}}
+{"jsonrpc":"2.0","id":4,"method":"diagnostics","params":{"path":"$B"}}
+{"jsonrpc":"2.0","id":5,"method":"change","params":{"path":"$A"}}
+{"jsonrpc":"2.0","id":6,"method":"frobnicate"}
+this is not json
+{"jsonrpc":"2.0","id":7,"method":"diagnostics","params":{"path":"$WORKDIR/missing.sysml"}}
+
+{"jsonrpc":"2.0","id":8,"method":"shutdown"}
+{"jsonrpc":"2.0","id":9,"method":"diagnostics"}
+EOF
+
+# ============================================================
+# Test 1: Session runs to shutdown
+# ============================================================
+echo ""
+echo "=== Test 1: Session ==="
+
+set +e
+"$PARSER" --serve < "$WORKDIR/requests.txt" > "$WORKDIR/responses.txt" 2> "$WORKDIR/stderr.txt"
+EXIT_CODE=$?
+set -e
+assert_exit_code $EXIT_CODE 0 "Server exits cleanly after shutdown"
+assert_not_contains "$(cat "$WORKDIR/responses.txt")" '"id":9,' "No requests handled after shutdown"
+
+# ============================================================
+# Test 2: Initial load validates everything
+# ============================================================
+echo ""
+echo "=== Test 2: load ==="
+
+R=$(response 1)
+assert_contains "$R" '"reparsed":3,"validated":3' "load parses and validates all files"
+assert_contains "$R" "\"path\":\"$C\"" "load reports every file"
+assert_not_contains "$R" '"code":"E' "Clean workspace has no diagnostics"
+
+# ============================================================
+# Test 3: A change re-validates only dependents
+# ============================================================
+echo ""
+echo "=== Test 3: change ==="
+
+R=$(response 2)
+assert_contains "$R" '"reparsed":1,"validated":2' "change validates the file and its dependent"
+assert_contains "$R" '"code":"E3001"' "Dependent reports the now-undefined type"
+assert_contains "$R" "\"path\":\"$B\"" "Dependent is reported"
+assert_not_contains "$R" "\"path\":\"$C\"" "Unrelated file is not re-validated"
+
+# ============================================================
+# Test 4: Syntax errors keep the previous model
+# ============================================================
+echo ""
+echo "=== Test 4: syntax error ==="
+
+R=$(response 3)
+assert_contains "$R" '"reparsed":1,"validated":0' "Broken edit re-validates nothing"
+assert_contains "$R" '"syntax":"' "Broken edit reports parser output"
+
+R=$(response 4)
+assert_contains "$R" '"code":"E3001"' "diagnostics returns stored results"
+assert_not_contains "$R" '"reparsed"' "diagnostics does no work"
+
+# ============================================================
+# Test 5: Reloading from disk clears the error
+# ============================================================
+echo ""
+echo "=== Test 5: change from disk ==="
+
+R=$(response 5)
+assert_contains "$R" '"reparsed":1,"validated":2' "Reload validates the file and its dependent"
+assert_contains "$R" '"syntax":null' "Reload clears the syntax error"
+assert_not_contains "$R" '"code":"E' "Restored definition resolves again"
+
+# ============================================================
+# Test 6: Error replies
+# ============================================================
+echo ""
+echo "=== Test 6: errors ==="
+
+assert_contains "$(response 6)" '"code":-32601' "Unknown method is rejected"
+assert_contains "$(cat "$WORKDIR/responses.txt")" '"id":null,"error":{"code":-32700' "Malformed request is a parse error"
+assert_contains "$(response 7)" '"code":-32602' "Unknown file is rejected"
+assert_contains "$(response 8)" '"result":null' "shutdown is acknowledged"
+
+LINES=$(wc -l < "$WORKDIR/responses.txt")
+assert_exit_code "$LINES" 9 "One response per non-blank request"
+
+# ============================================================
+# Test 7: --serve takes no file arguments
+# ============================================================
+echo ""
+echo "=== Test 7: incompatible flags ==="
+
+set +e
+"$PARSER" --serve "$A" < /dev/null > /dev/null 2>&1
+EXIT_CODE=$?
+set -e
+assert_exit_code $EXIT_CODE 1 "--serve with file arguments fails"
+
+# ============================================================
+# Test 8: Replaced models are freed
+# ============================================================
+echo ""
+echo "=== Test 8: memory across changes ==="
+
+# One model of D fits well within the limit; 300 kept models would not
+TEXT="package D {"
+for i in $(seq 1 300); do TEXT="$TEXT\\n    part def P$i;"; done
+TEXT="$TEXT\\n}\\n"
+D="$WORKDIR/d.sysml"
+{
+    for i in $(seq 1 300); do
+        echo "{\"jsonrpc\":\"2.0\",\"id\":$i,\"method\":\"change\",\"params\":{\"path\":\"$D\",\"text\":\"$TEXT\"}}"
+    done
+} > "$WORKDIR/changes.txt"
+
+"$PARSER" --serve --memory-limit 16M < "$WORKDIR/changes.txt" > "$WORKDIR/responses.txt" 2>/dev/null || true
+assert_contains "$(response 300)" '"syntax":null' "Repeated changes stay within the memory limit"
+
+# ============================================================
+# Summary
+# ============================================================
+echo ""
+echo "=== Test Summary ==="
+echo "Passed: $TESTS_PASSED"
+echo "Failed: $TESTS_FAILED"
+echo ""
+
+if [ $TESTS_FAILED -gt 0 ]; then
+    echo -e "${RED}Some tests failed!${NC}"
+    exit 1
+else
+    echo -e "${GREEN}All tests passed!${NC}"
+    exit 0
+fi
@@ -148,6 +148,48 @@ TEST(sysml_write_nested_packages) {
     FIXTURE_TEARDOWN();
 }
 
+TEST(sysml_write_interleaved_scopes) {
+    FIXTURE_SETUP();
+
+    const char *input =
+        "package A {\n"
+        "    import B::*;\n"
+        "    part def X { attribute x1; }\n"
+        "    enum def Color { enum red; green; }\n"
+        "}\n"
+        "package B {\n"
+        "    alias Y for A::X;\n"
+        "    part def Z { attribute z1; attribute z2; }\n"
+        "}\n";
+
+    SysmlSemanticModel *model = parse_sysml_string(&arena, &intern, input);
+    ASSERT_NOT_NULL(model);
+
+    char *expected = NULL;
+    ASSERT_EQ(sysml2_sysml_write_string(model, &expected), SYSML2_OK);
+    ASSERT_NOT_NULL(expected);
+
+    /* Scope members are gathered per parent, not by model position */
+    for (size_t i = 0, j = model->element_count - 1; i < j; i++, j--) {
+        SysmlNode *tmp = model->elements[i];
+        model->elements[i] = model->elements[j];
+        model->elements[j] = tmp;
+    }
+
+    char *output = NULL;
+    ASSERT_EQ(sysml2_sysml_write_string(model, &output), SYSML2_OK);
+    ASSERT_NOT_NULL(output);
+    ASSERT_STR_EQ(output, expected);
+    ASSERT(strstr(output, "import B::*;") != NULL);
+    ASSERT(strstr(output, "alias Y for A::X;") != NULL);
+    ASSERT(strstr(output, "enum red;") != NULL);
+    ASSERT(strstr(output, "enum green;") == NULL);
+
+    free(expected);
+    free(output);
+    FIXTURE_TEARDOWN();
+}
+
 /* ========== Specialization Tests ========== */
 
 TEST(sysml_write_specialization) {
@@ -369,6 +411,54 @@ TEST(sysml_write_line_comment) {
     FIXTURE_TEARDOWN();
 }
 
+TEST(sysml_write_trimmed_model_drops_trivia) {
+    FIXTURE_SETUP();
+
+    const char *input =
+        "package TestPkg {\n"
+        "    // This is a comment\n"
+        "    part def MyPart {\n"
+        "        doc /* Part documentation */\n"
+        "    }\n"
+        "}\n";
+
+    /* trim_models is for runs that write no SysML; models come out bare */
+    Sysml2CliOptions options = {0};
+    options.parse_only = true;
+    options.no_resolve = true;
+    options.trim_models = true;
+
+    Sysml2PipelineContext *ctx = sysml2_pipeline_create(&arena, &intern, &options);
+    ASSERT_NOT_NULL(ctx);
+    SysmlSemanticModel *model = NULL;
+    Sysml2Result result = sysml2_pipeline_process_input(
+        ctx, "<test>", input, strlen(input), &model
+    );
+    sysml2_pipeline_destroy(ctx);
+    ASSERT_EQ(result, SYSML2_OK);
+    ASSERT_NOT_NULL(model);
+
+    char *output = NULL;
+    result = sysml2_sysml_write_string(model, &output);
+    ASSERT_EQ(result, SYSML2_OK);
+    ASSERT_NOT_NULL(output);
+    ASSERT(strstr(output, "part def MyPart") != NULL);
+    ASSERT_NULL(strstr(output, "This is a comment"));
+    ASSERT_NULL(strstr(output, "Part documentation"));
+    free(output);
+
+    /* The same input keeps both by default */
+    model = parse_sysml_string(&arena, &intern, input);
+    ASSERT_NOT_NULL(model);
+    result = sysml2_sysml_write_string(model, &output);
+    ASSERT_EQ(result, SYSML2_OK);
+    ASSERT(strstr(output, "This is a comment") != NULL);
+    ASSERT(strstr(output, "Part documentation") != NULL);
+    free(output);
+
+    FIXTURE_TEARDOWN();
+}
+
 /* ========== Indentation Tests ========== */
 
 TEST(sysml_write_indentation) {
@@ -397,6 +487,45 @@ TEST(sysml_write_indentation) {
     FIXTURE_TEARDOWN();
 }
 
+TEST(sysml_write_file_matches_string) {
+    FIXTURE_SETUP();
+
+    /* Large enough to grow the output buffer several times */
+    size_t cap = 64 * 1024;
+    char *input = malloc(cap);
+    ASSERT_NOT_NULL(input);
+    size_t len = (size_t)snprintf(input, cap, "package Big {\n");
+    for (int i = 0; i < 300; i++) {
+        len += (size_t)snprintf(input + len, cap - len,
+                                "    // def %d\n    part def P%d { part q%d { attribute a; } }\n",
+                                i, i, i);
+    }
+    snprintf(input + len, cap - len, "}\n");
+
+    SysmlSemanticModel *model = parse_sysml_string(&arena, &intern, input);
+    free(input);
+    ASSERT_NOT_NULL(model);
+
+    char *text = NULL;
+    ASSERT_EQ(sysml2_sysml_write_string(model, &text), SYSML2_OK);
+    ASSERT_NOT_NULL(text);
+    ASSERT(strlen(text) > 16 * 1024);
+    ASSERT(strstr(text, "    part def P299 {\n        part q299 {\n            attribute a;\n") != NULL);
+
+    char *file_text = NULL;
+    size_t file_length = 0;
+    FILE *out = open_memstream(&file_text, &file_length);
+    ASSERT_NOT_NULL(out);
+    ASSERT_EQ(sysml2_sysml_write(model, out), SYSML2_OK);
+    fclose(out);
+    ASSERT_EQ(file_length, strlen(text));
+    ASSERT_STR_EQ(file_text, text);
+
+    free(file_text);
+    free(text);
+    FIXTURE_TEARDOWN();
+}
+
 /* ========== Error Handling Tests ========== */
 
 TEST(sysml_write_null_model) {
@@ -2339,6 +2468,7 @@ int main(void) {
     RUN_TEST(sysml_write_empty_package);
     RUN_TEST(sysml_write_package_with_part_def);
     RUN_TEST(sysml_write_nested_packages);
+    RUN_TEST(sysml_write_interleaved_scopes);
 
     /* Specialization */
     RUN_TEST(sysml_write_specialization);
@@ -2355,11 +2485,13 @@ int main(void) {
 
     /* Comments */
     RUN_TEST(sysml_write_line_comment);
+    RUN_TEST(sysml_write_trimmed_model_drops_trivia);
 
     /* Indentation */
     RUN_TEST(sysml_write_indentation);
 
     /* Error handling */
+    RUN_TEST(sysml_write_file_matches_string);
     RUN_TEST(sysml_write_null_model);
     RUN_TEST(sysml_write_null_output);
 
@@ -11,6 +11,7 @@
 #include "sysml2/ast_builder.h"
 #include "sysml2/diagnostic.h"
 #include "sysml2/validator.h"
+#include "sysml2/utils.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -161,6 +162,48 @@ TEST(symtab_add_symbol) {
     FIXTURE_TEARDOWN();
 }
 
+TEST(symtab_small_and_large_scopes) {
+    FIXTURE_SETUP();
+
+    Sysml2SymbolTable symtab;
+    sysml2_symtab_init(&symtab, &arena, &intern);
+
+    /* Scopes hold no member storage until something is added */
+    Sysml2Scope *leaf = sysml2_symtab_get_or_create_scope(&symtab, "Pkg::Leaf");
+    ASSERT_NULL(leaf->symbols);
+    ASSERT_NULL(sysml2_symtab_lookup(leaf, "x"));
+
+    /* Grow past the inline array and the linear-scan threshold */
+    Sysml2Scope *scope = sysml2_symtab_get_or_create_scope(&symtab, "Pkg");
+    Sysml2Symbol *syms[300];
+    char name[32], qid[48];
+    for (int i = 0; i < 300; i++) {
+        snprintf(name, sizeof(name), "m%d", i);
+        snprintf(qid, sizeof(qid), "Pkg::m%d", i);
+        syms[i] = sysml2_symtab_add(&symtab, scope, name, qid, NULL);
+        ASSERT_NOT_NULL(syms[i]);
+        if (i == SYSML_SYMTAB_INLINE_SYMBOLS - 1) {
+            ASSERT_EQ(scope->symbols, scope->inline_symbols);
+            ASSERT_NULL(scope->symbol_slots);
+        }
+    }
+    ASSERT_EQ(scope->symbol_count, 300);
+    ASSERT_NOT_NULL(scope->symbol_slots);
+
+    /* Every member stays reachable and keeps its address */
+    for (int i = 0; i < 300; i++) {
+        snprintf(name, sizeof(name), "m%d", i);
+        ASSERT_EQ(sysml2_symtab_lookup(scope, name), syms[i]);
+        ASSERT_EQ(scope->symbols[i], syms[i]);
+    }
+    ASSERT_NULL(sysml2_symtab_lookup(scope, "m300"));
+    ASSERT_EQ(sysml2_symtab_add(&symtab, scope, "m7", "Pkg::m7", NULL), syms[7]);
+    ASSERT_EQ(sysml2_symtab_resolve(&symtab, leaf, "m250"), syms[250]);
+
+    sysml2_symtab_destroy(&symtab);
+    FIXTURE_TEARDOWN();
+}
+
 TEST(symtab_duplicate_returns_existing) {
     FIXTURE_SETUP();
 
@@ -237,6 +280,108 @@ TEST(symtab_resolve_qualified) {
     FIXTURE_TEARDOWN();
 }
 
+TEST(symtab_resolve_cache_invalidation) {
+    FIXTURE_SETUP();
+
+    Sysml2SymbolTable symtab;
+    sysml2_symtab_init(&symtab, &arena, &intern);
+
+    Sysml2Scope *a = sysml2_symtab_get_or_create_scope(&symtab, "A");
+    Sysml2Scope *b = sysml2_symtab_get_or_create_scope(&symtab, "B");
+
+    /* Misses are cached until a symbol is added */
+    ASSERT_NULL(sysml2_symtab_resolve(&symtab, b, "Engine"));
+    ASSERT_NULL(sysml2_symtab_resolve(&symtab, b, "Engine"));
+    Sysml2Symbol *engine = sysml2_symtab_add(&symtab, a, "Engine", "A::Engine", NULL);
+    ASSERT_NULL(sysml2_symtab_resolve(&symtab, b, "Engine"));
+
+    /* ... or an import */
+    sysml2_symtab_add_import(&symtab, b, "A", SYSML_KIND_IMPORT_ALL);
+    ASSERT_EQ(sysml2_symtab_resolve(&symtab, b, "Engine"), engine);
+    ASSERT_EQ(sysml2_symtab_resolve(&symtab, b, "Engine"), engine);
+
+    sysml2_symtab_destroy(&symtab);
+    FIXTURE_TEARDOWN();
+}
+
+TEST(symtab_resolve_long_import_chain) {
+    FIXTURE_SETUP();
+
+    Sysml2SymbolTable symtab;
+    sysml2_symtab_init(&symtab, &arena, &intern);
+
+    /* P0 imports P1::*, ..., P63 imports P0::* (a cycle); P40 defines X */
+    enum { CHAIN = 64 };
+    char id[16], target[16];
+    Sysml2Scope *first = NULL;
+    for (int i = 0; i < CHAIN; i++) {
+        snprintf(id, sizeof(id), "P%d", i);
+        snprintf(target, sizeof(target), "P%d", (i + 1) % CHAIN);
+        Sysml2Scope *scope = sysml2_symtab_get_or_create_scope(&symtab, id);
+        sysml2_symtab_add_import(&symtab, scope, target, SYSML_KIND_IMPORT_ALL);
+        if (i == 40) sysml2_symtab_add(&symtab, scope, "X", "P40::X", NULL);
+        if (i == 0) first = scope;
+    }
+
+    Sysml2Symbol *found = sysml2_symtab_resolve(&symtab, first, "X");
+    ASSERT_NOT_NULL(found);
+    ASSERT_STR_EQ(found->qualified_id, "P40::X");
+
+    /* The cycle terminates for names defined nowhere */
+    ASSERT_NULL(sysml2_symtab_resolve(&symtab, first, "Missing"));
+
+    sysml2_symtab_destroy(&symtab);
+    FIXTURE_TEARDOWN();
+}
+
+TEST(symtab_overlay_on_frozen_table) {
+    FIXTURE_SETUP();
+
+    /* Base: Pkg::Engine, with Pkg::* imported at the root */
+    Sysml2SymbolTable base;
+    sysml2_symtab_init(&base, &arena, &intern);
+    sysml2_symtab_add(&base, base.root_scope, "Pkg", "Pkg", NULL);
+    Sysml2Scope *base_pkg = sysml2_symtab_get_or_create_scope(&base, "Pkg");
+    Sysml2Symbol *engine = sysml2_symtab_add(&base, base_pkg, "Engine", "Pkg::Engine", NULL);
+    sysml2_symtab_add_import(&base, base.root_scope, "Pkg", SYSML_KIND_IMPORT_ALL);
+    sysml2_symtab_freeze(&base);
+    ASSERT_NULL(sysml2_symtab_add(&base, base_pkg, "Late", "Pkg::Late", NULL));
+
+    Sysml2SymbolTable overlay;
+    sysml2_symtab_init_overlay(&overlay, &base, &arena, &intern);
+
+    /* New scopes resolve into the frozen ones */
+    Sysml2Scope *app = sysml2_symtab_get_or_create_scope(&overlay, "App");
+    ASSERT_EQ(sysml2_symtab_resolve(&overlay, app, "Engine"), engine);
+    ASSERT_EQ(sysml2_symtab_resolve(&overlay, app, "Pkg::Engine"), engine);
+
+    /* Contributions to a frozen package go to its shadow */
+    Sysml2Scope *pkg = sysml2_symtab_get_or_create_scope(&overlay, "Pkg");
+    ASSERT_EQ(pkg, base_pkg);
+    Sysml2Symbol *wheel = sysml2_symtab_add(&overlay, pkg, "Wheel", "Pkg::Wheel", NULL);
+    ASSERT_NOT_NULL(wheel);
+    ASSERT_EQ(overlay.shadow_count, 1);
+    ASSERT_EQ(sysml2_symtab_add(&overlay, pkg, "Engine", "Pkg::Engine", NULL), engine);
+    ASSERT_EQ(sysml2_symtab_resolve(&overlay, app, "Wheel"), wheel);
+    ASSERT_EQ(sysml2_symtab_resolve(&overlay, app, "Engine"), engine);
+
+    /* ... and leave the base as it was */
+    ASSERT_NULL(sysml2_symtab_lookup(base_pkg, "Wheel"));
+    ASSERT_NULL(sysml2_symtab_resolve(&base, base.root_scope, "Wheel"));
+
+    sysml2_symtab_destroy(&overlay);
+
+    /* A second overlay starts from the base alone */
+    sysml2_symtab_init_overlay(&overlay, &base, &arena, &intern);
+    app = sysml2_symtab_get_or_create_scope(&overlay, "App");
+    ASSERT_NULL(sysml2_symtab_resolve(&overlay, app, "Wheel"));
+    ASSERT_EQ(sysml2_symtab_resolve(&overlay, app, "Engine"), engine);
+
+    sysml2_symtab_destroy(&overlay);
+    sysml2_symtab_destroy(&base);
+    FIXTURE_TEARDOWN();
+}
+
 /* ========== Type Compatibility Tests ========== */
 
 TEST(type_compat_part_def) {
@@ -485,6 +630,85 @@ TEST(validate_e3005_circular_indirect) {
     test_ctx_destroy(&ctx);
 }
 
+TEST(validate_e3005_reports_each_cycle_member_once) {
+    TestContext ctx;
+    test_ctx_init(&ctx);
+
+    /* Tail :> N0, N0 :> N1 :> ... :> N299 :> N0, plus X :> Y :> X.
+     * Longer than any fixed DFS stack; Tail only reaches the cycle. */
+    enum { CHAIN = 300 };
+    char name[16], target[16];
+
+    SysmlNode *tail = sysml2_build_node(ctx.build_ctx, SYSML_KIND_PART_DEF, "Tail");
+    sysml2_build_add_specializes(ctx.build_ctx, tail, "N0");
+    sysml2_build_add_element(ctx.build_ctx, tail);
+
+    for (int i = 0; i < CHAIN; i++) {
+        snprintf(name, sizeof(name), "N%d", i);
+        snprintf(target, sizeof(target), "N%d", (i + 1) % CHAIN);
+        SysmlNode *n = sysml2_build_node(ctx.build_ctx, SYSML_KIND_PART_DEF, name);
+        sysml2_build_add_specializes(ctx.build_ctx, n, target);
+        sysml2_build_add_element(ctx.build_ctx, n);
+    }
+
+    SysmlNode *x = sysml2_build_node(ctx.build_ctx, SYSML_KIND_PART_DEF, "X");
+    sysml2_build_add_specializes(ctx.build_ctx, x, "Y");
+    sysml2_build_add_element(ctx.build_ctx, x);
+    SysmlNode *y = sysml2_build_node(ctx.build_ctx, SYSML_KIND_PART_DEF, "Y");
+    sysml2_build_add_specializes(ctx.build_ctx, y, "X");
+    sysml2_build_add_element(ctx.build_ctx, y);
+
+    SysmlSemanticModel *model = sysml2_build_finalize(ctx.build_ctx);
+
+    Sysml2ValidationOptions opts = SYSML_VALIDATION_OPTIONS_DEFAULT;
+    Sysml2Result result = sysml2_validate(model, &ctx.diag_ctx, NULL,
+        &ctx.arena, &ctx.intern, &opts);
+
+    ASSERT_EQ(result, SYSML2_ERROR_SEMANTIC);
+    ASSERT_EQ(ctx.diag_ctx.error_count, CHAIN + 2);
+
+    /* Reported in element order; Tail is not on a cycle */
+    Sysml2Diagnostic *diag = ctx.diag_ctx.first;
+    ASSERT_EQ(diag->code, SYSML2_DIAG_E3005_CIRCULAR_SPECIALIZATION);
+    ASSERT_NOT_NULL(diag->notes);
+    ASSERT(strncmp(diag->notes->message, "cycle: N0 -> N1 -> ", 19) == 0);
+
+    while (diag->next) diag = diag->next;
+    ASSERT_NOT_NULL(diag->notes);
+    ASSERT_STR_EQ(diag->notes->message, "cycle: Y -> X -> Y");
+
+    test_ctx_destroy(&ctx);
+}
+
+TEST(validate_e3005_deep_acyclic_hierarchy) {
+    TestContext ctx;
+    test_ctx_init(&ctx);
+
+    /* D0 :> D1 :> ... :> D19999 - deep, but no cycle */
+    enum { DEPTH = 20000 };
+    char name[16], target[16];
+    for (int i = 0; i < DEPTH; i++) {
+        snprintf(name, sizeof(name), "D%d", i);
+        SysmlNode *n = sysml2_build_node(ctx.build_ctx, SYSML_KIND_PART_DEF, name);
+        if (i + 1 < DEPTH) {
+            snprintf(target, sizeof(target), "D%d", i + 1);
+            sysml2_build_add_specializes(ctx.build_ctx, n, target);
+        }
+        sysml2_build_add_element(ctx.build_ctx, n);
+    }
+
+    SysmlSemanticModel *model = sysml2_build_finalize(ctx.build_ctx);
+
+    Sysml2ValidationOptions opts = SYSML_VALIDATION_OPTIONS_DEFAULT;
+    Sysml2Result result = sysml2_validate(model, &ctx.diag_ctx, NULL,
+        &ctx.arena, &ctx.intern, &opts);
+
+    ASSERT_EQ(result, SYSML2_OK);
+    ASSERT_EQ(ctx.diag_ctx.error_count, 0);
+
+    test_ctx_destroy(&ctx);
+}
+
 TEST(validate_e3006_type_mismatch) {
     TestContext ctx;
     test_ctx_init(&ctx);
@@ -588,6 +812,67 @@ TEST(find_similar_basic) {
     FIXTURE_TEARDOWN();
 }
 
+/* Plain Levenshtein distance for checking the bounded one */
+static size_t reference_distance(const char *a, const char *b) {
+    size_t la = strlen(a), lb = strlen(b);
+    size_t *row = malloc((lb + 1) * sizeof(size_t));
+    for (size_t j = 0; j <= lb; j++) row[j] = j;
+    for (size_t i = 1; i <= la; i++) {
+        size_t diag = row[0];
+        row[0] = i;
+        for (size_t j = 1; j <= lb; j++) {
+            size_t up = row[j];
+            size_t best = diag + (a[i - 1] == b[j - 1] ? 0 : 1);
+            if (up + 1 < best) best = up + 1;
+            if (row[j - 1] + 1 < best) best = row[j - 1] + 1;
+            row[j] = best;
+            diag = up;
+        }
+    }
+    size_t result = row[lb];
+    free(row);
+    return result;
+}
+
+TEST(edit_distance_bounded) {
+    /* Short and long (past one machine word) strings over a small alphabet */
+    char strings[40][100];
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < 40; i++) {
+        size_t len = i < 30 ? i % 12 : 60 + (i % 10) * 4;
+        for (size_t k = 0; k < len; k++) {
+            seed = seed * 1103515245u + 12345u;
+            strings[i][k] = "abcdE_"[(seed >> 16) % 6];
+        }
+        strings[i][len] = '\0';
+    }
+    /* Near-copies of the long strings */
+    for (size_t i = 30; i < 35; i++) {
+        memcpy(strings[i + 5], strings[i], sizeof(strings[i]));
+        strings[i + 5][3] = 'z';
+        strings[i + 5][40] = 'z';
+    }
+
+    for (size_t i = 0; i < 40; i++) {
+        Sysml2EditPattern pattern;
+        sysml2_edit_pattern_init(&pattern, strings[i], strlen(strings[i]));
+        for (size_t j = 0; j < 40; j++) {
+            size_t expected = reference_distance(strings[i], strings[j]);
+            for (size_t max = 0; max <= 4; max++) {
+                size_t got = sysml2_edit_distance_bounded(&pattern, strings[j],
+                                                          strlen(strings[j]), max);
+                ASSERT_EQ(got, expected <= max ? expected : max + 1);
+            }
+        }
+    }
+
+    Sysml2EditPattern pattern;
+    sysml2_edit_pattern_init(&pattern, "kitten", 6);
+    ASSERT_EQ(sysml2_edit_distance_bounded(&pattern, "sitting", 7, 3), 3);
+    ASSERT_EQ(sysml2_edit_distance_bounded(&pattern, "sitting", 7, 2), 3);
+    ASSERT_EQ(sysml2_edit_distance_bounded(&pattern, "kitten", 6, 0), 0);
+}
+
 /* ========== E3007 Multiplicity Validation Tests ========== */
 
 TEST(validate_e3007_inverted_bounds) {
@@ -793,6 +1078,86 @@ TEST(validate_e3008_valid_narrowing) {
     test_ctx_destroy(&ctx);
 }
 
+TEST(validate_e3008_deep_hierarchy) {
+    TestContext ctx;
+    test_ctx_init(&ctx);
+
+    /* Q29 :> Q28 :> ... :> Q0 and L0 :> L1 :> ... :> L29 :> Base,
+     * both deeper than a fixed recursion limit would follow */
+    enum { DEPTH = 30 };
+    char name[16], target[16];
+
+    for (int i = 0; i < DEPTH; i++) {
+        snprintf(name, sizeof(name), "Q%d", i);
+        SysmlNode *q = sysml2_build_node(ctx.build_ctx, SYSML_KIND_ATTRIBUTE_DEF, name);
+        if (i > 0) {
+            snprintf(target, sizeof(target), "Q%d", i - 1);
+            sysml2_build_add_specializes(ctx.build_ctx, q, target);
+        }
+        sysml2_build_add_element(ctx.build_ctx, q);
+    }
+
+    /* Base has x : Q0 */
+    SysmlNode *base = sysml2_build_node(ctx.build_ctx, SYSML_KIND_PART_DEF, "Base");
+    sysml2_build_add_element(ctx.build_ctx, base);
+    sysml2_build_push_scope(ctx.build_ctx, base->id);
+    SysmlNode *x = sysml2_build_node(ctx.build_ctx, SYSML_KIND_ATTRIBUTE_USAGE, "x");
+    sysml2_build_add_typed_by(ctx.build_ctx, x, "Q0");
+    sysml2_build_add_element(ctx.build_ctx, x);
+    sysml2_build_pop_scope(ctx.build_ctx);
+
+    for (int i = 0; i < DEPTH; i++) {
+        snprintf(name, sizeof(name), "L%d", i);
+        if (i + 1 < DEPTH) {
+            snprintf(target, sizeof(target), "L%d", i + 1);
+        } else {
+            snprintf(target, sizeof(target), "Base");
+        }
+        SysmlNode *l = sysml2_build_node(ctx.build_ctx, SYSML_KIND_PART_DEF, name);
+        sysml2_build_add_specializes(ctx.build_ctx, l, target);
+        sysml2_build_add_element(ctx.build_ctx, l);
+    }
+
+    /* Two parts redefine x with a deep subtype; the second hits the memo */
+    for (int i = 0; i < 2; i++) {
+        snprintf(name, sizeof(name), "Derived%d", i);
+        SysmlNode *derived = sysml2_build_node(ctx.build_ctx, SYSML_KIND_PART_DEF, name);
+        sysml2_build_add_specializes(ctx.build_ctx, derived, "L0");
+        sysml2_build_add_element(ctx.build_ctx, derived);
+        sysml2_build_push_scope(ctx.build_ctx, derived->id);
+        SysmlNode *rx = sysml2_build_node(ctx.build_ctx, SYSML_KIND_ATTRIBUTE_USAGE, "x");
+        sysml2_build_add_redefines(ctx.build_ctx, rx, "x");
+        sysml2_build_add_typed_by(ctx.build_ctx, rx, "Q29");
+        sysml2_build_add_element(ctx.build_ctx, rx);
+        sysml2_build_pop_scope(ctx.build_ctx);
+    }
+
+    /* Redefining with an unrelated type is still rejected */
+    SysmlNode *other = sysml2_build_node(ctx.build_ctx, SYSML_KIND_ATTRIBUTE_DEF, "Other");
+    sysml2_build_add_element(ctx.build_ctx, other);
+    SysmlNode *bad = sysml2_build_node(ctx.build_ctx, SYSML_KIND_PART_DEF, "Bad");
+    sysml2_build_add_specializes(ctx.build_ctx, bad, "L0");
+    sysml2_build_add_element(ctx.build_ctx, bad);
+    sysml2_build_push_scope(ctx.build_ctx, bad->id);
+    SysmlNode *bx = sysml2_build_node(ctx.build_ctx, SYSML_KIND_ATTRIBUTE_USAGE, "x");
+    sysml2_build_add_redefines(ctx.build_ctx, bx, "x");
+    sysml2_build_add_typed_by(ctx.build_ctx, bx, "Other");
+    sysml2_build_add_element(ctx.build_ctx, bx);
+    sysml2_build_pop_scope(ctx.build_ctx);
+
+    SysmlSemanticModel *model = sysml2_build_finalize(ctx.build_ctx);
+
+    Sysml2ValidationOptions opts = SYSML_VALIDATION_OPTIONS_DEFAULT;
+    Sysml2Result result = sysml2_validate(model, &ctx.diag_ctx, NULL,
+        &ctx.arena, &ctx.intern, &opts);
+
+    ASSERT_EQ(result, SYSML2_ERROR_SEMANTIC);
+    ASSERT_EQ(ctx.diag_ctx.error_count, 1);
+    ASSERT_EQ(ctx.diag_ctx.first->code, SYSML2_DIAG_E3008_REDEFINITION_ERROR);
+
+    test_ctx_destroy(&ctx);
+}
+
 /* ========== E3003 Undefined Namespace Tests ========== */
 
 TEST(validate_e3003_undefined_namespace) {
@@ -1006,6 +1371,347 @@ TEST(validate_multi_different_source_files) {
     sysml2_arena_destroy(&arena);
 }
 
+/* Assert two runs reported the same diagnostics in the same order */
+static void assert_same_diagnostics(const Sysml2DiagContext *x, const Sysml2DiagContext *y) {
+    const Sysml2Diagnostic *a = x->first;
+    const Sysml2Diagnostic *b = y->first;
+    for (; a && b; a = a->next, b = b->next) {
+        ASSERT_EQ(a->code, b->code);
+        ASSERT_EQ(a->severity, b->severity);
+        ASSERT_EQ(a->file, b->file);
+        ASSERT_EQ(a->range.start.line, b->range.start.line);
+        ASSERT_STR_EQ(a->message, b->message);
+        ASSERT((a->help == NULL) == (b->help == NULL));
+        if (a->help) ASSERT_STR_EQ(a->help, b->help);
+        ASSERT((a->notes == NULL) == (b->notes == NULL));
+        if (a->notes) ASSERT_STR_EQ(a->notes->message, b->notes->message);
+    }
+    ASSERT_NULL(a);
+    ASSERT_NULL(b);
+}
+
+/*
+ * Model with one package of part defs and usages; every seventh element
+ * carries an error or warning from one of the chunked passes
+ */
+static SysmlSemanticModel *build_parallel_model(
+    Sysml2Arena *arena,
+    Sysml2Intern *intern,
+    const char *package,
+    int count
+) {
+    SysmlBuildContext *build = sysml2_build_context_create(arena, intern, package);
+    char name[32], target[32];
+
+    SysmlNode *pkg = sysml2_build_node(build, SYSML_KIND_PACKAGE, package);
+    sysml2_build_add_element(build, pkg);
+    sysml2_build_push_scope(build, pkg->id);
+
+    SysmlNode *abs = sysml2_build_node(build, SYSML_KIND_PART_DEF, "Abstract");
+    abs->is_abstract = true;
+    sysml2_build_add_element(build, abs);
+
+    SysmlNode *base = sysml2_build_node(build, SYSML_KIND_PART_DEF, "Base");
+    sysml2_build_add_element(build, base);
+    sysml2_build_push_scope(build, base->id);
+    SysmlNode *feature = sysml2_build_node(build, SYSML_KIND_PART_USAGE, "f");
+    sysml2_build_add_element(build, feature);
+    sysml2_build_pop_scope(build);
+
+    for (int i = 0; i < count; i++) {
+        snprintf(name, sizeof(name), "D%d", i);
+        SysmlNode *def = sysml2_build_node(build, SYSML_KIND_PART_DEF, name);
+        sysml2_build_add_specializes(build, def, "Base");
+        def->loc.line = (uint32_t)i + 1;
+        sysml2_build_add_element(build, def);
+
+        snprintf(name, sizeof(name), "u%d", i);
+        SysmlNode *use = sysml2_build_node(build, SYSML_KIND_PART_USAGE, name);
+        use->loc.line = (uint32_t)i + 1;
+        switch (i % 7) {
+            case 1:
+                snprintf(target, sizeof(target), "Missing%d", i);
+                sysml2_build_add_typed_by(build, use, target);
+                break;
+            case 3:
+                use->multiplicity_lower = sysml2_intern(intern, "5");
+                use->multiplicity_upper = sysml2_intern(intern, "2");
+                break;
+            case 5:
+                sysml2_build_add_typed_by(build, use, "Abstract");
+                break;
+            default:
+                snprintf(target, sizeof(target), "D%d", i);
+                sysml2_build_add_typed_by(build, use, target);
+                break;
+        }
+        sysml2_build_add_element(build, use);
+
+        /* Redefinitions inside the def, one of them of a missing feature */
+        if (i % 7 == 6) {
+            sysml2_build_push_scope(build, def->id);
+            SysmlNode *redef = sysml2_build_node(build, SYSML_KIND_PART_USAGE, "g");
+            sysml2_build_add_redefines(build, redef, i % 14 == 6 ? "f" : "missing");
+            redef->loc.line = (uint32_t)i + 1;
+            sysml2_build_add_element(build, redef);
+            sysml2_build_pop_scope(build);
+        }
+    }
+
+    sysml2_build_pop_scope(build);
+    SysmlSemanticModel *model = sysml2_build_finalize(build);
+    sysml2_build_context_destroy(build);
+    return model;
+}
+
+TEST(validate_multi_parallel_matches_serial) {
+    FIXTURE_SETUP();
+
+    SysmlSemanticModel *models[] = {
+        build_parallel_model(&arena, &intern, "Alpha", 5000),
+        NULL,
+        build_parallel_model(&arena, &intern, "Beta", 3000)
+    };
+
+    Sysml2ValidationOptions opts = SYSML_VALIDATION_OPTIONS_DEFAULT;
+    Sysml2DiagContext serial;
+    sysml2_diag_context_init(&serial, &arena);
+    Sysml2Result serial_result = sysml2_validate_multi(models, 3, &serial,
+        &arena, &intern, &opts);
+
+    opts.jobs = 4;
+    Sysml2DiagContext parallel;
+    sysml2_diag_context_init(&parallel, &arena);
+    Sysml2Result parallel_result = sysml2_validate_multi(models, 3, &parallel,
+        &arena, &intern, &opts);
+
+    ASSERT_EQ(serial_result, SYSML2_ERROR_SEMANTIC);
+    ASSERT_EQ(parallel_result, serial_result);
+    ASSERT(serial.error_count > 1000);
+    ASSERT(serial.warning_count > 500);
+    ASSERT_EQ(parallel.error_count, serial.error_count);
+    ASSERT_EQ(parallel.warning_count, serial.warning_count);
+    ASSERT_EQ(parallel.semantic_error_count, serial.semantic_error_count);
+
+    assert_same_diagnostics(&serial, &parallel);
+
+    FIXTURE_TEARDOWN();
+}
+
+/* Cycle over every third def of a build_parallel_model package */
+static SysmlSemanticModel *build_cyclic_model(Sysml2Arena *arena, Sysml2Intern *intern) {
+    SysmlBuildContext *build = sysml2_build_context_create(arena, intern, "cyclic.sysml");
+    char name[32], target[32];
+
+    SysmlNode *pkg = sysml2_build_node(build, SYSML_KIND_PACKAGE, "Cyclic");
+    sysml2_build_add_element(build, pkg);
+    sysml2_build_push_scope(build, pkg->id);
+    for (int i = 0; i < 30; i++) {
+        snprintf(name, sizeof(name), "C%d", i);
+        snprintf(target, sizeof(target), "C%d", i % 3 == 2 ? i - 2 : i + 1);
+        SysmlNode *def = sysml2_build_node(build, SYSML_KIND_PART_DEF, name);
+        sysml2_build_add_specializes(build, def, target);
+        def->loc.line = (uint32_t)i + 1;
+        sysml2_build_add_element(build, def);
+
+        snprintf(name, sizeof(name), "c%d", i);
+        SysmlNode *use = sysml2_build_node(build, SYSML_KIND_PART_USAGE, name);
+        sysml2_build_add_typed_by(build, use, i % 2 ? target : "Alpha::Abstract");
+        use->multiplicity_lower = sysml2_intern(intern, i % 5 ? "1" : "x");
+        use->loc.line = (uint32_t)i + 1;
+        sysml2_build_add_element(build, use);
+    }
+    sysml2_build_pop_scope(build);
+
+    SysmlSemanticModel *model = sysml2_build_finalize(build);
+    sysml2_build_context_destroy(build);
+    return model;
+}
+
+TEST(validate_fused_matches_passes) {
+    FIXTURE_SETUP();
+
+    SysmlSemanticModel *models[] = {
+        build_parallel_model(&arena, &intern, "Alpha", 5000),
+        build_cyclic_model(&arena, &intern),
+        NULL,
+        build_parallel_model(&arena, &intern, "Beta", 3000)
+    };
+
+    Sysml2ValidationOptions opts = SYSML_VALIDATION_OPTIONS_DEFAULT;
+    for (size_t jobs = 1; jobs <= 4; jobs += 3) {
+        opts.jobs = jobs;
+        opts.fuse_passes = false;
+        Sysml2DiagContext passes;
+        sysml2_diag_context_init(&passes, &arena);
+        Sysml2Result passes_result = sysml2_validate_multi(models, 4, &passes,
+            &arena, &intern, &opts);
+
+        opts.fuse_passes = true;
+        Sysml2DiagContext fused;
+        sysml2_diag_context_init(&fused, &arena);
+        Sysml2Result fused_result = sysml2_validate_multi(models, 4, &fused,
+            &arena, &intern, &opts);
+
+        ASSERT_EQ(passes_result, SYSML2_ERROR_SEMANTIC);
+        ASSERT_EQ(fused_result, passes_result);
+        ASSERT(passes.error_count > 1000);
+        ASSERT_EQ(fused.error_count, passes.error_count);
+        ASSERT_EQ(fused.warning_count, passes.warning_count);
+        assert_same_diagnostics(&passes, &fused);
+    }
+
+    /* Single-model validation, both with checks off and on */
+    opts = SYSML_VALIDATION_OPTIONS_DEFAULT;
+    for (int checks = 0; checks < 2; checks++) {
+        opts.check_undefined_types = checks;
+        opts.check_multiplicity = checks;
+        opts.fuse_passes = false;
+        Sysml2DiagContext passes;
+        sysml2_diag_context_init(&passes, &arena);
+        Sysml2Result passes_result = sysml2_validate(models[1], &passes,
+            NULL, &arena, &intern, &opts);
+
+        opts.fuse_passes = true;
+        Sysml2DiagContext fused;
+        sysml2_diag_context_init(&fused, &arena);
+        Sysml2Result fused_result = sysml2_validate(models[1], &fused,
+            NULL, &arena, &intern, &opts);
+
+        ASSERT_EQ(passes_result, SYSML2_ERROR_SEMANTIC);
+        ASSERT_EQ(fused_result, passes_result);
+        ASSERT(passes.error_count >= 10);
+        assert_same_diagnostics(&passes, &fused);
+    }
+
+    FIXTURE_TEARDOWN();
+}
+
+/*
+ * Model using the "Alpha" package of build_parallel_model: contributes to
+ * it (one name clashing with a library def) and imports from it
+ */
+static SysmlSemanticModel *build_layer_client_model(Sysml2Arena *arena, Sysml2Intern *intern) {
+    SysmlBuildContext *build = sysml2_build_context_create(arena, intern, "client.sysml");
+
+    SysmlNode *alpha = sysml2_build_node(build, SYSML_KIND_PACKAGE, "Alpha");
+    sysml2_build_add_element(build, alpha);
+    sysml2_build_push_scope(build, alpha->id);
+    sysml2_build_add_element(build, sysml2_build_node(build, SYSML_KIND_PART_DEF, "Extra"));
+    sysml2_build_add_element(build, sysml2_build_node(build, SYSML_KIND_PART_DEF, "D4"));
+    sysml2_build_pop_scope(build);
+
+    SysmlNode *app = sysml2_build_node(build, SYSML_KIND_PACKAGE, "App");
+    sysml2_build_add_element(build, app);
+    sysml2_build_push_scope(build, app->id);
+    sysml2_build_add_import(build, SYSML_KIND_IMPORT_ALL, "Alpha::*");
+    const char *types[] = { "D1", "Extra", "Missing", "Abstract", "Alpha::Base" };
+    char name[16];
+    for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+        snprintf(name, sizeof(name), "p%zu", i);
+        SysmlNode *use = sysml2_build_node(build, SYSML_KIND_PART_USAGE, name);
+        sysml2_build_add_typed_by(build, use, types[i]);
+        use->loc.line = (uint32_t)i + 1;
+        sysml2_build_add_element(build, use);
+    }
+    sysml2_build_add_element(build, sysml2_build_node(build, SYSML_KIND_PART_DEF, "Twice"));
+    sysml2_build_add_element(build, sysml2_build_node(build, SYSML_KIND_PART_DEF, "Twice"));
+    sysml2_build_pop_scope(build);
+
+    SysmlSemanticModel *model = sysml2_build_finalize(build);
+    sysml2_build_context_destroy(build);
+    return model;
+}
+
+/* Validate with and without a layer and compare the diagnostics */
+static void assert_layer_matches(
+    SysmlSemanticModel **models,
+    size_t model_count,
+    const bool *check,
+    const Sysml2SymbolLayer *layer,
+    Sysml2Arena *arena,
+    Sysml2Intern *intern
+) {
+    Sysml2ValidationOptions opts = SYSML_VALIDATION_OPTIONS_DEFAULT;
+    Sysml2DiagContext unified;
+    sysml2_diag_context_init(&unified, arena);
+    Sysml2Result unified_result = sysml2_validate_subset(models, model_count, check,
+        &unified, arena, intern, &opts);
+
+    opts.layer = layer;
+    Sysml2DiagContext layered;
+    sysml2_diag_context_init(&layered, arena);
+    Sysml2Result layered_result = sysml2_validate_subset(models, model_count, check,
+        &layered, arena, intern, &opts);
+
+    ASSERT_EQ(layered_result, unified_result);
+    ASSERT(unified.error_count > 0);
+    ASSERT_EQ(layered.error_count, unified.error_count);
+    ASSERT_EQ(layered.warning_count, unified.warning_count);
+
+    const Sysml2Diagnostic *a = unified.first;
+    const Sysml2Diagnostic *b = layered.first;
+    for (; a && b; a = a->next, b = b->next) {
+        ASSERT_EQ(a->code, b->code);
+        ASSERT_EQ(a->range.start.line, b->range.start.line);
+        ASSERT_STR_EQ(a->message, b->message);
+        ASSERT((a->help == NULL) == (b->help == NULL));
+        if (a->help) ASSERT_STR_EQ(a->help, b->help);
+    }
+    ASSERT_NULL(a);
+    ASSERT_NULL(b);
+}
+
+TEST(validate_layer_matches_unified) {
+    FIXTURE_SETUP();
+
+    SysmlSemanticModel *library = build_parallel_model(&arena, &intern, "Alpha", 500);
+    SysmlSemanticModel *client = build_layer_client_model(&arena, &intern);
+    SysmlSemanticModel *models[] = { library, client };
+
+    Sysml2SymbolLayer layer;
+    ASSERT_EQ(sysml2_validator_build_layer(&layer, &library, 1, &arena, &intern), SYSML2_OK);
+    ASSERT_EQ(layer.model_count, 1);
+    ASSERT(!layer.has_duplicates);
+
+    /* All models checked, and only the client (as --serve does) */
+    assert_layer_matches(models, 2, NULL, &layer, &arena, &intern);
+    const bool client_only[] = { false, true };
+    assert_layer_matches(models, 2, client_only, &layer, &arena, &intern);
+
+    /* The layer is reusable */
+    assert_layer_matches(models, 2, client_only, &layer, &arena, &intern);
+
+    sysml2_symtab_destroy(&layer.symtab);
+    FIXTURE_TEARDOWN();
+}
+
+TEST(validate_layer_falls_back) {
+    FIXTURE_SETUP();
+
+    SysmlSemanticModel *library = build_parallel_model(&arena, &intern, "Alpha", 200);
+    SysmlSemanticModel *other = build_parallel_model(&arena, &intern, "Gamma", 10);
+    SysmlSemanticModel *client = build_layer_client_model(&arena, &intern);
+    SysmlSemanticModel *models[] = { library, client };
+
+    /* A layer model missing from the validation */
+    Sysml2SymbolLayer partial;
+    SysmlSemanticModel *layered[] = { library, other };
+    ASSERT_EQ(sysml2_validator_build_layer(&partial, layered, 2, &arena, &intern), SYSML2_OK);
+    assert_layer_matches(models, 2, NULL, &partial, &arena, &intern);
+
+    /* Duplicates inside the layer, which a checked model must report */
+    Sysml2SymbolLayer twice;
+    SysmlSemanticModel *doubled[] = { library, library };
+    ASSERT_EQ(sysml2_validator_build_layer(&twice, doubled, 2, &arena, &intern), SYSML2_OK);
+    ASSERT(twice.has_duplicates);
+    assert_layer_matches(doubled, 2, NULL, &twice, &arena, &intern);
+
+    sysml2_symtab_destroy(&partial.symtab);
+    sysml2_symtab_destroy(&twice.symtab);
+    FIXTURE_TEARDOWN();
+}
+
 TEST(validate_multi_null_source_file_safe) {
     /* Verify that validate_multi works when model->source_file is NULL */
     TestContext ctx;
@@ -1165,6 +1871,66 @@ TEST(validate_e3006_diagnostic_has_line_number) {
     test_ctx_destroy(&ctx);
 }
 
+/* ========== Reference Index Tests ========== */
+
+TEST(index_references_resolves_edges) {
+    TestContext ctx;
+    test_ctx_init(&ctx);
+
+    /* part def A { part x; }  part def B :> A { part x :>> x; }  part b : B; */
+    SysmlNode *def_a = sysml2_build_node(ctx.build_ctx, SYSML_KIND_PART_DEF, "A");
+    sysml2_build_add_element(ctx.build_ctx, def_a);
+    sysml2_build_push_scope(ctx.build_ctx, def_a->id);
+    SysmlNode *x = sysml2_build_node(ctx.build_ctx, SYSML_KIND_PART_USAGE, "x");
+    sysml2_build_add_element(ctx.build_ctx, x);
+    sysml2_build_pop_scope(ctx.build_ctx);
+
+    SysmlNode *def_b = sysml2_build_node(ctx.build_ctx, SYSML_KIND_PART_DEF, "B");
+    sysml2_build_add_specializes(ctx.build_ctx, def_b, "A");
+    sysml2_build_add_element(ctx.build_ctx, def_b);
+    sysml2_build_push_scope(ctx.build_ctx, def_b->id);
+    SysmlNode *x_redef = sysml2_build_node(ctx.build_ctx, SYSML_KIND_PART_USAGE, "x");
+    sysml2_build_add_redefines(ctx.build_ctx, x_redef, "x");
+    sysml2_build_add_element(ctx.build_ctx, x_redef);
+    sysml2_build_pop_scope(ctx.build_ctx);
+
+    SysmlNode *b = sysml2_build_node(ctx.build_ctx, SYSML_KIND_PART_USAGE, "b");
+    sysml2_build_add_typed_by(ctx.build_ctx, b, "B");
+    sysml2_build_add_typed_by(ctx.build_ctx, b, "Missing");
+    sysml2_build_add_element(ctx.build_ctx, b);
+
+    SysmlSemanticModel *model = sysml2_build_finalize(ctx.build_ctx);
+    SysmlSemanticModel *models[] = { model };
+
+    Sysml2RefIndex index = {0};
+    ASSERT_EQ(sysml2_validator_index_references(models, 1, &ctx.arena, &ctx.intern, &index),
+              SYSML2_OK);
+    ASSERT_EQ(index.edge_count, 3);  /* Missing is skipped */
+
+    /* The index is keyed by interned ID */
+
+    const Sysml2RefEdge *users = sysml2_ref_index_users(&index, sysml2_intern(&ctx.intern, "A"));
+    ASSERT_NOT_NULL(users);
+    ASSERT_EQ(users->user, def_b);
+    ASSERT_EQ(users->kind, SYSML2_REF_SPECIALIZES);
+    ASSERT_NULL(users->next);
+
+    users = sysml2_ref_index_users(&index, sysml2_intern(&ctx.intern, "A::x"));
+    ASSERT_NOT_NULL(users);
+    ASSERT_EQ(users->user, x_redef);
+    ASSERT_EQ(users->kind, SYSML2_REF_REDEFINES);
+
+    users = sysml2_ref_index_users(&index, sysml2_intern(&ctx.intern, "B"));
+    ASSERT_NOT_NULL(users);
+    ASSERT_EQ(users->user, b);
+    ASSERT_EQ(users->kind, SYSML2_REF_TYPED_BY);
+
+    ASSERT_NULL(sysml2_ref_index_users(&index, sysml2_intern(&ctx.intern, "b")));
+    ASSERT_EQ(ctx.diag_ctx.error_count, 0);
+
+    test_ctx_destroy(&ctx);
+}
+
 /* ========== Main ========== */
 
 int main(void) {
@@ -1176,10 +1942,14 @@ int main(void) {
     RUN_TEST(symtab_get_or_create_scope);
     RUN_TEST(symtab_nested_scopes);
     RUN_TEST(symtab_add_symbol);
+    RUN_TEST(symtab_small_and_large_scopes);
     RUN_TEST(symtab_duplicate_returns_existing);
     RUN_TEST(symtab_resolve_simple);
     RUN_TEST(symtab_resolve_parent_scope);
     RUN_TEST(symtab_resolve_qualified);
+    RUN_TEST(symtab_resolve_cache_invalidation);
+    RUN_TEST(symtab_resolve_long_import_chain);
+    RUN_TEST(symtab_overlay_on_frozen_table);
 
     /* Type Compatibility tests */
     printf("\n  Type Compatibility tests:\n");
@@ -1211,6 +1981,8 @@ int main(void) {
     RUN_TEST(validate_e3004_duplicate_name);
     RUN_TEST(validate_e3005_circular_direct);
     RUN_TEST(validate_e3005_circular_indirect);
+    RUN_TEST(validate_e3005_reports_each_cycle_member_once);
+    RUN_TEST(validate_e3005_deep_acyclic_hierarchy);
     RUN_TEST(validate_e3006_type_mismatch);
     RUN_TEST(validate_options_disable_checks);
     RUN_TEST(validate_suggestions);
@@ -1218,6 +1990,7 @@ int main(void) {
     /* Find Similar tests */
     printf("\n  Find Similar tests:\n");
     RUN_TEST(find_similar_basic);
+    RUN_TEST(edit_distance_bounded);
 
     /* E3007 Multiplicity Validation tests */
     printf("\n  E3007 Multiplicity Validation tests:\n");
@@ -1233,6 +2006,7 @@ int main(void) {
     printf("\n  E3008 Redefinition Compatibility tests:\n");
     RUN_TEST(validate_e3008_multiplicity_widening);
     RUN_TEST(validate_e3008_valid_narrowing);
+    RUN_TEST(validate_e3008_deep_hierarchy);
 
     /* E3003 Undefined Namespace tests */
     printf("\n  E3003 Undefined Namespace tests:\n");
@@ -1252,6 +2026,10 @@ int main(void) {
     RUN_TEST(validate_multi_source_file_on_diagnostics);
     RUN_TEST(validate_multi_different_source_files);
     RUN_TEST(validate_multi_null_source_file_safe);
+    RUN_TEST(validate_multi_parallel_matches_serial);
+    RUN_TEST(validate_fused_matches_passes);
+    RUN_TEST(validate_layer_matches_unified);
+    RUN_TEST(validate_layer_falls_back);
 
     /* Diagnostic Location tests */
     printf("\n  Diagnostic Location tests:\n");
@@ -1260,6 +2038,10 @@ int main(void) {
     RUN_TEST(validate_e3005_diagnostic_has_line_number);
     RUN_TEST(validate_e3006_diagnostic_has_line_number);
 
+    /* Reference Index tests */
+    printf("\n  Reference Index tests:\n");
+    RUN_TEST(index_references_resolves_edges);
+
     printf("\n%d/%d tests passed\n", tests_passed, tests_run);
     return tests_passed == tests_run ? 0 : 1;
 }
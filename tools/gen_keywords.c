@@ -0,0 +1,109 @@
+/*
+ * SysML v2 Parser - Keyword Table Generator
+ *
+ * Build-time tool: searches for a hash seed under which every keyword in
+ * src/keywords.def lands in its own slot, and writes the slot table as a
+ * header for keywords.c.
+ *
+ * Usage: gen_keywords <output.h>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "keyword_hash.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *const keywords[] = {
+#define SYSML2_KEYWORD(spelling, token) spelling,
+#include "keywords.def"
+#undef SYSML2_KEYWORD
+};
+
+#define KEYWORD_COUNT (sizeof(keywords) / sizeof(keywords[0]))
+
+/* Seeds tried per table size before doubling it */
+#define MAX_SEEDS 1000000u
+
+/* Slot values are keyword index + 1, so they must fit in a byte */
+_Static_assert(KEYWORD_COUNT < 255, "keyword slots are uint8_t");
+
+/* Try a seed; fills slots and returns 1 if collision-free */
+static int try_seed(uint32_t seed, unsigned bits, unsigned char *slots) {
+    size_t size = (size_t)1 << bits;
+    memset(slots, 0, size);
+    for (size_t i = 0; i < KEYWORD_COUNT; i++) {
+        uint32_t hash = sysml2_keyword_hash(seed, keywords[i], strlen(keywords[i]));
+        size_t slot = hash & (size - 1);
+        if (slots[slot]) return 0;
+        slots[slot] = (unsigned char)(i + 1);
+    }
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <output.h>\n", argv[0]);
+        return 1;
+    }
+
+    size_t min_length = (size_t)-1;
+    size_t max_length = 0;
+    for (size_t i = 0; i < KEYWORD_COUNT; i++) {
+        size_t length = strlen(keywords[i]);
+        if (length < min_length) min_length = length;
+        if (length > max_length) max_length = length;
+    }
+
+    /* Start at 8 slots per keyword, where a seed turns up quickly */
+    unsigned bits = 1;
+    while (((size_t)1 << bits) < KEYWORD_COUNT * 8) bits++;
+
+    unsigned char *slots = NULL;
+    uint32_t seed = 0;
+    for (;; bits++) {
+        free(slots);
+        slots = malloc((size_t)1 << bits);
+        if (!slots) {
+            fprintf(stderr, "gen_keywords: out of memory\n");
+            return 1;
+        }
+        uint32_t candidate = 1;
+        for (; candidate <= MAX_SEEDS; candidate++) {
+            if (try_seed(candidate, bits, slots)) break;
+        }
+        if (candidate <= MAX_SEEDS) {
+            seed = candidate;
+            break;
+        }
+    }
+
+    FILE *out = fopen(argv[1], "w");
+    if (!out) {
+        fprintf(stderr, "gen_keywords: cannot write '%s'\n", argv[1]);
+        free(slots);
+        return 1;
+    }
+
+    size_t size = (size_t)1 << bits;
+    fprintf(out, "/* Generated by tools/gen_keywords.c from src/keywords.def - do not edit */\n\n");
+    fprintf(out, "#define KEYWORD_HASH_SEED 0x%08Xu\n", (unsigned)seed);
+    fprintf(out, "#define KEYWORD_SLOT_BITS %u\n", bits);
+    fprintf(out, "#define KEYWORD_MIN_LENGTH %zu\n", min_length);
+    fprintf(out, "#define KEYWORD_MAX_LENGTH %zu\n\n", max_length);
+    fprintf(out, "/* Keyword index + 1 per slot, 0 = empty */\n");
+    fprintf(out, "static const uint8_t keyword_slots[%zu] = {\n", size);
+    for (size_t i = 0; i < size; i++) {
+        fprintf(out, "%s%3u,%s", i % 16 == 0 ? "    " : "", slots[i], i % 16 == 15 ? "\n" : "");
+    }
+    if (size % 16 != 0) fprintf(out, "\n");
+    fprintf(out, "};\n");
+
+    free(slots);
+    if (fclose(out) != 0) {
+        fprintf(stderr, "gen_keywords: cannot write '%s'\n", argv[1]);
+        return 1;
+    }
+    return 0;
+}